@@ -0,0 +1,17 @@
+// The headless run of Main.cpp for the machines without Windows, built by CMakeLists.txt as the headless program.
+// It takes the options of Main.cpp -headless: -fixedstep <ms> -frames <count> -software -threads <count> -images -hud -trace.
+
+#include "__headlessRunnerClass.h"
+
+#include <string>
+using namespace std;
+
+int main(int argc, char **argv)
+{
+	string cmdline;
+
+	for (int i = 1; i < argc; i++)
+		cmdline += string(argv[i]) + " ";
+
+	return HeadlessRunnerClass::RunCommandLine(cmdline.c_str()) ? 0 : 1;
+}
@@ -1,17 +1,40 @@
 #include "__systemClass.h"
+#include "__shaderLoaderClass.h"
+#include "__headlessRunnerClass.h"
 
-
+#include <string.h>
+#include <stdlib.h>
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline, int iCmdshow)
 {
 	SystemClass *System;
 	bool result;
 
+	// Compile the shaders even when the cache has them, to compare the startup time with and without the cache.
+	if (strstr(pScmdline, "-noshadercache"))
+		ShaderLoaderClass::SetReadEnabled(false);
+
+	// A run of a fixed step: -fixedstep <ms> -frames <count>, the same frames every time.
+	// -headless draws them without a window or a GPU.
+	float step	 = HeadlessRunnerClass::GetOption(pScmdline, "-fixedstep", 0.0f);
+	int	  frames = (int)HeadlessRunnerClass::GetOption(pScmdline, "-frames", 0.0f);
+
+	// -trace <count> traces the first frames into trace.json, TRACE_CAPTURE_FRAMES of them without a count.
+	int	  trace	 = (int)HeadlessRunnerClass::GetOption(pScmdline, "-trace", -1.0f);
+
+	if (strstr(pScmdline, "-headless"))
+		return HeadlessRunnerClass::RunCommandLine(pScmdline) ? 0 : 1;
+
 	// Create the system object.
 	System = new SystemClass;
 	if (!System)
 		return 0;
 
+	System->SetFixedStep(step, frames);
+
+	if (trace >= 0)
+		System->SetTrace(trace > 0 ? trace : TRACE_CAPTURE_FRAMES);
+
 	// Initialize and run the system object.
 	result = System->Initialize();
 	if (result)
@@ -22,5 +45,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline,
 	delete System;
 	System = 0;
 
+	ShaderLoaderClass::Shutdown();
+	TraceClass::Shutdown();
+
 	return 0;
 }
@@ -35,6 +35,19 @@ class Sprite {
 		y = posY;
 	}
 
+	// Moving any sprite bumps the shared version counter, so a LayerCacheClass watching it redraws the layer with the sprites.
+	void setCoords(int x, int y) {
+		if (x != posX || y != posY) {
+			posX = x;
+			posY = y;
+			Version++;
+		}
+	}
+
+	static const unsigned int* getVersionCounter() {
+		return &Version;
+	}
+
 	int getIndexCount() {
 		return Bitmap->GetIndexCount();
 	}
@@ -57,6 +70,7 @@ class Sprite {
  private:
 	 int posX, posY;
 	 static BitmapClass *Bitmap;
+	 static unsigned int Version;
 };
 
 
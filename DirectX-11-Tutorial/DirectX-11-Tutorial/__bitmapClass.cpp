@@ -2,12 +2,15 @@
 // https://docs.unity3d.com/Manual/OptimizingGraphicsPerformance.html
 
 #include "__bitmapClass.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
 
 BitmapClass::BitmapClass()
 {
 	m_vertexBuffer = 0;
 	m_indexBuffer  = 0;
 	m_Texture	   = 0;
+	m_version	   = 0;
 }
 
 BitmapClass::BitmapClass(const BitmapClass& other)
@@ -99,6 +102,11 @@ int BitmapClass::GetIndexCount()
 	return m_indexCount;
 }
 
+const unsigned int* BitmapClass::GetVersionCounter()
+{
+	return &m_version;
+}
+
 // The GetTexture function returns a pointer to the texture resource for this 2D image.
 // The shader will call this function so it has access to the image when drawing the buffers.
 ID3D11ShaderResourceView* BitmapClass::GetTexture()
@@ -217,6 +225,8 @@ void BitmapClass::ShutdownBuffers()
 // to re-position the 2D bitmap image on the screen if need be.
 bool BitmapClass::UpdateBuffers(ID3D11DeviceContext *deviceContext, int positionX, int positionY)
 {
+	TraceScopeClass scope("BitmapClass::UpdateBuffers");
+
 	// We check if the position to render this image has changed.
 	// If it hasn't changed then we just exit since the vertex buffer doesn't need any changes for this frame.
 	// This check can save us a lot of processing.
@@ -226,6 +236,7 @@ bool BitmapClass::UpdateBuffers(ID3D11DeviceContext *deviceContext, int position
 	// If the position to render this image has changed then we record the new location for the next time we come through this function.
 	m_previousPosX = positionX;
 	m_previousPosY = positionY;
+	m_version++;
 
 
 	float		 left, right, top, bottom;
@@ -288,6 +299,7 @@ bool BitmapClass::UpdateBuffers(ID3D11DeviceContext *deviceContext, int position
 
 	// Unlock the vertex buffer.
 	deviceContext->Unmap(m_vertexBuffer, 0);
+	PerfStatsClass::CountMap(sizeof(VertexType) * m_vertexCount);
 
 	// Release the vertex array as it is no longer needed.
 	delete[] vertices;
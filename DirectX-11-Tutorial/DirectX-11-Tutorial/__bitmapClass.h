@@ -34,6 +34,9 @@ class BitmapClass {
 	bool Render(ID3D11DeviceContext *, int, int);
 
 	int GetIndexCount();
+
+	// The version counter goes up every time the bitmap moves, a LayerCacheClass watches it to know when to redraw the layer.
+	const unsigned int* GetVersionCounter();
 	ID3D11ShaderResourceView* GetTexture();
 
  private:
@@ -57,6 +60,8 @@ class BitmapClass {
 	int m_screenWidth, m_screenHeight;
 	int m_bitmapWidth, m_bitmapHeight;
 	int m_previousPosX, m_previousPosY;
+
+	unsigned int m_version;
 };
 
 #endif
@@ -2,12 +2,17 @@
 // https://docs.unity3d.com/Manual/OptimizingGraphicsPerformance.html
 
 #include "__bitmapClassInstancing.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
 
 BitmapClass_Instancing::BitmapClass_Instancing()
 {
 	m_vertexBuffer   = 0;
 	m_Texture	     = 0;
 	m_instanceBuffer = 0;
+
+	m_instanceCount    = 0;
+	m_maxInstanceCount = 0;
 }
 
 BitmapClass_Instancing::BitmapClass_Instancing(const BitmapClass_Instancing& other)
@@ -190,8 +195,12 @@ bool BitmapClass_Instancing::InitializeBuffers(ID3D11Device *device)
 		// For this tutorial I used position as it is easy to see visually which helps understand how instancing works.
 
 		// Load the instance array with data.
-		for (int i = 0; i < m_instanceCount; i++)
+		for (int i = 0; i < m_instanceCount; i++) {
 			instances[i].position = D3DXVECTOR3(-50.0f + 333*cos(100.0*i)*sin(float(.2*i)), -50.0f + 333*cos(100.0*i)*cos(float(.2*i)), 0.0f);
+			instances[i].size	  = 1.0f;
+			instances[i].color	  = D3DXVECTOR4(1.0f, 1.0f, 1.0f, 1.0f);
+			instances[i].uvRect	  = D3DXVECTOR4(0.0f, 0.0f, 1.0f, 1.0f);
+		}
 
 
 		// The instance buffer description is setup exactly the same as a vertex buffer description.
@@ -226,28 +235,10 @@ bool BitmapClass_Instancing::InitializeBuffers(ID3D11Device *device)
 	return true;
 }
 
-bool BitmapClass_Instancing::initializeInstances(ID3D11Device *device) {
-
-	InstanceType			*instances;
-	D3D11_BUFFER_DESC		 instanceBufferDesc;
-	D3D11_SUBRESOURCE_DATA   instanceData;
-
-	// We will now setup the new instance buffer.
-	// We start by first setting the number of instances of the triangle that will need to be rendered.
-	// For this tutorial I have manually set it to 4 so that we will have four triangles rendered on the screen.
-
-	// Set the number of instances in the array.
-	m_instanceCount = 30000;
-
-	// Next we create a temporary instance array using the instance count.
-	// Note we use the InstanceType structure for the array type which is defined in the ModelClass header file.
-
-	// Create the instance array.
-	instances = new InstanceType[m_instanceCount];
-	if (!instances)
-		return false;
-
-	// Now here is where we setup the different positions for each instance of the triangle.
+// BuildInstances writes the positions of count instances of the triangle, turning them a little further with every call.
+// initializeInstances makes its instance buffer from them; a sprite pass of the same quad can draw them as well.
+void BitmapClass_Instancing::BuildInstances(InstanceType *instances, int count)
+{
 	// I have set four different x, y, z positions for each triangle.
 	// Note that this is where you could set color, scaling, different texture coordinates, and so forth.
 	// An instance can be modified in any way you want it to be.
@@ -256,7 +247,7 @@ bool BitmapClass_Instancing::initializeInstances(ID3D11Device *device) {
 	static float angle = 0.0f;
 
 	//       
-	for (int i = 0; i < m_instanceCount; i++) {
+	for (int i = 0; i < count; i++) {
 		//instances[i].position = D3DXVECTOR3(-50.0f + 333 * cos(100.0*i)*sin(float(.2*i)), -50.0f + 333 * cos(100.0*i)*cos(float(.2*i)), i);
 		//instances[i].position = D3DXVECTOR3(400.0f - 15.0*i, -300.0f - 15.0*i, 10*angle/i);
 
@@ -269,9 +260,39 @@ bool BitmapClass_Instancing::initializeInstances(ID3D11Device *device) {
 		int Size = 24;
 
 		instances[i].position = D3DXVECTOR3(float(X - Width/2 - Size/2), float(Y + Height/2 - Size/2), 10*angle/i);
+		instances[i].size	  = 1.0f;
+		instances[i].color	  = D3DXVECTOR4(1.0f, 1.0f, 1.0f, 1.0f);
+		instances[i].uvRect	  = D3DXVECTOR4(0.0f, 0.0f, 1.0f, 1.0f);
 	}
 
-	angle += m_instanceCount / 1000;
+	angle += count / 1000;
+
+	return;
+}
+
+bool BitmapClass_Instancing::initializeInstances(ID3D11Device *device) {
+
+	InstanceType			*instances;
+	D3D11_BUFFER_DESC		 instanceBufferDesc;
+	D3D11_SUBRESOURCE_DATA   instanceData;
+
+	// We will now setup the new instance buffer.
+	// We start by first setting the number of instances of the triangle that will need to be rendered.
+	// For this tutorial I have manually set it to 4 so that we will have four triangles rendered on the screen.
+
+	// Set the number of instances in the array.
+	m_instanceCount = 30000;
+
+	// Next we create a temporary instance array using the instance count.
+	// Note we use the InstanceType structure for the array type which is defined in the ModelClass header file.
+
+	// Create the instance array.
+	instances = new InstanceType[m_instanceCount];
+	if (!instances)
+		return false;
+
+	// Now here is where we setup the different positions for each instance of the triangle.
+	BuildInstances(instances, m_instanceCount);
 
 
 	// The instance buffer description is setup exactly the same as a vertex buffer description.
@@ -291,18 +312,93 @@ bool BitmapClass_Instancing::initializeInstances(ID3D11Device *device) {
 	instanceData.SysMemPitch	  = 0;
 	instanceData.SysMemSlicePitch = 0;
 
+	// This function is called every frame, so the buffer from the previous frame has to be released first.
+	if (m_instanceBuffer) {
+		m_instanceBuffer->Release();
+		m_instanceBuffer = 0;
+	}
+
 	// Create the instance buffer.
 	HRESULT result = device->CreateBuffer(&instanceBufferDesc, &instanceData, &m_instanceBuffer);
-	if (FAILED(result))
-		return false;
 
 	// Release the instance array now that the instance buffer has been created and loaded.
 	delete[] instances;
 	instances = 0;
 
+	if (FAILED(result))
+		return false;
+
+	m_maxInstanceCount = m_instanceCount;
+
+	return true;
+}
+
+// InitializeDynamicInstances creates an empty dynamic instance buffer large enough for maxInstances instances.
+// Unlike initializeInstances it is called only once, the contents are then rewritten every frame through MapInstances / UnmapInstances,
+// so nothing is allocated or released while rendering.
+bool BitmapClass_Instancing::InitializeDynamicInstances(ID3D11Device *device, int maxInstances)
+{
+	D3D11_BUFFER_DESC instanceBufferDesc;
+	HRESULT			  result;
+
+	if (m_instanceBuffer) {
+		m_instanceBuffer->Release();
+		m_instanceBuffer = 0;
+	}
+
+	m_maxInstanceCount = maxInstances;
+	m_instanceCount	   = 0;
+
+	// Same as the dynamic vertex buffer: usage is dynamic and the CPU is allowed to write to it.
+	instanceBufferDesc.Usage			   = D3D11_USAGE_DYNAMIC;
+	instanceBufferDesc.ByteWidth		   = sizeof(InstanceType) * m_maxInstanceCount;
+	instanceBufferDesc.BindFlags		   = D3D11_BIND_VERTEX_BUFFER;
+	instanceBufferDesc.CPUAccessFlags	   = D3D11_CPU_ACCESS_WRITE;
+	instanceBufferDesc.MiscFlags		   = 0;
+	instanceBufferDesc.StructureByteStride = 0;
+
+	result = device->CreateBuffer(&instanceBufferDesc, NULL, &m_instanceBuffer);
+	if (FAILED(result))
+		return false;
+
+	return true;
+}
+
+// MapInstances locks the dynamic instance buffer with WRITE_DISCARD, so the driver can hand us a fresh piece of memory
+// while the GPU is still drawing from the previous one. The caller writes the instances straight into the buffer, no temporary array is needed.
+bool BitmapClass_Instancing::MapInstances(ID3D11DeviceContext *deviceContext, void **instances)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT					 result;
+
+	result = deviceContext->Map(m_instanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if (FAILED(result))
+		return false;
+
+	*instances = mappedResource.pData;
+
 	return true;
 }
 
+// UnmapInstances unlocks the buffer and stores the number of instances that were written, which is what gets drawn.
+void BitmapClass_Instancing::UnmapInstances(ID3D11DeviceContext *deviceContext, int instanceCount)
+{
+	TraceScopeClass scope("BitmapClass_Instancing::UnmapInstances");
+
+	deviceContext->Unmap(m_instanceBuffer, 0);
+
+	m_instanceCount = instanceCount < m_maxInstanceCount ? instanceCount : m_maxInstanceCount;
+
+	PerfStatsClass::CountMap(sizeof(InstanceType) * m_instanceCount);
+
+	return;
+}
+
+int BitmapClass_Instancing::GetMaxInstanceCount()
+{
+	return m_maxInstanceCount;
+}
+
 // ShutdownBuffers releases the vertex and index buffers.
 void BitmapClass_Instancing::ShutdownBuffers()
 {
@@ -325,6 +421,8 @@ void BitmapClass_Instancing::ShutdownBuffers()
 // to re-position the 2D bitmap image on the screen if need be.
 bool BitmapClass_Instancing::UpdateBuffers(ID3D11DeviceContext *deviceContext, int positionX, int positionY)
 {
+	TraceScopeClass scope("BitmapClass_Instancing::UpdateBuffers");
+
 	// We check if the position to render this image has changed.
 	// If it hasn't changed then we just exit since the vertex buffer doesn't need any changes for this frame.
 	// This check can save us a lot of processing.
@@ -396,6 +494,7 @@ bool BitmapClass_Instancing::UpdateBuffers(ID3D11DeviceContext *deviceContext, i
 
 	// Unlock the vertex buffer.
 	deviceContext->Unmap(m_vertexBuffer, 0);
+	PerfStatsClass::CountMap(sizeof(VertexType) * m_vertexCount);
 
 	// Release the vertex array as it is no longer needed.
 	delete[] vertices;
@@ -11,6 +11,7 @@
 #include <d3dx10math.h>
 
 #include "__textureClass.h"
+#include "__textureShaderClassInstancing.h"
 
 
 
@@ -18,19 +19,20 @@ class BitmapClass_Instancing {
 private:
 	// Each bitmap image is still a polygon object that gets rendered similar to 3D objects.
 	// For 2D images we just need a position vector and texture coordinates.
-	struct VertexType {
-		D3DXVECTOR3 position;
-		D3DXVECTOR2 texture;
-	};
+	// The types are the ones of the TextureShaderClass_Instancing, whose input layout is made from them.
+	typedef TextureShaderClass_Instancing::VertexType VertexType;
 
+public:
 	// We add a new structure that will hold the instance information.
 	// In this tutorial we are modifying the position of each instance of the triangle so we use a position vector.
 	// But note that it could be anything else you want to modify for each instance such as color, size, rotation, and so forth.
 	// You can modify multiple things at once for each instance also.
-	struct InstanceType {
-		D3DXVECTOR3 position;
-		//float		angle;
-	};
+	// The z component of the position is used as the rotation angle of the instance.
+	// Size scales the quad and color tints the texture, so the particle system can fade and shrink its particles.
+	// The uvRect is the part of the texture the instance shows: x, y are the top left texture coordinates and z, w are the width and height.
+	// With a sprite sheet every instance can show its own frame, see SpriteAnimatorClass.
+	// The ParticleSystemClass writes this structure directly, so its InstanceType must match this one.
+	typedef TextureShaderClass_Instancing::InstanceType InstanceType;
 
 public:
 	BitmapClass_Instancing();
@@ -49,6 +51,14 @@ public:
 	int GetInstanceCount();
 
 	bool initializeInstances(ID3D11Device *);
+	void BuildInstances(InstanceType *, int);
+
+	// A dynamic instance buffer can be created instead of the static one and refilled every frame.
+	// MapInstances returns a pointer to write up to maxInstances instances into, UnmapInstances sets how many were written.
+	bool InitializeDynamicInstances(ID3D11Device *, int);
+	bool MapInstances(ID3D11DeviceContext *, void **);
+	void UnmapInstances(ID3D11DeviceContext *, int);
+	int  GetMaxInstanceCount();
 
 private:
 	bool InitializeBuffers(ID3D11Device *);
@@ -76,6 +86,7 @@ private:
 	ID3D11Buffer	*m_instanceBuffer;
 	// The index count has been replaced with the instance count.
 	int				 m_instanceCount;
+	int				 m_maxInstanceCount;
 };
 
 #endif
@@ -0,0 +1,202 @@
+#include "__clusteredLightsClass.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
+
+#include <string.h>
+
+// The binning is split over at most this many threads, the calling one included.
+#define CLUSTERED_LIGHTS_MAX_THREADS 4
+
+ClusteredLightsClass::ClusteredLightsClass()
+{
+	m_maxLights	   = 0;
+	m_lightCount   = 0;
+	m_screenWidth  = 0;
+	m_screenHeight = 0;
+
+	m_lightBuffer	= 0;
+	m_gridBuffer	= 0;
+	m_indexBuffer	= 0;
+	m_lightView		= 0;
+	m_gridView		= 0;
+	m_indexView		= 0;
+	m_clusterBuffer = 0;
+}
+
+ClusteredLightsClass::ClusteredLightsClass(const ClusteredLightsClass& other)
+{
+}
+
+ClusteredLightsClass::~ClusteredLightsClass()
+{
+}
+
+bool ClusteredLightsClass::Initialize(ID3D11Device *device, int maxLights, int screenWidth, int screenHeight)
+{
+	D3D11_BUFFER_DESC bufferDesc;
+	int				  clusterCount = CLUSTERED_LIGHTS_X * CLUSTERED_LIGHTS_Y * CLUSTERED_LIGHTS_Z;
+	int				  threads	   = (int)thread::hardware_concurrency();
+
+	if (maxLights <= 0)
+		return false;
+
+	m_maxLights	   = maxLights;
+	m_screenWidth  = screenWidth;
+	m_screenHeight = screenHeight;
+
+	if (threads > CLUSTERED_LIGHTS_MAX_THREADS)
+		threads = CLUSTERED_LIGHTS_MAX_THREADS;
+
+	if (!m_clusters.Initialize(CLUSTERED_LIGHTS_X, CLUSTERED_LIGHTS_Y, CLUSTERED_LIGHTS_Z, CLUSTERED_LIGHTS_PER_CLUSTER, threads))
+		return false;
+
+	// The index list is as big as it can get, every cluster full.
+	if (!CreateStructuredBuffer(device, maxLights, sizeof(ClusterLightType), &m_lightBuffer, &m_lightView))
+		return false;
+
+	if (!CreateStructuredBuffer(device, clusterCount, 2 * sizeof(unsigned int), &m_gridBuffer, &m_gridView))
+		return false;
+
+	if (!CreateStructuredBuffer(device, clusterCount * CLUSTERED_LIGHTS_PER_CLUSTER, sizeof(unsigned int), &m_indexBuffer, &m_indexView))
+		return false;
+
+	bufferDesc.Usage			   = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth		   = sizeof(ClusterBufferType);
+	bufferDesc.BindFlags		   = D3D11_BIND_CONSTANT_BUFFER;
+	bufferDesc.CPUAccessFlags	   = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags		   = 0;
+	bufferDesc.StructureByteStride = 0;
+
+	if (FAILED(device->CreateBuffer(&bufferDesc, NULL, &m_clusterBuffer)))
+		return false;
+
+	return true;
+}
+
+void ClusteredLightsClass::Shutdown()
+{
+	ID3D11Buffer			 *buffers[4] = { m_lightBuffer, m_gridBuffer, m_indexBuffer, m_clusterBuffer };
+	ID3D11ShaderResourceView *views[3]	 = { m_lightView, m_gridView, m_indexView };
+
+	for (int i = 0; i < 3; i++)
+		if (views[i])
+			views[i]->Release();
+
+	for (int i = 0; i < 4; i++)
+		if (buffers[i])
+			buffers[i]->Release();
+
+	m_lightView		= 0;
+	m_gridView		= 0;
+	m_indexView		= 0;
+	m_lightBuffer	= 0;
+	m_gridBuffer	= 0;
+	m_indexBuffer	= 0;
+	m_clusterBuffer = 0;
+
+	m_clusters.Shutdown();
+
+	return;
+}
+
+void ClusteredLightsClass::SetProjection(D3DXMATRIX projectionMatrix, float screenNear, float screenDepth)
+{
+	m_clusters.SetFrustum(1.0f / projectionMatrix._11, 1.0f / projectionMatrix._22, screenNear, screenDepth);
+
+	return;
+}
+
+bool ClusteredLightsClass::Update(ID3D11DeviceContext *deviceContext, const ClusterLightType *lights, int lightCount, D3DXMATRIX viewMatrix)
+{
+	ClusterBufferType constants;
+
+	if (lightCount > m_maxLights)
+		lightCount = m_maxLights;
+
+	m_lightCount = lightCount;
+
+	m_clusters.Bin(lights, lightCount, (const float*)&viewMatrix);
+
+	constants.tileScale[0]	   = (float)CLUSTERED_LIGHTS_X / m_screenWidth;
+	constants.tileScale[1]	   = (float)CLUSTERED_LIGHTS_Y / m_screenHeight;
+	constants.clusterCounts[0] = CLUSTERED_LIGHTS_X;
+	constants.clusterCounts[1] = CLUSTERED_LIGHTS_Y;
+	constants.clusterCounts[2] = CLUSTERED_LIGHTS_Z;
+	constants.lightCount	   = lightCount;
+
+	m_clusters.GetDepthParameters(&constants.depthScale, &constants.depthBias);
+
+	if (lightCount > 0 && !Upload(deviceContext, m_lightBuffer, lights, lightCount * sizeof(ClusterLightType)))
+		return false;
+
+	if (!Upload(deviceContext, m_gridBuffer, m_clusters.GetGrid(), m_clusters.GetClusterCount() * 2 * sizeof(unsigned int)))
+		return false;
+
+	if (m_clusters.GetIndexCount() > 0 && !Upload(deviceContext, m_indexBuffer, m_clusters.GetIndices(), m_clusters.GetIndexCount() * sizeof(unsigned int)))
+		return false;
+
+	return Upload(deviceContext, m_clusterBuffer, &constants, sizeof(constants));
+}
+
+void ClusteredLightsClass::Bind(ID3D11DeviceContext *deviceContext)
+{
+	ID3D11ShaderResourceView *views[3] = { m_lightView, m_gridView, m_indexView };
+
+	deviceContext->PSSetShaderResources(1, 3, views);
+	deviceContext->PSSetConstantBuffers(1, 1, &m_clusterBuffer);
+
+	return;
+}
+
+int ClusteredLightsClass::GetIndexCount()
+{
+	return m_clusters.GetIndexCount();
+}
+
+int ClusteredLightsClass::GetDroppedCount()
+{
+	return m_clusters.GetDroppedCount();
+}
+
+// The buffers are rewritten every frame, so they are dynamic; the shader reads them as StructuredBuffers.
+bool ClusteredLightsClass::CreateStructuredBuffer(ID3D11Device *device, int count, int stride, ID3D11Buffer **buffer, ID3D11ShaderResourceView **view)
+{
+	D3D11_BUFFER_DESC				bufferDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+
+	bufferDesc.Usage			   = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth		   = count * stride;
+	bufferDesc.BindFlags		   = D3D11_BIND_SHADER_RESOURCE;
+	bufferDesc.CPUAccessFlags	   = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags		   = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	bufferDesc.StructureByteStride = stride;
+
+	if (FAILED(device->CreateBuffer(&bufferDesc, NULL, buffer)))
+		return false;
+
+	memset(&viewDesc, 0, sizeof(viewDesc));
+	viewDesc.Format				 = DXGI_FORMAT_UNKNOWN;
+	viewDesc.ViewDimension		 = D3D11_SRV_DIMENSION_BUFFER;
+	viewDesc.Buffer.FirstElement = 0;
+	viewDesc.Buffer.NumElements	 = count;
+
+	return SUCCEEDED(device->CreateShaderResourceView(*buffer, &viewDesc, view));
+}
+
+// Only the used part of a buffer is written, the rest is never read by the shader.
+bool ClusteredLightsClass::Upload(ID3D11DeviceContext *deviceContext, ID3D11Buffer *buffer, const void *data, int size)
+{
+	TraceScopeClass scope("ClusteredLightsClass::Upload");
+
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+	if (FAILED(deviceContext->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource)))
+		return false;
+
+	memcpy(mappedResource.pData, data, size);
+
+	deviceContext->Unmap(buffer, 0);
+	PerfStatsClass::CountMap(size);
+
+	return true;
+}
@@ -0,0 +1,66 @@
+// --------------------------------------------------------------------------------------------------------
+// ClusteredLightsClass feeds the point and spot lights to the light shader: every frame the lights are binned into
+// the clusters of the view frustum by a LightClusterClass, and the lights, the (offset, count) grid of the clusters
+// and the light index list are uploaded into structured buffers.
+//
+// Bind sets them for the pixel shader, in the slots the CLUSTERED_LIGHTS variant of _shaderLight.ps reads:
+// t1 the lights, t2 the cluster grid, t3 the light indices and b1 the constants to find the cluster of a pixel.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _CLUSTEREDLIGHTSCLASS_H_
+#define _CLUSTEREDLIGHTSCLASS_H_
+
+#include <d3d11.h>
+#include <d3dx10math.h>
+
+#include "__lightClusterClass.h"
+#include "__shaderConstantsClass.h"
+
+// The clusters: tiles across and down the screen, and slices in depth
+#define CLUSTERED_LIGHTS_X			 16
+#define CLUSTERED_LIGHTS_Y			 9
+#define CLUSTERED_LIGHTS_Z			 24
+#define CLUSTERED_LIGHTS_PER_CLUSTER 256
+
+
+
+class ClusteredLightsClass {
+ private:
+	typedef ShaderConstantsClass<D3DXMATRIX, D3DXVECTOR3, D3DXVECTOR4>::ClusterBufferType ClusterBufferType;
+
+ public:
+	ClusteredLightsClass();
+	ClusteredLightsClass(const ClusteredLightsClass &);
+   ~ClusteredLightsClass();
+
+	// Initialize takes the most lights there will be and the size of the screen.
+	bool Initialize(ID3D11Device *, int, int, int);
+	void Shutdown();
+
+	// SetProjection takes the projection matrix and the depths it was made with.
+	void SetProjection(D3DXMATRIX, float, float);
+
+	// Update bins the lights (in world space) for the view and uploads the buffers.
+	bool Update(ID3D11DeviceContext *, const ClusterLightType *, int, D3DXMATRIX);
+	void Bind(ID3D11DeviceContext *);
+
+	// The lights binned in the last Update: how many cluster entries there are, and how many didn't fit in their cluster.
+	int GetIndexCount();
+	int GetDroppedCount();
+
+ private:
+	bool CreateStructuredBuffer(ID3D11Device *, int, int, ID3D11Buffer **, ID3D11ShaderResourceView **);
+	bool Upload(ID3D11DeviceContext *, ID3D11Buffer *, const void *, int);
+
+ private:
+	LightClusterClass		  m_clusters;
+	int						  m_maxLights;
+	int						  m_lightCount;
+	int						  m_screenWidth, m_screenHeight;
+
+	ID3D11Buffer			 *m_lightBuffer,  *m_gridBuffer,  *m_indexBuffer;
+	ID3D11ShaderResourceView *m_lightView,	  *m_gridView,	  *m_indexView;
+	ID3D11Buffer			 *m_clusterBuffer;
+};
+
+#endif
@@ -3,13 +3,24 @@
 
 #include <d3d11.h>
 #include <d3dx10math.h>
-#include <d3dx11async.h>
-#include <fstream>
-using namespace std;
+
+#include "__shaderProgramClass.h"
 
 
 
 class ColorShaderClass {
+ public:
+	// The vertex of the models drawn with the color shader, a position and a color.
+	// The input layout is made from the VertexLayout, it can't get out of step with the struct.
+	struct VertexType {
+		D3DXVECTOR3 position;
+		D3DXVECTOR4 color;
+	};
+
+	typedef VertexLayoutClass<VertexType,
+							  VERTEX_ELEMENT(VertexType, position, PositionSemantic),
+							  VERTEX_ELEMENT(VertexType, color,	   ColorSemantic)> VertexLayout;
+
  private:
 	struct MatrixBufferType {
 		D3DXMATRIX world;
@@ -27,18 +38,7 @@ class ColorShaderClass {
 	bool Render(ID3D11DeviceContext*, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX);
 
  private:
-	bool InitializeShader(ID3D11Device*, HWND, WCHAR*, WCHAR*);
-	void ShutdownShader();
-	void OutputShaderErrorMessage(ID3D10Blob*, HWND, WCHAR*);
-
-	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX);
-	void RenderShader(ID3D11DeviceContext*, int);
-
- private:
-	ID3D11VertexShader* m_vertexShader;
-	ID3D11PixelShader* m_pixelShader;
-	ID3D11InputLayout* m_layout;
-	ID3D11Buffer* m_matrixBuffer;
+	ShaderProgramClass<VertexLayout, ConstantBufferClass<MatrixBufferType, SHADER_VERTEX, 0> > m_program;
 };
 
 #endif
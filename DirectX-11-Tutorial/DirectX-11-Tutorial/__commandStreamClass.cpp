@@ -0,0 +1,196 @@
+#include "__commandStreamClass.h"
+
+#include <string.h>
+
+CommandStreamClass::CommandStreamClass()
+{
+	m_cursor = 0;
+	m_valid	 = true;
+}
+
+CommandStreamClass::CommandStreamClass(const CommandStreamClass& other)
+{
+}
+
+CommandStreamClass::~CommandStreamClass()
+{
+}
+
+void CommandStreamClass::Clear()
+{
+	m_data.clear();
+	Rewind();
+
+	return;
+}
+
+void CommandStreamClass::WriteByte(unsigned char value)
+{
+	m_data.push_back(value);
+
+	return;
+}
+
+void CommandStreamClass::WriteUint(unsigned int value)
+{
+	while (value >= 0x80) {
+		m_data.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+
+	m_data.push_back((unsigned char)value);
+
+	return;
+}
+
+// The sign goes to the lowest bit, so small negative numbers stay short too.
+void CommandStreamClass::WriteInt(int value)
+{
+	WriteUint(((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+
+	return;
+}
+
+void CommandStreamClass::WriteFloat(float value)
+{
+	WriteBytes(&value, sizeof(value));
+
+	return;
+}
+
+void CommandStreamClass::WriteBytes(const void *data, int size)
+{
+	size_t start = m_data.size();
+
+	m_data.resize(start + size);
+
+	if (size > 0)
+		memcpy(&m_data[start], data, size);
+
+	return;
+}
+
+void CommandStreamClass::WriteString(const char *text)
+{
+	WriteBytes(text, (int)strlen(text) + 1);
+
+	return;
+}
+
+void CommandStreamClass::Rewind()
+{
+	m_cursor = 0;
+	m_valid	 = true;
+
+	return;
+}
+
+bool CommandStreamClass::AtEnd()
+{
+	return !m_valid || m_cursor >= (int)m_data.size();
+}
+
+bool CommandStreamClass::IsValid()
+{
+	return m_valid;
+}
+
+unsigned int CommandStreamClass::ReadByte()
+{
+	const unsigned char *data = Take(1);
+
+	return data ? *data : 0;
+}
+
+// A number has at most 5 bytes, the fifth holds the top 4 bits.
+unsigned int CommandStreamClass::ReadUint()
+{
+	unsigned int value = 0;
+
+	for (int shift = 0; shift < 35; shift += 7) {
+		const unsigned char *data = Take(1);
+
+		if (!data)
+			return 0;
+
+		value |= (unsigned int)(*data & 0x7F) << shift;
+
+		if (!(*data & 0x80))
+			return value;
+	}
+
+	m_valid = false;
+
+	return 0;
+}
+
+int CommandStreamClass::ReadInt()
+{
+	unsigned int value = ReadUint();
+
+	return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+float CommandStreamClass::ReadFloat()
+{
+	const unsigned char *data = Take(sizeof(float));
+	float				 value;
+
+	if (!data)
+		return 0.0f;
+
+	memcpy(&value, data, sizeof(value));
+
+	return value;
+}
+
+const void* CommandStreamClass::ReadBytes(int size)
+{
+	return Take(size);
+}
+
+// The string is read up to its terminating 0, a string without one fails the stream.
+const char* CommandStreamClass::ReadString()
+{
+	const unsigned char *start;
+
+	if (!m_valid)
+		return 0;
+
+	start = m_data.empty() ? 0 : &m_data[0] + m_cursor;
+
+	for (int i = m_cursor; i < (int)m_data.size(); i++)
+		if (!m_data[i]) {
+			m_cursor = i + 1;
+			return (const char*)start;
+		}
+
+	m_valid = false;
+
+	return 0;
+}
+
+const unsigned char* CommandStreamClass::GetData()
+{
+	return m_data.empty() ? 0 : &m_data[0];
+}
+
+int CommandStreamClass::GetSize()
+{
+	return (int)m_data.size();
+}
+
+const unsigned char* CommandStreamClass::Take(int size)
+{
+	const unsigned char *data;
+
+	if (!m_valid || size < 0 || size > (int)m_data.size() - m_cursor) {
+		m_valid = false;
+		return 0;
+	}
+
+	data	  = m_data.empty() ? 0 : &m_data[0] + m_cursor;
+	m_cursor += size;
+
+	return data;
+}
@@ -0,0 +1,59 @@
+// --------------------------------------------------------------------------------------------------------
+// CommandStreamClass is a growing buffer of bytes for recorded commands, and a cursor to read them back.
+// The numbers are written as variable length integers (7 bits a byte, the high bit set on all but the last byte),
+// so the handles, the counts and the small offsets of a draw take a byte each;
+// floats and blocks of data are copied as they are.
+//
+// Reading past the end or a malformed number makes the stream fail: every Read returns 0 from then on and IsValid is false.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _COMMANDSTREAMCLASS_H_
+#define _COMMANDSTREAMCLASS_H_
+
+#include <vector>
+using namespace std;
+
+
+
+class CommandStreamClass {
+ public:
+	CommandStreamClass();
+	CommandStreamClass(const CommandStreamClass &);
+   ~CommandStreamClass();
+
+	// Clear empties the stream and puts the cursor at its start, the memory is kept for the next recording.
+	void Clear();
+
+	void WriteByte(unsigned char);
+	void WriteUint(unsigned int);
+	void WriteInt(int);
+	void WriteFloat(float);
+	void WriteBytes(const void *, int);
+	void WriteString(const char *);
+
+	// Rewind puts the cursor at the start; the Read functions follow the Write functions.
+	// ReadBytes takes the size and returns a pointer into the stream, valid until it is written again. ReadString too, it is 0-terminated.
+	void		 Rewind();
+	bool		 AtEnd();
+	bool		 IsValid();
+	unsigned int ReadByte();
+	unsigned int ReadUint();
+	int			 ReadInt();
+	float		 ReadFloat();
+	const void*	 ReadBytes(int);
+	const char*	 ReadString();
+
+	const unsigned char* GetData();
+	int					 GetSize();
+
+ private:
+	const unsigned char* Take(int);
+
+ private:
+	vector<unsigned char> m_data;
+	int					  m_cursor;
+	bool				  m_valid;
+};
+
+#endif
@@ -1,10 +1,13 @@
 #include "__d3dClass.h"
 
+#include <string.h>
+
 d3dClass::d3dClass()
 {
 	m_swapChain		     = 0;
 	m_device			 = 0;
 	m_deviceContext		 = 0;
+	m_filteredContext	 = 0;
 	m_renderTargetView	 = 0;
 	m_depthStencilBuffer = 0;
 	m_depthStencilState  = 0;
@@ -13,6 +16,13 @@ d3dClass::d3dClass()
 
 	// Initialize the new depth stencil state to null in the class constructor.
 	m_depthDisabledStencilState = 0;
+
+	m_alphaEnableBlendingState		  = 0;
+	m_alphaDisableBlendingState		  = 0;
+	m_alphaPremultipliedBlendingState = 0;
+
+	m_sampleState	  = 0;
+	m_immediateContext = 0;
 }
 
 d3dClass::d3dClass(const d3dClass &other)
@@ -194,6 +204,22 @@ bool d3dClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	if( FAILED(result) )
 		return false;
 
+	// Put the state filter in front of the device context, the state changes of this class go through it too.
+	m_filteredContext = new FilteredContextClass;
+	if (!m_filteredContext)
+		return false;
+
+	if (!m_filteredContext->Initialize(m_deviceContext))
+		return false;
+
+	// The calls of the backend go to the filtered context too.
+	m_immediateContext = new D3DContextClass;
+	if (!m_immediateContext)
+		return false;
+
+	if (!m_immediateContext->Initialize(this, m_filteredContext))
+		return false;
+
 	// Get the pointer to the back buffer.
 	result = m_swapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (LPVOID*)&backBufferPtr);
 	if( FAILED(result) )
@@ -265,7 +291,7 @@ bool d3dClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 		return false;
 
 	// Set the depth stencil state.
-	m_deviceContext->OMSetDepthStencilState(m_depthStencilState, 1);
+	m_filteredContext->OMSetDepthStencilState(m_depthStencilState, 1);
 
 	// Initailze the depth stencil view.
 	ZeroMemory(&depthStencilViewDesc, sizeof(depthStencilViewDesc));
@@ -283,7 +309,7 @@ bool d3dClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 
 
 	// Bind the render target view and depth stencil buffer to the output render pipeline.
-	m_deviceContext->OMSetRenderTargets(1, &m_renderTargetView, m_depthStencilView);
+	m_filteredContext->OMSetRenderTargets(1, &m_renderTargetView, m_depthStencilView);
 
 
 
@@ -305,7 +331,7 @@ bool d3dClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 		return false;
 
 	// Now set the rasterizer state.
-	m_deviceContext->RSSetState(m_rasterState);
+	m_filteredContext->RSSetState(m_rasterState);
 
 	// Setup the viewport for rendering.
 	viewport.Width  = (float)screenWidth;
@@ -316,7 +342,10 @@ bool d3dClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 	viewport.TopLeftY = 0.0f;
 
 	// Create the viewport.
-	m_deviceContext->RSSetViewports(1, &viewport);
+	m_filteredContext->RSSetViewports(1, &viewport);
+
+	// Keep the viewport, it has to be restored after rendering into a render texture.
+	m_viewport = viewport;
 
 
 	// Setup the projection matrix.
@@ -376,8 +405,10 @@ bool d3dClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 		blendStateDescription.RenderTarget[0].SrcBlend		 = D3D11_BLEND_SRC_ALPHA;
 		blendStateDescription.RenderTarget[0].DestBlend		 = D3D11_BLEND_INV_SRC_ALPHA;
 		blendStateDescription.RenderTarget[0].BlendOp		 = D3D11_BLEND_OP_ADD;
+		// The alpha is blended "over" as well, so a layer drawn into a cleared render texture ends up with its coverage in the alpha
+		// and its color already multiplied by it, ready to be composited with the premultiplied state below.
 		blendStateDescription.RenderTarget[0].SrcBlendAlpha	 = D3D11_BLEND_ONE;
-		blendStateDescription.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+		blendStateDescription.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
 		blendStateDescription.RenderTarget[0].BlendOpAlpha	 = D3D11_BLEND_OP_ADD;
 		blendStateDescription.RenderTarget[0].RenderTargetWriteMask = 0x0f;
 		blendStateDescription.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
@@ -387,7 +418,16 @@ bool d3dClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 		if (FAILED(result))
 			return false;
 
+		// The premultiplied blend state is for the textures whose color is already multiplied by their alpha, like the cached layers.
+		// Blending them with SRC_ALPHA again would multiply the edges twice and darken them.
+		blendStateDescription.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+
+		result = m_device->CreateBlendState(&blendStateDescription, &m_alphaPremultipliedBlendingState);
+		if (FAILED(result))
+			return false;
+
 		// Modify the description to create an alpha disabled blend state description.
+		blendStateDescription.RenderTarget[0].SrcBlend	  = D3D11_BLEND_SRC_ALPHA;
 		blendStateDescription.RenderTarget[0].BlendEnable = false;
 
 		// Create the blend state using the description.
@@ -396,6 +436,27 @@ bool d3dClass::Initialize(int screenWidth, int screenHeight, bool vsync, HWND hw
 			return false;
 	}
 
+	// The sampler of the backend, the same as the shader classes make for themselves
+	{
+		D3D11_SAMPLER_DESC samplerDesc;
+
+		ZeroMemory(&samplerDesc, sizeof(samplerDesc));
+
+		samplerDesc.Filter		   = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+		samplerDesc.AddressU	   = D3D11_TEXTURE_ADDRESS_WRAP;
+		samplerDesc.AddressV	   = D3D11_TEXTURE_ADDRESS_WRAP;
+		samplerDesc.AddressW	   = D3D11_TEXTURE_ADDRESS_WRAP;
+		samplerDesc.MaxAnisotropy  = 1;
+		samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+		samplerDesc.MaxLOD		   = D3D11_FLOAT32_MAX;
+
+		result = m_device->CreateSamplerState(&samplerDesc, &m_sampleState);
+		if (FAILED(result))
+			return false;
+	}
+
+	m_immediateContext->SetRenderTarget(0);
+
 	return true;
 }
 
@@ -405,6 +466,18 @@ void d3dClass::Shutdown()
 	if (m_swapChain)
 		m_swapChain->SetFullscreenState(false, NULL);
 
+	// The objects of the backend that were not released by their owners
+	for (size_t i = 0; i < m_objects.size(); i++)
+		ReleaseObject(&m_objects[i]);
+
+	m_objects.clear();
+	m_freeHandles.clear();
+
+	if (m_sampleState) {
+		m_sampleState->Release();
+		m_sampleState = 0;
+	}
+
 	// Here we release the new (second) depth stencil
 	if (m_depthDisabledStencilState) {
 		m_depthDisabledStencilState->Release();
@@ -421,6 +494,11 @@ void d3dClass::Shutdown()
 		m_alphaDisableBlendingState = 0;
 	}
 
+	if (m_alphaPremultipliedBlendingState) {
+		m_alphaPremultipliedBlendingState->Release();
+		m_alphaPremultipliedBlendingState = 0;
+	}
+
 	if (m_rasterState) {
 		m_rasterState->Release();
 		m_rasterState = 0;
@@ -446,6 +524,18 @@ void d3dClass::Shutdown()
 		m_renderTargetView = 0;
 	}
 
+	if (m_immediateContext) {
+		m_immediateContext->Shutdown();
+		delete m_immediateContext;
+		m_immediateContext = 0;
+	}
+
+	if (m_filteredContext) {
+		m_filteredContext->Shutdown();
+		delete m_filteredContext;
+		m_filteredContext = 0;
+	}
+
 	if (m_deviceContext) {
 		m_deviceContext->Release();
 		m_deviceContext = 0;
@@ -475,10 +565,10 @@ void d3dClass::BeginScene(float red, float green, float blue, float alpha)
 	color[3] = alpha;
 
 	// Clear the back buffer.
-	m_deviceContext->ClearRenderTargetView(m_renderTargetView, color);
+	m_filteredContext->ClearRenderTargetView(m_renderTargetView, color);
 
 	// Clear the depth buffer.
-	m_deviceContext->ClearDepthStencilView(m_depthStencilView, D3D11_CLEAR_DEPTH, 1.0f, 0);
+	m_filteredContext->ClearDepthStencilView(m_depthStencilView, D3D11_CLEAR_DEPTH, 1.0f, 0);
 
 	return;
 }
@@ -503,9 +593,15 @@ ID3D11Device* d3dClass::GetDevice()
 	return m_device;
 }
 
+// Everyone draws through the filtered context, the real one is only used by it.
 ID3D11DeviceContext* d3dClass::GetDeviceContext()
 {
-	return m_deviceContext;
+	return m_filteredContext;
+}
+
+FilteredContextClass* d3dClass::GetFilteredContext()
+{
+	return m_filteredContext;
 }
 
 void d3dClass::GetProjectionMatrix(D3DXMATRIX& projectionMatrix)
@@ -540,12 +636,12 @@ void d3dClass::GetVideoCardInfo(char* cardName, int& memory)
 // then turn the Z buffer off and do your 2D rendering, and then turn the Z buffer on again.
 void d3dClass::TurnZBufferOn()
 {
-	m_deviceContext->OMSetDepthStencilState(m_depthStencilState, 1);
+	m_filteredContext->OMSetDepthStencilState(m_depthStencilState, 1);
 }
 
 void d3dClass::TurnZBufferOff()
 {
-	m_deviceContext->OMSetDepthStencilState(m_depthDisabledStencilState, 1);
+	m_filteredContext->OMSetDepthStencilState(m_depthDisabledStencilState, 1);
 }
 
 void d3dClass::TurnOnAlphaBlending()
@@ -553,7 +649,14 @@ void d3dClass::TurnOnAlphaBlending()
 	float blendFactor[] = { 0, 0, 0, 0 };
 
 	// Turn on the alpha blending.
-	m_deviceContext->OMSetBlendState(m_alphaEnableBlendingState, blendFactor, 0xffffffff);
+	m_filteredContext->OMSetBlendState(m_alphaEnableBlendingState, blendFactor, 0xffffffff);
+}
+
+void d3dClass::TurnOnPremultipliedAlphaBlending()
+{
+	float blendFactor[] = { 0, 0, 0, 0 };
+
+	m_filteredContext->OMSetBlendState(m_alphaPremultipliedBlendingState, blendFactor, 0xffffffff);
 }
 
 void d3dClass::TurnOffAlphaBlending()
@@ -561,5 +664,409 @@ void d3dClass::TurnOffAlphaBlending()
 	float blendFactor[] = { 0, 0, 0, 0 };
 
 	// Turn off the alpha blending.
-	m_deviceContext->OMSetBlendState(m_alphaDisableBlendingState, blendFactor, 0xffffffff);
-}
\ No newline at end of file
+	m_filteredContext->OMSetBlendState(m_alphaDisableBlendingState, blendFactor, 0xffffffff);
+}
+
+// SetBackBufferRenderTarget binds the back buffer and the depth buffer as the render target again.
+void d3dClass::SetBackBufferRenderTarget()
+{
+	m_filteredContext->OMSetRenderTargets(1, &m_renderTargetView, m_depthStencilView);
+}
+
+// ResetViewport restores the full screen viewport.
+void d3dClass::ResetViewport()
+{
+	m_filteredContext->RSSetViewports(1, &m_viewport);
+}
+// --- RenderBackendClass ---
+
+RenderBackendClass::HandleType d3dClass::CreateBuffer(const BufferDescType &desc, const void *data)
+{
+	BackendObjectType	   object;
+	D3D11_BUFFER_DESC	   bufferDesc;
+	D3D11_SUBRESOURCE_DATA initialData;
+	UINT				   bindFlags[4] = { D3D11_BIND_VERTEX_BUFFER, D3D11_BIND_INDEX_BUFFER, D3D11_BIND_CONSTANT_BUFFER, D3D11_BIND_SHADER_RESOURCE };
+
+	if (desc.type < RENDER_BUFFER_VERTEX || desc.type > RENDER_BUFFER_STRUCTURED || desc.size <= 0)
+		return 0;
+
+	ZeroMemory(&object, sizeof(object));
+	object.kind = D3D_OBJECT_BUFFER;
+
+	// A constant buffer is a multiple of 16 bytes
+	bufferDesc.Usage			   = desc.dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT;
+	bufferDesc.ByteWidth		   = desc.type == RENDER_BUFFER_CONSTANT ? (desc.size + 15) & ~15 : desc.size;
+	bufferDesc.BindFlags		   = bindFlags[desc.type];
+	bufferDesc.CPUAccessFlags	   = desc.dynamic ? D3D11_CPU_ACCESS_WRITE : 0;
+	bufferDesc.MiscFlags		   = desc.type == RENDER_BUFFER_STRUCTURED ? D3D11_RESOURCE_MISC_BUFFER_STRUCTURED : 0;
+	bufferDesc.StructureByteStride = desc.type == RENDER_BUFFER_STRUCTURED ? desc.stride : 0;
+
+	initialData.pSysMem			 = data;
+	initialData.SysMemPitch		 = 0;
+	initialData.SysMemSlicePitch = 0;
+
+	if (FAILED(m_device->CreateBuffer(&bufferDesc, data ? &initialData : NULL, &object.buffer)))
+		return 0;
+
+	if (desc.type == RENDER_BUFFER_STRUCTURED) {
+		D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+
+		ZeroMemory(&viewDesc, sizeof(viewDesc));
+		viewDesc.Format				 = DXGI_FORMAT_UNKNOWN;
+		viewDesc.ViewDimension		 = D3D11_SRV_DIMENSION_BUFFER;
+		viewDesc.Buffer.FirstElement = 0;
+		viewDesc.Buffer.NumElements	 = desc.size / desc.stride;
+
+		if (FAILED(m_device->CreateShaderResourceView(object.buffer, &viewDesc, &object.view))) {
+			ReleaseObject(&object);
+			return 0;
+		}
+	}
+
+	return NewObject(object);
+}
+
+RenderBackendClass::HandleType d3dClass::CreateTexture(const TextureDescType &desc, const void *data, int pitch)
+{
+	BackendObjectType	   object;
+	D3D11_TEXTURE2D_DESC   textureDesc;
+	D3D11_SUBRESOURCE_DATA initialData;
+
+	ZeroMemory(&object, sizeof(object));
+	object.kind	  = D3D_OBJECT_TEXTURE;
+	object.width  = desc.width;
+	object.height = desc.height;
+
+	ZeroMemory(&textureDesc, sizeof(textureDesc));
+	textureDesc.Width			 = desc.width;
+	textureDesc.Height			 = desc.height;
+	textureDesc.MipLevels		 = 1;
+	textureDesc.ArraySize		 = 1;
+	textureDesc.Format			 = (DXGI_FORMAT)desc.format;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage			 = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags		 = D3D11_BIND_SHADER_RESOURCE | (desc.renderTarget ? D3D11_BIND_RENDER_TARGET : 0);
+
+	initialData.pSysMem			 = data;
+	initialData.SysMemPitch		 = pitch;
+	initialData.SysMemSlicePitch = 0;
+
+	if (FAILED(m_device->CreateTexture2D(&textureDesc, data ? &initialData : NULL, &object.texture)))
+		return 0;
+
+	if (FAILED(m_device->CreateShaderResourceView(object.texture, NULL, &object.view)) ||
+		(desc.renderTarget && FAILED(m_device->CreateRenderTargetView(object.texture, NULL, &object.target)))) {
+		ReleaseObject(&object);
+		return 0;
+	}
+
+	return NewObject(object);
+}
+
+// The input layout of a vertex shader is made from its elements and its code.
+RenderBackendClass::HandleType d3dClass::CreateShader(const ShaderDescType &desc)
+{
+	BackendObjectType				 object;
+	vector<D3D11_INPUT_ELEMENT_DESC> layout(desc.elementCount);
+	HRESULT							 result;
+
+	ZeroMemory(&object, sizeof(object));
+	object.kind = D3D_OBJECT_SHADER;
+
+	if (desc.stage == RENDER_STAGE_PIXEL)
+		return SUCCEEDED(m_device->CreatePixelShader(desc.code, desc.size, NULL, &object.pixelShader)) ? NewObject(object) : 0;
+
+	if (desc.stage != RENDER_STAGE_VERTEX || FAILED(m_device->CreateVertexShader(desc.code, desc.size, NULL, &object.vertexShader)))
+		return 0;
+
+	for (int i = 0; i < desc.elementCount; i++) {
+		layout[i].SemanticName		   = desc.elements[i].semantic;
+		layout[i].SemanticIndex		   = desc.elements[i].semanticIndex;
+		layout[i].Format			   = (DXGI_FORMAT)desc.elements[i].format;
+		layout[i].InputSlot			   = desc.elements[i].slot;
+		layout[i].AlignedByteOffset	   = desc.elements[i].offset;
+		layout[i].InputSlotClass	   = desc.elements[i].perInstance ? D3D11_INPUT_PER_INSTANCE_DATA : D3D11_INPUT_PER_VERTEX_DATA;
+		layout[i].InstanceDataStepRate = desc.elements[i].perInstance ? 1 : 0;
+	}
+
+	if (desc.elementCount > 0) {
+		result = m_device->CreateInputLayout(&layout[0], desc.elementCount, desc.code, desc.size, &object.layout);
+
+		if (FAILED(result)) {
+			ReleaseObject(&object);
+			return 0;
+		}
+	}
+
+	return NewObject(object);
+}
+
+// The states are made like the ones of Initialize: the same blending, LESS depth test and solid fill, without stencil.
+RenderBackendClass::HandleType d3dClass::CreateState(const StateDescType &desc)
+{
+	BackendObjectType		 object;
+	D3D11_BLEND_DESC		 blendDesc;
+	D3D11_DEPTH_STENCIL_DESC depthDesc;
+	D3D11_RASTERIZER_DESC	 rasterDesc;
+
+	ZeroMemory(&object, sizeof(object));
+	object.kind = D3D_OBJECT_STATE;
+
+	ZeroMemory(&blendDesc, sizeof(blendDesc));
+	blendDesc.RenderTarget[0].BlendEnable			= desc.alphaBlending;
+	blendDesc.RenderTarget[0].SrcBlend				= D3D11_BLEND_SRC_ALPHA;
+	blendDesc.RenderTarget[0].DestBlend				= D3D11_BLEND_INV_SRC_ALPHA;
+	blendDesc.RenderTarget[0].BlendOp				= D3D11_BLEND_OP_ADD;
+	blendDesc.RenderTarget[0].SrcBlendAlpha			= D3D11_BLEND_ONE;
+	blendDesc.RenderTarget[0].DestBlendAlpha		= D3D11_BLEND_ZERO;
+	blendDesc.RenderTarget[0].BlendOpAlpha			= D3D11_BLEND_OP_ADD;
+	blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+	ZeroMemory(&depthDesc, sizeof(depthDesc));
+	depthDesc.DepthEnable	 = desc.depthTest;
+	depthDesc.DepthWriteMask = desc.depthWrite ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
+	depthDesc.DepthFunc		 = D3D11_COMPARISON_LESS;
+
+	ZeroMemory(&rasterDesc, sizeof(rasterDesc));
+	rasterDesc.FillMode				 = D3D11_FILL_SOLID;
+	rasterDesc.CullMode				 = desc.cullBack ? D3D11_CULL_BACK : D3D11_CULL_NONE;
+	rasterDesc.FrontCounterClockwise = false;
+	rasterDesc.DepthClipEnable		 = true;
+
+	if (FAILED(m_device->CreateBlendState(&blendDesc, &object.blendState)) ||
+		FAILED(m_device->CreateDepthStencilState(&depthDesc, &object.depthState)) ||
+		FAILED(m_device->CreateRasterizerState(&rasterDesc, &object.rasterState))) {
+		ReleaseObject(&object);
+		return 0;
+	}
+
+	return NewObject(object);
+}
+
+void d3dClass::Release(HandleType handle)
+{
+	BackendObjectType *object = FindObject(handle, 0);
+
+	if (!object)
+		return;
+
+	ReleaseObject(object);
+	m_freeHandles.push_back(handle);
+
+	return;
+}
+
+bool d3dClass::UpdateBuffer(HandleType handle, const void *data, int size)
+{
+	return m_immediateContext->UpdateBuffer(handle, data, size);
+}
+
+void d3dClass::BeginFrame(const float *color)
+{
+	BeginScene(color[0], color[1], color[2], color[3]);
+
+	return;
+}
+
+void d3dClass::EndFrame()
+{
+	EndScene();
+
+	return;
+}
+
+// The calls of a context go to the immediate one.
+void d3dClass::SetRenderTarget(HandleType handle)
+{
+	m_immediateContext->SetRenderTarget(handle);
+}
+
+void d3dClass::Clear(const float *color)
+{
+	m_immediateContext->Clear(color);
+}
+
+void d3dClass::SetState(HandleType handle)
+{
+	m_immediateContext->SetState(handle);
+}
+
+void d3dClass::SetShaders(HandleType vertexShader, HandleType pixelShader)
+{
+	m_immediateContext->SetShaders(vertexShader, pixelShader);
+}
+
+void d3dClass::SetVertexBuffers(int start, int count, const HandleType *buffers, const unsigned int *strides, const unsigned int *offsets)
+{
+	m_immediateContext->SetVertexBuffers(start, count, buffers, strides, offsets);
+}
+
+void d3dClass::SetIndexBuffer(HandleType buffer)
+{
+	m_immediateContext->SetIndexBuffer(buffer);
+}
+
+void d3dClass::SetConstantBuffers(int stages, int slot, int count, const HandleType *buffers)
+{
+	m_immediateContext->SetConstantBuffers(stages, slot, count, buffers);
+}
+
+void d3dClass::SetTextures(int stages, int slot, int count, const HandleType *textures)
+{
+	m_immediateContext->SetTextures(stages, slot, count, textures);
+}
+
+void d3dClass::Draw(int vertexCount, int startVertex)
+{
+	m_immediateContext->Draw(vertexCount, startVertex);
+}
+
+void d3dClass::DrawIndexed(int indexCount, int startIndex, int baseVertex)
+{
+	m_immediateContext->DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void d3dClass::DrawInstanced(int vertexCount, int instanceCount, int startVertex, int startInstance)
+{
+	m_immediateContext->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+}
+
+void d3dClass::DrawIndexedInstanced(int indexCount, int instanceCount, int startIndex, int baseVertex, int startInstance)
+{
+	m_immediateContext->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+// The device makes deferred contexts on any thread; the driver records the command lists itself or the runtime does it for it.
+RenderContextClass* d3dClass::CreateDeferredContext()
+{
+	ID3D11DeviceContext *deviceContext;
+	D3DContextClass		*context;
+	bool				 result;
+
+	if (FAILED(m_device->CreateDeferredContext(0, &deviceContext)))
+		return 0;
+
+	context = new D3DContextClass;
+	result	= context && context->Initialize(this, deviceContext);
+
+	// The context holds its own reference.
+	deviceContext->Release();
+
+	if (!result) {
+		delete context;
+		return 0;
+	}
+
+	return context;
+}
+
+// The command list does not restore the state of the immediate context, the filter forgets it and the back buffer is bound again.
+void d3dClass::ExecuteDeferredContext(RenderContextClass *context)
+{
+	ID3D11CommandList *commandList = ((D3DContextClass*)context)->FinishCommandList();
+
+	if (commandList) {
+		m_filteredContext->ExecuteCommandList(commandList, FALSE);
+		commandList->Release();
+	}
+
+	m_immediateContext->SetRenderTarget(0);
+
+	return;
+}
+
+void d3dClass::ReleaseDeferredContext(RenderContextClass *context)
+{
+	D3DContextClass *deferred = (D3DContextClass*)context;
+
+	if (deferred) {
+		deferred->Shutdown();
+		delete deferred;
+	}
+
+	return;
+}
+
+RenderBackendClass::HandleType d3dClass::ImportTexture(ID3D11ShaderResourceView *view, ID3D11RenderTargetView *target)
+{
+	BackendObjectType	 object;
+	ID3D11Resource		*resource;
+	D3D11_TEXTURE2D_DESC textureDesc;
+
+	if (!view)
+		return 0;
+
+	view->GetResource(&resource);
+
+	ZeroMemory(&object, sizeof(object));
+	object.kind = D3D_OBJECT_TEXTURE;
+	object.view = view;
+
+	if (FAILED(resource->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&object.texture))) {
+		resource->Release();
+		return 0;
+	}
+
+	resource->Release();
+	view->AddRef();
+
+	if (target) {
+		object.target = target;
+		target->AddRef();
+	}
+
+	object.texture->GetDesc(&textureDesc);
+	object.width  = textureDesc.Width;
+	object.height = textureDesc.Height;
+
+	return NewObject(object);
+}
+
+// A released handle is given out again before a new one.
+RenderBackendClass::HandleType d3dClass::NewObject(const BackendObjectType &object)
+{
+	HandleType handle;
+
+	if (!m_freeHandles.empty()) {
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+	}
+	else {
+		m_objects.push_back(object);
+		handle = (HandleType)m_objects.size();
+	}
+
+	m_objects[handle - 1] = object;
+
+	return handle;
+}
+
+// FindObject gives the object of a handle when it is of the kind asked for (any kind for 0), otherwise null.
+d3dClass::BackendObjectType* d3dClass::FindObject(HandleType handle, int kind)
+{
+	BackendObjectType *object;
+
+	if (!handle || handle > m_objects.size())
+		return 0;
+
+	object = &m_objects[handle - 1];
+
+	if (!object->kind || (kind && object->kind != kind))
+		return 0;
+
+	return object;
+}
+
+void d3dClass::ReleaseObject(BackendObjectType *object)
+{
+	IUnknown *interfaces[10] = { object->buffer, object->texture, object->view, object->target, object->vertexShader,
+								 object->pixelShader, object->layout, object->blendState, object->depthState, object->rasterState };
+
+	for (int i = 0; i < 10; i++)
+		if (interfaces[i])
+			interfaces[i]->Release();
+
+	ZeroMemory(object, sizeof(*object));
+
+	return;
+}
@@ -16,10 +16,44 @@
 #include <d3dcommon.h>
 #include <d3d11.h>
 #include <d3dx10math.h>
+#include <vector>
+using namespace std;
 
+#include "__filteredContextClass.h"
+#include "__renderBackendClass.h"
+#include "__d3dContextClass.h"
 
+// The kinds of the objects of the backend
+#define D3D_OBJECT_BUFFER  1
+#define D3D_OBJECT_TEXTURE 2
+#define D3D_OBJECT_SHADER  3
+#define D3D_OBJECT_STATE   4
+
+
+
+// d3dClass is also the Direct3D RenderBackendClass: the objects of the backend are made on its device
+// and the calls go through its filtered device context, so they mix with the calls of the classes that use the context directly.
+// Its deferred contexts are D3DContextClass objects on deferred device contexts, executed as command lists.
+class d3dClass : public RenderBackendClass {
+	friend class D3DContextClass;
+
+ private:
+	// An object of the backend, only the members of its kind are set
+	struct BackendObjectType {
+		int						  kind;		// 0 for a free handle, else D3D_OBJECT_BUFFER and so on
+		ID3D11Buffer			 *buffer;
+		ID3D11Texture2D			 *texture;
+		ID3D11ShaderResourceView *view;		// of a texture or a structured buffer
+		ID3D11RenderTargetView	 *target;
+		int						  width, height;
+		ID3D11VertexShader		 *vertexShader;
+		ID3D11PixelShader		 *pixelShader;
+		ID3D11InputLayout		 *layout;
+		ID3D11BlendState		 *blendState;
+		ID3D11DepthStencilState	 *depthState;
+		ID3D11RasterizerState	 *rasterState;
+	};
 
-class d3dClass {
  public:
 	d3dClass();
 	d3dClass(const d3dClass &);
@@ -34,6 +68,9 @@ class d3dClass {
 	ID3D11Device*		 GetDevice();
 	ID3D11DeviceContext* GetDeviceContext();
 
+	// The device context is a FilteredContextClass, it drops the state changes that change nothing and counts them.
+	FilteredContextClass* GetFilteredContext();
+
 	void GetProjectionMatrix(D3DXMATRIX &);
 	void GetWorldMatrix(D3DXMATRIX &);
 	void GetOrthoMatrix(D3DXMATRIX &);
@@ -48,6 +85,54 @@ class d3dClass {
 	void TurnOnAlphaBlending();
 	void TurnOffAlphaBlending();
 
+	// For textures with premultiplied alpha, such as the layers of LayerCacheClass
+	void TurnOnPremultipliedAlphaBlending();
+
+	// After rendering into a render texture these two put the back buffer and the full screen viewport back in place.
+	void SetBackBufferRenderTarget();
+	void ResetViewport();
+
+	// RenderBackendClass
+	HandleType CreateBuffer(const BufferDescType &, const void *);
+	HandleType CreateTexture(const TextureDescType &, const void *, int);
+	HandleType CreateShader(const ShaderDescType &);
+	HandleType CreateState(const StateDescType &);
+	void	   Release(HandleType);
+
+	bool UpdateBuffer(HandleType, const void *, int);
+
+	void BeginFrame(const float *);
+	void EndFrame();
+
+	void SetRenderTarget(HandleType);
+	void Clear(const float *);
+
+	void SetState(HandleType);
+	void SetShaders(HandleType, HandleType);
+	void SetVertexBuffers(int, int, const HandleType *, const unsigned int *, const unsigned int *);
+	void SetIndexBuffer(HandleType);
+	void SetConstantBuffers(int, int, int, const HandleType *);
+	void SetTextures(int, int, int, const HandleType *);
+
+	void Draw(int, int);
+	void DrawIndexed(int, int, int);
+	void DrawInstanced(int, int, int, int);
+	void DrawIndexedInstanced(int, int, int, int, int);
+
+	RenderContextClass* CreateDeferredContext();
+	void				ExecuteDeferredContext(RenderContextClass *);
+	void				ReleaseDeferredContext(RenderContextClass *);
+
+	// ImportTexture makes a texture of the backend from views made elsewhere, like the ones of TextureClass and RenderTextureClass,
+	// so the backend can draw with what the other classes load. With a render target view the texture can be a target too.
+	// The backend holds its own references, Release gives them back.
+	HandleType ImportTexture(ID3D11ShaderResourceView *, ID3D11RenderTargetView *);
+
+ private:
+	HandleType		   NewObject(const BackendObjectType &);
+	BackendObjectType* FindObject(HandleType, int);
+	void			   ReleaseObject(BackendObjectType *);
+
  private:
 	bool m_vsync_enabled;
 	int	 m_videoCardMemory;
@@ -56,11 +141,13 @@ class d3dClass {
 	IDXGISwapChain			*m_swapChain;
 	ID3D11Device			*m_device;
 	ID3D11DeviceContext		*m_deviceContext;
+	FilteredContextClass	*m_filteredContext;
 	ID3D11RenderTargetView	*m_renderTargetView;
 	ID3D11Texture2D			*m_depthStencilBuffer;
 	ID3D11DepthStencilState	*m_depthStencilState;
 	ID3D11DepthStencilView	*m_depthStencilView;
 	ID3D11RasterizerState	*m_rasterState;
+	D3D11_VIEWPORT			 m_viewport;
 
 	D3DXMATRIX				m_projectionMatrix;
 	D3DXMATRIX				m_worldMatrix;
@@ -72,6 +159,13 @@ class d3dClass {
 	// adding these in order to use alpha-channel
 	ID3D11BlendState* m_alphaEnableBlendingState;
 	ID3D11BlendState* m_alphaDisableBlendingState;
+	ID3D11BlendState* m_alphaPremultipliedBlendingState;
+
+	// The objects of the backend by handle, the sampler its pixel shaders get, and the context of its own calls
+	vector<BackendObjectType>	 m_objects;
+	vector<HandleType>			 m_freeHandles;
+	ID3D11SamplerState			*m_sampleState;
+	D3DContextClass				*m_immediateContext;
 };
 
 #endif
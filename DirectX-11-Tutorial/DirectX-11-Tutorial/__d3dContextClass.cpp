@@ -0,0 +1,254 @@
+#include "__d3dContextClass.h"
+#include "__d3dClass.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
+
+#include <string.h>
+
+D3DContextClass::D3DContextClass()
+{
+	m_owner			= 0;
+	m_context		= 0;
+	m_currentTarget = 0;
+}
+
+D3DContextClass::D3DContextClass(const D3DContextClass &other)
+{
+}
+
+D3DContextClass::~D3DContextClass()
+{
+}
+
+bool D3DContextClass::Initialize(d3dClass *owner, ID3D11DeviceContext *context)
+{
+	if (!owner || !context)
+		return false;
+
+	m_owner	  = owner;
+	m_context = context;
+	m_context->AddRef();
+
+	return true;
+}
+
+void D3DContextClass::Shutdown()
+{
+	if (m_context) {
+		m_context->Release();
+		m_context = 0;
+	}
+
+	m_owner			= 0;
+	m_currentTarget = 0;
+
+	return;
+}
+
+ID3D11DeviceContext* D3DContextClass::GetContext()
+{
+	return m_context;
+}
+
+// The context keeps nothing bound after the command list, the same as the immediate context after it executes it.
+ID3D11CommandList* D3DContextClass::FinishCommandList()
+{
+	ID3D11CommandList *commandList = 0;
+
+	if (FAILED(m_context->FinishCommandList(FALSE, &commandList)))
+		commandList = 0;
+
+	m_currentTarget = 0;
+
+	return commandList;
+}
+
+// A deferred context can Map only with WRITE_DISCARD, which is what a dynamic buffer is written with anyway.
+bool D3DContextClass::UpdateBuffer(HandleType handle, const void *data, int size)
+{
+	TraceScopeClass scope("D3DContextClass::UpdateBuffer");
+
+	d3dClass::BackendObjectType *object = m_owner->FindObject(handle, D3D_OBJECT_BUFFER);
+	D3D11_MAPPED_SUBRESOURCE	 mappedResource;
+
+	if (!object)
+		return false;
+
+	if (FAILED(m_context->Map(object->buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource)))
+		return false;
+
+	memcpy(mappedResource.pData, data, size);
+
+	m_context->Unmap(object->buffer, 0);
+	PerfStatsClass::CountMap(size);
+
+	return true;
+}
+
+void D3DContextClass::SetRenderTarget(HandleType handle)
+{
+	d3dClass::BackendObjectType *object = m_owner->FindObject(handle, D3D_OBJECT_TEXTURE);
+	D3D11_VIEWPORT				 viewport;
+
+	if (!object || !object->target) {
+		m_context->OMSetRenderTargets(1, &m_owner->m_renderTargetView, m_owner->m_depthStencilView);
+		m_context->RSSetViewports(1, &m_owner->m_viewport);
+
+		m_currentTarget = m_owner->m_renderTargetView;
+		return;
+	}
+
+	viewport		  = m_owner->m_viewport;
+	viewport.Width	  = (float)object->width;
+	viewport.Height	  = (float)object->height;
+	viewport.TopLeftX = 0.0f;
+	viewport.TopLeftY = 0.0f;
+
+	m_context->OMSetRenderTargets(1, &object->target, NULL);
+	m_context->RSSetViewports(1, &viewport);
+
+	m_currentTarget = object->target;
+
+	return;
+}
+
+void D3DContextClass::Clear(const float *color)
+{
+	if (m_currentTarget)
+		m_context->ClearRenderTargetView(m_currentTarget, color);
+
+	return;
+}
+
+void D3DContextClass::SetState(HandleType handle)
+{
+	d3dClass::BackendObjectType *object			= m_owner->FindObject(handle, D3D_OBJECT_STATE);
+	float						 blendFactor[4] = { 0, 0, 0, 0 };
+
+	if (!object)
+		return;
+
+	m_context->OMSetBlendState(object->blendState, blendFactor, 0xffffffff);
+	m_context->OMSetDepthStencilState(object->depthState, 1);
+	m_context->RSSetState(object->rasterState);
+
+	return;
+}
+
+// The shaders come with the input layout of the vertex shader, the sampler and the triangle lists.
+void D3DContextClass::SetShaders(HandleType vertexShader, HandleType pixelShader)
+{
+	d3dClass::BackendObjectType *vertex = m_owner->FindObject(vertexShader, D3D_OBJECT_SHADER);
+	d3dClass::BackendObjectType *pixel	= m_owner->FindObject(pixelShader,	D3D_OBJECT_SHADER);
+
+	m_context->IASetInputLayout(vertex ? vertex->layout : NULL);
+	m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	m_context->VSSetShader(vertex ? vertex->vertexShader : NULL, NULL, 0);
+	m_context->PSSetShader(pixel  ? pixel->pixelShader	 : NULL, NULL, 0);
+	m_context->PSSetSamplers(0, 1, &m_owner->m_sampleState);
+
+	return;
+}
+
+void D3DContextClass::SetVertexBuffers(int start, int count, const HandleType *buffers, const unsigned int *strides, const unsigned int *offsets)
+{
+	ID3D11Buffer *objects[RENDER_MAX_BINDINGS];
+
+	if (count > RENDER_MAX_BINDINGS)
+		count = RENDER_MAX_BINDINGS;
+
+	for (int i = 0; i < count; i++) {
+		d3dClass::BackendObjectType *object = m_owner->FindObject(buffers[i], D3D_OBJECT_BUFFER);
+
+		objects[i] = object ? object->buffer : NULL;
+	}
+
+	m_context->IASetVertexBuffers(start, count, objects, strides, offsets);
+
+	return;
+}
+
+void D3DContextClass::SetIndexBuffer(HandleType buffer)
+{
+	d3dClass::BackendObjectType *object = m_owner->FindObject(buffer, D3D_OBJECT_BUFFER);
+
+	m_context->IASetIndexBuffer(object ? object->buffer : NULL, DXGI_FORMAT_R32_UINT, 0);
+
+	return;
+}
+
+void D3DContextClass::SetConstantBuffers(int stages, int slot, int count, const HandleType *buffers)
+{
+	ID3D11Buffer *objects[RENDER_MAX_BINDINGS];
+
+	if (count > RENDER_MAX_BINDINGS)
+		count = RENDER_MAX_BINDINGS;
+
+	for (int i = 0; i < count; i++) {
+		d3dClass::BackendObjectType *object = m_owner->FindObject(buffers[i], D3D_OBJECT_BUFFER);
+
+		objects[i] = object ? object->buffer : NULL;
+	}
+
+	if (stages & RENDER_STAGE_VERTEX)
+		m_context->VSSetConstantBuffers(slot, count, objects);
+
+	if (stages & RENDER_STAGE_PIXEL)
+		m_context->PSSetConstantBuffers(slot, count, objects);
+
+	return;
+}
+
+void D3DContextClass::SetTextures(int stages, int slot, int count, const HandleType *textures)
+{
+	ID3D11ShaderResourceView *views[RENDER_MAX_BINDINGS];
+
+	if (count > RENDER_MAX_BINDINGS)
+		count = RENDER_MAX_BINDINGS;
+
+	for (int i = 0; i < count; i++) {
+		d3dClass::BackendObjectType *object = m_owner->FindObject(textures[i], 0);
+
+		views[i] = object ? object->view : NULL;
+	}
+
+	if (stages & RENDER_STAGE_VERTEX)
+		m_context->VSSetShaderResources(slot, count, views);
+
+	if (stages & RENDER_STAGE_PIXEL)
+		m_context->PSSetShaderResources(slot, count, views);
+
+	return;
+}
+
+void D3DContextClass::Draw(int vertexCount, int startVertex)
+{
+	m_context->Draw(vertexCount, startVertex);
+	PerfStatsClass::CountDraw();
+
+	return;
+}
+
+void D3DContextClass::DrawIndexed(int indexCount, int startIndex, int baseVertex)
+{
+	m_context->DrawIndexed(indexCount, startIndex, baseVertex);
+	PerfStatsClass::CountDraw();
+
+	return;
+}
+
+void D3DContextClass::DrawInstanced(int vertexCount, int instanceCount, int startVertex, int startInstance)
+{
+	m_context->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+	PerfStatsClass::CountDraw();
+
+	return;
+}
+
+void D3DContextClass::DrawIndexedInstanced(int indexCount, int instanceCount, int startIndex, int baseVertex, int startInstance)
+{
+	m_context->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+	PerfStatsClass::CountDraw();
+
+	return;
+}
@@ -0,0 +1,59 @@
+// --------------------------------------------------------------------------------------------------------
+// D3DContextClass is the RenderContextClass of d3dClass on one device context: the filtered immediate context
+// for the calls d3dClass takes itself, or a deferred context a pass records into on its own thread.
+// It finds the objects in the table of its d3dClass, which is only read while the passes record.
+//
+// The current target is per context: a deferred context starts without one, like its device context.
+// FinishCommandList closes what a deferred context recorded into a command list for the immediate context to execute,
+// and the context starts over empty, with nothing bound.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _D3DCONTEXTCLASS_H_
+#define _D3DCONTEXTCLASS_H_
+
+#include <d3d11.h>
+
+#include "__renderBackendClass.h"
+
+class d3dClass;
+
+
+
+class D3DContextClass : public RenderContextClass {
+ public:
+	D3DContextClass();
+	D3DContextClass(const D3DContextClass &);
+   ~D3DContextClass();
+
+	// Initialize takes a reference to the device context, Shutdown gives it back.
+	bool Initialize(d3dClass *, ID3D11DeviceContext *);
+	void Shutdown();
+
+	ID3D11DeviceContext* GetContext();
+	ID3D11CommandList*	 FinishCommandList();
+
+	// RenderContextClass
+	bool UpdateBuffer(HandleType, const void *, int);
+
+	void SetRenderTarget(HandleType);
+	void Clear(const float *);
+
+	void SetState(HandleType);
+	void SetShaders(HandleType, HandleType);
+	void SetVertexBuffers(int, int, const HandleType *, const unsigned int *, const unsigned int *);
+	void SetIndexBuffer(HandleType);
+	void SetConstantBuffers(int, int, int, const HandleType *);
+	void SetTextures(int, int, int, const HandleType *);
+
+	void Draw(int, int);
+	void DrawIndexed(int, int, int);
+	void DrawInstanced(int, int, int, int);
+	void DrawIndexedInstanced(int, int, int, int, int);
+
+ private:
+	d3dClass				*m_owner;
+	ID3D11DeviceContext		*m_context;
+	ID3D11RenderTargetView	*m_currentTarget;
+};
+
+#endif
@@ -241,6 +241,15 @@ bool DirectInputClass::IsEscapePressed()
 	return false;
 }
 
+// IsKeyPressed does the same for any key, given by its DIK_ code.
+bool DirectInputClass::IsKeyPressed(unsigned char key)
+{
+	if (m_keyboardState[key] & 0x80)
+		return true;
+
+	return false;
+}
+
 // GetMouseLocation is a helper function I wrote which returns the location of the mouse.
 // GraphicsClass can get this info and then use TextClass to render the mouse X and Y position to the screen.
 void DirectInputClass::GetMouseLocation(int &mouseX, int &mouseY, int &mouseZ)
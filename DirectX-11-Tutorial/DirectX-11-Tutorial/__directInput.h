@@ -33,6 +33,7 @@ class DirectInputClass {
 	bool Frame();
 
 	bool IsEscapePressed();
+	bool IsKeyPressed(unsigned char);
 	void GetMouseLocation(int&, int&, int&);
 
  private:
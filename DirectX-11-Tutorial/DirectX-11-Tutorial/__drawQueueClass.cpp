@@ -0,0 +1,261 @@
+#include "__drawQueueClass.h"
+
+#include <string.h>
+
+#define DEPTH_BITS 23
+
+DrawQueueClass::DrawQueueClass()
+{
+	memset(m_targets, 0, sizeof(m_targets));
+	memset(&m_submitted, 0, sizeof(m_submitted));
+	memset(&m_added, 0, sizeof(m_added));
+}
+
+DrawQueueClass::DrawQueueClass(const DrawQueueClass& other)
+{
+}
+
+DrawQueueClass::~DrawQueueClass()
+{
+}
+
+void DrawQueueClass::Reset()
+{
+	m_packets.clear();
+	m_entries.clear();
+	m_constants.clear();
+
+	memset(&m_added, 0, sizeof(m_added));
+
+	return;
+}
+
+void DrawQueueClass::SetPassTarget(int pass, HandleType target)
+{
+	if (pass >= 0 && pass < DRAW_QUEUE_MAX_PASSES)
+		m_targets[pass] = target;
+
+	return;
+}
+
+unsigned long long DrawQueueClass::MakeKey(int pass, bool blended, int shader, int texture, float depth)
+{
+	unsigned long long key;
+	unsigned long long z;
+	unsigned int	   maxDepth = (1 << DEPTH_BITS) - 1;
+
+	depth = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+	z	  = (unsigned long long)(depth * maxDepth);
+
+	key = (unsigned long long)(pass & 0xff) << 56;
+
+	if (!blended)
+		key |= (unsigned long long)(shader & 0xffff) << 39 | (unsigned long long)(texture & 0xffff) << DEPTH_BITS | z;
+	else
+		key |= 1ULL << 55 | (maxDepth - z) << 32 | (unsigned long long)(shader & 0xffff) << 16 | (unsigned long long)(texture & 0xffff);
+
+	return key;
+}
+
+// The draw is counted against the one added before it, for the statistics of the order the draws came in.
+void DrawQueueClass::AddDraw(unsigned long long key, const DrawType &draw, const void *constants, int constantSize)
+{
+	PacketType packet;
+	EntryType  entry;
+	int		   pass = (int)(key >> 56);
+
+	entry.draw			 = draw;
+	entry.constantOffset = (int)m_constants.size();
+	entry.constantSize	 = constants ? constantSize : 0;
+
+	if (entry.constantSize > 0)
+		m_constants.insert(m_constants.end(), (const unsigned char*)constants, (const unsigned char*)constants + entry.constantSize);
+
+	if (m_packets.empty())
+		Count(GetChanges(0, 0, draw, pass), &m_added);
+	else
+		Count(GetChanges(&m_entries.back().draw, (int)(m_packets.back().key >> 56), draw, pass), &m_added);
+
+	m_added.draws++;
+
+	packet.key	= key;
+	packet.draw = (int)m_entries.size();
+
+	m_entries.push_back(entry);
+	m_packets.push_back(packet);
+
+	return;
+}
+
+int DrawQueueClass::GetDrawCount()
+{
+	return (int)m_packets.size();
+}
+
+// The histograms of the eight bytes are made in one go; a byte that is the same in every key leaves the order as it is.
+void DrawQueueClass::Sort()
+{
+	int count = (int)m_packets.size();
+	int histograms[8][256];
+
+	if (count < 2)
+		return;
+
+	memset(histograms, 0, sizeof(histograms));
+
+	for (int i = 0; i < count; i++) {
+		unsigned long long key = m_packets[i].key;
+
+		for (int b = 0; b < 8; b++)
+			histograms[b][(key >> (b * 8)) & 0xff]++;
+	}
+
+	m_sorted.resize(count);
+
+	for (int b = 0; b < 8; b++) {
+		int *histogram = histograms[b];
+		int	 offset	   = 0;
+		int	 shift	   = b * 8;
+
+		if (histogram[(m_packets[0].key >> shift) & 0xff] == count)
+			continue;
+
+		for (int i = 0; i < 256; i++) {
+			int bucket = histogram[i];
+
+			histogram[i] = offset;
+			offset += bucket;
+		}
+
+		for (int i = 0; i < count; i++)
+			m_sorted[histogram[(m_packets[i].key >> shift) & 0xff]++] = m_packets[i];
+
+		m_packets.swap(m_sorted);
+	}
+
+	return;
+}
+
+void DrawQueueClass::Submit(RenderContextClass *context)
+{
+	const DrawType *previous	 = 0;
+	int				previousPass = 0;
+
+	memset(&m_submitted, 0, sizeof(m_submitted));
+
+	for (size_t i = 0; i < m_packets.size(); i++) {
+		const EntryType &entry	 = m_entries[m_packets[i].draw];
+		const DrawType	&draw	 = entry.draw;
+		int				 pass	 = (int)(m_packets[i].key >> 56);
+		int				 changes = GetChanges(previous, previousPass, draw, pass);
+
+		if (changes & DRAW_QUEUE_CHANGE_TARGET)
+			context->SetRenderTarget(m_targets[pass]);
+
+		if (changes & DRAW_QUEUE_CHANGE_STATE)
+			context->SetState(draw.state);
+
+		if (changes & DRAW_QUEUE_CHANGE_SHADERS)
+			context->SetShaders(draw.vertexShader, draw.pixelShader);
+
+		if (changes & DRAW_QUEUE_CHANGE_VERTEX_BUFFERS)
+			context->SetVertexBuffers(0, draw.vertexBufferCount, draw.vertexBuffers, draw.strides, draw.offsets);
+
+		if (changes & DRAW_QUEUE_CHANGE_INDEX_BUFFER)
+			context->SetIndexBuffer(draw.indexBuffer);
+
+		if (changes & DRAW_QUEUE_CHANGE_CONSTANT_BUFFERS) {
+			if (!previous || memcmp(previous->constantBuffers[0], draw.constantBuffers[0], sizeof(draw.constantBuffers[0])))
+				context->SetConstantBuffers(RENDER_STAGE_VERTEX, 0, DRAW_QUEUE_MAX_CONSTANTS, draw.constantBuffers[0]);
+
+			if (!previous || memcmp(previous->constantBuffers[1], draw.constantBuffers[1], sizeof(draw.constantBuffers[1])))
+				context->SetConstantBuffers(RENDER_STAGE_PIXEL, 0, DRAW_QUEUE_MAX_CONSTANTS, draw.constantBuffers[1]);
+		}
+
+		if (changes & DRAW_QUEUE_CHANGE_TEXTURES)
+			context->SetTextures(RENDER_STAGE_PIXEL, 0, DRAW_QUEUE_MAX_TEXTURES, draw.textures);
+
+		Count(changes, &m_submitted);
+		m_submitted.draws++;
+
+		// The constants of every draw are its own, they are written whatever changed.
+		if (entry.constantSize > 0)
+			context->UpdateBuffer(draw.constantBuffer, &m_constants[entry.constantOffset], entry.constantSize);
+
+		if (draw.indexBuffer) {
+			if (draw.instanceCount > 1)
+				context->DrawIndexedInstanced(draw.count, draw.instanceCount, draw.start, draw.baseVertex, draw.startInstance);
+			else
+				context->DrawIndexed(draw.count, draw.start, draw.baseVertex);
+		}
+		else {
+			if (draw.instanceCount > 1)
+				context->DrawInstanced(draw.count, draw.instanceCount, draw.start, draw.startInstance);
+			else
+				context->Draw(draw.count, draw.start);
+		}
+
+		previous	 = &draw;
+		previousPass = pass;
+	}
+
+	return;
+}
+
+void DrawQueueClass::GetStatistics(StatisticsType *submitted, StatisticsType *added)
+{
+	*submitted = m_submitted;
+	*added	   = m_added;
+
+	return;
+}
+
+// GetChanges gives the DRAW_QUEUE_CHANGE_ bits of what a draw binds differently from the draw before it, all of them for the first draw.
+int DrawQueueClass::GetChanges(const DrawType *previous, int previousPass, const DrawType &draw, int pass)
+{
+	int changes = 0;
+
+	if (!previous)
+		return DRAW_QUEUE_CHANGE_TARGET | DRAW_QUEUE_CHANGE_STATE | DRAW_QUEUE_CHANGE_SHADERS | DRAW_QUEUE_CHANGE_VERTEX_BUFFERS |
+			   DRAW_QUEUE_CHANGE_INDEX_BUFFER | DRAW_QUEUE_CHANGE_CONSTANT_BUFFERS | DRAW_QUEUE_CHANGE_TEXTURES;
+
+	if (pass != previousPass)
+		changes |= DRAW_QUEUE_CHANGE_TARGET;
+
+	if (draw.state != previous->state)
+		changes |= DRAW_QUEUE_CHANGE_STATE;
+
+	if (draw.vertexShader != previous->vertexShader || draw.pixelShader != previous->pixelShader)
+		changes |= DRAW_QUEUE_CHANGE_SHADERS;
+
+	if (draw.vertexBufferCount != previous->vertexBufferCount ||
+		memcmp(draw.vertexBuffers, previous->vertexBuffers, draw.vertexBufferCount * sizeof(HandleType)) ||
+		memcmp(draw.strides, previous->strides, draw.vertexBufferCount * sizeof(unsigned int)) ||
+		memcmp(draw.offsets, previous->offsets, draw.vertexBufferCount * sizeof(unsigned int)))
+		changes |= DRAW_QUEUE_CHANGE_VERTEX_BUFFERS;
+
+	if (draw.indexBuffer != previous->indexBuffer)
+		changes |= DRAW_QUEUE_CHANGE_INDEX_BUFFER;
+
+	if (memcmp(draw.constantBuffers, previous->constantBuffers, sizeof(draw.constantBuffers)))
+		changes |= DRAW_QUEUE_CHANGE_CONSTANT_BUFFERS;
+
+	if (memcmp(draw.textures, previous->textures, sizeof(draw.textures)))
+		changes |= DRAW_QUEUE_CHANGE_TEXTURES;
+
+	return changes;
+}
+
+void DrawQueueClass::Count(int changes, StatisticsType *statistics)
+{
+	int *counters[7] = { &statistics->targets, &statistics->states, &statistics->shaders, &statistics->vertexBuffers,
+						 &statistics->indexBuffers, &statistics->constantBuffers, &statistics->textures };
+
+	for (int i = 0; i < 7; i++)
+		if (changes & (1 << i)) {
+			(*counters[i])++;
+			statistics->calls++;
+		}
+
+	return;
+}
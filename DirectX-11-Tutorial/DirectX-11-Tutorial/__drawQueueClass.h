@@ -0,0 +1,112 @@
+// --------------------------------------------------------------------------------------------------------
+// DrawQueueClass collects the draws of a frame and submits them sorted, so the draws that share a shader and a texture
+// come together, whatever order the code that made them ran in.
+// A draw is a packet of its 64 bit sort key and the index of its parameters: everything it binds, the constants it writes
+// into its constant buffer before drawing (copied into the queue), and the draw call.
+//
+// The key is made by MakeKey, from the high bits down:
+// - the pass, 8 bits: a pass draws into its own target, the passes go in their order;
+// - the blending, 1 bit: the opaque draws first;
+// - for an opaque draw the shader, 16 bits, the texture, 16 bits, and the depth, 23 bits, front to back;
+//   for a blended draw the depth first, back to front, so the blending stays right, then the shader and the texture.
+// Sort is an LSD radix sort of the packets a byte at a time, stable, skipping the bytes all the keys share;
+// the draws with the same key keep the order they were added in.
+// Submit binds only what changed from the draw before and counts it. The queue also counts what would have changed
+// in the order the draws were added, so the difference is what the sorting saved.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _DRAWQUEUECLASS_H_
+#define _DRAWQUEUECLASS_H_
+
+#include <vector>
+using namespace std;
+
+#include "__renderBackendClass.h"
+
+#define DRAW_QUEUE_MAX_PASSES		   256
+#define DRAW_QUEUE_MAX_VERTEX_BUFFERS  2
+#define DRAW_QUEUE_MAX_CONSTANTS	   3		// constant buffers per stage
+#define DRAW_QUEUE_MAX_TEXTURES		   4		// of the pixel shader
+
+// What changes from a draw to the next, counted by StatisticsType
+#define DRAW_QUEUE_CHANGE_TARGET		   1
+#define DRAW_QUEUE_CHANGE_STATE			   2
+#define DRAW_QUEUE_CHANGE_SHADERS		   4
+#define DRAW_QUEUE_CHANGE_VERTEX_BUFFERS   8
+#define DRAW_QUEUE_CHANGE_INDEX_BUFFER	   16
+#define DRAW_QUEUE_CHANGE_CONSTANT_BUFFERS 32
+#define DRAW_QUEUE_CHANGE_TEXTURES		   64
+
+
+
+class DrawQueueClass {
+ public:
+	typedef RenderContextClass::HandleType HandleType;
+
+	// What a draw binds and draws. The slots that are not used are 0; the vertex constant buffers and textures start at slot 0.
+	struct DrawType {
+		HandleType	 state;
+		HandleType	 vertexShader, pixelShader;
+		int			 vertexBufferCount;
+		HandleType	 vertexBuffers[DRAW_QUEUE_MAX_VERTEX_BUFFERS];
+		unsigned int strides[DRAW_QUEUE_MAX_VERTEX_BUFFERS], offsets[DRAW_QUEUE_MAX_VERTEX_BUFFERS];
+		HandleType	 indexBuffer;	// 0 for a draw without indices
+		HandleType	 constantBuffers[2][DRAW_QUEUE_MAX_CONSTANTS];		// vertex, pixel
+		HandleType	 textures[DRAW_QUEUE_MAX_TEXTURES];
+		HandleType	 constantBuffer;	// the buffer the constants of the draw are written into
+		int			 count, instanceCount, start, baseVertex, startInstance;
+	};
+
+	struct StatisticsType {
+		int draws;
+		int targets, states, shaders, vertexBuffers, indexBuffers, constantBuffers, textures;
+		int calls;		// the binding calls, all of the above
+	};
+
+ private:
+	struct PacketType {
+		unsigned long long key;
+		int				   draw;
+	};
+
+	// The parameters of a draw and where its constants are
+	struct EntryType {
+		DrawType draw;
+		int		 constantOffset, constantSize;
+	};
+
+ public:
+	DrawQueueClass();
+	DrawQueueClass(const DrawQueueClass &);
+   ~DrawQueueClass();
+
+	// Reset empties the queue for the next frame, the memory is kept. The targets of the passes stay.
+	void Reset();
+	void SetPassTarget(int, HandleType);
+
+	// MakeKey takes the pass, the blending, the shader and texture ids (16 bits are kept) and the depth from 0 to 1.
+	static unsigned long long MakeKey(int, bool, int, int, float);
+
+	void AddDraw(unsigned long long, const DrawType &, const void *, int);
+	int	 GetDrawCount();
+
+	void Sort();
+	void Submit(RenderContextClass *);
+
+	// The changes of the last Submit, and the ones the draws would have made in the order they were added.
+	void GetStatistics(StatisticsType *, StatisticsType *);
+
+ private:
+	static int	GetChanges(const DrawType *, int, const DrawType &, int);
+	static void Count(int, StatisticsType *);
+
+ private:
+	vector<PacketType>	  m_packets, m_sorted;
+	vector<EntryType>	  m_entries;
+	vector<unsigned char> m_constants;
+	HandleType			  m_targets[DRAW_QUEUE_MAX_PASSES];
+	StatisticsType		  m_submitted, m_added;
+};
+
+#endif
@@ -0,0 +1,396 @@
+#include "__dynamicFontClass.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
+
+// The atlas pages are square textures of that many pixels, at most DYNAMIC_FONT_PAGES of them.
+#define DYNAMIC_FONT_PAGE_SIZE 512
+#define DYNAMIC_FONT_PAGES	   4
+
+// In SDF mode the glyphs are rasterized at that size, with a distance field reaching that many pixels out of the outline.
+#define DYNAMIC_FONT_SDF_SIZE   32
+#define DYNAMIC_FONT_SDF_SPREAD 4
+
+DynamicFontClass::DynamicFontClass()
+{
+	m_device		 = 0;
+	m_Rasterizer	 = 0;
+	m_Atlas			 = 0;
+	m_maxVertexCount = 0;
+	m_vertexBuffer	 = 0;
+	m_indexBuffer	 = 0;
+	m_vertices		 = 0;
+	m_quadPages		 = 0;
+}
+
+DynamicFontClass::DynamicFontClass(const DynamicFontClass& other)
+{
+}
+
+DynamicFontClass::~DynamicFontClass()
+{
+}
+
+bool DynamicFontClass::Initialize(ID3D11Device *device, HWND hwnd, WCHAR *fontFile, WCHAR *faceName, int screenWidth, int screenHeight, D3DXMATRIX baseViewMatrix, int maxLetters, bool sdf)
+{
+	m_device		 = device;
+	m_screenWidth	 = screenWidth;
+	m_screenHeight	 = screenHeight;
+	m_baseViewMatrix = baseViewMatrix;
+	m_maxVertexCount = 6 * maxLetters;
+
+	m_Rasterizer = new GdiGlyphRasterizerClass;
+	if (!m_Rasterizer)
+		return false;
+
+	if (!m_Rasterizer->Initialize(fontFile, faceName)) {
+		MessageBox(hwnd, fontFile, L"Could not load the font file", MB_OK);
+		return false;
+	}
+
+	// The glyphs are rasterized on the worker thread of the atlas.
+	m_Atlas = new GlyphAtlasClass;
+	if (!m_Atlas)
+		return false;
+
+	if (sdf)
+		m_Atlas->EnableSdf(DYNAMIC_FONT_SDF_SIZE, DYNAMIC_FONT_SDF_SPREAD);
+
+	if (!m_Atlas->Initialize(m_Rasterizer, DYNAMIC_FONT_PAGE_SIZE, DYNAMIC_FONT_PAGES, true)) {
+		MessageBox(hwnd, L"Could not initialize the glyph atlas.", L"Error", MB_OK);
+		return false;
+	}
+
+	m_vertices	= new VertexType[m_maxVertexCount];
+	m_quadPages = new int[maxLetters];
+	if (!m_vertices || !m_quadPages)
+		return false;
+
+	if (!InitializeBuffers(device)) {
+		MessageBox(hwnd, L"Could not initialize the dynamic font buffers.", L"Error", MB_OK);
+		return false;
+	}
+
+	return true;
+}
+
+void DynamicFontClass::Shutdown()
+{
+	// The atlas goes first, its worker thread uses the rasterizer.
+	if (m_Atlas) {
+		m_Atlas->Shutdown();
+		delete m_Atlas;
+		m_Atlas = 0;
+	}
+
+	if (m_Rasterizer) {
+		m_Rasterizer->Shutdown();
+		delete m_Rasterizer;
+		m_Rasterizer = 0;
+	}
+
+	for (size_t i = 0; i < m_pageTextures.size(); i++) {
+		m_pageViews[i]->Release();
+		m_pageTextures[i]->Release();
+	}
+
+	m_pageViews.clear();
+	m_pageTextures.clear();
+
+	if (m_indexBuffer) {
+		m_indexBuffer->Release();
+		m_indexBuffer = 0;
+	}
+
+	if (m_vertexBuffer) {
+		m_vertexBuffer->Release();
+		m_vertexBuffer = 0;
+	}
+
+	if (m_vertices) {
+		delete [] m_vertices;
+		m_vertices = 0;
+	}
+
+	if (m_quadPages) {
+		delete [] m_quadPages;
+		m_quadPages = 0;
+	}
+
+	return;
+}
+
+// Frame lets the atlas pack the new glyphs, creates the textures of the new pages
+// and copies only the dirty rectangle of every page into its texture.
+bool DynamicFontClass::Frame(ID3D11DeviceContext *deviceContext)
+{
+	TraceScopeClass scope("DynamicFontClass::Frame");
+
+	int pageSize, left, top, right, bottom;
+	D3D11_BOX box;
+
+	m_Atlas->Update();
+
+	pageSize = m_Atlas->GetPageSize();
+
+	for (int page = 0; page < m_Atlas->GetPageCount(); page++) {
+
+		// A new page gets its texture with its current content, nothing to upload then.
+		if (page >= (int)m_pageTextures.size()) {
+			if (!CreatePageTexture(page))
+				return false;
+
+			m_Atlas->ClearDirtyRect(page);
+			continue;
+		}
+
+		if (!m_Atlas->GetDirtyRect(page, &left, &top, &right, &bottom))
+			continue;
+
+		box.left   = left;
+		box.top	   = top;
+		box.right  = right;
+		box.bottom = bottom;
+		box.front  = 0;
+		box.back   = 1;
+
+		deviceContext->UpdateSubresource(m_pageTextures[page], 0, &box, m_Atlas->GetPagePixels(page) + top * pageSize + left, pageSize, 0);
+		PerfStatsClass::CountMap((right - left) * (bottom - top));
+
+		m_Atlas->ClearDirtyRect(page);
+	}
+
+	return true;
+}
+
+// Render lays out the text on the baseline, builds one quad per visible glyph and draws the quads page by page.
+// Like the TextOutClass, it uses the base view matrix, so the text stays at the same place on the screen.
+// In SDF mode the metrics and the quads of the base size are scaled to the asked size.
+bool DynamicFontClass::Render(ID3D11DeviceContext *deviceContext, FontShaderClass *fontShader, const char *text, int positionX, int positionY,
+							  int size, const D3DXVECTOR4 &color, D3DXMATRIX worldMatrix, D3DXMATRIX orthoMatrix)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	unsigned int codepoint, stride, offset;
+	int	  ascent, lineHeight, length, quadCount, pageCount, first;
+	float penX, startX, baseline, left, top, right, bottom, pageSize, scale;
+	const GlyphAtlasClass::GlyphType *glyph;
+	VertexType *v, *dest;
+	HRESULT result;
+
+	scale = 1.0f;
+
+	if (m_Atlas->IsSdf()) {
+		scale = size / (float)m_Atlas->GetSdfSize();
+		m_Atlas->GetLineMetrics(m_Atlas->GetSdfSize(), &ascent, &lineHeight);
+	}
+	else {
+		m_Atlas->GetLineMetrics(size, &ascent, &lineHeight);
+	}
+
+	pageSize = (float)m_Atlas->GetPageSize();
+	pageCount = m_Atlas->GetPageCount();
+
+	// In DirectX's 2d scene the point (0, 0) lies at the center of the screen.
+	startX	 = (float)(m_screenWidth / -2 + positionX);
+	penX	 = startX;
+	baseline = (float)(m_screenHeight / 2 - positionY) - ascent * scale;
+
+	quadCount = 0;
+
+	while ((length = GlyphAtlasClass::DecodeUtf8(text, &codepoint)) > 0) {
+		text += length;
+
+		if (codepoint == '\n') {
+			penX	  = startX;
+			baseline -= lineHeight * scale;
+			continue;
+		}
+
+		glyph = m_Atlas->FindGlyph(codepoint, size);
+
+		// Not rasterized yet: leave the room of an average letter.
+		if (!glyph) {
+			penX += size / 2;
+			continue;
+		}
+
+		// A glyph without pixels, or a page the texture of which is not created yet (it will be by the next Frame).
+		if (glyph->page < 0 || glyph->page >= (int)m_pageTextures.size() || glyph->width == 0 || 6 * quadCount >= m_maxVertexCount) {
+			penX += glyph->advance * scale;
+			continue;
+		}
+
+		left   = penX + glyph->bearingX * scale;
+		top	   = baseline + glyph->bearingY * scale;
+		right  = left + glyph->width * scale;
+		bottom = top - glyph->height * scale;
+
+		float u0 = glyph->x / pageSize;
+		float v0 = glyph->y / pageSize;
+		float u1 = (glyph->x + glyph->width) / pageSize;
+		float v1 = (glyph->y + glyph->height) / pageSize;
+
+		v = m_vertices + 6 * quadCount;
+
+		// First triangle in quad.
+		v[0].position = D3DXVECTOR3(left, top, 0.0f);		v[0].texture = D3DXVECTOR2(u0, v0);		// Top left.
+		v[1].position = D3DXVECTOR3(right, bottom, 0.0f);	v[1].texture = D3DXVECTOR2(u1, v1);		// Bottom right.
+		v[2].position = D3DXVECTOR3(left, bottom, 0.0f);	v[2].texture = D3DXVECTOR2(u0, v1);		// Bottom left.
+
+		// Second triangle in quad.
+		v[3].position = D3DXVECTOR3(left, top, 0.0f);		v[3].texture = D3DXVECTOR2(u0, v0);		// Top left.
+		v[4].position = D3DXVECTOR3(right, top, 0.0f);		v[4].texture = D3DXVECTOR2(u1, v0);		// Top right.
+		v[5].position = D3DXVECTOR3(right, bottom, 0.0f);	v[5].texture = D3DXVECTOR2(u1, v1);		// Bottom right.
+
+		for (int i = 0; i < 6; i++)
+			v[i].color = color;
+
+		m_quadPages[quadCount++] = glyph->page;
+		penX += glyph->advance * scale;
+	}
+
+	if (quadCount == 0)
+		return true;
+
+	// Copy the quads into the vertex buffer grouped by page.
+	result = deviceContext->Map(m_vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if (FAILED(result))
+		return false;
+
+	dest = (VertexType*)mappedResource.pData;
+
+	m_pageQuadCount.assign(pageCount, 0);
+
+	for (int page = 0; page < pageCount; page++)
+		for (int i = 0; i < quadCount; i++)
+			if (m_quadPages[i] == page) {
+				memcpy(dest, m_vertices + 6 * i, sizeof(VertexType) * 6);
+				dest += 6;
+				m_pageQuadCount[page]++;
+			}
+
+	deviceContext->Unmap(m_vertexBuffer, 0);
+	PerfStatsClass::CountMap(sizeof(VertexType) * 6 * quadCount);
+
+	deviceContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	stride = sizeof(VertexType);
+	first  = 0;
+
+	// One draw per page, the vertex buffer offset moves to the first quad of the page.
+	for (int page = 0; page < pageCount; page++) {
+
+		if (m_pageQuadCount[page] == 0)
+			continue;
+
+		offset = sizeof(VertexType) * 6 * first;
+
+		deviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
+
+		if (!fontShader->Render(deviceContext, 6 * m_pageQuadCount[page], worldMatrix, m_baseViewMatrix, orthoMatrix, m_pageViews[page], m_Atlas->IsSdf()))
+			return false;
+
+		first += m_pageQuadCount[page];
+	}
+
+	return true;
+}
+
+const unsigned int* DynamicFontClass::GetVersionCounter()
+{
+	return m_Atlas->GetVersionCounter();
+}
+
+GlyphAtlasClass* DynamicFontClass::GetAtlas()
+{
+	return m_Atlas;
+}
+
+bool DynamicFontClass::InitializeBuffers(ID3D11Device *device)
+{
+	D3D11_BUFFER_DESC		vertexBufferDesc, indexBufferDesc;
+	D3D11_SUBRESOURCE_DATA	indexData;
+	unsigned long		   *indices;
+	HRESULT					result;
+
+	indices = new unsigned long[m_maxVertexCount];
+	if (!indices)
+		return false;
+
+	for (int i = 0; i < m_maxVertexCount; i++)
+		indices[i] = i;
+
+	vertexBufferDesc.Usage				 = D3D11_USAGE_DYNAMIC;
+	vertexBufferDesc.ByteWidth			 = sizeof(VertexType) * m_maxVertexCount;
+	vertexBufferDesc.BindFlags			 = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags		 = D3D11_CPU_ACCESS_WRITE;
+	vertexBufferDesc.MiscFlags			 = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+
+	result = device->CreateBuffer(&vertexBufferDesc, NULL, &m_vertexBuffer);
+	if (FAILED(result)) {
+		delete [] indices;
+		return false;
+	}
+
+	indexBufferDesc.Usage				= D3D11_USAGE_IMMUTABLE;
+	indexBufferDesc.ByteWidth			= sizeof(unsigned long) * m_maxVertexCount;
+	indexBufferDesc.BindFlags			= D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.CPUAccessFlags		= 0;
+	indexBufferDesc.MiscFlags			= 0;
+	indexBufferDesc.StructureByteStride = 0;
+
+	indexData.pSysMem		   = indices;
+	indexData.SysMemPitch	   = 0;
+	indexData.SysMemSlicePitch = 0;
+
+	result = device->CreateBuffer(&indexBufferDesc, &indexData, &m_indexBuffer);
+
+	delete [] indices;
+	indices = 0;
+
+	if (FAILED(result))
+		return false;
+
+	return true;
+}
+
+// The pages are single channel textures, the font pixel shader reads the coverage from the red channel.
+bool DynamicFontClass::CreatePageTexture(int page)
+{
+	D3D11_TEXTURE2D_DESC	textureDesc;
+	D3D11_SUBRESOURCE_DATA	textureData;
+	ID3D11Texture2D		   *texture;
+	ID3D11ShaderResourceView *view;
+	HRESULT					result;
+
+	ZeroMemory(&textureDesc, sizeof(textureDesc));
+
+	textureDesc.Width			 = m_Atlas->GetPageSize();
+	textureDesc.Height			 = m_Atlas->GetPageSize();
+	textureDesc.MipLevels		 = 1;
+	textureDesc.ArraySize		 = 1;
+	textureDesc.Format			 = DXGI_FORMAT_R8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage			 = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags		 = D3D11_BIND_SHADER_RESOURCE;
+
+	textureData.pSysMem			 = m_Atlas->GetPagePixels(page);
+	textureData.SysMemPitch		 = m_Atlas->GetPageSize();
+	textureData.SysMemSlicePitch = 0;
+
+	result = m_device->CreateTexture2D(&textureDesc, &textureData, &texture);
+	if (FAILED(result))
+		return false;
+
+	result = m_device->CreateShaderResourceView(texture, NULL, &view);
+	if (FAILED(result)) {
+		texture->Release();
+		return false;
+	}
+
+	m_pageTextures.push_back(texture);
+	m_pageViews.push_back(view);
+
+	return true;
+}
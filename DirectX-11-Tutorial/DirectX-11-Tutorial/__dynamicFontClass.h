@@ -0,0 +1,73 @@
+// --------------------------------------------------------------------------------------------------------
+// DynamicFontClass draws UTF-8 text with glyphs rasterized on demand from a TrueType font.
+// It is the Direct3D side of the GlyphAtlasClass: it keeps one R8 texture per atlas page, uploads the parts of the pages
+// that changed, and turns text into the same vertices as FontClass, so it is drawn with the FontShaderClass.
+//
+// A glyph that is not in the atlas yet is skipped (the pen still moves) and appears once the worker has rasterized it.
+// The quads are grouped by atlas page, each page used by the text is one draw call.
+// In SDF mode the atlas keeps one distance field per glyph and every size of text is scaled from it.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _DYNAMICFONTCLASS_H_
+#define _DYNAMICFONTCLASS_H_
+
+#include <d3d11.h>
+#include <d3dx10math.h>
+
+#include "__glyphAtlasClass.h"
+#include "__gdiGlyphRasterizerClass.h"
+#include "__fontShaderClass.h"
+
+
+
+class DynamicFontClass {
+ private:
+	// The vertices of the text are the ones of the font shader.
+	typedef FontShaderClass::VertexType VertexType;
+
+ public:
+	DynamicFontClass();
+	DynamicFontClass(const DynamicFontClass &);
+   ~DynamicFontClass();
+
+	// Initialize takes the font file and face name, the screen size, the base view matrix (as the TextOutClass does),
+	// the maximal number of letters drawn by one Render call and whether the glyphs are distance fields.
+	bool Initialize(ID3D11Device *, HWND, WCHAR *, WCHAR *, int, int, D3DXMATRIX, int, bool);
+	void Shutdown();
+
+	// Frame packs the glyphs the worker has finished and uploads the changed parts of the atlas pages. Call it once per frame, before Render.
+	bool Frame(ID3D11DeviceContext *);
+
+	// Render draws the text with its top left corner at the given screen position, with the given pixel size and color.
+	// A '\n' starts a new line.
+	bool Render(ID3D11DeviceContext *, FontShaderClass *, const char *, int, int, int, const D3DXVECTOR4 &, D3DXMATRIX, D3DXMATRIX);
+
+	// The version counter of the atlas: it goes up when glyphs are added or evicted, a cached layer showing the text has to be redrawn then.
+	const unsigned int* GetVersionCounter();
+
+	GlyphAtlasClass* GetAtlas();
+
+ private:
+	bool InitializeBuffers(ID3D11Device *);
+	bool CreatePageTexture(int);
+
+ private:
+	ID3D11Device				*m_device;
+	GdiGlyphRasterizerClass		*m_Rasterizer;
+	GlyphAtlasClass				*m_Atlas;
+
+	vector<ID3D11Texture2D*>			m_pageTextures;
+	vector<ID3D11ShaderResourceView*>	m_pageViews;
+
+	int							 m_screenWidth, m_screenHeight;
+	D3DXMATRIX					 m_baseViewMatrix;
+	int							 m_maxVertexCount;
+	ID3D11Buffer				*m_vertexBuffer, *m_indexBuffer;
+
+	// The quads of the text are built here first, then copied into the vertex buffer page by page.
+	VertexType					*m_vertices;
+	int							*m_quadPages;
+	vector<int>					 m_pageQuadCount;
+};
+
+#endif
@@ -0,0 +1,670 @@
+#include "__filteredContextClass.h"
+
+FilteredContextClass::FilteredContextClass()
+{
+	m_context	 = 0;
+	m_references = 1;
+}
+
+FilteredContextClass::FilteredContextClass(const FilteredContextClass& other)
+{
+}
+
+FilteredContextClass::~FilteredContextClass()
+{
+}
+
+bool FilteredContextClass::Initialize(ID3D11DeviceContext *context)
+{
+	if (!context)
+		return false;
+
+	m_context = context;
+	m_filter.SetContext(context);
+
+	return true;
+}
+
+void FilteredContextClass::Shutdown()
+{
+	m_context = 0;
+	m_filter.SetContext(0);
+
+	return;
+}
+
+ID3D11DeviceContext* FilteredContextClass::GetContext()
+{
+	return m_context;
+}
+
+int FilteredContextClass::GetForwardedCount()
+{
+	return m_filter.GetForwardedCount();
+}
+
+int FilteredContextClass::GetFilteredCount()
+{
+	return m_filter.GetFilteredCount();
+}
+
+void FilteredContextClass::ResetCounters()
+{
+	m_filter.ResetCounters();
+
+	return;
+}
+
+// --------------------------------------------------------------------------------------------------------
+// IUnknown and ID3D11DeviceChild
+// --------------------------------------------------------------------------------------------------------
+
+HRESULT FilteredContextClass::QueryInterface(REFIID riid, void **object)
+{
+	if (!object)
+		return E_POINTER;
+
+	if (riid == __uuidof(IUnknown) || riid == __uuidof(ID3D11DeviceChild) || riid == __uuidof(ID3D11DeviceContext)) {
+		*object = this;
+		AddRef();
+		return S_OK;
+	}
+
+	return m_context->QueryInterface(riid, object);
+}
+
+ULONG FilteredContextClass::AddRef()
+{
+	return ++m_references;
+}
+
+ULONG FilteredContextClass::Release()
+{
+	return --m_references;
+}
+
+void FilteredContextClass::GetDevice(ID3D11Device **device)
+{
+	m_context->GetDevice(device);
+}
+
+HRESULT FilteredContextClass::GetPrivateData(REFGUID guid, UINT *size, void *data)
+{
+	return m_context->GetPrivateData(guid, size, data);
+}
+
+HRESULT FilteredContextClass::SetPrivateData(REFGUID guid, UINT size, const void *data)
+{
+	return m_context->SetPrivateData(guid, size, data);
+}
+
+HRESULT FilteredContextClass::SetPrivateDataInterface(REFGUID guid, const IUnknown *data)
+{
+	return m_context->SetPrivateDataInterface(guid, data);
+}
+
+// --------------------------------------------------------------------------------------------------------
+// The state that is filtered
+// --------------------------------------------------------------------------------------------------------
+
+void FilteredContextClass::IASetInputLayout(ID3D11InputLayout *layout)
+{
+	m_filter.IASetInputLayout(layout);
+}
+
+void FilteredContextClass::IASetVertexBuffers(UINT start, UINT count, ID3D11Buffer *const *buffers, const UINT *strides, const UINT *offsets)
+{
+	m_filter.IASetVertexBuffers(start, count, buffers, strides, offsets);
+}
+
+void FilteredContextClass::IASetIndexBuffer(ID3D11Buffer *buffer, DXGI_FORMAT format, UINT offset)
+{
+	m_filter.IASetIndexBuffer(buffer, format, offset);
+}
+
+void FilteredContextClass::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+	m_filter.IASetPrimitiveTopology(topology);
+}
+
+void FilteredContextClass::VSSetShader(ID3D11VertexShader *shader, ID3D11ClassInstance *const *instances, UINT instanceCount)
+{
+	m_filter.VSSetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::VSSetConstantBuffers(UINT start, UINT count, ID3D11Buffer *const *buffers)
+{
+	m_filter.VSSetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::VSSetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView *const *views)
+{
+	m_filter.VSSetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::VSSetSamplers(UINT start, UINT count, ID3D11SamplerState *const *samplers)
+{
+	m_filter.VSSetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::PSSetShader(ID3D11PixelShader *shader, ID3D11ClassInstance *const *instances, UINT instanceCount)
+{
+	m_filter.PSSetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::PSSetConstantBuffers(UINT start, UINT count, ID3D11Buffer *const *buffers)
+{
+	m_filter.PSSetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::PSSetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView *const *views)
+{
+	m_filter.PSSetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::PSSetSamplers(UINT start, UINT count, ID3D11SamplerState *const *samplers)
+{
+	m_filter.PSSetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::OMSetBlendState(ID3D11BlendState *state, const FLOAT factor[4], UINT mask)
+{
+	m_filter.OMSetBlendState(state, factor, mask);
+}
+
+void FilteredContextClass::OMSetDepthStencilState(ID3D11DepthStencilState *state, UINT stencilRef)
+{
+	m_filter.OMSetDepthStencilState(state, stencilRef);
+}
+
+void FilteredContextClass::RSSetState(ID3D11RasterizerState *state)
+{
+	m_filter.RSSetState(state);
+}
+
+// --------------------------------------------------------------------------------------------------------
+// The calls that change the state behind the filter
+// --------------------------------------------------------------------------------------------------------
+
+// A texture bound as a render target is unbound from the shader inputs by the runtime.
+void FilteredContextClass::OMSetRenderTargets(UINT count, ID3D11RenderTargetView *const *views, ID3D11DepthStencilView *depthView)
+{
+	m_context->OMSetRenderTargets(count, views, depthView);
+	m_filter.InvalidateResources();
+}
+
+void FilteredContextClass::OMSetRenderTargetsAndUnorderedAccessViews(UINT count, ID3D11RenderTargetView *const *views, ID3D11DepthStencilView *depthView,
+																	 UINT uavStart, UINT uavCount, ID3D11UnorderedAccessView *const *uavs, const UINT *initialCounts)
+{
+	m_context->OMSetRenderTargetsAndUnorderedAccessViews(count, views, depthView, uavStart, uavCount, uavs, initialCounts);
+	m_filter.InvalidateResources();
+}
+
+void FilteredContextClass::CSSetUnorderedAccessViews(UINT start, UINT count, ID3D11UnorderedAccessView *const *uavs, const UINT *initialCounts)
+{
+	m_context->CSSetUnorderedAccessViews(start, count, uavs, initialCounts);
+	m_filter.InvalidateResources();
+}
+
+// A buffer bound as a stream output target is unbound from the input assembler.
+void FilteredContextClass::SOSetTargets(UINT count, ID3D11Buffer *const *buffers, const UINT *offsets)
+{
+	m_context->SOSetTargets(count, buffers, offsets);
+	m_filter.Invalidate();
+}
+
+// Without restoring, the context is left in its default state after the command list.
+void FilteredContextClass::ExecuteCommandList(ID3D11CommandList *commandList, BOOL restoreState)
+{
+	m_context->ExecuteCommandList(commandList, restoreState);
+
+	if (!restoreState)
+		m_filter.Invalidate();
+}
+
+void FilteredContextClass::ClearState()
+{
+	m_context->ClearState();
+	m_filter.Invalidate();
+}
+
+// --------------------------------------------------------------------------------------------------------
+// Everything else is forwarded as it is
+// --------------------------------------------------------------------------------------------------------
+
+void FilteredContextClass::DrawIndexed(UINT indexCount, UINT startIndex, INT baseVertex)
+{
+	m_context->DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void FilteredContextClass::Draw(UINT vertexCount, UINT startVertex)
+{
+	m_context->Draw(vertexCount, startVertex);
+}
+
+HRESULT FilteredContextClass::Map(ID3D11Resource *resource, UINT subresource, D3D11_MAP mapType, UINT flags, D3D11_MAPPED_SUBRESOURCE *mapped)
+{
+	return m_context->Map(resource, subresource, mapType, flags, mapped);
+}
+
+void FilteredContextClass::Unmap(ID3D11Resource *resource, UINT subresource)
+{
+	m_context->Unmap(resource, subresource);
+}
+
+void FilteredContextClass::DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+{
+	m_context->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+void FilteredContextClass::DrawInstanced(UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance)
+{
+	m_context->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+}
+
+void FilteredContextClass::GSSetConstantBuffers(UINT start, UINT count, ID3D11Buffer *const *buffers)
+{
+	m_context->GSSetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::GSSetShader(ID3D11GeometryShader *shader, ID3D11ClassInstance *const *instances, UINT instanceCount)
+{
+	m_context->GSSetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::Begin(ID3D11Asynchronous *async)
+{
+	m_context->Begin(async);
+}
+
+void FilteredContextClass::End(ID3D11Asynchronous *async)
+{
+	m_context->End(async);
+}
+
+HRESULT FilteredContextClass::GetData(ID3D11Asynchronous *async, void *data, UINT size, UINT flags)
+{
+	return m_context->GetData(async, data, size, flags);
+}
+
+void FilteredContextClass::SetPredication(ID3D11Predicate *predicate, BOOL value)
+{
+	m_context->SetPredication(predicate, value);
+}
+
+void FilteredContextClass::GSSetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView *const *views)
+{
+	m_context->GSSetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::GSSetSamplers(UINT start, UINT count, ID3D11SamplerState *const *samplers)
+{
+	m_context->GSSetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::DrawAuto()
+{
+	m_context->DrawAuto();
+}
+
+void FilteredContextClass::DrawIndexedInstancedIndirect(ID3D11Buffer *buffer, UINT offset)
+{
+	m_context->DrawIndexedInstancedIndirect(buffer, offset);
+}
+
+void FilteredContextClass::DrawInstancedIndirect(ID3D11Buffer *buffer, UINT offset)
+{
+	m_context->DrawInstancedIndirect(buffer, offset);
+}
+
+void FilteredContextClass::Dispatch(UINT x, UINT y, UINT z)
+{
+	m_context->Dispatch(x, y, z);
+}
+
+void FilteredContextClass::DispatchIndirect(ID3D11Buffer *buffer, UINT offset)
+{
+	m_context->DispatchIndirect(buffer, offset);
+}
+
+void FilteredContextClass::RSSetViewports(UINT count, const D3D11_VIEWPORT *viewports)
+{
+	m_context->RSSetViewports(count, viewports);
+}
+
+void FilteredContextClass::RSSetScissorRects(UINT count, const D3D11_RECT *rects)
+{
+	m_context->RSSetScissorRects(count, rects);
+}
+
+void FilteredContextClass::CopySubresourceRegion(ID3D11Resource *destination, UINT destinationSubresource, UINT x, UINT y, UINT z,
+												 ID3D11Resource *source, UINT sourceSubresource, const D3D11_BOX *box)
+{
+	m_context->CopySubresourceRegion(destination, destinationSubresource, x, y, z, source, sourceSubresource, box);
+}
+
+void FilteredContextClass::CopyResource(ID3D11Resource *destination, ID3D11Resource *source)
+{
+	m_context->CopyResource(destination, source);
+}
+
+void FilteredContextClass::UpdateSubresource(ID3D11Resource *resource, UINT subresource, const D3D11_BOX *box, const void *data, UINT rowPitch, UINT depthPitch)
+{
+	m_context->UpdateSubresource(resource, subresource, box, data, rowPitch, depthPitch);
+}
+
+void FilteredContextClass::CopyStructureCount(ID3D11Buffer *buffer, UINT offset, ID3D11UnorderedAccessView *uav)
+{
+	m_context->CopyStructureCount(buffer, offset, uav);
+}
+
+void FilteredContextClass::ClearRenderTargetView(ID3D11RenderTargetView *view, const FLOAT color[4])
+{
+	m_context->ClearRenderTargetView(view, color);
+}
+
+void FilteredContextClass::ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView *uav, const UINT values[4])
+{
+	m_context->ClearUnorderedAccessViewUint(uav, values);
+}
+
+void FilteredContextClass::ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView *uav, const FLOAT values[4])
+{
+	m_context->ClearUnorderedAccessViewFloat(uav, values);
+}
+
+void FilteredContextClass::ClearDepthStencilView(ID3D11DepthStencilView *view, UINT flags, FLOAT depth, UINT8 stencil)
+{
+	m_context->ClearDepthStencilView(view, flags, depth, stencil);
+}
+
+void FilteredContextClass::GenerateMips(ID3D11ShaderResourceView *view)
+{
+	m_context->GenerateMips(view);
+}
+
+void FilteredContextClass::SetResourceMinLOD(ID3D11Resource *resource, FLOAT minLOD)
+{
+	m_context->SetResourceMinLOD(resource, minLOD);
+}
+
+FLOAT FilteredContextClass::GetResourceMinLOD(ID3D11Resource *resource)
+{
+	return m_context->GetResourceMinLOD(resource);
+}
+
+void FilteredContextClass::ResolveSubresource(ID3D11Resource *destination, UINT destinationSubresource, ID3D11Resource *source, UINT sourceSubresource, DXGI_FORMAT format)
+{
+	m_context->ResolveSubresource(destination, destinationSubresource, source, sourceSubresource, format);
+}
+
+void FilteredContextClass::HSSetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView *const *views)
+{
+	m_context->HSSetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::HSSetShader(ID3D11HullShader *shader, ID3D11ClassInstance *const *instances, UINT instanceCount)
+{
+	m_context->HSSetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::HSSetSamplers(UINT start, UINT count, ID3D11SamplerState *const *samplers)
+{
+	m_context->HSSetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::HSSetConstantBuffers(UINT start, UINT count, ID3D11Buffer *const *buffers)
+{
+	m_context->HSSetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::DSSetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView *const *views)
+{
+	m_context->DSSetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::DSSetShader(ID3D11DomainShader *shader, ID3D11ClassInstance *const *instances, UINT instanceCount)
+{
+	m_context->DSSetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::DSSetSamplers(UINT start, UINT count, ID3D11SamplerState *const *samplers)
+{
+	m_context->DSSetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::DSSetConstantBuffers(UINT start, UINT count, ID3D11Buffer *const *buffers)
+{
+	m_context->DSSetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::CSSetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView *const *views)
+{
+	m_context->CSSetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::CSSetShader(ID3D11ComputeShader *shader, ID3D11ClassInstance *const *instances, UINT instanceCount)
+{
+	m_context->CSSetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::CSSetSamplers(UINT start, UINT count, ID3D11SamplerState *const *samplers)
+{
+	m_context->CSSetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::CSSetConstantBuffers(UINT start, UINT count, ID3D11Buffer *const *buffers)
+{
+	m_context->CSSetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::VSGetConstantBuffers(UINT start, UINT count, ID3D11Buffer **buffers)
+{
+	m_context->VSGetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::PSGetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView **views)
+{
+	m_context->PSGetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::PSGetShader(ID3D11PixelShader **shader, ID3D11ClassInstance **instances, UINT *instanceCount)
+{
+	m_context->PSGetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::PSGetSamplers(UINT start, UINT count, ID3D11SamplerState **samplers)
+{
+	m_context->PSGetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::VSGetShader(ID3D11VertexShader **shader, ID3D11ClassInstance **instances, UINT *instanceCount)
+{
+	m_context->VSGetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::PSGetConstantBuffers(UINT start, UINT count, ID3D11Buffer **buffers)
+{
+	m_context->PSGetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::IAGetInputLayout(ID3D11InputLayout **layout)
+{
+	m_context->IAGetInputLayout(layout);
+}
+
+void FilteredContextClass::IAGetVertexBuffers(UINT start, UINT count, ID3D11Buffer **buffers, UINT *strides, UINT *offsets)
+{
+	m_context->IAGetVertexBuffers(start, count, buffers, strides, offsets);
+}
+
+void FilteredContextClass::IAGetIndexBuffer(ID3D11Buffer **buffer, DXGI_FORMAT *format, UINT *offset)
+{
+	m_context->IAGetIndexBuffer(buffer, format, offset);
+}
+
+void FilteredContextClass::GSGetConstantBuffers(UINT start, UINT count, ID3D11Buffer **buffers)
+{
+	m_context->GSGetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::GSGetShader(ID3D11GeometryShader **shader, ID3D11ClassInstance **instances, UINT *instanceCount)
+{
+	m_context->GSGetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::IAGetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY *topology)
+{
+	m_context->IAGetPrimitiveTopology(topology);
+}
+
+void FilteredContextClass::VSGetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView **views)
+{
+	m_context->VSGetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::VSGetSamplers(UINT start, UINT count, ID3D11SamplerState **samplers)
+{
+	m_context->VSGetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::GetPredication(ID3D11Predicate **predicate, BOOL *value)
+{
+	m_context->GetPredication(predicate, value);
+}
+
+void FilteredContextClass::GSGetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView **views)
+{
+	m_context->GSGetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::GSGetSamplers(UINT start, UINT count, ID3D11SamplerState **samplers)
+{
+	m_context->GSGetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::OMGetRenderTargets(UINT count, ID3D11RenderTargetView **views, ID3D11DepthStencilView **depthView)
+{
+	m_context->OMGetRenderTargets(count, views, depthView);
+}
+
+void FilteredContextClass::OMGetRenderTargetsAndUnorderedAccessViews(UINT count, ID3D11RenderTargetView **views, ID3D11DepthStencilView **depthView,
+																	 UINT uavStart, UINT uavCount, ID3D11UnorderedAccessView **uavs)
+{
+	m_context->OMGetRenderTargetsAndUnorderedAccessViews(count, views, depthView, uavStart, uavCount, uavs);
+}
+
+void FilteredContextClass::OMGetBlendState(ID3D11BlendState **state, FLOAT factor[4], UINT *mask)
+{
+	m_context->OMGetBlendState(state, factor, mask);
+}
+
+void FilteredContextClass::OMGetDepthStencilState(ID3D11DepthStencilState **state, UINT *stencilRef)
+{
+	m_context->OMGetDepthStencilState(state, stencilRef);
+}
+
+void FilteredContextClass::SOGetTargets(UINT count, ID3D11Buffer **buffers)
+{
+	m_context->SOGetTargets(count, buffers);
+}
+
+void FilteredContextClass::RSGetState(ID3D11RasterizerState **state)
+{
+	m_context->RSGetState(state);
+}
+
+void FilteredContextClass::RSGetViewports(UINT *count, D3D11_VIEWPORT *viewports)
+{
+	m_context->RSGetViewports(count, viewports);
+}
+
+void FilteredContextClass::RSGetScissorRects(UINT *count, D3D11_RECT *rects)
+{
+	m_context->RSGetScissorRects(count, rects);
+}
+
+void FilteredContextClass::HSGetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView **views)
+{
+	m_context->HSGetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::HSGetShader(ID3D11HullShader **shader, ID3D11ClassInstance **instances, UINT *instanceCount)
+{
+	m_context->HSGetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::HSGetSamplers(UINT start, UINT count, ID3D11SamplerState **samplers)
+{
+	m_context->HSGetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::HSGetConstantBuffers(UINT start, UINT count, ID3D11Buffer **buffers)
+{
+	m_context->HSGetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::DSGetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView **views)
+{
+	m_context->DSGetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::DSGetShader(ID3D11DomainShader **shader, ID3D11ClassInstance **instances, UINT *instanceCount)
+{
+	m_context->DSGetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::DSGetSamplers(UINT start, UINT count, ID3D11SamplerState **samplers)
+{
+	m_context->DSGetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::DSGetConstantBuffers(UINT start, UINT count, ID3D11Buffer **buffers)
+{
+	m_context->DSGetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::CSGetShaderResources(UINT start, UINT count, ID3D11ShaderResourceView **views)
+{
+	m_context->CSGetShaderResources(start, count, views);
+}
+
+void FilteredContextClass::CSGetUnorderedAccessViews(UINT start, UINT count, ID3D11UnorderedAccessView **uavs)
+{
+	m_context->CSGetUnorderedAccessViews(start, count, uavs);
+}
+
+void FilteredContextClass::CSGetShader(ID3D11ComputeShader **shader, ID3D11ClassInstance **instances, UINT *instanceCount)
+{
+	m_context->CSGetShader(shader, instances, instanceCount);
+}
+
+void FilteredContextClass::CSGetSamplers(UINT start, UINT count, ID3D11SamplerState **samplers)
+{
+	m_context->CSGetSamplers(start, count, samplers);
+}
+
+void FilteredContextClass::CSGetConstantBuffers(UINT start, UINT count, ID3D11Buffer **buffers)
+{
+	m_context->CSGetConstantBuffers(start, count, buffers);
+}
+
+void FilteredContextClass::Flush()
+{
+	m_context->Flush();
+}
+
+UINT FilteredContextClass::GetContextFlags()
+{
+	return m_context->GetContextFlags();
+}
+
+HRESULT FilteredContextClass::FinishCommandList(BOOL restoreState, ID3D11CommandList **commandList)
+{
+	return m_context->FinishCommandList(restoreState, commandList);
+}
+
+D3D11_DEVICE_CONTEXT_TYPE FilteredContextClass::GetType()
+{
+	return m_context->GetType();
+}
@@ -138,6 +138,11 @@ ID3D11ShaderResourceView* FontClass::GetTexture()
 // The sentence input is the text sentence that will be used to create the vertex array.
 // The drawX and drawY input variables are the screen coordinates of where to draw the sentence.
 void FontClass::BuildVertexArray(void* vertices, char* sentence, float drawX, float drawY)
+{
+	BuildVertexArray(vertices, sentence, drawX, drawY, 0, D3DXVECTOR4(1.0f, 1.0f, 1.0f, 1.0f));
+}
+
+int FontClass::BuildVertexArray(void* vertices, char* sentence, float drawX, float drawY, int firstLetter, const D3DXVECTOR4 &color)
 {
 	VertexType	*vertexPtr;
 	int numLetters, index = 0, letter;
@@ -155,10 +160,32 @@ void FontClass::BuildVertexArray(void* vertices, char* sentence, float drawX, fl
 	// It then maps the character from the font texture onto those two triangles using the m_Font array which has the TU texture coordinates and pixel size.
 	// Once the polygon for that character has been created it then updates the X coordinate on the screen of where to draw the next character.
 
+	// Skip the letters that are already in the array, only moving the X coordinate and the index past them.
+	// Spaces don't get a quad, so the index is not simply 6 times the letter number.
+	for(int i = 0; i < firstLetter && i < numLetters; i++) {
+
+		letter = GlyphTableClass::GetAsciiGlyph(sentence[i]);
+
+		if(letter < 0)
+			continue;
+
+		if(letter == 0) {
+			drawX = drawX + 3.0f;
+		}
+		else {
+			drawX = drawX + m_Font[letter].size + 1.0f;
+			index += 6;
+		}
+	}
+
 	// Draw each letter onto a quad.
-	for(int i = 0; i < numLetters; i++) {
+	for(int i = firstLetter; i < numLetters; i++) {
 
-		letter = ((int)sentence[i]) - 32;
+		letter = GlyphTableClass::GetAsciiGlyph(sentence[i]);
+
+		// The characters the font doesn't have are left out.
+		if(letter < 0)
+			continue;
 
 		// If the letter is a space then just move over three pixels.
 		if(letter == 0) {
@@ -169,31 +196,89 @@ void FontClass::BuildVertexArray(void* vertices, char* sentence, float drawX, fl
 			// First triangle in quad.
 			vertexPtr[index].position = D3DXVECTOR3(drawX, drawY, 0.0f);  // Top left.
 			vertexPtr[index].texture  = D3DXVECTOR2(m_Font[letter].left, 0.0f);
+			vertexPtr[index].color	 = color;
 			index++;
 
 			vertexPtr[index].position = D3DXVECTOR3((drawX + m_Font[letter].size), (drawY - 16), 0.0f);  // Bottom right.
 			vertexPtr[index].texture  = D3DXVECTOR2(m_Font[letter].right, 1.0f);
+			vertexPtr[index].color	 = color;
 			index++;
 
 			vertexPtr[index].position = D3DXVECTOR3(drawX, (drawY - 16), 0.0f);  // Bottom left.
 			vertexPtr[index].texture  = D3DXVECTOR2(m_Font[letter].left, 1.0f);
+			vertexPtr[index].color	 = color;
 			index++;
 
 			// Second triangle in quad.
 			vertexPtr[index].position = D3DXVECTOR3(drawX, drawY, 0.0f);  // Top left.
 			vertexPtr[index].texture  = D3DXVECTOR2(m_Font[letter].left, 0.0f);
+			vertexPtr[index].color	 = color;
 			index++;
 
 			vertexPtr[index].position = D3DXVECTOR3(drawX + m_Font[letter].size, drawY, 0.0f);  // Top right.
 			vertexPtr[index].texture  = D3DXVECTOR2(m_Font[letter].right, 0.0f);
+			vertexPtr[index].color	 = color;
 			index++;
 
 			vertexPtr[index].position = D3DXVECTOR3((drawX + m_Font[letter].size), (drawY - 16), 0.0f);  // Bottom right.
 			vertexPtr[index].texture  = D3DXVECTOR2(m_Font[letter].right, 1.0f);
+			vertexPtr[index].color	 = color;
 			index++;
 
 			// Update the x location for drawing by the size of the letter and one pixel.
 			drawX = drawX + m_Font[letter].size + 1.0f;
 		}
 	}
+
+	return index;
+}
+
+// The font data has the 95 printable ASCII characters, 16 pixels high.
+// A letter is followed by one pixel of space, and the space character is 3 pixels wide, as in BuildVertexArray.
+void FontClass::BuildMetrics(FontMetricsClass *metrics)
+{
+	FontMetricsClass::GlyphMetricsType glyph;
+
+	metrics->Clear();
+
+	for (int letter = 0; letter < 95; letter++) {
+
+		glyph.left	  = 0.0f;
+		glyph.top	  = 0.0f;
+		glyph.width	  = (float)m_Font[letter].size;
+		glyph.height  = 16.0f;
+		glyph.visible = letter != 0;
+		glyph.advance = letter == 0 ? 3.0f : m_Font[letter].size + 1.0f;
+
+		metrics->AddGlyph(letter + 32, glyph);
+	}
+
+	metrics->SetLineMetrics(16.0f, 18.0f);
+	metrics->SetFallback('?');
+
+	return;
+}
+
+void FontClass::BuildGlyphTable(GlyphTableClass *table)
+{
+	GlyphTableClass::GlyphType glyph;
+
+	table->Clear();
+
+	// The letters are 16 pixels high and use the whole height of the texture.
+	for (int letter = 0; letter < 95; letter++) {
+
+		glyph.left	 = 0.0f;
+		glyph.top	 = 0.0f;
+		glyph.width	 = (float)m_Font[letter].size;
+		glyph.height = 16.0f;
+		glyph.u0	 = m_Font[letter].left;
+		glyph.v0	 = 0.0f;
+		glyph.u1	 = m_Font[letter].right;
+		glyph.v1	 = 1.0f;
+
+		table->SetGlyph(letter, glyph);
+	}
+
+	return;
 }
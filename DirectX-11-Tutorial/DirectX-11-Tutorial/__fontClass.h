@@ -7,6 +7,9 @@
 using namespace std;
 
 #include "__textureClass.h"
+#include "__textLayoutClass.h"
+#include "__glyphTableClass.h"
+#include "__fontShaderClass.h"
 
 
 
@@ -23,11 +26,9 @@ class FontClass {
 
 	// The VertexType structure is for the actual vertex data used to build the square to render the text character on.
 	// The individual character will require two triangles to make a square.
-	// Those triangles will have position and texture data only.
-	struct VertexType {
-		D3DXVECTOR3 position;
-		D3DXVECTOR2 texture;
-	};
+	// Those triangles have position, texture and color data, the color lets sentences of different colors share one draw call.
+	// The vertex is the one the FontShaderClass takes.
+	typedef FontShaderClass::VertexType VertexType;
 
  public:
 	FontClass();
@@ -43,6 +44,16 @@ class FontClass {
 	// This function will be called by the new TextClass to build vertex arrays of all the sentences it needs to render.
 	void BuildVertexArray(void*, char*, float, float);
 
+	// This version leaves the quads of the letters before firstLetter untouched, so a sentence that only changed at the end can be patched.
+	// The letters get the given color. It returns the number of vertices in the whole sentence.
+	int  BuildVertexArray(void*, char*, float, float, int, const D3DXVECTOR4 &);
+
+	// BuildMetrics fills the table the TextLayoutClass works with. The glyph id of a letter is its index in the font data.
+	void BuildMetrics(FontMetricsClass*);
+
+	// BuildGlyphTable fills the glyph table of the instanced text with the boxes and texture rectangles of the letters, with the same ids.
+	void BuildGlyphTable(GlyphTableClass*);
+
 private:
 	bool LoadFontData(char*);
 	void ReleaseFontData();
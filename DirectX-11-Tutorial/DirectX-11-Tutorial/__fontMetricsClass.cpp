@@ -0,0 +1,121 @@
+#include "__fontMetricsClass.h"
+
+FontMetricsClass::FontMetricsClass()
+{
+	m_version = 0;
+
+	Clear();
+}
+
+FontMetricsClass::FontMetricsClass(const FontMetricsClass& other)
+{
+}
+
+FontMetricsClass::~FontMetricsClass()
+{
+}
+
+void FontMetricsClass::Clear()
+{
+	m_glyphs.clear();
+	m_others.clear();
+	m_kerning.clear();
+
+	for (int i = 0; i < 128; i++)
+		m_ascii[i] = -1;
+
+	m_fallback	 = -1;
+	m_ascent	 = 0.0f;
+	m_lineHeight = 0.0f;
+	m_version++;
+
+	return;
+}
+
+int FontMetricsClass::AddGlyph(unsigned int codepoint, const GlyphMetricsType &metrics)
+{
+	int id = (int)m_glyphs.size();
+
+	m_glyphs.push_back(metrics);
+
+	if (codepoint < 128)
+		m_ascii[codepoint] = id;
+	else
+		m_others[codepoint] = id;
+
+	m_version++;
+
+	return id;
+}
+
+void FontMetricsClass::AddKerningPair(unsigned int first, unsigned int second, float amount)
+{
+	m_kerning[((unsigned long long)first << 32) | second] = amount;
+	m_version++;
+
+	return;
+}
+
+void FontMetricsClass::SetLineMetrics(float ascent, float lineHeight)
+{
+	m_ascent	 = ascent;
+	m_lineHeight = lineHeight;
+	m_version++;
+
+	return;
+}
+
+void FontMetricsClass::SetFallback(unsigned int codepoint)
+{
+	m_fallback = -1;
+	m_fallback = FindGlyph(codepoint);
+	m_version++;
+
+	return;
+}
+
+int FontMetricsClass::FindGlyph(unsigned int codepoint) const
+{
+	if (codepoint < 128)
+		return m_ascii[codepoint] >= 0 ? m_ascii[codepoint] : m_fallback;
+
+	unordered_map<unsigned int, int>::const_iterator it = m_others.find(codepoint);
+
+	return it != m_others.end() ? it->second : m_fallback;
+}
+
+const FontMetricsClass::GlyphMetricsType& FontMetricsClass::GetGlyph(int id) const
+{
+	return m_glyphs[id];
+}
+
+int FontMetricsClass::GetGlyphCount() const
+{
+	return (int)m_glyphs.size();
+}
+
+float FontMetricsClass::GetKerning(unsigned int first, unsigned int second) const
+{
+	// Most fonts (and the tutorial font) have no pairs at all, don't even hash then.
+	if (m_kerning.empty())
+		return 0.0f;
+
+	unordered_map<unsigned long long, float>::const_iterator it = m_kerning.find(((unsigned long long)first << 32) | second);
+
+	return it != m_kerning.end() ? it->second : 0.0f;
+}
+
+float FontMetricsClass::GetAscent() const
+{
+	return m_ascent;
+}
+
+float FontMetricsClass::GetLineHeight() const
+{
+	return m_lineHeight;
+}
+
+unsigned int FontMetricsClass::GetVersion() const
+{
+	return m_version;
+}
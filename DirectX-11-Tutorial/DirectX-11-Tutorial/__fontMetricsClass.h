@@ -0,0 +1,67 @@
+// --------------------------------------------------------------------------------------------------------
+// FontMetricsClass is the table the TextLayoutClass lays text out with: for every glyph of a font its advance and its box,
+// plus the kerning pairs and the line metrics. It knows nothing about textures, a glyph is only an id
+// (the index it was added with), which the font that filled the table maps back to its own data.
+//
+// The glyphs of the ASCII range are found through a plain array, the others through a hash map.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _FONTMETRICSCLASS_H_
+#define _FONTMETRICSCLASS_H_
+
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+
+
+class FontMetricsClass {
+ public:
+	// The box is relative to the pen at the top of the line, y going down.
+	struct GlyphMetricsType {
+		float advance;
+		float left, top, width, height;
+		bool  visible;					// false for the glyphs without ink, like the space
+	};
+
+ public:
+	FontMetricsClass();
+	FontMetricsClass(const FontMetricsClass &);
+   ~FontMetricsClass();
+
+	void Clear();
+
+	// AddGlyph adds the metrics of a codepoint and returns its glyph id.
+	int  AddGlyph(unsigned int, const GlyphMetricsType &);
+	void AddKerningPair(unsigned int, unsigned int, float);
+	void SetLineMetrics(float, float);
+
+	// The fallback glyph is used for the codepoints the font doesn't have.
+	void SetFallback(unsigned int);
+
+	// FindGlyph returns the glyph id of the codepoint, the fallback glyph if there is none, or -1 without a fallback.
+	int FindGlyph(unsigned int) const;
+	const GlyphMetricsType& GetGlyph(int) const;
+	int GetGlyphCount() const;
+
+	// GetKerning returns the adjustment of the advance between the two codepoints, 0 for most pairs.
+	float GetKerning(unsigned int, unsigned int) const;
+
+	float GetAscent() const;
+	float GetLineHeight() const;
+
+	// The version goes up with every change, cached layouts made with an older table are not used.
+	unsigned int GetVersion() const;
+
+ private:
+	vector<GlyphMetricsType>				m_glyphs;
+	int										m_ascii[128];
+	unordered_map<unsigned int, int>		m_others;
+	unordered_map<unsigned long long, float> m_kerning;
+	int										m_fallback;
+	float									m_ascent, m_lineHeight;
+	unsigned int							m_version;
+};
+
+#endif
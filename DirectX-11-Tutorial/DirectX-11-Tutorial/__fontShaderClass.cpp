@@ -1,19 +1,9 @@
 #include "__fontShaderClass.h"
-
-//   D3DCompileFromFile
-#pragma comment(lib, "d3dcompiler.lib")
-#include "D3Dcompiler.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
 
 FontShaderClass::FontShaderClass()
 {
-	m_vertexShader	 = 0;
-	m_pixelShader	 = 0;
-	m_layout		 = 0;
-	m_constantBuffer = 0;
-	m_sampleState	 = 0;
-
-	// We initialize the pixel color constant buffer to null in the class constructor.
-	m_pixelBuffer	 = 0;
 }
 
 FontShaderClass::FontShaderClass(const FontShaderClass& other)
@@ -24,154 +14,10 @@ FontShaderClass::~FontShaderClass()
 {
 }
 
+// Initialize loads the font vertex shader and the two pixel shaders, the second one is for the distance field atlases.
 bool FontShaderClass::Initialize(ID3D11Device* device, HWND hwnd)
 {
-	bool result;
-
-	// Initialize loads the new font vertex shader and pixel shader HLSL files.
-
-	// Initialize the vertex and pixel shaders.
-	result = InitializeShader(device, hwnd, L"../DirectX-11-Tutorial/_shaderFont.vs", L"../DirectX-11-Tutorial/_shaderFont.ps");
-	if(!result)
-		return false;
-
-	return true;
-}
-
-// Shutdown calls ShutdownShader which releases the font shader related pointers and data.
-void FontShaderClass::Shutdown()
-{
-	// Shutdown the vertex and pixel shaders as well as the related objects.
-	ShutdownShader();
-}
-
-// Render will set the shader parameters and then draw the buffers using the font shader.
-// Notice the is the same as TextureShaderClass except that it takes in the new pixelColor parameter.
-bool FontShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCount,
-								D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, D3DXVECTOR4 pixelColor)
-{
-	bool result;
-
-	// Set the shader parameters that it will use for rendering.
-	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, pixelColor);
-	if(!result)
-		return false;
-
-	// Now render the prepared buffers with the shader.
-	RenderShader(deviceContext, indexCount);
-
-	return true;
-}
-
-// The InitializeShader function loads the new HLSL font vertex and pixel shaders as well as the pointers that interface with the shader.
-bool FontShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
-{
-	HRESULT				 result;
-	ID3D10Blob			*errorMessage;
-	ID3D10Blob			*vertexShaderBuffer;
-	ID3D10Blob			*pixelShaderBuffer;
-	unsigned int		 numElements;
-	D3D11_BUFFER_DESC	 constantBufferDesc;
-	D3D11_SAMPLER_DESC	 samplerDesc;
-	D3D11_BUFFER_DESC	 pixelBufferDesc;
-	D3D11_INPUT_ELEMENT_DESC polygonLayout[2];
-
-
-	// Initialize the pointers this function will use to null.
-	errorMessage		= 0;
-	vertexShaderBuffer	= 0;
-	pixelShaderBuffer	= 0;
-
-	// The name of the vertex shader has been changed to FontVertexShader.
-	// Compile the vertex shader code.
-	//result = D3DX11CompileFromFile(vsFilename, NULL, NULL, "FontVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &vertexShaderBuffer, &errorMessage, NULL);
-	result = D3DCompileFromFile(vsFilename, NULL, NULL, "FontVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &vertexShaderBuffer, &errorMessage);
-
-	if(FAILED(result)) {
-
-		// If the shader failed to compile it should have writen something to the error message.
-		if(errorMessage)
-			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
-		else
-			// If there was  nothing in the error message then it simply could not find the shader file itself.
-			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
-
-		return false;
-	}
-
-	// The name of the pixel shader has been changed to FontPixelShader.
-
-	// Compile the pixel shader code.
-	//result = D3DX11CompileFromFile(psFilename, NULL, NULL, "FontPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &pixelShaderBuffer, &errorMessage, NULL);
-	result = D3DCompileFromFile(psFilename, NULL, NULL, "FontPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &pixelShaderBuffer, &errorMessage);
-
-	if(FAILED(result)) {
-
-		// If the shader failed to compile it should have writen something to the error message.
-		if(errorMessage)
-			OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
-		else
-			// If there was  nothing in the error message then it simply could not find the file itself.
-			MessageBox(hwnd, psFilename, L"Missing Shader File", MB_OK);
-
-		return false;
-	}
-
-	// Create the vertex shader from the buffer.
-	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &m_vertexShader);
-	if(FAILED(result))
-		return false;
-
-	// Create the pixel shader from the buffer.
-	result = device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), NULL, &m_pixelShader);
-	if(FAILED(result))
-		return false;
-
-	// Create the vertex input layout description.
-	// This setup needs to match the VertexType stucture in the ModelClass and in the shader.
-	polygonLayout[0].SemanticName		= "POSITION";
-	polygonLayout[0].SemanticIndex		= 0;
-	polygonLayout[0].Format				= DXGI_FORMAT_R32G32B32_FLOAT;
-	polygonLayout[0].InputSlot			= 0;
-	polygonLayout[0].AlignedByteOffset	= 0;
-	polygonLayout[0].InputSlotClass		= D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[0].InstanceDataStepRate = 0;
-
-	polygonLayout[1].SemanticName		= "TEXCOORD";
-	polygonLayout[1].SemanticIndex		= 0;
-	polygonLayout[1].Format				= DXGI_FORMAT_R32G32_FLOAT;
-	polygonLayout[1].InputSlot			= 0;
-	polygonLayout[1].AlignedByteOffset	= D3D11_APPEND_ALIGNED_ELEMENT;
-	polygonLayout[1].InputSlotClass		= D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[1].InstanceDataStepRate = 0;
-
-	// Get a count of the elements in the layout.
-	numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
-
-	// Create the vertex input layout.
-	result = device->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &m_layout);
-	if(FAILED(result))
-		return false;
-
-	// Release the vertex shader buffer and pixel shader buffer since they are no longer needed.
-	vertexShaderBuffer->Release();
-	vertexShaderBuffer = 0;
-
-	pixelShaderBuffer->Release();
-	pixelShaderBuffer = 0;
-
-	// Setup the description of the dynamic constant buffer that is in the vertex shader.
-	constantBufferDesc.Usage			= D3D11_USAGE_DYNAMIC;
-	constantBufferDesc.ByteWidth		= sizeof(ConstantBufferType);
-	constantBufferDesc.BindFlags		= D3D11_BIND_CONSTANT_BUFFER;
-	constantBufferDesc.CPUAccessFlags	= D3D11_CPU_ACCESS_WRITE;
-	constantBufferDesc.MiscFlags		= 0;
-	constantBufferDesc.StructureByteStride = 0;
-
-	// Create the constant buffer pointer so we can access the vertex shader constant buffer from within this class.
-	result = device->CreateBuffer(&constantBufferDesc, NULL, &m_constantBuffer);
-	if(FAILED(result))
-		return false;
+	D3D11_SAMPLER_DESC samplerDesc;
 
 	// Create a texture sampler state description.
 	samplerDesc.Filter		   = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
@@ -188,184 +34,55 @@ bool FontShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* v
 	samplerDesc.MinLOD		   = 0;
 	samplerDesc.MaxLOD		   = D3D11_FLOAT32_MAX;
 
-	// Create the texture sampler state.
-	result = device->CreateSamplerState(&samplerDesc, &m_sampleState);
-	if(FAILED(result))
+	if (!m_program.Initialize(device, hwnd, L"../DirectX-11-Tutorial/_shaderFont.vs", "FontVertexShader",
+											L"../DirectX-11-Tutorial/_shaderFont.ps", "FontPixelShader", &samplerDesc))
 		return false;
 
-	// Here we setup the new pixel color constant buffer that will allow this class to set the pixel color in the pixel shader.
-
-	// Setup the description of the dynamic pixel constant buffer that is in the pixel shader.
-	pixelBufferDesc.Usage			= D3D11_USAGE_DYNAMIC;
-	pixelBufferDesc.ByteWidth		= sizeof(PixelBufferType);
-	pixelBufferDesc.BindFlags		= D3D11_BIND_CONSTANT_BUFFER;
-	pixelBufferDesc.CPUAccessFlags	= D3D11_CPU_ACCESS_WRITE;
-	pixelBufferDesc.MiscFlags		= 0;
-	pixelBufferDesc.StructureByteStride = 0;
-
-	// Create the pixel constant buffer pointer so we can access the pixel shader constant buffer from within this class.
-	result = device->CreateBuffer(&pixelBufferDesc, NULL, &m_pixelBuffer);
-	if(FAILED(result))
+	// The pixel shader for the distance field atlases lives in the same file.
+	if (!m_program.AddPixelShader(device, hwnd, L"../DirectX-11-Tutorial/_shaderFont.ps", "FontSdfPixelShader"))
 		return false;
 
 	return true;
 }
 
-// The ShutdownShader function releases all the shader related data.
-void FontShaderClass::ShutdownShader()
+// Shutdown releases the font shader related pointers and data.
+void FontShaderClass::Shutdown()
 {
-
-	// The new pixel color constant buffer is released here.
-	// Release the pixel constant buffer.
-	if(m_pixelBuffer) {
-		m_pixelBuffer->Release();
-		m_pixelBuffer = 0;
-	}
-
-	// Release the sampler state.
-	if(m_sampleState) {
-		m_sampleState->Release();
-		m_sampleState = 0;
-	}
-
-	// Release the constant buffer.
-	if(m_constantBuffer) {
-		m_constantBuffer->Release();
-		m_constantBuffer = 0;
-	}
-
-	// Release the layout.
-	if(m_layout) {
-		m_layout->Release();
-		m_layout = 0;
-	}
-
-	// Release the pixel shader.
-	if(m_pixelShader) {
-		m_pixelShader->Release();
-		m_pixelShader = 0;
-	}
-
-	// Release the vertex shader.
-	if(m_vertexShader) {
-		m_vertexShader->Release();
-		m_vertexShader = 0;
-	}
+	m_program.Shutdown();
 }
 
-// OutputShaderErrorMessage writes any shader compilation errors to a text file that can be reviewed in the event of a failure in compilation.
-void FontShaderClass::OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFilename)
+// Render will set the shader parameters and then draw the buffers using the font shader.
+// The color of the text used to be a parameter here, it is now part of every vertex.
+bool FontShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCount,
+								D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
 {
-	char* compileErrors;
-	unsigned long bufferSize, i;
-	ofstream fout;
-
-	// Get a pointer to the error message text buffer.
-	compileErrors = (char*)(errorMessage->GetBufferPointer());
-
-	// Get the length of the message.
-	bufferSize = errorMessage->GetBufferSize();
-
-	// Open a file to write the error message to.
-	fout.open("____shader-error.txt");
-
-	// Write out the error message.
-	for(i=0; i<bufferSize; i++)
-		fout << compileErrors[i];
-
-	// Close the file.
-	fout.close();
-
-	// Release the error message.
-	errorMessage->Release();
-	errorMessage = 0;
-
-	// Pop a message up on the screen to notify the user to check the text file for compile errors.
-	MessageBox(hwnd, L"Error compiling shader. Check '__shader-error.txt' for message.", shaderFilename, MB_OK);
+	return Render(deviceContext, indexCount, worldMatrix, viewMatrix, projectionMatrix, texture, false);
 }
 
-// The SetShaderParameters function sets all the shader variables before rendering.
-bool FontShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext,
-						D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, D3DXVECTOR4 pixelColor)
+bool FontShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCount,
+								D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, bool sdf)
 {
-	HRESULT result;
-	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	ConstantBufferType* dataPtr;
-	unsigned int bufferNumber;
-	PixelBufferType* dataPtr2;
-
-	// Lock the constant buffer so it can be written to.
-	result = deviceContext->Map(m_constantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if(FAILED(result))
-		return false;
+	TraceScopeClass scope("FontShaderClass::Render");
 
-	// Get a pointer to the data in the constant buffer.
-	dataPtr = (ConstantBufferType*)mappedResource.pData;
+	ConstantBufferType matrices;
 
 	// Transpose the matrices to prepare them for the shader.
-	D3DXMatrixTranspose(&worldMatrix, &worldMatrix);
-	D3DXMatrixTranspose(&viewMatrix,  &viewMatrix);
-	D3DXMatrixTranspose(&projectionMatrix, &projectionMatrix);
-
-	// Copy the matrices into the constant buffer.
-	dataPtr->world = worldMatrix;
-	dataPtr->view  = viewMatrix;
-	dataPtr->projection = projectionMatrix;
-
-	// Unlock the constant buffer.
-	deviceContext->Unmap(m_constantBuffer, 0);
-
-	// Set the position of the constant buffer in the vertex shader.
-	bufferNumber = 0;
+	D3DXMatrixTranspose(&matrices.world, &worldMatrix);
+	D3DXMatrixTranspose(&matrices.view,  &viewMatrix);
+	D3DXMatrixTranspose(&matrices.projection, &projectionMatrix);
 
-	// Now set the constant buffer in the vertex shader with the updated values.
-	deviceContext->VSSetConstantBuffers(bufferNumber, 1, &m_constantBuffer);
+	// Set the matrices in the constant buffer of the vertex shader.
+	if (!m_program.SetConstants<0>(deviceContext, matrices))
+		return false;
 
 	// Set shader texture resource in the pixel shader.
 	deviceContext->PSSetShaderResources(0, 1, &texture);
 
-	// Here is where we set the pixel color before rendering.
-	// We lock the pixel constant buffer and then set the pixel color inside it and unlock it again.
-	// We set the constant buffer position in the pixel shader and it is ready for use.
-
-	// Lock the pixel constant buffer so it can be written to.
-	result = deviceContext->Map(m_pixelBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if(FAILED(result))
-		return false;
-
-	// Get a pointer to the data in the pixel constant buffer.
-	dataPtr2 = (PixelBufferType*)mappedResource.pData;
-
-	// Copy the pixel color into the pixel constant buffer.
-	dataPtr2->pixelColor = pixelColor;
+	// Set the input layout, the shaders and the sampler, and render the triangles.
+	m_program.Bind(deviceContext, sdf ? PIXEL_SHADER_SDF : PIXEL_SHADER_TEXTURE);
 
-	// Unlock the pixel constant buffer.
-	deviceContext->Unmap(m_pixelBuffer, 0);
-
-	// Set the position of the pixel constant buffer in the pixel shader.
-	bufferNumber = 0;
-
-	// Now set the pixel constant buffer in the pixel shader with the updated value.
-	deviceContext->PSSetConstantBuffers(bufferNumber, 1, &m_pixelBuffer);
-
-	return true;
-}
-
-// RenderShader draws the prepared font vertex/index buffers using the font shader.
-void FontShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount)
-{
-	// Set the vertex input layout.
-	deviceContext->IASetInputLayout(m_layout);
-
-	// Set the vertex and pixel shaders that will be used to render the triangles.
-	deviceContext->VSSetShader(m_vertexShader, NULL, 0);
-	deviceContext->PSSetShader(m_pixelShader, NULL, 0);
-
-	// Set the sampler state in the pixel shader.
-	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
-
-	// Render the triangles.
 	deviceContext->DrawIndexed(indexCount, 0, 0);
+	PerfStatsClass::CountDraw();
 
-	return;
+	return true;
 }
@@ -5,27 +5,31 @@
 
 #include <d3d11.h>
 #include <d3dx10math.h>
-#include <d3dx11async.h>
-#include <fstream>
-using namespace std;
 
-class FontShaderClass {
- private:
+#include "__shaderProgramClass.h"
+#include "__shaderConstantsClass.h"
 
-	struct ConstantBufferType
-	{
-		D3DXMATRIX world;
-		D3DXMATRIX view;
-		D3DXMATRIX projection;
+class FontShaderClass {
+ public:
+	// The vertex of the text: the FontClass, the DynamicFontClass and the PerfHudClass all write this one.
+	// The color of the letter comes with every vertex, so sentences of different colors share one draw call.
+	struct VertexType {
+		D3DXVECTOR3 position;
+		D3DXVECTOR2 texture;
+		D3DXVECTOR4 color;
 	};
 
-	// We have a new structure type to match the PixleBuffer in the pixel shader.
-	// It contains just the pixel color of the text that will be rendered.
+	typedef VertexLayoutClass<VertexType,
+							  VERTEX_ELEMENT(VertexType, position, PositionSemantic),
+							  VERTEX_ELEMENT(VertexType, texture,  TexcoordSemantic),
+							  VERTEX_ELEMENT(VertexType, color,	   ColorSemantic)> VertexLayout;
 
-	struct PixelBufferType
-	{
-		D3DXVECTOR4 pixelColor;
-	};
+ private:
+
+	typedef ShaderConstantsClass<D3DXMATRIX, D3DXVECTOR3, D3DXVECTOR4>::MatrixBufferType ConstantBufferType;
+
+	// The pixel shaders of the program
+	enum { PIXEL_SHADER_TEXTURE, PIXEL_SHADER_SDF };
 
  public:
 	FontShaderClass();
@@ -34,25 +38,13 @@ class FontShaderClass {
 
 	bool Initialize(ID3D11Device*, HWND);
 	void Shutdown();
-	bool Render(ID3D11DeviceContext*, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, D3DXVECTOR4);
-
- private:
-	bool InitializeShader(ID3D11Device*, HWND, WCHAR*, WCHAR*);
-	void ShutdownShader();
-	void OutputShaderErrorMessage(ID3D10Blob*, HWND, WCHAR*);
-
-	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, D3DXVECTOR4);
-	void RenderShader(ID3D11DeviceContext*, int);
+	// The color of the text comes with every vertex, so all the sentences can be drawn with one call.
+	bool Render(ID3D11DeviceContext*, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*);
+	// With sdf set the texture is a signed distance field atlas and the FontSdfPixelShader is used.
+	bool Render(ID3D11DeviceContext*, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, bool);
 
  private:
-	ID3D11VertexShader	*m_vertexShader;
-	ID3D11PixelShader	*m_pixelShader;
-	ID3D11InputLayout	*m_layout;
-	ID3D11Buffer		*m_constantBuffer;
-	ID3D11SamplerState	*m_sampleState;
-
-	// The FontShaderClass has a constant buffer for the pixel color that will be used to render the text fonts with color.
-	ID3D11Buffer		*m_pixelBuffer;
+	ShaderProgramClass<VertexLayout, ConstantBufferClass<ConstantBufferType, SHADER_VERTEX, 0> > m_program;
 };
 
-#endif
\ No newline at end of file
+#endif
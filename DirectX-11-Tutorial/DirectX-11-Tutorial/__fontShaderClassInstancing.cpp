@@ -0,0 +1,373 @@
+#include "__fontShaderClassInstancing.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
+#include "__shaderLoaderClass.h"
+
+// for D3DCompileFromFile
+#pragma comment(lib, "d3dcompiler.lib")
+#include "D3Dcompiler.h"
+
+FontShaderClass_Instancing::FontShaderClass_Instancing()
+{
+	m_vertexShader	 = 0;
+	m_pixelShader	 = 0;
+	m_layout		 = 0;
+	m_constantBuffer = 0;
+	m_glyphBuffer	 = 0;
+	m_sampleState	 = 0;
+
+	m_glyphTable	   = 0;
+	m_glyphVersion	   = 0;
+	m_glyphUploadCount = 0;
+}
+
+FontShaderClass_Instancing::FontShaderClass_Instancing(const FontShaderClass_Instancing& other)
+{
+}
+
+FontShaderClass_Instancing::~FontShaderClass_Instancing()
+{
+}
+
+bool FontShaderClass_Instancing::Initialize(ID3D11Device* device, HWND hwnd)
+{
+	bool result;
+
+	// The instanced vertex shader has its own file, the pixel shader is the one of the FontShaderClass.
+	result = InitializeShader(device, hwnd, L"../DirectX-11-Tutorial/_shaderFontInstancing.vs", L"../DirectX-11-Tutorial/_shaderFont.ps");
+	if(!result)
+		return false;
+
+	return true;
+}
+
+void FontShaderClass_Instancing::Shutdown()
+{
+	// Shutdown the vertex and pixel shaders as well as the related objects.
+	ShutdownShader();
+}
+
+bool FontShaderClass_Instancing::Render(ID3D11DeviceContext* deviceContext, int vertexCount, int instanceCount,
+										D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture,
+										GlyphTableClass *glyphTable)
+{
+	TraceScopeClass scope("FontShaderClass_Instancing::Render");
+
+	bool result;
+
+	// Set the shader parameters that it will use for rendering.
+	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, glyphTable);
+	if(!result)
+		return false;
+
+	// Now render the prepared buffers with the shader.
+	RenderShader(deviceContext, vertexCount, instanceCount);
+
+	return true;
+}
+
+int FontShaderClass_Instancing::GetGlyphUploadCount()
+{
+	return m_glyphUploadCount;
+}
+
+bool FontShaderClass_Instancing::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
+{
+	HRESULT				 result;
+	ID3D10Blob			*errorMessage;
+	ID3D10Blob			*vertexShaderBuffer;
+	ID3D10Blob			*pixelShaderBuffer;
+	unsigned int		 numElements;
+	D3D11_BUFFER_DESC	 constantBufferDesc, glyphBufferDesc;
+	D3D11_SAMPLER_DESC	 samplerDesc;
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[4];
+
+
+	// Initialize the pointers this function will use to null.
+	errorMessage		= 0;
+	vertexShaderBuffer	= 0;
+	pixelShaderBuffer	= 0;
+
+	// Compile the vertex shader code.
+	result = ShaderLoaderClass::CompileFromFile(vsFilename, "FontInstancingVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, &vertexShaderBuffer, &errorMessage);
+
+	if(FAILED(result)) {
+
+		// If the shader failed to compile it should have writen something to the error message.
+		if(errorMessage)
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
+		else
+			// If there was  nothing in the error message then it simply could not find the shader file itself.
+			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
+
+		return false;
+	}
+
+	// Compile the pixel shader code.
+	result = ShaderLoaderClass::CompileFromFile(psFilename, "FontPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, &pixelShaderBuffer, &errorMessage);
+
+	if(FAILED(result)) {
+
+		// If the shader failed to compile it should have writen something to the error message.
+		if(errorMessage)
+			OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
+		else
+			// If there was  nothing in the error message then it simply could not find the file itself.
+			MessageBox(hwnd, psFilename, L"Missing Shader File", MB_OK);
+
+		return false;
+	}
+
+	// Create the vertex shader from the buffer.
+	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &m_vertexShader);
+	if(FAILED(result))
+		return false;
+
+	// Create the pixel shader from the buffer.
+	result = device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), NULL, &m_pixelShader);
+	if(FAILED(result))
+		return false;
+
+	// The first slot only has the corner of the unit quad.
+	polygonLayout[0].SemanticName		= "POSITION";
+	polygonLayout[0].SemanticIndex		= 0;
+	polygonLayout[0].Format				= DXGI_FORMAT_R32G32_FLOAT;
+	polygonLayout[0].InputSlot			= 0;
+	polygonLayout[0].AlignedByteOffset	= 0;
+	polygonLayout[0].InputSlotClass		= D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[0].InstanceDataStepRate = 0;
+
+	// The second slot is the instance buffer, one GlyphTableClass::InstanceType per letter:
+	// the pen position, the glyph id and the color, 8 bits per channel.
+	polygonLayout[1].SemanticName		= "TEXCOORD";
+	polygonLayout[1].SemanticIndex		= 1;
+	polygonLayout[1].Format				= DXGI_FORMAT_R32G32_FLOAT;
+	polygonLayout[1].InputSlot			= 1;
+	polygonLayout[1].AlignedByteOffset	= 0;
+	polygonLayout[1].InputSlotClass		= D3D11_INPUT_PER_INSTANCE_DATA;
+	polygonLayout[1].InstanceDataStepRate = 1;
+
+	polygonLayout[2].SemanticName		= "TEXCOORD";
+	polygonLayout[2].SemanticIndex		= 2;
+	polygonLayout[2].Format				= DXGI_FORMAT_R32_UINT;
+	polygonLayout[2].InputSlot			= 1;
+	polygonLayout[2].AlignedByteOffset	= D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[2].InputSlotClass		= D3D11_INPUT_PER_INSTANCE_DATA;
+	polygonLayout[2].InstanceDataStepRate = 1;
+
+	polygonLayout[3].SemanticName		= "COLOR";
+	polygonLayout[3].SemanticIndex		= 0;
+	polygonLayout[3].Format				= DXGI_FORMAT_R8G8B8A8_UNORM;
+	polygonLayout[3].InputSlot			= 1;
+	polygonLayout[3].AlignedByteOffset	= D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[3].InputSlotClass		= D3D11_INPUT_PER_INSTANCE_DATA;
+	polygonLayout[3].InstanceDataStepRate = 1;
+
+	// Get a count of the elements in the layout.
+	numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
+
+	// Create the vertex input layout.
+	result = device->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &m_layout);
+	if(FAILED(result))
+		return false;
+
+	// Release the vertex shader buffer and pixel shader buffer since they are no longer needed.
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+
+	pixelShaderBuffer->Release();
+	pixelShaderBuffer = 0;
+
+	// Setup the description of the dynamic constant buffer that is in the vertex shader.
+	constantBufferDesc.Usage			= D3D11_USAGE_DYNAMIC;
+	constantBufferDesc.ByteWidth		= sizeof(ConstantBufferType);
+	constantBufferDesc.BindFlags		= D3D11_BIND_CONSTANT_BUFFER;
+	constantBufferDesc.CPUAccessFlags	= D3D11_CPU_ACCESS_WRITE;
+	constantBufferDesc.MiscFlags		= 0;
+	constantBufferDesc.StructureByteStride = 0;
+
+	result = device->CreateBuffer(&constantBufferDesc, NULL, &m_constantBuffer);
+	if(FAILED(result))
+		return false;
+
+	// The glyph table rarely changes, so its buffer is a default one updated with UpdateSubresource.
+	glyphBufferDesc.Usage			= D3D11_USAGE_DEFAULT;
+	glyphBufferDesc.ByteWidth		= sizeof(GlyphTableClass::GlyphType) * GLYPH_TABLE_MAX_GLYPHS;
+	glyphBufferDesc.BindFlags		= D3D11_BIND_CONSTANT_BUFFER;
+	glyphBufferDesc.CPUAccessFlags	= 0;
+	glyphBufferDesc.MiscFlags		= 0;
+	glyphBufferDesc.StructureByteStride = 0;
+
+	result = device->CreateBuffer(&glyphBufferDesc, NULL, &m_glyphBuffer);
+	if(FAILED(result))
+		return false;
+
+	// Create a texture sampler state description.
+	samplerDesc.Filter		   = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.AddressU	   = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressV	   = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressW	   = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.MipLODBias     = 0.0f;
+	samplerDesc.MaxAnisotropy  = 1;
+	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+	samplerDesc.BorderColor[0] = 0;
+	samplerDesc.BorderColor[1] = 0;
+	samplerDesc.BorderColor[2] = 0;
+	samplerDesc.BorderColor[3] = 0;
+	samplerDesc.MinLOD		   = 0;
+	samplerDesc.MaxLOD		   = D3D11_FLOAT32_MAX;
+
+	// Create the texture sampler state.
+	result = device->CreateSamplerState(&samplerDesc, &m_sampleState);
+	if(FAILED(result))
+		return false;
+
+	return true;
+}
+
+void FontShaderClass_Instancing::ShutdownShader()
+{
+	// Release the sampler state.
+	if(m_sampleState) {
+		m_sampleState->Release();
+		m_sampleState = 0;
+	}
+
+	// Release the constant buffers.
+	if(m_glyphBuffer) {
+		m_glyphBuffer->Release();
+		m_glyphBuffer = 0;
+	}
+
+	if(m_constantBuffer) {
+		m_constantBuffer->Release();
+		m_constantBuffer = 0;
+	}
+
+	// Release the layout.
+	if(m_layout) {
+		m_layout->Release();
+		m_layout = 0;
+	}
+
+	// Release the pixel shader.
+	if(m_pixelShader) {
+		m_pixelShader->Release();
+		m_pixelShader = 0;
+	}
+
+	// Release the vertex shader.
+	if(m_vertexShader) {
+		m_vertexShader->Release();
+		m_vertexShader = 0;
+	}
+
+	m_glyphTable = 0;
+}
+
+// OutputShaderErrorMessage writes any shader compilation errors to a text file that can be reviewed in the event of a failure in compilation.
+void FontShaderClass_Instancing::OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFilename)
+{
+	char* compileErrors;
+	unsigned long bufferSize, i;
+	ofstream fout;
+
+	// Get a pointer to the error message text buffer.
+	compileErrors = (char*)(errorMessage->GetBufferPointer());
+
+	// Get the length of the message.
+	bufferSize = errorMessage->GetBufferSize();
+
+	// Open a file to write the error message to.
+	fout.open("____shader-error.txt");
+
+	// Write out the error message.
+	for(i=0; i<bufferSize; i++)
+		fout << compileErrors[i];
+
+	// Close the file.
+	fout.close();
+
+	// Release the error message.
+	errorMessage->Release();
+	errorMessage = 0;
+
+	// Pop a message up on the screen to notify the user to check the text file for compile errors.
+	MessageBox(hwnd, L"Error compiling shader. Check '__shader-error.txt' for message.", shaderFilename, MB_OK);
+}
+
+bool FontShaderClass_Instancing::SetShaderParameters(ID3D11DeviceContext* deviceContext,
+						D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture,
+						GlyphTableClass *glyphTable)
+{
+	TraceScopeClass scope("FontShaderClass_Instancing::SetShaderParameters");
+
+	HRESULT result;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	ConstantBufferType* dataPtr;
+	ID3D11Buffer *buffers[2];
+
+	// Lock the constant buffer so it can be written to.
+	result = deviceContext->Map(m_constantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if(FAILED(result))
+		return false;
+
+	// Get a pointer to the data in the constant buffer.
+	dataPtr = (ConstantBufferType*)mappedResource.pData;
+
+	// Transpose the matrices to prepare them for the shader.
+	D3DXMatrixTranspose(&worldMatrix, &worldMatrix);
+	D3DXMatrixTranspose(&viewMatrix,  &viewMatrix);
+	D3DXMatrixTranspose(&projectionMatrix, &projectionMatrix);
+
+	// Copy the matrices into the constant buffer.
+	dataPtr->world = worldMatrix;
+	dataPtr->view  = viewMatrix;
+	dataPtr->projection = projectionMatrix;
+
+	// Unlock the constant buffer.
+	deviceContext->Unmap(m_constantBuffer, 0);
+	PerfStatsClass::CountMap(sizeof(ConstantBufferType));
+
+	// Copy the glyph table when it is another table or it changed since the last upload.
+	if (glyphTable != m_glyphTable || glyphTable->GetVersion() != m_glyphVersion) {
+
+		deviceContext->UpdateSubresource(m_glyphBuffer, 0, NULL, glyphTable->GetGlyphs(), 0, 0);
+		PerfStatsClass::CountMap(sizeof(GlyphTableClass::GlyphType) * GLYPH_TABLE_MAX_GLYPHS);
+
+		m_glyphTable   = glyphTable;
+		m_glyphVersion = glyphTable->GetVersion();
+		m_glyphUploadCount++;
+	}
+
+	// The matrices go to slot 0 and the glyph table to slot 1 of the vertex shader.
+	buffers[0] = m_constantBuffer;
+	buffers[1] = m_glyphBuffer;
+
+	deviceContext->VSSetConstantBuffers(0, 2, buffers);
+
+	// Set shader texture resource in the pixel shader.
+	deviceContext->PSSetShaderResources(0, 1, &texture);
+
+	return true;
+}
+
+// RenderShader draws the instances with DrawInstanced, every instance is one letter.
+void FontShaderClass_Instancing::RenderShader(ID3D11DeviceContext* deviceContext, int vertexCount, int instanceCount)
+{
+	// Set the vertex input layout.
+	deviceContext->IASetInputLayout(m_layout);
+
+	// Set the vertex and pixel shaders that will be used to render the triangles.
+	deviceContext->VSSetShader(m_vertexShader, NULL, 0);
+	deviceContext->PSSetShader(m_pixelShader,  NULL, 0);
+
+	// Set the sampler state in the pixel shader.
+	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
+
+	// Render the letters.
+	deviceContext->DrawInstanced(vertexCount, instanceCount, 0, 0);
+	PerfStatsClass::CountDraw();
+
+	return;
+}
@@ -0,0 +1,62 @@
+// The FontShaderClass_Instancing draws text from glyph instances instead of the six vertices per letter of the FontShaderClass.
+// The vertex shader expands a unit quad into each letter with the glyph table it gets in a second constant buffer,
+// the pixel shader is the FontPixelShader of the FontShaderClass.
+
+#ifndef _FONTSHADERCLASSINSTANCING_H_
+#define _FONTSHADERCLASSINSTANCING_H_
+
+#include <d3d11.h>
+#include <d3dx10math.h>
+#include <d3dx11async.h>
+#include <fstream>
+using namespace std;
+
+#include "__glyphTableClass.h"
+
+class FontShaderClass_Instancing {
+ private:
+	struct ConstantBufferType
+	{
+		D3DXMATRIX world;
+		D3DXMATRIX view;
+		D3DXMATRIX projection;
+	};
+
+ public:
+	FontShaderClass_Instancing();
+	FontShaderClass_Instancing(const FontShaderClass_Instancing &);
+   ~FontShaderClass_Instancing();
+
+	bool Initialize(ID3D11Device*, HWND);
+	void Shutdown();
+
+	// Render takes the vertex count of the quad and the number of letters.
+	// The glyph table is uploaded again only when it changed since the last Render.
+	bool Render(ID3D11DeviceContext*, int, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, GlyphTableClass*);
+
+	// Number of glyph table uploads since the shader was created.
+	int  GetGlyphUploadCount();
+
+ private:
+	bool InitializeShader(ID3D11Device*, HWND, WCHAR*, WCHAR*);
+	void ShutdownShader();
+	void OutputShaderErrorMessage(ID3D10Blob*, HWND, WCHAR*);
+
+	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, GlyphTableClass*);
+	void RenderShader(ID3D11DeviceContext*, int, int);
+
+ private:
+	ID3D11VertexShader	*m_vertexShader;
+	ID3D11PixelShader	*m_pixelShader;
+	ID3D11InputLayout	*m_layout;
+	ID3D11Buffer		*m_constantBuffer;
+	ID3D11Buffer		*m_glyphBuffer;
+	ID3D11SamplerState	*m_sampleState;
+
+	// The table and the version of it that is in the glyph buffer.
+	GlyphTableClass		*m_glyphTable;
+	unsigned int		 m_glyphVersion;
+	int					 m_glyphUploadCount;
+};
+
+#endif
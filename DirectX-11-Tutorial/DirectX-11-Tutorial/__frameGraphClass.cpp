@@ -0,0 +1,483 @@
+#include "__frameGraphClass.h"
+
+#include <string.h>
+
+FrameGraphClass::FrameGraphClass()
+{
+	m_backend		= 0;
+	m_valid			= true;
+	m_culled		= 0;
+	m_targetChanges = 0;
+	m_stateChanges	= 0;
+	m_transients	= 0;
+	m_pooled		= 0;
+}
+
+FrameGraphClass::FrameGraphClass(const FrameGraphClass& other)
+{
+}
+
+FrameGraphClass::~FrameGraphClass()
+{
+}
+
+bool FrameGraphClass::Initialize(RenderBackendClass *backend)
+{
+	if (!backend)
+		return false;
+
+	m_backend = backend;
+	Reset();
+
+	return true;
+}
+
+void FrameGraphClass::Shutdown()
+{
+	for (size_t i = 0; i < m_textures.size(); i++)
+		if (m_textures[i].handle)
+			m_backend->Release(m_textures[i].handle);
+
+	for (size_t i = 0; i < m_states.size(); i++)
+		if (m_states[i].handle)
+			m_backend->Release(m_states[i].handle);
+
+	m_textures.clear();
+	m_states.clear();
+	m_resources.clear();
+	m_passes.clear();
+	m_edges.clear();
+	m_successors.clear();
+	m_order.clear();
+	m_ready.clear();
+	m_backend = 0;
+
+	return;
+}
+
+void FrameGraphClass::Reset()
+{
+	m_resources.clear();
+	m_passes.clear();
+	m_order.clear();
+	m_valid = true;
+
+	ImportTexture(0, true);
+
+	return;
+}
+
+int FrameGraphClass::CreateTexture(const TextureDescType &desc)
+{
+	ResourceType resource;
+
+	resource.desc				= desc;
+	resource.desc.renderTarget	= true;
+	resource.transient			= true;
+	resource.output				= false;
+	resource.handle				= 0;
+	resource.texture			= -1;
+	resource.firstUse			= -1;
+	resource.lastUse			= -1;
+	resource.lastWriter			= -1;
+	resource.needed				= false;
+
+	m_resources.push_back(resource);
+
+	return (int)m_resources.size() - 1;
+}
+
+// An imported output is needed at the end of the frame like the back buffer, the passes that draw into it are never culled.
+int FrameGraphClass::ImportTexture(HandleType handle, bool output)
+{
+	ResourceType resource;
+
+	memset(&resource.desc, 0, sizeof(resource.desc));
+	resource.transient	= false;
+	resource.output		= output;
+	resource.handle		= handle;
+	resource.texture	= -1;
+	resource.firstUse	= -1;
+	resource.lastUse	= -1;
+	resource.lastWriter = -1;
+	resource.needed		= false;
+
+	m_resources.push_back(resource);
+
+	return (int)m_resources.size() - 1;
+}
+
+int FrameGraphClass::AddPass(const char *name, PassFunctionType function, void *data, const StateDescType &state)
+{
+	PassType pass;
+
+	pass.name		= name;
+	pass.function	= function;
+	pass.data		= data;
+	pass.state		= state;
+	pass.target		= FRAME_GRAPH_BACK_BUFFER;
+	pass.readCount	= 0;
+	pass.alive		= false;
+	pass.waiting	= 0;
+
+	if (!function)
+		m_valid = false;
+
+	m_passes.push_back(pass);
+
+	return (int)m_passes.size() - 1;
+}
+
+// The back buffer can't be sampled.
+void FrameGraphClass::Read(int pass, int resource)
+{
+	if (pass < 0 || pass >= (int)m_passes.size() || resource <= FRAME_GRAPH_BACK_BUFFER || resource >= (int)m_resources.size() ||
+		m_passes[pass].readCount == FRAME_GRAPH_MAX_READS) {
+		m_valid = false;
+		return;
+	}
+
+	m_passes[pass].reads[m_passes[pass].readCount++] = resource;
+
+	return;
+}
+
+void FrameGraphClass::Write(int pass, int resource)
+{
+	if (pass < 0 || pass >= (int)m_passes.size() || resource < 0 || resource >= (int)m_resources.size()) {
+		m_valid = false;
+		return;
+	}
+
+	m_passes[pass].target = resource;
+
+	return;
+}
+
+bool FrameGraphClass::Compile()
+{
+	int passCount = (int)m_passes.size();
+	int previousTarget;
+	int edgeCount;
+
+	m_order.clear();
+	m_edges.clear();
+	m_culled		= 0;
+	m_targetChanges = 0;
+	m_stateChanges	= 0;
+	m_transients	= 0;
+	m_pooled		= 0;
+
+	if (!m_valid)
+		return false;
+
+	for (int i = 0; i < passCount; i++)
+		for (int j = 0; j < m_passes[i].readCount; j++)
+			if (m_passes[i].reads[j] == m_passes[i].target)
+				return false;
+
+	// The culling goes from the last pass back: a pass is kept when its target is needed after it, and then what it reads is needed before it.
+	for (size_t i = 0; i < m_resources.size(); i++) {
+		m_resources[i].needed	  = m_resources[i].output;
+		m_resources[i].lastWriter = -1;
+		m_resources[i].firstUse	  = -1;
+		m_resources[i].lastUse	  = -1;
+		m_resources[i].texture	  = -1;
+	}
+
+	for (int i = passCount - 1; i >= 0; i--) {
+		PassType &pass = m_passes[i];
+
+		pass.alive = m_resources[pass.target].needed;
+
+		if (!pass.alive) {
+			m_culled++;
+			continue;
+		}
+
+		for (int j = 0; j < pass.readCount; j++)
+			m_resources[pass.reads[j]].needed = true;
+	}
+
+	// A pass waits for the last writer of what it reads, and for the last writer and the readers since of its target.
+	// The edges only go from a pass to a later one, so the declarations can't make a cycle.
+	for (int i = 0; i < passCount; i++) {
+		PassType &pass = m_passes[i];
+
+		if (!pass.alive)
+			continue;
+
+		for (int j = 0; j < pass.readCount; j++)
+			if (m_resources[pass.reads[j]].lastWriter >= 0)
+				AddEdge(m_resources[pass.reads[j]].lastWriter, i);
+
+		for (int k = m_resources[pass.target].lastWriter + 1; k < i; k++) {
+			if (!m_passes[k].alive)
+				continue;
+
+			for (int j = 0; j < m_passes[k].readCount; j++)
+				if (m_passes[k].reads[j] == pass.target) {
+					AddEdge(k, i);
+					break;
+				}
+		}
+
+		if (m_resources[pass.target].lastWriter >= 0)
+			AddEdge(m_resources[pass.target].lastWriter, i);
+
+		m_resources[pass.target].lastWriter = i;
+	}
+
+	// The successors of every pass one after the other, counted first
+	edgeCount = (int)m_edges.size();
+	m_successors.resize(edgeCount);
+
+	for (int i = 0; i < passCount; i++) {
+		m_passes[i].successorCount = 0;
+		m_passes[i].waiting		   = 0;
+	}
+
+	for (int i = 0; i < edgeCount; i++) {
+		m_passes[m_edges[i].from].successorCount++;
+		m_passes[m_edges[i].to].waiting++;
+	}
+
+	for (int i = 0, first = 0; i < passCount; i++) {
+		m_passes[i].firstSuccessor = first;
+		first += m_passes[i].successorCount;
+		m_passes[i].successorCount = 0;
+	}
+
+	for (int i = 0; i < edgeCount; i++) {
+		PassType &from = m_passes[m_edges[i].from];
+
+		m_successors[from.firstSuccessor + from.successorCount++] = m_edges[i].to;
+	}
+
+	// The passes are taken as they are free to run, the ones that keep the target and the state first.
+	m_ready.clear();
+
+	for (int i = 0; i < passCount; i++)
+		if (m_passes[i].alive && !m_passes[i].waiting)
+			m_ready.push_back(i);
+
+	previousTarget = -1;
+
+	while (!m_ready.empty()) {
+		int		  next = TakeNextPass(previousTarget, m_order.empty() ? 0 : &m_passes[m_order.back()].state);
+		PassType &pass = m_passes[next];
+
+		if (pass.target != previousTarget)
+			m_targetChanges++;
+
+		if (m_order.empty() || !SameState(pass.state, m_passes[m_order.back()].state))
+			m_stateChanges++;
+
+		previousTarget = pass.target;
+		m_order.push_back(next);
+
+		for (int i = 0; i < pass.successorCount; i++)
+			if (--m_passes[m_successors[pass.firstSuccessor + i]].waiting == 0)
+				m_ready.push_back(m_successors[pass.firstSuccessor + i]);
+	}
+
+	// The lifetimes of the resources, as positions in the order
+	for (int i = 0; i < (int)m_order.size(); i++) {
+		PassType &pass = m_passes[m_order[i]];
+
+		for (int j = 0; j <= pass.readCount; j++) {
+			ResourceType &resource = m_resources[j < pass.readCount ? pass.reads[j] : pass.target];
+
+			if (resource.firstUse < 0)
+				resource.firstUse = i;
+
+			resource.lastUse = i;
+		}
+	}
+
+	// The transient textures take the textures of the pool in the order they are first used:
+	// a texture of the pool is free again after the last use of the one that has it.
+	for (size_t i = 0; i < m_textures.size(); i++)
+		m_textures[i].lastUse = -1;
+
+	for (int i = 0; i < (int)m_order.size(); i++) {
+		PassType &pass = m_passes[m_order[i]];
+
+		for (int j = 0; j <= pass.readCount; j++) {
+			ResourceType &resource = m_resources[j < pass.readCount ? pass.reads[j] : pass.target];
+			int			  texture  = -1;
+
+			if (!resource.transient || resource.firstUse != i || resource.texture >= 0)
+				continue;
+
+			for (int k = 0; k < (int)m_textures.size() && texture < 0; k++) {
+				TextureType &candidate = m_textures[k];
+
+				if (candidate.lastUse < i && candidate.desc.width == resource.desc.width && candidate.desc.height == resource.desc.height &&
+					candidate.desc.format == resource.desc.format)
+					texture = k;
+			}
+
+			if (texture < 0) {
+				TextureType added;
+
+				added.desc	  = resource.desc;
+				added.handle  = 0;
+				added.lastUse = -1;
+
+				m_textures.push_back(added);
+				texture = (int)m_textures.size() - 1;
+			}
+
+			if (m_textures[texture].lastUse == -1)
+				m_pooled++;
+
+			m_textures[texture].lastUse = resource.lastUse;
+			resource.texture			= texture;
+			m_transients++;
+		}
+	}
+
+	return true;
+}
+
+// Execute makes what the pool is missing, then runs the passes with their targets and states.
+void FrameGraphClass::Execute()
+{
+	HandleType currentTarget = 0;
+	int		   currentState	 = -1;
+
+	for (size_t i = 0; i < m_textures.size(); i++)
+		if (m_textures[i].lastUse >= 0 && !m_textures[i].handle)
+			m_textures[i].handle = m_backend->CreateTexture(m_textures[i].desc, 0, 0);
+
+	for (size_t i = 0; i < m_order.size(); i++) {
+		PassType  &pass	  = m_passes[m_order[i]];
+		HandleType target = GetTexture(pass.target);
+		int		   state  = FindState(pass.state);
+
+		if (i == 0 || target != currentTarget) {
+			m_backend->SetRenderTarget(target);
+			currentTarget = target;
+		}
+
+		if (i == 0 || state != currentState) {
+			m_backend->SetState(state >= 0 ? m_states[state].handle : 0);
+			currentState = state;
+		}
+
+		pass.function(m_backend, pass.data);
+	}
+
+	return;
+}
+
+RenderBackendClass::HandleType FrameGraphClass::GetTexture(int resource)
+{
+	if (resource < 0 || resource >= (int)m_resources.size())
+		return 0;
+
+	if (!m_resources[resource].transient)
+		return m_resources[resource].handle;
+
+	return m_resources[resource].texture >= 0 ? m_textures[m_resources[resource].texture].handle : 0;
+}
+
+int FrameGraphClass::GetPassCount()
+{
+	return (int)m_order.size();
+}
+
+int FrameGraphClass::GetOrderedPass(int index)
+{
+	return m_order[index];
+}
+
+const char* FrameGraphClass::GetPassName(int pass)
+{
+	return m_passes[pass].name;
+}
+
+int FrameGraphClass::GetCulledCount()
+{
+	return m_culled;
+}
+
+int FrameGraphClass::GetTargetChanges()
+{
+	return m_targetChanges;
+}
+
+int FrameGraphClass::GetStateChanges()
+{
+	return m_stateChanges;
+}
+
+int FrameGraphClass::GetTransientCount()
+{
+	return m_transients;
+}
+
+int FrameGraphClass::GetPooledCount()
+{
+	return m_pooled;
+}
+
+int FrameGraphClass::GetPoolTexture(int resource)
+{
+	return m_resources[resource].texture;
+}
+
+void FrameGraphClass::AddEdge(int from, int to)
+{
+	EdgeType edge = { from, to };
+
+	m_edges.push_back(edge);
+
+	return;
+}
+
+// TakeNextPass takes a pass of the ready ones: one with the target and the state of the previous pass,
+// or else the target, or else the state, the first declared of the best.
+int FrameGraphClass::TakeNextPass(int previousTarget, const StateDescType *previousState)
+{
+	int best = 0, bestScore = -1;
+	int pass;
+
+	for (int i = 0; i < (int)m_ready.size(); i++) {
+		PassType &candidate = m_passes[m_ready[i]];
+		int		  score		= (candidate.target == previousTarget ? 2 : 0) + (previousState && SameState(candidate.state, *previousState) ? 1 : 0);
+
+		if (score > bestScore || (score == bestScore && m_ready[i] < m_ready[best])) {
+			best	  = i;
+			bestScore = score;
+		}
+	}
+
+	pass		  = m_ready[best];
+	m_ready[best] = m_ready.back();
+	m_ready.pop_back();
+
+	return pass;
+}
+
+// FindState gives the state object of a description, made the first time; -1 when the backend can't make it.
+int FrameGraphClass::FindState(const StateDescType &desc)
+{
+	StateType state;
+
+	for (int i = 0; i < (int)m_states.size(); i++)
+		if (SameState(m_states[i].desc, desc))
+			return m_states[i].handle ? i : -1;
+
+	state.desc	 = desc;
+	state.handle = m_backend->CreateState(desc);
+	m_states.push_back(state);
+
+	return state.handle ? (int)m_states.size() - 1 : -1;
+}
+
+bool FrameGraphClass::SameState(const StateDescType &a, const StateDescType &b)
+{
+	return a.alphaBlending == b.alphaBlending && a.depthTest == b.depthTest && a.depthWrite == b.depthWrite && a.cullBack == b.cullBack;
+}
@@ -0,0 +1,148 @@
+// --------------------------------------------------------------------------------------------------------
+// FrameGraphClass orders the passes of a frame from what they read and write, instead of the order they are written in.
+// Every frame the passes are declared again: each one draws into the one texture it writes (the back buffer by default)
+// with the state it declares, and reads the textures it samples.
+//
+// Compile works out the frame from the declarations:
+// - the passes whose target nothing needs are culled: the back buffer and the imported outputs are needed,
+//   and so is what a pass that is kept reads;
+// - a pass runs after the last pass before it that wrote what it reads, and after the passes before it that wrote or read its target,
+//   otherwise the passes are free to move: among the ones that can run, the one with the target and the state of the previous pass goes first,
+//   so the target and state changes come together;
+// - the transient textures get the textures of a pool: two of the same size and format whose passes don't overlap share one.
+//   Direct3D 11 has no placed resources, so sharing a texture is how their memory is shared.
+// Execute makes the textures and states the frame needs, switches the target and the state only when they change, and runs the passes.
+// The pool and the states are kept from frame to frame, and the declarations reuse their memory: a frame allocates nothing once it has run.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _FRAMEGRAPHCLASS_H_
+#define _FRAMEGRAPHCLASS_H_
+
+#include <vector>
+using namespace std;
+
+#include "__renderBackendClass.h"
+
+// The most textures a pass reads
+#define FRAME_GRAPH_MAX_READS RENDER_MAX_BINDINGS
+
+// The resource of the back buffer, there after every Reset
+#define FRAME_GRAPH_BACK_BUFFER 0
+
+
+
+class FrameGraphClass {
+ public:
+	typedef RenderBackendClass::HandleType		HandleType;
+	typedef RenderBackendClass::TextureDescType TextureDescType;
+	typedef RenderBackendClass::StateDescType	StateDescType;
+
+	// A pass records its draws into the context with the pointer it was declared with; the target and the state are already set.
+	typedef void (*PassFunctionType)(RenderContextClass *, void *);
+
+ private:
+	struct ResourceType {
+		TextureDescType desc;
+		bool			transient;		// a texture of the pool, else an imported texture
+		bool			output;
+		HandleType		handle;			// of an imported texture
+		int				texture;		// the texture of the pool of a transient one, -1 when it is not used
+		int				firstUse, lastUse;
+		int				lastWriter;
+		bool			needed;
+	};
+
+	struct PassType {
+		const char		*name;
+		PassFunctionType function;
+		void			*data;
+		StateDescType	 state;
+		int				 target;
+		int				 reads[FRAME_GRAPH_MAX_READS];
+		int				 readCount;
+		bool			 alive;
+		int				 waiting;		// the passes it still waits for, while the order is worked out
+		int				 firstSuccessor, successorCount;
+	};
+
+	// A pass that has to run before another
+	struct EdgeType {
+		int from, to;
+	};
+
+	struct TextureType {
+		TextureDescType desc;
+		HandleType		handle;
+		int				lastUse;
+	};
+
+	struct StateType {
+		StateDescType desc;
+		HandleType	  handle;
+	};
+
+ public:
+	FrameGraphClass();
+	FrameGraphClass(const FrameGraphClass &);
+   ~FrameGraphClass();
+
+	bool Initialize(RenderBackendClass *);
+	void Shutdown();
+
+	// Reset starts the declarations of a new frame.
+	void Reset();
+
+	// The resources are numbers from 0, the back buffer being FRAME_GRAPH_BACK_BUFFER.
+	// A transient texture is a render target the passes of the frame hand to each other; an imported texture is made elsewhere.
+	int CreateTexture(const TextureDescType &);
+	int ImportTexture(HandleType, bool);
+
+	// AddPass declares a pass with its name, function, data and state; Read and Write declare what it samples and draws into.
+	// A pass can't read its own target.
+	int	 AddPass(const char *, PassFunctionType, void *, const StateDescType &);
+	void Read(int, int);
+	void Write(int, int);
+
+	// Compile returns false when a declaration was wrong.
+	bool Compile();
+	void Execute();
+
+	// The texture of a resource, for the passes to bind what they read. The transient ones have one once Execute made them.
+	HandleType GetTexture(int);
+
+	// What Compile worked out: the passes in their order, the culled ones, the changes of target and state,
+	// and the transient textures with the textures of the pool they took.
+	int			GetPassCount();
+	int			GetOrderedPass(int);
+	const char* GetPassName(int);
+	int			GetCulledCount();
+	int			GetTargetChanges();
+	int			GetStateChanges();
+	int			GetTransientCount();
+	int			GetPooledCount();
+	int			GetPoolTexture(int);
+
+ private:
+	void AddEdge(int, int);
+	int	 TakeNextPass(int, const StateDescType *);
+	int	 FindState(const StateDescType &);
+
+	static bool SameState(const StateDescType &, const StateDescType &);
+
+ private:
+	RenderBackendClass	 *m_backend;
+	vector<ResourceType>  m_resources;
+	vector<PassType>	  m_passes;
+	vector<EdgeType>	  m_edges;
+	vector<int>			  m_successors;		// the edges by the pass they start from
+	vector<int>			  m_order;
+	vector<int>			  m_ready;
+	bool				  m_valid;
+	int					  m_culled, m_targetChanges, m_stateChanges, m_transients, m_pooled;
+
+	vector<TextureType>	  m_textures;
+	vector<StateType>	  m_states;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include "__gdiGlyphRasterizerClass.h"
+
+GdiGlyphRasterizerClass::GdiGlyphRasterizerClass()
+{
+	m_fontFile[0] = 0;
+	m_faceName[0] = 0;
+	m_fontAdded	  = false;
+	m_dc		  = 0;
+}
+
+GdiGlyphRasterizerClass::GdiGlyphRasterizerClass(const GdiGlyphRasterizerClass& other)
+{
+}
+
+GdiGlyphRasterizerClass::~GdiGlyphRasterizerClass()
+{
+}
+
+bool GdiGlyphRasterizerClass::Initialize(WCHAR *fontFile, WCHAR *faceName)
+{
+	wcscpy_s(m_fontFile, MAX_PATH, fontFile);
+	wcscpy_s(m_faceName, LF_FACESIZE, faceName);
+
+	// Make the font known to GDI for this process only.
+	if (AddFontResourceEx(m_fontFile, FR_PRIVATE, 0) == 0)
+		return false;
+
+	m_fontAdded = true;
+
+	// The glyphs are not drawn into the DC, it is only needed to select the fonts into.
+	m_dc = CreateCompatibleDC(NULL);
+	if (!m_dc)
+		return false;
+
+	return true;
+}
+
+void GdiGlyphRasterizerClass::Shutdown()
+{
+	for (map<int, HFONT>::iterator it = m_fonts.begin(); it != m_fonts.end(); ++it)
+		DeleteObject(it->second);
+
+	m_fonts.clear();
+
+	if (m_dc) {
+		DeleteDC(m_dc);
+		m_dc = 0;
+	}
+
+	if (m_fontAdded) {
+		RemoveFontResourceEx(m_fontFile, FR_PRIVATE, 0);
+		m_fontAdded = false;
+	}
+
+	return;
+}
+
+// RasterizeGlyph asks GDI for the 65 level gray bitmap of the glyph and scales it to 0..255.
+// GDI pads the rows of the bitmap to 4 bytes, the result is tightly packed.
+bool GdiGlyphRasterizerClass::RasterizeGlyph(unsigned int codepoint, int size, GlyphBitmapType *bitmap)
+{
+	GLYPHMETRICS gm;
+	MAT2		 identity = { { 0, 1 }, { 0, 0 }, { 0, 0 }, { 0, 1 } };
+	DWORD		 bufferSize;
+	int			 pitch;
+
+	if (codepoint > 0xFFFF)
+		return false;
+
+	lock_guard<mutex> lock(m_mutex);
+
+	SelectObject(m_dc, GetFont(size));
+
+	bufferSize = GetGlyphOutline(m_dc, codepoint, GGO_GRAY8_BITMAP, &gm, 0, 0, &identity);
+	if (bufferSize == GDI_ERROR)
+		return false;
+
+	bitmap->bearingX = gm.gmptGlyphOrigin.x;
+	bitmap->bearingY = gm.gmptGlyphOrigin.y;
+	bitmap->advance	 = (float)gm.gmCellIncX;
+
+	// A glyph without ink (a space) has no bitmap, only the advance.
+	if (bufferSize == 0) {
+		bitmap->width  = 0;
+		bitmap->height = 0;
+		bitmap->pixels.clear();
+		return true;
+	}
+
+	m_buffer.resize(bufferSize);
+
+	if (GetGlyphOutline(m_dc, codepoint, GGO_GRAY8_BITMAP, &gm, bufferSize, &m_buffer[0], &identity) == GDI_ERROR)
+		return false;
+
+	bitmap->width  = gm.gmBlackBoxX;
+	bitmap->height = gm.gmBlackBoxY;
+	bitmap->pixels.resize(bitmap->width * bitmap->height);
+
+	pitch = (bitmap->width + 3) & ~3;
+
+	for (int y = 0; y < bitmap->height; y++)
+		for (int x = 0; x < bitmap->width; x++)
+			bitmap->pixels[y * bitmap->width + x] = (unsigned char)(m_buffer[y * pitch + x] * 255 / 64);
+
+	return true;
+}
+
+void GdiGlyphRasterizerClass::GetLineMetrics(int size, int *ascent, int *lineHeight)
+{
+	TEXTMETRIC tm;
+
+	lock_guard<mutex> lock(m_mutex);
+
+	SelectObject(m_dc, GetFont(size));
+
+	if (!GetTextMetrics(m_dc, &tm)) {
+		*ascent		= size;
+		*lineHeight = size;
+		return;
+	}
+
+	*ascent		= tm.tmAscent;
+	*lineHeight = tm.tmHeight + tm.tmExternalLeading;
+
+	return;
+}
+
+// GetFont creates the GDI font of the given pixel size the first time it is needed. Called with m_mutex held.
+HFONT GdiGlyphRasterizerClass::GetFont(int size)
+{
+	map<int, HFONT>::iterator it = m_fonts.find(size);
+
+	if (it != m_fonts.end())
+		return it->second;
+
+	// A negative height asks for the size of the characters rather than the size of the cells.
+	HFONT font = CreateFont(-size, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
+							OUT_TT_ONLY_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH, m_faceName);
+
+	m_fonts[size] = font;
+
+	return font;
+}
@@ -0,0 +1,46 @@
+// --------------------------------------------------------------------------------------------------------
+// GdiGlyphRasterizerClass renders the glyphs of a TrueType font for the GlyphAtlasClass, using GDI's GetGlyphOutline.
+// The font file is loaded as a private font resource, so it doesn't need to be installed.
+// GetGlyphOutline only takes 16 bit characters, so the codepoints past U+FFFF are reported as missing.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _GDIGLYPHRASTERIZERCLASS_H_
+#define _GDIGLYPHRASTERIZERCLASS_H_
+
+#include <windows.h>
+#include <map>
+
+#include "__glyphAtlasClass.h"
+
+
+
+class GdiGlyphRasterizerClass : public GlyphRasterizerClass {
+ public:
+	GdiGlyphRasterizerClass();
+	GdiGlyphRasterizerClass(const GdiGlyphRasterizerClass &);
+   ~GdiGlyphRasterizerClass();
+
+	// Initialize takes the font file and the face name of the font in it.
+	bool Initialize(WCHAR *, WCHAR *);
+	void Shutdown();
+
+	// GlyphRasterizerClass
+	bool RasterizeGlyph(unsigned int, int, GlyphBitmapType *);
+	void GetLineMetrics(int, int *, int *);
+
+ private:
+	HFONT GetFont(int);
+
+ private:
+	WCHAR				 m_fontFile[MAX_PATH];
+	WCHAR				 m_faceName[LF_FACESIZE];
+	bool				 m_fontAdded;
+	HDC					 m_dc;
+	map<int, HFONT>		 m_fonts;		// one GDI font per pixel size
+
+	// The rasterizing runs on the atlas worker thread while the metrics are asked from the main thread, they share the DC.
+	mutex				 m_mutex;
+	vector<unsigned char> m_buffer;
+};
+
+#endif
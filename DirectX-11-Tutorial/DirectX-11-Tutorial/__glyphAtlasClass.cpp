@@ -0,0 +1,543 @@
+#include "__glyphAtlasClass.h"
+
+#include <string.h>
+
+GlyphAtlasClass::GlyphAtlasClass()
+{
+	m_rasterizer	= 0;
+	m_pageSize		= 0;
+	m_maxPages		= 0;
+	m_frame			= 0;
+	m_version		= 0;
+	m_evictionCount = 0;
+	m_threaded		= false;
+	m_quit			= false;
+	m_sdfSize		= 0;
+	m_sdfSpread		= 0;
+}
+
+GlyphAtlasClass::GlyphAtlasClass(const GlyphAtlasClass& other)
+{
+}
+
+GlyphAtlasClass::~GlyphAtlasClass()
+{
+}
+
+bool GlyphAtlasClass::Initialize(GlyphRasterizerClass *rasterizer, int pageSize, int maxPages, bool threaded)
+{
+	if (!rasterizer || pageSize <= 0 || maxPages <= 0)
+		return false;
+
+	m_rasterizer = rasterizer;
+	m_pageSize	 = pageSize;
+	m_maxPages	 = maxPages;
+	m_threaded	 = threaded;
+	m_quit		 = false;
+
+	if (m_threaded)
+		m_worker = thread(&GlyphAtlasClass::WorkerThread, this);
+
+	return true;
+}
+
+void GlyphAtlasClass::EnableSdf(int baseSize, int spread)
+{
+	m_sdfSize	= baseSize;
+	m_sdfSpread = spread;
+
+	return;
+}
+
+bool GlyphAtlasClass::IsSdf()
+{
+	return m_sdfSpread > 0;
+}
+
+int GlyphAtlasClass::GetSdfSize()
+{
+	return m_sdfSize;
+}
+
+int GlyphAtlasClass::GetSdfSpread()
+{
+	return m_sdfSpread;
+}
+
+void GlyphAtlasClass::Shutdown()
+{
+	// Stop the worker first, it may still be using the rasterizer.
+	if (m_worker.joinable()) {
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_quit = true;
+		}
+
+		m_wakeUp.notify_one();
+		m_worker.join();
+	}
+
+	for (size_t i = 0; i < m_pages.size(); i++) {
+		delete [] m_pages[i].pixels;
+		m_pages[i].pixels = 0;
+	}
+
+	m_pages.clear();
+	m_glyphs.clear();
+	m_pending.clear();
+	m_requests.clear();
+	m_results.clear();
+	m_deferred.clear();
+
+	m_rasterizer = 0;
+
+	return;
+}
+
+// Update packs what the worker has finished since the last frame.
+// The glyphs that could not be packed (all the pages were in use by the last frame) are tried again first.
+void GlyphAtlasClass::Update()
+{
+	vector<ResultType> results;
+
+	m_frame++;
+
+	results.swap(m_deferred);
+
+	if (m_threaded) {
+		lock_guard<mutex> lock(m_mutex);
+
+		for (size_t i = 0; i < m_results.size(); i++)
+			results.push_back(m_results[i]);
+
+		m_results.clear();
+	}
+
+	for (size_t i = 0; i < results.size(); i++)
+		if (!Store(results[i]))
+			m_deferred.push_back(results[i]);
+
+	return;
+}
+
+const GlyphAtlasClass::GlyphType* GlyphAtlasClass::FindGlyph(unsigned int codepoint, int size)
+{
+	unsigned long long key;
+
+	// All the sizes share the distance field of the base size.
+	if (m_sdfSpread > 0)
+		size = m_sdfSize;
+
+	key = MakeKey(codepoint, size);
+
+	unordered_map<unsigned long long, GlyphType>::iterator it = m_glyphs.find(key);
+
+	if (it == m_glyphs.end()) {
+		Request(key);
+
+		// Without the worker thread the glyph may be there already.
+		it = m_glyphs.find(key);
+		if (it == m_glyphs.end())
+			return 0;
+	}
+
+	it->second.lastUsed = m_frame;
+
+	if (it->second.page >= 0)
+		m_pages[it->second.page].lastUsed = m_frame;
+
+	return &it->second;
+}
+
+bool GlyphAtlasClass::IsPending()
+{
+	return !m_pending.empty();
+}
+
+int GlyphAtlasClass::GetPageSize()
+{
+	return m_pageSize;
+}
+
+int GlyphAtlasClass::GetPageCount()
+{
+	return (int)m_pages.size();
+}
+
+const unsigned char* GlyphAtlasClass::GetPagePixels(int page)
+{
+	return m_pages[page].pixels;
+}
+
+bool GlyphAtlasClass::GetDirtyRect(int page, int *left, int *top, int *right, int *bottom)
+{
+	PageType &p = m_pages[page];
+
+	if (p.dirtyRight <= p.dirtyLeft || p.dirtyBottom <= p.dirtyTop)
+		return false;
+
+	*left	= p.dirtyLeft;
+	*top	= p.dirtyTop;
+	*right	= p.dirtyRight;
+	*bottom = p.dirtyBottom;
+
+	return true;
+}
+
+void GlyphAtlasClass::ClearDirtyRect(int page)
+{
+	PageType &p = m_pages[page];
+
+	p.dirtyLeft	  = m_pageSize;
+	p.dirtyTop	  = m_pageSize;
+	p.dirtyRight  = 0;
+	p.dirtyBottom = 0;
+
+	return;
+}
+
+void GlyphAtlasClass::GetLineMetrics(int size, int *ascent, int *lineHeight)
+{
+	m_rasterizer->GetLineMetrics(size, ascent, lineHeight);
+
+	return;
+}
+
+const unsigned int* GlyphAtlasClass::GetVersionCounter()
+{
+	return &m_version;
+}
+
+int GlyphAtlasClass::GetGlyphCount()
+{
+	return (int)m_glyphs.size();
+}
+
+int GlyphAtlasClass::GetEvictionCount()
+{
+	return m_evictionCount;
+}
+
+int GlyphAtlasClass::DecodeUtf8(const char *text, unsigned int *codepoint)
+{
+	const unsigned char *s = (const unsigned char*)text;
+	unsigned int cp, min;
+	int length;
+
+	if (s[0] == 0) {
+		*codepoint = 0;
+		return 0;
+	}
+
+	if (s[0] < 0x80) {
+		*codepoint = s[0];
+		return 1;
+	}
+
+	// The lead byte gives the length of the sequence.
+	if ((s[0] & 0xE0) == 0xC0) {
+		cp = s[0] & 0x1F;
+		length = 2;
+		min = 0x80;
+	}
+	else if ((s[0] & 0xF0) == 0xE0) {
+		cp = s[0] & 0x0F;
+		length = 3;
+		min = 0x800;
+	}
+	else if ((s[0] & 0xF8) == 0xF0) {
+		cp = s[0] & 0x07;
+		length = 4;
+		min = 0x10000;
+	}
+	else {
+		*codepoint = 0xFFFD;
+		return 1;
+	}
+
+	for (int i = 1; i < length; i++) {
+
+		// A missing continuation byte (this includes the end of the string) makes the sequence invalid.
+		if ((s[i] & 0xC0) != 0x80) {
+			*codepoint = 0xFFFD;
+			return 1;
+		}
+
+		cp = (cp << 6) | (s[i] & 0x3F);
+	}
+
+	// Overlong forms, surrogates and values past the Unicode range are invalid too.
+	if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+		*codepoint = 0xFFFD;
+		return 1;
+	}
+
+	*codepoint = cp;
+
+	return length;
+}
+
+unsigned long long GlyphAtlasClass::MakeKey(unsigned int codepoint, int size)
+{
+	return ((unsigned long long)(unsigned int)size << 32) | codepoint;
+}
+
+// Request sends the glyph to the worker, or rasterizes it right away when there is no worker.
+void GlyphAtlasClass::Request(unsigned long long key)
+{
+	if (m_pending.count(key))
+		return;
+
+	m_pending.insert(key);
+
+	if (m_threaded) {
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_requests.push_back(key);
+		}
+
+		m_wakeUp.notify_one();
+	}
+	else {
+		ResultType result;
+
+		result.key = key;
+		result.ok  = Rasterize(key, &result.bitmap);
+
+		if (!Store(result))
+			m_deferred.push_back(result);
+	}
+
+	return;
+}
+
+// Rasterize asks the rasterizer for the glyph and, in SDF mode, replaces its coverage with the distance field.
+// The field is bigger than the bitmap by the spread on every side, so the bearings move by the spread too.
+bool GlyphAtlasClass::Rasterize(unsigned long long key, GlyphBitmapType *bitmap)
+{
+	if (!m_rasterizer->RasterizeGlyph((unsigned int)(key & 0xFFFFFFFF), (int)(key >> 32), bitmap))
+		return false;
+
+	if (m_sdfSpread > 0 && bitmap->width > 0 && bitmap->height > 0) {
+
+		m_Sdf.Generate(&bitmap->pixels[0], bitmap->width, bitmap->height, m_sdfSpread, &m_sdfField);
+
+		bitmap->pixels.swap(m_sdfField);
+		bitmap->width	 += 2 * m_sdfSpread;
+		bitmap->height	 += 2 * m_sdfSpread;
+		bitmap->bearingX -= m_sdfSpread;
+		bitmap->bearingY += m_sdfSpread;
+	}
+
+	return true;
+}
+
+// Store packs a rasterized glyph into a page and adds it to the cache.
+// It returns false when there is no room until the next frame, the caller keeps the glyph and tries again.
+bool GlyphAtlasClass::Store(ResultType &result)
+{
+	GlyphType glyph;
+	GlyphBitmapType &bitmap = result.bitmap;
+
+	glyph.page	   = -1;
+	glyph.x		   = 0;
+	glyph.y		   = 0;
+	glyph.width	   = 0;
+	glyph.height   = 0;
+	glyph.bearingX = 0;
+	glyph.bearingY = 0;
+	glyph.advance  = 0.0f;
+	glyph.lastUsed = m_frame;
+
+	if (result.ok) {
+		glyph.bearingX = bitmap.bearingX;
+		glyph.bearingY = bitmap.bearingY;
+		glyph.advance  = bitmap.advance;
+	}
+
+	// Empty glyphs (spaces) and glyphs that failed or are bigger than a page are cached without pixels, so they are not requested again.
+	if (result.ok && bitmap.width > 0 && bitmap.height > 0 && bitmap.width < m_pageSize && bitmap.height < m_pageSize) {
+
+		if (!Pack(bitmap.width, bitmap.height, &glyph.page, &glyph.x, &glyph.y))
+			return false;
+
+		glyph.width	 = bitmap.width;
+		glyph.height = bitmap.height;
+
+		PageType &page = m_pages[glyph.page];
+
+		for (int row = 0; row < glyph.height; row++)
+			memcpy(page.pixels + (glyph.y + row) * m_pageSize + glyph.x, &bitmap.pixels[row * glyph.width], glyph.width);
+
+		page.keys.push_back(result.key);
+		page.lastUsed = m_frame;
+
+		MarkDirty(glyph.page, glyph.x, glyph.y, glyph.x + glyph.width, glyph.y + glyph.height);
+	}
+
+	m_glyphs[result.key] = glyph;
+	m_pending.erase(result.key);
+	m_version++;
+
+	return true;
+}
+
+// Pack finds room for a glyph: first in the existing pages, then in a new page, and last in the page used least recently.
+// A page used during the current frame is never cleared, as text drawn this frame may still point into it.
+bool GlyphAtlasClass::Pack(int width, int height, int *page, int *x, int *y)
+{
+	int lru;
+
+	// One pixel of padding keeps the filtering from bleeding the neighbours in.
+	width++;
+	height++;
+
+	for (int i = 0; i < (int)m_pages.size(); i++)
+		if (PackInPage(i, width, height, x, y)) {
+			*page = i;
+			return true;
+		}
+
+	if ((int)m_pages.size() < m_maxPages) {
+		*page = AddPage();
+		return PackInPage(*page, width, height, x, y);
+	}
+
+	lru = -1;
+
+	for (int i = 0; i < (int)m_pages.size(); i++)
+		if (m_pages[i].lastUsed < m_frame && (lru < 0 || m_pages[i].lastUsed < m_pages[lru].lastUsed))
+			lru = i;
+
+	if (lru < 0)
+		return false;
+
+	EvictPage(lru);
+
+	*page = lru;
+
+	return PackInPage(lru, width, height, x, y);
+}
+
+// PackInPage puts the glyph on the shelf that wastes the least height. A new shelf is opened when the best one is much too tall.
+bool GlyphAtlasClass::PackInPage(int page, int width, int height, int *x, int *y)
+{
+	PageType &p = m_pages[page];
+	int best = -1;
+
+	for (int i = 0; i < (int)p.shelves.size(); i++) {
+		ShelfType &shelf = p.shelves[i];
+
+		if (shelf.height >= height && shelf.x + width <= m_pageSize)
+			if (best < 0 || shelf.height < p.shelves[best].height)
+				best = i;
+	}
+
+	if (best < 0 || (p.shelves[best].height > height + height / 2 && p.nextShelfY + height <= m_pageSize)) {
+
+		if (p.nextShelfY + height > m_pageSize) {
+			if (best < 0)
+				return false;
+		}
+		else {
+			ShelfType shelf;
+
+			shelf.y		 = p.nextShelfY;
+			shelf.height = height;
+			shelf.x		 = 0;
+
+			p.shelves.push_back(shelf);
+			p.nextShelfY += height;
+
+			best = (int)p.shelves.size() - 1;
+		}
+	}
+
+	*x = p.shelves[best].x;
+	*y = p.shelves[best].y;
+
+	p.shelves[best].x += width;
+
+	return true;
+}
+
+int GlyphAtlasClass::AddPage()
+{
+	PageType page;
+
+	page.pixels		= new unsigned char[m_pageSize * m_pageSize];
+	page.nextShelfY = 0;
+	page.lastUsed	= m_frame;
+
+	memset(page.pixels, 0, m_pageSize * m_pageSize);
+
+	m_pages.push_back(page);
+
+	// A new page starts clean, its texture is created empty.
+	ClearDirtyRect((int)m_pages.size() - 1);
+
+	return (int)m_pages.size() - 1;
+}
+
+// EvictPage forgets all the glyphs of the page and clears it. The glyphs will be requested again when some text needs them.
+void GlyphAtlasClass::EvictPage(int page)
+{
+	PageType &p = m_pages[page];
+
+	for (size_t i = 0; i < p.keys.size(); i++)
+		m_glyphs.erase(p.keys[i]);
+
+	p.keys.clear();
+	p.shelves.clear();
+	p.nextShelfY = 0;
+
+	memset(p.pixels, 0, m_pageSize * m_pageSize);
+	MarkDirty(page, 0, 0, m_pageSize, m_pageSize);
+
+	m_evictionCount++;
+	m_version++;
+
+	return;
+}
+
+void GlyphAtlasClass::MarkDirty(int page, int left, int top, int right, int bottom)
+{
+	PageType &p = m_pages[page];
+
+	if (left   < p.dirtyLeft)	p.dirtyLeft	  = left;
+	if (top	   < p.dirtyTop)	p.dirtyTop	  = top;
+	if (right  > p.dirtyRight)	p.dirtyRight  = right;
+	if (bottom > p.dirtyBottom)	p.dirtyBottom = bottom;
+
+	return;
+}
+
+// The worker rasterizes the requests one by one, the results are packed by Update on the main thread.
+void GlyphAtlasClass::WorkerThread()
+{
+	while (true) {
+		ResultType result;
+
+		{
+			unique_lock<mutex> lock(m_mutex);
+
+			while (!m_quit && m_requests.empty())
+				m_wakeUp.wait(lock);
+
+			if (m_quit)
+				return;
+
+			result.key = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		result.ok = Rasterize(result.key, &result.bitmap);
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_results.push_back(result);
+		}
+	}
+}
@@ -0,0 +1,180 @@
+// --------------------------------------------------------------------------------------------------------
+// GlyphAtlasClass is the cache of a dynamic font: glyphs are rasterized when some text first needs them
+// and packed into a few square atlas pages, instead of coming from one prebaked texture.
+//
+// A glyph is identified by its (codepoint, pixel size) pair, so any Unicode text in any size can be drawn.
+// The rasterizing is done by a GlyphRasterizerClass, on a worker thread when the atlas is threaded,
+// which means a glyph that was just requested shows up a frame or two later.
+// The packing is done on the calling thread in Update(): each page is filled with shelves (rows of glyphs of similar height).
+// When all the pages are full, the page used least recently is cleared and reused.
+//
+// The pages are kept as 8 bit coverage on the CPU side, with a dirty rectangle per page;
+// the owner of the textures (DynamicFontClass) uploads the dirty part after Update().
+// In SDF mode every glyph is rasterized once at a base size and stored as a signed distance field (SdfGeneratorClass),
+// whatever size is asked for, and the text is scaled from it by the pixel shader.
+//
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _GLYPHATLASCLASS_H_
+#define _GLYPHATLASCLASS_H_
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+#include "__sdfGeneratorClass.h"
+
+
+
+// GlyphBitmapType is what a rasterizer gives back for one glyph: an 8 bit coverage bitmap and its placement relative to the pen.
+struct GlyphBitmapType {
+	int		width, height;
+	int		bearingX;				// from the pen to the left edge of the bitmap
+	int		bearingY;				// from the baseline up to the top edge of the bitmap
+	float	advance;				// how far the pen moves after the glyph
+	vector<unsigned char> pixels;	// width * height, one byte per pixel, tightly packed
+};
+
+// The rasterizer interface. On Windows it is implemented with GDI (GdiGlyphRasterizerClass), any other implementation can be plugged in.
+// When the atlas is threaded, RasterizeGlyph is called on the worker thread only.
+class GlyphRasterizerClass {
+ public:
+	virtual ~GlyphRasterizerClass() {}
+
+	virtual bool RasterizeGlyph(unsigned int codepoint, int size, GlyphBitmapType *bitmap) = 0;
+
+	// Vertical metrics of the font in the given pixel size.
+	virtual void GetLineMetrics(int size, int *ascent, int *lineHeight) = 0;
+};
+
+
+
+class GlyphAtlasClass {
+ public:
+	// GlyphType is the placement of a cached glyph, in pixels of its page.
+	struct GlyphType {
+		int		page;
+		int		x, y, width, height;
+		int		bearingX, bearingY;
+		float	advance;
+		int		lastUsed;				// frame of the last lookup, for the LRU eviction
+	};
+
+ private:
+	struct ShelfType {
+		int y, height;
+		int x;							// first free column
+	};
+
+	struct PageType {
+		unsigned char			   *pixels;
+		vector<ShelfType>			shelves;
+		int							nextShelfY;
+		int							lastUsed;
+		vector<unsigned long long>	keys;	// glyphs living in the page, they are forgotten when the page is cleared
+		int							dirtyLeft, dirtyTop, dirtyRight, dirtyBottom;
+	};
+
+	struct ResultType {
+		unsigned long long	key;
+		bool				ok;
+		GlyphBitmapType		bitmap;
+	};
+
+ public:
+	GlyphAtlasClass();
+	GlyphAtlasClass(const GlyphAtlasClass &);
+   ~GlyphAtlasClass();
+
+	// Initialize takes the rasterizer (owned by the caller), the size of a page in pixels, the maximal number of pages,
+	// and whether the rasterizing goes to a worker thread. Without the thread, a requested glyph is ready right away.
+	bool Initialize(GlyphRasterizerClass *, int, int, bool);
+
+	// EnableSdf switches the atlas to distance fields of the given base size and spread. Call it before Initialize.
+	void EnableSdf(int, int);
+	bool IsSdf();
+	int  GetSdfSize();
+	int  GetSdfSpread();
+	void Shutdown();
+
+	// Update is called once per frame: it packs the glyphs rasterized since the last call and starts a new LRU frame.
+	void Update();
+
+	// FindGlyph returns the cached glyph, or 0 if it is not in the atlas yet, in which case it gets requested.
+	const GlyphType* FindGlyph(unsigned int, int);
+
+	// Tells if some requested glyphs are not packed yet.
+	bool IsPending();
+
+	int  GetPageSize();
+	int  GetPageCount();
+	const unsigned char* GetPagePixels(int);
+
+	// The dirty rectangle of a page is what changed since the last ClearDirtyRect; right and bottom are exclusive.
+	bool GetDirtyRect(int, int *, int *, int *, int *);
+	void ClearDirtyRect(int);
+
+	void GetLineMetrics(int, int *, int *);
+
+	// The version counter goes up every time glyphs are added or evicted, a LayerCacheClass can watch it.
+	const unsigned int* GetVersionCounter();
+
+	int  GetGlyphCount();
+	int  GetEvictionCount();
+
+	// UTF-8 helper: decodes the codepoint at text and returns the number of bytes it takes, 0 at the end of the string.
+	// Invalid sequences give U+FFFD and take one byte.
+	static int DecodeUtf8(const char *, unsigned int *);
+
+ private:
+	static unsigned long long MakeKey(unsigned int, int);
+
+	void Request(unsigned long long);
+	bool Rasterize(unsigned long long, GlyphBitmapType *);
+	bool Store(ResultType &);
+	bool Pack(int, int, int *, int *, int *);
+	bool PackInPage(int, int, int, int *, int *);
+	int  AddPage();
+	void EvictPage(int);
+	void MarkDirty(int, int, int, int, int);
+
+	void WorkerThread();
+
+ private:
+	GlyphRasterizerClass	*m_rasterizer;
+	int						 m_pageSize;
+	int						 m_maxPages;
+	vector<PageType>		 m_pages;
+
+	unordered_map<unsigned long long, GlyphType> m_glyphs;
+	unordered_set<unsigned long long>			 m_pending;	// requested, not packed yet
+
+	int						 m_frame;
+	unsigned int			 m_version;
+	int						 m_evictionCount;
+
+	// The worker thread takes the keys from m_requests and puts the bitmaps into m_results, both under m_mutex.
+	bool					 m_threaded;
+	thread					 m_worker;
+	mutex					 m_mutex;
+	condition_variable		 m_wakeUp;
+	deque<unsigned long long> m_requests;
+	vector<ResultType>		 m_results;
+	bool					 m_quit;
+
+	// Rasterized glyphs waiting for a page to become free.
+	vector<ResultType>		 m_deferred;
+
+	// Base size and spread of the distance fields, 0 when the atlas keeps plain coverage.
+	int						 m_sdfSize, m_sdfSpread;
+	SdfGeneratorClass		 m_Sdf;			// used by the thread that rasterizes
+	vector<unsigned char>	 m_sdfField;
+};
+
+#endif
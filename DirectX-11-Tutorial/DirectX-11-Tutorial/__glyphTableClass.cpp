@@ -0,0 +1,121 @@
+#include "__glyphTableClass.h"
+
+#include <string.h>
+
+// Corners of the unit quad: top left, bottom right, bottom left, top left, top right, bottom right.
+static const float s_quadCorners[6][2] = { { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } };
+
+GlyphTableClass::GlyphTableClass()
+{
+	m_version = 0;
+
+	Clear();
+}
+
+GlyphTableClass::GlyphTableClass(const GlyphTableClass& other)
+{
+}
+
+GlyphTableClass::~GlyphTableClass()
+{
+}
+
+void GlyphTableClass::Clear()
+{
+	memset(m_glyphs, 0, sizeof(m_glyphs));
+
+	m_glyphCount = 0;
+	m_version++;
+
+	return;
+}
+
+bool GlyphTableClass::SetGlyph(int id, const GlyphType &glyph)
+{
+	if (id < 0 || id >= GLYPH_TABLE_MAX_GLYPHS)
+		return false;
+
+	m_glyphs[id] = glyph;
+
+	if (id >= m_glyphCount)
+		m_glyphCount = id + 1;
+
+	m_version++;
+
+	return true;
+}
+
+const GlyphTableClass::GlyphType* GlyphTableClass::GetGlyphs()
+{
+	return m_glyphs;
+}
+
+int GlyphTableClass::GetGlyphCount()
+{
+	return m_glyphCount;
+}
+
+unsigned int GlyphTableClass::GetVersion()
+{
+	return m_version;
+}
+
+// The char may be signed, so the bytes past 127 are negative here and are rejected with the control characters.
+int GlyphTableClass::GetAsciiGlyph(char character)
+{
+	int letter = (int)character - 32;
+
+	if (letter < 0 || letter > 94)
+		return -1;
+
+	return letter;
+}
+
+// Rounds every channel to 8 bits, as UNORM reads it back: byte / 255.
+unsigned int GlyphTableClass::PackColor(float red, float green, float blue, float alpha)
+{
+	float		 channels[4] = { red, green, blue, alpha };
+	unsigned int color = 0;
+
+	for (int i = 0; i < 4; i++) {
+		float c = channels[i];
+
+		if (c < 0.0f) c = 0.0f;
+		if (c > 1.0f) c = 1.0f;
+
+		color |= (unsigned int)(c * 255.0f + 0.5f) << (8 * i);
+	}
+
+	return color;
+}
+
+void GlyphTableClass::GetQuadCorner(int vertex, float *x, float *y)
+{
+	*x = s_quadCorners[vertex][0];
+	*y = s_quadCorners[vertex][1];
+
+	return;
+}
+
+// The glyph id is clamped to the table like the shader does, so a bad id draws the last glyph instead of reading past the buffer.
+void GlyphTableClass::ExpandVertex(const GlyphType *glyphs, const InstanceType &instance, int vertex, ExpandedVertexType *output)
+{
+	unsigned int	 id = instance.glyph < GLYPH_TABLE_MAX_GLYPHS ? instance.glyph : GLYPH_TABLE_MAX_GLYPHS - 1;
+	const GlyphType &glyph = glyphs[id];
+	float			 cx = s_quadCorners[vertex][0];
+	float			 cy = s_quadCorners[vertex][1];
+
+	// The box goes right and down from the pen, the screen y goes up.
+	output->x = instance.x + glyph.left + cx * glyph.width;
+	output->y = instance.y - glyph.top  - cy * glyph.height;
+
+	output->u = glyph.u0 + cx * (glyph.u1 - glyph.u0);
+	output->v = glyph.v0 + cy * (glyph.v1 - glyph.v0);
+
+	output->r = ((instance.color	  ) & 0xff) / 255.0f;
+	output->g = ((instance.color >>  8) & 0xff) / 255.0f;
+	output->b = ((instance.color >> 16) & 0xff) / 255.0f;
+	output->a = ((instance.color >> 24) & 0xff) / 255.0f;
+
+	return;
+}
@@ -0,0 +1,76 @@
+// --------------------------------------------------------------------------------------------------------
+// GlyphTableClass holds what the instanced text needs to know about every glyph of a font: its box relative to the pen
+// and its rectangle in the font texture. The table is copied into a constant buffer of the FontShaderClass_Instancing,
+// so a letter is sent to the GPU as one 16 byte instance (pen position, glyph id and color)
+// instead of six vertices of 36 bytes, and the vertex shader expands a shared unit quad into the letter.
+//
+// ExpandVertex is the C++ twin of FontInstancingVertexShader in _shaderFontInstancing.vs, they must be kept in sync.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _GLYPHTABLECLASS_H_
+#define _GLYPHTABLECLASS_H_
+
+// The size of the glyph array in the constant buffer of _shaderFontInstancing.vs.
+#define GLYPH_TABLE_MAX_GLYPHS 256
+
+
+
+class GlyphTableClass {
+ public:
+	// The box is in pixels from the pen, y going down the screen; the texture rectangle is u0, v0 at the top left and u1, v1 at the bottom right.
+	// The layout is the one of the constant buffer: two float4 per glyph.
+	struct GlyphType {
+		float left, top, width, height;
+		float u0, v0, u1, v1;
+	};
+
+	// One letter of text. The position is the pen in screen pixels (y going up, as the vertices of the FontClass),
+	// the color is 8 bit RGBA with red in the lowest byte, read by the input assembler as DXGI_FORMAT_R8G8B8A8_UNORM.
+	struct InstanceType {
+		float		 x, y;
+		unsigned int glyph;
+		unsigned int color;
+	};
+
+	// What the vertex shader outputs for one corner of the quad, before the matrices.
+	struct ExpandedVertexType {
+		float x, y;
+		float u, v;
+		float r, g, b, a;
+	};
+
+ public:
+	GlyphTableClass();
+	GlyphTableClass(const GlyphTableClass &);
+   ~GlyphTableClass();
+
+	void Clear();
+
+	// SetGlyph fails for an id past GLYPH_TABLE_MAX_GLYPHS.
+	bool SetGlyph(int, const GlyphType &);
+	const GlyphType* GetGlyphs();
+	int  GetGlyphCount();
+
+	// The version goes up with every change, the shader uploads the table again when it sees a new one.
+	unsigned int GetVersion();
+
+	static unsigned int PackColor(float, float, float, float);
+
+	// GetAsciiGlyph is the glyph id of a character in the fonts of the printable ASCII range, the FontClass ones: 32..126 are the ids 0..94.
+	// Any other byte, a control character or a part of a UTF-8 sequence, has no glyph and gets -1.
+	static int GetAsciiGlyph(char);
+
+	// The six corners of the unit quad, in the order of the quads of the FontClass: two triangles, clockwise.
+	static void GetQuadCorner(int, float *, float *);
+
+	// ExpandVertex computes corner (0..5) of the quad of the instance, as the vertex shader does.
+	static void ExpandVertex(const GlyphType *, const InstanceType &, int, ExpandedVertexType *);
+
+ private:
+	GlyphType		m_glyphs[GLYPH_TABLE_MAX_GLYPHS];
+	int				m_glyphCount;
+	unsigned int	m_version;
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "__gpuTimerClass.h"
+
+GpuTimerClass::GpuTimerClass()
+{
+	m_deviceContext	  = 0;
+	m_frame			  = 0;
+	m_timing		  = false;
+	m_track			  = -1;
+	m_trackGeneration = -1;
+
+	ZeroMemory(m_frames, sizeof(m_frames));
+}
+
+GpuTimerClass::GpuTimerClass(const GpuTimerClass& other)
+{
+}
+
+GpuTimerClass::~GpuTimerClass()
+{
+}
+
+// Initialize makes all the queries of the frames in flight up front, the frames only issue them.
+bool GpuTimerClass::Initialize(ID3D11Device *device, ID3D11DeviceContext *deviceContext)
+{
+	D3D11_QUERY_DESC disjointDesc, timestampDesc;
+	HRESULT			 result;
+
+	m_deviceContext = deviceContext;
+
+	disjointDesc.Query		= D3D11_QUERY_TIMESTAMP_DISJOINT;
+	disjointDesc.MiscFlags	= 0;
+	timestampDesc.Query		= D3D11_QUERY_TIMESTAMP;
+	timestampDesc.MiscFlags = 0;
+
+	for (int i = 0; i < GPU_TIMER_FRAMES; i++) {
+		FrameType &frame = m_frames[i];
+
+		result = device->CreateQuery(&disjointDesc, &frame.disjoint);
+		if (FAILED(result))
+			return false;
+
+		result = device->CreateQuery(&timestampDesc, &frame.start);
+		if (FAILED(result))
+			return false;
+
+		for (int s = 0; s < GPU_TIMER_MAX_SCOPES; s++) {
+			result = device->CreateQuery(&timestampDesc, &frame.scopes[s].begin);
+			if (FAILED(result))
+				return false;
+
+			result = device->CreateQuery(&timestampDesc, &frame.scopes[s].end);
+			if (FAILED(result))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void GpuTimerClass::Shutdown()
+{
+	for (int i = 0; i < GPU_TIMER_FRAMES; i++) {
+		FrameType &frame = m_frames[i];
+
+		if (frame.disjoint) {
+			frame.disjoint->Release();
+			frame.disjoint = 0;
+		}
+
+		if (frame.start) {
+			frame.start->Release();
+			frame.start = 0;
+		}
+
+		for (int s = 0; s < GPU_TIMER_MAX_SCOPES; s++) {
+			if (frame.scopes[s].begin) {
+				frame.scopes[s].begin->Release();
+				frame.scopes[s].begin = 0;
+			}
+
+			if (frame.scopes[s].end) {
+				frame.scopes[s].end->Release();
+				frame.scopes[s].end = 0;
+			}
+		}
+	}
+
+	m_deviceContext = 0;
+
+	return;
+}
+
+// The slot of the frame is read first: it holds the frame GPU_TIMER_FRAMES frames back.
+void GpuTimerClass::BeginFrame()
+{
+	if (!TraceClass::IsEnabled())
+		return;
+
+	FrameType &frame = m_frames[m_frame % GPU_TIMER_FRAMES];
+
+	// The track is made again after a Shutdown of TraceClass, the old number is gone with its buffers
+	if (m_trackGeneration != TraceClass::GetGeneration()) {
+		m_track			  = TraceClass::CreateTrack("GPU");
+		m_trackGeneration = TraceClass::GetGeneration();
+	}
+
+	if (frame.pending)
+		Collect(frame, false);
+
+	m_deviceContext->Begin(frame.disjoint);
+	m_deviceContext->End(frame.start);
+
+	frame.cpuStart	 = TraceClass::GetTicks();
+	frame.scopeCount = 0;
+	m_timing		 = true;
+
+	return;
+}
+
+void GpuTimerClass::EndFrame()
+{
+	if (!m_timing)
+		return;
+
+	FrameType &frame = m_frames[m_frame % GPU_TIMER_FRAMES];
+
+	m_deviceContext->End(frame.disjoint);
+
+	frame.pending = true;
+	m_timing	  = false;
+	m_frame++;
+
+	return;
+}
+
+int GpuTimerClass::Begin(const char *name)
+{
+	if (!m_timing)
+		return -1;
+
+	FrameType &frame = m_frames[m_frame % GPU_TIMER_FRAMES];
+
+	if (frame.scopeCount == GPU_TIMER_MAX_SCOPES)
+		return -1;
+
+	ScopeType &scope = frame.scopes[frame.scopeCount];
+
+	scope.name	 = name;
+	scope.closed = false;
+	m_deviceContext->End(scope.begin);
+
+	return frame.scopeCount++;
+}
+
+void GpuTimerClass::End(int index)
+{
+	if (index < 0 || !m_timing)
+		return;
+
+	ScopeType &scope = m_frames[m_frame % GPU_TIMER_FRAMES].scopes[index];
+
+	m_deviceContext->End(scope.end);
+	scope.closed = true;
+
+	return;
+}
+
+// Flush reads the frames in flight from the oldest, waiting for the GPU.
+void GpuTimerClass::Flush()
+{
+	for (int i = 0; i < GPU_TIMER_FRAMES; i++) {
+		FrameType &frame = m_frames[(m_frame + i) % GPU_TIMER_FRAMES];
+
+		if (frame.pending)
+			Collect(frame, true);
+	}
+
+	return;
+}
+
+// Collect turns the timestamps of a frame into events: the GPU ticks from the start of the frame, in the ticks of the CPU clock.
+void GpuTimerClass::Collect(FrameType &frame, bool wait)
+{
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+	UINT64								start, begin, end;
+	HRESULT								result;
+	double								scale;
+
+	frame.pending = false;
+
+	do {
+		result = m_deviceContext->GetData(frame.disjoint, &disjoint, sizeof(disjoint), wait ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH);
+	} while (wait && result == S_FALSE);
+
+	if (result != S_OK || disjoint.Disjoint || !disjoint.Frequency)
+		return;
+
+	if (!GetTimestamp(frame.start, wait, &start))
+		return;
+
+	scale = (double)TraceClass::GetFrequency() / disjoint.Frequency;
+
+	for (int s = 0; s < frame.scopeCount; s++) {
+		const ScopeType &scope = frame.scopes[s];
+
+		if (!scope.closed || !GetTimestamp(scope.begin, wait, &begin) || !GetTimestamp(scope.end, wait, &end))
+			continue;
+
+		TraceClass::AddEvent(m_track, scope.name, frame.cpuStart + (long long)((begin - start) * scale),
+							 frame.cpuStart + (long long)((end - start) * scale));
+	}
+
+	return;
+}
+
+bool GpuTimerClass::GetTimestamp(ID3D11Query *query, bool wait, UINT64 *timestamp)
+{
+	HRESULT result;
+
+	do {
+		result = m_deviceContext->GetData(query, timestamp, sizeof(UINT64), wait ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH);
+	} while (wait && result == S_FALSE);
+
+	return result == S_OK;
+}
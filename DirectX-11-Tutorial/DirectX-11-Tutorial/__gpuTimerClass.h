@@ -0,0 +1,73 @@
+// --------------------------------------------------------------------------------------------------------
+// GpuTimerClass times pieces of the frame on the GPU with timestamp queries and writes them into the "GPU" track of TraceClass.
+// A frame is bracketed by BeginFrame and EndFrame, its pieces by Begin and End, which can nest.
+// While tracing is off every call tests one flag and returns, no query is issued.
+//
+// The GPU runs behind the CPU, so a frame is read GPU_TIMER_FRAMES frames later, when its slot is used again;
+// a frame whose queries are still not done then is dropped, and so is one the GPU clock was disjoint in
+// (its frequency changed or it was reset). Flush waits for the frames still in flight, before the trace stops.
+// The GPU times are placed on the timeline of the CPU from the time the frame began on the CPU: the clocks are not the same,
+// the pieces are right relative to each other and the frame starts when the CPU started it, not when the GPU got to it.
+//
+// The context is the one of d3dClass, it is not owned.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _GPUTIMERCLASS_H_
+#define _GPUTIMERCLASS_H_
+
+#include <d3d11.h>
+
+#include "__traceClass.h"
+
+#define GPU_TIMER_FRAMES	 4
+#define GPU_TIMER_MAX_SCOPES 32		// per frame
+
+
+
+class GpuTimerClass {
+ private:
+	struct ScopeType {
+		const char	*name;
+		ID3D11Query *begin, *end;
+		bool		 closed;		// a piece left open by an error is not read
+	};
+
+	struct FrameType {
+		ID3D11Query *disjoint;
+		ID3D11Query *start;			// the timestamp at BeginFrame
+		long long	 cpuStart;		// the TraceClass ticks at BeginFrame
+		ScopeType	 scopes[GPU_TIMER_MAX_SCOPES];
+		int			 scopeCount;
+		bool		 pending;		// issued and not read yet
+	};
+
+ public:
+	GpuTimerClass();
+	GpuTimerClass(const GpuTimerClass &);
+   ~GpuTimerClass();
+
+	bool Initialize(ID3D11Device *, ID3D11DeviceContext *);
+	void Shutdown();
+
+	void BeginFrame();
+	void EndFrame();
+
+	// Begin returns the piece that End closes, -1 when it is not timed.
+	int	 Begin(const char *);
+	void End(int);
+
+	void Flush();
+
+ private:
+	void Collect(FrameType &, bool);
+	bool GetTimestamp(ID3D11Query *, bool, UINT64 *);
+
+ private:
+	ID3D11DeviceContext *m_deviceContext;
+	FrameType			 m_frames[GPU_TIMER_FRAMES];
+	int					 m_frame;
+	bool				 m_timing;		// between BeginFrame and EndFrame of a traced frame
+	int					 m_track, m_trackGeneration;		// the "GPU" track of the generation of TraceClass it was made in
+};
+
+#endif
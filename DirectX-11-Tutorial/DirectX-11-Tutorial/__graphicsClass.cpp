@@ -1,12 +1,39 @@
 #include "__graphicsClass.h"
+#include "__shaderLoaderClass.h"
 #include "___Sprite.h"
 
+#include "D3Dcompiler.h"
+
 BitmapClass* Sprite::Bitmap = 0;
+unsigned int Sprite::Version = 0;
 #define NUM 5000					// Sprite Vector Size
+#define MAX_PARTICLES 1000000		// Particle Pool Size
+#define TILEMAP_SIZE  4096			// Tilemap Width and Height, in tiles
+#define ANIMATED_NUM  2000			// Number of Animated Sprites
+#define ANIMATED_BATCHES 8			// Sprite Passes of the Animated Sprites
+#define BITMAP_NUM    30000			// Number of Instanced Bitmaps
+
+// The sprite passes draw the particle instances with the input layout of the TextureShaderClass_Instancing
+static_assert(sizeof(ParticleSystemClass::InstanceType) == sizeof(BitmapClass_Instancing::InstanceType), "Particle instance must match the bitmap instance");
+
+// The states of TurnZBufferOff with TurnOnAlphaBlending, and of TurnZBufferOn with TurnOffAlphaBlending
+static const RenderBackendClass::StateDescType STATE_2D = { true,  false, false, true };
+static const RenderBackendClass::StateDescType STATE_3D = { false, true,  true,  true };
+
+// The constant buffer of the sprite passes takes the matrices transposed, like the shader classes write them
+static void SetSpriteMatrices(SpritePassClass::MatrixBufferType *matrices, const D3DXMATRIX &world, const D3DXMATRIX &view, const D3DXMATRIX &projection)
+{
+	D3DXMatrixTranspose((D3DXMATRIX*)&matrices->world,		&world);
+	D3DXMatrixTranspose((D3DXMATRIX*)&matrices->view,		&view);
+	D3DXMatrixTranspose((D3DXMATRIX*)&matrices->projection, &projection);
+}
 
 GraphicsClass::GraphicsClass()
 {
 	m_d3d			= 0;
+	m_backend		= 0;
+	m_state2D		= 0;
+	m_state3D		= 0;
 	m_Camera		= 0;
 	m_Model			= 0;
 	//m_ColorShader	= 0;
@@ -14,9 +41,32 @@ GraphicsClass::GraphicsClass()
 	m_TextureShaderIns = 0;
 	m_LightShader	= 0;
 	m_Light			= 0;
+	m_ClusteredLights = 0;
 	m_Bitmap		= 0;
 	m_BitmapIns		= 0;
+	m_BitmapPass	= 0;
+	m_bitmapTexture	= 0;
 	m_TextOut		= 0;
+	m_SpriteTexture = 0;
+	m_spriteVertexShader = 0;
+	m_spritePixelShader	 = 0;
+	m_spriteTexture		 = 0;
+	m_Particles		= 0;
+	m_ParticlePass	= 0;
+	m_particleEmitter = -1;
+	m_Tilemap		= 0;
+	m_Animator		= 0;
+	m_PassRecorder	= 0;
+	m_LayerCache	= 0;
+	m_HudTexture	= 0;
+	m_OrthoWindow	= 0;
+	m_hudLayer		= -1;
+	m_hudLayerTexture = 0;
+	m_FrameGraph	= 0;
+	m_DynamicFont	= 0;
+	m_FontShader	= 0;
+	m_PerfHud		= 0;
+	m_GpuTimer		= 0;
 }
 
 GraphicsClass::GraphicsClass(const GraphicsClass &other)
@@ -55,6 +105,34 @@ bool GraphicsClass::Initialize(int screenWidth, int screenHeight, HWND hwnd)
 		return false;
 	}
 
+	m_backend = m_d3d;
+
+	// The states of the passes that set their own
+	m_state2D = m_backend->CreateState(STATE_2D);
+	m_state3D = m_backend->CreateState(STATE_3D);
+
+	if (!m_state2D || !m_state3D)
+		return false;
+
+	// The passes of the frame are ordered and given their targets and states by the frame graph, see Render()
+	m_FrameGraph = new FrameGraphClass;
+	if (!m_FrameGraph)
+		return false;
+
+	if (!m_FrameGraph->Initialize(m_backend))
+		return false;
+
+	// The timestamp queries of the GPU timer only run while a trace is recorded
+	m_GpuTimer = new GpuTimerClass;
+	if (!m_GpuTimer)
+		return false;
+
+	result = m_GpuTimer->Initialize(m_d3d->GetDevice(), m_d3d->GetDeviceContext());
+	if (!result) {
+		MessageBox(hwnd, L"Could not initialize the GPU timer object.", L"Error", MB_OK);
+		return false;
+	}
+
 	// Create the camera object.
 	m_Camera = new CameraClass;
 	if (!m_Camera)
@@ -162,6 +240,40 @@ bool GraphicsClass::Initialize(int screenWidth, int screenHeight, HWND hwnd)
 		m_Light->SetSpecularColor(1.0f, 1.0f, 1.0f, 1.0f);
 		m_Light->SetSpecularPower(32.0f);
 	}
+
+	// --- The point and spot lights, shaded by the clustered variant of the light shader ---
+	{
+		D3DXMATRIX projection;
+
+		m_ClusteredLights = new ClusteredLightsClass;
+		if (!m_ClusteredLights)
+			return false;
+
+		result = m_ClusteredLights->Initialize(m_d3d->GetDevice(), POINT_LIGHTS, screenWidth, screenHeight);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the clustered lights object.", L"Error", MB_OK);
+			return false;
+		}
+
+		m_d3d->GetProjectionMatrix(projection);
+		m_ClusteredLights->SetProjection(projection, SCREEN_NEAR, SCREEN_DEPTH);
+
+		// Every fourth light is a spot light pointing at the model, the colors go around the hue circle.
+		m_pointLights.resize(POINT_LIGHTS);
+
+		for (int i = 0; i < POINT_LIGHTS; i++) {
+			ClusterLightType &light = m_pointLights[i];
+
+			light.range	   = 1.5f + (i % 7) * 0.25f;
+			light.color[0] = 0.5f + 0.5f * sin(i * 0.1f);
+			light.color[1] = 0.5f + 0.5f * sin(i * 0.1f + 2.1f);
+			light.color[2] = 0.5f + 0.5f * sin(i * 0.1f + 4.2f);
+			light.spotCos  = i % 4 == 0 ? 0.9f : -1.0f;
+			light.padding  = 0.0f;
+		}
+
+		m_LightShader->SetFeatures(SHADER_FEATURE_SPECULAR | SHADER_FEATURE_TEXTURE | SHADER_FEATURE_CLUSTERED_LIGHTS);
+	}
 #endif
 
 #if 1
@@ -243,6 +355,177 @@ bool GraphicsClass::Initialize(int screenWidth, int screenHeight, HWND hwnd)
 			m_spriteVec.push_back(spr);
 		}
 
+		m_spriteWorlds.resize(m_spriteVec.size());
+
+	}
+
+
+	// --- Particles ---
+	{
+		m_screenWidth  = screenWidth;
+		m_screenHeight = screenHeight;
+
+		m_Particles = new ParticleSystemClass;
+		if (!m_Particles)
+			return false;
+
+		result = m_Particles->Initialize(MAX_PARTICLES);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the particle system.", L"Error", MB_OK);
+			return false;
+		}
+
+		// The emitter follows the mouse cursor, see Render()
+		m_particleEmitter = m_Particles->AddEmitter(0.0f, 0.0f, 20000.0f);
+		m_Particles->SetEmitterVelocity(m_particleEmitter, 0.0f, 6.2831853f, 50.0f, 250.0f);
+		m_Particles->SetEmitterLifetime(m_particleEmitter, 1.0f, 3.0f);
+		m_Particles->SetEmitterSpin(m_particleEmitter, -3.0f, 3.0f);
+		m_Particles->SetGravity(0.0f, -98.0f);
+		m_Particles->SetDrag(0.5f);
+		m_Particles->SetColorCurve(1.0f, 0.9f, 0.5f, 1.0f,   1.0f, 0.2f, 0.0f, 0.0f);
+		m_Particles->SetSizeCurve(0.5f, 0.1f);
+
+		result = InitializeSprites();
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the sprite shaders.", L"Error", MB_OK);
+			return false;
+		}
+
+		// Each particle is the same 24x24 quad, scaled and tinted in the vertex shader.
+		// The instance buffer of the pass is created once and refilled every frame
+		m_ParticlePass = new SpritePassClass;
+		if (!m_ParticlePass)
+			return false;
+
+		result = m_ParticlePass->Initialize(m_backend, 24, m_Particles->GetCapacity(), m_spriteVertexShader, m_spritePixelShader, m_spriteTexture, m_state2D);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the particle pass.", L"Error", MB_OK);
+			return false;
+		}
+
+		m_particleInstances.resize(m_Particles->GetCapacity());
+	}
+
+
+	// --- Tilemap ---
+	{
+		m_Tilemap = new TilemapClass;
+		if (!m_Tilemap)
+			return false;
+
+		// pic5.png is used as a 2x2 atlas of 32x32 pixel tiles, drawn with the shaders of the sprite passes
+		result = m_Tilemap->Initialize(m_d3d, TILEMAP_SIZE, TILEMAP_SIZE, 32, L"../DirectX-11-Tutorial/data/pic5.png", 2, 2,
+									   m_spriteVertexShader, m_spritePixelShader, m_state2D);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the tilemap object.", L"Error", MB_OK);
+			return false;
+		}
+
+		// Fill the map with some pattern, leaving holes so that the empty tiles are skipped as well
+		for (int y = 0; y < TILEMAP_SIZE; y++)
+			for (int x = 0; x < TILEMAP_SIZE; x++)
+				if ((x ^ y) % 13)
+					m_Tilemap->SetTile(x, y, ((x / 7) ^ (y / 5)) & 3);
+	}
+
+
+	// --- Instanced Bitmap ---
+	{
+		// The quad of BitmapClass_Instancing is the 24x24 quad of a sprite pass, the instances are written by the bitmap every frame
+		m_bitmapTexture = m_d3d->ImportTexture(m_BitmapIns->GetTexture(), 0);
+		if (!m_bitmapTexture)
+			return false;
+
+		m_bitmapInstances.resize(BITMAP_NUM);
+
+		m_BitmapPass = new SpritePassClass;
+		if (!m_BitmapPass)
+			return false;
+
+		result = m_BitmapPass->Initialize(m_backend, 24, (int)m_bitmapInstances.size(), m_spriteVertexShader, m_spritePixelShader, m_bitmapTexture, m_state2D);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the bitmap pass.", L"Error", MB_OK);
+			return false;
+		}
+	}
+
+
+	// --- Animated Sprites ---
+	{
+		// pic5.png is used as a 2x2 sprite sheet
+		m_Animator = new SpriteAnimatorClass;
+		if (!m_Animator)
+			return false;
+
+		result = m_Animator->Initialize(ANIMATED_NUM, 2, 2);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the sprite animator.", L"Error", MB_OK);
+			return false;
+		}
+
+		int spin  = m_Animator->AddAnimation(0, 4, 8.0f, true);
+		int blink = m_Animator->AddAnimation(1, 2, 3.0f, true);
+
+		// The sprites are drawn in batches, a pass each. Every other batch takes its frames from the copy of pic5.png the bitmap loaded,
+		// so the batches come with their textures in turn, the way the objects of a scene do, and the draw queue groups them.
+		for (int i = 0; i < ANIMATED_BATCHES; i++) {
+
+			SpritePassClass *pass = new SpritePassClass;
+			if (!pass)
+				return false;
+
+			m_SpritePasses.push_back(pass);
+
+			result = pass->Initialize(m_backend, 24, ANIMATED_NUM / ANIMATED_BATCHES, m_spriteVertexShader, m_spritePixelShader,
+									  i % 2 ? m_bitmapTexture : m_spriteTexture, m_state2D);
+			if (!result) {
+				MessageBox(hwnd, L"Could not initialize the animated sprite pass.", L"Error", MB_OK);
+				return false;
+			}
+		}
+
+		// The sprites stand still in a grid along the bottom of the screen, only their frames change
+		m_animatedInstances.resize(ANIMATED_NUM);
+
+		for (int i = 0; i < ANIMATED_NUM; i++) {
+
+			int sprite = m_Animator->AddSprite(i % 3 ? spin : blink, (float)rand() / RAND_MAX);
+			m_Animator->SetSpriteSpeed(sprite, 0.5f + (float)rand() / RAND_MAX);
+
+			SpritePassClass::InstanceType &instance = m_animatedInstances[i];
+
+			instance.x		  = float(-screenWidth/2 + 6 + (i % 100) * 8);
+			instance.y		  = float(-screenHeight/2 + 6 + (i / 100) * 8);
+			instance.rotation = 0.0f;
+			instance.size	  = 0.33f;
+			instance.r		  = instance.g = instance.b = instance.a = 1.0f;
+		}
+	}
+
+
+	// --- Pass Recorder ---
+	{
+		// The scene and the particles are recorded on two threads, the calling one included
+		m_PassRecorder = new PassRecorderClass;
+		if (!m_PassRecorder)
+			return false;
+
+		result = m_PassRecorder->Initialize(m_backend, 2);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the pass recorder.", L"Error", MB_OK);
+			return false;
+		}
+
+		// The tilemap is not a pass of the scene: its instances are baked into immutable buffers, there is nothing to upload
+		m_spriteLayers[0].passes.push_back(m_BitmapPass);
+
+		for (size_t i = 0; i < m_SpritePasses.size(); i++)
+			m_spriteLayers[0].passes.push_back(m_SpritePasses[i]);
+
+		m_spriteLayers[1].passes.push_back(m_ParticlePass);
+
+		m_PassRecorder->AddPass(SpritePassClass::RecordLayer, &m_spriteLayers[0]);
+		m_PassRecorder->AddPass(SpritePassClass::RecordLayer, &m_spriteLayers[1]);
 	}
 
 
@@ -286,6 +569,77 @@ bool GraphicsClass::Initialize(int screenWidth, int screenHeight, HWND hwnd)
 			MessageBox(hwnd, L"Could not initialize the text object.", L"Error", MB_OK);
 			return false;
 		}	
+
+		// The dynamic font takes its glyphs from a TrueType file instead of a prebaked texture, so it can draw any Unicode text in any size.
+		// Its glyphs are distance fields, so all the sizes come from one small atlas
+		m_FontShader = new FontShaderClass;
+		if (!m_FontShader)
+			return false;
+
+		result = m_FontShader->Initialize(m_d3d->GetDevice(), hwnd);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the font shader object.", L"Error", MB_OK);
+			return false;
+		}
+
+		m_DynamicFont = new DynamicFontClass;
+		if (!m_DynamicFont)
+			return false;
+
+		result = m_DynamicFont->Initialize(m_d3d->GetDevice(), hwnd, L"C:/Windows/Fonts/arial.ttf", L"Arial", screenWidth, screenHeight, baseViewMatrix, 256, true);
+		if (!result)
+			return false;
+
+		// The performance HUD has its own font objects, so it can be drawn over everything with one call
+		m_PerfHud = new PerfHudClass;
+		if (!m_PerfHud)
+			return false;
+
+		result = m_PerfHud->Initialize(m_d3d->GetDevice(), hwnd, screenWidth, screenHeight, baseViewMatrix);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the performance HUD object.", L"Error", MB_OK);
+			return false;
+		}
+	}
+
+
+	// --- Layer Cache ---
+	{
+		// The text is drawn into its own screen-sized layer, which is redrawn only when a sentence changes
+		m_HudTexture = new RenderTextureClass;
+		if (!m_HudTexture)
+			return false;
+
+		result = m_HudTexture->Initialize(m_d3d, screenWidth, screenHeight);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the render texture object.", L"Error", MB_OK);
+			return false;
+		}
+
+		m_OrthoWindow = new OrthoWindowClass;
+		if (!m_OrthoWindow)
+			return false;
+
+		result = m_OrthoWindow->Initialize(m_d3d->GetDevice(), screenWidth, screenHeight);
+		if (!result) {
+			MessageBox(hwnd, L"Could not initialize the ortho window object.", L"Error", MB_OK);
+			return false;
+		}
+
+		m_LayerCache = new LayerCacheClass;
+		if (!m_LayerCache)
+			return false;
+
+		m_hudLayer = m_LayerCache->AddLayer(m_HudTexture);
+		m_LayerCache->WatchVersion(m_hudLayer, m_TextOut->GetVersionCounter());
+
+		// The layer is redrawn as well when new glyphs of the dynamic font arrive from its worker thread
+		m_LayerCache->WatchVersion(m_hudLayer, m_DynamicFont->GetVersionCounter());
+
+		// The layer is a texture of the frame graph too, the text pass draws into it and the HUD pass reads it
+		m_hudLayerTexture = m_d3d->ImportTexture(m_HudTexture->GetShaderResourceView(), m_HudTexture->GetRenderTargetView());
+		if (!m_hudLayerTexture)
+			return false;
 	}
 
 
@@ -321,6 +675,45 @@ void GraphicsClass::Shutdown()
 		}
 	}
 
+	// Release the layer cache.
+	if (m_LayerCache) {
+		m_LayerCache->Shutdown();
+		delete m_LayerCache;
+		m_LayerCache = 0;
+	}
+
+	if (m_HudTexture) {
+		m_HudTexture->Shutdown();
+		delete m_HudTexture;
+		m_HudTexture = 0;
+	}
+
+	if (m_OrthoWindow) {
+		m_OrthoWindow->Shutdown();
+		delete m_OrthoWindow;
+		m_OrthoWindow = 0;
+	}
+
+	// Release the performance HUD.
+	if (m_PerfHud) {
+		m_PerfHud->Shutdown();
+		delete m_PerfHud;
+		m_PerfHud = 0;
+	}
+
+	// Release the dynamic font and its shader.
+	if (m_DynamicFont) {
+		m_DynamicFont->Shutdown();
+		delete m_DynamicFont;
+		m_DynamicFont = 0;
+	}
+
+	if (m_FontShader) {
+		m_FontShader->Shutdown();
+		delete m_FontShader;
+		m_FontShader = 0;
+	}
+
 	// Release the text object.
 	if(m_TextOut) {
 		m_TextOut->Shutdown();
@@ -342,6 +735,89 @@ void GraphicsClass::Shutdown()
 		m_BitmapIns = 0;
 	}
 
+	// Release the tilemap object.
+	if (m_Tilemap) {
+		m_Tilemap->Shutdown();
+		delete m_Tilemap;
+		m_Tilemap = 0;
+	}
+
+	// Release the pass recorder before the passes it records.
+	if (m_PassRecorder) {
+		m_PassRecorder->Shutdown();
+		delete m_PassRecorder;
+		m_PassRecorder = 0;
+	}
+
+	m_spriteLayers[0].passes.clear();
+	m_spriteLayers[1].passes.clear();
+
+	// Release the animated sprites.
+	if (m_Animator) {
+		m_Animator->Shutdown();
+		delete m_Animator;
+		m_Animator = 0;
+	}
+
+	for (size_t i = 0; i < m_SpritePasses.size(); i++) {
+		m_SpritePasses[i]->Shutdown();
+		delete m_SpritePasses[i];
+	}
+	m_SpritePasses.clear();
+
+	// Release the bitmap pass.
+	if (m_BitmapPass) {
+		m_BitmapPass->Shutdown();
+		delete m_BitmapPass;
+		m_BitmapPass = 0;
+	}
+
+	// Release the particle system.
+	if (m_Particles) {
+		m_Particles->Shutdown();
+		delete m_Particles;
+		m_Particles = 0;
+	}
+
+	// Release the particle pass.
+	if (m_ParticlePass) {
+		m_ParticlePass->Shutdown();
+		delete m_ParticlePass;
+		m_ParticlePass = 0;
+	}
+
+	// Release the frame graph, with the textures and the states it made.
+	if (m_FrameGraph) {
+		m_FrameGraph->Shutdown();
+		delete m_FrameGraph;
+		m_FrameGraph = 0;
+	}
+
+	// Release the objects the sprite passes shared, the layer of the frame graph and the states.
+	if (m_backend) {
+		m_backend->Release(m_hudLayerTexture);
+		m_backend->Release(m_bitmapTexture);
+		m_backend->Release(m_spriteTexture);
+		m_backend->Release(m_spritePixelShader);
+		m_backend->Release(m_spriteVertexShader);
+		m_backend->Release(m_state3D);
+		m_backend->Release(m_state2D);
+
+		m_hudLayerTexture	 = 0;
+		m_bitmapTexture		 = 0;
+		m_spriteTexture		 = 0;
+		m_spritePixelShader	 = 0;
+		m_spriteVertexShader = 0;
+		m_state3D			 = 0;
+		m_state2D			 = 0;
+	}
+
+	if (m_SpriteTexture) {
+		m_SpriteTexture->Shutdown();
+		delete m_SpriteTexture;
+		m_SpriteTexture = 0;
+	}
+
 	// Release the bitmap object.
 	if (m_BitmapSprite) {
 		m_BitmapSprite->Shutdown();
@@ -382,6 +858,12 @@ void GraphicsClass::Shutdown()
 #endif
 
 #if 1
+	if (m_ClusteredLights) {
+		m_ClusteredLights->Shutdown();
+		delete m_ClusteredLights;
+		m_ClusteredLights = 0;
+	}
+
 	// Release the light object.
 	if (m_Light) {
 		delete m_Light;
@@ -409,36 +891,124 @@ void GraphicsClass::Shutdown()
 		m_Camera = 0;
 	}
 
+	// Release the GPU timer before the device it made its queries with.
+	if (m_GpuTimer) {
+		m_GpuTimer->Shutdown();
+		delete m_GpuTimer;
+		m_GpuTimer = 0;
+	}
+
 	if( m_d3d ) {
 		m_d3d->Shutdown();
 		delete m_d3d;
 		m_d3d = 0;
 	}
 
+	m_backend = 0;
+
 	return;
 }
 
+// The sprites are drawn through the backend with the shaders of TextureShaderClass_Instancing, which the shader cache already holds,
+// and the texture they all share, pic5.png used as a 2x2 sprite sheet.
+bool GraphicsClass::InitializeSprites()
+{
+	WCHAR		 vsFilename[]  = L"../DirectX-11-Tutorial/_shaderTextureInstancing.vs";
+	WCHAR		 psFilename[]  = L"../DirectX-11-Tutorial/_shaderTextureInstancing.ps";
+	WCHAR		 texFilename[] = L"../DirectX-11-Tutorial/data/pic5.png";
+	ID3D10Blob	*vertexShaderBuffer = 0;
+	ID3D10Blob	*pixelShaderBuffer	= 0;
+	ID3D10Blob	*errorMessage		= 0;
+	bool		 result;
+
+	m_SpriteTexture = new TextureClass;
+	if (!m_SpriteTexture)
+		return false;
+
+	if (!m_SpriteTexture->Initialize(m_d3d->GetDevice(), texFilename))
+		return false;
+
+	m_spriteTexture = m_d3d->ImportTexture(m_SpriteTexture->GetTexture(), 0);
+	if (!m_spriteTexture)
+		return false;
+
+	if (FAILED(ShaderLoaderClass::CompileFromFile(vsFilename, "TextureVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, &vertexShaderBuffer, &errorMessage)) ||
+		FAILED(ShaderLoaderClass::CompileFromFile(psFilename, "TexturePixelShader",	 "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, &pixelShaderBuffer,	&errorMessage))) {
+
+		if (errorMessage)
+			errorMessage->Release();
+
+		if (vertexShaderBuffer)
+			vertexShaderBuffer->Release();
+
+		return false;
+	}
+
+	result = SpritePassClass::CreateShaders(m_backend, vertexShaderBuffer->GetBufferPointer(), (int)vertexShaderBuffer->GetBufferSize(),
+											pixelShaderBuffer->GetBufferPointer(), (int)pixelShaderBuffer->GetBufferSize(),
+											&m_spriteVertexShader, &m_spritePixelShader);
+
+	vertexShaderBuffer->Release();
+	pixelShaderBuffer->Release();
+
+	return result;
+}
+
 bool GraphicsClass::Frame(const int &fps, const int &cpu, const float &frameTime)
 {
-	bool result;
+	TraceScopeClass scope("GraphicsClass::Frame");
+	bool			result;
+
+	m_PerfHud->Begin(PERF_TEXT);
+
+	// The text counters tell how many sentence uploads this frame did and how many were skipped as nothing changed
+	m_TextOut->ResetCounters();
 
 	// Set the frames per second
-	result = m_TextOut->SetFps(fps, m_d3d->GetDeviceContext());
+	result = m_TextOut->SetFps(fps);
 	if (!result)
 		return false;
 
 	// Set the cpu usage
-	result = m_TextOut->SetCpu(cpu, m_d3d->GetDeviceContext());
+	result = m_TextOut->SetCpu(cpu);
 	if (!result)
 		return false;
 
+	// Pack the glyphs rasterized since the last frame and upload them into the atlas textures
+	result = m_DynamicFont->Frame(m_d3d->GetDeviceContext());
+	if (!result)
+		return false;
+
+	m_PerfHud->End(PERF_TEXT);
+	m_PerfHud->Begin(PERF_ANIMATION);
+
+	// Advance the particle simulation, frameTime is in milliseconds
+	m_Particles->Frame(frameTime * 0.001f);
+
+	// Advance the flipbook animations
+	m_Animator->Frame(frameTime * 0.001f);
+
+	m_PerfHud->End(PERF_ANIMATION);
+
 	return true;
 }
 
+PerfHudClass* GraphicsClass::GetPerfHud()
+{
+	return m_PerfHud;
+}
+
+GpuTimerClass* GraphicsClass::GetGpuTimer()
+{
+	return m_GpuTimer;
+}
+
 bool GraphicsClass::Render(const float &rotation, const float &zoom, const int &mouseX, const int &mouseY)
 {
-	bool		 result;
-	D3DXMATRIX	 viewMatrix, projectionMatrix, worldMatrixX, worldMatrixY, worldMatrixZ, orthoMatrix;
+	TraceScopeClass scope("GraphicsClass::Render");
+	float			clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	int				gpuFrame;
+	int				pass, hudLayer;
 
 	if (true) {
 		//m_Camera->SetPosition(0.0f, 0.0f, -20.0f + 15 * sin(10 * zoom));
@@ -447,18 +1017,130 @@ bool GraphicsClass::Render(const float &rotation, const float &zoom, const int &
 		m_Camera->SetPosition(0.0f, 0.0f, -10.0f + 0.005*zoom);
 	}
 
+	// The GPU time of the frame includes the clears
+	m_GpuTimer->BeginFrame();
+	gpuFrame = m_GpuTimer->Begin("Frame");
+
 	// Clear the buffers to begin the scene.
-	m_d3d->BeginScene(0.0f, 0.0f, 0.0f, 1.0f);
+	m_backend->BeginFrame(clearColor);
 
 	// Generate the view matrix based on the camera's position.
 	m_Camera->Render();
 
-	// Get the world, view, and projection matrices from the camera and d3d objects.
-	m_Camera->GetViewMatrix(viewMatrix);
+	// The view, projection and ortho matrices and the input of the frame, for the passes.
+	m_Camera->GetViewMatrix(m_frame.view);
+	m_d3d->GetProjectionMatrix(m_frame.projection);
+	m_d3d->GetOrthoMatrix(m_frame.ortho);
+
+	m_frame.rotation = rotation;
+	m_frame.zoom	 = zoom;
+	m_frame.mouseX	 = mouseX;
+	m_frame.mouseY	 = mouseY;
+	m_frame.result	 = true;
+
+	m_LayerCache->ResetCounters();
+
+	// --- Frame Graph ---
+	// The passes are declared in the order they are drawn in; the ones that draw into the back buffer keep it,
+	// and the text goes into the layer before the layer is composited.
+	m_FrameGraph->Reset();
+	hudLayer = m_FrameGraph->ImportTexture(m_hudLayerTexture, false);
+
+	m_FrameGraph->AddPass("2D", Render2DPass, this, STATE_2D);
+
+	// The text is only drawn into the layer when a sentence has changed since the last time
+	if (m_LayerCache->IsDirty(m_hudLayer)) {
+		pass = m_FrameGraph->AddPass("Text", RenderTextPass, this, STATE_2D);
+		m_FrameGraph->Write(pass, hudLayer);
+	}
+
+	pass = m_FrameGraph->AddPass("HUD Layer", RenderHudPass, this, STATE_2D);
+	m_FrameGraph->Read(pass, hudLayer);
+
+	m_FrameGraph->AddPass("3D", Render3DPass, this, STATE_3D);
+
+	// Drawn last, over the 3D scene. When it is hidden it costs nothing here
+	if (m_PerfHud->IsEnabled())
+		m_FrameGraph->AddPass("Performance HUD", RenderPerfHudPass, this, STATE_2D);
+
+	if (!m_FrameGraph->Compile())
+		return false;
+
+	m_FrameGraph->Execute();
+
+	// The state calls of this frame, as the filter in front of the device context counted them
+	m_PerfHud->GetStats()->SetStateCalls(m_d3d->GetFilteredContext()->GetForwardedCount(), m_d3d->GetFilteredContext()->GetFilteredCount());
+	m_d3d->GetFilteredContext()->ResetCounters();
+
+	m_GpuTimer->End(gpuFrame);
+	m_GpuTimer->EndFrame();
+
+	// Present the rendered scene to the screen.
+	m_backend->EndFrame();
+
+	return m_frame.result;
+}
+
+// The passes of the frame graph: a pass that fails fails the frame, the ones after it still run.
+void GraphicsClass::Render2DPass(RenderContextClass *context, void *data)
+{
+	GraphicsClass *graphics = (GraphicsClass*)data;
+
+	graphics->RunPass(&GraphicsClass::Render2D, PERF_2D, "2D");
+}
+
+void GraphicsClass::RenderTextPass(RenderContextClass *context, void *data)
+{
+	GraphicsClass *graphics = (GraphicsClass*)data;
+
+	graphics->RunPass(&GraphicsClass::RenderText, PERF_TEXT, "Text");
+}
+
+void GraphicsClass::RenderHudPass(RenderContextClass *context, void *data)
+{
+	GraphicsClass *graphics = (GraphicsClass*)data;
+
+	graphics->RunPass(&GraphicsClass::RenderHud, PERF_TEXT, "HUD Layer");
+}
+
+void GraphicsClass::Render3DPass(RenderContextClass *context, void *data)
+{
+	GraphicsClass *graphics = (GraphicsClass*)data;
+
+	graphics->RunPass(&GraphicsClass::Render3D, PERF_3D, "3D");
+}
+
+void GraphicsClass::RenderPerfHudPass(RenderContextClass *context, void *data)
+{
+	GraphicsClass *graphics = (GraphicsClass*)data;
+
+	graphics->m_frame.result = graphics->RenderPerfHud() && graphics->m_frame.result;
+}
+
+void GraphicsClass::RunPass(bool (GraphicsClass::*render)(), int perfPart, const char *gpuName)
+{
+	int gpuPart;
+
+	m_PerfHud->Begin(perfPart);
+	gpuPart = m_GpuTimer->Begin(gpuName);
+
+	m_frame.result = (this->*render)() && m_frame.result;
+
+	m_GpuTimer->End(gpuPart);
+	m_PerfHud->End(perfPart);
+}
+
+bool GraphicsClass::Render2D()
+{
+	bool		result;
+	D3DXMATRIX	viewMatrix = m_frame.view, orthoMatrix = m_frame.ortho, worldMatrixX, worldMatrixY, worldMatrixZ;
+	float		rotation = m_frame.rotation, zoom = m_frame.zoom;
+	int			mouseX = m_frame.mouseX, mouseY = m_frame.mouseY;
+	SpritePassClass::MatrixBufferType spriteMatrices;
+
 	m_d3d->GetWorldMatrix(worldMatrixX);
 	m_d3d->GetWorldMatrix(worldMatrixY);
 	m_d3d->GetWorldMatrix(worldMatrixZ);
-	m_d3d->GetProjectionMatrix(projectionMatrix);
 
 	// --- 2d Rendering ---
 	//     ,             (  ),
@@ -476,321 +1158,374 @@ bool GraphicsClass::Render(const float &rotation, const float &zoom, const int &
 	// new instancing
 	if(true)
 	{
-		m_d3d->TurnOnAlphaBlending();
-		m_d3d->GetOrthoMatrix(orthoMatrix);
-
+		// The graph has set the back buffer and the 2D state, alpha blending on and the Z buffer off
 		D3DXMATRIX matScale;
 		D3DXMATRIX matTrans;
 		m_d3d->GetWorldMatrix(matTrans);
 		m_d3d->GetWorldMatrix(matScale);
 
-		m_d3d->TurnZBufferOff();
-
 		//    
 		int xCenter = 800 / 2;
 		int yCenter = 600 / 2;
 
-		if (!m_BitmapIns->initializeInstances(m_d3d->GetDevice()))
-			return false;
+		// The draws of the scene are added to its layer as the scene is walked: the tilemap chunks, the bitmap and the batches of the animated sprites.
+		// Their keys put the tilemap at the back and the sprites in front, the sort keeps that order and groups the draws of a texture
+		// within it. The batches of the sprites don't overlap, so the order they are drawn in doesn't show.
+		SpritePassClass::LayerType &scene = m_spriteLayers[0];
 
-		//     !!!
-		if (!m_BitmapIns->Render(m_d3d->GetDeviceContext(), 400-12, 300-12))
-			return false;
+		scene.queue.Reset();
+		m_spriteLayers[1].queue.Reset();
 
-		D3DXMatrixRotationZ(&worldMatrixZ, rotation / 5);
-		D3DXMatrixTranslation(&matTrans, 100.0f, 100.0f, 0.0f);
-		D3DXMatrixScaling(&matScale, 0.5f + 0.3*sin(rotation/5) + 0.0001*zoom, 0.5f + 0.3*sin(rotation/5) + 0.0001*zoom, 1.0f);
+		// --- Tilemap ---
+		{
+			// Scroll slowly across the map, only the chunks under the screen are baked and drawn
+			int mapPixels = TILEMAP_SIZE * m_Tilemap->GetTileSize();
+			int viewLeft  = int((mapPixels - m_screenWidth)  * (0.5f + 0.45f * sin(rotation / 200)));
+			int viewTop	  = int((mapPixels - m_screenHeight) * (0.5f + 0.45f * cos(rotation / 300)));
 
-		// The Render function for the shader now requires the vertex and instance count from the model object.
-		// Render the model using the texture shader.
-		result = m_TextureShaderIns->Render(m_d3d->GetDeviceContext(),
-						m_BitmapIns->GetVertexCount(), m_BitmapIns->GetInstanceCount(),
-						worldMatrixZ * matTrans * matScale,
-						viewMatrix, orthoMatrix, m_BitmapIns->GetTexture());
+			unsigned long long key = DrawQueueClass::MakeKey(0, true, m_spriteVertexShader, m_Tilemap->GetTexture(), 1.0f);
 
-		if (!result)
-			return false;
+			result = m_Tilemap->AddDraws(&scene.queue, key, viewMatrix, orthoMatrix, viewLeft, viewTop, m_screenWidth, m_screenHeight);
+			if (!result)
+				return false;
+		}
 
-		result = m_TextOut->Render(m_d3d->GetDeviceContext(), worldMatrixX, orthoMatrix);
-		if (!result)
-			return false;
+		// --- Instanced Bitmap ---
+		{
+			//     !!!
+			// The instances are offsets from the quad in the center, the pass draws them with the bitmap's world matrix
+			m_BitmapIns->BuildInstances((BitmapClass_Instancing::InstanceType*)&m_bitmapInstances[0], (int)m_bitmapInstances.size());
 
-		m_d3d->TurnOffAlphaBlending();
+			D3DXMatrixRotationZ(&worldMatrixZ, rotation / 5);
+			D3DXMatrixTranslation(&matTrans, 100.0f, 100.0f, 0.0f);
+			D3DXMatrixScaling(&matScale, 0.5f + 0.3*sin(rotation/5) + 0.0001*zoom, 0.5f + 0.3*sin(rotation/5) + 0.0001*zoom, 1.0f);
 
-		m_d3d->TurnZBufferOn();
-	}
+			SetSpriteMatrices(&spriteMatrices, worldMatrixZ * matTrans * matScale, viewMatrix, orthoMatrix);
 
+			m_BitmapPass->SetInstances(&m_bitmapInstances[0], (int)m_bitmapInstances.size());
+			m_BitmapPass->SetMatrices(spriteMatrices);
+			m_BitmapPass->AddDraw(&scene.queue, DrawQueueClass::MakeKey(0, true, m_spriteVertexShader, m_bitmapTexture, 0.5f));
+		}
 
+		// --- Particles ---
+		{
+			// Move the emitter to the mouse cursor. Instance positions are offsets from the center of the screen, with Y pointing up.
+			m_Particles->SetEmitterPosition(m_particleEmitter, float(mouseX - m_screenWidth/2), float(m_screenHeight/2 - mouseY));
 
+			// The quad of the pass is centered on the origin, so the instance offsets are applied around the center of the screen
+			int particleCount = m_Particles->BuildInstanceArray(&m_particleInstances[0], (int)m_particleInstances.size());
 
-	if(false)
-	{
-		//      ,   
-		// ,         ,     
-		m_d3d->TurnOnAlphaBlending();
+			m_d3d->GetWorldMatrix(worldMatrixY);
+			SetSpriteMatrices(&spriteMatrices, worldMatrixY, viewMatrix, orthoMatrix);
 
-		// We now also get the ortho matrix from the D3DClass for 2D rendering. We will pass this in instead of the projection matrix.
-		m_d3d->GetOrthoMatrix(orthoMatrix);
+			m_ParticlePass->SetInstances(&m_particleInstances[0], particleCount);
+			m_ParticlePass->SetMatrices(spriteMatrices);
+			m_ParticlePass->AddDraw(&m_spriteLayers[1].queue, DrawQueueClass::MakeKey(0, true, m_spriteVertexShader, m_spriteTexture, 0.0f));
+		}
 
-		//        
-		D3DXMATRIX matScale;
-		D3DXMATRIX matTrans;
-		m_d3d->GetWorldMatrix(matTrans);
-		m_d3d->GetWorldMatrix(matScale);
+		// --- Animated Sprites ---
+		{
+			// The animator writes the texture rectangles straight into the u, v, width and height of every instance
+			m_Animator->BuildUVArray(&m_animatedInstances[0].u, sizeof(SpritePassClass::InstanceType));
 
-		// The Z buffer is turned off before we do any 2D rendering.
-		m_d3d->TurnZBufferOff();
+			int batchSize = ANIMATED_NUM / ANIMATED_BATCHES;
 
+			for (size_t i = 0; i < m_SpritePasses.size(); i++) {
 
-		//   
-		int xCenter = 800/2;
-		int yCenter = 600/2;
+				unsigned long long key = DrawQueueClass::MakeKey(0, true, m_spriteVertexShader, m_SpritePasses[i]->GetTexture(), 0.0f);
 
-		//    
-		if (!m_Bitmap->Render(m_d3d->GetDeviceContext(), xCenter - 128, yCenter - 128))
-			return false;
+				m_SpritePasses[i]->SetInstances(&m_animatedInstances[i * batchSize], batchSize);
+				m_SpritePasses[i]->SetMatrices(spriteMatrices);
+				m_SpritePasses[i]->AddDraw(&scene.queue, key);
+			}
+		}
 
-		//    
-		D3DXMatrixRotationZ(&worldMatrixZ, rotation / 5);
-		D3DXMatrixTranslation(&matTrans, 100.0f, 100.0f, 0.0f);
-		D3DXMatrixScaling(&matScale, 0.5f + 0.03*sin(rotation) + 0.0001*zoom, 0.5f + 0.03*sin(rotation) + 0.0001*zoom, 1.0f);
+		scene.queue.Sort();
+		m_spriteLayers[1].queue.Sort();
 
+		// Both layers are recorded at once and executed in the order they were added, the particles over the scene.
+		// The command lists leave the state cleared, the 2D state the graph set is put back
+		m_PassRecorder->Record();
+		m_backend->SetState(m_state2D);
 
-		// Once the vertex / index buffers are prepared we draw them using the texture shader.
-		// Notice we send in the orthoMatrix instead of the projectionMatrix for rendering 2D.
-		// Due note also that if your view matrix is changing you will need to create a default one for 2D rendering and use it instead of the regular view matrix.
-		// In this tutorial using the regular view matrix is fine as the camera in this tutorial is stationary.
+		// The ring is drawn through the device context, over the layers
+		// --- Sprite Ring ---
+		{
+			//        
+			xCenter = 600;
+			yCenter = 450;
 
-		//      
-		if ( !m_TextureShader->Render(m_d3d->GetDeviceContext(), m_Bitmap->GetIndexCount(),
-										worldMatrixZ
-										* matTrans
-										* matScale
-										,
-										viewMatrix, orthoMatrix, m_Bitmap->GetTexture()) )
-			return false;
+			if (!m_spriteVec.size() || !m_spriteVec[0]->Render(m_d3d->GetDeviceContext(), xCenter - 24, yCenter - 24))
+				return false;
 
-		//  
-		if (!m_Cursor->Render(m_d3d->GetDeviceContext(), mouseX, mouseY))
-			return false;
+			ID3D11DeviceContext		 *device   = m_d3d->GetDeviceContext();
+			ID3D11ShaderResourceView *texture  = m_spriteVec[0]->getTexture();
+			int						  indexCnt = m_spriteVec[0]->getIndexCount();
+			int x, y;
 
-		m_d3d->GetWorldMatrix(worldMatrixX);
-		result = m_TextureShader->Render(m_d3d->GetDeviceContext(), m_Cursor->GetIndexCount(), worldMatrixX, viewMatrix, orthoMatrix, m_Cursor->GetTexture());
-		if (!result)
-			return false;
+			static int selector;
+			static float frameCount = 1001.0f;
+			frameCount++;
 
-		// render bitmaps from vector
+			if( frameCount > 1000 ) {
+				frameCount = 0.0f;
+				selector = (float)rand() / (RAND_MAX + 1) * 20;
+			}
 
+			for (int i = 0; i < m_spriteVec.size(); i++) {
 
-#if 1
-		// test-fast-render
+				m_spriteVec[i]->getCoords(x, y);
 
-		//        
-		xCenter = 600;
-		yCenter = 450;
+				switch( selector ) {
+			
+					case 0:
+						//  
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.5*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.0005*sin(rotation*i/5000) + 0.05*zoom, 1.0f);
+						break;
+
+					case 1:
+						//  
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.25*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.0005*sin(rotation*i/5000) + 0.05*zoom, 1.0f);
+						break;
+
+					case 2:
+						//  ,     
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 1.0f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 3:
+						// Opera
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.0005*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 4:
+						// Big Opera
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 5:
+						// Big ROUND Opera
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 6:
+						// Big SQUARE Opera
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.1*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 7:
+						// Moebeus DNA 1
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + sin(i) * 0.03*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + sin(i) * 0.03*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 8:
+						// square MOBEUS DNA 2
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + sin(i) * 0.05*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + cos(i) * 0.05*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 9:
+						// round pulsing jaws of atan
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + sin(i) * 0.05*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 2*sin(rotation*0.5)*atan(i) * 0.05*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 10:
+						// majic ninja mask
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + sin(i) * 0.05*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 5*sin(rotation*0.5)* 0.05*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 11:
+						// rotating circles 1
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.75*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.751*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 12:
+						// rotating wheel of crawling bugs
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.101*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 13:
+						// circle of changing phases 1
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/3000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 14:
+						// circle of SLOW changing phases 2
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/50000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/25000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 15:
+						// circle of SLOW changing phases 3 - eye of the Dragon
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.35*sin(rotation*i/50000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/25000) + 0.0005*zoom, 1.0f);
+						break;
+
+					case 16:
+
+						break;
+
+					default:
+						D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
+						//D3DXMatrixTranslation(&matTrans, x * cos(rotation/100 + .002*i) - 400.0f, y - 300.0f, 0.0f);
+						//D3DXMatrixScaling(&matScale, 1.0f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
+						D3DXMatrixScaling(&matScale, 0.5f + 0.35*sin(rotation*i/10000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/15000) + 0.0005*zoom, 1.0f);
+				}
+
+				// **********************************************************************************************************************************
+
+				m_spriteWorlds[i] = worldMatrixZ * matScale * matTrans;
+			}
 
-		if (!m_spriteVec.size() || !m_spriteVec[0]->Render(m_d3d->GetDeviceContext(), xCenter - 24, yCenter - 24))
-			return false;
+			// All the sprites share the buffers of the first one: their world matrices go into one structured buffer and they are drawn with one call,
+			// instead of one constant buffer upload and one draw per sprite.
+			if (!m_TextureShader->RenderObjects(device, indexCnt, &m_spriteWorlds[0], (int)m_spriteVec.size(), viewMatrix, orthoMatrix, texture))
+				return false;
+		}
+	}
 
-		ID3D11DeviceContext		 *device   = m_d3d->GetDeviceContext();
-		ID3D11ShaderResourceView *texture  = m_spriteVec[0]->getTexture();
-		int						  indexCnt = m_spriteVec[0]->getIndexCount();
-		int x, y;
+	return true;
+}
 
-		static int selector;
-		static float frameCount = 1001.0f;
-		frameCount++;
+// The text of the HUD, drawn into the layer the graph has made the target
+bool GraphicsClass::RenderText()
+{
+	bool		result;
+	D3DXMATRIX	worldMatrixX, orthoMatrix = m_frame.ortho;
 
-		if( frameCount > 1000 ) {
-			frameCount = 0.0f;
-			selector = (float)rand() / (RAND_MAX + 1) * 20;
-		}
+	m_d3d->GetWorldMatrix(worldMatrixX);
 
-		for (int i = 0; i < m_spriteVec.size(); i++) {
+	if (!m_LayerCache->BeginLayer(m_hudLayer))
+		return false;
 
-			m_spriteVec[i]->getCoords(x, y);
+	result = m_TextOut->Render(m_d3d->GetDeviceContext(), worldMatrixX, orthoMatrix);
 
-			switch( selector ) {
-			
-				case 0:
-					//  
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.5*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.0005*sin(rotation*i/5000) + 0.05*zoom, 1.0f);
-					break;
-
-				case 1:
-					//  
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.25*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.0005*sin(rotation*i/5000) + 0.05*zoom, 1.0f);
-					break;
-
-				case 2:
-					//  ,     
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 1.0f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 3:
-					// Opera
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.0005*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 4:
-					// Big Opera
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 5:
-					// Big ROUND Opera
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 6:
-					// Big SQUARE Opera
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.1*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 7:
-					// Moebeus DNA 1
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + sin(i) * 0.03*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + sin(i) * 0.03*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 8:
-					// square MOBEUS DNA 2
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + sin(i) * 0.05*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + cos(i) * 0.05*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 9:
-					// round pulsing jaws of atan
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + sin(i) * 0.05*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 2*sin(rotation*0.5)*atan(i) * 0.05*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 10:
-					// majic ninja mask
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + sin(i) * 0.05*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 5*sin(rotation*0.5)* 0.05*cos(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 11:
-					// rotating circles 1
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.75*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.751*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 12:
-					// rotating wheel of crawling bugs
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.101*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 13:
-					// circle of changing phases 1
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/5000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/3000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 14:
-					// circle of SLOW changing phases 2
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.1*sin(rotation*i/50000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/25000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 15:
-					// circle of SLOW changing phases 3 - eye of the Dragon
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.35*sin(rotation*i/50000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/25000) + 0.0005*zoom, 1.0f);
-					break;
-
-				case 16:
-
-					break;
-
-				default:
-					D3DXMatrixRotationZ(&worldMatrixZ, (rotation+i) / 10);
-					//D3DXMatrixTranslation(&matTrans, x * cos(rotation/100 + .002*i) - 400.0f, y - 300.0f, 0.0f);
-					//D3DXMatrixScaling(&matScale, 1.0f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f + 0.05*sin(rotation*i/5000) + 0.0005*zoom, 1.0f);
-					D3DXMatrixScaling(&matScale, 0.5f + 0.35*sin(rotation*i/10000) + 0.0005*zoom, 0.5f + 0.1*sin(rotation*i/15000) + 0.0005*zoom, 1.0f);
-			}
+	// UTF-8 sample text with accented Latin, Cyrillic and the euro sign. The source file is not UTF-8, so the bytes are escaped
+	if (result)
+		result = m_DynamicFont->Render(m_d3d->GetDeviceContext(), m_FontShader,
+				"Unicode: \xC3\xA9t\xC3\xA9 \xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 \xE2\x82\xAC",
+				20, 60, 24, D3DXVECTOR4(1.0f, 1.0f, 1.0f, 1.0f), worldMatrixX, orthoMatrix);
 
-			// **********************************************************************************************************************************
+	// The same glyphs scaled up, they stay sharp
+	if (result)
+		result = m_DynamicFont->Render(m_d3d->GetDeviceContext(), m_FontShader, "SDF 64px", 20, 90, 64,
+				D3DXVECTOR4(1.0f, 0.8f, 0.2f, 1.0f), worldMatrixX, orthoMatrix);
 
-			if( i == 0 ) {
+	m_LayerCache->EndLayer(m_hudLayer);
 
-				if (!m_TextureShader->Render(device, indexCnt,
-					worldMatrixZ * matScale * matTrans,
-					viewMatrix, orthoMatrix, texture, true))
-					return false;
-			}
-			else {
+	return result;
+}
 
-				if (!m_TextureShader->Render(device, indexCnt,
-					worldMatrixZ * matScale * matTrans,
-					viewMatrix, orthoMatrix, texture, false))
-					return false;
-			}
-		}
+bool GraphicsClass::RenderHud()
+{
+	bool		result;
+	D3DXMATRIX	worldMatrixY, viewMatrix = m_frame.view, orthoMatrix = m_frame.ortho;
 
-#endif
+	// Composite the cached layer over the scene. The text was alpha blended into a cleared target, so its color is already
+	// multiplied by its alpha and the layer goes on with the premultiplied blend state, not the usual one.
+	m_OrthoWindow->Render(m_d3d->GetDeviceContext());
 
-		// text Out
-		// We call the text object to render all its sentences to the screen here.
-		// And just like with 2D images we disable the Z buffer before drawing and then enable it again after all the 2D has been drawn.
+	m_d3d->GetWorldMatrix(worldMatrixY);
+	m_d3d->TurnOnPremultipliedAlphaBlending();
 
-		// Render the text strings.
-		result = m_TextOut->Render(m_d3d->GetDeviceContext(), worldMatrixX, orthoMatrix);
-		if(!result)
-			return false;
+	result = m_TextureShader->Render(m_d3d->GetDeviceContext(), m_OrthoWindow->GetIndexCount(), worldMatrixY, viewMatrix, orthoMatrix, m_HudTexture->GetShaderResourceView());
 
+	// The premultiplied blend is not a state of the backend, the 2D state the graph set is put back
+	m_backend->SetState(m_state2D);
 
-		m_d3d->TurnOffAlphaBlending();
+	return result;
+}
 
-		// After all the 2D rendering is done we turn the Z buffer back on for the next round of 3D rendering.
-		// Turn the Z buffer back on now that all 2D rendering has completed.
-		m_d3d->TurnZBufferOn();
-	}
+bool GraphicsClass::Render3D()
+{
+	bool		result;
+	D3DXMATRIX	viewMatrix = m_frame.view, projectionMatrix = m_frame.projection, worldMatrixX, worldMatrixY, worldMatrixZ;
+	float		rotation = m_frame.rotation, zoom = m_frame.zoom;
+
+	// The model turns with the instanced bitmap of the 2D pass
+	m_d3d->GetWorldMatrix(worldMatrixY);
+	D3DXMatrixRotationZ(&worldMatrixZ, rotation / 5);
 
-	// --- 3d Rendering ---
-	{
 #if 1
-		// Here we rotate the world matrix by the rotation value so that when we render the triangle using this updated world matrix
-		// it will spin the triangle by the rotation amount.
-
-		D3DXMatrixRotationX(&worldMatrixX, tan(zoom));
-		//D3DXMatrixRotationY(&worldMatrixY, atan(rotation));
-
-		// Put the model vertex and index buffers on the graphics pipeline to prepare them for drawing.
-		m_Model->Render(m_d3d->GetDeviceContext());
-
-		D3DXMATRIX	 mat;
-		m_d3d->GetWorldMatrix(mat);
-		D3DXMatrixTranslation(&mat, 15.0f, 11.0f, 10.0f);
-
-		result = m_LightShader->Render(m_d3d->GetDeviceContext(), m_Model->GetIndexCount(),
-								//       ,     ,        
-								//    ,      
-								worldMatrixX
-								* worldMatrixY
-								* worldMatrixZ
-								* mat
-								,
-								viewMatrix, projectionMatrix,
-								m_Model->GetTexture(),
-								m_Light->GetDirection(), m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(),
-								m_Camera->GetPosition(), m_Light->GetSpecularColor(), m_Light->GetSpecularPower()
-		);
-#endif
+	// Here we rotate the world matrix by the rotation value so that when we render the triangle using this updated world matrix
+	// it will spin the triangle by the rotation amount.
+
+	D3DXMatrixRotationX(&worldMatrixX, tan(zoom));
+	//D3DXMatrixRotationY(&worldMatrixY, atan(rotation));
+
+	// Put the model vertex and index buffers on the graphics pipeline to prepare them for drawing.
+	m_Model->Render(m_d3d->GetDeviceContext());
+
+	D3DXMATRIX	 mat;
+	m_d3d->GetWorldMatrix(mat);
+	D3DXMatrixTranslation(&mat, 15.0f, 11.0f, 10.0f);
+
+	// The point lights orbit the model on a spiral shell, the spot lights look at its center.
+	m_PerfHud->Begin(PERF_LIGHTS);
+
+	for (int i = 0; i < POINT_LIGHTS; i++) {
+		ClusterLightType &light = m_pointLights[i];
+
+		float height = 1.0f - 2.0f * (i + 0.5f) / POINT_LIGHTS;
+		float radius = sqrt(1.0f - height * height) * (3.0f + (i % 5) * 0.5f);
+		float angle	 = i * 2.39996f + rotation * (0.002f + (i % 3) * 0.001f);
+
+		light.position[0] = 15.0f + radius * cos(angle);
+		light.position[1] = 11.0f + height * (3.0f + (i % 5) * 0.5f);
+		light.position[2] = 10.0f + radius * sin(angle);
+
+		float length = sqrt((light.position[0] - 15.0f) * (light.position[0] - 15.0f) + (light.position[1] - 11.0f) * (light.position[1] - 11.0f) +
+							(light.position[2] - 10.0f) * (light.position[2] - 10.0f));
+
+		light.direction[0] = (15.0f - light.position[0]) / length;
+		light.direction[1] = (11.0f - light.position[1]) / length;
+		light.direction[2] = (10.0f - light.position[2]) / length;
 	}
 
+	result = m_ClusteredLights->Update(m_d3d->GetDeviceContext(), &m_pointLights[0], POINT_LIGHTS, viewMatrix);
+	m_PerfHud->End(PERF_LIGHTS);
 
+	if (!result)
+		return false;
+
+	m_ClusteredLights->Bind(m_d3d->GetDeviceContext());
+
+	result = m_LightShader->Render(m_d3d->GetDeviceContext(), m_Model->GetIndexCount(),
+							//       ,     ,        
+							//    ,      
+							worldMatrixX
+							* worldMatrixY
+							* worldMatrixZ
+							* mat
+							,
+							viewMatrix, projectionMatrix,
+							m_Model->GetTexture(),
+							m_Light->GetDirection(), m_Light->GetAmbientColor(), m_Light->GetDiffuseColor(),
+							m_Camera->GetPosition(), m_Light->GetSpecularColor(), m_Light->GetSpecularPower()
+	);
+#endif
 
-	// Present the rendered scene to the screen.
-	m_d3d->EndScene();
 	return true;
 }
+
+bool GraphicsClass::RenderPerfHud()
+{
+	D3DXMATRIX worldMatrix;
+
+	m_d3d->GetWorldMatrix(worldMatrix);
+
+	return m_PerfHud->Render(m_d3d->GetDeviceContext(), worldMatrix, m_frame.ortho);
+}
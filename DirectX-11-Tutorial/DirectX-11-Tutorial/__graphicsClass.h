@@ -19,12 +19,25 @@
 #include "__textureShaderClass.h"
 #include "__lightShaderClass.h"
 #include "__lightClass.h"
+#include "__clusteredLightsClass.h"
 #include "__bitmapClass.h"
 #include "__textOutClass.h"
 #include "___Sprite.h"
 
 #include "__bitmapClassInstancing.h"
 #include "__textureShaderClassInstancing.h"
+#include "__particleSystemClass.h"
+#include "__spritePassClass.h"
+#include "__passRecorderClass.h"
+#include "__frameGraphClass.h"
+#include "__tilemapClass.h"
+#include "__spriteAnimatorClass.h"
+#include "__layerCacheClass.h"
+#include "__renderTextureClass.h"
+#include "__orthoWindowClass.h"
+#include "__dynamicFontClass.h"
+#include "__perfHudClass.h"
+#include "__gpuTimerClass.h"
 
 // ---------------------------------------------------------------------------------------
 #define fullScreen
@@ -43,10 +56,21 @@ const int  windowedHeight = 600;
 const bool	VSYNC_ENABLED = false;
 const float SCREEN_DEPTH  = 1000.0f;
 const float SCREEN_NEAR   = 0.1f;
+
+const int	POINT_LIGHTS  = 1024;
 // ---------------------------------------------------------------------------------------
 
 
 class GraphicsClass {
+ private:
+	// What the passes of the frame graph draw with, set by Render()
+	struct FrameType {
+		D3DXMATRIX view, projection, ortho;
+		float	   rotation, zoom;
+		int		   mouseX, mouseY;
+		bool	   result;
+	};
+
  public:
 	GraphicsClass();
 	GraphicsClass(const GraphicsClass &);
@@ -60,8 +84,37 @@ class GraphicsClass {
 
 	bool Render(const float &, const float &, const int &, const int &);
 
+	// The performance HUD is also used by the SystemClass, to time the input and to end the frames.
+	PerfHudClass* GetPerfHud();
+
+	// The GPU timer is flushed by the SystemClass before it stops a trace.
+	GpuTimerClass* GetGpuTimer();
+
+ private:
+	bool InitializeSprites();
+
+	// The passes of the frame graph, the data is the GraphicsClass
+	static void Render2DPass(RenderContextClass *, void *);
+	static void RenderTextPass(RenderContextClass *, void *);
+	static void RenderHudPass(RenderContextClass *, void *);
+	static void Render3DPass(RenderContextClass *, void *);
+	static void RenderPerfHudPass(RenderContextClass *, void *);
+
+	// RunPass renders a pass between the scopes of the performance HUD and of the GPU timer, closed whether it fails or not.
+	void RunPass(bool (GraphicsClass::*)(), int, const char *);
+
+	bool Render2D();
+	bool RenderText();
+	bool RenderHud();
+	bool Render3D();
+	bool RenderPerfHud();
+
  private:
 	 d3dClass				*m_d3d;
+
+	// The frame, the states of the 2D and the 3D rendering and the sprite passes go through d3dClass as a RenderBackendClass
+	RenderBackendClass		*m_backend;
+	RenderBackendClass::HandleType m_state2D, m_state3D;
 	 CameraClass			*m_Camera;
 	 ModelClass				*m_Model;
 
@@ -71,11 +124,16 @@ class GraphicsClass {
 	 LightShaderClass		*m_LightShader;
 	 LightClass				*m_Light;
 
+	// Point and spot lights orbiting the model, binned into the clusters of the view frustum every frame
+	ClusteredLightsClass	*m_ClusteredLights;
+	vector<ClusterLightType> m_pointLights;
+
 	 // We create a new private BitmapClass object here.
 	 BitmapClass			*m_Bitmap;
 	 BitmapClass			*m_Cursor;
 
 	 vector<Sprite*>		 m_spriteVec;
+	 vector<D3DXMATRIX>		 m_spriteWorlds;
 	 BitmapClass			*m_BitmapSprite;
 
 	// There is a new private variable for the TextClass object.
@@ -83,6 +141,58 @@ class GraphicsClass {
 
 	BitmapClass_Instancing	*m_BitmapIns;
 	TextureShaderClass_Instancing *m_TextureShaderIns;
+
+	// The instances of the bitmap are drawn by a sprite pass with the texture of the bitmap, made on the backend
+	SpritePassClass			*m_BitmapPass;
+	vector<SpritePassClass::InstanceType> m_bitmapInstances;
+	RenderBackendClass::HandleType m_bitmapTexture;
+
+	// The sprite passes draw with the shaders of TextureShaderClass_Instancing and one texture, made on the backend
+	TextureClass			*m_SpriteTexture;
+	RenderBackendClass::HandleType m_spriteVertexShader, m_spritePixelShader, m_spriteTexture;
+
+	// The particle system is simulated on the CPU and drawn by its own sprite pass.
+	ParticleSystemClass		*m_Particles;
+	SpritePassClass			*m_ParticlePass;
+	vector<SpritePassClass::InstanceType> m_particleInstances;
+	int						 m_particleEmitter;
+	int						 m_screenWidth, m_screenHeight;
+
+	// Scrolling tile background
+	TilemapClass			*m_Tilemap;
+
+	// Flipbook sprites: the animator picks the frame of each sprite from the sprite sheet, the sprites are drawn in batches of a pass each
+	SpriteAnimatorClass		*m_Animator;
+	vector<SpritePassClass*> m_SpritePasses;
+	vector<SpritePassClass::InstanceType> m_animatedInstances;
+
+	// The scene (the tilemap, the bitmap and the animated sprites) and the particles are two layers,
+	// recorded on deferred contexts in parallel and executed in that order.
+	// The draws of a layer are added to its draw queue every frame and submitted sorted
+	PassRecorderClass		*m_PassRecorder;
+	SpritePassClass::LayerType m_spriteLayers[2];
+
+	// Static 2D layers are cached in render textures and composited with the ortho window quad
+	LayerCacheClass			*m_LayerCache;
+	RenderTextureClass		*m_HudTexture;
+	OrthoWindowClass		*m_OrthoWindow;
+	int						 m_hudLayer;
+	RenderBackendClass::HandleType m_hudLayerTexture;
+
+	// The frame is declared as the passes of a frame graph every frame: the 2D scene, the text into the HUD layer when it changed,
+	// the HUD layer over the scene, the 3D scene and the performance HUD
+	FrameGraphClass			*m_FrameGraph;
+	FrameType				 m_frame;
+
+	// UTF-8 text with glyphs rasterized on demand from a TrueType font, drawn with its own font shader
+	DynamicFontClass		*m_DynamicFont;
+	FontShaderClass			*m_FontShader;
+
+	// Performance overlay: frame time graph, percentiles, subsystem times and GPU upload counters
+	PerfHudClass			*m_PerfHud;
+
+	// GPU times of the frame and of its passes, for the trace
+	GpuTimerClass			*m_GpuTimer;
 };
 
 #endif
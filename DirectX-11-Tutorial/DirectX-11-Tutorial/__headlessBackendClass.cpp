@@ -0,0 +1,791 @@
+#include "__headlessBackendClass.h"
+#include "__perfStatsClass.h"
+
+HeadlessBackendClass::HeadlessBackendClass()
+{
+	m_owner = this;
+
+	ResetCounters();
+}
+
+HeadlessBackendClass::HeadlessBackendClass(const HeadlessBackendClass& other)
+{
+}
+
+HeadlessBackendClass::~HeadlessBackendClass()
+{
+}
+
+void HeadlessBackendClass::Shutdown()
+{
+	m_stream.Clear();
+	m_objects.clear();
+	m_freeHandles.clear();
+
+	return;
+}
+
+CommandStreamClass* HeadlessBackendClass::GetStream()
+{
+	return &m_stream;
+}
+
+int HeadlessBackendClass::GetCommandCount()
+{
+	return m_commands;
+}
+
+int HeadlessBackendClass::GetDrawCount()
+{
+	return m_draws;
+}
+
+int HeadlessBackendClass::GetErrorCount()
+{
+	return m_errors;
+}
+
+void HeadlessBackendClass::ResetCounters()
+{
+	m_commands = 0;
+	m_draws	   = 0;
+	m_errors   = 0;
+
+	return;
+}
+
+void HeadlessBackendClass::SetOwner(HeadlessBackendClass *owner)
+{
+	m_owner = owner;
+
+	return;
+}
+
+RenderBackendClass::HandleType HeadlessBackendClass::CreateBuffer(const BufferDescType &desc, const void *data)
+{
+	HandleType handle;
+
+	if (desc.size <= 0 || (desc.type == RENDER_BUFFER_STRUCTURED && desc.stride <= 0)) {
+		m_errors++;
+		return 0;
+	}
+
+	handle = NewObject(HEADLESS_CREATE_BUFFER, desc.type, desc.size, desc.dynamic);
+
+	Command(HEADLESS_CREATE_BUFFER);
+	m_stream.WriteUint(handle);
+	m_stream.WriteUint(desc.type);
+	m_stream.WriteUint(desc.size);
+	m_stream.WriteUint(desc.stride);
+	m_stream.WriteByte(desc.dynamic ? 1 : 0);
+	m_stream.WriteByte(data ? 1 : 0);
+
+	if (data)
+		m_stream.WriteBytes(data, desc.size);
+
+	return handle;
+}
+
+// The rows are recorded without the padding of the pitch.
+RenderBackendClass::HandleType HeadlessBackendClass::CreateTexture(const TextureDescType &desc, const void *data, int pitch)
+{
+	HandleType handle;
+	int		   rowSize = desc.width * GetTexelSize(desc.format);
+
+	if (desc.width <= 0 || desc.height <= 0 || rowSize <= 0 || (data && pitch < rowSize)) {
+		m_errors++;
+		return 0;
+	}
+
+	handle = NewObject(HEADLESS_CREATE_TEXTURE, desc.format, rowSize * desc.height, desc.renderTarget);
+
+	Command(HEADLESS_CREATE_TEXTURE);
+	m_stream.WriteUint(handle);
+	m_stream.WriteUint(desc.width);
+	m_stream.WriteUint(desc.height);
+	m_stream.WriteUint(desc.format);
+	m_stream.WriteByte(desc.renderTarget ? 1 : 0);
+	m_stream.WriteByte(data ? 1 : 0);
+
+	if (data)
+		for (int y = 0; y < desc.height; y++)
+			m_stream.WriteBytes((const unsigned char*)data + y * pitch, rowSize);
+
+	return handle;
+}
+
+RenderBackendClass::HandleType HeadlessBackendClass::CreateShader(const ShaderDescType &desc)
+{
+	HandleType handle;
+
+	if ((desc.stage != RENDER_STAGE_VERTEX && desc.stage != RENDER_STAGE_PIXEL) || !desc.entry || desc.size < 0) {
+		m_errors++;
+		return 0;
+	}
+
+	handle = NewObject(HEADLESS_CREATE_SHADER, desc.stage, desc.size, false);
+
+	Command(HEADLESS_CREATE_SHADER);
+	m_stream.WriteUint(handle);
+	m_stream.WriteUint(desc.stage);
+	m_stream.WriteString(desc.entry);
+	m_stream.WriteUint((unsigned int)desc.features);
+	m_stream.WriteUint(desc.size);
+	m_stream.WriteBytes(desc.code, desc.size);
+	m_stream.WriteUint(desc.elementCount);
+
+	for (int i = 0; i < desc.elementCount; i++) {
+		const VertexElementType &element = desc.elements[i];
+
+		m_stream.WriteString(element.semantic);
+		m_stream.WriteUint(element.semanticIndex);
+		m_stream.WriteUint(element.format);
+		m_stream.WriteUint(element.slot);
+		m_stream.WriteUint(element.offset);
+		m_stream.WriteByte(element.perInstance ? 1 : 0);
+	}
+
+	return handle;
+}
+
+RenderBackendClass::HandleType HeadlessBackendClass::CreateState(const StateDescType &desc)
+{
+	HandleType handle = NewObject(HEADLESS_CREATE_STATE, 0, 0, false);
+
+	Command(HEADLESS_CREATE_STATE);
+	m_stream.WriteUint(handle);
+	m_stream.WriteByte((desc.alphaBlending ? 1 : 0) | (desc.depthTest ? 2 : 0) | (desc.depthWrite ? 4 : 0) | (desc.cullBack ? 8 : 0));
+
+	return handle;
+}
+
+void HeadlessBackendClass::Release(HandleType handle)
+{
+	if (!handle)
+		return;
+
+	Check(handle, 0);
+
+	Command(HEADLESS_RELEASE);
+	m_stream.WriteUint(handle);
+
+	if (FindObject(handle)) {
+		m_objects[handle - 1].kind = 0;
+		m_freeHandles.push_back(handle);
+	}
+
+	return;
+}
+
+bool HeadlessBackendClass::UpdateBuffer(HandleType handle, const void *data, int size)
+{
+	const ObjectType *object = FindObject(handle);
+	bool			  valid	 = size >= 0 && (!m_owner || (object && object->kind == HEADLESS_CREATE_BUFFER && object->dynamic && size <= object->size));
+
+	if (!valid)
+		m_errors++;
+
+	Command(HEADLESS_UPDATE_BUFFER);
+	m_stream.WriteUint(handle);
+	m_stream.WriteUint(size);
+	m_stream.WriteBytes(data, size);
+
+	if (m_owner)
+		PerfStatsClass::CountMap(size);
+
+	return valid;
+}
+
+void HeadlessBackendClass::BeginFrame(const float *color)
+{
+	Command(HEADLESS_BEGIN_FRAME);
+
+	for (int i = 0; i < 4; i++)
+		m_stream.WriteFloat(color[i]);
+
+	return;
+}
+
+void HeadlessBackendClass::EndFrame()
+{
+	Command(HEADLESS_END_FRAME);
+
+	return;
+}
+
+void HeadlessBackendClass::SetRenderTarget(HandleType texture)
+{
+	const ObjectType *object = FindObject(texture);
+
+	if (texture && m_owner && (!object || object->kind != HEADLESS_CREATE_TEXTURE || !object->dynamic))
+		m_errors++;
+
+	Command(HEADLESS_SET_RENDER_TARGET);
+	m_stream.WriteUint(texture);
+
+	return;
+}
+
+void HeadlessBackendClass::Clear(const float *color)
+{
+	Command(HEADLESS_CLEAR);
+
+	for (int i = 0; i < 4; i++)
+		m_stream.WriteFloat(color[i]);
+
+	return;
+}
+
+void HeadlessBackendClass::SetState(HandleType state)
+{
+	Check(state, HEADLESS_CREATE_STATE);
+
+	Command(HEADLESS_SET_STATE);
+	m_stream.WriteUint(state);
+
+	return;
+}
+
+void HeadlessBackendClass::SetShaders(HandleType vertexShader, HandleType pixelShader)
+{
+	Check(vertexShader, HEADLESS_CREATE_SHADER);
+	Check(pixelShader,	HEADLESS_CREATE_SHADER);
+
+	Command(HEADLESS_SET_SHADERS);
+	m_stream.WriteUint(vertexShader);
+	m_stream.WriteUint(pixelShader);
+
+	return;
+}
+
+void HeadlessBackendClass::SetVertexBuffers(int start, int count, const HandleType *buffers, const unsigned int *strides, const unsigned int *offsets)
+{
+	if (count > RENDER_MAX_BINDINGS)
+		m_errors++;
+
+	Command(HEADLESS_SET_VERTEX_BUFFERS);
+	m_stream.WriteUint(start);
+	m_stream.WriteUint(count);
+
+	for (int i = 0; i < count; i++) {
+		Check(buffers[i], HEADLESS_CREATE_BUFFER);
+
+		m_stream.WriteUint(buffers[i]);
+		m_stream.WriteUint(strides[i]);
+		m_stream.WriteUint(offsets[i]);
+	}
+
+	return;
+}
+
+void HeadlessBackendClass::SetIndexBuffer(HandleType buffer)
+{
+	Check(buffer, HEADLESS_CREATE_BUFFER);
+
+	Command(HEADLESS_SET_INDEX_BUFFER);
+	m_stream.WriteUint(buffer);
+
+	return;
+}
+
+void HeadlessBackendClass::SetConstantBuffers(int stages, int slot, int count, const HandleType *buffers)
+{
+	if (count > RENDER_MAX_BINDINGS)
+		m_errors++;
+
+	Command(HEADLESS_SET_CONSTANT_BUFFERS);
+	m_stream.WriteUint(stages);
+	m_stream.WriteUint(slot);
+	m_stream.WriteUint(count);
+
+	for (int i = 0; i < count; i++) {
+		Check(buffers[i], HEADLESS_CREATE_BUFFER);
+		m_stream.WriteUint(buffers[i]);
+	}
+
+	return;
+}
+
+// A texture slot takes a texture or a structured buffer.
+void HeadlessBackendClass::SetTextures(int stages, int slot, int count, const HandleType *textures)
+{
+	if (count > RENDER_MAX_BINDINGS)
+		m_errors++;
+
+	Command(HEADLESS_SET_TEXTURES);
+	m_stream.WriteUint(stages);
+	m_stream.WriteUint(slot);
+	m_stream.WriteUint(count);
+
+	for (int i = 0; i < count; i++) {
+		const ObjectType *object = FindObject(textures[i]);
+
+		if (textures[i] && m_owner && (!object || (object->kind != HEADLESS_CREATE_TEXTURE &&
+			(object->kind != HEADLESS_CREATE_BUFFER || object->type != RENDER_BUFFER_STRUCTURED))))
+			m_errors++;
+
+		m_stream.WriteUint(textures[i]);
+	}
+
+	return;
+}
+
+void HeadlessBackendClass::Draw(int vertexCount, int startVertex)
+{
+	Command(HEADLESS_DRAW);
+	m_stream.WriteUint(vertexCount);
+	m_stream.WriteUint(startVertex);
+
+	CountDraw();
+
+	return;
+}
+
+void HeadlessBackendClass::DrawIndexed(int indexCount, int startIndex, int baseVertex)
+{
+	Command(HEADLESS_DRAW_INDEXED);
+	m_stream.WriteUint(indexCount);
+	m_stream.WriteUint(startIndex);
+	m_stream.WriteInt(baseVertex);
+
+	CountDraw();
+
+	return;
+}
+
+void HeadlessBackendClass::DrawInstanced(int vertexCount, int instanceCount, int startVertex, int startInstance)
+{
+	Command(HEADLESS_DRAW_INSTANCED);
+	m_stream.WriteUint(vertexCount);
+	m_stream.WriteUint(instanceCount);
+	m_stream.WriteUint(startVertex);
+	m_stream.WriteUint(startInstance);
+
+	CountDraw();
+
+	return;
+}
+
+void HeadlessBackendClass::DrawIndexedInstanced(int indexCount, int instanceCount, int startIndex, int baseVertex, int startInstance)
+{
+	Command(HEADLESS_DRAW_INDEXED_INSTANCED);
+	m_stream.WriteUint(indexCount);
+	m_stream.WriteUint(instanceCount);
+	m_stream.WriteUint(startIndex);
+	m_stream.WriteInt(baseVertex);
+	m_stream.WriteUint(startInstance);
+
+	CountDraw();
+
+	return;
+}
+
+// A deferred context is a HeadlessBackendClass of the same owner, its calls are checked against the objects of this one.
+RenderContextClass* HeadlessBackendClass::CreateDeferredContext()
+{
+	HeadlessBackendClass *context = new HeadlessBackendClass;
+
+	if (!context)
+		return 0;
+
+	context->SetOwner(this);
+
+	return context;
+}
+
+// The recording of the context goes to the end of the stream with its counters, then the back buffer is the target again.
+void HeadlessBackendClass::ExecuteDeferredContext(RenderContextClass *context)
+{
+	HeadlessBackendClass *deferred = (HeadlessBackendClass*)context;
+
+	m_stream.WriteBytes(deferred->m_stream.GetData(), deferred->m_stream.GetSize());
+	m_commands += deferred->m_commands;
+	m_draws	   += deferred->m_draws;
+	m_errors   += deferred->m_errors;
+
+	deferred->m_stream.Clear();
+	deferred->ResetCounters();
+
+	SetRenderTarget(0);
+
+	return;
+}
+
+void HeadlessBackendClass::ReleaseDeferredContext(RenderContextClass *context)
+{
+	HeadlessBackendClass *deferred = (HeadlessBackendClass*)context;
+
+	if (deferred) {
+		deferred->Shutdown();
+		delete deferred;
+	}
+
+	return;
+}
+
+// The recorded handles are numbers from 1, the table gives the handle the other backend made for each.
+bool HeadlessBackendClass::Replay(CommandStreamClass *stream, RenderBackendClass *backend)
+{
+	vector<HandleType> handles(1, 0);
+
+	return Play(stream, backend, backend, &handles);
+}
+
+// A context makes no objects, its recording only has the calls of a context.
+bool HeadlessBackendClass::ReplayContext(CommandStreamClass *stream, RenderContextClass *context)
+{
+	return Play(stream, 0, context, 0);
+}
+
+// Play sends the commands to the context, and the ones that make, release objects or frame to the backend, when there is one.
+// Without a table of handles the recorded handles are used as they are.
+bool HeadlessBackendClass::Play(CommandStreamClass *stream, RenderBackendClass *backend, RenderContextClass *context, vector<HandleType> *handles)
+{
+	HandleType		   bindings[RENDER_MAX_BINDINGS];
+	unsigned int	   strides[RENDER_MAX_BINDINGS], offsets[RENDER_MAX_BINDINGS];
+	float			   color[4];
+
+	stream->Rewind();
+
+	while (!stream->AtEnd()) {
+		int opcode = stream->ReadByte();
+
+		// A context makes no objects and no frames
+		if (!backend && (opcode <= HEADLESS_RELEASE || opcode == HEADLESS_BEGIN_FRAME || opcode == HEADLESS_END_FRAME))
+			return false;
+
+		switch (opcode) {
+			case HEADLESS_CREATE_BUFFER: {
+				BufferDescType desc;
+				unsigned int   handle = stream->ReadUint();
+				const void	  *data	  = 0;
+
+				desc.type	 = stream->ReadUint();
+				desc.size	 = stream->ReadUint();
+				desc.stride	 = stream->ReadUint();
+				desc.dynamic = stream->ReadByte() != 0;
+
+				if (stream->ReadByte())
+					data = stream->ReadBytes(desc.size);
+
+				if (!stream->IsValid())
+					return false;
+
+				if (handle >= handles->size())
+					handles->resize(handle + 1, 0);
+
+				(*handles)[handle] = backend->CreateBuffer(desc, data);
+				break;
+			}
+
+			case HEADLESS_CREATE_TEXTURE: {
+				TextureDescType desc;
+				unsigned int	handle = stream->ReadUint();
+				const void	   *data   = 0;
+
+				desc.width		  = stream->ReadUint();
+				desc.height		  = stream->ReadUint();
+				desc.format		  = stream->ReadUint();
+				desc.renderTarget = stream->ReadByte() != 0;
+
+				if (stream->ReadByte())
+					data = stream->ReadBytes(desc.width * desc.height * GetTexelSize(desc.format));
+
+				if (!stream->IsValid())
+					return false;
+
+				if (handle >= handles->size())
+					handles->resize(handle + 1, 0);
+
+				(*handles)[handle] = backend->CreateTexture(desc, data, desc.width * GetTexelSize(desc.format));
+				break;
+			}
+
+			case HEADLESS_CREATE_SHADER: {
+				ShaderDescType			  desc;
+				vector<VertexElementType> elements;
+				unsigned int			  handle = stream->ReadUint();
+
+				desc.stage		  = stream->ReadUint();
+				desc.entry		  = stream->ReadString();
+				desc.features	  = stream->ReadUint();
+				desc.size		  = stream->ReadUint();
+				desc.code		  = stream->ReadBytes(desc.size);
+				desc.elementCount = stream->ReadUint();
+
+				if (!stream->IsValid() || desc.elementCount > stream->GetSize())
+					return false;
+
+				elements.resize(desc.elementCount);
+
+				for (int i = 0; i < desc.elementCount; i++) {
+					elements[i].semantic	  = stream->ReadString();
+					elements[i].semanticIndex = stream->ReadUint();
+					elements[i].format		  = stream->ReadUint();
+					elements[i].slot		  = stream->ReadUint();
+					elements[i].offset		  = stream->ReadUint();
+					elements[i].perInstance	  = stream->ReadByte() != 0;
+				}
+
+				desc.elements = elements.empty() ? 0 : &elements[0];
+
+				if (!stream->IsValid())
+					return false;
+
+				if (handle >= handles->size())
+					handles->resize(handle + 1, 0);
+
+				(*handles)[handle] = backend->CreateShader(desc);
+				break;
+			}
+
+			case HEADLESS_CREATE_STATE: {
+				StateDescType desc;
+				unsigned int  handle = stream->ReadUint();
+				unsigned int  flags	 = stream->ReadByte();
+
+				desc.alphaBlending = (flags & 1) != 0;
+				desc.depthTest	   = (flags & 2) != 0;
+				desc.depthWrite	   = (flags & 4) != 0;
+				desc.cullBack	   = (flags & 8) != 0;
+
+				if (!stream->IsValid())
+					return false;
+
+				if (handle >= handles->size())
+					handles->resize(handle + 1, 0);
+
+				(*handles)[handle] = backend->CreateState(desc);
+				break;
+			}
+
+			case HEADLESS_RELEASE: {
+				unsigned int handle = stream->ReadUint();
+
+				if (handle < handles->size()) {
+					backend->Release((*handles)[handle]);
+					(*handles)[handle] = 0;
+				}
+				break;
+			}
+
+			case HEADLESS_UPDATE_BUFFER: {
+				HandleType	buffer;
+				int			size;
+				const void *data;
+
+				buffer = ReadHandle(stream, handles);
+				size = stream->ReadUint();
+				data = stream->ReadBytes(size);
+
+				if (!stream->IsValid())
+					return false;
+
+				context->UpdateBuffer(buffer, data, size);
+				break;
+			}
+
+			case HEADLESS_BEGIN_FRAME:
+			case HEADLESS_CLEAR:
+				for (int i = 0; i < 4; i++)
+					color[i] = stream->ReadFloat();
+
+				if (!stream->IsValid())
+					return false;
+
+				if (opcode == HEADLESS_BEGIN_FRAME)
+					backend->BeginFrame(color);
+				else
+					context->Clear(color);
+				break;
+
+			case HEADLESS_END_FRAME:
+				backend->EndFrame();
+				break;
+
+			case HEADLESS_SET_RENDER_TARGET:
+				bindings[0] = ReadHandle(stream, handles);
+				context->SetRenderTarget(bindings[0]);
+				break;
+
+			case HEADLESS_SET_STATE:
+				bindings[0] = ReadHandle(stream, handles);
+				context->SetState(bindings[0]);
+				break;
+
+			case HEADLESS_SET_SHADERS:
+				bindings[0] = ReadHandle(stream, handles);
+				bindings[1] = ReadHandle(stream, handles);
+				context->SetShaders(bindings[0], bindings[1]);
+				break;
+
+			case HEADLESS_SET_VERTEX_BUFFERS: {
+				int start = stream->ReadUint();
+				int count = stream->ReadUint();
+
+				if (count > RENDER_MAX_BINDINGS)
+					return false;
+
+				for (int i = 0; i < count; i++) {
+					bindings[i] = ReadHandle(stream, handles);
+					strides[i] = stream->ReadUint();
+					offsets[i] = stream->ReadUint();
+				}
+
+				context->SetVertexBuffers(start, count, bindings, strides, offsets);
+				break;
+			}
+
+			case HEADLESS_SET_INDEX_BUFFER:
+				bindings[0] = ReadHandle(stream, handles);
+				context->SetIndexBuffer(bindings[0]);
+				break;
+
+			case HEADLESS_SET_CONSTANT_BUFFERS:
+			case HEADLESS_SET_TEXTURES: {
+				int stages = stream->ReadUint();
+				int slot   = stream->ReadUint();
+				int count  = stream->ReadUint();
+
+				if (count > RENDER_MAX_BINDINGS)
+					return false;
+
+				for (int i = 0; i < count; i++)
+					bindings[i] = ReadHandle(stream, handles);
+
+				if (opcode == HEADLESS_SET_CONSTANT_BUFFERS)
+					context->SetConstantBuffers(stages, slot, count, bindings);
+				else
+					context->SetTextures(stages, slot, count, bindings);
+				break;
+			}
+
+			case HEADLESS_DRAW: {
+				int vertexCount = stream->ReadUint();
+				int startVertex = stream->ReadUint();
+
+				context->Draw(vertexCount, startVertex);
+				break;
+			}
+
+			case HEADLESS_DRAW_INDEXED: {
+				int indexCount = stream->ReadUint();
+				int startIndex = stream->ReadUint();
+				int baseVertex = stream->ReadInt();
+
+				context->DrawIndexed(indexCount, startIndex, baseVertex);
+				break;
+			}
+
+			case HEADLESS_DRAW_INSTANCED: {
+				int vertexCount	  = stream->ReadUint();
+				int instanceCount = stream->ReadUint();
+				int startVertex	  = stream->ReadUint();
+				int startInstance = stream->ReadUint();
+
+				context->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+				break;
+			}
+
+			case HEADLESS_DRAW_INDEXED_INSTANCED: {
+				int indexCount	  = stream->ReadUint();
+				int instanceCount = stream->ReadUint();
+				int startIndex	  = stream->ReadUint();
+				int baseVertex	  = stream->ReadInt();
+				int startInstance = stream->ReadUint();
+
+				context->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+				break;
+			}
+
+			default:
+				return false;
+		}
+	}
+
+	return stream->IsValid();
+}
+
+// ReadHandle reads a recorded handle and gives the one made for it by the backend of the replay, or the same one without a table.
+RenderBackendClass::HandleType HeadlessBackendClass::ReadHandle(CommandStreamClass *stream, const vector<HandleType> *handles)
+{
+	unsigned int recorded = stream->ReadUint();
+
+	if (!handles)
+		return recorded;
+
+	return recorded < handles->size() ? (*handles)[recorded] : 0;
+}
+
+// A released handle is given out again before a new one.
+RenderBackendClass::HandleType HeadlessBackendClass::NewObject(int kind, int type, int size, bool dynamic)
+{
+	ObjectType object = { kind, type, size, dynamic };
+	HandleType handle;
+
+	if (!m_freeHandles.empty()) {
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+	}
+	else {
+		m_objects.push_back(object);
+		handle = (HandleType)m_objects.size();
+	}
+
+	m_objects[handle - 1] = object;
+
+	return handle;
+}
+
+// FindObject gives what is known of an object of the owner, null for no object.
+const HeadlessBackendClass::ObjectType* HeadlessBackendClass::FindObject(HandleType handle)
+{
+	if (!m_owner || !handle || handle > m_owner->m_objects.size() || !m_owner->m_objects[handle - 1].kind)
+		return 0;
+
+	return &m_owner->m_objects[handle - 1];
+}
+
+void HeadlessBackendClass::Command(int opcode)
+{
+	m_stream.WriteByte((unsigned char)opcode);
+	m_commands++;
+
+	return;
+}
+
+// A handle given to a call has to be an object of the kind the call takes, kind 0 takes any object. No object (0) is always fine.
+void HeadlessBackendClass::Check(HandleType handle, int kind)
+{
+	const ObjectType *object = FindObject(handle);
+
+	if (!handle || !m_owner)
+		return;
+
+	if (!object || (kind && object->kind != kind))
+		m_errors++;
+
+	return;
+}
+
+// Without an owner the backend that plays the recording back counts the draws.
+void HeadlessBackendClass::CountDraw()
+{
+	m_draws++;
+
+	if (m_owner)
+		PerfStatsClass::CountDraw();
+
+	return;
+}
+
+int HeadlessBackendClass::GetTexelSize(int format)
+{
+	switch (format) {
+		case RENDER_FORMAT_RGBA32F: return 16;
+		case RENDER_FORMAT_RGBA8:	return 4;
+		case RENDER_FORMAT_R8:		return 1;
+	}
+
+	return 0;
+}
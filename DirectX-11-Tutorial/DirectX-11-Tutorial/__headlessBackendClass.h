@@ -0,0 +1,135 @@
+// --------------------------------------------------------------------------------------------------------
+// HeadlessBackendClass is a RenderBackendClass without a GPU: every call is checked and recorded into a CommandStreamClass,
+// one opcode byte and the arguments, the data of the buffers and textures included.
+// The recording is what the frame asked the GPU for, to compare two runs or to time the CPU side of a frame alone.
+//
+// A handle that was never made or was released, an update of a static buffer or past the end of a buffer,
+// and more than RENDER_MAX_BINDINGS slots in a call count as errors;
+// the calls are recorded anyway, UpdateBuffer returns false like a failed Map.
+// Replay sends a recording to another backend, with the handles it makes there in place of the recorded ones.
+// The stream keeps growing until it is cleared, GetStream()->Clear() between the frames records one frame at a time.
+//
+// A deferred context is another HeadlessBackendClass with a stream of its own, checked against the objects of its owner;
+// executing it appends its stream to the stream of the owner, so a recording replays the same whether the passes were deferred or not.
+// Other backends use one without an owner, unchecked, and play its stream back themselves with ReplayContext.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _HEADLESSBACKENDCLASS_H_
+#define _HEADLESSBACKENDCLASS_H_
+
+#include <vector>
+using namespace std;
+
+#include "__renderBackendClass.h"
+#include "__commandStreamClass.h"
+
+// The opcodes of the stream
+#define HEADLESS_CREATE_BUFFER			 1
+#define HEADLESS_CREATE_TEXTURE			 2
+#define HEADLESS_CREATE_SHADER			 3
+#define HEADLESS_CREATE_STATE			 4
+#define HEADLESS_RELEASE				 5
+#define HEADLESS_UPDATE_BUFFER			 6
+#define HEADLESS_BEGIN_FRAME			 7
+#define HEADLESS_END_FRAME				 8
+#define HEADLESS_SET_RENDER_TARGET		 9
+#define HEADLESS_CLEAR					 10
+#define HEADLESS_SET_STATE				 11
+#define HEADLESS_SET_SHADERS			 12
+#define HEADLESS_SET_VERTEX_BUFFERS		 13
+#define HEADLESS_SET_INDEX_BUFFER		 14
+#define HEADLESS_SET_CONSTANT_BUFFERS	 15
+#define HEADLESS_SET_TEXTURES			 16
+#define HEADLESS_DRAW					 17
+#define HEADLESS_DRAW_INDEXED			 18
+#define HEADLESS_DRAW_INSTANCED			 19
+#define HEADLESS_DRAW_INDEXED_INSTANCED	 20
+
+
+
+class HeadlessBackendClass : public RenderBackendClass {
+ private:
+	// What is known of an object, to check the calls that use it
+	struct ObjectType {
+		int	 kind;			// 0 for a free handle, else the HEADLESS_CREATE_ opcode of the object
+		int	 type;			// the buffer type or the shader stage
+		int	 size;
+		bool dynamic;		// a dynamic buffer, or a texture that is a render target
+	};
+
+ public:
+	HeadlessBackendClass();
+	HeadlessBackendClass(const HeadlessBackendClass &);
+   ~HeadlessBackendClass();
+
+	void Shutdown();
+
+	CommandStreamClass* GetStream();
+
+	// The counters since the last ResetCounters: the calls recorded, the draws among them and the wrong calls.
+	int	 GetCommandCount();
+	int	 GetDrawCount();
+	int	 GetErrorCount();
+	void ResetCounters();
+
+	// SetOwner makes the calls checked against the objects of another HeadlessBackendClass, or not checked with 0.
+	// Only the RenderContextClass calls are for a HeadlessBackendClass that is not its own owner.
+	void SetOwner(HeadlessBackendClass *);
+
+	// Replay runs the commands of a recorded stream on another backend, it returns false on a stream it can't read.
+	// ReplayContext runs the recording of a context, with the handles as they were recorded.
+	static bool Replay(CommandStreamClass *, RenderBackendClass *);
+	static bool ReplayContext(CommandStreamClass *, RenderContextClass *);
+
+	// RenderBackendClass
+	HandleType CreateBuffer(const BufferDescType &, const void *);
+	HandleType CreateTexture(const TextureDescType &, const void *, int);
+	HandleType CreateShader(const ShaderDescType &);
+	HandleType CreateState(const StateDescType &);
+	void	   Release(HandleType);
+
+	bool UpdateBuffer(HandleType, const void *, int);
+
+	void BeginFrame(const float *);
+	void EndFrame();
+
+	void SetRenderTarget(HandleType);
+	void Clear(const float *);
+
+	void SetState(HandleType);
+	void SetShaders(HandleType, HandleType);
+	void SetVertexBuffers(int, int, const HandleType *, const unsigned int *, const unsigned int *);
+	void SetIndexBuffer(HandleType);
+	void SetConstantBuffers(int, int, int, const HandleType *);
+	void SetTextures(int, int, int, const HandleType *);
+
+	void Draw(int, int);
+	void DrawIndexed(int, int, int);
+	void DrawInstanced(int, int, int, int);
+	void DrawIndexedInstanced(int, int, int, int, int);
+
+	RenderContextClass* CreateDeferredContext();
+	void				ExecuteDeferredContext(RenderContextClass *);
+	void				ReleaseDeferredContext(RenderContextClass *);
+
+ private:
+	HandleType		  NewObject(int, int, int, bool);
+	const ObjectType* FindObject(HandleType);
+	void			  Command(int);
+	void			  Check(HandleType, int);
+	void			  CountDraw();
+
+	static bool		  Play(CommandStreamClass *, RenderBackendClass *, RenderContextClass *, vector<HandleType> *);
+	static HandleType ReadHandle(CommandStreamClass *, const vector<HandleType> *);
+	static int		  GetTexelSize(int);
+
+ private:
+	HeadlessBackendClass *m_owner;
+	CommandStreamClass	  m_stream;
+	vector<ObjectType>	  m_objects;
+	vector<HandleType>	  m_freeHandles;
+	int					  m_commands, m_draws, m_errors;
+};
+
+#endif
@@ -0,0 +1,546 @@
+#include "__headlessRunnerClass.h"
+#include "__traceClass.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+#define PARTICLE_QUAD_SIZE 24		// the quad of a particle in pixels, the size curve scales it
+#define PARTICLE_TEXTURE   32
+#define EMITTER_RADIUS	   150.0f
+#define EMITTER_PERIOD	   4000.0f	// a turn of the emitter, in milliseconds
+#define HUD_LETTER_WIDTH   7		// the boxes of the letters of the HUD
+#define HUD_LETTER_HEIGHT  16
+#define HUD_TEXT_PERIOD	   250.0f	// the text of the HUD is refreshed 4 times a second, like PerfHudClass does
+
+HeadlessRunnerClass::HeadlessRunnerClass()
+{
+	m_mode	   = HEADLESS_RUNNER_RECORD;
+	m_width	   = 0;
+	m_height   = 0;
+	m_backend  = 0;
+	m_recorder = 0;
+	m_software = 0;
+
+	m_particles		= 0;
+	m_maxParticles	= 0;
+	m_emitter		= -1;
+	m_instanceCount = 0;
+
+	m_vertexShader = 0;
+	m_pixelShader  = 0;
+	m_texture	   = 0;
+	m_state		   = 0;
+
+	m_hudEnabled	  = false;
+	m_lastTextTime	  = -1.0f;
+	m_hudTime		  = 0.0;
+	m_hudVertexShader = 0;
+	m_hudPixelShader  = 0;
+	m_hudBuffer		  = 0;
+	m_hudTexture	  = 0;
+	m_hudMatrixBuffer = 0;
+}
+
+HeadlessRunnerClass::HeadlessRunnerClass(const HeadlessRunnerClass& other)
+{
+}
+
+HeadlessRunnerClass::~HeadlessRunnerClass()
+{
+}
+
+bool HeadlessRunnerClass::Initialize(int mode, int width, int height, int threadCount, int maxParticles)
+{
+	bool result;
+
+	m_mode	 = mode;
+	m_width	 = width;
+	m_height = height;
+
+	if (mode == HEADLESS_RUNNER_SOFTWARE) {
+		m_software = new SoftwareBackendClass;
+		if (!m_software)
+			return false;
+
+		result = m_software->Initialize(width, height, threadCount);
+		if (!result)
+			return false;
+
+		m_backend = m_software;
+	}
+	else {
+		m_recorder = new HeadlessBackendClass;
+		if (!m_recorder)
+			return false;
+
+		m_backend = m_recorder;
+	}
+
+	m_particles = new ParticleSystemClass;
+	if (!m_particles)
+		return false;
+
+	m_maxParticles = maxParticles;
+
+	result = CreateParticles();
+	if (!result)
+		return false;
+
+	m_instances.resize(m_particles->GetCapacity());
+
+	result = CreateScene();
+	if (!result)
+		return false;
+
+	return CreateHud();
+}
+
+void HeadlessRunnerClass::Shutdown()
+{
+	m_hud.Shutdown();
+	PerfStatsClass::SetCounting(false);
+
+	m_particlePass.Shutdown();
+
+	if (m_particles) {
+		m_particles->Shutdown();
+		delete m_particles;
+		m_particles = 0;
+	}
+
+	if (m_software) {
+		m_software->Shutdown();
+		delete m_software;
+		m_software = 0;
+	}
+
+	if (m_recorder) {
+		m_recorder->Shutdown();
+		delete m_recorder;
+		m_recorder = 0;
+	}
+
+	m_backend = 0;
+
+	return;
+}
+
+// Showing the HUD starts a fresh history and counts the draws and uploads, like PerfHudClass::SetEnabled.
+void HeadlessRunnerClass::SetHudEnabled(bool enabled)
+{
+	m_hudEnabled = enabled;
+
+	PerfStatsClass::SetCounting(enabled);
+
+	m_stats.Reset();
+	m_lastTextTime = -1.0f;
+	m_hudTime	   = 0.0;
+
+	return;
+}
+
+// The timings are taken around the work only; the hash and the image of a frame are not part of them.
+bool HeadlessRunnerClass::Run(int frameCount, float step, const char *imageName)
+{
+	m_frames.clear();
+
+	if (!CreateParticles())
+		return false;
+
+	if (m_hudEnabled) {
+		m_stats.Reset();
+		m_lastTextTime = -1.0f;
+	}
+
+	for (int i = 0; i < frameCount; i++) {
+		FrameType frame;
+		double	  start, updated, rendered;
+		float	  time = i * step;
+		float	  angle = 6.2831853f * fmodf(time, EMITTER_PERIOD) / EMITTER_PERIOD;
+
+		if (m_recorder) {
+			m_recorder->GetStream()->Clear();
+			m_recorder->ResetCounters();
+		}
+		else
+			m_software->ResetCounters();
+
+		start = GetClock();
+
+		{
+			TraceScopeClass scope("HeadlessRunnerClass::Update");
+
+			m_particles->SetEmitterPosition(m_emitter, EMITTER_RADIUS * cosf(angle), EMITTER_RADIUS * sinf(angle));
+			m_particles->Frame(step * 0.001f);
+			m_instanceCount = m_particles->BuildInstanceArray(&m_instances[0], (int)m_instances.size());
+		}
+
+		updated = GetClock();
+
+		if (!RenderFrame(time))
+			return false;
+
+		rendered = GetClock();
+
+		frame.time		 = time;
+		frame.updateTime = updated - start;
+		frame.renderTime = rendered - updated;
+		frame.hudTime	 = m_hudEnabled ? m_hudTime : 0.0;
+		frame.particles	 = m_instanceCount;
+		frame.draws		 = m_recorder ? m_recorder->GetDrawCount() : (m_instanceCount > 0 ? 1 : 0) + (m_hudEnabled ? 1 : 0);
+		frame.hash		 = HashFrame();
+
+		m_frames.push_back(frame);
+
+		// The statistics the HUD shows in the next frames: the particles are the animation, their draw the 2D
+		if (m_hudEnabled) {
+			m_stats.AddTime(PERF_ANIMATION, (float)frame.updateTime);
+			m_stats.AddTime(PERF_2D, (float)(frame.renderTime - frame.hudTime));
+			m_stats.EndFrame((float)(frame.updateTime + frame.renderTime));
+		}
+
+		if (imageName && m_software) {
+			ostringstream filename;
+
+			filename << imageName << setw(4) << setfill('0') << i << ".tga";
+
+			if (!m_software->SaveImage(filename.str().c_str()))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+int HeadlessRunnerClass::GetFrameCount()
+{
+	return (int)m_frames.size();
+}
+
+const HeadlessRunnerClass::FrameType& HeadlessRunnerClass::GetFrame(int index)
+{
+	return m_frames[index];
+}
+
+bool HeadlessRunnerClass::SaveTimings(const char *filename)
+{
+	ofstream fout;
+
+	fout.open(filename);
+	if (fout.fail())
+		return false;
+
+	fout << "frame,time,update_ms,render_ms,hud_ms,total_ms,particles,draws,hash\n" << fixed;
+
+	for (size_t i = 0; i < m_frames.size(); i++) {
+		const FrameType &frame = m_frames[i];
+
+		fout << i << ',' << setprecision(3) << frame.time << ',' << setprecision(4) << frame.updateTime << ',' << frame.renderTime << ',' << frame.hudTime << ','
+			 << frame.updateTime + frame.renderTime << ',' << frame.particles << ',' << frame.draws << ','
+			 << hex << setw(16) << setfill('0') << frame.hash << dec << setfill(' ') << '\n';
+	}
+
+	fout.close();
+
+	return !fout.fail();
+}
+
+// The headless run of Main.cpp: 800x600 like the window, and room for the 20000 particles a second of the emitter that live up to 3 seconds.
+bool HeadlessRunnerClass::RunCommandLine(const char *cmdline)
+{
+	HeadlessRunnerClass runner;
+	bool				software = strstr(cmdline, "-software") != 0;
+	bool				trace	 = strstr(cmdline, "-trace") != 0;
+	int					frames	 = (int)GetOption(cmdline, "-frames", 0.0f);
+	float				step	 = GetOption(cmdline, "-fixedstep", 0.0f);
+	bool				result;
+
+	TraceClass::SetThreadName("main");
+
+	result = runner.Initialize(software ? HEADLESS_RUNNER_SOFTWARE : HEADLESS_RUNNER_RECORD, 800, 600,
+							   (int)GetOption(cmdline, "-threads", (float)thread::hardware_concurrency()), 100000);
+	if (result) {
+		runner.SetHudEnabled(strstr(cmdline, "-hud") != 0);
+
+		if (trace)
+			TraceClass::Start();
+
+		result = runner.Run(frames > 0 ? frames : 600, step > 0.0f ? step : 1000.0f / 60.0f, software && strstr(cmdline, "-images") ? "headless_" : 0);
+
+		if (trace) {
+			TraceClass::Stop();
+			result = TraceClass::Export("headless_trace.json") && result;
+		}
+	}
+	if (result)
+		result = runner.SaveTimings("headless.csv");
+
+	runner.Shutdown();
+	TraceClass::Shutdown();
+
+	return result;
+}
+
+float HeadlessRunnerClass::GetOption(const char *cmdline, const char *option, float value)
+{
+	const char *found = strstr(cmdline, option);
+
+	return found ? (float)atof(found + strlen(option)) : value;
+}
+
+// The particles are set up like the ones of GraphicsClass. Made again, the pool is empty and the random numbers start over.
+bool HeadlessRunnerClass::CreateParticles()
+{
+	m_particles->Shutdown();
+
+	if (!m_particles->Initialize(m_maxParticles))
+		return false;
+
+	m_emitter = m_particles->AddEmitter(EMITTER_RADIUS, 0.0f, 20000.0f);
+	m_particles->SetEmitterVelocity(m_emitter, 0.0f, 6.2831853f, 50.0f, 250.0f);
+	m_particles->SetEmitterLifetime(m_emitter, 1.0f, 3.0f);
+	m_particles->SetEmitterSpin(m_emitter, -3.0f, 3.0f);
+	m_particles->SetGravity(0.0f, -98.0f);
+	m_particles->SetDrag(0.5f);
+	m_particles->SetColorCurve(1.0f, 0.9f, 0.5f, 1.0f,   1.0f, 0.2f, 0.0f, 0.0f);
+	m_particles->SetSizeCurve(0.5f, 0.1f);
+
+	return true;
+}
+
+// The particles are drawn like the ones of GraphicsClass, a soft round dot for the texture.
+// The backends that run the code don't get it here, the instancing shader is known by its entry point.
+bool HeadlessRunnerClass::CreateScene()
+{
+	RenderBackendClass::TextureDescType textureDesc;
+	RenderBackendClass::StateDescType	stateDesc;
+	unsigned char						texels[PARTICLE_TEXTURE * PARTICLE_TEXTURE * 4];
+
+	for (int y = 0; y < PARTICLE_TEXTURE; y++)
+		for (int x = 0; x < PARTICLE_TEXTURE; x++) {
+			float dx	= (x + 0.5f) / PARTICLE_TEXTURE * 2.0f - 1.0f;
+			float dy	= (y + 0.5f) / PARTICLE_TEXTURE * 2.0f - 1.0f;
+			float alpha = 1.0f - sqrtf(dx * dx + dy * dy);
+			unsigned char *texel = &texels[(y * PARTICLE_TEXTURE + x) * 4];
+
+			texel[0] = texel[1] = texel[2] = 255;
+			texel[3] = (unsigned char)(alpha > 0.0f ? alpha * 255.0f : 0.0f);
+		}
+
+	textureDesc.width		 = PARTICLE_TEXTURE;
+	textureDesc.height		 = PARTICLE_TEXTURE;
+	textureDesc.format		 = RENDER_FORMAT_RGBA8;
+	textureDesc.renderTarget = false;
+	m_texture = m_backend->CreateTexture(textureDesc, texels, PARTICLE_TEXTURE * 4);
+
+	if (!SpritePassClass::CreateShaders(m_backend, 0, 0, 0, 0, &m_vertexShader, &m_pixelShader))
+		return false;
+
+	// The particles are blended over each other without the depth buffer, like the 2D rendering of GraphicsClass
+	stateDesc.alphaBlending = true;
+	stateDesc.depthTest		= false;
+	stateDesc.depthWrite	= false;
+	stateDesc.cullBack		= true;
+	m_state = m_backend->CreateState(stateDesc);
+
+	if (!m_texture || !m_state)
+		return false;
+
+	return m_particlePass.Initialize(m_backend, PARTICLE_QUAD_SIZE, (int)m_instances.size(), m_vertexShader, m_pixelShader, m_texture, m_state);
+}
+
+// The HUD draws with the vertices and shaders of _shaderFont.vs/ps. Its glyph table has a box for every printable ASCII letter
+// but the space, all of them on a white texture, so the text is drawn as solid boxes with the cost of real text.
+bool HeadlessRunnerClass::CreateHud()
+{
+	typedef RenderBackendClass RB;
+
+	RB::VertexElementType elements[3] = {
+		{ "POSITION", 0,  6, 0,  0, false },
+		{ "TEXCOORD", 0, 16, 0, 12, false },
+		{ "COLOR",	  0,  2, 0, 20, false },
+	};
+
+	GlyphTableClass::GlyphType glyph;
+	RB::BufferDescType		   bufferDesc;
+	RB::TextureDescType		   textureDesc;
+	RB::ShaderDescType		   shaderDesc;
+	unsigned char			   texels[4 * 4 * 4];
+
+	memset(&glyph, 0, sizeof(glyph));
+	m_glyphs.Clear();
+	m_glyphs.SetGlyph(0, glyph);
+
+	glyph.width	 = (float)HUD_LETTER_WIDTH;
+	glyph.height = (float)HUD_LETTER_HEIGHT;
+	glyph.u1	 = 1.0f;
+	glyph.v1	 = 1.0f;
+
+	for (int letter = 1; letter < 95; letter++)
+		m_glyphs.SetGlyph(letter, glyph);
+
+	if (!m_hud.Initialize(&m_glyphs, m_width, m_height))
+		return false;
+
+	m_hudVertices.resize(PerfHudBuilderClass::GetMaxVertexCount());
+
+	bufferDesc.type	   = RENDER_BUFFER_VERTEX;
+	bufferDesc.size	   = (int)(m_hudVertices.size() * sizeof(PerfHudBuilderClass::VertexType));
+	bufferDesc.stride  = 0;
+	bufferDesc.dynamic = true;
+	m_hudBuffer = m_backend->CreateBuffer(bufferDesc, 0);
+
+	bufferDesc.type = RENDER_BUFFER_CONSTANT;
+	bufferDesc.size = sizeof(SpritePassClass::MatrixBufferType);
+	m_hudMatrixBuffer = m_backend->CreateBuffer(bufferDesc, 0);
+
+	memset(texels, 255, sizeof(texels));
+
+	textureDesc.width		 = 4;
+	textureDesc.height		 = 4;
+	textureDesc.format		 = RENDER_FORMAT_RGBA8;
+	textureDesc.renderTarget = false;
+	m_hudTexture = m_backend->CreateTexture(textureDesc, texels, 4 * 4);
+
+	memset(&shaderDesc, 0, sizeof(shaderDesc));
+	shaderDesc.stage		= RENDER_STAGE_VERTEX;
+	shaderDesc.entry		= "FontVertexShader";
+	shaderDesc.elements		= elements;
+	shaderDesc.elementCount = 3;
+	m_hudVertexShader = m_backend->CreateShader(shaderDesc);
+
+	memset(&shaderDesc, 0, sizeof(shaderDesc));
+	shaderDesc.stage = RENDER_STAGE_PIXEL;
+	shaderDesc.entry = "FontPixelShader";
+	m_hudPixelShader = m_backend->CreateShader(shaderDesc);
+
+	return m_hudBuffer && m_hudMatrixBuffer && m_hudTexture && m_hudVertexShader && m_hudPixelShader;
+}
+
+// RenderHud does what PerfHudClass::Render does: the text when it is due, the graph of every frame, one upload and one draw.
+// The text is refreshed by the time of the frame rather than by the clock, so the runs stay the same frames.
+bool HeadlessRunnerClass::RenderHud(float time)
+{
+	unsigned int stride = sizeof(PerfHudBuilderClass::VertexType), offset = 0;
+	double		 start	= GetClock();
+	int			 vertexCount;
+
+	if (m_lastTextTime < 0.0f || time - m_lastTextTime >= HUD_TEXT_PERIOD) {
+		m_hud.BuildText(&m_stats, 0, (float)m_hudTime);
+		m_lastTextTime = time;
+	}
+
+	vertexCount = m_hud.WriteVertices(&m_stats, &m_hudVertices[0]);
+
+	if (!m_backend->UpdateBuffer(m_hudBuffer, &m_hudVertices[0], vertexCount * stride))
+		return false;
+
+	m_backend->SetState(m_state);
+	m_backend->SetShaders(m_hudVertexShader, m_hudPixelShader);
+	m_backend->SetVertexBuffers(0, 1, &m_hudBuffer, &stride, &offset);
+	m_backend->SetConstantBuffers(RENDER_STAGE_VERTEX, 0, 1, &m_hudMatrixBuffer);
+	m_backend->SetTextures(RENDER_STAGE_PIXEL, 0, 1, &m_hudTexture);
+	m_backend->Draw(vertexCount, 0);
+
+	m_hudTime = GetClock() - start;
+
+	return true;
+}
+
+// The camera of GraphicsClass: at 10 units in front of the screen plane, with the orthographic projection of the 2D rendering.
+// The matrices go into the constant buffer transposed, like the shader classes write them.
+bool HeadlessRunnerClass::RenderFrame(float time)
+{
+	TraceScopeClass scope("HeadlessRunnerClass::RenderFrame");
+
+	SpritePassClass::MatrixBufferType matrices;
+	float							  color[4]	 = { 0.0f, 0.0f, 0.0f, 1.0f };
+	float							  screenNear = 0.1f, screenDepth = 1000.0f;
+
+	memset(&matrices, 0, sizeof(matrices));
+
+	for (int i = 0; i < 4; i++) {
+		matrices.world.m[i][i]		= 1.0f;
+		matrices.view.m[i][i]		= 1.0f;
+		matrices.projection.m[i][i] = 1.0f;
+	}
+
+	matrices.view.m[2][3]		= 10.0f;
+	matrices.projection.m[0][0] = 2.0f / m_width;
+	matrices.projection.m[1][1] = 2.0f / m_height;
+	matrices.projection.m[2][2] = 1.0f / (screenDepth - screenNear);
+	matrices.projection.m[2][3] = screenNear / (screenNear - screenDepth);
+
+	m_backend->BeginFrame(color);
+
+	m_particlePass.SetInstances(&m_instances[0], m_instanceCount);
+	m_particlePass.SetMatrices(matrices);
+
+	if (!m_particlePass.Render(m_backend))
+		return false;
+
+	if (m_hudEnabled) {
+		if (!m_backend->UpdateBuffer(m_hudMatrixBuffer, &matrices, sizeof(matrices)))
+			return false;
+
+		if (!RenderHud(time))
+			return false;
+	}
+
+	m_backend->EndFrame();
+
+	return true;
+}
+
+// FNV-1a over the calls the frame recorded, or over its pixels
+unsigned long long HeadlessRunnerClass::HashFrame()
+{
+	unsigned long long	 hash = 14695981039346656037ULL;
+	const unsigned char *data;
+	int					 size;
+
+	if (m_recorder) {
+		data = m_recorder->GetStream()->GetData();
+		size = m_recorder->GetStream()->GetSize();
+	}
+	else {
+		m_pixels.resize(m_width * m_height * 4);
+		m_software->GetPixels(&m_pixels[0]);
+
+		data = &m_pixels[0];
+		size = (int)m_pixels.size();
+	}
+
+	for (int i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+// The clock in milliseconds: the performance counter on Windows, where the standard clocks of VS2013 are as coarse as the system time.
+double HeadlessRunnerClass::GetClock()
+{
+#ifdef _WIN32
+	LARGE_INTEGER counter, frequency;
+
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return counter.QuadPart * 1000.0 / frequency.QuadPart;
+#else
+	return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
@@ -0,0 +1,122 @@
+// --------------------------------------------------------------------------------------------------------
+// HeadlessRunnerClass draws frames without a window, a device or the wall clock, for performance runs that can be repeated anywhere.
+// Frame n is at n times a fixed step, so two runs with the same arguments do exactly the same work and draw the same frames.
+//
+// The frame is the particles of GraphicsClass: the same emitter and curves, the emitter going round in a circle
+// instead of following the mouse, drawn by the same SpritePassClass with the instancing texture shader. It goes to one of two backends:
+// - HEADLESS_RUNNER_RECORD, a HeadlessBackendClass: the calls are recorded and nothing is drawn, the time is the CPU side of the frame;
+// - HEADLESS_RUNNER_SOFTWARE, a SoftwareBackendClass: the frame is drawn on the CPU, and can be saved as a TGA image.
+// Every frame keeps its CPU times, the simulation and the rendering (through EndFrame) apart, its draws,
+// and a hash of what it made: the recorded calls or the pixels. Two runs that drew the same have the same hashes.
+// SaveTimings writes the frames as CSV, one line each. Every Run starts the particles over, with the random numbers of the emitter.
+// RunCommandLine is the headless run of the program, from WinMain or from HeadlessMain.cpp on the machines without Windows.
+//
+// SetHudEnabled adds the performance HUD of PerfHudClass over the particles: the statistics of the frames and their graph,
+// built by a PerfHudBuilderClass and drawn with the font shader in one draw. The letters are plain boxes, no font is loaded.
+// Its CPU time, from the statistics to the draw, is the HUD time of the frame, the cost PerfHudClass adds to a frame.
+// The text shows the measured times, so the hashes of two runs with the HUD differ. Without it the HUD costs nothing.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _HEADLESSRUNNERCLASS_H_
+#define _HEADLESSRUNNERCLASS_H_
+
+#include <vector>
+using namespace std;
+
+#include "__renderBackendClass.h"
+#include "__headlessBackendClass.h"
+#include "__softwareBackendClass.h"
+#include "__particleSystemClass.h"
+#include "__spritePassClass.h"
+#include "__perfHudBuilderClass.h"
+
+// The backends
+#define HEADLESS_RUNNER_RECORD	 0
+#define HEADLESS_RUNNER_SOFTWARE 1
+
+
+
+class HeadlessRunnerClass {
+ public:
+	struct FrameType {
+		float			   time;				// in milliseconds from the start
+		double			   updateTime;			// the CPU times of the frame, in milliseconds
+		double			   renderTime;
+		double			   hudTime;				// part of the render time, 0 without the HUD
+		int				   particles;
+		int				   draws;
+		unsigned long long hash;
+	};
+
+ public:
+	HeadlessRunnerClass();
+	HeadlessRunnerClass(const HeadlessRunnerClass &);
+   ~HeadlessRunnerClass();
+
+	// Initialize takes the backend, the size of the frames, the threads of the software backend and the most particles.
+	bool Initialize(int, int, int, int, int);
+	void Shutdown();
+
+	// SetHudEnabled shows the HUD in the frames of the next runs.
+	void SetHudEnabled(bool);
+
+	// Run draws the frames from the time 0 with the step in milliseconds. With a name the software frames are saved,
+	// the number of the frame and ".tga" added to it. The frames of an earlier run are forgotten.
+	bool Run(int, float, const char *);
+
+	int				 GetFrameCount();
+	const FrameType& GetFrame(int);
+
+	// SaveTimings writes the frames of the last run as CSV with a header line.
+	bool SaveTimings(const char *);
+
+	// RunCommandLine runs the frames of a fixed step, -fixedstep <ms> (16.7 by default) -frames <count> (600), timed into headless.csv:
+	// recorded by the headless backend, or drawn by the software one with -software on -threads <count>, all the cores by default.
+	// -images saves the software frames as headless_0000.tga ..., -hud adds the performance HUD and its time per frame (the hud_ms column),
+	// -trace traces the whole run into headless_trace.json. It returns false when the run or a file fails.
+	static bool RunCommandLine(const char *);
+
+	// GetOption gives the number after an option of a command line, or the default without the option.
+	static float GetOption(const char *, const char *, float);
+
+ private:
+	bool			   CreateParticles();
+	bool			   CreateScene();
+	bool			   CreateHud();
+	bool			   RenderFrame(float);
+	bool			   RenderHud(float);
+	unsigned long long HashFrame();
+
+	static double	   GetClock();
+
+ private:
+	int						m_mode;
+	int						m_width, m_height;
+	RenderBackendClass	   *m_backend;
+	HeadlessBackendClass   *m_recorder;
+	SoftwareBackendClass   *m_software;
+
+	ParticleSystemClass	   *m_particles;
+	int						m_maxParticles;
+	int						m_emitter;
+	vector<ParticleSystemClass::InstanceType> m_instances;
+	int						m_instanceCount;
+
+	SpritePassClass			m_particlePass;
+	RenderBackendClass::HandleType m_vertexShader, m_pixelShader, m_texture, m_state;
+
+	bool					m_hudEnabled;
+	PerfStatsClass			m_stats;
+	GlyphTableClass			m_glyphs;
+	PerfHudBuilderClass		m_hud;
+	vector<PerfHudBuilderClass::VertexType> m_hudVertices;
+	float					m_lastTextTime;
+	double					m_hudTime;
+	RenderBackendClass::HandleType m_hudVertexShader, m_hudPixelShader, m_hudBuffer, m_hudTexture, m_hudMatrixBuffer;
+
+	vector<FrameType>		m_frames;
+	vector<unsigned char>	m_pixels;
+};
+
+#endif
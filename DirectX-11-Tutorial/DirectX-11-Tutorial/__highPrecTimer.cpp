@@ -2,6 +2,7 @@
 
 HighPrecisionTimer::HighPrecisionTimer()
 {
+	m_fixedStep = 0.0f;
 }
 
 HighPrecisionTimer::HighPrecisionTimer(const HighPrecisionTimer& other)
@@ -52,9 +53,14 @@ bool HighPrecisionTimer::Frame()
 
 	QueryPerformanceCounter((LARGE_INTEGER*) &currentTime);
 	timeDifference = (float)(currentTime - m_startTime);
-	m_frameTime	   = timeDifference / m_ticksPerMs;
 	m_startTime	   = currentTime;
 
+	// The fixed step stands for the time that passed, in ticks like the interval
+	if (m_fixedStep > 0.0f)
+		timeDifference = m_fixedStep * m_ticksPerMs;
+
+	m_frameTime = timeDifference / m_ticksPerMs;
+
 	m_TimePassed += timeDifference;
 
 	if( m_TimePassed >= m_Interval ) {
@@ -70,3 +76,8 @@ float HighPrecisionTimer::GetTime()
 {
 	return m_frameTime;
 }
+
+void HighPrecisionTimer::SetFixedStep(float step)
+{
+	m_fixedStep = step > 0.0f ? step : 0.0f;
+}
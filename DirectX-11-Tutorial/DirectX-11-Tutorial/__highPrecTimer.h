@@ -20,6 +20,10 @@ class HighPrecisionTimer {
 	bool  Frame();
 	float GetTime();
 
+	// With a fixed step every frame takes that many milliseconds instead of the time that really passed,
+	// so a run animates the same whatever the machine. 0 goes back to the real time.
+	void  SetFixedStep(float);
+
  private:
 	INT64 m_frequency;
 	float m_ticksPerMs;
@@ -28,6 +32,8 @@ class HighPrecisionTimer {
 
 	float m_Interval;
 	float m_TimePassed;
+
+	float m_fixedStep;
 };
 
 #endif
@@ -0,0 +1,131 @@
+#include "__layerCacheClass.h"
+
+LayerCacheClass::LayerCacheClass()
+{
+	m_redrawCount = 0;
+	m_reuseCount  = 0;
+}
+
+LayerCacheClass::LayerCacheClass(const LayerCacheClass& other)
+{
+}
+
+LayerCacheClass::~LayerCacheClass()
+{
+}
+
+// The targets are owned by the caller, Shutdown only forgets them.
+void LayerCacheClass::Shutdown()
+{
+	m_layers.clear();
+
+	return;
+}
+
+// AddLayer registers a new layer drawn into the given target and returns its index. A new layer is always dirty.
+int LayerCacheClass::AddLayer(LayerTargetClass *target)
+{
+	LayerType layer;
+
+	layer.target  = target;
+	layer.dirty	  = true;
+	layer.drawing = false;
+
+	m_layers.push_back(layer);
+
+	return (int)m_layers.size() - 1;
+}
+
+// WatchVersion makes the layer depend on the counter: any change of its value marks the layer dirty.
+void LayerCacheClass::WatchVersion(int layer, const unsigned int *version)
+{
+	m_layers[layer].versions.push_back(version);
+	m_layers[layer].seen.push_back(*version);
+	m_layers[layer].dirty = true;
+
+	return;
+}
+
+void LayerCacheClass::Invalidate(int layer)
+{
+	m_layers[layer].dirty = true;
+
+	return;
+}
+
+void LayerCacheClass::InvalidateAll()
+{
+	for (size_t i = 0; i < m_layers.size(); i++)
+		m_layers[i].dirty = true;
+
+	return;
+}
+
+// IsDirty compares the watched counters with the values seen at the last redraw.
+// A clean layer counts as reused, as the caller will composite the cached target instead of drawing its content.
+bool LayerCacheClass::IsDirty(int layer)
+{
+	LayerType &l = m_layers[layer];
+
+	for (size_t i = 0; !l.dirty && i < l.versions.size(); i++)
+		if (*l.versions[i] != l.seen[i])
+			l.dirty = true;
+
+	if (!l.dirty)
+		m_reuseCount++;
+
+	return l.dirty;
+}
+
+// BeginLayer binds and clears the target of the layer. The content drawn until EndLayer is what gets cached.
+bool LayerCacheClass::BeginLayer(int layer)
+{
+	LayerType &l = m_layers[layer];
+
+	if (!l.target->BeginLayer())
+		return false;
+
+	l.drawing = true;
+
+	return true;
+}
+
+// EndLayer restores the back buffer and remembers the current values of the counters.
+// Drawing the layer may itself bump a counter (e.g. a bitmap updating its vertex buffer on its first Render),
+// so the values are taken here, after the drawing, not in BeginLayer.
+void LayerCacheClass::EndLayer(int layer)
+{
+	LayerType &l = m_layers[layer];
+
+	if (!l.drawing)
+		return;
+
+	l.target->EndLayer();
+
+	for (size_t i = 0; i < l.versions.size(); i++)
+		l.seen[i] = *l.versions[i];
+
+	l.dirty	  = false;
+	l.drawing = false;
+	m_redrawCount++;
+
+	return;
+}
+
+void LayerCacheClass::ResetCounters()
+{
+	m_redrawCount = 0;
+	m_reuseCount  = 0;
+
+	return;
+}
+
+int LayerCacheClass::GetRedrawCount()
+{
+	return m_redrawCount;
+}
+
+int LayerCacheClass::GetReuseCount()
+{
+	return m_reuseCount;
+}
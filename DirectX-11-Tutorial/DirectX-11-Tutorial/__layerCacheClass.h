@@ -0,0 +1,72 @@
+// --------------------------------------------------------------------------------------------------------
+// LayerCacheClass keeps static 2D layers in offscreen targets, so they are drawn only when something in them changes.
+// Each layer watches a set of version counters (BitmapClass, TextOutClass, Sprite all provide one).
+// When any of them has moved since the layer was last drawn, the layer is dirty and the caller redraws it into its target.
+// Otherwise the cached target is simply composited onto the screen as one quad.
+//
+// The cache only talks to its targets through LayerTargetClass, so the invalidation logic does not need Direct3D
+// and can be driven by a mock target that just counts the Begin / End calls.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _LAYERCACHECLASS_H_
+#define _LAYERCACHECLASS_H_
+
+#include <vector>
+using namespace std;
+
+
+
+// LayerTargetClass is what a layer is drawn into. RenderTextureClass is the Direct3D implementation.
+class LayerTargetClass {
+ public:
+	virtual ~LayerTargetClass() {}
+
+	// BeginLayer makes the target the current render target and clears it, EndLayer goes back to the back buffer.
+	virtual bool BeginLayer() = 0;
+	virtual void EndLayer()	  = 0;
+};
+
+
+
+class LayerCacheClass {
+ private:
+	struct LayerType {
+		LayerTargetClass			*target;
+		vector<const unsigned int*>	 versions;		// the counters this layer depends on
+		vector<unsigned int>		 seen;			// their values when the layer was last drawn
+		bool						 dirty;
+		bool						 drawing;
+	};
+
+ public:
+	LayerCacheClass();
+	LayerCacheClass(const LayerCacheClass &);
+   ~LayerCacheClass();
+
+	void Shutdown();
+
+	int  AddLayer(LayerTargetClass *);
+	void WatchVersion(int, const unsigned int *);
+
+	// Invalidate forces the layer to be redrawn, e.g. after a resize or when the content is not covered by a version counter.
+	void Invalidate(int);
+	void InvalidateAll();
+
+	// IsDirty checks the watched counters. If it returns true the caller draws the layer between BeginLayer and EndLayer.
+	bool IsDirty(int);
+	bool BeginLayer(int);
+	void EndLayer(int);
+
+	// Counters since the last ResetCounters: how many layers were redrawn and how many were reused from the cache.
+	void ResetCounters();
+	int  GetRedrawCount();
+	int  GetReuseCount();
+
+ private:
+	vector<LayerType> m_layers;
+
+	int m_redrawCount;
+	int m_reuseCount;
+};
+
+#endif
@@ -0,0 +1,474 @@
+#include "__lightClusterClass.h"
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include <xmmintrin.h>
+
+LightClusterClass::LightClusterClass()
+{
+	m_clustersX			  = 0;
+	m_clustersY			  = 0;
+	m_clustersZ			  = 0;
+	m_rowStride			  = 0;
+	m_maxLightsPerCluster = 0;
+	m_tanX				  = 1.0f;
+	m_tanY				  = 1.0f;
+	m_near				  = 0.1f;
+	m_far				  = 1000.0f;
+	m_indexCount		  = 0;
+	m_threadCount		  = 1;
+	m_generation		  = 0;
+	m_pending			  = 0;
+	m_quit				  = false;
+}
+
+LightClusterClass::LightClusterClass(const LightClusterClass& other)
+{
+}
+
+LightClusterClass::~LightClusterClass()
+{
+}
+
+bool LightClusterClass::Initialize(int clustersX, int clustersY, int clustersZ, int maxLightsPerCluster, int threadCount)
+{
+	int clusterCount;
+
+	if (clustersX <= 0 || clustersY <= 0 || clustersZ <= 0 || maxLightsPerCluster <= 0)
+		return false;
+
+	m_clustersX			  = clustersX;
+	m_clustersY			  = clustersY;
+	m_clustersZ			  = clustersZ;
+	m_rowStride			  = (clustersX + 3) & ~3;
+	m_maxLightsPerCluster = maxLightsPerCluster;
+
+	// There is no use for more threads than slices.
+	m_threadCount = threadCount < 1 ? 1 : (threadCount > clustersZ ? clustersZ : threadCount);
+
+	clusterCount = clustersX * clustersY * clustersZ;
+
+	m_minX.resize(m_rowStride * clustersY * clustersZ);
+	m_maxX.resize(m_minX.size());
+	m_minY.resize(m_minX.size());
+	m_maxY.resize(m_minX.size());
+	m_sliceDepth.resize(clustersZ + 1);
+
+	m_clusterLights.resize(clusterCount * maxLightsPerCluster);
+	m_clusterCounts.assign(clusterCount, 0);
+	m_dropped.assign(m_threadCount, 0);
+
+	m_grid.assign(clusterCount * 2, 0);
+	m_indices.resize(clusterCount * maxLightsPerCluster);
+	m_indexCount = 0;
+
+	BuildBounds();
+
+	m_quit		 = false;
+	m_generation = 0;
+	m_pending	 = 0;
+
+	for (int i = 1; i < m_threadCount; i++)
+		m_workers.push_back(thread(&LightClusterClass::WorkerThread, this, i));
+
+	return true;
+}
+
+void LightClusterClass::Shutdown()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_quit = true;
+	}
+
+	m_wakeUp.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+		m_workers[i].join();
+
+	m_workers.clear();
+
+	m_lights.clear();
+	m_clusterLights.clear();
+	m_indices.clear();
+
+	return;
+}
+
+void LightClusterClass::SetFrustum(float tanHalfFovX, float tanHalfFovY, float nearZ, float farZ)
+{
+	m_tanX = tanHalfFovX;
+	m_tanY = tanHalfFovY;
+	m_near = nearZ;
+	m_far  = farZ;
+
+	BuildBounds();
+
+	return;
+}
+
+void LightClusterClass::Bin(const ClusterLightType *lights, int lightCount, const float *view)
+{
+	float scale, bias, sphere[4], zMin, zMax, lo, hi;
+	int	  clusterCount = GetClusterCount(), offset;
+
+	GetDepthParameters(&scale, &bias);
+
+	// The bounds of the lights are computed once, every thread uses them.
+	m_lights.resize(lightCount);
+
+	for (int i = 0; i < lightCount; i++) {
+		LightBoundsType &b = m_lights[i];
+
+		GetBoundingSphere(lights[i], view, sphere);
+
+		b.x		 = sphere[0];
+		b.y		 = sphere[1];
+		b.z		 = sphere[2];
+		b.radius = sphere[3];
+
+		zMin = b.z - b.radius > m_near ? b.z - b.radius : m_near;
+		zMax = b.z + b.radius < m_far  ? b.z + b.radius : m_far;
+
+		// Behind the camera or past the far depth, the light reaches no cluster.
+		b.firstSlice = 0;
+		b.lastSlice	 = -1;
+
+		if (zMin > zMax)
+			continue;
+
+		b.firstSlice = (int)floorf(logf(zMin) * scale + bias);
+		b.lastSlice	 = (int)floorf(logf(zMax) * scale + bias);
+
+		// The screen range of the sphere: for every point of it between zMin and zMax, x / z lies between these two.
+		lo = (b.x - b.radius) / ((b.x - b.radius < 0.0f ? zMin : zMax) * m_tanX);
+		hi = (b.x + b.radius) / ((b.x + b.radius > 0.0f ? zMin : zMax) * m_tanX);
+
+		b.firstTileX = (int)floorf((lo + 1.0f) * 0.5f * m_clustersX);
+		b.lastTileX	 = (int)floorf((hi + 1.0f) * 0.5f * m_clustersX);
+
+		lo = (b.y - b.radius) / ((b.y - b.radius < 0.0f ? zMin : zMax) * m_tanY);
+		hi = (b.y + b.radius) / ((b.y + b.radius > 0.0f ? zMin : zMax) * m_tanY);
+
+		// The tile rows go down the screen.
+		b.firstTileY = (int)floorf((1.0f - hi) * 0.5f * m_clustersY);
+		b.lastTileY	 = (int)floorf((1.0f - lo) * 0.5f * m_clustersY);
+
+		if (b.firstSlice < 0)				 b.firstSlice = 0;
+		if (b.lastSlice	 > m_clustersZ - 1)	 b.lastSlice  = m_clustersZ - 1;
+		if (b.firstTileX < 0)				 b.firstTileX = 0;
+		if (b.lastTileX	 > m_clustersX - 1)	 b.lastTileX  = m_clustersX - 1;
+		if (b.firstTileY < 0)				 b.firstTileY = 0;
+		if (b.lastTileY	 > m_clustersY - 1)	 b.lastTileY  = m_clustersY - 1;
+	}
+
+	// The workers take their slices, the calling thread bins the first ones.
+	if (m_threadCount > 1) {
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_pending = m_threadCount - 1;
+			m_generation++;
+		}
+
+		m_wakeUp.notify_all();
+	}
+
+	BinSlices(0);
+
+	if (m_threadCount > 1) {
+		unique_lock<mutex> lock(m_mutex);
+
+		while (m_pending > 0)
+			m_finished.wait(lock);
+	}
+
+	// The lists of the clusters are packed one after the other.
+	offset = 0;
+
+	for (int i = 0; i < clusterCount; i++) {
+		m_grid[i * 2]	  = offset;
+		m_grid[i * 2 + 1] = m_clusterCounts[i];
+
+		if (m_clusterCounts[i] > 0)
+			memcpy(&m_indices[offset], &m_clusterLights[i * m_maxLightsPerCluster], m_clusterCounts[i] * sizeof(unsigned int));
+
+		offset += m_clusterCounts[i];
+	}
+
+	m_indexCount = offset;
+
+	return;
+}
+
+const unsigned int* LightClusterClass::GetGrid()
+{
+	return &m_grid[0];
+}
+
+const unsigned int* LightClusterClass::GetIndices()
+{
+	return &m_indices[0];
+}
+
+int LightClusterClass::GetIndexCount()
+{
+	return m_indexCount;
+}
+
+int LightClusterClass::GetDroppedCount()
+{
+	int dropped = 0;
+
+	for (size_t i = 0; i < m_dropped.size(); i++)
+		dropped += m_dropped[i];
+
+	return dropped;
+}
+
+int LightClusterClass::GetClusterCount()
+{
+	return m_clustersX * m_clustersY * m_clustersZ;
+}
+
+void LightClusterClass::GetClusterCounts(int *clustersX, int *clustersY, int *clustersZ)
+{
+	*clustersX = m_clustersX;
+	*clustersY = m_clustersY;
+	*clustersZ = m_clustersZ;
+
+	return;
+}
+
+int LightClusterClass::GetCluster(float x, float y, float z)
+{
+	float scale, bias, ndcX, ndcY;
+	int	  tileX, tileY, slice;
+
+	if (z < m_near || z >= m_far)
+		return -1;
+
+	ndcX = x / (z * m_tanX);
+	ndcY = y / (z * m_tanY);
+
+	if (ndcX < -1.0f || ndcX > 1.0f || ndcY < -1.0f || ndcY > 1.0f)
+		return -1;
+
+	GetDepthParameters(&scale, &bias);
+
+	slice = (int)floorf(logf(z) * scale + bias);
+	tileX = (int)floorf((ndcX + 1.0f) * 0.5f * m_clustersX);
+	tileY = (int)floorf((1.0f - ndcY) * 0.5f * m_clustersY);
+
+	if (slice < 0)				slice = 0;
+	if (slice > m_clustersZ - 1) slice = m_clustersZ - 1;
+	if (tileX > m_clustersX - 1) tileX = m_clustersX - 1;
+	if (tileY > m_clustersY - 1) tileY = m_clustersY - 1;
+
+	return (slice * m_clustersY + tileY) * m_clustersX + tileX;
+}
+
+// The slice of a depth z is floor(log(z) * scale + bias).
+void LightClusterClass::GetDepthParameters(float *scale, float *bias)
+{
+	float logRatio = logf(m_far / m_near);
+
+	*scale = m_clustersZ / logRatio;
+	*bias  = -m_clustersZ * logf(m_near) / logRatio;
+
+	return;
+}
+
+void LightClusterClass::GetClusterBounds(int cluster, float *min, float *max)
+{
+	int tileX = cluster % m_clustersX;
+	int tileY = cluster / m_clustersX % m_clustersY;
+	int slice = cluster / (m_clustersX * m_clustersY);
+	int index = (slice * m_clustersY + tileY) * m_rowStride + tileX;
+
+	min[0] = m_minX[index];
+	min[1] = m_minY[index];
+	min[2] = m_sliceDepth[slice];
+	max[0] = m_maxX[index];
+	max[1] = m_maxY[index];
+	max[2] = m_sliceDepth[slice + 1];
+
+	return;
+}
+
+// A point light is its own sphere. A narrow cone fits in the sphere through its tip and its base circle,
+// a wide one (more than 45 degrees) in the sphere around its base circle.
+void LightClusterClass::GetBoundingSphere(const ClusterLightType &light, const float *view, float *sphere)
+{
+	float center[3], radius, sine;
+
+	center[0] = light.position[0];
+	center[1] = light.position[1];
+	center[2] = light.position[2];
+	radius	  = light.range;
+
+	if (light.spotCos > 0.0f) {
+		if (light.spotCos > 0.70710678f) {
+			radius = light.range / (2.0f * light.spotCos);
+
+			for (int i = 0; i < 3; i++)
+				center[i] += light.direction[i] * radius;
+		}
+		else {
+			sine = sqrtf(1.0f - light.spotCos * light.spotCos);
+
+			for (int i = 0; i < 3; i++)
+				center[i] += light.direction[i] * light.range * light.spotCos;
+
+			radius = light.range * sine;
+		}
+	}
+
+	for (int i = 0; i < 3; i++)
+		sphere[i] = center[0] * view[i] + center[1] * view[4 + i] + center[2] * view[8 + i] + view[12 + i];
+
+	sphere[3] = radius;
+
+	return;
+}
+
+// BuildBounds makes the bounding boxes of the clusters: the frustum of a tile between the two depths of a slice.
+// The columns that only pad a row to the SSE width get empty boxes, which no sphere touches.
+void LightClusterClass::BuildBounds()
+{
+	float z0, z1, left, right, top, bottom;
+	int	  index;
+
+	if (m_clustersZ == 0)
+		return;
+
+	for (int k = 0; k <= m_clustersZ; k++)
+		m_sliceDepth[k] = m_near * powf(m_far / m_near, (float)k / m_clustersZ);
+
+	for (int k = 0; k < m_clustersZ; k++) {
+		z0 = m_sliceDepth[k];
+		z1 = m_sliceDepth[k + 1];
+
+		for (int j = 0; j < m_clustersY; j++) {
+			top	   = (1.0f - 2.0f * j / m_clustersY)	   * m_tanY;
+			bottom = (1.0f - 2.0f * (j + 1) / m_clustersY) * m_tanY;
+
+			for (int i = 0; i < m_rowStride; i++) {
+				index = (k * m_clustersY + j) * m_rowStride + i;
+
+				if (i >= m_clustersX) {
+					m_minX[index] = m_minY[index] = FLT_MAX;
+					m_maxX[index] = m_maxY[index] = -FLT_MAX;
+					continue;
+				}
+
+				left  = (-1.0f + 2.0f * i / m_clustersX)	   * m_tanX;
+				right = (-1.0f + 2.0f * (i + 1) / m_clustersX) * m_tanX;
+
+				m_minX[index] = left   * z0 < left	 * z1 ? left   * z0 : left	 * z1;
+				m_maxX[index] = right  * z0 > right	 * z1 ? right  * z0 : right	 * z1;
+				m_minY[index] = bottom * z0 < bottom * z1 ? bottom * z0 : bottom * z1;
+				m_maxY[index] = top	   * z0 > top	 * z1 ? top	   * z0 : top	 * z1;
+			}
+		}
+	}
+
+	return;
+}
+
+// BinSlices tests the lights against the clusters of the slices of one thread.
+// The distance from the sphere center to a box is the length of how far the center is outside the box on every axis.
+void LightClusterClass::BinSlices(int threadIndex)
+{
+	int	   firstSlice = threadIndex * m_clustersZ / m_threadCount;
+	int	   endSlice	  = (threadIndex + 1) * m_clustersZ / m_threadCount;
+	int	   tilesPerSlice = m_clustersX * m_clustersY;
+	int	   dropped = 0, k0, k1, index, cluster;
+	float  dz, radius2;
+	__m128 zero = _mm_setzero_ps();
+
+	memset(&m_clusterCounts[firstSlice * tilesPerSlice], 0, (endSlice - firstSlice) * tilesPerSlice * sizeof(unsigned int));
+
+	for (int l = 0; l < (int)m_lights.size(); l++) {
+		const LightBoundsType &b = m_lights[l];
+
+		k0 = b.firstSlice > firstSlice	  ? b.firstSlice : firstSlice;
+		k1 = b.lastSlice  < endSlice - 1 ? b.lastSlice	: endSlice - 1;
+
+		if (k0 > k1)
+			continue;
+
+		__m128 x = _mm_set1_ps(b.x);
+		__m128 y = _mm_set1_ps(b.y);
+
+		radius2 = b.radius * b.radius;
+
+		for (int k = k0; k <= k1; k++) {
+			dz = m_sliceDepth[k] - b.z;
+
+			if (b.z - m_sliceDepth[k + 1] > dz)
+				dz = b.z - m_sliceDepth[k + 1];
+
+			if (dz < 0.0f)
+				dz = 0.0f;
+
+			if (dz * dz > radius2)
+				continue;
+
+			__m128 rest = _mm_set1_ps(radius2 - dz * dz);
+
+			for (int j = b.firstTileY; j <= b.lastTileY; j++)
+				for (int i = b.firstTileX & ~3; i <= b.lastTileX; i += 4) {
+					index = (k * m_clustersY + j) * m_rowStride + i;
+
+					__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_minX[index]), x), _mm_sub_ps(x, _mm_loadu_ps(&m_maxX[index]))), zero);
+					__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_minY[index]), y), _mm_sub_ps(y, _mm_loadu_ps(&m_maxY[index]))), zero);
+					__m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+					int mask = _mm_movemask_ps(_mm_cmple_ps(d2, rest));
+
+					for (int n = 0; n < 4; n++)
+						if ((mask & (1 << n)) && i + n >= b.firstTileX && i + n <= b.lastTileX) {
+							cluster = (k * m_clustersY + j) * m_clustersX + i + n;
+
+							if (m_clusterCounts[cluster] < (unsigned int)m_maxLightsPerCluster)
+								m_clusterLights[cluster * m_maxLightsPerCluster + m_clusterCounts[cluster]++] = l;
+							else
+								dropped++;
+						}
+				}
+		}
+	}
+
+	m_dropped[threadIndex] = dropped;
+
+	return;
+}
+
+void LightClusterClass::WorkerThread(int threadIndex)
+{
+	int generation = 0;
+
+	while (true) {
+		{
+			unique_lock<mutex> lock(m_mutex);
+
+			while (!m_quit && m_generation == generation)
+				m_wakeUp.wait(lock);
+
+			if (m_quit)
+				return;
+
+			generation = m_generation;
+		}
+
+		BinSlices(threadIndex);
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_pending--;
+		}
+
+		m_finished.notify_one();
+	}
+}
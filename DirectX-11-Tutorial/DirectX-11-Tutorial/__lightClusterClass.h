@@ -0,0 +1,123 @@
+// --------------------------------------------------------------------------------------------------------
+// LightClusterClass assigns point and spot lights to the clusters of the view frustum, so the pixel shader
+// only loops over the lights that can reach the pixel instead of all of them.
+//
+// The frustum is cut into clustersX x clustersY tiles on the screen and clustersZ slices in depth; the slices get thicker
+// with the distance (slice k starts at near * (far / near) ^ (k / clustersZ)), so the clusters are roughly cubes.
+// Every light is bounded by a sphere in view space (a spot light by the sphere around its cone). The tiles and slices
+// the sphere can project onto are found first, and only the bounding boxes of these clusters are tested against the sphere,
+// four clusters at a time with SSE.
+//
+// The slices are split between the calling thread and the worker threads; every cluster is written by one thread only,
+// in the order of the lights, so the result doesn't depend on the number of threads.
+// The result is the layout the pixel shader reads: an (offset, count) pair per cluster into one list of light indices.
+// A cluster keeps at most maxLightsPerCluster lights, the others are counted as dropped.
+//
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _LIGHTCLUSTERCLASS_H_
+#define _LIGHTCLUSTERCLASS_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+// A point or a spot light, in world space. The layout is the one of the light buffer of the pixel shader.
+struct ClusterLightType {
+	float position[3];
+	float range;		// the light falls to zero at this distance
+	float color[3];
+	float spotCos;		// the cosine of the half angle of the cone, -1 for a point light
+	float direction[3];	// where a spot light points, normalized
+	float padding;
+};
+
+
+
+class LightClusterClass {
+ private:
+	// The view space bounding sphere of a light and the range of clusters it may touch.
+	struct LightBoundsType {
+		float x, y, z, radius;
+		int	  firstSlice, lastSlice;
+		int	  firstTileX, lastTileX;
+		int	  firstTileY, lastTileY;
+	};
+
+ public:
+	LightClusterClass();
+	LightClusterClass(const LightClusterClass &);
+   ~LightClusterClass();
+
+	// Initialize takes the number of clusters, the most lights a cluster keeps and the number of threads (1 bins on the calling thread only).
+	bool Initialize(int, int, int, int, int);
+	void Shutdown();
+
+	// SetFrustum takes the tangents of half the horizontal and the vertical field of view, and the near and the far depth of the clusters.
+	// For a projection matrix P these are 1 / P._11 and 1 / P._22.
+	void SetFrustum(float, float, float, float);
+
+	// Bin assigns the lights to the clusters. The view matrix is 16 floats in the D3DX order (row vectors, translation in the last row).
+	void Bin(const ClusterLightType *, int, const float *);
+
+	// The result: two unsigned ints per cluster (the offset into the indices and the number of lights), and the indices.
+	// Cluster (x, y, z) is number (z * clustersY + y) * clustersX + x, tile row 0 is at the top of the screen.
+	const unsigned int* GetGrid();
+	const unsigned int* GetIndices();
+	int GetIndexCount();
+	int GetDroppedCount();
+
+	int GetClusterCount();
+	void GetClusterCounts(int *, int *, int *);
+
+	// The cluster of a view space point, -1 when it is out of the frustum. The pixel shader does the same with the depth parameters.
+	int GetCluster(float, float, float);
+	void GetDepthParameters(float *, float *);
+
+	// The view space bounding box of a cluster.
+	void GetClusterBounds(int, float *, float *);
+
+	// The view space bounding sphere of a light, as Bin uses it.
+	static void GetBoundingSphere(const ClusterLightType &, const float *, float *);
+
+ private:
+	void BuildBounds();
+	void BinSlices(int);
+	void WorkerThread(int);
+
+ private:
+	int						m_clustersX, m_clustersY, m_clustersZ;
+	int						m_rowStride;			// clustersX rounded up to a multiple of 4, for the SSE loads
+	int						m_maxLightsPerCluster;
+	float					m_tanX, m_tanY, m_near, m_far;
+
+	// The bounding boxes of the clusters: the x and y ranges per tile and slice, the depth range per slice.
+	vector<float>			m_minX, m_maxX, m_minY, m_maxY;
+	vector<float>			m_sliceDepth;			// clustersZ + 1 depths
+
+	// The lights of the frame being binned
+	vector<LightBoundsType> m_lights;
+
+	// The lights of every cluster, maxLightsPerCluster places each, and how many there are
+	vector<unsigned int>	m_clusterLights;
+	vector<unsigned int>	m_clusterCounts;
+	vector<int>				m_dropped;				// per thread
+
+	vector<unsigned int>	m_grid;
+	vector<unsigned int>	m_indices;
+	int						m_indexCount;
+
+	// The workers bin their slices when m_generation changes, and count m_pending down when they are done.
+	int						m_threadCount;
+	vector<thread>			m_workers;
+	mutex					m_mutex;
+	condition_variable		m_wakeUp, m_finished;
+	int						m_generation;
+	int						m_pending;
+	bool					m_quit;
+};
+
+#endif
@@ -1,21 +1,27 @@
 #include "__lightShaderClass.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
+#include "__shaderLoaderClass.h"
 
 //   D3DCompileFromFile
 #pragma comment(lib, "d3dcompiler.lib")
 #include "D3Dcompiler.h"
 
+#include <string.h>
+
 LightShaderClass::LightShaderClass()
 {
-	m_vertexShader = 0;
-	m_pixelShader  = 0;
-	m_layout	   = 0;
+	m_features	   = SHADER_FEATURE_SPECULAR | SHADER_FEATURE_TEXTURE;
 	m_sampleState  = 0;
-	m_matrixBuffer = 0;
+	m_frameBuffer  = 0;
+	m_objectBuffer = 0;
 
 	// Set the light constant buffer to null in the class constructor.
 	m_lightBuffer  = 0;
 
-	m_cameraBuffer = 0;
+	m_frameValid  = false;
+	m_objectValid = false;
+	m_lightValid  = false;
 }
 
 LightShaderClass::LightShaderClass(const LightShaderClass& other)
@@ -68,141 +74,82 @@ bool LightShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCount
 								D3DXVECTOR4 ambientColor, D3DXVECTOR4 diffuseColor,
 								D3DXVECTOR3 cameraPosition, D3DXVECTOR4 specularColor, float specularPower)
 {
+	TraceScopeClass scope("LightShaderClass::Render");
+
 	bool result;
 
 	// Set the shader parameters that it will use for rendering.
-	//result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, lightDirection, diffuseColor);
-	//result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, lightDirection, ambientColor, diffuseColor);
-	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture,
-									lightDirection, ambientColor, diffuseColor,
-									cameraPosition, specularColor, specularPower);
+	// The frame parameters are only uploaded when they changed since the previous call.
+	result = SetFrameParameters(deviceContext, viewMatrix, projectionMatrix, cameraPosition,
+									ambientColor, diffuseColor, lightDirection, specularColor, specularPower);
 	if( !result )
 		return false;
 
-	// Now render the prepared buffers with the shader.
-	RenderShader(deviceContext, indexCount);
-
-	return true;
+	return RenderObject(deviceContext, indexCount, worldMatrix, texture);
 }
 
-bool LightShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
+bool LightShaderClass::RenderObject(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, ID3D11ShaderResourceView* texture)
 {
-	HRESULT result;
-	ID3D10Blob *errorMessage;
-	ID3D10Blob *vertexShaderBuffer;
-	ID3D10Blob *pixelShaderBuffer;
-
-	// The polygonLayout variable has been changed to have three elements instead of two.
-	// This is so that it can accommodate a normal vector in the layout.
-	D3D11_INPUT_ELEMENT_DESC	polygonLayout[3];
-	unsigned int				numElements;
-	D3D11_SAMPLER_DESC			samplerDesc;
-	D3D11_BUFFER_DESC			matrixBufferDesc;
-	D3D11_BUFFER_DESC			cameraBufferDesc;
+	TraceScopeClass scope("LightShaderClass::RenderObject");
 
-	// We also add a new description variable for the light constant buffer.
-	D3D11_BUFFER_DESC lightBufferDesc;
-
-	// Initialize the pointers this function will use to null.
-	errorMessage	   = 0;
-	vertexShaderBuffer = 0;
-	pixelShaderBuffer  = 0;
-
-	// Load in the new light vertex shader.
-
-	// Compile the vertex shader code.
-	// result = D3DX11CompileFromFile(vsFilename, NULL, NULL, "LightVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &vertexShaderBuffer, &errorMessage, NULL);
-	result = D3DCompileFromFile(vsFilename, NULL, NULL, "LightVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &vertexShaderBuffer, &errorMessage);
-
-	if( FAILED(result) ) {
-
-		// If the shader failed to compile it should have writen something to the error message.
-		if (errorMessage)
-			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
-		else
-			// If there was nothing in the error message then it simply could not find the shader file itself.
-			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
+	bool result;
 
+	result = SetObjectParameters(deviceContext, worldMatrix, texture);
+	if( !result )
 		return false;
-	}
-
-	// Load in the new light pixel shader.
 
-	// Compile the pixel shader code.
-	//result = D3DX11CompileFromFile(psFilename, NULL, NULL, "LightPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &pixelShaderBuffer, &errorMessage, NULL);
-	result = D3DCompileFromFile(psFilename, NULL, NULL, "LightPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &pixelShaderBuffer, &errorMessage);
-
-	if( FAILED(result) ) {
-
-		// If the shader failed to compile it should have writen something to the error message.
-		if (errorMessage)
-			OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
-		else
-			// If there was nothing in the error message then it simply could not find the file itself.
-			MessageBox(hwnd, psFilename, L"Missing Shader File", MB_OK);
+	// Now render the prepared buffers with the shader.
+	return RenderShader(deviceContext, indexCount);
+}
 
-		return false;
-	}
+bool LightShaderClass::RenderInstanced(ID3D11DeviceContext* deviceContext, int indexCount, int instanceCount, ID3D11ShaderResourceView* texture)
+{
+	TraceScopeClass scope("LightShaderClass::RenderInstanced");
 
-	// Create the vertex shader from the buffer.
-	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &m_vertexShader);
+	// Only the frame buffer is used by the vertex shader, the world matrices are in the instances.
+	deviceContext->VSSetConstantBuffers(0, 1, &m_frameBuffer);
+	SetResources(deviceContext, texture);
 
-	if (FAILED(result))
+	if (!m_permutations.Bind(deviceContext, m_features | SHADER_FEATURE_INSTANCING))
 		return false;
 
-	// Create the pixel shader from the buffer.
-	result = device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), NULL, &m_pixelShader);
+	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
 
-	if (FAILED(result))
-		return false;
+	deviceContext->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, 0);
+	PerfStatsClass::CountDraw();
 
-	// Create the vertex input layout description.
-	// This setup needs to match the VertexType stucture in the ModelClass and in the shader.
-	polygonLayout[0].SemanticName = "POSITION";
-	polygonLayout[0].SemanticIndex = 0;
-	polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	polygonLayout[0].InputSlot = 0;
-	polygonLayout[0].AlignedByteOffset = 0;
-	polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[0].InstanceDataStepRate = 0;
-
-	polygonLayout[1].SemanticName = "TEXCOORD";
-	polygonLayout[1].SemanticIndex = 0;
-	polygonLayout[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-	polygonLayout[1].InputSlot = 0;
-	polygonLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[1].InstanceDataStepRate = 0;
+	return true;
+}
 
+void LightShaderClass::SetFeatures(unsigned long long features)
+{
+	m_features = features;
 
-	// One of the major changes to the shader initialization is here in the polygonLayout.
-	// We add a third element for the normal vector that will be used for lighting.
-	// The semantic name is NORMAL and the format is the regular DXGI_FORMAT_R32G32B32_FLOAT which handles 3 floats for the x, y, and z of the normal vector.
-	// The layout will now match the expected input to the HLSL vertex shader.
+	return;
+}
 
-	polygonLayout[2].SemanticName = "NORMAL";
-	polygonLayout[2].SemanticIndex = 0;
-	polygonLayout[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	polygonLayout[2].InputSlot = 0;
-	polygonLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	polygonLayout[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[2].InstanceDataStepRate = 0;
+unsigned long long LightShaderClass::GetFeatures()
+{
+	return m_features;
+}
 
-	// Get a count of the elements in the layout.
-	numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
+bool LightShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
+{
+	HRESULT result;
+	D3D11_SAMPLER_DESC			samplerDesc;
+	D3D11_BUFFER_DESC			constantBufferDesc;
 
-	// Create the vertex input layout.
-	result = device->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &m_layout);
+	// We also add a new description variable for the light constant buffer.
+	D3D11_BUFFER_DESC lightBufferDesc;
 
-	if (FAILED(result))
+	// The light shaders are compiled in variants, one for every combination of features a material uses.
+	if (!m_permutations.Initialize(device, hwnd, vsFilename, "LightVertexShader", LIGHT_SHADER_VERTEX_FEATURES,
+								   psFilename, "LightPixelShader", LIGHT_SHADER_PIXEL_FEATURES, GetLayout))
 		return false;
 
-	// Release the vertex shader buffer and pixel shader buffer since they are no longer needed.
-	vertexShaderBuffer->Release();
-	vertexShaderBuffer = 0;
-
-	pixelShaderBuffer->Release();
-	pixelShaderBuffer = 0;
+	// The default variant is compiled now, so a broken shader shows up at startup. The others are compiled when a material first needs them.
+	if (!m_permutations.Precompile(m_features))
+		return false;
 
 	// Create a texture sampler state description.
 	samplerDesc.Filter		   = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
@@ -224,34 +171,22 @@ bool LightShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR*
 	if (FAILED(result))
 		return false;
 
-	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
-	matrixBufferDesc.Usage			= D3D11_USAGE_DYNAMIC;
-	matrixBufferDesc.ByteWidth		= sizeof(MatrixBufferType);
-	matrixBufferDesc.BindFlags		= D3D11_BIND_CONSTANT_BUFFER;
-	matrixBufferDesc.CPUAccessFlags	= D3D11_CPU_ACCESS_WRITE;
-	matrixBufferDesc.MiscFlags		= 0;
-	matrixBufferDesc.StructureByteStride = 0;
+	// Setup the description of the dynamic constant buffers that are in the vertex shader:
+	// the frame buffer (view, projection and camera position) and the object buffer (world matrix).
+	constantBufferDesc.Usage			= D3D11_USAGE_DYNAMIC;
+	constantBufferDesc.ByteWidth		= sizeof(FrameBufferType);
+	constantBufferDesc.BindFlags		= D3D11_BIND_CONSTANT_BUFFER;
+	constantBufferDesc.CPUAccessFlags	= D3D11_CPU_ACCESS_WRITE;
+	constantBufferDesc.MiscFlags		= 0;
+	constantBufferDesc.StructureByteStride = 0;
 
-	// Create the constant buffer pointer so we can access the vertex shader constant buffer from within this class.
-	result = device->CreateBuffer(&matrixBufferDesc, NULL, &m_matrixBuffer);
+	result = device->CreateBuffer(&constantBufferDesc, NULL, &m_frameBuffer);
 	if (FAILED(result))
 		return false;
 
+	constantBufferDesc.ByteWidth = sizeof(ObjectBufferType);
 
-
-	// We setup the description of the new camera buffer and then create a buffer using that description.
-	// This will allow us to interface with and set the camera position in the vertex shader.
-
-	// Setup the description of the camera dynamic constant buffer that is in the vertex shader.
-	cameraBufferDesc.Usage			= D3D11_USAGE_DYNAMIC;
-	cameraBufferDesc.ByteWidth		= sizeof(CameraBufferType);
-	cameraBufferDesc.BindFlags		= D3D11_BIND_CONSTANT_BUFFER;
-	cameraBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	cameraBufferDesc.MiscFlags		= 0;
-	cameraBufferDesc.StructureByteStride = 0;
-
-	// Create the camera constant buffer pointer so we can access the vertex shader constant buffer from within this class.
-	result = device->CreateBuffer(&cameraBufferDesc, NULL, &m_cameraBuffer);
+	result = device->CreateBuffer(&constantBufferDesc, NULL, &m_objectBuffer);
 	if (FAILED(result))
 		return false;
 
@@ -289,18 +224,15 @@ void LightShaderClass::ShutdownShader()
 		m_lightBuffer = 0;
 	}
 
-	// Release the new camera constant buffer in the ShutdownShader function
-
-	// Release the camera constant buffer.
-	if (m_cameraBuffer) {
-		m_cameraBuffer->Release();
-		m_cameraBuffer = 0;
+	// Release the object and frame constant buffers.
+	if (m_objectBuffer) {
+		m_objectBuffer->Release();
+		m_objectBuffer = 0;
 	}
 
-	// Release the matrix constant buffer.
-	if (m_matrixBuffer) {
-		m_matrixBuffer->Release();
-		m_matrixBuffer = 0;
+	if (m_frameBuffer) {
+		m_frameBuffer->Release();
+		m_frameBuffer = 0;
 	}
 
 	// Release the sampler state.
@@ -309,183 +241,186 @@ void LightShaderClass::ShutdownShader()
 		m_sampleState = 0;
 	}
 
-	// Release the layout.
-	if (m_layout) {
-		m_layout->Release();
-		m_layout = 0;
-	}
-
-	// Release the pixel shader.
-	if (m_pixelShader) {
-		m_pixelShader->Release();
-		m_pixelShader = 0;
-	}
-
-	// Release the vertex shader.
-	if (m_vertexShader) {
-		m_vertexShader->Release();
-		m_vertexShader = 0;
-	}
+	// Release the shader variants with their layouts.
+	m_permutations.Shutdown();
 
 	return;
 }
 
-void LightShaderClass::OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFilename)
+// SetFrameParameters takes what is the same for all the objects of a frame: the matrices of the camera, its position and the light.
+// The frame buffer and the light buffer are uploaded only when their contents change.
+bool LightShaderClass::SetFrameParameters(ID3D11DeviceContext* deviceContext,
+											D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, D3DXVECTOR3 cameraPosition,
+											D3DXVECTOR4 ambientColor, D3DXVECTOR4 diffuseColor, D3DXVECTOR3 lightDirection,
+											D3DXVECTOR4 specularColor, float specularPower)
 {
-	char* compileErrors;
-	unsigned long bufferSize, i;
-	ofstream fout;
-
-	// Get a pointer to the error message text buffer.
-	compileErrors = (char*)(errorMessage->GetBufferPointer());
-
-	// Get the length of the message.
-	bufferSize = errorMessage->GetBufferSize();
-
-	// Open a file to write the error message to.
-	fout.open("____shader-error.txt");
-
-	// Write out the error message.
-	for (i = 0; i<bufferSize; i++)
-		fout << compileErrors[i];
+	TraceScopeClass scope("LightShaderClass::SetFrameParameters");
 
-	// Close the file.
-	fout.close();
-
-	// Release the error message.
-	errorMessage->Release();
-	errorMessage = 0;
-
-	// Pop a message up on the screen to notify the user to check the text file for compile errors.
-	MessageBox(hwnd, L"Error compiling shader. Check '__shader-error.txt' for message.", shaderFilename, MB_OK);
-
-	return;
-}
-
-// The SetShaderParameters function now takes in lightDirection and diffuseColor as inputs.
-bool LightShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext,
-											D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix,
-											ID3D11ShaderResourceView* texture,
-											D3DXVECTOR3 lightDirection,
-											D3DXVECTOR4 ambientColor, D3DXVECTOR4 diffuseColor,
-											D3DXVECTOR3 cameraPosition, D3DXVECTOR4 specularColor, float specularPower)
-{
 	HRESULT result;
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	unsigned int			 bufferNumber;
-	MatrixBufferType		*dataPtr;
-	LightBufferType			*dataPtr2;
-	CameraBufferType		*dataPtr3;
+	FrameBufferType			 frame;
+	LightBufferType			 light;
 
 	// Transpose the matrices to prepare them for the shader.
-	D3DXMatrixTranspose(&worldMatrix,	   &worldMatrix);
-	D3DXMatrixTranspose(&viewMatrix,	   &viewMatrix);
-	D3DXMatrixTranspose(&projectionMatrix, &projectionMatrix);
-
-	// Lock the constant buffer so it can be written to.
-	result = deviceContext->Map(m_matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if (FAILED(result))
-		return false;
-
-	// Get a pointer to the data in the constant buffer.
-	dataPtr = (MatrixBufferType*)mappedResource.pData;
+	D3DXMatrixTranspose(&frame.view,	   &viewMatrix);
+	D3DXMatrixTranspose(&frame.projection, &projectionMatrix);
+	frame.cameraPosition = cameraPosition;
+	frame.padding		 = 0.0f;
 
-	// Copy the matrices into the constant buffer.
-	dataPtr->world = worldMatrix;
-	dataPtr->view  = viewMatrix;
-	dataPtr->projection = projectionMatrix;
+	if (!m_frameValid || memcmp(&frame, &m_frameData, sizeof(frame)) != 0) {
 
-	// Unlock the constant buffer.
-	deviceContext->Unmap(m_matrixBuffer, 0);
+		// Lock the constant buffer so it can be written to.
+		result = deviceContext->Map(m_frameBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+		if (FAILED(result))
+			return false;
 
-	// Set the position of the constant buffer in the vertex shader.
-	bufferNumber = 0;
+		*(FrameBufferType*)mappedResource.pData = frame;
 
-	// Now set the constant buffer in the vertex shader with the updated values.
-	deviceContext->VSSetConstantBuffers(bufferNumber, 1, &m_matrixBuffer);
+		// Unlock the constant buffer.
+		deviceContext->Unmap(m_frameBuffer, 0);
+		PerfStatsClass::CountMap(sizeof(FrameBufferType));
 
+		m_frameData	 = frame;
+		m_frameValid = true;
+	}
 
+	// The light constant buffer is setup the same way.
+	light.ambientColor	 = ambientColor;		// The ambient light color is mapped into the light buffer and then set as a constant in the pixel shader before rendering.
+	light.diffuseColor	 = diffuseColor;
+	light.lightDirection = lightDirection;
+	light.specularColor	 = specularColor;
+	light.specularPower	 = specularPower;
 
-	// Here we lock the camera buffer and set the camera position value in it.
+	if (!m_lightValid || memcmp(&light, &m_lightData, sizeof(light)) != 0) {
 
-	// Lock the camera constant buffer so it can be written to.
-	result = deviceContext->Map(m_cameraBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if (FAILED(result))
-		return false;
+		// Lock the light constant buffer so it can be written to.
+		result = deviceContext->Map(m_lightBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+		if (FAILED(result))
+			return false;
 
-	// Get a pointer to the data in the constant buffer.
-	dataPtr3 = (CameraBufferType*)mappedResource.pData;
+		*(LightBufferType*)mappedResource.pData = light;
 
-	// Copy the camera position into the constant buffer.
-	dataPtr3->cameraPosition = cameraPosition;
-	dataPtr3->padding = 0.0f;
+		// Unlock the constant buffer.
+		deviceContext->Unmap(m_lightBuffer, 0);
+		PerfStatsClass::CountMap(sizeof(LightBufferType));
 
-	// Unlock the camera constant buffer.
-	deviceContext->Unmap(m_cameraBuffer, 0);
+		m_lightData	 = light;
+		m_lightValid = true;
+	}
 
-	// Note that we set the bufferNumber to 1 instead of 0 before setting the constant buffer.
-	// This is because it is the second buffer in the vertex shader(the first being the matrix buffer).
+	return true;
+}
 
-	// Set the position of the camera constant buffer in the vertex shader.
-	bufferNumber = 1;
+// SetObjectParameters uploads the world matrix of the object and sets all the buffers, other shaders may have used the same slots since the last draw.
+bool LightShaderClass::SetObjectParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, ID3D11ShaderResourceView* texture)
+{
+	TraceScopeClass scope("LightShaderClass::SetObjectParameters");
 
-	// Now set the camera constant buffer in the vertex shader with the updated values.
-	deviceContext->VSSetConstantBuffers(bufferNumber, 1, &m_cameraBuffer);
+	HRESULT result;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	ObjectBufferType		 object;
+	ID3D11Buffer			*buffers[2];
 
+	D3DXMatrixTranspose(&object.world, &worldMatrix);
 
+	if (!m_objectValid || memcmp(&object, &m_objectData, sizeof(object)) != 0) {
 
-	// Set shader texture resource in the pixel shader.
-	deviceContext->PSSetShaderResources(0, 1, &texture);
+		result = deviceContext->Map(m_objectBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+		if (FAILED(result))
+			return false;
 
+		*(ObjectBufferType*)mappedResource.pData = object;
 
-	// The light constant buffer is setup the same way as the matrix constant buffer.
-	// We first lock the buffer and get a pointer to it.
-	// After that we set the diffuse color and light direction using that pointer.
-	// Once the data is set we unlock the buffer and then set it in the pixel shader.
-	// Note that we use the PSSetConstantBuffers function instead of VSSetConstantBuffers since this is a pixel shader buffer we are setting.
+		deviceContext->Unmap(m_objectBuffer, 0);
+		PerfStatsClass::CountMap(sizeof(ObjectBufferType));
 
-	// Lock the light constant buffer so it can be written to.
-	result = deviceContext->Map(m_lightBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if (FAILED(result))
-		return false;
+		m_objectData  = object;
+		m_objectValid = true;
+	}
 
-	// Get a pointer to the data in the constant buffer.
-	dataPtr2 = (LightBufferType*)mappedResource.pData;
+	// The frame buffer is in slot 0 and the object buffer in slot 1 of the vertex shader.
+	buffers[0] = m_frameBuffer;
+	buffers[1] = m_objectBuffer;
+	deviceContext->VSSetConstantBuffers(0, 2, buffers);
 
-	// Copy the lighting variables into the constant buffer.
-	dataPtr2->ambientColor	 = ambientColor;		// The ambient light color is mapped into the light buffer and then set as a constant in the pixel shader before rendering.
-	dataPtr2->diffuseColor   = diffuseColor;
-	dataPtr2->lightDirection = lightDirection;
-	//dataPtr2->padding = 0.0f;
-	dataPtr2->specularColor  = specularColor;
-	dataPtr2->specularPower  = specularPower;
+	SetResources(deviceContext, texture);
 
-	// Unlock the constant buffer.
-	deviceContext->Unmap(m_lightBuffer, 0);
+	return true;
+}
 
-	// Set the position of the light constant buffer in the pixel shader.
-	bufferNumber = 0;
+// SetResources sets the texture and the light buffer of the pixel shader.
+void LightShaderClass::SetResources(ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* texture)
+{
+	// Set shader texture resource in the pixel shader, a variant without texture doesn't sample it.
+	if (m_features & SHADER_FEATURE_TEXTURE)
+		deviceContext->PSSetShaderResources(0, 1, &texture);
 
-	// Finally set the light constant buffer in the pixel shader with the updated values.
-	deviceContext->PSSetConstantBuffers(bufferNumber, 1, &m_lightBuffer);
+	// Finally set the light constant buffer in the pixel shader.
+	deviceContext->PSSetConstantBuffers(0, 1, &m_lightBuffer);
 
-	return true;
+	return;
 }
 
-void LightShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount)
+bool LightShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount)
 {
-	// Set the vertex input layout.
-	deviceContext->IASetInputLayout(m_layout);
-
-	// Set the vertex and pixel shaders that will be used to render this triangle.
-	deviceContext->VSSetShader(m_vertexShader, NULL, 0);
-	deviceContext->PSSetShader(m_pixelShader, NULL, 0);
+	// Set the vertex input layout and the vertex and pixel shaders of the features that will be used to render this triangle.
+	if (!m_permutations.Bind(deviceContext, m_features))
+		return false;
 
 	// Set the sampler state in the pixel shader.
 	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
 
 	// Render the triangle.
 	deviceContext->DrawIndexed(indexCount, 0, 0);
+	PerfStatsClass::CountDraw();
 
-	return;
+	return true;
+}
+
+// GetLayout is the input layout of a vertex shader variant.
+// This setup needs to match the VertexType stucture in the ModelClass and in the shader.
+int LightShaderClass::GetLayout(unsigned long long features, D3D11_INPUT_ELEMENT_DESC* polygonLayout, int maxCount)
+{
+	int numElements = (features & SHADER_FEATURE_INSTANCING) ? 7 : 3;
+
+	if (numElements > maxCount)
+		return 0;
+
+	polygonLayout[0].SemanticName = "POSITION";
+	polygonLayout[0].SemanticIndex = 0;
+	polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polygonLayout[0].InputSlot = 0;
+	polygonLayout[0].AlignedByteOffset = 0;
+	polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[0].InstanceDataStepRate = 0;
+
+	polygonLayout[1].SemanticName = "TEXCOORD";
+	polygonLayout[1].SemanticIndex = 0;
+	polygonLayout[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+	polygonLayout[1].InputSlot = 0;
+	polygonLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[1].InstanceDataStepRate = 0;
+
+	// The normal vector that will be used for lighting.
+	polygonLayout[2].SemanticName = "NORMAL";
+	polygonLayout[2].SemanticIndex = 0;
+	polygonLayout[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polygonLayout[2].InputSlot = 0;
+	polygonLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[2].InstanceDataStepRate = 0;
+
+	// The instanced variant reads the four rows of the world matrix from the instance buffer in slot 1.
+	for (int i = 3; i < numElements; i++) {
+		polygonLayout[i].SemanticName = "WORLD";
+		polygonLayout[i].SemanticIndex = i - 3;
+		polygonLayout[i].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+		polygonLayout[i].InputSlot = 1;
+		polygonLayout[i].AlignedByteOffset = i == 3 ? 0 : D3D11_APPEND_ALIGNED_ELEMENT;
+		polygonLayout[i].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+		polygonLayout[i].InstanceDataStepRate = 1;
+	}
+
+	return numElements;
 }
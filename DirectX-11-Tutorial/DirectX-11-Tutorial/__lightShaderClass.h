@@ -9,15 +9,25 @@
 #include <fstream>
 using namespace std;
 
+#include "__shaderPermutationClass.h"
+#include "__shaderConstantsClass.h"
+
+// The features of the light shader variants. The vertex shader only depends on specular lighting (the view direction),
+// instancing and the clustered lights (the world position and the depth), the pixel shader on all but instancing.
+#define LIGHT_SHADER_VERTEX_FEATURES (SHADER_FEATURE_SPECULAR | SHADER_FEATURE_INSTANCING | SHADER_FEATURE_CLUSTERED_LIGHTS)
+#define LIGHT_SHADER_PIXEL_FEATURES	 (SHADER_FEATURE_SPECULAR | SHADER_FEATURE_TEXTURE | SHADER_FEATURE_ALPHA_TEST | SHADER_FEATURE_CLUSTERED_LIGHTS)
+
 
 
 class LightShaderClass {
  private:
-	struct MatrixBufferType {
-		D3DXMATRIX world;
-		D3DXMATRIX view;
-		D3DXMATRIX projection;
-	};
+	// The constant buffers are split by how often they change: the view, the projection and the camera once per frame,
+	// the world matrix with every object. Each one is only uploaded when its contents differ from the last upload.
+	// The layouts are shared with ShaderReferenceClass, see ShaderConstantsClass.
+	typedef ShaderConstantsClass<D3DXMATRIX, D3DXVECTOR3, D3DXVECTOR4> ConstantsType;
+
+	typedef ConstantsType::LightFrameBufferType	 FrameBufferType;
+	typedef ConstantsType::LightObjectBufferType ObjectBufferType;
 
 	// The new LightBufferType structure will be used for holding lighting information.
 	// This typedef is the same as the new typedef in the pixel shader.
@@ -38,24 +48,7 @@ class LightShaderClass {
 	// instead of using padding so that the structure could be kept in multiples of 16 bytes.
 	// Also had specular power been placed last in the structure and no padding used beneath light direction then the shader would not have functioned correctly.
 	// This is because even though the structure was a multiple of 16 the individual slots themselves were not aligned logically to 16 bytes each.
-
-	struct LightBufferType
-	{
-		D3DXVECTOR4 ambientColor;
-		D3DXVECTOR4 diffuseColor;
-		D3DXVECTOR3 lightDirection;
-		float		specularPower;
-		D3DXVECTOR4 specularColor;
-	};
-
-	// We add a new camera buffer structure to match the new camera constant buffer in the vertex shader.
-	// Note we add a padding to make the structure size a multiple of 16 to prevent CreateBuffer failing when using sizeof with this structure.
-
-	struct CameraBufferType
-	{
-		D3DXVECTOR3 cameraPosition;
-		float padding;
-	};
+	typedef ConstantsType::LightBufferType LightBufferType;
 
  public:
 	LightShaderClass();
@@ -69,30 +62,48 @@ class LightShaderClass {
 	bool Render(ID3D11DeviceContext *, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView *,
 					D3DXVECTOR3, D3DXVECTOR4, D3DXVECTOR4, D3DXVECTOR3, D3DXVECTOR4, float);
 
+	// The same in two steps: the frame parameters once (view, projection, camera and light), then one RenderObject per object.
+	bool SetFrameParameters(ID3D11DeviceContext *, D3DXMATRIX, D3DXMATRIX, D3DXVECTOR3, D3DXVECTOR4, D3DXVECTOR4, D3DXVECTOR3, D3DXVECTOR4, float);
+	bool RenderObject(ID3D11DeviceContext *, int, D3DXMATRIX, ID3D11ShaderResourceView *);
+
+	// The instances of the object after SetFrameParameters: the world matrix of every instance (not transposed)
+	// comes from the vertex buffer in slot 1, which the caller sets.
+	bool RenderInstanced(ID3D11DeviceContext *, int, int, ID3D11ShaderResourceView *);
+
+	// The features of the material drawn next (SHADER_FEATURE_ bits), the shader variant is selected by them.
+	// Specular and texture are on by default, instancing is added by RenderInstanced.
+	// With the clustered lights the point and spot lights of a ClusteredLightsClass are added, it has to be bound before the draw.
+	void SetFeatures(unsigned long long);
+	unsigned long long GetFeatures();
+
  private:
 	bool InitializeShader(ID3D11Device *, HWND, WCHAR *, WCHAR *);
 	void ShutdownShader();
-	void OutputShaderErrorMessage(ID3D10Blob *, HWND, WCHAR *);
 
-	bool SetShaderParameters(ID3D11DeviceContext *, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView *, D3DXVECTOR3, D3DXVECTOR4, D3DXVECTOR4);
-	void RenderShader(ID3D11DeviceContext *, int);
+	bool SetObjectParameters(ID3D11DeviceContext *, D3DXMATRIX, ID3D11ShaderResourceView *);
+	void SetResources(ID3D11DeviceContext *, ID3D11ShaderResourceView *);
+	bool RenderShader(ID3D11DeviceContext *, int);
 
-	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, D3DXVECTOR3, D3DXVECTOR4, D3DXVECTOR4,
-		D3DXVECTOR3, D3DXVECTOR4, float);
+	static int GetLayout(unsigned long long, D3D11_INPUT_ELEMENT_DESC *, int);
 
  private:
-	ID3D11VertexShader	*m_vertexShader;
-	ID3D11PixelShader	*m_pixelShader;
-	ID3D11InputLayout	*m_layout;
+	// The shader variants, and the features of the one drawn with
+	ShaderPermutationClass m_permutations;
+	unsigned long long	   m_features;
+
 	ID3D11SamplerState	*m_sampleState;
-	ID3D11Buffer		*m_matrixBuffer;
+	ID3D11Buffer		*m_frameBuffer;
+	ID3D11Buffer		*m_objectBuffer;
 
 	// There is a new private constant buffer for the light information(color and direction).
 	// The light buffer will be used by this class to set the global light variables inside the HLSL pixel shader.
 	ID3D11Buffer		*m_lightBuffer;
 
-	// We add a new camera constant buffer here which will be used for setting the camera position in the vertex shader
-	ID3D11Buffer		*m_cameraBuffer;
+	// The last uploaded contents of the buffers, and whether there is any yet.
+	FrameBufferType		 m_frameData;
+	ObjectBufferType	 m_objectData;
+	LightBufferType		 m_lightData;
+	bool				 m_frameValid, m_objectValid, m_lightValid;
 };
 
 #endif
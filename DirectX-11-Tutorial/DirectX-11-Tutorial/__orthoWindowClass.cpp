@@ -0,0 +1,137 @@
+#include "__orthoWindowClass.h"
+
+OrthoWindowClass::OrthoWindowClass()
+{
+	m_vertexBuffer = 0;
+	m_indexBuffer  = 0;
+}
+
+OrthoWindowClass::OrthoWindowClass(const OrthoWindowClass& other)
+{
+}
+
+OrthoWindowClass::~OrthoWindowClass()
+{
+}
+
+bool OrthoWindowClass::Initialize(ID3D11Device *device, int windowWidth, int windowHeight)
+{
+	return InitializeBuffers(device, windowWidth, windowHeight);
+}
+
+void OrthoWindowClass::Shutdown()
+{
+	ShutdownBuffers();
+
+	return;
+}
+
+// Render puts the quad on the graphics pipeline, the shader then draws it with GetIndexCount() indices.
+void OrthoWindowClass::Render(ID3D11DeviceContext *deviceContext)
+{
+	RenderBuffers(deviceContext);
+
+	return;
+}
+
+int OrthoWindowClass::GetIndexCount()
+{
+	return m_indexCount;
+}
+
+// The quad is centered on the screen, as in DirectX's 2d scene the point (0, 0) lies at the center of the screen.
+// The buffers are immutable, as the quad never moves.
+bool OrthoWindowClass::InitializeBuffers(ID3D11Device *device, int windowWidth, int windowHeight)
+{
+	VertexType				 vertices[6];
+	unsigned long			 indices[6];
+	D3D11_BUFFER_DESC		 vertexBufferDesc, indexBufferDesc;
+	D3D11_SUBRESOURCE_DATA	 vertexData, indexData;
+	HRESULT					 result;
+
+	float left	 = (float)(-windowWidth / 2);
+	float right	 = left + (float)windowWidth;
+	float top	 = (float)(windowHeight / 2);
+	float bottom = top - (float)windowHeight;
+
+	m_vertexCount = 6;
+	m_indexCount  = 6;
+
+	// First triangle.
+	vertices[0].position = D3DXVECTOR3(left, top, 0.0f);		// Top left
+	vertices[0].texture  = D3DXVECTOR2(0.0f, 0.0f);
+	vertices[1].position = D3DXVECTOR3(right, bottom, 0.0f);	// Bottom right
+	vertices[1].texture  = D3DXVECTOR2(1.0f, 1.0f);
+	vertices[2].position = D3DXVECTOR3(left, bottom, 0.0f);		// Bottom left
+	vertices[2].texture  = D3DXVECTOR2(0.0f, 1.0f);
+
+	// Second triangle.
+	vertices[3].position = D3DXVECTOR3(left, top, 0.0f);		// Top left
+	vertices[3].texture  = D3DXVECTOR2(0.0f, 0.0f);
+	vertices[4].position = D3DXVECTOR3(right, top, 0.0f);		// Top right
+	vertices[4].texture  = D3DXVECTOR2(1.0f, 0.0f);
+	vertices[5].position = D3DXVECTOR3(right, bottom, 0.0f);	// Bottom right
+	vertices[5].texture  = D3DXVECTOR2(1.0f, 1.0f);
+
+	for (int i = 0; i < m_indexCount; i++)
+		indices[i] = i;
+
+	vertexBufferDesc.Usage				 = D3D11_USAGE_IMMUTABLE;
+	vertexBufferDesc.ByteWidth			 = sizeof(VertexType) * m_vertexCount;
+	vertexBufferDesc.BindFlags			 = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags		 = 0;
+	vertexBufferDesc.MiscFlags			 = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+
+	vertexData.pSysMem			= vertices;
+	vertexData.SysMemPitch		= 0;
+	vertexData.SysMemSlicePitch = 0;
+
+	result = device->CreateBuffer(&vertexBufferDesc, &vertexData, &m_vertexBuffer);
+	if (FAILED(result))
+		return false;
+
+	indexBufferDesc.Usage				= D3D11_USAGE_IMMUTABLE;
+	indexBufferDesc.ByteWidth			= sizeof(unsigned long) * m_indexCount;
+	indexBufferDesc.BindFlags			= D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.CPUAccessFlags		= 0;
+	indexBufferDesc.MiscFlags			= 0;
+	indexBufferDesc.StructureByteStride = 0;
+
+	indexData.pSysMem		   = indices;
+	indexData.SysMemPitch	   = 0;
+	indexData.SysMemSlicePitch = 0;
+
+	result = device->CreateBuffer(&indexBufferDesc, &indexData, &m_indexBuffer);
+	if (FAILED(result))
+		return false;
+
+	return true;
+}
+
+void OrthoWindowClass::ShutdownBuffers()
+{
+	if (m_indexBuffer) {
+		m_indexBuffer->Release();
+		m_indexBuffer = 0;
+	}
+
+	if (m_vertexBuffer) {
+		m_vertexBuffer->Release();
+		m_vertexBuffer = 0;
+	}
+
+	return;
+}
+
+void OrthoWindowClass::RenderBuffers(ID3D11DeviceContext *deviceContext)
+{
+	unsigned int stride = sizeof(VertexType);
+	unsigned int offset = 0;
+
+	deviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
+	deviceContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	return;
+}
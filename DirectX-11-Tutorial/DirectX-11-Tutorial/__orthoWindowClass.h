@@ -0,0 +1,43 @@
+// --------------------------------------------------------------------------------------------------------
+// OrthoWindowClass is a single screen-sized quad, used to draw a render texture onto the screen with the ortho matrix.
+// Unlike BitmapClass it has no texture of its own and its vertex buffer never changes.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _ORTHOWINDOWCLASS_H_
+#define _ORTHOWINDOWCLASS_H_
+
+#include <d3d11.h>
+#include <d3dx10math.h>
+
+
+
+class OrthoWindowClass {
+ private:
+	// The VertexType must match the one in the TextureShaderClass layout.
+	struct VertexType {
+		D3DXVECTOR3 position;
+		D3DXVECTOR2 texture;
+	};
+
+ public:
+	OrthoWindowClass();
+	OrthoWindowClass(const OrthoWindowClass &);
+   ~OrthoWindowClass();
+
+	bool Initialize(ID3D11Device *, int, int);
+	void Shutdown();
+	void Render(ID3D11DeviceContext *);
+
+	int GetIndexCount();
+
+ private:
+	bool InitializeBuffers(ID3D11Device *, int, int);
+	void ShutdownBuffers();
+	void RenderBuffers(ID3D11DeviceContext *);
+
+ private:
+	ID3D11Buffer	*m_vertexBuffer, *m_indexBuffer;
+	int				 m_vertexCount, m_indexCount;
+};
+
+#endif
@@ -0,0 +1,424 @@
+#include "__particleSystemClass.h"
+
+#include <math.h>
+#include <string.h>
+#include <xmmintrin.h>
+
+ParticleSystemClass::ParticleSystemClass()
+{
+	m_capacity  = 0;
+	m_liveCount = 0;
+
+	m_posX	   = 0;
+	m_posY	   = 0;
+	m_velX	   = 0;
+	m_velY	   = 0;
+	m_rotation = 0;
+	m_spin	   = 0;
+	m_age	   = 0;
+	m_invLife  = 0;
+	m_alive	   = 0;
+
+	m_freeList	= 0;
+	m_freeCount = 0;
+}
+
+ParticleSystemClass::ParticleSystemClass(const ParticleSystemClass& other)
+{
+}
+
+ParticleSystemClass::~ParticleSystemClass()
+{
+}
+
+// Initialize allocates the pool for the given number of particles and puts every slot on the free list.
+bool ParticleSystemClass::Initialize(int maxParticles)
+{
+	float **arrays[] = { &m_posX, &m_posY, &m_velX, &m_velY, &m_rotation, &m_spin, &m_age, &m_invLife, &m_alive };
+
+	if (maxParticles <= 0)
+		return false;
+
+	// Round the capacity up so the SSE loops never have to deal with a partial group of four.
+	m_capacity	= (maxParticles + 3) & ~3;
+	m_liveCount = 0;
+
+	// Allocate the aligned arrays and clear them, a zeroed slot is a dead slot.
+	for (size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++) {
+
+		*arrays[i] = (float*)_mm_malloc(sizeof(float) * m_capacity, 16);
+		if (!*arrays[i])
+			return false;
+
+		memset(*arrays[i], 0, sizeof(float) * m_capacity);
+	}
+
+	// Create the free list. Slots are pushed in reverse so that the first spawns use the lowest indices,
+	// which keeps the live particles packed at the front of the pool while the system warms up.
+	m_freeList = new int[m_capacity];
+	if (!m_freeList)
+		return false;
+
+	for (int i = 0; i < m_capacity; i++)
+		m_freeList[i] = m_capacity - 1 - i;
+
+	m_freeCount = m_capacity;
+
+	// Default forces and curves: light gravity pulling down the screen, a bit of drag,
+	// white particles fading out while they shrink to nothing.
+	m_gravityX = 0.0f;
+	m_gravityY = -98.0f;
+	m_drag	   = 0.5f;
+
+	SetColorCurve(1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f);
+	SetSizeCurve(1.0f, 0.0f);
+
+	m_randomState = 0x9E3779B9;
+
+	return true;
+}
+
+// Shutdown releases the pool and forgets all the emitters.
+void ParticleSystemClass::Shutdown()
+{
+	float **arrays[] = { &m_posX, &m_posY, &m_velX, &m_velY, &m_rotation, &m_spin, &m_age, &m_invLife, &m_alive };
+
+	for (size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++) {
+		if (*arrays[i]) {
+			_mm_free(*arrays[i]);
+			*arrays[i] = 0;
+		}
+	}
+
+	if (m_freeList) {
+		delete [] m_freeList;
+		m_freeList = 0;
+	}
+
+	m_emitters.clear();
+
+	m_capacity	= 0;
+	m_liveCount = 0;
+	m_freeCount = 0;
+
+	return;
+}
+
+// AddEmitter creates a new emitter at the given position spawning 'rate' particles per second and returns its index.
+// The remaining emitter parameters get sensible defaults and can be changed with the SetEmitter* functions.
+int ParticleSystemClass::AddEmitter(float posX, float posY, float rate)
+{
+	EmitterType emitter;
+
+	emitter.posX		= posX;
+	emitter.posY		= posY;
+	emitter.rate		= rate;
+	emitter.accumulator = 0.0f;
+	emitter.angleMin	= 0.0f;
+	emitter.angleMax	= 2.0f * 3.14159265f;
+	emitter.speedMin	= 50.0f;
+	emitter.speedMax	= 150.0f;
+	emitter.lifeMin		= 1.0f;
+	emitter.lifeMax		= 2.0f;
+	emitter.spinMin		= -3.0f;
+	emitter.spinMax		=  3.0f;
+	emitter.active		= true;
+
+	m_emitters.push_back(emitter);
+
+	return (int)m_emitters.size() - 1;
+}
+
+void ParticleSystemClass::SetEmitterPosition(int emitter, float posX, float posY)
+{
+	m_emitters[emitter].posX = posX;
+	m_emitters[emitter].posY = posY;
+}
+
+void ParticleSystemClass::SetEmitterRate(int emitter, float rate)
+{
+	m_emitters[emitter].rate = rate;
+}
+
+void ParticleSystemClass::SetEmitterVelocity(int emitter, float angleMin, float angleMax, float speedMin, float speedMax)
+{
+	m_emitters[emitter].angleMin = angleMin;
+	m_emitters[emitter].angleMax = angleMax;
+	m_emitters[emitter].speedMin = speedMin;
+	m_emitters[emitter].speedMax = speedMax;
+}
+
+void ParticleSystemClass::SetEmitterLifetime(int emitter, float lifeMin, float lifeMax)
+{
+	m_emitters[emitter].lifeMin = lifeMin;
+	m_emitters[emitter].lifeMax = lifeMax;
+}
+
+void ParticleSystemClass::SetEmitterSpin(int emitter, float spinMin, float spinMax)
+{
+	m_emitters[emitter].spinMin = spinMin;
+	m_emitters[emitter].spinMax = spinMax;
+}
+
+void ParticleSystemClass::SetEmitterActive(int emitter, bool active)
+{
+	m_emitters[emitter].active = active;
+}
+
+void ParticleSystemClass::SetGravity(float gravityX, float gravityY)
+{
+	m_gravityX = gravityX;
+	m_gravityY = gravityY;
+}
+
+// The drag is the fraction of the velocity lost per second.
+void ParticleSystemClass::SetDrag(float drag)
+{
+	m_drag = drag;
+}
+
+// The color of a particle is interpolated linearly from the start color at birth to the end color at death.
+void ParticleSystemClass::SetColorCurve(float r0, float g0, float b0, float a0, float r1, float g1, float b1, float a1)
+{
+	m_colorStart[0] = r0;
+	m_colorStart[1] = g0;
+	m_colorStart[2] = b0;
+	m_colorStart[3] = a0;
+
+	m_colorEnd[0] = r1;
+	m_colorEnd[1] = g1;
+	m_colorEnd[2] = b1;
+	m_colorEnd[3] = a1;
+}
+
+// The size is a scale factor applied to the instanced quad, interpolated the same way as the color.
+void ParticleSystemClass::SetSizeCurve(float sizeStart, float sizeEnd)
+{
+	m_sizeStart = sizeStart;
+	m_sizeEnd	= sizeEnd;
+}
+
+int ParticleSystemClass::GetLiveCount()
+{
+	return m_liveCount;
+}
+
+int ParticleSystemClass::GetCapacity()
+{
+	return m_capacity;
+}
+
+// Frame advances the whole system by frameTime seconds.
+void ParticleSystemClass::Frame(float frameTime)
+{
+	if (!m_capacity || frameTime <= 0.0f)
+		return;
+
+	// New particles first so they get integrated for the rest of this frame as well.
+	Emit(frameTime);
+
+	Integrate(frameTime);
+
+	CollectDead();
+
+	return;
+}
+
+// Emit lets every active emitter spawn the particles it owes for this frame.
+// When the pool is full the remaining particles are simply dropped.
+void ParticleSystemClass::Emit(float frameTime)
+{
+	for (size_t i = 0; i < m_emitters.size(); i++) {
+
+		EmitterType &emitter = m_emitters[i];
+
+		if (!emitter.active)
+			continue;
+
+		emitter.accumulator += emitter.rate * frameTime;
+
+		while (emitter.accumulator >= 1.0f) {
+
+			emitter.accumulator -= 1.0f;
+
+			if (Spawn(emitter) < 0) {
+				emitter.accumulator = 0.0f;
+				break;
+			}
+		}
+	}
+
+	return;
+}
+
+// Spawn pops a slot from the free list and fills it with a new particle. Returns the slot or -1 if the pool is full.
+int ParticleSystemClass::Spawn(EmitterType &emitter)
+{
+	int	  slot;
+	float angle, speed;
+
+	if (!m_freeCount)
+		return -1;
+
+	slot = m_freeList[--m_freeCount];
+
+	angle = Random(emitter.angleMin, emitter.angleMax);
+	speed = Random(emitter.speedMin, emitter.speedMax);
+
+	m_posX[slot]	 = emitter.posX;
+	m_posY[slot]	 = emitter.posY;
+	m_velX[slot]	 = cosf(angle) * speed;
+	m_velY[slot]	 = sinf(angle) * speed;
+	m_rotation[slot] = Random(0.0f, 2.0f * 3.14159265f);
+	m_spin[slot]	 = Random(emitter.spinMin, emitter.spinMax);
+	m_age[slot]		 = 0.0f;
+	m_invLife[slot]	 = 1.0f / Random(emitter.lifeMin, emitter.lifeMax);
+	m_alive[slot]	 = 1.0f;
+
+	m_liveCount++;
+
+	return slot;
+}
+
+// Integrate runs the SSE kernels over the whole pool, four slots at a time.
+// Free slots are integrated as well, it is cheaper than branching on them, and the alive mask keeps them from ever coming back to life.
+void ParticleSystemClass::Integrate(float frameTime)
+{
+	__m128 dt	   = _mm_set1_ps(frameTime);
+	__m128 gravX   = _mm_set1_ps(m_gravityX * frameTime);
+	__m128 gravY   = _mm_set1_ps(m_gravityY * frameTime);
+	__m128 damping = _mm_set1_ps(m_drag * frameTime < 1.0f ? 1.0f - m_drag * frameTime : 0.0f);
+
+	for (int i = 0; i < m_capacity; i += 4) {
+
+		__m128 velX = _mm_load_ps(m_velX + i);
+		__m128 velY = _mm_load_ps(m_velY + i);
+
+		// Apply the gravity and the drag to the velocity.
+		velX = _mm_mul_ps(_mm_add_ps(velX, gravX), damping);
+		velY = _mm_mul_ps(_mm_add_ps(velY, gravY), damping);
+
+		_mm_store_ps(m_velX + i, velX);
+		_mm_store_ps(m_velY + i, velY);
+
+		// Move the particles with the new velocity.
+		_mm_store_ps(m_posX + i, _mm_add_ps(_mm_load_ps(m_posX + i), _mm_mul_ps(velX, dt)));
+		_mm_store_ps(m_posY + i, _mm_add_ps(_mm_load_ps(m_posY + i), _mm_mul_ps(velY, dt)));
+
+		// Spin them.
+		_mm_store_ps(m_rotation + i, _mm_add_ps(_mm_load_ps(m_rotation + i), _mm_mul_ps(_mm_load_ps(m_spin + i), dt)));
+
+		// And age them.
+		_mm_store_ps(m_age + i, _mm_add_ps(_mm_load_ps(m_age + i), dt));
+	}
+
+	return;
+}
+
+// CollectDead finds the live particles whose normalized age reached 1 and gives their slots back to the free list.
+void ParticleSystemClass::CollectDead()
+{
+	__m128 one = _mm_set1_ps(1.0f);
+
+	for (int i = 0; i < m_capacity; i += 4) {
+
+		__m128 alive   = _mm_cmpgt_ps(_mm_load_ps(m_alive + i), _mm_setzero_ps());
+		__m128 expired = _mm_cmpge_ps(_mm_mul_ps(_mm_load_ps(m_age + i), _mm_load_ps(m_invLife + i)), one);
+
+		int mask = _mm_movemask_ps(_mm_and_ps(alive, expired));
+
+		// Most groups have nobody dying this frame, so this is a single test for them.
+		if (!mask)
+			continue;
+
+		for (int lane = 0; lane < 4; lane++) {
+			if (mask & (1 << lane)) {
+				m_alive[i + lane]	= 0.0f;
+				m_invLife[i + lane] = 0.0f;
+				m_freeList[m_freeCount++] = i + lane;
+				m_liveCount--;
+			}
+		}
+	}
+
+	return;
+}
+
+// BuildInstanceArray compacts the live particles into the instance array, which is normally the mapped instance buffer
+// of a BitmapClass_Instancing object. Size and color curves are evaluated here with SSE for four slots at a time,
+// then only the live lanes are written out, one after the other, so the buffer is filled with sequential writes.
+int ParticleSystemClass::BuildInstanceArray(void *instances, int maxInstances)
+{
+	InstanceType *instancePtr;
+	int			  count;
+
+	__m128 one		 = _mm_set1_ps(1.0f);
+	__m128 sizeStart = _mm_set1_ps(m_sizeStart);
+	__m128 sizeDelta = _mm_set1_ps(m_sizeEnd - m_sizeStart);
+	__m128 colorStart[4], colorDelta[4];
+
+	for (int c = 0; c < 4; c++) {
+		colorStart[c] = _mm_set1_ps(m_colorStart[c]);
+		colorDelta[c] = _mm_set1_ps(m_colorEnd[c] - m_colorStart[c]);
+	}
+
+	// Coerce the input instances into an InstanceType structure.
+	instancePtr = (InstanceType*)instances;
+	count = 0;
+
+	for (int i = 0; i < m_capacity && count < maxInstances; i += 4) {
+
+		int mask = _mm_movemask_ps(_mm_cmpgt_ps(_mm_load_ps(m_alive + i), _mm_setzero_ps()));
+
+		if (!mask)
+			continue;
+
+		// Normalized age, clamped to 1 for the particles that are about to die.
+		__m128 t = _mm_min_ps(_mm_mul_ps(_mm_load_ps(m_age + i), _mm_load_ps(m_invLife + i)), one);
+
+		float size[4];
+		float color[4][4];
+
+		_mm_storeu_ps(size, _mm_add_ps(sizeStart, _mm_mul_ps(sizeDelta, t)));
+
+		for (int c = 0; c < 4; c++)
+			_mm_storeu_ps(color[c], _mm_add_ps(colorStart[c], _mm_mul_ps(colorDelta[c], t)));
+
+		for (int lane = 0; lane < 4 && count < maxInstances; lane++) {
+
+			if (!(mask & (1 << lane)))
+				continue;
+
+			instancePtr[count].x		= m_posX[i + lane];
+			instancePtr[count].y		= m_posY[i + lane];
+			instancePtr[count].rotation = m_rotation[i + lane];
+			instancePtr[count].size		= size[lane];
+			instancePtr[count].r		= color[0][lane];
+			instancePtr[count].g		= color[1][lane];
+			instancePtr[count].b		= color[2][lane];
+			instancePtr[count].a		= color[3][lane];
+			instancePtr[count].u		= 0.0f;
+			instancePtr[count].v		= 0.0f;
+			instancePtr[count].uWidth	= 1.0f;
+			instancePtr[count].vHeight	= 1.0f;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+// Random returns a uniformly distributed number in [0, 1) from a xorshift generator, which is a lot cheaper than rand() for a million particles.
+float ParticleSystemClass::Random()
+{
+	m_randomState ^= m_randomState << 13;
+	m_randomState ^= m_randomState >> 17;
+	m_randomState ^= m_randomState << 5;
+
+	return (float)(m_randomState >> 8) * (1.0f / 16777216.0f);
+}
+
+float ParticleSystemClass::Random(float minValue, float maxValue)
+{
+	return minValue + (maxValue - minValue) * Random();
+}
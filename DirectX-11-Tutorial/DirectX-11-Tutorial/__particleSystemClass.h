@@ -0,0 +1,108 @@
+// --------------------------------------------------------------------------------------------------------
+// ParticleSystemClass is a CPU particle simulation that feeds the instance buffer of BitmapClass_Instancing.
+// Particles live in a fixed-capacity pool stored as a structure of arrays, so the update kernels can run over
+// four particles at a time with SSE. Dead slots go onto a free list and are reused by the emitters in O(1).
+// Each frame the live particles are compacted straight into the (mapped) instance buffer, which is then drawn
+// with a single DrawInstanced call through TextureShaderClass_Instancing.
+//
+// The class itself has no Direct3D dependency, so the update and compaction can be timed on any platform.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _PARTICLESYSTEMCLASS_H_
+#define _PARTICLESYSTEMCLASS_H_
+
+#include <vector>
+using namespace std;
+
+
+
+class ParticleSystemClass {
+ public:
+	// The InstanceType must match the one in the BitmapClass_Instancing.
+	struct InstanceType {
+		float x, y, rotation;
+		float size;
+		float r, g, b, a;
+		float u, v, uWidth, vHeight;
+	};
+
+ private:
+	// An emitter spawns particles at a fixed rate around its position.
+	// Speed, direction, lifetime and spin are picked at random from the given ranges for every new particle.
+	struct EmitterType {
+		float posX, posY;
+		float rate;					// particles per second
+		float accumulator;			// fractional particles left over from the previous frame
+		float angleMin, angleMax;	// direction of the initial velocity, in radians
+		float speedMin, speedMax;
+		float lifeMin,  lifeMax;	// in seconds
+		float spinMin,  spinMax;	// in radians per second
+		bool  active;
+	};
+
+ public:
+	ParticleSystemClass();
+	ParticleSystemClass(const ParticleSystemClass &);
+   ~ParticleSystemClass();
+
+	bool Initialize(int);
+	void Shutdown();
+
+	int  AddEmitter(float, float, float);
+	void SetEmitterPosition(int, float, float);
+	void SetEmitterRate(int, float);
+	void SetEmitterVelocity(int, float, float, float, float);
+	void SetEmitterLifetime(int, float, float);
+	void SetEmitterSpin(int, float, float);
+	void SetEmitterActive(int, bool);
+
+	// Forces and curves are shared by all the particles of the system.
+	void SetGravity(float, float);
+	void SetDrag(float);
+	void SetColorCurve(float, float, float, float, float, float, float, float);
+	void SetSizeCurve(float, float);
+
+	// Frame spawns new particles, integrates the live ones and kills the expired ones.
+	void Frame(float);
+
+	// BuildInstanceArray writes all the live particles into the instance array and returns how many it wrote.
+	int  BuildInstanceArray(void *, int);
+
+	int  GetLiveCount();
+	int  GetCapacity();
+
+ private:
+	int  Spawn(EmitterType &);
+	void Emit(float);
+	void Integrate(float);
+	void CollectDead();
+
+	float Random();
+	float Random(float, float);
+
+ private:
+	int		 m_capacity;		// number of slots, rounded up to a multiple of 4 for the SSE kernels
+	int		 m_liveCount;
+
+	// Structure of arrays, one entry per slot. All arrays are 16-byte aligned.
+	float	*m_posX,  *m_posY;
+	float	*m_velX,  *m_velY;
+	float	*m_rotation, *m_spin;
+	float	*m_age,   *m_invLife;	// normalized age is age * invLife, the particle dies when it reaches 1
+	float	*m_alive;				// 1.0f for a live particle and 0.0f for a free slot, used as a SIMD mask
+
+	// Free list of slot indices, used as a stack.
+	int		*m_freeList;
+	int		 m_freeCount;
+
+	vector<EmitterType> m_emitters;
+
+	float	 m_gravityX, m_gravityY;
+	float	 m_drag;
+	float	 m_colorStart[4], m_colorEnd[4];
+	float	 m_sizeStart, m_sizeEnd;
+
+	unsigned int m_randomState;
+};
+
+#endif
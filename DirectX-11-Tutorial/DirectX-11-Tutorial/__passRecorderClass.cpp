@@ -0,0 +1,211 @@
+#include "__passRecorderClass.h"
+#include "__traceClass.h"
+
+PassRecorderClass::PassRecorderClass()
+{
+	m_backend	  = 0;
+	m_deferred	  = false;
+	m_nextPass	  = 0;
+	m_threadCount = 1;
+	m_generation  = 0;
+	m_pending	  = 0;
+	m_quit		  = false;
+}
+
+PassRecorderClass::PassRecorderClass(const PassRecorderClass& other)
+{
+}
+
+PassRecorderClass::~PassRecorderClass()
+{
+}
+
+bool PassRecorderClass::Initialize(RenderBackendClass *backend, int threadCount)
+{
+	RenderContextClass *context;
+
+	if (!backend)
+		return false;
+
+	m_backend = backend;
+
+	// The first context tells if the backend has them at all.
+	context	   = m_backend->CreateDeferredContext();
+	m_deferred = context != 0;
+
+	if (context)
+		m_contexts.push_back(context);
+
+	m_threadCount = threadCount < 1 || !m_deferred ? 1 : threadCount;
+
+	m_quit		 = false;
+	m_generation = 0;
+	m_pending	 = 0;
+
+	for (int i = 1; i < m_threadCount; i++)
+		m_workers.push_back(thread(&PassRecorderClass::WorkerThread, this, i));
+
+	return true;
+}
+
+void PassRecorderClass::Shutdown()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_quit = true;
+	}
+
+	m_wakeUp.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+		m_workers[i].join();
+
+	m_workers.clear();
+
+	for (size_t i = 0; i < m_contexts.size(); i++)
+		m_backend->ReleaseDeferredContext(m_contexts[i]);
+
+	m_contexts.clear();
+	m_passes.clear();
+	m_backend = 0;
+
+	return;
+}
+
+void PassRecorderClass::AddPass(PassFunctionType function, void *data)
+{
+	PassType pass = { function, data };
+
+	m_passes.push_back(pass);
+
+	return;
+}
+
+void PassRecorderClass::ClearPasses()
+{
+	m_passes.clear();
+
+	return;
+}
+
+int PassRecorderClass::GetPassCount()
+{
+	return (int)m_passes.size();
+}
+
+bool PassRecorderClass::IsDeferred()
+{
+	return m_deferred;
+}
+
+void PassRecorderClass::Record()
+{
+	int passCount = (int)m_passes.size();
+
+	if (!m_deferred) {
+		for (int i = 0; i < passCount; i++)
+			m_passes[i].function(m_backend, m_passes[i].data);
+
+		return;
+	}
+
+	// The contexts are made here, the threads only use them.
+	while ((int)m_contexts.size() < passCount) {
+		RenderContextClass *context = m_backend->CreateDeferredContext();
+
+		if (!context)
+			break;
+
+		m_contexts.push_back(context);
+	}
+
+	// The passes past the contexts the backend could make are recorded on the backend itself after the others, the order stays.
+	if ((int)m_contexts.size() < passCount)
+		passCount = (int)m_contexts.size();
+
+	m_nextPass = 0;
+
+	// The workers take passes, the calling thread too.
+	if (m_threadCount > 1) {
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_pending = m_threadCount - 1;
+			m_generation++;
+		}
+
+		m_wakeUp.notify_all();
+	}
+
+	RecordPasses();
+
+	if (m_threadCount > 1) {
+		unique_lock<mutex> lock(m_mutex);
+
+		while (m_pending > 0)
+			m_finished.wait(lock);
+	}
+
+	{
+		TraceScopeClass scope("PassRecorderClass::Execute");
+
+		for (int i = 0; i < passCount; i++)
+			m_backend->ExecuteDeferredContext(m_contexts[i]);
+	}
+
+	for (int i = passCount; i < (int)m_passes.size(); i++)
+		m_passes[i].function(m_backend, m_passes[i].data);
+
+	return;
+}
+
+// RecordPasses takes the next pass until there are none left with a context.
+void PassRecorderClass::RecordPasses()
+{
+	int passCount = (int)(m_passes.size() < m_contexts.size() ? m_passes.size() : m_contexts.size());
+
+	while (true) {
+		int pass;
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			pass = m_nextPass++;
+		}
+
+		if (pass >= passCount)
+			return;
+
+		TraceScopeClass scope("PassRecorderClass::RecordPass");
+
+		m_passes[pass].function(m_contexts[pass], m_passes[pass].data);
+	}
+}
+
+void PassRecorderClass::WorkerThread(int threadIndex)
+{
+	int generation = 0;
+
+	TraceClass::SetThreadName("pass recorder");
+
+	while (true) {
+		{
+			unique_lock<mutex> lock(m_mutex);
+
+			while (!m_quit && m_generation == generation)
+				m_wakeUp.wait(lock);
+
+			if (m_quit)
+				return;
+
+			generation = m_generation;
+		}
+
+		RecordPasses();
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_pending--;
+		}
+
+		m_finished.notify_one();
+	}
+}
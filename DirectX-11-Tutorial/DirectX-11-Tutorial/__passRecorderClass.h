@@ -0,0 +1,78 @@
+// --------------------------------------------------------------------------------------------------------
+// PassRecorderClass records the passes of a frame in parallel: every pass gets a deferred context of the backend,
+// the calling thread and the worker threads take the passes one at a time and record them,
+// then the contexts are executed on the calling thread in the order the passes were added.
+// So the frame the backend gets doesn't depend on the number of threads or on which thread recorded what.
+//
+// A pass is a function that records into the context it is given, with the pointer it was added with.
+// It sets everything it draws with, the target included, and shares nothing but the objects of the backend with the other passes;
+// it doesn't make or release objects while it records.
+// A backend without deferred contexts gets the passes one after the other on the calling thread.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _PASSRECORDERCLASS_H_
+#define _PASSRECORDERCLASS_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+#include "__renderBackendClass.h"
+
+
+
+class PassRecorderClass {
+ public:
+	typedef void (*PassFunctionType)(RenderContextClass *, void *);
+
+ private:
+	struct PassType {
+		PassFunctionType function;
+		void			*data;
+	};
+
+ public:
+	PassRecorderClass();
+	PassRecorderClass(const PassRecorderClass &);
+   ~PassRecorderClass();
+
+	// Initialize starts the threads, 1 records all the passes on the calling thread.
+	bool Initialize(RenderBackendClass *, int);
+	void Shutdown();
+
+	// The passes of the frame, in the order they are executed. ClearPasses keeps the contexts for the next frame.
+	void AddPass(PassFunctionType, void *);
+	void ClearPasses();
+	int	 GetPassCount();
+
+	// Record records the passes and executes them. The passes stay, the next Record records them again.
+	void Record();
+
+	// False when the backend has no deferred contexts.
+	bool IsDeferred();
+
+ private:
+	void RecordPasses();
+	void WorkerThread(int);
+
+ private:
+	RenderBackendClass			*m_backend;
+	vector<PassType>			 m_passes;
+	vector<RenderContextClass*>	 m_contexts;	// of the passes by their index, made as they are needed
+	bool						 m_deferred;
+	int							 m_nextPass;
+
+	// The workers record passes when m_generation changes, and count m_pending down when they are done (like LightClusterClass).
+	int							 m_threadCount;
+	vector<thread>				 m_workers;
+	mutex						 m_mutex;
+	condition_variable			 m_wakeUp, m_finished;
+	int							 m_generation;
+	int							 m_pending;
+	bool						 m_quit;
+};
+
+#endif
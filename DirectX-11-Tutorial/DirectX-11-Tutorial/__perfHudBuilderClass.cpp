@@ -0,0 +1,223 @@
+#include "__perfHudBuilderClass.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// The lines are formatted with the bounded sprintf of the platform.
+#ifdef _WIN32
+#define PERF_HUD_PRINT sprintf_s
+#else
+#define PERF_HUD_PRINT snprintf
+#endif
+
+PerfHudBuilderClass::PerfHudBuilderClass()
+{
+	m_glyphs		  = 0;
+	m_screenWidth	  = 0;
+	m_screenHeight	  = 0;
+	m_barU			  = 0.0f;
+	m_textVertexCount = 0;
+}
+
+PerfHudBuilderClass::PerfHudBuilderClass(const PerfHudBuilderClass& other)
+{
+}
+
+PerfHudBuilderClass::~PerfHudBuilderClass()
+{
+}
+
+bool PerfHudBuilderClass::Initialize(GlyphTableClass *glyphs, int screenWidth, int screenHeight)
+{
+	int bar = GlyphTableClass::GetAsciiGlyph('|');
+
+	if (!glyphs)
+		return false;
+
+	m_glyphs	   = glyphs;
+	m_screenWidth  = screenWidth;
+	m_screenHeight = screenHeight;
+
+	// The vertical bar is a solid stroke one texel wide through the whole height of the font,
+	// so every corner of a bar samples the middle of it: the rectangle is fully covered.
+	m_barU = (glyphs->GetGlyphs()[bar].u0 + glyphs->GetGlyphs()[bar].u1) * 0.5f;
+
+	m_textVertices.resize(6 * PERF_HUD_MAX_LETTERS);
+	m_textVertexCount = 0;
+
+	return true;
+}
+
+void PerfHudBuilderClass::Shutdown()
+{
+	m_textVertices.clear();
+	m_textVertexCount = 0;
+	m_glyphs		  = 0;
+
+	return;
+}
+
+void PerfHudBuilderClass::BuildText(PerfStatsClass *stats, const char *shaderLine, float hudTime)
+{
+	char  line[256];
+	float p50, p95, p99, drawX, drawY;
+	int	  length;
+
+	m_textVertexCount = 0;
+
+	stats->GetPercentiles(&p50, &p95, &p99);
+
+	drawX = (float)(m_screenWidth / -2 + 10);
+	drawY = (float)(m_screenHeight / -2 + 10 + (int)(PERF_HUD_GRAPH_MAX * PERF_HUD_GRAPH_SCALE) + 5 * 18);
+
+	for (int i = 0; i < 5; i++) {
+
+		switch (i) {
+			case 0:
+				PERF_HUD_PRINT(line, sizeof(line), "frame p50 %.2f  p95 %.2f  p99 %.2f ms", p50, p95, p99);
+				break;
+
+			case 1:
+				length = 0;
+				for (int s = 0; s < PERF_SUBSYSTEM_COUNT && length < (int)sizeof(line); s++)
+					length += PERF_HUD_PRINT(line + length, sizeof(line) - length, "%s %.2f  ", PerfStatsClass::GetSubsystemName(s), stats->GetSubsystemTime(s));
+				if (length < (int)sizeof(line))
+					PERF_HUD_PRINT(line + length, sizeof(line) - length, "ms");
+				break;
+
+			case 2:
+				PERF_HUD_PRINT(line, sizeof(line), "draws %d  maps %d  upload %d bytes  state %d sent %d dropped", stats->GetDrawCount(), stats->GetMapCount(),
+							   stats->GetUploadBytes(), stats->GetForwardedStateCalls(), stats->GetFilteredStateCalls());
+				break;
+
+			case 3:
+				if (!shaderLine)
+					continue;
+
+				PERF_HUD_PRINT(line, sizeof(line), "%s", shaderLine);
+				break;
+
+			default:
+				PERF_HUD_PRINT(line, sizeof(line), "hud %.3f ms  (F1 hides)", hudTime);
+				break;
+		}
+
+		m_textVertexCount += BuildLine(line, drawX, drawY, &m_textVertices[m_textVertexCount], (int)m_textVertices.size() - m_textVertexCount);
+		drawY -= 18.0f;
+	}
+
+	return;
+}
+
+int PerfHudBuilderClass::GetTextVertexCount()
+{
+	return m_textVertexCount;
+}
+
+// WriteVertices writes one bar per frame of the history, the newest on the right,
+// green up to 60 fps, yellow up to 30 fps and red below, and two lines at 16.7 and 33.3 ms.
+int PerfHudBuilderClass::WriteVertices(PerfStatsClass *stats, VertexType *vertices)
+{
+	int	  count = m_textVertexCount, frames = stats->GetHistoryCount();
+	float left, bottom, height, ms;
+
+	if (m_textVertexCount > 0)
+		memcpy(vertices, &m_textVertices[0], sizeof(VertexType) * m_textVertexCount);
+
+	left   = (float)(m_screenWidth / -2 + 10);
+	bottom = (float)(m_screenHeight / -2 + 10);
+
+	for (int i = 0; i < frames; i++) {
+
+		ms	   = stats->GetFrameTime(frames - 1 - i);
+		height = (ms < PERF_HUD_GRAPH_MAX ? ms : PERF_HUD_GRAPH_MAX) * PERF_HUD_GRAPH_SCALE;
+
+		if (ms <= 1000.0f / 60.0f)
+			count += BuildBar(vertices + count, left + 3.0f * i, bottom + height, left + 3.0f * i + 2.0f, bottom, 0.0f, 1.0f, 0.0f, 0.8f);
+		else if (ms <= 1000.0f / 30.0f)
+			count += BuildBar(vertices + count, left + 3.0f * i, bottom + height, left + 3.0f * i + 2.0f, bottom, 1.0f, 1.0f, 0.0f, 0.8f);
+		else
+			count += BuildBar(vertices + count, left + 3.0f * i, bottom + height, left + 3.0f * i + 2.0f, bottom, 1.0f, 0.0f, 0.0f, 0.8f);
+	}
+
+	for (int i = 1; i <= 2; i++) {
+		height = 1000.0f / 60.0f * i * PERF_HUD_GRAPH_SCALE;
+
+		count += BuildBar(vertices + count, left, bottom + height + 1.0f, left + 3.0f * PERF_HISTORY, bottom + height, 1.0f, 1.0f, 1.0f, 0.4f);
+	}
+
+	return count;
+}
+
+int PerfHudBuilderClass::GetMaxVertexCount()
+{
+	return 6 * PERF_HUD_MAX_QUADS;
+}
+
+// BuildLine places the letters like FontClass::BuildVertexArray: the box of the glyph from the pen, one pixel between the letters
+// and three pixels for a space. The letters past the room left are left out. It returns the number of vertices.
+int PerfHudBuilderClass::BuildLine(const char *text, float drawX, float drawY, VertexType *vertices, int room)
+{
+	int count = 0;
+
+	for (int i = 0; text[i]; i++) {
+		int letter = GlyphTableClass::GetAsciiGlyph(text[i]);
+
+		if (letter < 0)
+			continue;
+
+		if (letter == 0) {
+			drawX += 3.0f;
+			continue;
+		}
+
+		if (count + 6 > room)
+			break;
+
+		const GlyphTableClass::GlyphType &glyph = m_glyphs->GetGlyphs()[letter];
+
+		for (int corner = 0; corner < 6; corner++) {
+			VertexType &vertex = vertices[count++];
+			float		cx, cy;
+
+			GlyphTableClass::GetQuadCorner(corner, &cx, &cy);
+
+			vertex.x = drawX + glyph.left + cx * glyph.width;
+			vertex.y = drawY - glyph.top  - cy * glyph.height;
+			vertex.z = 0.0f;
+			vertex.u = glyph.u0 + cx * (glyph.u1 - glyph.u0);
+			vertex.v = glyph.v0 + cy * (glyph.v1 - glyph.v0);
+			vertex.r = 1.0f;
+			vertex.g = 1.0f;
+			vertex.b = 1.0f;
+			vertex.a = 1.0f;
+		}
+
+		drawX += glyph.width + 1.0f;
+	}
+
+	return count;
+}
+
+// BuildBar writes the six vertices of a solid rectangle of the given color (left, top, right, bottom on the screen) and returns 6.
+int PerfHudBuilderClass::BuildBar(VertexType *vertices, float left, float top, float right, float bottom, float red, float green, float blue, float alpha)
+{
+	for (int corner = 0; corner < 6; corner++) {
+		VertexType &vertex = vertices[corner];
+		float		cx, cy;
+
+		GlyphTableClass::GetQuadCorner(corner, &cx, &cy);
+
+		vertex.x = cx == 0.0f ? left : right;
+		vertex.y = cy == 0.0f ? top	 : bottom;
+		vertex.z = 0.0f;
+		vertex.u = m_barU;
+		vertex.v = 0.5f;
+		vertex.r = red;
+		vertex.g = green;
+		vertex.b = blue;
+		vertex.a = alpha;
+	}
+
+	return 6;
+}
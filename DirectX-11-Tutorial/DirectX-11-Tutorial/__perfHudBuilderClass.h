@@ -0,0 +1,73 @@
+// --------------------------------------------------------------------------------------------------------
+// PerfHudBuilderClass is the CPU side of the PerfHudClass: the lines of text of the statistics and the bars of the frame time graph,
+// written as the quads of the font shader (six vertices each), so they go out in one draw.
+// The letters are placed with the glyph table of the font, the same boxes and texture rectangles FontClass::BuildVertexArray uses,
+// and the bars sample the middle of the vertical bar glyph, which is solid.
+//
+// PerfHudClass keeps the Direct3D buffers and copies what WriteVertices gives into them; the HeadlessRunnerClass does the same
+// through a backend, which is how the cost of the HUD is measured.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _PERFHUDBUILDERCLASS_H_
+#define _PERFHUDBUILDERCLASS_H_
+
+#include <vector>
+using namespace std;
+
+#include "__glyphTableClass.h"
+#include "__perfStatsClass.h"
+
+// The vertex buffer holds that many quads: the letters of the text and the bars of the graph.
+#define PERF_HUD_MAX_QUADS	 1024
+#define PERF_HUD_MAX_LETTERS 512
+
+// Pixels per millisecond in the graph, and the time at the top of it.
+#define PERF_HUD_GRAPH_SCALE 2.0f
+#define PERF_HUD_GRAPH_MAX	 50.0f
+
+
+
+class PerfHudBuilderClass {
+ public:
+	// The layout of FontShaderClass::VertexType: position, texture coordinates and color.
+	struct VertexType {
+		float x, y, z;
+		float u, v;
+		float r, g, b, a;
+	};
+
+ public:
+	PerfHudBuilderClass();
+	PerfHudBuilderClass(const PerfHudBuilderClass &);
+   ~PerfHudBuilderClass();
+
+	// Initialize takes the glyph table of the ASCII font (FontClass::BuildGlyphTable) and the size of the screen.
+	bool Initialize(GlyphTableClass *, int, int);
+	void Shutdown();
+
+	// BuildText writes the lines of the statistics above the graph, in the bottom left corner of the screen.
+	// The shader line is made by the caller, 0 leaves it out; the HUD time is what the HUD cost in the last frame.
+	// The text is kept until the next BuildText, it only changes a few times per second.
+	void BuildText(PerfStatsClass *, const char *, float);
+	int	 GetTextVertexCount();
+
+	// WriteVertices copies the text and adds the graph of the current history, and returns the number of vertices.
+	// The destination holds GetMaxVertexCount vertices.
+	int	 WriteVertices(PerfStatsClass *, VertexType *);
+	static int GetMaxVertexCount();
+
+ private:
+	int	 BuildLine(const char *, float, float, VertexType *, int);
+	int	 BuildBar(VertexType *, float, float, float, float, float, float, float, float);
+
+ private:
+	GlyphTableClass		   *m_glyphs;
+	int						m_screenWidth, m_screenHeight;
+	float					m_barU;				// the middle of the vertical bar glyph
+
+	vector<VertexType>		m_textVertices;
+	int						m_textVertexCount;
+};
+
+#endif
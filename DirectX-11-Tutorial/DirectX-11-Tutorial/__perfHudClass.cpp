@@ -0,0 +1,305 @@
+#include "__perfHudClass.h"
+#include "__shaderLoaderClass.h"
+
+#include <stdio.h>
+
+// Text refreshes per second, the numbers are unreadable when they change every frame.
+#define PERF_HUD_TEXT_RATE 4
+
+// The vertices the builder writes are the ones of the font shader.
+static_assert(sizeof(PerfHudBuilderClass::VertexType) == sizeof(FontShaderClass::VertexType), "the HUD vertices must match FontShaderClass::VertexType");
+
+PerfHudClass::PerfHudClass()
+{
+	m_Font		 = 0;
+	m_FontShader = 0;
+
+	m_vertexBuffer	 = 0;
+	m_indexBuffer	 = 0;
+	m_maxVertexCount = 0;
+
+	m_enabled	   = false;
+	m_frequency	   = 0;
+	m_ticksPerMs   = 0.0f;
+	m_lastTextTime = 0;
+	m_hudTime	   = 0.0f;
+
+	for (int i = 0; i < PERF_SUBSYSTEM_COUNT; i++)
+		m_start[i] = 0;
+}
+
+PerfHudClass::PerfHudClass(const PerfHudClass& other)
+{
+}
+
+PerfHudClass::~PerfHudClass()
+{
+}
+
+bool PerfHudClass::Initialize(ID3D11Device* device, HWND hwnd, int screenWidth, int screenHeight, D3DXMATRIX baseViewMatrix)
+{
+	bool result;
+
+	m_screenWidth	 = screenWidth;
+	m_screenHeight	 = screenHeight;
+	m_baseViewMatrix = baseViewMatrix;
+
+	// The subsystems are timed with the performance counter, like the HighPrecisionTimer does.
+	QueryPerformanceFrequency((LARGE_INTEGER*)&m_frequency);
+	if (m_frequency == 0)
+		return false;
+
+	m_ticksPerMs = (float)m_frequency / 1000.0f;
+
+	m_Font = new FontClass;
+	if(!m_Font)
+		return false;
+
+	result = m_Font->Initialize(device, "../DirectX-11-Tutorial/data/fontdata.txt", L"../DirectX-11-Tutorial/data/font.dds");
+	if(!result) {
+		MessageBox(hwnd, L"Could not initialize the font object of the performance HUD.", L"Error", MB_OK);
+		return false;
+	}
+
+	m_FontShader = new FontShaderClass;
+	if(!m_FontShader)
+		return false;
+
+	result = m_FontShader->Initialize(device, hwnd);
+	if(!result) {
+		MessageBox(hwnd, L"Could not initialize the font shader object of the performance HUD.", L"Error", MB_OK);
+		return false;
+	}
+
+	// The letters are placed with the glyph table of the font.
+	m_Font->BuildGlyphTable(&m_Glyphs);
+
+	result = m_Builder.Initialize(&m_Glyphs, m_screenWidth, m_screenHeight);
+	if(!result)
+		return false;
+
+	result = InitializeBuffers(device);
+	if(!result) {
+		MessageBox(hwnd, L"Could not initialize the performance HUD buffers.", L"Error", MB_OK);
+		return false;
+	}
+
+	SetEnabled(true);
+
+	return true;
+}
+
+void PerfHudClass::Shutdown()
+{
+	SetEnabled(false);
+
+	ShutdownBuffers();
+
+	m_Builder.Shutdown();
+
+	if(m_FontShader) {
+		m_FontShader->Shutdown();
+		delete m_FontShader;
+		m_FontShader = 0;
+	}
+
+	if(m_Font) {
+		m_Font->Shutdown();
+		delete m_Font;
+		m_Font = 0;
+	}
+
+	return;
+}
+
+// Showing the HUD starts a fresh history, the frames before it were not counted.
+void PerfHudClass::SetEnabled(bool enabled)
+{
+	m_enabled = enabled;
+
+	PerfStatsClass::SetCounting(enabled);
+
+	if (enabled) {
+		m_Stats.Reset();
+		m_lastTextTime = 0;
+	}
+
+	return;
+}
+
+bool PerfHudClass::IsEnabled()
+{
+	return m_enabled;
+}
+
+void PerfHudClass::Toggle()
+{
+	SetEnabled(!m_enabled);
+
+	return;
+}
+
+void PerfHudClass::Begin(int subsystem)
+{
+	if (!m_enabled)
+		return;
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&m_start[subsystem]);
+
+	return;
+}
+
+void PerfHudClass::End(int subsystem)
+{
+	INT64 now;
+
+	if (!m_enabled)
+		return;
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&now);
+
+	m_Stats.AddTime(subsystem, (float)(now - m_start[subsystem]) / m_ticksPerMs);
+
+	return;
+}
+
+void PerfHudClass::EndFrame(float frameTime)
+{
+	if (!m_enabled)
+		return;
+
+	m_Stats.EndFrame(frameTime);
+
+	return;
+}
+
+// Render writes the text and the graph into the vertex buffer and draws them with one call.
+bool PerfHudClass::Render(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX orthoMatrix)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT		 result;
+	INT64		 start, now;
+	int			 vertexCount;
+	unsigned int stride, offset;
+
+	if (!m_enabled)
+		return true;
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&start);
+
+	// Refresh the numbers a few times per second.
+	if (m_lastTextTime == 0 || start - m_lastTextTime >= m_frequency / PERF_HUD_TEXT_RATE) {
+		BuildText();
+		m_lastTextTime = start;
+	}
+
+	result = deviceContext->Map(m_vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if(FAILED(result))
+		return false;
+
+	vertexCount = m_Builder.WriteVertices(&m_Stats, (PerfHudBuilderClass::VertexType*)mappedResource.pData);
+
+	deviceContext->Unmap(m_vertexBuffer, 0);
+
+	PerfStatsClass::CountMap(sizeof(PerfHudBuilderClass::VertexType) * vertexCount);
+
+	stride = sizeof(PerfHudBuilderClass::VertexType);
+	offset = 0;
+
+	deviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
+	deviceContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// Like the TextOutClass, the HUD uses the base view matrix so it stays in place on the screen.
+	if (!m_FontShader->Render(deviceContext, vertexCount, worldMatrix, m_baseViewMatrix, orthoMatrix, m_Font->GetTexture()))
+		return false;
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&now);
+	m_hudTime = (float)(now - start) / m_ticksPerMs;
+
+	return true;
+}
+
+PerfStatsClass* PerfHudClass::GetStats()
+{
+	return &m_Stats;
+}
+
+// The vertex buffer is dynamic and rewritten every frame, the index buffer is static, as for the text of the TextOutClass.
+bool PerfHudClass::InitializeBuffers(ID3D11Device* device)
+{
+	unsigned long* indices;
+	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
+	D3D11_SUBRESOURCE_DATA indexData;
+	HRESULT result;
+
+	m_maxVertexCount = PerfHudBuilderClass::GetMaxVertexCount();
+
+	indices = new unsigned long[m_maxVertexCount];
+	if(!indices)
+		return false;
+
+	for(int i = 0; i < m_maxVertexCount; i++)
+		indices[i] = i;
+
+	vertexBufferDesc.Usage			= D3D11_USAGE_DYNAMIC;
+	vertexBufferDesc.ByteWidth		= sizeof(PerfHudBuilderClass::VertexType) * m_maxVertexCount;
+	vertexBufferDesc.BindFlags		= D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	vertexBufferDesc.MiscFlags		= 0;
+	vertexBufferDesc.StructureByteStride = 0;
+
+	result = device->CreateBuffer(&vertexBufferDesc, NULL, &m_vertexBuffer);
+	if(FAILED(result)) {
+		delete [] indices;
+		return false;
+	}
+
+	indexBufferDesc.Usage			= D3D11_USAGE_IMMUTABLE;
+	indexBufferDesc.ByteWidth		= sizeof(unsigned long) * m_maxVertexCount;
+	indexBufferDesc.BindFlags		= D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.CPUAccessFlags	= 0;
+	indexBufferDesc.MiscFlags		= 0;
+	indexBufferDesc.StructureByteStride = 0;
+
+	indexData.pSysMem	  = indices;
+	indexData.SysMemPitch = 0;
+	indexData.SysMemSlicePitch = 0;
+
+	result = device->CreateBuffer(&indexBufferDesc, &indexData, &m_indexBuffer);
+
+	delete [] indices;
+	indices = 0;
+
+	if(FAILED(result))
+		return false;
+
+	return true;
+}
+
+void PerfHudClass::ShutdownBuffers()
+{
+	if(m_indexBuffer) {
+		m_indexBuffer->Release();
+		m_indexBuffer = 0;
+	}
+
+	if(m_vertexBuffer) {
+		m_vertexBuffer->Release();
+		m_vertexBuffer = 0;
+	}
+}
+
+// BuildText gives the builder the line of the shader cache, which only the HUD knows about, and the cost of the last frame of the HUD.
+void PerfHudClass::BuildText()
+{
+	char line[128];
+	const ShaderCacheClass::StatsType &shaders = ShaderLoaderClass::GetStats();
+
+	sprintf_s(line, sizeof(line), "shaders %.1f ms  cached %d  compiled %d  saved %.0f ms",
+			  ShaderLoaderClass::GetLoadTime(), shaders.hits, shaders.misses, shaders.savedTime);
+
+	m_Builder.BuildText(&m_Stats, line, m_hudTime);
+
+	return;
+}
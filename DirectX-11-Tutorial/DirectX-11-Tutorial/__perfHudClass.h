@@ -0,0 +1,69 @@
+// The PerfHudClass draws the performance overlay: a graph of the last frame times, their percentiles,
+// the CPU time of every subsystem, the draw calls, Maps and bytes uploaded per frame and the state calls sent and dropped.
+// The text and the bars of the graph are all quads in the font texture, built by the PerfHudBuilderClass
+// into one dynamic vertex buffer and drawn with one call of the FontShaderClass.
+//
+// The subsystems are timed with Begin and End around their work. When the HUD is hidden these calls,
+// the counters of the PerfStatsClass and Render do nothing but test a flag.
+
+#ifndef _PERFHUDCLASS_H_
+#define _PERFHUDCLASS_H_
+
+#include "__fontClass.h"
+#include "__fontShaderClass.h"
+#include "__perfStatsClass.h"
+#include "__perfHudBuilderClass.h"
+
+class PerfHudClass {
+ public:
+	PerfHudClass();
+	PerfHudClass(const PerfHudClass &);
+   ~PerfHudClass();
+
+	bool Initialize(ID3D11Device*, HWND, int, int, D3DXMATRIX);
+	void Shutdown();
+
+	void SetEnabled(bool);
+	bool IsEnabled();
+	void Toggle();
+
+	// Begin and End time a piece of work of a subsystem (PERF_INPUT, PERF_ANIMATION, ...).
+	void Begin(int);
+	void End(int);
+
+	// EndFrame is called once per frame with the time of the frame in milliseconds.
+	void EndFrame(float);
+
+	bool Render(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX);
+
+	PerfStatsClass* GetStats();
+
+ private:
+	bool InitializeBuffers(ID3D11Device*);
+	void ShutdownBuffers();
+	void BuildText();
+
+ private:
+	FontClass		*m_Font;
+	FontShaderClass	*m_FontShader;
+	int				 m_screenWidth, m_screenHeight;
+	D3DXMATRIX		 m_baseViewMatrix;
+
+	ID3D11Buffer	*m_vertexBuffer, *m_indexBuffer;
+	int				 m_maxVertexCount;
+
+	// The text only changes a few times per second, the builder keeps its vertices between the frames.
+	GlyphTableClass	 m_Glyphs;
+	PerfHudBuilderClass m_Builder;
+
+	PerfStatsClass	 m_Stats;
+	bool			 m_enabled;
+
+	INT64			 m_frequency;
+	float			 m_ticksPerMs;
+	INT64			 m_start[PERF_SUBSYSTEM_COUNT];
+	INT64			 m_lastTextTime;
+	float			 m_hudTime;			// what the HUD itself cost in the last frame
+};
+
+#endif
@@ -0,0 +1,196 @@
+#include "__perfStatsClass.h"
+
+#include <algorithm>
+using namespace std;
+
+bool		PerfStatsClass::s_counting = false;
+atomic<int> PerfStatsClass::s_draws(0);
+atomic<int> PerfStatsClass::s_maps(0);
+atomic<int> PerfStatsClass::s_bytes(0);
+
+PerfStatsClass::PerfStatsClass()
+{
+	Reset();
+}
+
+PerfStatsClass::PerfStatsClass(const PerfStatsClass& other)
+{
+}
+
+PerfStatsClass::~PerfStatsClass()
+{
+}
+
+void PerfStatsClass::Reset()
+{
+	m_historyStart = 0;
+	m_historyCount = 0;
+
+	for (int i = 0; i < PERF_SUBSYSTEM_COUNT; i++) {
+		m_current[i] = 0.0f;
+		m_last[i]	 = 0.0f;
+	}
+
+	m_lastDraws = 0;
+	m_lastMaps	= 0;
+	m_lastBytes = 0;
+
+	m_currentForwarded = 0;
+	m_currentFiltered  = 0;
+	m_lastForwarded	   = 0;
+	m_lastFiltered	   = 0;
+
+	s_draws = 0;
+	s_maps	= 0;
+	s_bytes = 0;
+
+	return;
+}
+
+void PerfStatsClass::AddTime(int subsystem, float ms)
+{
+	m_current[subsystem] += ms;
+
+	return;
+}
+
+// The history is a ring buffer, m_historyStart is the oldest frame once it is full.
+void PerfStatsClass::EndFrame(float frameTime)
+{
+	if (m_historyCount < PERF_HISTORY) {
+		m_history[m_historyCount++] = frameTime;
+	}
+	else {
+		m_history[m_historyStart] = frameTime;
+		m_historyStart = (m_historyStart + 1) % PERF_HISTORY;
+	}
+
+	for (int i = 0; i < PERF_SUBSYSTEM_COUNT; i++) {
+		m_last[i]	 = m_current[i];
+		m_current[i] = 0.0f;
+	}
+
+	m_lastDraws = s_draws;
+	m_lastMaps	= s_maps;
+	m_lastBytes = s_bytes;
+
+	m_lastForwarded	   = m_currentForwarded;
+	m_lastFiltered	   = m_currentFiltered;
+	m_currentForwarded = 0;
+	m_currentFiltered  = 0;
+
+	s_draws = 0;
+	s_maps	= 0;
+	s_bytes = 0;
+
+	return;
+}
+
+float PerfStatsClass::GetFrameTime(int age)
+{
+	if (age < 0 || age >= m_historyCount)
+		return 0.0f;
+
+	return m_history[(m_historyStart + m_historyCount - 1 - age) % PERF_HISTORY];
+}
+
+int PerfStatsClass::GetHistoryCount()
+{
+	return m_historyCount;
+}
+
+// Nearest rank: the p percentile is the smallest time that at least p percent of the frames don't exceed.
+void PerfStatsClass::GetPercentiles(float *p50, float *p95, float *p99)
+{
+	int count = m_historyCount;
+
+	if (count == 0) {
+		*p50 = *p95 = *p99 = 0.0f;
+		return;
+	}
+
+	for (int i = 0; i < count; i++)
+		m_sorted[i] = m_history[i];
+
+	sort(m_sorted, m_sorted + count);
+
+	*p50 = m_sorted[(count * 50 + 99) / 100 - 1];
+	*p95 = m_sorted[(count * 95 + 99) / 100 - 1];
+	*p99 = m_sorted[(count * 99 + 99) / 100 - 1];
+
+	return;
+}
+
+float PerfStatsClass::GetSubsystemTime(int subsystem)
+{
+	return m_last[subsystem];
+}
+
+int PerfStatsClass::GetDrawCount()
+{
+	return m_lastDraws;
+}
+
+int PerfStatsClass::GetMapCount()
+{
+	return m_lastMaps;
+}
+
+int PerfStatsClass::GetUploadBytes()
+{
+	return m_lastBytes;
+}
+
+void PerfStatsClass::SetStateCalls(int forwarded, int filtered)
+{
+	m_currentForwarded = forwarded;
+	m_currentFiltered  = filtered;
+
+	return;
+}
+
+int PerfStatsClass::GetForwardedStateCalls()
+{
+	return m_lastForwarded;
+}
+
+int PerfStatsClass::GetFilteredStateCalls()
+{
+	return m_lastFiltered;
+}
+
+const char* PerfStatsClass::GetSubsystemName(int subsystem)
+{
+	static const char *names[PERF_SUBSYSTEM_COUNT] = { "input", "anim", "text", "2d", "3d", "lights" };
+
+	return names[subsystem];
+}
+
+void PerfStatsClass::SetCounting(bool counting)
+{
+	s_counting = counting;
+	s_draws	   = 0;
+	s_maps	   = 0;
+	s_bytes	   = 0;
+
+	return;
+}
+
+void PerfStatsClass::CountDraw()
+{
+	if (s_counting)
+		s_draws++;
+
+	return;
+}
+
+// A Map, or an UpdateSubresource, that wrote the given number of bytes.
+void PerfStatsClass::CountMap(int bytes)
+{
+	if (s_counting) {
+		s_maps++;
+		s_bytes += bytes;
+	}
+
+	return;
+}
@@ -0,0 +1,85 @@
+// --------------------------------------------------------------------------------------------------------
+// PerfStatsClass collects what the performance HUD shows: the frame times of the last PERF_HISTORY frames
+// with their percentiles, the CPU time spent in every subsystem during the last frame,
+// and the draw calls, buffer Maps and bytes uploaded during the last frame,
+// with the state calls the state filter of the device context forwarded and dropped.
+//
+// The draw and upload counters are static, so the shader and buffer classes can count without knowing about the HUD:
+// they call CountDraw and CountMap next to their Draw and Map calls. While counting is off (the HUD is hidden)
+// these calls only test a flag. The counters are atomic, the passes recorded on other threads count their draws too.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _PERFSTATSCLASS_H_
+#define _PERFSTATSCLASS_H_
+
+#include <atomic>
+using namespace std;
+
+#define PERF_INPUT			  0
+#define PERF_ANIMATION		  1
+#define PERF_TEXT			  2
+#define PERF_2D				  3
+#define PERF_3D				  4
+#define PERF_LIGHTS			  5
+#define PERF_SUBSYSTEM_COUNT  6
+
+// Number of frames kept for the graph and the percentiles
+#define PERF_HISTORY 128
+
+
+
+class PerfStatsClass {
+ public:
+	PerfStatsClass();
+	PerfStatsClass(const PerfStatsClass &);
+   ~PerfStatsClass();
+
+	void Reset();
+
+	// AddTime adds milliseconds to the time of a subsystem in the current frame, a subsystem can be timed in several pieces.
+	void AddTime(int, float);
+
+	// EndFrame closes the current frame with its total time in milliseconds: its subsystem times and counters become the last frame.
+	void EndFrame(float);
+
+	// The frame time of the given age, 0 being the last frame. The history holds GetHistoryCount frames.
+	float GetFrameTime(int);
+	int   GetHistoryCount();
+
+	// The 50th, 95th and 99th percentile of the frame times in the history (nearest rank).
+	void  GetPercentiles(float *, float *, float *);
+
+	float GetSubsystemTime(int);
+	int   GetDrawCount();
+	int   GetMapCount();
+	int   GetUploadBytes();
+
+	// SetStateCalls takes the counters of the state filter for the current frame.
+	void  SetStateCalls(int, int);
+	int   GetForwardedStateCalls();
+	int   GetFilteredStateCalls();
+
+	static const char* GetSubsystemName(int);
+
+	// The counters shared by the whole program.
+	static void SetCounting(bool);
+	static void CountDraw();
+	static void CountMap(int);
+
+ private:
+	float	m_history[PERF_HISTORY];
+	int		m_historyStart, m_historyCount;
+	float	m_sorted[PERF_HISTORY];
+
+	float	m_current[PERF_SUBSYSTEM_COUNT];
+	float	m_last[PERF_SUBSYSTEM_COUNT];
+	int		m_lastDraws, m_lastMaps, m_lastBytes;
+	int		m_currentForwarded, m_currentFiltered;
+	int		m_lastForwarded, m_lastFiltered;
+
+	static bool		   s_counting;
+	static atomic<int> s_draws, s_maps, s_bytes;
+};
+
+#endif
@@ -0,0 +1,145 @@
+// --------------------------------------------------------------------------------------------------------
+// RenderBackendClass is what the renderer needs from a GPU: buffers, textures, shaders and states to create,
+// and the bindings and draws to submit. d3dClass implements it on top of its device and its (filtered) device context,
+// HeadlessBackendClass records the calls into a command stream without any GPU, so the frame work runs and can be timed anywhere,
+// and SoftwareBackendClass draws them on the CPU with the C++ twins of the shaders.
+//
+// The objects are handles, 0 being no object. A handle is only meaningful to the backend that made it.
+// What the backend does is what d3dClass sets up: triangle lists, 32 bit indices, one linear wrap sampler in slot 0
+// of the pixel shader, and the states it switches with TurnZBufferOn/Off and TurnOn/OffAlphaBlending.
+//
+// A shader is its compiled code and its entry point; a vertex shader also takes the input layout of its vertices,
+// which is bound with it. A backend that does not run the code identifies the shader by its entry point (and its features).
+//
+// The buffer updates, bindings and draws are the RenderContextClass part of a backend, which a pass records with.
+// A deferred context records them on its own thread, to be executed by the backend later, in the order the backend is given them.
+// The deferred contexts share the objects of their backend, which are not made or released while they record.
+// A deferred context starts with nothing bound, not even the target: a pass sets everything it draws with, SetRenderTarget(0) included.
+// After executing one the backend draws into the back buffer again, and the calls that follow set the other bindings again too.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _RENDERBACKENDCLASS_H_
+#define _RENDERBACKENDCLASS_H_
+
+// The kinds of buffers
+#define RENDER_BUFFER_VERTEX	 0
+#define RENDER_BUFFER_INDEX		 1
+#define RENDER_BUFFER_CONSTANT	 2
+#define RENDER_BUFFER_STRUCTURED 3		// read by the shaders like a texture
+
+// The stages of the shaders, a binding can be for both
+#define RENDER_STAGE_VERTEX 1
+#define RENDER_STAGE_PIXEL	2
+
+// The texture formats, the DXGI_FORMAT values
+#define RENDER_FORMAT_RGBA32F 2
+#define RENDER_FORMAT_RGBA8	  28
+#define RENDER_FORMAT_R8	  61
+
+// The most slots of a single binding call
+#define RENDER_MAX_BINDINGS 8
+
+
+
+class RenderContextClass {
+ public:
+	typedef unsigned int HandleType;
+
+ public:
+	virtual ~RenderContextClass()
+	{
+	}
+
+	// UpdateBuffer replaces the contents of a dynamic buffer from its start.
+	virtual bool UpdateBuffer(HandleType, const void *, int) = 0;
+
+	// SetRenderTarget draws into a render target texture, without depth buffer, or into the back buffer again with 0.
+	// The viewport is the size of the target. Clear clears the color of the current target.
+	virtual void SetRenderTarget(HandleType) = 0;
+	virtual void Clear(const float *) = 0;
+
+	virtual void SetState(HandleType) = 0;
+	virtual void SetShaders(HandleType, HandleType) = 0;
+	virtual void SetVertexBuffers(int, int, const HandleType *, const unsigned int *, const unsigned int *) = 0;
+	virtual void SetIndexBuffer(HandleType) = 0;
+
+	// The bindings take the stages, the first slot, the count and the handles. The textures are textures or structured buffers.
+	virtual void SetConstantBuffers(int, int, int, const HandleType *) = 0;
+	virtual void SetTextures(int, int, int, const HandleType *) = 0;
+
+	// The draws take their arguments in the order of the D3D11 calls.
+	virtual void Draw(int, int) = 0;
+	virtual void DrawIndexed(int, int, int) = 0;
+	virtual void DrawInstanced(int, int, int, int) = 0;
+	virtual void DrawIndexedInstanced(int, int, int, int, int) = 0;
+};
+
+
+
+class RenderBackendClass : public RenderContextClass {
+ public:
+	struct BufferDescType {
+		int	 type;
+		int	 size;			// in bytes
+		int	 stride;		// the size of an element of a structured buffer
+		bool dynamic;		// written with UpdateBuffer, otherwise only by the initial data
+	};
+
+	struct TextureDescType {
+		int	 width, height;
+		int	 format;
+		bool renderTarget;	// it can be drawn into with SetRenderTarget
+	};
+
+	// An element of a vertex input layout, in the terms of D3D11_INPUT_ELEMENT_DESC (the format is a DXGI_FORMAT value)
+	struct VertexElementType {
+		const char *semantic;
+		int			semanticIndex;
+		int			format;
+		int			slot;
+		int			offset;
+		bool		perInstance;
+	};
+
+	struct ShaderDescType {
+		int						 stage;
+		const char				*entry;
+		unsigned long long		 features;			// the SHADER_FEATURE_ bits of a shader variant, for the backends that run their own twin of it
+		const void				*code;
+		int						 size;
+		const VertexElementType *elements;		// the input layout of a vertex shader
+		int						 elementCount;
+	};
+
+	struct StateDescType {
+		bool alphaBlending;		// SRC_ALPHA, INV_SRC_ALPHA
+		bool depthTest;			// LESS
+		bool depthWrite;
+		bool cullBack;
+	};
+
+ public:
+	virtual ~RenderBackendClass()
+	{
+	}
+
+	// The Create functions return 0 when the object can't be made. A texture takes its rows of pixels with their pitch in bytes, or no data.
+	virtual HandleType CreateBuffer(const BufferDescType &, const void *) = 0;
+	virtual HandleType CreateTexture(const TextureDescType &, const void *, int) = 0;
+	virtual HandleType CreateShader(const ShaderDescType &) = 0;
+	virtual HandleType CreateState(const StateDescType &) = 0;
+	virtual void	   Release(HandleType) = 0;
+
+	// BeginFrame clears the back buffer to the color and the depth buffer, EndFrame shows the frame.
+	virtual void BeginFrame(const float *) = 0;
+	virtual void EndFrame() = 0;
+
+	// CreateDeferredContext returns 0 when the backend can't record on other threads.
+	// ExecuteDeferredContext runs what the context recorded, which leaves it empty to record again.
+	virtual RenderContextClass* CreateDeferredContext() = 0;
+	virtual void				ExecuteDeferredContext(RenderContextClass *) = 0;
+	virtual void				ReleaseDeferredContext(RenderContextClass *) = 0;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "__renderTextureClass.h"
+
+RenderTextureClass::RenderTextureClass()
+{
+	m_d3d				  = 0;
+	m_renderTargetTexture = 0;
+	m_renderTargetView	  = 0;
+	m_shaderResourceView  = 0;
+}
+
+RenderTextureClass::RenderTextureClass(const RenderTextureClass& other)
+{
+}
+
+RenderTextureClass::~RenderTextureClass()
+{
+}
+
+// Initialize creates the texture, a render target view to draw into it and a shader resource view to read from it.
+bool RenderTextureClass::Initialize(d3dClass *d3d, int textureWidth, int textureHeight)
+{
+	D3D11_TEXTURE2D_DESC			textureDesc;
+	D3D11_RENDER_TARGET_VIEW_DESC	renderTargetViewDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC	shaderResourceViewDesc;
+	HRESULT							result;
+
+	m_d3d = d3d;
+
+	// Setup the render target texture description.
+	ZeroMemory(&textureDesc, sizeof(textureDesc));
+
+	textureDesc.Width			 = textureWidth;
+	textureDesc.Height			 = textureHeight;
+	textureDesc.MipLevels		 = 1;
+	textureDesc.ArraySize		 = 1;
+	textureDesc.Format			 = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage			 = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags		 = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	textureDesc.CPUAccessFlags	 = 0;
+	textureDesc.MiscFlags		 = 0;
+
+	// Create the render target texture.
+	result = d3d->GetDevice()->CreateTexture2D(&textureDesc, NULL, &m_renderTargetTexture);
+	if (FAILED(result))
+		return false;
+
+	// Setup the description of the render target view.
+	renderTargetViewDesc.Format				= textureDesc.Format;
+	renderTargetViewDesc.ViewDimension		= D3D11_RTV_DIMENSION_TEXTURE2D;
+	renderTargetViewDesc.Texture2D.MipSlice = 0;
+
+	// Create the render target view.
+	result = d3d->GetDevice()->CreateRenderTargetView(m_renderTargetTexture, &renderTargetViewDesc, &m_renderTargetView);
+	if (FAILED(result))
+		return false;
+
+	// Setup the description of the shader resource view.
+	shaderResourceViewDesc.Format					 = textureDesc.Format;
+	shaderResourceViewDesc.ViewDimension			 = D3D11_SRV_DIMENSION_TEXTURE2D;
+	shaderResourceViewDesc.Texture2D.MostDetailedMip = 0;
+	shaderResourceViewDesc.Texture2D.MipLevels		 = 1;
+
+	// Create the shader resource view.
+	result = d3d->GetDevice()->CreateShaderResourceView(m_renderTargetTexture, &shaderResourceViewDesc, &m_shaderResourceView);
+	if (FAILED(result))
+		return false;
+
+	// The viewport covers the whole texture.
+	m_viewport.Width	= (float)textureWidth;
+	m_viewport.Height	= (float)textureHeight;
+	m_viewport.MinDepth = 0.0f;
+	m_viewport.MaxDepth = 1.0f;
+	m_viewport.TopLeftX = 0.0f;
+	m_viewport.TopLeftY = 0.0f;
+
+	return true;
+}
+
+void RenderTextureClass::Shutdown()
+{
+	if (m_shaderResourceView) {
+		m_shaderResourceView->Release();
+		m_shaderResourceView = 0;
+	}
+
+	if (m_renderTargetView) {
+		m_renderTargetView->Release();
+		m_renderTargetView = 0;
+	}
+
+	if (m_renderTargetTexture) {
+		m_renderTargetTexture->Release();
+		m_renderTargetTexture = 0;
+	}
+
+	return;
+}
+
+// SetRenderTarget makes the texture the current render target. The layers are 2D only, so no depth buffer is bound.
+void RenderTextureClass::SetRenderTarget()
+{
+	ID3D11ShaderResourceView *nullView = 0;
+
+	// The texture can't be read and written at the same time, so make sure it is not still bound from the last composite.
+	m_d3d->GetDeviceContext()->PSSetShaderResources(0, 1, &nullView);
+
+	m_d3d->GetDeviceContext()->OMSetRenderTargets(1, &m_renderTargetView, NULL);
+	m_d3d->GetDeviceContext()->RSSetViewports(1, &m_viewport);
+
+	return;
+}
+
+void RenderTextureClass::ClearRenderTarget(float red, float green, float blue, float alpha)
+{
+	float color[4] = { red, green, blue, alpha };
+
+	m_d3d->GetDeviceContext()->ClearRenderTargetView(m_renderTargetView, color);
+
+	return;
+}
+
+ID3D11ShaderResourceView* RenderTextureClass::GetShaderResourceView()
+{
+	return m_shaderResourceView;
+}
+
+ID3D11RenderTargetView* RenderTextureClass::GetRenderTargetView()
+{
+	return m_renderTargetView;
+}
+
+// A layer starts out fully transparent, so whatever is not drawn in it shows the scene below.
+bool RenderTextureClass::BeginLayer()
+{
+	SetRenderTarget();
+	ClearRenderTarget(0.0f, 0.0f, 0.0f, 0.0f);
+
+	return true;
+}
+
+void RenderTextureClass::EndLayer()
+{
+	m_d3d->SetBackBufferRenderTarget();
+	m_d3d->ResetViewport();
+
+	return;
+}
@@ -0,0 +1,42 @@
+// --------------------------------------------------------------------------------------------------------
+// RenderTextureClass is a texture that can be rendered into instead of the back buffer, and then used as a regular texture by the shaders.
+// It is the Direct3D target of the LayerCacheClass: a cached 2D layer is drawn into it once and composited onto the screen every frame.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _RENDERTEXTURECLASS_H_
+#define _RENDERTEXTURECLASS_H_
+
+#include <d3d11.h>
+
+#include "__d3dClass.h"
+#include "__layerCacheClass.h"
+
+
+
+class RenderTextureClass : public LayerTargetClass {
+ public:
+	RenderTextureClass();
+	RenderTextureClass(const RenderTextureClass &);
+   ~RenderTextureClass();
+
+	bool Initialize(d3dClass *, int, int);
+	void Shutdown();
+
+	void SetRenderTarget();
+	void ClearRenderTarget(float, float, float, float);
+	ID3D11ShaderResourceView* GetShaderResourceView();
+	ID3D11RenderTargetView*	  GetRenderTargetView();
+
+	// LayerTargetClass
+	bool BeginLayer();
+	void EndLayer();
+
+ private:
+	d3dClass				 *m_d3d;
+	ID3D11Texture2D			 *m_renderTargetTexture;
+	ID3D11RenderTargetView	 *m_renderTargetView;
+	ID3D11ShaderResourceView *m_shaderResourceView;
+	D3D11_VIEWPORT			  m_viewport;
+};
+
+#endif
@@ -0,0 +1,169 @@
+#include "__sdfGeneratorClass.h"
+
+#include <math.h>
+
+// Far enough to be "no texel of that kind", small enough to keep the parabola intersections finite in float.
+#define SDF_INFINITY 1e20f
+
+SdfGeneratorClass::SdfGeneratorClass()
+{
+}
+
+SdfGeneratorClass::SdfGeneratorClass(const SdfGeneratorClass& other)
+{
+}
+
+SdfGeneratorClass::~SdfGeneratorClass()
+{
+}
+
+void SdfGeneratorClass::Generate(const unsigned char *coverage, int width, int height, int spread, vector<unsigned char> *field)
+{
+	int fieldWidth	= width	 + 2 * spread;
+	int fieldHeight = height + 2 * spread;
+	int size		= fieldWidth * fieldHeight;
+
+	m_outside.assign(size, SDF_INFINITY);
+	m_inside.assign(size, 0.0f);
+	m_distance.resize(size);
+	field->resize(size);
+
+	// A texel at least half covered is inside the glyph. The padding around the bitmap is outside.
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			if (coverage[y * width + x] >= 128) {
+				int i = (y + spread) * fieldWidth + x + spread;
+
+				m_outside[i] = 0.0f;
+				m_inside[i]	 = SDF_INFINITY;
+			}
+
+	Transform(&m_outside[0], fieldWidth, fieldHeight);
+	Transform(&m_inside[0],	 fieldWidth, fieldHeight);
+
+	for (int y = 0; y < fieldHeight; y++)
+		for (int x = 0; x < fieldWidth; x++) {
+			int	  i = y * fieldWidth + x;
+			float distance;
+
+			// The outline lies half way between the centers of an inside and an outside texel.
+			if (m_outside[i] > 0.0f)
+				distance = sqrtf(m_outside[i]) - 0.5f;
+			else
+				distance = 0.5f - sqrtf(m_inside[i]);
+
+			// The texels on the outline know better from their own coverage where the outline crosses them.
+			int bx = x - spread;
+			int by = y - spread;
+
+			if (bx >= 0 && bx < width && by >= 0 && by < height) {
+				unsigned char c = coverage[by * width + bx];
+
+				if (c > 0 && c < 255)
+					distance = 0.5f - c / 255.0f;
+			}
+
+			m_distance[i] = distance;
+
+			// 0.5 on the outline, 1 at spread pixels inside, 0 at spread pixels outside.
+			float value = 0.5f - distance / (2.0f * spread);
+
+			if (value < 0.0f) value = 0.0f;
+			if (value > 1.0f) value = 1.0f;
+
+			(*field)[i] = (unsigned char)(value * 255.0f + 0.5f);
+		}
+
+	return;
+}
+
+const float* SdfGeneratorClass::GetDistances()
+{
+	return &m_distance[0];
+}
+
+// The same math as FontSdfPixelShader: the field is cut at 0.5 with a smoothstep one screen pixel wide.
+float SdfGeneratorClass::ReferenceCoverage(float distance, float width)
+{
+	float t;
+
+	if (width < 0.0001f)
+		width = 0.0001f;
+
+	t = (distance - (0.5f - width)) / (2.0f * width);
+
+	if (t < 0.0f) t = 0.0f;
+	if (t > 1.0f) t = 1.0f;
+
+	return t * t * (3.0f - 2.0f * t);
+}
+
+// Transform replaces every value of the grid (0 on the texels of interest, SDF_INFINITY elsewhere)
+// with the squared distance to the nearest texel of interest: the columns first, then the rows.
+void SdfGeneratorClass::Transform(float *grid, int width, int height)
+{
+	int n = width > height ? width : height;
+
+	m_line.resize(n);
+	m_result.resize(n);
+	m_envelope.resize(n + 1);
+	m_vertices.resize(n);
+
+	for (int x = 0; x < width; x++) {
+		for (int y = 0; y < height; y++)
+			m_line[y] = grid[y * width + x];
+
+		Transform1D(&m_line[0], &m_result[0], height);
+
+		for (int y = 0; y < height; y++)
+			grid[y * width + x] = m_result[y];
+	}
+
+	for (int y = 0; y < height; y++) {
+		Transform1D(grid + y * width, &m_result[0], width);
+
+		for (int x = 0; x < width; x++)
+			grid[y * width + x] = m_result[x];
+	}
+
+	return;
+}
+
+// Transform1D is the lower envelope of the parabolas rooted at every sample: d(q) = min over p of (q - p)^2 + f(p).
+void SdfGeneratorClass::Transform1D(const float *f, float *d, int n)
+{
+	float *z = &m_envelope[0];		// boundaries between the parabolas of the envelope
+	int	  *v = &m_vertices[0];		// roots of the parabolas of the envelope
+	int	   k = 0;
+	float  s;
+
+	v[0] = 0;
+	z[0] = -SDF_INFINITY;
+	z[1] =	SDF_INFINITY;
+
+	for (int q = 1; q < n; q++) {
+		s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+
+		// Drop the parabolas the new one hides. z[0] is minus infinity, so k never goes below 0.
+		while (s <= z[k]) {
+			k--;
+			s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+		}
+
+		k++;
+		v[k]	 = q;
+		z[k]	 = s;
+		z[k + 1] = SDF_INFINITY;
+	}
+
+	k = 0;
+
+	for (int q = 0; q < n; q++) {
+		while (z[k + 1] < q)
+			k++;
+
+		d[q] = (float)((q - v[k]) * (q - v[k])) + f[v[k]];
+	}
+
+	return;
+}
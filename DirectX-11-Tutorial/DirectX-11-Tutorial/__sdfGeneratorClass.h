@@ -0,0 +1,53 @@
+// --------------------------------------------------------------------------------------------------------
+// SdfGeneratorClass turns the coverage bitmap of a glyph into a signed distance field.
+// Every texel of the field tells how far it is from the outline of the glyph, so the letter can be drawn
+// at any size from one small bitmap: the pixel shader cuts the field at the outline and smooths the cut over one screen pixel.
+//
+// The distances are computed with the exact euclidean distance transform of Felzenszwalb and Huttenlocher
+// (two one dimensional passes of lower envelopes of parabolas), once for the outside and once for the inside of the glyph.
+// A texel stores 0.5 on the outline, more inside and less outside; spread pixels away from the outline the field is 0 or 1.
+// The field is bigger than the bitmap by spread pixels on every side, so the outside distances fit in.
+//
+// ReferenceCoverage is the C++ twin of FontSdfPixelShader in _shaderFont.ps, they must be kept in sync.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SDFGENERATORCLASS_H_
+#define _SDFGENERATORCLASS_H_
+
+#include <vector>
+using namespace std;
+
+
+
+class SdfGeneratorClass {
+ public:
+	SdfGeneratorClass();
+	SdfGeneratorClass(const SdfGeneratorClass &);
+   ~SdfGeneratorClass();
+
+	// Generate takes the 8 bit coverage of a width x height bitmap and the spread in pixels,
+	// and writes the (width + 2 * spread) x (height + 2 * spread) field into the output vector.
+	void Generate(const unsigned char *, int, int, int, vector<unsigned char> *);
+
+	// The signed distance in pixels of the last Generate, positive outside the glyph. Kept for checking the accuracy of the field.
+	const float* GetDistances();
+
+	// ReferenceCoverage is what the SDF pixel shader computes from the sampled field value and its screen space derivative (fwidth).
+	static float ReferenceCoverage(float, float);
+
+ private:
+	void Transform(float *, int, int);
+	void Transform1D(const float *, float *, int);
+
+ private:
+	vector<float>	m_outside;		// squared distance to the nearest texel inside the glyph
+	vector<float>	m_inside;		// squared distance to the nearest texel outside the glyph
+	vector<float>	m_distance;
+
+	// Scratch of the one dimensional transform.
+	vector<float>	m_line, m_result, m_envelope;
+	vector<int>		m_vertices;
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "__sentenceStateClass.h"
+
+#include <string.h>
+
+SentenceStateClass::SentenceStateClass()
+{
+	m_text		= 0;
+	m_maxLength = 0;
+	m_positionX = 0;
+	m_positionY = 0;
+	m_color		= 0;
+	m_built		= false;
+	m_paragraph = false;
+	m_wrapWidth = 0.0f;
+	m_align		= 0;
+}
+
+SentenceStateClass::SentenceStateClass(const SentenceStateClass& other)
+{
+}
+
+SentenceStateClass::~SentenceStateClass()
+{
+}
+
+// Nothing has been built yet, so the first update of any kind changes everything.
+bool SentenceStateClass::Initialize(int maxLength)
+{
+	if (maxLength < 0)
+		return false;
+
+	m_text = new char[maxLength + 1];
+	if (!m_text)
+		return false;
+
+	m_text[0]	= 0;
+	m_maxLength = maxLength;
+	m_built		= false;
+	m_paragraph = false;
+
+	return true;
+}
+
+void SentenceStateClass::Shutdown()
+{
+	if (m_text) {
+		delete [] m_text;
+		m_text = 0;
+	}
+
+	m_maxLength = 0;
+	m_built		= false;
+
+	return;
+}
+
+int SentenceStateClass::UpdateSentence(const char *text, int positionX, int positionY, unsigned int color, int *firstLetter)
+{
+	int changes	   = CHANGE_NONE;
+	int numLetters = (int)strlen(text);
+
+	if (numLetters > m_maxLength)
+		return -1;
+
+	// The color is stored in every instance, so a new color recolors the letters already built.
+	if (!m_built || m_color != color)
+		changes |= CHANGE_COLOR;
+
+	// Find the first letter that differs from the last text. A new position moves every letter, so everything is rebuilt then.
+	*firstLetter = 0;
+
+	if (m_built && !m_paragraph && m_positionX == positionX && m_positionY == positionY)
+		while (text[*firstLetter] && text[*firstLetter] == m_text[*firstLetter])
+			(*firstLetter)++;
+
+	if (*firstLetter != numLetters || m_text[*firstLetter] != 0 || !m_built || m_paragraph)
+		changes |= CHANGE_TEXT;
+
+	memcpy(m_text, text, numLetters + 1);
+	m_positionX = positionX;
+	m_positionY = positionY;
+	m_color		= color;
+	m_built		= true;
+	m_paragraph = false;
+
+	return changes;
+}
+
+int SentenceStateClass::UpdateParagraph(const char *text, int positionX, int positionY, float wrapWidth, int align, unsigned int color)
+{
+	int changes	   = CHANGE_NONE;
+	int numLetters = (int)strlen(text);
+
+	if (numLetters > m_maxLength)
+		return -1;
+
+	if (!m_built || m_color != color)
+		changes |= CHANGE_COLOR;
+
+	if (!m_built || !m_paragraph || m_positionX != positionX || m_positionY != positionY ||
+		m_wrapWidth != wrapWidth || m_align != align || strcmp(m_text, text) != 0)
+		changes |= CHANGE_TEXT;
+
+	memcpy(m_text, text, numLetters + 1);
+	m_positionX = positionX;
+	m_positionY = positionY;
+	m_wrapWidth = wrapWidth;
+	m_align		= align;
+	m_color		= color;
+	m_built		= true;
+	m_paragraph = true;
+
+	return changes;
+}
+
+const char* SentenceStateClass::GetText()
+{
+	return m_text;
+}
@@ -0,0 +1,52 @@
+// --------------------------------------------------------------------------------------------------------
+// SentenceStateClass remembers what a sentence of the TextOutClass was last built from: its text, position and color,
+// and for a paragraph the wrapping width and the alignment. An update is compared with it to find what has to be done:
+// nothing, only recoloring the letters already built, or rebuilding the letters from the first one that differs.
+// Only an update that changes nothing at all lets the TextOutClass skip the upload of the instances.
+//
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SENTENCESTATECLASS_H_
+#define _SENTENCESTATECLASS_H_
+
+
+
+class SentenceStateClass {
+ public:
+	// What an update changed, the flags can be combined
+	enum { CHANGE_NONE = 0, CHANGE_COLOR = 1, CHANGE_TEXT = 2 };
+
+ public:
+	SentenceStateClass();
+	SentenceStateClass(const SentenceStateClass &);
+   ~SentenceStateClass();
+
+	// Initialize takes the longest text the sentence can hold.
+	bool Initialize(int);
+	void Shutdown();
+
+	// UpdateSentence stores the new text, position and packed color and returns the CHANGE_ flags.
+	// For CHANGE_TEXT the last argument gets the first letter to rebuild: 0 when the sentence moved or was a paragraph,
+	// otherwise the first one that differs from the last text. Nothing is stored for a text longer than the sentence, -1 is returned.
+	int	 UpdateSentence(const char *, int, int, unsigned int, int *);
+
+	// UpdateParagraph does the same for a paragraph, which is always laid out again as a whole when its text changes.
+	int	 UpdateParagraph(const char *, int, int, float, int, unsigned int);
+
+	const char* GetText();
+
+ private:
+	char		*m_text;
+	int			 m_maxLength;
+	int			 m_positionX, m_positionY;
+	unsigned int m_color;
+	bool		 m_built;
+
+	// A paragraph is laid out by the TextLayoutClass, its letters can't be patched one by one like the ones of a sentence.
+	bool		 m_paragraph;
+	float		 m_wrapWidth;
+	int			 m_align;
+};
+
+#endif
@@ -0,0 +1,280 @@
+#include "__shaderCacheClass.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+
+// 'SHC1', the first bytes of every blob
+#define SHADER_CACHE_MAGIC 0x31434853
+
+ShaderCacheClass::ShaderCacheClass()
+{
+	m_compile	  = 0;
+	m_user		  = 0;
+	m_readEnabled = true;
+
+	ResetStats();
+}
+
+ShaderCacheClass::ShaderCacheClass(const ShaderCacheClass& other)
+{
+}
+
+ShaderCacheClass::~ShaderCacheClass()
+{
+}
+
+bool ShaderCacheClass::Initialize(const char *directory, const char *compilerName, ShaderCompileFunction compile, void *user)
+{
+	if (!compile)
+		return false;
+
+	m_directory	   = directory;
+	m_compilerName = compilerName;
+	m_compile	   = compile;
+	m_user		   = user;
+
+	if (!m_directory.empty() && m_directory[m_directory.size() - 1] != '/' && m_directory[m_directory.size() - 1] != '\\')
+		m_directory += '/';
+
+	return true;
+}
+
+void ShaderCacheClass::Shutdown()
+{
+	m_source.clear();
+	m_compile = 0;
+
+	return;
+}
+
+bool ShaderCacheClass::Load(const char *filename, const char *entry, const char *profile, unsigned int flags, vector<unsigned char> *bytecode, string *errors)
+{
+	return Load(filename, entry, profile, flags, "", bytecode, errors);
+}
+
+bool ShaderCacheClass::Load(const char *filename, const char *entry, const char *profile, unsigned int flags, const char *defines,
+							vector<unsigned char> *bytecode, string *errors)
+{
+	ifstream		   fin;
+	string			   prefix;
+	long			   size, prefixSize;
+	unsigned long long hash;
+	string			   path;
+	float			   milliseconds;
+
+	errors->clear();
+	bytecode->clear();
+
+	// Read the source, its text is needed for the hash even when the blob is up to date.
+	fin.open(filename, ios::binary);
+
+	if (fin.fail())
+		return false;
+
+	fin.seekg(0, ios::end);
+	size = (long)fin.tellg();
+	fin.seekg(0, ios::beg);
+
+	if (size < 0)
+		return false;
+
+	// The defines go in front of the text of the file.
+	if (*defines) {
+		prefix = defines;
+
+		if (prefix[prefix.size() - 1] != '\n')
+			prefix += '\n';
+
+		prefix += "#line 1\n";
+	}
+
+	prefixSize = (long)prefix.size();
+
+	m_source.resize(prefixSize + size + 1);
+
+	if (prefixSize > 0)
+		memcpy(&m_source[0], prefix.c_str(), prefixSize);
+
+	if (size > 0 && !fin.read(&m_source[prefixSize], size))
+		return false;
+
+	size += prefixSize;
+	m_source[size] = 0;
+
+	fin.close();
+
+	hash = Hash(&m_source[0], (int)size, entry, profile, flags, m_compilerName.c_str());
+	path = GetBlobPath(filename, entry, profile, defines);
+
+	if (m_readEnabled && ReadBlob(path, hash, bytecode, &milliseconds)) {
+		m_stats.hits++;
+		m_stats.savedTime += milliseconds;
+		return true;
+	}
+
+	m_stats.misses++;
+
+	milliseconds = 0.0f;
+
+	if (!m_compile(m_user, filename, &m_source[0], (int)size, entry, profile, flags, bytecode, errors, &milliseconds)) {
+		m_stats.compileFailures++;
+		bytecode->clear();
+		return false;
+	}
+
+	m_stats.compileTime += milliseconds;
+
+	if (!WriteBlob(path, hash, *bytecode, milliseconds))
+		m_stats.writeFailures++;
+
+	return true;
+}
+
+void ShaderCacheClass::SetReadEnabled(bool enabled)
+{
+	m_readEnabled = enabled;
+
+	return;
+}
+
+const ShaderCacheClass::StatsType& ShaderCacheClass::GetStats()
+{
+	return m_stats;
+}
+
+void ShaderCacheClass::ResetStats()
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+
+	return;
+}
+
+// The blob of "dir/_shaderFont.ps", FontPixelShader, ps_5_0 is "<cache>/_shaderFont.ps.FontPixelShader.ps_5_0.cso".
+// A variant adds the hash of its defines: "<cache>/_shaderLight.ps.LightPixelShader.ps_5_0.0123456789abcdef.cso".
+string ShaderCacheClass::GetBlobPath(const char *filename, const char *entry, const char *profile, const char *defines)
+{
+	const char		  *name = filename;
+	string			   variant = ".";
+	unsigned long long hash;
+
+	for (const char *s = filename; *s; s++)
+		if (*s == '/' || *s == '\\')
+			name = s + 1;
+
+	if (!*defines)
+		return m_directory + name + "." + entry + "." + profile + ".cso";
+
+	hash = Hash(defines, (int)strlen(defines), "", "", 0, "");
+
+	for (int i = 60; i >= 0; i -= 4)
+		variant += "0123456789abcdef"[(hash >> i) & 0xF];
+
+	return m_directory + name + "." + entry + "." + profile + variant + ".cso";
+}
+
+// FNV-1a over the size of the source, the source, the entry point, the profile, the flags and the compiler name.
+// The source is hashed after its size and the strings with their terminating zero, so "ab" + "c" and "a" + "bc" differ.
+unsigned long long ShaderCacheClass::Hash(const char *source, int size, const char *entry, const char *profile, unsigned int flags, const char *compilerName)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	const char		  *strings[3] = { entry, profile, compilerName };
+
+	for (int i = 0; i < 4; i++) {
+		hash ^= ((unsigned int)size >> (i * 8)) & 0xFF;
+		hash *= 1099511628211ULL;
+	}
+
+	for (int i = 0; i < size; i++) {
+		hash ^= (unsigned char)source[i];
+		hash *= 1099511628211ULL;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		const char *s = strings[i];
+
+		do {
+			hash ^= (unsigned char)*s;
+			hash *= 1099511628211ULL;
+		} while (*s++);
+	}
+
+	for (int i = 0; i < 4; i++) {
+		hash ^= (flags >> (i * 8)) & 0xFF;
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+bool ShaderCacheClass::ReadBlob(const string &path, unsigned long long hash, vector<unsigned char> *bytecode, float *milliseconds)
+{
+	ifstream	   fin;
+	BlobHeaderType header;
+	bool		   result;
+
+	fin.open(path.c_str(), ios::binary);
+
+	if (fin.fail())
+		return false;
+
+	result = fin.read((char*)&header, sizeof(header)) && header.magic == SHADER_CACHE_MAGIC && header.hash == hash && header.size > 0;
+
+	if (result) {
+		bytecode->resize(header.size);
+
+		// A short blob was cut while being written, it is compiled again.
+		result = !!fin.read((char*)&(*bytecode)[0], header.size);
+	}
+
+	fin.close();
+
+	if (!result) {
+		bytecode->clear();
+		return false;
+	}
+
+	*milliseconds = header.compileTime;
+
+	return true;
+}
+
+// The blob is written to a temporary file first and renamed, so a reader never sees half a blob under the real name.
+bool ShaderCacheClass::WriteBlob(const string &path, unsigned long long hash, const vector<unsigned char> &bytecode, float milliseconds)
+{
+	ofstream	   fout;
+	BlobHeaderType header;
+	string		   temporary = path + ".tmp";
+	bool		   result;
+
+	if (bytecode.empty())
+		return false;
+
+	fout.open(temporary.c_str(), ios::binary | ios::trunc);
+
+	if (fout.fail())
+		return false;
+
+	header.magic	   = SHADER_CACHE_MAGIC;
+	header.size		   = (unsigned int)bytecode.size();
+	header.hash		   = hash;
+	header.compileTime = milliseconds;
+	header.reserved	   = 0;
+
+	fout.write((const char*)&header, sizeof(header));
+	fout.write((const char*)&bytecode[0], bytecode.size());
+	fout.close();
+
+	result = !fout.fail();
+
+	// rename doesn't replace an existing file on Windows.
+	if (result) {
+		remove(path.c_str());
+		result = rename(temporary.c_str(), path.c_str()) == 0;
+	}
+
+	if (!result)
+		remove(temporary.c_str());
+
+	return result;
+}
@@ -0,0 +1,91 @@
+// --------------------------------------------------------------------------------------------------------
+// ShaderCacheClass keeps the compiled bytecode of the shaders on disk, so the HLSL compiler only runs when a source changes.
+// Every entry point of a source file has its own blob in the cache directory, named after the file, the entry point and the profile.
+// The header of a blob holds a hash of everything the bytecode depends on: the source text, the entry point, the profile,
+// the compile flags and the name of the compiler. Load reads the source, and when the blob is missing, damaged or has another hash,
+// compiles it again and replaces the blob. The sources must not #include other files, these would not be part of the hash.
+//
+// A variant of an entry point is compiled with #define lines in front of the source (followed by a #line 1, so the errors
+// keep the line numbers of the file). The defines are part of the text that is hashed, and a variant has its own blob.
+//
+// The compiler is a callback: ShaderLoaderClass gives the D3DCompile one, a stub can be given to check the cache without Direct3D.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SHADERCACHECLASS_H_
+#define _SHADERCACHECLASS_H_
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// The compiler gets the name and the text of the source, the entry point, the profile and the flags.
+// It fills the bytecode, or the error messages when it fails, and tells how many milliseconds the compilation took.
+typedef bool (*ShaderCompileFunction)(void *user, const char *filename, const char *source, int size, const char *entry, const char *profile,
+									  unsigned int flags, vector<unsigned char> *bytecode, string *errors, float *milliseconds);
+
+
+
+class ShaderCacheClass {
+ public:
+	struct StatsType {
+		int	  hits;				// blobs read from the cache
+		int	  misses;			// entry points compiled
+		int	  compileFailures;
+		int	  writeFailures;	// blobs compiled but not stored, the cache directory is not writable
+		float compileTime;		// milliseconds spent compiling
+		float savedTime;		// milliseconds the blobs read from the cache took to compile when they were stored
+	};
+
+ private:
+	// The blob file is this header followed by the bytecode.
+	struct BlobHeaderType {
+		unsigned int	   magic;
+		unsigned int	   size;
+		unsigned long long hash;
+		float			   compileTime;
+		unsigned int	   reserved;
+	};
+
+ public:
+	ShaderCacheClass();
+	ShaderCacheClass(const ShaderCacheClass &);
+   ~ShaderCacheClass();
+
+	// Initialize takes the cache directory (it must exist), the name of the compiler (a new compiler makes all blobs stale) and the compiler callback.
+	bool Initialize(const char *, const char *, ShaderCompileFunction, void *);
+	void Shutdown();
+
+	// Load gives the bytecode of an entry point of a source file, from the cache or compiled.
+	// It returns false when the source can't be read (the errors are then empty) or doesn't compile.
+	bool Load(const char *, const char *, const char *, unsigned int, vector<unsigned char> *, string *);
+
+	// The same for the variant compiled with the defines ("#define NAME VALUE" lines).
+	bool Load(const char *, const char *, const char *, unsigned int, const char *, vector<unsigned char> *, string *);
+
+	// Without reading, every Load compiles (and still stores the blob). Used to measure a start without the cache.
+	void SetReadEnabled(bool);
+
+	const StatsType& GetStats();
+	void ResetStats();
+
+	string GetBlobPath(const char *, const char *, const char *, const char *);
+
+	static unsigned long long Hash(const char *, int, const char *, const char *, unsigned int, const char *);
+
+ private:
+	bool ReadBlob(const string &, unsigned long long, vector<unsigned char> *, float *);
+	bool WriteBlob(const string &, unsigned long long, const vector<unsigned char> &, float);
+
+ private:
+	string				  m_directory;
+	string				  m_compilerName;
+	ShaderCompileFunction m_compile;
+	void				 *m_user;
+	bool				  m_readEnabled;
+	StatsType			  m_stats;
+
+	vector<char>		  m_source;		// the text of the source being loaded
+};
+
+#endif
@@ -0,0 +1,78 @@
+// --------------------------------------------------------------------------------------------------------
+// ShaderConstantsClass holds the constant buffer layouts of the HLSL shaders, one struct per cbuffer.
+// The shader classes fill them with the D3DX types:
+//
+//	typedef ShaderConstantsClass<D3DXMATRIX, D3DXVECTOR3, D3DXVECTOR4>::LightFrameBufferType FrameBufferType;
+//
+// and ShaderReferenceClass reads the very same layouts with its own vector types, so the C++ reference shaders
+// take the bytes the GPU gets. A matrix is 16 floats and is uploaded transposed, as the shaders read it (column major).
+// The feature bits of the shader variants are here too, ShaderPermutationClass and the reference shaders both select by them.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SHADERCONSTANTSCLASS_H_
+#define _SHADERCONSTANTSCLASS_H_
+
+// The features of the shader variants, the bits of a ShaderPermutationClass key
+#define SHADER_FEATURE_SPECULAR			0x1ULL
+#define SHADER_FEATURE_TEXTURE			0x2ULL
+#define SHADER_FEATURE_INSTANCING		0x4ULL
+#define SHADER_FEATURE_ALPHA_TEST		0x8ULL
+#define SHADER_FEATURE_CLUSTERED_LIGHTS 0x10ULL
+
+#define SHADER_FEATURE_COUNT 5
+
+
+
+template <class Matrix, class Vector3, class Vector4>
+class ShaderConstantsClass {
+ public:
+	// _shaderLight.vs: FrameBuffer (b0) and ObjectBuffer (b1)
+	struct LightFrameBufferType {
+		Matrix	view;
+		Matrix	projection;
+		Vector3 cameraPosition;
+		float	padding;
+	};
+
+	struct LightObjectBufferType {
+		Matrix world;
+	};
+
+	// _shaderLight.ps: LightBuffer (b0). The specular power sits next to the light direction to fill its 16 bytes.
+	struct LightBufferType {
+		Vector4 ambientColor;
+		Vector4 diffuseColor;
+		Vector3 lightDirection;
+		float	specularPower;
+		Vector4 specularColor;
+	};
+
+	// _shaderLight.ps: ClusterBuffer (b1) of the clustered lights
+	struct ClusterBufferType {
+		float		 tileScale[2];		// clusters per pixel
+		float		 depthScale;
+		float		 depthBias;
+		unsigned int clusterCounts[3];
+		unsigned int lightCount;
+	};
+
+	// _shaderTexture.vs: FrameBuffer (b0) and ObjectBuffer (b1)
+	struct TextureFrameBufferType {
+		Matrix view;
+		Matrix projection;
+	};
+
+	struct TextureObjectBufferType {
+		Matrix world;
+	};
+
+	// _shaderTextureInstancing.vs and _shaderFont.vs: all three matrices in one buffer
+	struct MatrixBufferType {
+		Matrix world;
+		Matrix view;
+		Matrix projection;
+	};
+};
+
+#endif
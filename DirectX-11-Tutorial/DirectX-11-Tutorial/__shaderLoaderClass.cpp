@@ -0,0 +1,241 @@
+#include "__shaderLoaderClass.h"
+#include "__shaderPermutationClass.h"
+#include "__lightShaderClass.h"
+
+#pragma comment(lib, "d3dcompiler.lib")
+#include "D3Dcompiler.h"
+
+#include <stdio.h>
+#include <fstream>
+
+#define SHADER_CACHE_DIRECTORY L"../DirectX-11-Tutorial/shadercache"
+
+// Every entry point the shader classes load, for BuildAll. A shader class that loads a new one has to add it here.
+static const struct {
+	const WCHAR *filename;
+	const char	*entry;
+	const char	*profile;
+} s_shaders[] = {
+	{ L"../DirectX-11-Tutorial/_shaderColor.vs",			 "ColorVertexShader",		   "vs_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderColor.ps",			 "ColorPixelShader",		   "ps_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderTexture.vs",			 "TextureVertexShader",		   "vs_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderTexture.vs",			 "TextureObjectsVertexShader", "vs_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderTexture.ps",			 "TexturePixelShader",		   "ps_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderTextureInstancing.vs", "TextureVertexShader",		   "vs_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderTextureInstancing.ps", "TexturePixelShader",		   "ps_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderFont.vs",				 "FontVertexShader",		   "vs_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderFont.ps",				 "FontPixelShader",			   "ps_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderFont.ps",				 "FontSdfPixelShader",		   "ps_5_0" },
+	{ L"../DirectX-11-Tutorial/_shaderFontInstancing.vs",	 "FontInstancingVertexShader", "vs_5_0" },
+};
+
+// The entry points compiled as ShaderPermutationClass variants, with the features each of them uses.
+static const struct {
+	const WCHAR		  *filename;
+	const char		  *entry;
+	const char		  *profile;
+	unsigned long long features;
+} s_permutations[] = {
+	{ L"../DirectX-11-Tutorial/_shaderLight.vs", "LightVertexShader", "vs_5_0", LIGHT_SHADER_VERTEX_FEATURES },
+	{ L"../DirectX-11-Tutorial/_shaderLight.ps", "LightPixelShader",  "ps_5_0", LIGHT_SHADER_PIXEL_FEATURES	},
+};
+
+ShaderCacheClass ShaderLoaderClass::s_cache;
+bool			 ShaderLoaderClass::s_initialized = false;
+bool			 ShaderLoaderClass::s_readEnabled = true;
+float			 ShaderLoaderClass::s_loadTime	  = 0.0f;
+INT64			 ShaderLoaderClass::s_frequency	  = 0;
+
+void ShaderLoaderClass::SetReadEnabled(bool enabled)
+{
+	s_readEnabled = enabled;
+	s_cache.SetReadEnabled(enabled);
+
+	return;
+}
+
+HRESULT ShaderLoaderClass::CompileFromFile(WCHAR *filename, const char *entry, const char *profile, UINT flags, ID3D10Blob **code, ID3D10Blob **errors)
+{
+	return CompileFromFile(filename, entry, profile, flags, "", code, errors);
+}
+
+HRESULT ShaderLoaderClass::CompileFromFile(WCHAR *filename, const char *entry, const char *profile, UINT flags, const char *defines, ID3D10Blob **code, ID3D10Blob **errors)
+{
+	vector<unsigned char> bytecode;
+	string				  messages;
+	char				  name[MAX_PATH];
+	INT64				  start, end;
+	HRESULT				  result;
+	bool				  loaded;
+
+	*code	= 0;
+	*errors = 0;
+
+	if (!s_initialized && !Initialize())
+		return E_FAIL;
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&start);
+
+	if (WideCharToMultiByte(CP_ACP, 0, filename, -1, name, MAX_PATH, NULL, NULL) == 0)
+		return E_FAIL;
+
+	loaded = s_cache.Load(name, entry, profile, flags, defines, &bytecode, &messages);
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&end);
+	s_loadTime += (float)(end - start) * 1000.0f / (float)s_frequency;
+
+	// The results are handed back in blobs, as D3DCompileFromFile does, so the shader classes release them the same way.
+	if (!loaded) {
+
+		if (!messages.empty() && SUCCEEDED(D3DCreateBlob(messages.size(), errors)))
+			memcpy((*errors)->GetBufferPointer(), messages.c_str(), messages.size());
+
+		return E_FAIL;
+	}
+
+	result = D3DCreateBlob(bytecode.size(), code);
+
+	if (FAILED(result))
+		return result;
+
+	memcpy((*code)->GetBufferPointer(), &bytecode[0], bytecode.size());
+
+	return S_OK;
+}
+
+bool ShaderLoaderClass::BuildAll()
+{
+	ofstream		   fout;
+	string			   defines;
+	unsigned long long features, key;
+	bool			   result = true;
+
+	for (int i = 0; i < (int)(sizeof(s_shaders) / sizeof(s_shaders[0])); i++)
+		if (!Build(s_shaders[i].filename, s_shaders[i].entry, s_shaders[i].profile, "", &fout))
+			result = false;
+
+	// Every subset of the features of a permutation, from none to all of them.
+	for (int i = 0; i < (int)(sizeof(s_permutations) / sizeof(s_permutations[0])); i++) {
+		features = s_permutations[i].features;
+		key		 = 0;
+
+		do {
+			ShaderPermutationClass::GetDefines(key, features, &defines);
+
+			if (!Build(s_permutations[i].filename, s_permutations[i].entry, s_permutations[i].profile, defines.c_str(), &fout))
+				result = false;
+
+			key = (key - features) & features;
+		} while (key != 0);
+	}
+
+	return result;
+}
+
+void ShaderLoaderClass::Shutdown()
+{
+	s_cache.Shutdown();
+	s_initialized = false;
+
+	return;
+}
+
+const ShaderCacheClass::StatsType& ShaderLoaderClass::GetStats()
+{
+	return s_cache.GetStats();
+}
+
+float ShaderLoaderClass::GetLoadTime()
+{
+	return s_loadTime;
+}
+
+bool ShaderLoaderClass::Initialize()
+{
+	char compilerName[32];
+	char directory[MAX_PATH];
+
+	QueryPerformanceFrequency((LARGE_INTEGER*)&s_frequency);
+
+	// The cache directory may not be there yet. If it can't be made, the blobs are not stored and the shaders are compiled every time.
+	CreateDirectoryW(SHADER_CACHE_DIRECTORY, NULL);
+
+	if (WideCharToMultiByte(CP_ACP, 0, SHADER_CACHE_DIRECTORY, -1, directory, MAX_PATH, NULL, NULL) == 0)
+		return false;
+
+	// A new d3dcompiler makes all the blobs stale.
+	sprintf_s(compilerName, sizeof(compilerName), "d3dcompiler_%d", D3D_COMPILER_VERSION);
+
+	if (!s_cache.Initialize(directory, compilerName, Compile, 0))
+		return false;
+
+	s_cache.SetReadEnabled(s_readEnabled);
+	s_initialized = true;
+
+	return true;
+}
+
+// Build compiles one entry point for BuildAll.
+bool ShaderLoaderClass::Build(const WCHAR *filename, const char *entry, const char *profile, const char *defines, ofstream *fout)
+{
+	ID3D10Blob *code, *errors;
+
+	if (FAILED(CompileFromFile((WCHAR*)filename, entry, profile, D3D10_SHADER_ENABLE_STRICTNESS, defines, &code, &errors))) {
+
+		// There is no window to show the errors in, they are written out like the shader classes do.
+		if (!fout->is_open())
+			fout->open("____shader-error.txt");
+
+		*fout << entry << ":" << endl << defines;
+
+		if (errors) {
+			fout->write((const char*)errors->GetBufferPointer(), errors->GetBufferSize());
+			errors->Release();
+		}
+		else
+			*fout << "missing shader file" << endl;
+
+		return false;
+	}
+
+	code->Release();
+
+	return true;
+}
+
+// The compiler callback of the cache, D3DCompile timed with the performance counter.
+bool ShaderLoaderClass::Compile(void *user, const char *filename, const char *source, int size, const char *entry, const char *profile,
+								unsigned int flags, vector<unsigned char> *bytecode, string *errors, float *milliseconds)
+{
+	ID3D10Blob *code = 0, *errorMessage = 0;
+	INT64		start, end;
+	HRESULT		result;
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&start);
+
+	result = D3DCompile(source, size, filename, NULL, NULL, entry, profile, flags, 0, &code, &errorMessage);
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&end);
+	*milliseconds = (float)(end - start) * 1000.0f / (float)s_frequency;
+
+	if (errorMessage) {
+		errors->assign((const char*)errorMessage->GetBufferPointer(), errorMessage->GetBufferSize());
+		errorMessage->Release();
+	}
+
+	if (FAILED(result)) {
+		if (code)
+			code->Release();
+
+		// D3DCompile always explains a failure, but the caller tells a missing file by the empty errors.
+		if (errors->empty())
+			errors->assign("compilation failed");
+
+		return false;
+	}
+
+	bytecode->assign((const unsigned char*)code->GetBufferPointer(), (const unsigned char*)code->GetBufferPointer() + code->GetBufferSize());
+	code->Release();
+
+	return true;
+}
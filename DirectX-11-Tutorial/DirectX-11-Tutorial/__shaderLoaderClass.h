@@ -0,0 +1,55 @@
+// --------------------------------------------------------------------------------------------------------
+// ShaderLoaderClass is what the shader classes call instead of D3DCompileFromFile: it has the same arguments and results,
+// but gets the bytecode through a ShaderCacheClass, so a shader is only compiled when its source has changed since the last run.
+// The cache is in the shadercache directory next to the shaders.
+//
+// BuildAll is the offline step: it compiles every entry point the program uses into the cache, without a window or a device.
+// The ShaderBuild project of the solution runs it when a shader source changes, so a fresh build starts without compiling anything.
+// For the shaders with feature permutations it compiles every combination of their features.
+// "-noshadercache" on the command line makes every shader compile again, to compare the startup time with the cache.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SHADERLOADERCLASS_H_
+#define _SHADERLOADERCLASS_H_
+
+#include <windows.h>
+#include <d3d11.h>
+#include <fstream>
+
+#include "__shaderCacheClass.h"
+
+
+
+class ShaderLoaderClass {
+ public:
+	static void SetReadEnabled(bool);
+
+	// CompileFromFile fails without error messages when the source can't be read, like D3DCompileFromFile.
+	static HRESULT CompileFromFile(WCHAR *, const char *, const char *, UINT, ID3D10Blob **, ID3D10Blob **);
+
+	// The same for a variant: the defines are "#define NAME VALUE" lines put in front of the source.
+	static HRESULT CompileFromFile(WCHAR *, const char *, const char *, UINT, const char *, ID3D10Blob **, ID3D10Blob **);
+
+	// BuildAll compiles all the entry points into the cache, the errors go to '__shader-error.txt'.
+	static bool BuildAll();
+
+	static void Shutdown();
+
+	// The counters of the cache, and the time spent in CompileFromFile (reading the cache or compiling), in milliseconds.
+	static const ShaderCacheClass::StatsType& GetStats();
+	static float GetLoadTime();
+
+ private:
+	static bool Initialize();
+	static bool Build(const WCHAR *, const char *, const char *, const char *, ofstream *);
+	static bool Compile(void *, const char *, const char *, int, const char *, const char *, unsigned int, vector<unsigned char> *, string *, float *);
+
+ private:
+	static ShaderCacheClass s_cache;
+	static bool				s_initialized;
+	static bool				s_readEnabled;
+	static float			s_loadTime;
+	static INT64			s_frequency;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#include "__shaderPermutationClass.h"
+#include "__shaderLoaderClass.h"
+
+#include <fstream>
+
+#pragma comment(lib, "d3dcompiler.lib")
+#include "D3Dcompiler.h"
+
+// The define of every feature bit
+static const struct {
+	unsigned long long bit;
+	const char		  *name;
+} s_features[SHADER_FEATURE_COUNT] = {
+	{ SHADER_FEATURE_SPECULAR,	 "SPECULAR"	  },
+	{ SHADER_FEATURE_TEXTURE,	 "TEXTURE"	  },
+	{ SHADER_FEATURE_INSTANCING, "INSTANCING" },
+	{ SHADER_FEATURE_ALPHA_TEST, "ALPHA_TEST" },
+	{ SHADER_FEATURE_CLUSTERED_LIGHTS, "CLUSTERED_LIGHTS" },
+};
+
+// The most elements an input layout callback may describe
+#define SHADER_PERMUTATION_MAX_ELEMENTS 16
+
+ShaderPermutationClass::ShaderPermutationClass()
+{
+	m_device		 = 0;
+	m_hwnd			 = 0;
+	m_vsFilename	 = 0;
+	m_psFilename	 = 0;
+	m_vsEntry		 = 0;
+	m_psEntry		 = 0;
+	m_vsFeatures	 = 0;
+	m_psFeatures	 = 0;
+	m_layoutFunction = 0;
+}
+
+ShaderPermutationClass::ShaderPermutationClass(const ShaderPermutationClass& other)
+{
+}
+
+ShaderPermutationClass::~ShaderPermutationClass()
+{
+}
+
+// The file names and the entry points are kept as pointers, they have to stay valid (they are string literals in the shader classes).
+bool ShaderPermutationClass::Initialize(ID3D11Device *device, HWND hwnd, WCHAR *vsFilename, const char *vsEntry, unsigned long long vsFeatures,
+										WCHAR *psFilename, const char *psEntry, unsigned long long psFeatures, ShaderLayoutFunction layoutFunction)
+{
+	if (!device || !layoutFunction)
+		return false;
+
+	m_device		 = device;
+	m_hwnd			 = hwnd;
+	m_vsFilename	 = vsFilename;
+	m_vsEntry		 = vsEntry;
+	m_vsFeatures	 = vsFeatures;
+	m_psFilename	 = psFilename;
+	m_psEntry		 = psEntry;
+	m_psFeatures	 = psFeatures;
+	m_layoutFunction = layoutFunction;
+
+	return true;
+}
+
+void ShaderPermutationClass::Shutdown()
+{
+	for (auto i = m_pixelShaders.begin(); i != m_pixelShaders.end(); ++i)
+		if (i->second)
+			i->second->Release();
+
+	for (auto i = m_vertexShaders.begin(); i != m_vertexShaders.end(); ++i) {
+		if (i->second.layout)
+			i->second.layout->Release();
+
+		if (i->second.shader)
+			i->second.shader->Release();
+	}
+
+	m_pixelShaders.clear();
+	m_vertexShaders.clear();
+
+	m_device = 0;
+
+	return;
+}
+
+bool ShaderPermutationClass::Precompile(unsigned long long key)
+{
+	VertexVariantType *vertexShader;
+	ID3D11PixelShader *pixelShader;
+
+	return GetVariant(key, &vertexShader, &pixelShader);
+}
+
+bool ShaderPermutationClass::Bind(ID3D11DeviceContext *deviceContext, unsigned long long key)
+{
+	VertexVariantType *vertexShader;
+	ID3D11PixelShader *pixelShader;
+
+	if (!GetVariant(key, &vertexShader, &pixelShader))
+		return false;
+
+	deviceContext->IASetInputLayout(vertexShader->layout);
+	deviceContext->VSSetShader(vertexShader->shader, NULL, 0);
+	deviceContext->PSSetShader(pixelShader, NULL, 0);
+
+	return true;
+}
+
+int ShaderPermutationClass::GetVariantCount()
+{
+	return (int)(m_vertexShaders.size() + m_pixelShaders.size());
+}
+
+void ShaderPermutationClass::GetDefines(unsigned long long key, unsigned long long features, string *defines)
+{
+	defines->clear();
+
+	for (int i = 0; i < SHADER_FEATURE_COUNT; i++)
+		if (features & s_features[i].bit) {
+			*defines += "#define ";
+			*defines += s_features[i].name;
+			*defines += (key & s_features[i].bit) ? " 1\n" : " 0\n";
+		}
+
+	return;
+}
+
+// GetVariant finds the shaders of a key, and compiles the ones that are not there yet.
+bool ShaderPermutationClass::GetVariant(unsigned long long key, VertexVariantType **vertexShader, ID3D11PixelShader **pixelShader)
+{
+	unsigned long long vsKey = key & m_vsFeatures;
+	unsigned long long psKey = key & m_psFeatures;
+
+	auto vs = m_vertexShaders.find(vsKey);
+	auto ps = m_pixelShaders.find(psKey);
+
+	if (vs == m_vertexShaders.end()) {
+		VertexVariantType variant = { 0, 0 };
+
+		if (!m_device)
+			return false;
+
+		CompileVertexShader(vsKey, &variant);
+		vs = m_vertexShaders.insert(make_pair(vsKey, variant)).first;
+	}
+
+	if (ps == m_pixelShaders.end()) {
+		ID3D11PixelShader *shader = 0;
+
+		if (!m_device)
+			return false;
+
+		CompilePixelShader(psKey, &shader);
+		ps = m_pixelShaders.insert(make_pair(psKey, shader)).first;
+	}
+
+	*vertexShader = &vs->second;
+	*pixelShader  = ps->second;
+
+	return vs->second.shader && vs->second.layout && ps->second;
+}
+
+bool ShaderPermutationClass::CompileVertexShader(unsigned long long key, VertexVariantType *variant)
+{
+	D3D11_INPUT_ELEMENT_DESC layout[SHADER_PERMUTATION_MAX_ELEMENTS];
+	ID3D10Blob				*vertexShaderBuffer = 0, *errorMessage = 0;
+	string					 defines;
+	int						 layoutCount;
+	HRESULT					 result;
+
+	GetDefines(key, m_vsFeatures, &defines);
+
+	result = ShaderLoaderClass::CompileFromFile(m_vsFilename, m_vsEntry, "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, defines.c_str(), &vertexShaderBuffer, &errorMessage);
+
+	if (FAILED(result)) {
+		if (errorMessage)
+			OutputShaderErrorMessage(errorMessage, m_vsFilename);
+		else
+			MessageBox(m_hwnd, m_vsFilename, L"Missing Shader File", MB_OK);
+
+		return false;
+	}
+
+	result = m_device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &variant->shader);
+
+	// The input layout is checked against the variant, an instanced vertex shader has more inputs.
+	if (SUCCEEDED(result)) {
+		layoutCount = m_layoutFunction(key, layout, SHADER_PERMUTATION_MAX_ELEMENTS);
+
+		result = m_device->CreateInputLayout(layout, layoutCount, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &variant->layout);
+	}
+
+	vertexShaderBuffer->Release();
+
+	return SUCCEEDED(result);
+}
+
+bool ShaderPermutationClass::CompilePixelShader(unsigned long long key, ID3D11PixelShader **shader)
+{
+	ID3D10Blob *pixelShaderBuffer = 0, *errorMessage = 0;
+	string		defines;
+	HRESULT		result;
+
+	GetDefines(key, m_psFeatures, &defines);
+
+	result = ShaderLoaderClass::CompileFromFile(m_psFilename, m_psEntry, "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, defines.c_str(), &pixelShaderBuffer, &errorMessage);
+
+	if (FAILED(result)) {
+		if (errorMessage)
+			OutputShaderErrorMessage(errorMessage, m_psFilename);
+		else
+			MessageBox(m_hwnd, m_psFilename, L"Missing Shader File", MB_OK);
+
+		return false;
+	}
+
+	result = m_device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), NULL, shader);
+
+	pixelShaderBuffer->Release();
+
+	return SUCCEEDED(result);
+}
+
+// OutputShaderErrorMessage writes the compile errors to a text file and tells where to find them.
+void ShaderPermutationClass::OutputShaderErrorMessage(ID3D10Blob *errorMessage, WCHAR *shaderFilename)
+{
+	ofstream fout;
+
+	fout.open("____shader-error.txt");
+	fout.write((const char*)errorMessage->GetBufferPointer(), errorMessage->GetBufferSize());
+	fout.close();
+
+	errorMessage->Release();
+
+	MessageBox(m_hwnd, L"Error compiling shader. Check '__shader-error.txt' for message.", shaderFilename, MB_OK);
+
+	return;
+}
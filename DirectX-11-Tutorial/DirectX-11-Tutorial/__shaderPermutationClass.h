@@ -0,0 +1,80 @@
+// --------------------------------------------------------------------------------------------------------
+// ShaderPermutationClass compiles the variants of a vertex and a pixel shader from feature defines,
+// so a material only pays for the features it uses. A variant is selected by a 64 bit key, one bit per feature:
+//
+//	m_permutations.Bind(deviceContext, SHADER_FEATURE_TEXTURE | SHADER_FEATURE_ALPHA_TEST);
+//
+// Every feature the shader knows is defined to 1 or 0 in front of its source ("#define SPECULAR 1"), the HLSL tests it with #if.
+// The vertex and the pixel shader each get only the bits they use, so a vertex shader is shared by all the pixel shaders
+// that differ in a pixel feature. A bit the shaders don't know about is ignored.
+//
+// A variant is compiled the first time it is bound, or ahead of time with Precompile. The bytecode goes through
+// ShaderLoaderClass, so a variant compiled once is read from the shader cache afterwards, and the ShaderBuild tool fills
+// the cache with all the variants of the shaders in its list.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SHADERPERMUTATIONCLASS_H_
+#define _SHADERPERMUTATIONCLASS_H_
+
+#include <d3d11.h>
+#include <string>
+#include <unordered_map>
+using namespace std;
+
+// The features, the bits of a key (SHADER_FEATURE_SPECULAR, ...)
+#include "__shaderConstantsClass.h"
+
+// The input layout of a vertex shader variant: fills at most maxCount element descriptions and returns how many there are.
+typedef int (*ShaderLayoutFunction)(unsigned long long key, D3D11_INPUT_ELEMENT_DESC *layout, int maxCount);
+
+
+
+class ShaderPermutationClass {
+ private:
+	struct VertexVariantType {
+		ID3D11VertexShader *shader;
+		ID3D11InputLayout  *layout;
+	};
+
+ public:
+	ShaderPermutationClass();
+	ShaderPermutationClass(const ShaderPermutationClass &);
+   ~ShaderPermutationClass();
+
+	// Initialize takes the files and entry points of the shaders, the features each of them uses and the input layout callback.
+	// Nothing is compiled yet.
+	bool Initialize(ID3D11Device *, HWND, WCHAR *, const char *, unsigned long long, WCHAR *, const char *, unsigned long long, ShaderLayoutFunction);
+	void Shutdown();
+
+	// Precompile compiles the variant of a key now, instead of at its first Bind.
+	bool Precompile(unsigned long long);
+
+	// Bind sets the input layout and the shaders of the variant. It fails when the variant doesn't compile, and then draws nothing;
+	// the compile errors are only shown the first time.
+	bool Bind(ID3D11DeviceContext *, unsigned long long);
+
+	int GetVariantCount();
+
+	// GetDefines writes the "#define" lines of the features in a mask, set to 1 for the bits of the key.
+	static void GetDefines(unsigned long long, unsigned long long, string *);
+
+ private:
+	bool GetVariant(unsigned long long, VertexVariantType **, ID3D11PixelShader **);
+	bool CompileVertexShader(unsigned long long, VertexVariantType *);
+	bool CompilePixelShader(unsigned long long, ID3D11PixelShader **);
+	void OutputShaderErrorMessage(ID3D10Blob *, WCHAR *);
+
+ private:
+	ID3D11Device		 *m_device;
+	HWND				  m_hwnd;
+	WCHAR				 *m_vsFilename, *m_psFilename;
+	const char			 *m_vsEntry, *m_psEntry;
+	unsigned long long	  m_vsFeatures, m_psFeatures;
+	ShaderLayoutFunction  m_layoutFunction;
+
+	// The variants by the bits of their shader, a variant that failed to compile is kept with null shaders.
+	unordered_map<unsigned long long, VertexVariantType>   m_vertexShaders;
+	unordered_map<unsigned long long, ID3D11PixelShader *> m_pixelShaders;
+};
+
+#endif
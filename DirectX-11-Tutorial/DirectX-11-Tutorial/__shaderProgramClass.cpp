@@ -0,0 +1,179 @@
+#include "__shaderProgramClass.h"
+#include "__shaderLoaderClass.h"
+
+#include <d3dx11async.h>
+#include <fstream>
+using namespace std;
+
+#pragma comment(lib, "d3dcompiler.lib")
+#include "D3Dcompiler.h"
+
+// The vertex formats of the VertexLayoutClass are DXGI_FORMAT values.
+static_assert(VERTEX_FORMAT_FLOAT4 == DXGI_FORMAT_R32G32B32A32_FLOAT && VERTEX_FORMAT_FLOAT3 == DXGI_FORMAT_R32G32B32_FLOAT &&
+			  VERTEX_FORMAT_FLOAT2 == DXGI_FORMAT_R32G32_FLOAT && VERTEX_FORMAT_FLOAT1 == DXGI_FORMAT_R32_FLOAT &&
+			  VERTEX_FORMAT_UINT1 == DXGI_FORMAT_R32_UINT && VERTEX_FORMAT_SINT1 == DXGI_FORMAT_R32_SINT, "the vertex formats must be DXGI formats");
+
+ShaderProgramBaseClass::ShaderProgramBaseClass()
+{
+	m_vertexShader	   = 0;
+	m_pixelShaderCount = 0;
+	m_layout		   = 0;
+	m_sampleState	   = 0;
+
+	for (int i = 0; i < SHADER_PROGRAM_MAX_PIXEL_SHADERS; i++)
+		m_pixelShaders[i] = 0;
+}
+
+ShaderProgramBaseClass::ShaderProgramBaseClass(const ShaderProgramBaseClass& other)
+{
+}
+
+ShaderProgramBaseClass::~ShaderProgramBaseClass()
+{
+}
+
+bool ShaderProgramBaseClass::AddPixelShader(ID3D11Device *device, HWND hwnd, WCHAR *psFilename, const char *psEntry)
+{
+	ID3D10Blob *pixelShaderBuffer = 0, *errorMessage = 0;
+	HRESULT		result;
+
+	if (m_pixelShaderCount == SHADER_PROGRAM_MAX_PIXEL_SHADERS)
+		return false;
+
+	result = ShaderLoaderClass::CompileFromFile(psFilename, psEntry, "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, &pixelShaderBuffer, &errorMessage);
+
+	if (FAILED(result)) {
+		if (errorMessage)
+			OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
+		else
+			MessageBox(hwnd, psFilename, L"Missing Shader File", MB_OK);
+
+		return false;
+	}
+
+	result = device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), NULL, &m_pixelShaders[m_pixelShaderCount]);
+
+	pixelShaderBuffer->Release();
+
+	if (FAILED(result))
+		return false;
+
+	m_pixelShaderCount++;
+
+	return true;
+}
+
+void ShaderProgramBaseClass::Bind(ID3D11DeviceContext *deviceContext, int pixelShader)
+{
+	deviceContext->IASetInputLayout(m_layout);
+
+	deviceContext->VSSetShader(m_vertexShader, NULL, 0);
+	deviceContext->PSSetShader(m_pixelShaders[pixelShader], NULL, 0);
+
+	if (m_sampleState)
+		deviceContext->PSSetSamplers(0, 1, &m_sampleState);
+
+	return;
+}
+
+// InitializeShaders compiles the vertex shader and the first pixel shader, and makes the input layout from the vertex shader.
+bool ShaderProgramBaseClass::InitializeShaders(ID3D11Device *device, HWND hwnd, WCHAR *vsFilename, const char *vsEntry, WCHAR *psFilename, const char *psEntry,
+											   const D3D11_INPUT_ELEMENT_DESC *layout, int layoutCount, const D3D11_SAMPLER_DESC *samplerDesc)
+{
+	ID3D10Blob *vertexShaderBuffer = 0, *errorMessage = 0;
+	HRESULT		result;
+
+	result = ShaderLoaderClass::CompileFromFile(vsFilename, vsEntry, "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, &vertexShaderBuffer, &errorMessage);
+
+	if (FAILED(result)) {
+
+		// If the shader failed to compile it should have writen something to the error message.
+		if (errorMessage)
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
+		else
+			// If there was nothing in the error message then it simply could not find the shader file itself.
+			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
+
+		return false;
+	}
+
+	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &m_vertexShader);
+
+	if (SUCCEEDED(result))
+		result = device->CreateInputLayout(layout, layoutCount, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &m_layout);
+
+	vertexShaderBuffer->Release();
+
+	if (FAILED(result))
+		return false;
+
+	if (!AddPixelShader(device, hwnd, psFilename, psEntry))
+		return false;
+
+	if (samplerDesc) {
+		result = device->CreateSamplerState(samplerDesc, &m_sampleState);
+
+		if (FAILED(result))
+			return false;
+	}
+
+	return true;
+}
+
+// The constant buffers are dynamic, they are rewritten for every draw.
+bool ShaderProgramBaseClass::CreateConstantBuffer(ID3D11Device *device, int size, ID3D11Buffer **buffer)
+{
+	D3D11_BUFFER_DESC bufferDesc;
+
+	bufferDesc.Usage			   = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth		   = size;
+	bufferDesc.BindFlags		   = D3D11_BIND_CONSTANT_BUFFER;
+	bufferDesc.CPUAccessFlags	   = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags		   = 0;
+	bufferDesc.StructureByteStride = 0;
+
+	return SUCCEEDED(device->CreateBuffer(&bufferDesc, NULL, buffer));
+}
+
+void ShaderProgramBaseClass::ShutdownShaders()
+{
+	if (m_sampleState) {
+		m_sampleState->Release();
+		m_sampleState = 0;
+	}
+
+	if (m_layout) {
+		m_layout->Release();
+		m_layout = 0;
+	}
+
+	for (int i = 0; i < m_pixelShaderCount; i++) {
+		m_pixelShaders[i]->Release();
+		m_pixelShaders[i] = 0;
+	}
+
+	m_pixelShaderCount = 0;
+
+	if (m_vertexShader) {
+		m_vertexShader->Release();
+		m_vertexShader = 0;
+	}
+
+	return;
+}
+
+// OutputShaderErrorMessage writes the compile errors to a text file and tells where to find them.
+void ShaderProgramBaseClass::OutputShaderErrorMessage(ID3D10Blob *errorMessage, HWND hwnd, WCHAR *shaderFilename)
+{
+	ofstream fout;
+
+	fout.open("____shader-error.txt");
+	fout.write((const char*)errorMessage->GetBufferPointer(), errorMessage->GetBufferSize());
+	fout.close();
+
+	errorMessage->Release();
+
+	MessageBox(hwnd, L"Error compiling shader. Check '__shader-error.txt' for message.", shaderFilename, MB_OK);
+
+	return;
+}
@@ -0,0 +1,176 @@
+// --------------------------------------------------------------------------------------------------------
+// ShaderProgramClass is what the shader classes had in common: it compiles a vertex and a pixel shader,
+// creates the input layout, the constant buffers and the sampler, and binds them all for a draw.
+//
+// The input layout is generated from a VertexLayoutClass, so it always matches the vertex struct.
+// The constant buffers are the ConstantBufferClass parameters, in the order they are passed:
+//
+//	ShaderProgramClass<VertexLayout, ConstantBufferClass<MatrixBufferType, SHADER_VERTEX, 0>,
+//									 ConstantBufferClass<PixelBufferType,  SHADER_PIXEL,  0> > m_program;
+//
+//	m_program.SetConstants<0>(deviceContext, matrices);
+//	m_program.Bind(deviceContext);
+//
+// The index, the size, the stages and the slot of a buffer are template arguments, so SetConstants is a Map, a copy,
+// an Unmap and the bindings, with nothing looked up at run time. A constant buffer whose size is not a multiple
+// of 16 bytes doesn't compile.
+//
+// Besides the first pixel shader, AddPixelShader loads other entry points for the same vertex shader and constants,
+// Bind takes the one to draw with.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SHADERPROGRAMCLASS_H_
+#define _SHADERPROGRAMCLASS_H_
+
+#include <d3d11.h>
+#include <string.h>
+
+#include "__vertexLayoutClass.h"
+#include "__perfStatsClass.h"
+
+// The stages a constant buffer is bound to
+#define SHADER_VERTEX 1
+#define SHADER_PIXEL  2
+
+#define SHADER_PROGRAM_MAX_PIXEL_SHADERS 4
+
+
+
+template <class Data, int Stages, unsigned int Slot>
+class ConstantBufferClass {
+ public:
+	static_assert(sizeof(Data) % 16 == 0, "the size of a constant buffer must be a multiple of 16 bytes");
+
+	typedef Data DataType;
+
+	enum { stages = Stages, slot = Slot, size = sizeof(Data) };
+};
+
+// The type of the constant buffer at an index of the list
+template <int Index, class... Buffers>
+struct ConstantBufferAt;
+
+template <class Buffer, class... Buffers>
+struct ConstantBufferAt<0, Buffer, Buffers...> {
+	typedef Buffer Type;
+};
+
+template <int Index, class Buffer, class... Buffers>
+struct ConstantBufferAt<Index, Buffer, Buffers...> {
+	typedef typename ConstantBufferAt<Index - 1, Buffers...>::Type Type;
+};
+
+
+
+// The part that doesn't depend on the layout and the constant buffers
+class ShaderProgramBaseClass {
+ public:
+	ShaderProgramBaseClass();
+	ShaderProgramBaseClass(const ShaderProgramBaseClass &);
+   ~ShaderProgramBaseClass();
+
+	// AddPixelShader loads another pixel shader, the n-th one added is the pixel shader n to Bind.
+	bool AddPixelShader(ID3D11Device *, HWND, WCHAR *, const char *);
+
+	// Bind sets the input layout, the shaders and the sampler.
+	void Bind(ID3D11DeviceContext *, int pixelShader = 0);
+
+ protected:
+	bool InitializeShaders(ID3D11Device *, HWND, WCHAR *, const char *, WCHAR *, const char *, const D3D11_INPUT_ELEMENT_DESC *, int, const D3D11_SAMPLER_DESC *);
+	bool CreateConstantBuffer(ID3D11Device *, int, ID3D11Buffer **);
+	void ShutdownShaders();
+
+ private:
+	void OutputShaderErrorMessage(ID3D10Blob *, HWND, WCHAR *);
+
+ private:
+	ID3D11VertexShader	*m_vertexShader;
+	ID3D11PixelShader	*m_pixelShaders[SHADER_PROGRAM_MAX_PIXEL_SHADERS];
+	int					 m_pixelShaderCount;
+	ID3D11InputLayout	*m_layout;
+	ID3D11SamplerState	*m_sampleState;
+};
+
+
+
+template <class Layout, class... Buffers>
+class ShaderProgramClass : public ShaderProgramBaseClass {
+ public:
+	ShaderProgramClass()
+	{
+		for (int i = 0; i < bufferCount; i++)
+			m_buffers[i] = 0;
+	}
+
+	ShaderProgramClass(const ShaderProgramClass &other)
+	{
+	}
+
+   ~ShaderProgramClass()
+	{
+	}
+
+	// Initialize loads the vertex and the pixel shader, the sampler is only made when a description is given.
+	bool Initialize(ID3D11Device *device, HWND hwnd, WCHAR *vsFilename, const char *vsEntry, WCHAR *psFilename, const char *psEntry,
+					const D3D11_SAMPLER_DESC *samplerDesc = 0)
+	{
+		D3D11_INPUT_ELEMENT_DESC layout[Layout::count];
+		int						 sizes[bufferCount + 1] = { Buffers::size... };
+
+		Layout::Describe(layout);
+
+		if (!InitializeShaders(device, hwnd, vsFilename, vsEntry, psFilename, psEntry, layout, Layout::count, samplerDesc))
+			return false;
+
+		for (int i = 0; i < bufferCount; i++)
+			if (!CreateConstantBuffer(device, sizes[i], &m_buffers[i]))
+				return false;
+
+		return true;
+	}
+
+	void Shutdown()
+	{
+		for (int i = 0; i < bufferCount; i++)
+			if (m_buffers[i]) {
+				m_buffers[i]->Release();
+				m_buffers[i] = 0;
+			}
+
+		ShutdownShaders();
+
+		return;
+	}
+
+	// SetConstants uploads the data of the constant buffer Index and binds it to its stages.
+	template <int Index>
+	bool SetConstants(ID3D11DeviceContext *deviceContext, const typename ConstantBufferAt<Index, Buffers...>::Type::DataType &data)
+	{
+		typedef typename ConstantBufferAt<Index, Buffers...>::Type Buffer;
+
+		D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+		if (FAILED(deviceContext->Map(m_buffers[Index], 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource)))
+			return false;
+
+		memcpy(mappedResource.pData, &data, Buffer::size);
+
+		deviceContext->Unmap(m_buffers[Index], 0);
+		PerfStatsClass::CountMap(Buffer::size);
+
+		if (Buffer::stages & SHADER_VERTEX)
+			deviceContext->VSSetConstantBuffers(Buffer::slot, 1, &m_buffers[Index]);
+
+		if (Buffer::stages & SHADER_PIXEL)
+			deviceContext->PSSetConstantBuffers(Buffer::slot, 1, &m_buffers[Index]);
+
+		return true;
+	}
+
+ private:
+	enum { bufferCount = sizeof...(Buffers) };
+
+	ID3D11Buffer *m_buffers[bufferCount + 1];
+};
+
+#endif
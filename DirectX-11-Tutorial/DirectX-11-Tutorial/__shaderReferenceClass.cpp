@@ -0,0 +1,506 @@
+#include "__shaderReferenceClass.h"
+
+#include <math.h>
+
+// A matrix as the four lanes see it, in the order of mul(v, M): out[j] = sum of v[i] * c[i][j].
+// The lanes may have different matrices (the instances), or all the same one (a constant buffer).
+struct LaneMatrixType {
+	__m128 c[4][4];
+};
+
+// A matrix of a constant buffer is transposed, row j of the stored matrix is column j of the one the shader multiplies by.
+static void LoadMatrix(const ShaderReferenceClass::MatrixType &matrix, LaneMatrixType *out)
+{
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			out->c[i][j] = _mm_set1_ps(matrix.m[j][i]);
+
+	return;
+}
+
+// A different (transposed) matrix for every lane
+static void LoadMatrices(const ShaderReferenceClass::MatrixType *matrices[4], LaneMatrixType *out)
+{
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			out->c[i][j] = _mm_setr_ps(matrices[0]->m[j][i], matrices[1]->m[j][i], matrices[2]->m[j][i], matrices[3]->m[j][i]);
+
+	return;
+}
+
+static void Transform(const LaneMatrixType &matrix, const ShaderReferenceClass::Float4Type &in, ShaderReferenceClass::Float4Type *out)
+{
+	__m128 v[4] = { in.x, in.y, in.z, in.w };
+	__m128 r[4];
+
+	for (int j = 0; j < 4; j++) {
+		r[j] = _mm_mul_ps(v[0], matrix.c[0][j]);
+
+		for (int i = 1; i < 4; i++)
+			r[j] = _mm_add_ps(r[j], _mm_mul_ps(v[i], matrix.c[i][j]));
+	}
+
+	out->x = r[0];
+	out->y = r[1];
+	out->z = r[2];
+	out->w = r[3];
+
+	return;
+}
+
+static __m128 Dot3(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz)
+{
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+}
+
+static void Normalize(ShaderReferenceClass::Float3Type *v)
+{
+	__m128 length = _mm_sqrt_ps(Dot3(v->x, v->y, v->z, v->x, v->y, v->z));
+
+	v->x = _mm_div_ps(v->x, length);
+	v->y = _mm_div_ps(v->y, length);
+	v->z = _mm_div_ps(v->z, length);
+
+	return;
+}
+
+static __m128 Saturate(__m128 v)
+{
+	return _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+static __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static __m128 Smoothstep(__m128 edge0, __m128 edge1, __m128 x)
+{
+	__m128 t = Saturate(_mm_div_ps(_mm_sub_ps(x, edge0), _mm_sub_ps(edge1, edge0)));
+
+	return _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_add_ps(t, t)));
+}
+
+// The texel a coordinate wraps to, with fmodf only for the coordinates too far out for an int.
+static int Wrap(float texel, int size)
+{
+	int wrapped = fabsf(texel) < 1.0e9f ? (int)texel % size : (int)fmodf(texel, (float)size);
+
+	return wrapped < 0 ? wrapped + size : wrapped;
+}
+
+// There is no SSE pow, the lanes are done one by one.
+static __m128 Pow(__m128 x, float power)
+{
+	float lanes[4];
+
+	_mm_storeu_ps(lanes, x);
+
+	for (int i = 0; i < 4; i++)
+		lanes[i] = powf(lanes[i], power);
+
+	return _mm_loadu_ps(lanes);
+}
+
+// The vertex position with w = 1, through a world matrix, the view and the projection
+static void TransformPosition(const LaneMatrixType &world, const ShaderReferenceClass::MatrixType &view, const ShaderReferenceClass::MatrixType &projection,
+							  const ShaderReferenceClass::Float3Type &in, ShaderReferenceClass::Float4Type *out)
+{
+	LaneMatrixType					 matrix;
+	ShaderReferenceClass::Float4Type position = { in.x, in.y, in.z, _mm_set1_ps(1.0f) };
+
+	Transform(world, position, out);
+
+	LoadMatrix(view, &matrix);
+	Transform(matrix, *out, out);
+
+	LoadMatrix(projection, &matrix);
+	Transform(matrix, *out, out);
+
+	return;
+}
+
+
+
+void ShaderReferenceClass::LightVertexShader(unsigned long long features, const ConstantsType::LightFrameBufferType &frame,
+											 const ConstantsType::LightObjectBufferType &object, const LightVertexType &in, LightPixelType *out)
+{
+	LaneMatrixType world, matrix;
+	Float4Type	   position = { in.position.x, in.position.y, in.position.z, _mm_set1_ps(1.0f) };
+
+	// The instance rows are the rows of the matrix the shader multiplies by.
+	if (features & SHADER_FEATURE_INSTANCING) {
+		for (int i = 0; i < 4; i++) {
+			world.c[i][0] = in.world[i].x;
+			world.c[i][1] = in.world[i].y;
+			world.c[i][2] = in.world[i].z;
+			world.c[i][3] = in.world[i].w;
+		}
+	}
+	else
+		LoadMatrix(object.world, &world);
+
+	Transform(world, position, &out->position);
+
+	out->worldPosition.x = out->position.x;
+	out->worldPosition.y = out->position.y;
+	out->worldPosition.z = out->position.z;
+
+	LoadMatrix(frame.view, &matrix);
+	Transform(matrix, out->position, &out->position);
+
+	out->viewDepth = out->position.z;
+
+	LoadMatrix(frame.projection, &matrix);
+	Transform(matrix, out->position, &out->position);
+
+	out->tex = in.tex;
+
+	// The normal through the 3x3 part of the world matrix
+	out->normal.x = Dot3(in.normal.x, in.normal.y, in.normal.z, world.c[0][0], world.c[1][0], world.c[2][0]);
+	out->normal.y = Dot3(in.normal.x, in.normal.y, in.normal.z, world.c[0][1], world.c[1][1], world.c[2][1]);
+	out->normal.z = Dot3(in.normal.x, in.normal.y, in.normal.z, world.c[0][2], world.c[1][2], world.c[2][2]);
+	Normalize(&out->normal);
+
+	if (features & SHADER_FEATURE_SPECULAR) {
+		out->viewDirection.x = _mm_sub_ps(_mm_set1_ps(frame.cameraPosition.x), out->worldPosition.x);
+		out->viewDirection.y = _mm_sub_ps(_mm_set1_ps(frame.cameraPosition.y), out->worldPosition.y);
+		out->viewDirection.z = _mm_sub_ps(_mm_set1_ps(frame.cameraPosition.z), out->worldPosition.z);
+		Normalize(&out->viewDirection);
+	}
+	else
+		out->viewDirection.x = out->viewDirection.y = out->viewDirection.z = _mm_setzero_ps();
+
+	return;
+}
+
+int ShaderReferenceClass::LightPixelShader(unsigned long long features, const ConstantsType::LightBufferType &light, const TextureType *texture,
+										   const ClusterResourcesType *clusters, const LightPixelType &in, Float4Type *out)
+{
+	Float4Type textureColor, color;
+	Float3Type lightDir, cluster;
+	__m128	   lightIntensity, lit, specular;
+	__m128	   one  = _mm_set1_ps(1.0f);
+	int		   mask = 0xF;
+
+	if ((features & SHADER_FEATURE_TEXTURE) && texture)
+		Sample(*texture, in.tex, &textureColor);
+	else
+		textureColor.x = textureColor.y = textureColor.z = textureColor.w = one;
+
+	// clip() discards the lanes with an alpha below the reference, they still run on like the other pixels of the quad do.
+	if (features & SHADER_FEATURE_ALPHA_TEST)
+		mask = _mm_movemask_ps(_mm_cmpnlt_ps(_mm_sub_ps(textureColor.w, _mm_set1_ps(0.5f)), _mm_setzero_ps()));
+
+	lightDir.x = _mm_set1_ps(-light.lightDirection.x);
+	lightDir.y = _mm_set1_ps(-light.lightDirection.y);
+	lightDir.z = _mm_set1_ps(-light.lightDirection.z);
+
+	lightIntensity = Saturate(Dot3(in.normal.x, in.normal.y, in.normal.z, lightDir.x, lightDir.y, lightDir.z));
+	lit			   = _mm_cmpgt_ps(lightIntensity, _mm_setzero_ps());
+
+	// Only the lit lanes get the diffuse color and are saturated, the others keep the ambient color as it is.
+	color.x = Select(lit, Saturate(_mm_add_ps(_mm_set1_ps(light.ambientColor.x), _mm_mul_ps(_mm_set1_ps(light.diffuseColor.x), lightIntensity))), _mm_set1_ps(light.ambientColor.x));
+	color.y = Select(lit, Saturate(_mm_add_ps(_mm_set1_ps(light.ambientColor.y), _mm_mul_ps(_mm_set1_ps(light.diffuseColor.y), lightIntensity))), _mm_set1_ps(light.ambientColor.y));
+	color.z = Select(lit, Saturate(_mm_add_ps(_mm_set1_ps(light.ambientColor.z), _mm_mul_ps(_mm_set1_ps(light.diffuseColor.z), lightIntensity))), _mm_set1_ps(light.ambientColor.z));
+	color.w = Select(lit, Saturate(_mm_add_ps(_mm_set1_ps(light.ambientColor.w), _mm_mul_ps(_mm_set1_ps(light.diffuseColor.w), lightIntensity))), _mm_set1_ps(light.ambientColor.w));
+
+	specular = _mm_setzero_ps();
+
+	if (features & SHADER_FEATURE_SPECULAR) {
+		Float3Type reflection;
+		__m128	   twice = _mm_add_ps(lightIntensity, lightIntensity);
+
+		reflection.x = _mm_sub_ps(_mm_mul_ps(twice, in.normal.x), lightDir.x);
+		reflection.y = _mm_sub_ps(_mm_mul_ps(twice, in.normal.y), lightDir.y);
+		reflection.z = _mm_sub_ps(_mm_mul_ps(twice, in.normal.z), lightDir.z);
+		Normalize(&reflection);
+
+		specular = Pow(Saturate(Dot3(reflection.x, reflection.y, reflection.z, in.viewDirection.x, in.viewDirection.y, in.viewDirection.z)), light.specularPower);
+		specular = _mm_and_ps(lit, specular);
+	}
+
+	// The clustered lights have no alpha, only its saturation is left.
+	if ((features & SHADER_FEATURE_CLUSTERED_LIGHTS) && clusters) {
+		ClusterLighting(*clusters, in, &cluster);
+
+		color.x = Saturate(_mm_add_ps(color.x, cluster.x));
+		color.y = Saturate(_mm_add_ps(color.y, cluster.y));
+		color.z = Saturate(_mm_add_ps(color.z, cluster.z));
+		color.w = Saturate(color.w);
+	}
+
+	out->x = Saturate(_mm_add_ps(_mm_mul_ps(color.x, textureColor.x), specular));
+	out->y = Saturate(_mm_add_ps(_mm_mul_ps(color.y, textureColor.y), specular));
+	out->z = Saturate(_mm_add_ps(_mm_mul_ps(color.z, textureColor.z), specular));
+	out->w = Saturate(_mm_add_ps(_mm_mul_ps(color.w, textureColor.w), specular));
+
+	return mask;
+}
+
+void ShaderReferenceClass::TextureVertexShader(const ConstantsType::TextureFrameBufferType &frame, const ConstantsType::TextureObjectBufferType &object,
+											   const TextureVertexType &in, TexturePixelType *out)
+{
+	LaneMatrixType world;
+
+	LoadMatrix(object.world, &world);
+	TransformPosition(world, frame.view, frame.projection, in.position, &out->position);
+
+	// The texture shader has no color, it is left white.
+	out->tex	 = in.tex;
+	out->color.x = out->color.y = out->color.z = out->color.w = _mm_set1_ps(1.0f);
+
+	return;
+}
+
+void ShaderReferenceClass::TextureObjectsVertexShader(const ConstantsType::TextureFrameBufferType &frame, const MatrixType *objectMatrices, const int *instances,
+													  const TextureVertexType &in, TexturePixelType *out)
+{
+	LaneMatrixType	  world;
+	const MatrixType *matrices[4];
+
+	for (int i = 0; i < 4; i++)
+		matrices[i] = &objectMatrices[instances[i]];
+
+	LoadMatrices(matrices, &world);
+	TransformPosition(world, frame.view, frame.projection, in.position, &out->position);
+
+	out->tex	 = in.tex;
+	out->color.x = out->color.y = out->color.z = out->color.w = _mm_set1_ps(1.0f);
+
+	return;
+}
+
+void ShaderReferenceClass::TexturePixelShader(const TextureType &texture, const TexturePixelType &in, Float4Type *out)
+{
+	Sample(texture, in.tex, out);
+
+	return;
+}
+
+void ShaderReferenceClass::TextureInstancingVertexShader(const ConstantsType::MatrixBufferType &matrices, const TextureInstanceVertexType &in, TexturePixelType *out)
+{
+	LaneMatrixType world;
+	Float3Type	   position;
+	Float2Type	   pos;
+	float		   angles[4], cosines[4], sines[4];
+	__m128		   Cos, Sin;
+
+	_mm_storeu_ps(angles, in.instancePosition.z);
+
+	for (int i = 0; i < 4; i++) {
+		cosines[i] = cosf(angles[i]);
+		sines[i]   = sinf(angles[i]);
+	}
+
+	Cos = _mm_loadu_ps(cosines);
+	Sin = _mm_loadu_ps(sines);
+
+	// The quad is scaled by the size of the instance, rotated by its angle and moved to its position.
+	pos.x = _mm_mul_ps(in.position.x, in.instanceSize);
+	pos.y = _mm_mul_ps(in.position.y, in.instanceSize);
+
+	position.x = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(pos.x, Cos), _mm_mul_ps(pos.y, Sin)), in.instancePosition.x);
+	position.y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pos.x, Sin), _mm_mul_ps(pos.y, Cos)), in.instancePosition.y);
+	position.z = _mm_set1_ps(1.0f);
+
+	LoadMatrix(matrices.world, &world);
+	TransformPosition(world, matrices.view, matrices.projection, position, &out->position);
+
+	out->tex.x = _mm_add_ps(in.instanceUV.x, _mm_mul_ps(in.tex.x, in.instanceUV.z));
+	out->tex.y = _mm_add_ps(in.instanceUV.y, _mm_mul_ps(in.tex.y, in.instanceUV.w));
+	out->color = in.instanceColor;
+
+	return;
+}
+
+void ShaderReferenceClass::TextureInstancingPixelShader(const TextureType &texture, const TexturePixelType &in, Float4Type *out)
+{
+	Sample(texture, in.tex, out);
+
+	out->x = _mm_mul_ps(out->x, in.color.x);
+	out->y = _mm_mul_ps(out->y, in.color.y);
+	out->z = _mm_mul_ps(out->z, in.color.z);
+	out->w = _mm_mul_ps(out->w, in.color.w);
+
+	return;
+}
+
+void ShaderReferenceClass::FontVertexShader(const ConstantsType::MatrixBufferType &matrices, const FontVertexType &in, TexturePixelType *out)
+{
+	LaneMatrixType world;
+
+	LoadMatrix(matrices.world, &world);
+	TransformPosition(world, matrices.view, matrices.projection, in.position, &out->position);
+
+	out->tex   = in.tex;
+	out->color = in.color;
+
+	return;
+}
+
+void ShaderReferenceClass::FontPixelShader(const TextureType &texture, const TexturePixelType &in, Float4Type *out)
+{
+	Float4Type coverage;
+
+	Sample(texture, in.tex, &coverage);
+
+	*out   = in.color;
+	out->w = _mm_mul_ps(out->w, coverage.x);
+
+	return;
+}
+
+// fwidth is taken across the quad like the GPU does: ddx is the right pixel minus the left one of the same row,
+// ddy the bottom pixel minus the top one of the same column.
+void ShaderReferenceClass::FontSdfPixelShader(const TextureType &texture, const TexturePixelType &in, Float4Type *out)
+{
+	Float4Type field;
+	__m128	   distance, ddx, ddy, width;
+	__m128	   sign = _mm_set1_ps(-0.0f);
+	__m128	   half = _mm_set1_ps(0.5f);
+
+	Sample(texture, in.tex, &field);
+	distance = field.x;
+
+	ddx = _mm_sub_ps(_mm_shuffle_ps(distance, distance, _MM_SHUFFLE(3, 3, 1, 1)), _mm_shuffle_ps(distance, distance, _MM_SHUFFLE(2, 2, 0, 0)));
+	ddy = _mm_sub_ps(_mm_shuffle_ps(distance, distance, _MM_SHUFFLE(3, 2, 3, 2)), _mm_shuffle_ps(distance, distance, _MM_SHUFFLE(1, 0, 1, 0)));
+
+	width = _mm_max_ps(_mm_add_ps(_mm_andnot_ps(sign, ddx), _mm_andnot_ps(sign, ddy)), _mm_set1_ps(0.0001f));
+
+	*out   = in.color;
+	out->w = _mm_mul_ps(out->w, Smoothstep(_mm_sub_ps(half, width), _mm_add_ps(half, width), distance));
+
+	return;
+}
+
+// The bilinear filter of the samplers: the four texels around the coordinates minus half a texel, wrapped around the edges.
+// Only the top mip level is read, what the GPU samples for a texture that is drawn at about its size or bigger.
+void ShaderReferenceClass::Sample(const TextureType &texture, const Float2Type &tex, Float4Type *out)
+{
+	float  u[4], v[4];
+	__m128 texels[4];
+
+	_mm_storeu_ps(u, tex.x);
+	_mm_storeu_ps(v, tex.y);
+
+	// A texel at a time, its four channels lerped at once
+	for (int lane = 0; lane < 4; lane++) {
+		float		 x = u[lane] * texture.width  - 0.5f;
+		float		 y = v[lane] * texture.height - 0.5f;
+		float		 fx = floorf(x), fy = floorf(y);
+		__m128		 ax = _mm_set1_ps(x - fx);
+		__m128		 ay = _mm_set1_ps(y - fy);
+		int			 x0 = Wrap(fx, texture.width);
+		int			 y0 = Wrap(fy, texture.height);
+		int			 x1 = x0 + 1 == texture.width  ? 0 : x0 + 1;
+		int			 y1 = y0 + 1 == texture.height ? 0 : y0 + 1;
+		__m128		 t00, t10, t01, t11, top, bottom;
+
+		t00 = _mm_loadu_ps(texture.texels + (y0 * texture.width + x0) * 4);
+		t10 = _mm_loadu_ps(texture.texels + (y0 * texture.width + x1) * 4);
+		t01 = _mm_loadu_ps(texture.texels + (y1 * texture.width + x0) * 4);
+		t11 = _mm_loadu_ps(texture.texels + (y1 * texture.width + x1) * 4);
+
+		top	   = _mm_add_ps(t00, _mm_mul_ps(_mm_sub_ps(t10, t00), ax));
+		bottom = _mm_add_ps(t01, _mm_mul_ps(_mm_sub_ps(t11, t01), ax));
+
+		texels[lane] = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), ay));
+	}
+
+	_MM_TRANSPOSE4_PS(texels[0], texels[1], texels[2], texels[3]);
+
+	out->x = texels[0];
+	out->y = texels[1];
+	out->z = texels[2];
+	out->w = texels[3];
+
+	return;
+}
+
+// The lanes of a quad are mostly in the same cluster, then its lights are looped over once for all four.
+// When they are not, every cluster is looped over with the lanes outside of it masked off.
+void ShaderReferenceClass::ClusterLighting(const ClusterResourcesType &resources, const LightPixelType &in, Float3Type *out)
+{
+	const ConstantsType::ClusterBufferType &constants = resources.constants;
+	float		 x[4], y[4], depth[4];
+	unsigned int clusters[4];
+	int			 done = 0;
+
+	_mm_storeu_ps(x, in.position.x);
+	_mm_storeu_ps(y, in.position.y);
+	_mm_storeu_ps(depth, in.viewDepth);
+
+	for (int lane = 0; lane < 4; lane++) {
+		float		 cluster[3] = { x[lane] * constants.tileScale[0], y[lane] * constants.tileScale[1], logf(depth[lane]) * constants.depthScale + constants.depthBias };
+		unsigned int index[3];
+
+		// Clamped before the conversion, a float out of the range of an unsigned int has no defined value.
+		for (int i = 0; i < 3; i++) {
+			if (!(cluster[i] > 0.0f))
+				cluster[i] = 0.0f;
+
+			if (cluster[i] > (float)(constants.clusterCounts[i] - 1))
+				cluster[i] = (float)(constants.clusterCounts[i] - 1);
+
+			index[i] = (unsigned int)cluster[i];
+		}
+
+		clusters[lane] = (index[2] * constants.clusterCounts[1] + index[1]) * constants.clusterCounts[0] + index[0];
+	}
+
+	out->x = out->y = out->z = _mm_setzero_ps();
+
+	for (int lane = 0; lane < 4; lane++) {
+		const unsigned int *grid;
+		unsigned int		laneBits[4];
+		__m128				laneMask;
+
+		if (done & (1 << lane))
+			continue;
+
+		for (int i = 0; i < 4; i++) {
+			laneBits[i] = clusters[i] == clusters[lane] ? 0xFFFFFFFF : 0;
+
+			if (laneBits[i])
+				done |= 1 << i;
+		}
+
+		laneMask = _mm_loadu_ps((const float*)laneBits);
+		grid	 = resources.grid + clusters[lane] * 2;
+
+		for (unsigned int i = 0; i < grid[1]; i++) {
+			const ClusterLightType &light = resources.lights[resources.indices[grid[0] + i]];
+			Float3Type				toLight;
+			__m128					distance, attenuation, intensity;
+
+			toLight.x = _mm_sub_ps(_mm_set1_ps(light.position[0]), in.worldPosition.x);
+			toLight.y = _mm_sub_ps(_mm_set1_ps(light.position[1]), in.worldPosition.y);
+			toLight.z = _mm_sub_ps(_mm_set1_ps(light.position[2]), in.worldPosition.z);
+
+			distance  = _mm_sqrt_ps(Dot3(toLight.x, toLight.y, toLight.z, toLight.x, toLight.y, toLight.z));
+			toLight.x = _mm_div_ps(toLight.x, _mm_max_ps(distance, _mm_set1_ps(0.0001f)));
+			toLight.y = _mm_div_ps(toLight.y, _mm_max_ps(distance, _mm_set1_ps(0.0001f)));
+			toLight.z = _mm_div_ps(toLight.z, _mm_max_ps(distance, _mm_set1_ps(0.0001f)));
+
+			attenuation = Saturate(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_div_ps(distance, _mm_set1_ps(light.range))));
+			intensity	= _mm_mul_ps(Saturate(Dot3(in.normal.x, in.normal.y, in.normal.z, toLight.x, toLight.y, toLight.z)), _mm_mul_ps(attenuation, attenuation));
+
+			// A spot light fades out over the outer part of its cone.
+			if (light.spotCos > -1.0f) {
+				__m128 cosine = _mm_sub_ps(_mm_setzero_ps(), Dot3(toLight.x, toLight.y, toLight.z,
+										   _mm_set1_ps(light.direction[0]), _mm_set1_ps(light.direction[1]), _mm_set1_ps(light.direction[2])));
+
+				intensity = _mm_mul_ps(intensity, Smoothstep(_mm_set1_ps(light.spotCos), _mm_set1_ps(light.spotCos + (1.0f - light.spotCos) * 0.2f), cosine));
+			}
+
+			intensity = _mm_and_ps(laneMask, intensity);
+
+			out->x = _mm_add_ps(out->x, _mm_mul_ps(_mm_set1_ps(light.color[0]), intensity));
+			out->y = _mm_add_ps(out->y, _mm_mul_ps(_mm_set1_ps(light.color[1]), intensity));
+			out->z = _mm_add_ps(out->z, _mm_mul_ps(_mm_set1_ps(light.color[2]), intensity));
+		}
+	}
+
+	return;
+}
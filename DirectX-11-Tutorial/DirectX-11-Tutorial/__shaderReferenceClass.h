@@ -0,0 +1,144 @@
+// --------------------------------------------------------------------------------------------------------
+// ShaderReferenceClass is the C++ twin of the vertex and pixel shaders in _shaderLight.vs/ps, _shaderTexture.vs/ps,
+// _shaderTextureInstancing.vs/ps and _shaderFont.vs/ps, so the shader math can be checked and timed without a GPU.
+// A change to one of these shaders has to be made here too.
+//
+// Every function runs four lanes at once with SSE: four vertices, or the four pixels of a 2x2 quad
+// (top left, top right, bottom left, bottom right), which is also how the derivatives of FontSdfPixelShader are taken.
+// The constants come in the ShaderConstantsClass structs the shader classes upload, matrices transposed as the GPU gets them.
+// The light shaders take the feature bits of their variant (SHADER_FEATURE_SPECULAR, ...).
+// Only the stages are here: the caller interpolates the vertex shader output and sets the screen position of the pixels.
+//
+// A texture is sampled like the samplers of the shader classes do, bilinear with wrapped coordinates,
+// but only from the top mip level. The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SHADERREFERENCECLASS_H_
+#define _SHADERREFERENCECLASS_H_
+
+#include <xmmintrin.h>
+
+#include "__shaderConstantsClass.h"
+#include "__lightClusterClass.h"
+
+
+
+class ShaderReferenceClass {
+ public:
+	struct Vector3Type {
+		float x, y, z;
+	};
+
+	struct Vector4Type {
+		float x, y, z, w;
+	};
+
+	struct MatrixType {
+		float m[4][4];
+	};
+
+	typedef ShaderConstantsClass<MatrixType, Vector3Type, Vector4Type> ConstantsType;
+
+	// The four lanes of a float2, float3 and float4
+	struct Float2Type {
+		__m128 x, y;
+	};
+
+	struct Float3Type {
+		__m128 x, y, z;
+	};
+
+	struct Float4Type {
+		__m128 x, y, z, w;
+	};
+
+	// RGBA floats, row by row from the top
+	struct TextureType {
+		int			 width, height;
+		const float *texels;
+	};
+
+	// The buffers of the clustered lights, as ClusteredLightsClass uploads them
+	struct ClusterResourcesType {
+		ConstantsType::ClusterBufferType constants;
+		const ClusterLightType			*lights;
+		const unsigned int				*grid;
+		const unsigned int				*indices;
+	};
+
+	// _shaderLight.vs/ps. The world rows are the instance data of the INSTANCING variant (not transposed).
+	struct LightVertexType {
+		Float3Type position;
+		Float2Type tex;
+		Float3Type normal;
+		Float4Type world[4];
+	};
+
+	struct LightPixelType {
+		Float4Type position;		// SV_POSITION: clip space out of the vertex shader, the pixel center on the screen into the pixel shader
+		Float2Type tex;
+		Float3Type normal;
+		Float3Type viewDirection;
+		Float3Type worldPosition;
+		__m128	   viewDepth;
+	};
+
+	// _shaderTexture.vs, _shaderTextureInstancing.vs and _shaderFont.vs all give the pixel shader the same three values.
+	struct TextureVertexType {
+		Float3Type position;
+		Float2Type tex;
+	};
+
+	struct TextureInstanceVertexType {
+		Float3Type position;
+		Float2Type tex;
+		Float3Type instancePosition;	// x, y and the angle
+		__m128	   instanceSize;
+		Float4Type instanceColor;
+		Float4Type instanceUV;
+	};
+
+	struct FontVertexType {
+		Float3Type position;
+		Float2Type tex;
+		Float4Type color;
+	};
+
+	struct TexturePixelType {
+		Float4Type position;
+		Float2Type tex;
+		Float4Type color;
+	};
+
+ public:
+	// _shaderLight.vs/ps. The pixel shader returns the lanes it draws (bit n for lane n), the alpha test discards the others.
+	// The texture and the clusters are only read by the variants that have the feature.
+	static void LightVertexShader(unsigned long long, const ConstantsType::LightFrameBufferType &, const ConstantsType::LightObjectBufferType &,
+								  const LightVertexType &, LightPixelType *);
+	static int	LightPixelShader(unsigned long long, const ConstantsType::LightBufferType &, const TextureType *, const ClusterResourcesType *,
+								 const LightPixelType &, Float4Type *);
+
+	// _shaderTexture.vs/ps. TextureObjectsVertexShader takes the world matrices of the objects (transposed) and the instance of every lane.
+	static void TextureVertexShader(const ConstantsType::TextureFrameBufferType &, const ConstantsType::TextureObjectBufferType &,
+									const TextureVertexType &, TexturePixelType *);
+	static void TextureObjectsVertexShader(const ConstantsType::TextureFrameBufferType &, const MatrixType *, const int *,
+										   const TextureVertexType &, TexturePixelType *);
+	static void TexturePixelShader(const TextureType &, const TexturePixelType &, Float4Type *);
+
+	// _shaderTextureInstancing.vs/ps
+	static void TextureInstancingVertexShader(const ConstantsType::MatrixBufferType &, const TextureInstanceVertexType &, TexturePixelType *);
+	static void TextureInstancingPixelShader(const TextureType &, const TexturePixelType &, Float4Type *);
+
+	// _shaderFont.vs/ps
+	static void FontVertexShader(const ConstantsType::MatrixBufferType &, const FontVertexType &, TexturePixelType *);
+	static void FontPixelShader(const TextureType &, const TexturePixelType &, Float4Type *);
+	static void FontSdfPixelShader(const TextureType &, const TexturePixelType &, Float4Type *);
+
+	// Sample reads the texture at the coordinates of the four lanes.
+	static void Sample(const TextureType &, const Float2Type &, Float4Type *);
+
+ private:
+	static void ClusterLighting(const ClusterResourcesType &, const LightPixelType &, Float3Type *);
+};
+
+#endif
@@ -0,0 +1,1468 @@
+#include "__softwareBackendClass.h"
+#include "__headlessBackendClass.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
+
+#include <math.h>
+#include <string.h>
+#include <fstream>
+#include <algorithm>
+
+// The vertex attributes an input layout can fill, by their semantics
+#define ATTRIBUTE_POSITION 0
+#define ATTRIBUTE_NORMAL   1
+#define ATTRIBUTE_COLOR	   2
+#define ATTRIBUTE_TEXCOORD 3		// TEXCOORD0 to TEXCOORD3
+#define ATTRIBUTE_WORLD	   7		// WORLD0 to WORLD3
+#define ATTRIBUTE_COUNT	   11
+
+// The largest 24 bit depth, the depth buffer is cleared to it
+#define DEPTH_MAX 16777215
+
+static int GetAttribute(const char *semantic, int index)
+{
+	if (!semantic || index < 0)
+		return -1;
+
+	if (!strcmp(semantic, "POSITION") && index == 0)
+		return ATTRIBUTE_POSITION;
+
+	if (!strcmp(semantic, "NORMAL") && index == 0)
+		return ATTRIBUTE_NORMAL;
+
+	if (!strcmp(semantic, "COLOR") && index == 0)
+		return ATTRIBUTE_COLOR;
+
+	if (!strcmp(semantic, "TEXCOORD") && index < 4)
+		return ATTRIBUTE_TEXCOORD + index;
+
+	if (!strcmp(semantic, "WORLD") && index < 4)
+		return ATTRIBUTE_WORLD + index;
+
+	return -1;
+}
+
+// The float formats of the layouts, R32G32B32A32 down to R32
+static int GetComponents(int format)
+{
+	switch (format) {
+		case 2:	 return 4;
+		case 6:	 return 3;
+		case 16: return 2;
+		case 41: return 1;
+	}
+
+	return 0;
+}
+
+// The attributes are kept as [attribute][component][lane], so a component of the four vertices loads at once.
+static ShaderReferenceClass::Float2Type Load2(const float attribute[4][4])
+{
+	ShaderReferenceClass::Float2Type value = { _mm_loadu_ps(attribute[0]), _mm_loadu_ps(attribute[1]) };
+
+	return value;
+}
+
+static ShaderReferenceClass::Float3Type Load3(const float attribute[4][4])
+{
+	ShaderReferenceClass::Float3Type value = { _mm_loadu_ps(attribute[0]), _mm_loadu_ps(attribute[1]), _mm_loadu_ps(attribute[2]) };
+
+	return value;
+}
+
+static ShaderReferenceClass::Float4Type Load4(const float attribute[4][4])
+{
+	ShaderReferenceClass::Float4Type value = { _mm_loadu_ps(attribute[0]), _mm_loadu_ps(attribute[1]), _mm_loadu_ps(attribute[2]), _mm_loadu_ps(attribute[3]) };
+
+	return value;
+}
+
+// Store puts the four lanes of a value into the same float of four shaded vertices.
+static void Store(__m128 value, float *vertices, int index)
+{
+	float lanes[4];
+
+	_mm_storeu_ps(lanes, value);
+
+	for (int i = 0; i < 4; i++)
+		vertices[i * SOFTWARE_VERTEX_FLOATS + index] = lanes[i];
+
+	return;
+}
+
+static void Store(const ShaderReferenceClass::Float2Type &value, float *vertices, int index)
+{
+	Store(value.x, vertices, index);
+	Store(value.y, vertices, index + 1);
+
+	return;
+}
+
+static void Store(const ShaderReferenceClass::Float3Type &value, float *vertices, int index)
+{
+	Store(value.x, vertices, index);
+	Store(value.y, vertices, index + 1);
+	Store(value.z, vertices, index + 2);
+
+	return;
+}
+
+static void Store(const ShaderReferenceClass::Float4Type &value, float *vertices, int index)
+{
+	Store(value.x, vertices, index);
+	Store(value.y, vertices, index + 1);
+	Store(value.z, vertices, index + 2);
+	Store(value.w, vertices, index + 3);
+
+	return;
+}
+
+// An 8 bit channel holds 256 levels, the colors are rounded to the nearest one (the even one on a tie) like the GPU writes them.
+// Adding 1.5 * 2^23 leaves no bits below the units, SSE rounds there.
+static __m128 Quantize(__m128 value)
+{
+	__m128 round = _mm_set1_ps(12582912.0f);
+
+	value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	value = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(255.0f)), round), round);
+
+	return _mm_mul_ps(value, _mm_set1_ps(1.0f / 255.0f));
+}
+
+SoftwareBackendClass::SoftwareBackendClass()
+{
+	m_width			= 0;
+	m_height		= 0;
+	m_target		= 0;
+	m_state			= 0;
+	m_vertexShader	= 0;
+	m_pixelShader	= 0;
+	m_indexBuffer	= 0;
+	m_batch			= 1;
+	m_tilesX		= 0;
+	m_tilesY		= 0;
+	m_nextTile		= 0;
+	m_triangleCount = 0;
+	m_threadCount	= 1;
+	m_generation	= 0;
+	m_pending		= 0;
+	m_quit			= false;
+
+	memset(m_vertexBuffers, 0, sizeof(m_vertexBuffers));
+	memset(m_strides, 0, sizeof(m_strides));
+	memset(m_offsets, 0, sizeof(m_offsets));
+	memset(m_constantBuffers, 0, sizeof(m_constantBuffers));
+	memset(m_textures, 0, sizeof(m_textures));
+	memset(&m_drawTarget, 0, sizeof(m_drawTarget));
+}
+
+SoftwareBackendClass::SoftwareBackendClass(const SoftwareBackendClass& other)
+{
+}
+
+SoftwareBackendClass::~SoftwareBackendClass()
+{
+}
+
+bool SoftwareBackendClass::Initialize(int width, int height, int threadCount)
+{
+	float black[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	int	  tileCount;
+
+	if (width <= 0 || height <= 0)
+		return false;
+
+	m_width	 = width;
+	m_height = height;
+	m_color.resize(width * height * 4);
+	m_depth.resize(width * height);
+
+	ClearTarget(black, true);
+
+	// There is no use for more threads than tiles of the back buffer.
+	tileCount	  = ((width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE) * ((height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE);
+	m_threadCount = threadCount < 1 ? 1 : (threadCount > tileCount ? tileCount : threadCount);
+	m_quadCounts.assign(m_threadCount, 0);
+
+	m_quit		 = false;
+	m_generation = 0;
+	m_pending	 = 0;
+
+	for (int i = 1; i < m_threadCount; i++)
+		m_workers.push_back(thread(&SoftwareBackendClass::WorkerThread, this, i));
+
+	return true;
+}
+
+void SoftwareBackendClass::Shutdown()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_quit = true;
+	}
+
+	m_wakeUp.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+		m_workers[i].join();
+
+	m_workers.clear();
+
+	for (size_t i = 0; i < m_objects.size(); i++)
+		delete m_objects[i];
+
+	m_objects.clear();
+	m_freeHandles.clear();
+
+	m_draws.clear();
+	m_vertices.clear();
+	m_triangles.clear();
+	m_tiles.clear();
+	m_color.clear();
+	m_depth.clear();
+
+	return;
+}
+
+int SoftwareBackendClass::GetWidth()
+{
+	return m_width;
+}
+
+int SoftwareBackendClass::GetHeight()
+{
+	return m_height;
+}
+
+void SoftwareBackendClass::GetPixels(unsigned char *pixels)
+{
+	Flush();
+
+	for (size_t i = 0; i < m_color.size(); i += 4) {
+		float values[4];
+
+		_mm_storeu_ps(values, _mm_mul_ps(Quantize(_mm_loadu_ps(&m_color[i])), _mm_set1_ps(255.0f)));
+
+		for (int c = 0; c < 4; c++)
+			pixels[i + c] = (unsigned char)values[c];
+	}
+
+	return;
+}
+
+// An uncompressed 32 bit TGA, the rows from the top (bit 5 of the descriptor) and 8 bits of alpha, in BGRA order.
+bool SoftwareBackendClass::SaveImage(const char *filename)
+{
+	vector<unsigned char> pixels(m_width * m_height * 4);
+	unsigned char		  header[18];
+	ofstream			  fout;
+
+	if (!m_width)
+		return false;
+
+	GetPixels(&pixels[0]);
+
+	for (size_t i = 0; i < pixels.size(); i += 4) {
+		unsigned char red = pixels[i];
+
+		pixels[i]	  = pixels[i + 2];
+		pixels[i + 2] = red;
+	}
+
+	memset(header, 0, sizeof(header));
+	header[2]  = 2;
+	header[12] = (unsigned char)(m_width & 0xFF);
+	header[13] = (unsigned char)(m_width >> 8);
+	header[14] = (unsigned char)(m_height & 0xFF);
+	header[15] = (unsigned char)(m_height >> 8);
+	header[16] = 32;
+	header[17] = 0x28;
+
+	fout.open(filename, ios::out | ios::binary);
+
+	if (fout.fail())
+		return false;
+
+	fout.write((const char*)header, sizeof(header));
+	fout.write((const char*)&pixels[0], pixels.size());
+	fout.close();
+
+	return !fout.fail();
+}
+
+int SoftwareBackendClass::GetTriangleCount()
+{
+	return m_triangleCount;
+}
+
+int SoftwareBackendClass::GetQuadCount()
+{
+	int count = 0;
+
+	for (size_t i = 0; i < m_quadCounts.size(); i++)
+		count += m_quadCounts[i];
+
+	return count;
+}
+
+void SoftwareBackendClass::ResetCounters()
+{
+	m_triangleCount = 0;
+	m_quadCounts.assign(m_threadCount, 0);
+
+	return;
+}
+
+RenderBackendClass::HandleType SoftwareBackendClass::CreateBuffer(const BufferDescType &desc, const void *data)
+{
+	ObjectType *object;
+
+	if (desc.type < RENDER_BUFFER_VERTEX || desc.type > RENDER_BUFFER_STRUCTURED || desc.size <= 0)
+		return 0;
+
+	object			= new ObjectType();
+	object->kind	= SOFTWARE_OBJECT_BUFFER;
+	object->type	= desc.type;
+	object->dynamic = desc.dynamic;
+	object->data.assign(desc.size, 0);
+
+	if (data)
+		memcpy(&object->data[0], data, desc.size);
+
+	return NewObject(object);
+}
+
+// The texels are kept as floats: an R8 texture samples as (r, 0, 0, 1) like the GPU reads it.
+RenderBackendClass::HandleType SoftwareBackendClass::CreateTexture(const TextureDescType &desc, const void *data, int pitch)
+{
+	ObjectType *object;
+
+	if (desc.width <= 0 || desc.height <= 0 ||
+		(desc.format != RENDER_FORMAT_RGBA32F && desc.format != RENDER_FORMAT_RGBA8 && desc.format != RENDER_FORMAT_R8))
+		return 0;
+
+	object				 = new ObjectType();
+	object->kind		 = SOFTWARE_OBJECT_TEXTURE;
+	object->width		 = desc.width;
+	object->height		 = desc.height;
+	object->format		 = desc.format;
+	object->renderTarget = desc.renderTarget;
+	object->texels.assign(desc.width * desc.height * 4, 0.0f);
+
+	if (data)
+		for (int y = 0; y < desc.height; y++) {
+			const unsigned char *row	= (const unsigned char*)data + y * pitch;
+			float				*texels = &object->texels[y * desc.width * 4];
+
+			for (int x = 0; x < desc.width; x++, texels += 4)
+				if (desc.format == RENDER_FORMAT_RGBA32F)
+					memcpy(texels, row + x * 16, 16);
+				else if (desc.format == RENDER_FORMAT_RGBA8)
+					for (int c = 0; c < 4; c++)
+						texels[c] = row[x * 4 + c] / 255.0f;
+				else {
+					texels[0] = row[x] / 255.0f;
+					texels[3] = 1.0f;
+				}
+		}
+
+	return NewObject(object);
+}
+
+// The shader is known by its entry point. The vertex shaders of _shaderTexture.vs and _shaderTextureInstancing.vs
+// have the same one, the instancing one is told apart by its per instance elements.
+RenderBackendClass::HandleType SoftwareBackendClass::CreateShader(const ShaderDescType &desc)
+{
+	ObjectType *object;
+	int			program	 = 0;
+	bool		instance = false;
+
+	if (!desc.entry)
+		return 0;
+
+	for (int i = 0; i < desc.elementCount; i++)
+		instance |= desc.elements[i].perInstance;
+
+	if (desc.stage == RENDER_STAGE_VERTEX) {
+		if (!strcmp(desc.entry, "LightVertexShader"))
+			program = SOFTWARE_VS_LIGHT;
+		else if (!strcmp(desc.entry, "TextureVertexShader"))
+			program = instance ? SOFTWARE_VS_TEXTURE_INSTANCING : SOFTWARE_VS_TEXTURE;
+		else if (!strcmp(desc.entry, "TextureObjectsVertexShader"))
+			program = SOFTWARE_VS_TEXTURE_OBJECTS;
+		else if (!strcmp(desc.entry, "FontVertexShader"))
+			program = SOFTWARE_VS_FONT;
+	}
+	else if (desc.stage == RENDER_STAGE_PIXEL) {
+		if (!strcmp(desc.entry, "LightPixelShader"))
+			program = SOFTWARE_PS_LIGHT;
+		else if (!strcmp(desc.entry, "TexturePixelShader"))
+			program = SOFTWARE_PS_TEXTURE;
+		else if (!strcmp(desc.entry, "FontPixelShader"))
+			program = SOFTWARE_PS_FONT;
+		else if (!strcmp(desc.entry, "FontSdfPixelShader"))
+			program = SOFTWARE_PS_FONT_SDF;
+	}
+
+	if (!program)
+		return 0;
+
+	object			 = new ObjectType();
+	object->kind	 = SOFTWARE_OBJECT_SHADER;
+	object->type	 = desc.stage;
+	object->program	 = program;
+	object->features = desc.features;
+
+	// The elements the shaders don't read, or not as floats, are left out.
+	for (int i = 0; i < desc.elementCount; i++) {
+		ElementType element;
+
+		element.attribute	= GetAttribute(desc.elements[i].semantic, desc.elements[i].semanticIndex);
+		element.components	= GetComponents(desc.elements[i].format);
+		element.slot		= desc.elements[i].slot;
+		element.offset		= desc.elements[i].offset;
+		element.perInstance = desc.elements[i].perInstance;
+
+		if (element.attribute >= 0 && element.components > 0 && element.slot >= 0 && element.slot < RENDER_MAX_BINDINGS)
+			object->elements.push_back(element);
+	}
+
+	return NewObject(object);
+}
+
+RenderBackendClass::HandleType SoftwareBackendClass::CreateState(const StateDescType &desc)
+{
+	ObjectType *object = new ObjectType();
+
+	object->kind  = SOFTWARE_OBJECT_STATE;
+	object->state = desc;
+
+	return NewObject(object);
+}
+
+// The binned triangles may still read the object, they are drawn first.
+void SoftwareBackendClass::Release(HandleType handle)
+{
+	ObjectType *object = FindObject(handle, 0);
+
+	if (!object)
+		return;
+
+	if (object->batch == m_batch || handle == m_target)
+		Flush();
+
+	if (handle == m_target)
+		m_target = 0;
+
+	delete object;
+	m_objects[handle - 1] = 0;
+	m_freeHandles.push_back(handle);
+
+	return;
+}
+
+bool SoftwareBackendClass::UpdateBuffer(HandleType handle, const void *data, int size)
+{
+	ObjectType *object = FindObject(handle, SOFTWARE_OBJECT_BUFFER);
+
+	if (!object || !object->dynamic || size < 0 || size > (int)object->data.size())
+		return false;
+
+	if (object->batch == m_batch)
+		Flush();
+
+	if (size > 0)
+		memcpy(&object->data[0], data, size);
+
+	PerfStatsClass::CountMap(size);
+
+	return true;
+}
+
+void SoftwareBackendClass::BeginFrame(const float *color)
+{
+	Flush();
+
+	m_target = 0;
+	ClearTarget(color, true);
+
+	return;
+}
+
+void SoftwareBackendClass::EndFrame()
+{
+	Flush();
+
+	return;
+}
+
+void SoftwareBackendClass::SetRenderTarget(HandleType handle)
+{
+	ObjectType *object = FindObject(handle, SOFTWARE_OBJECT_TEXTURE);
+
+	if (handle && (!object || !object->renderTarget))
+		return;
+
+	if (handle != m_target) {
+		Flush();
+		m_target = handle;
+	}
+
+	return;
+}
+
+void SoftwareBackendClass::Clear(const float *color)
+{
+	Flush();
+	ClearTarget(color, false);
+
+	return;
+}
+
+void SoftwareBackendClass::SetState(HandleType handle)
+{
+	m_state = handle;
+
+	return;
+}
+
+void SoftwareBackendClass::SetShaders(HandleType vertexShader, HandleType pixelShader)
+{
+	m_vertexShader = vertexShader;
+	m_pixelShader  = pixelShader;
+
+	return;
+}
+
+void SoftwareBackendClass::SetVertexBuffers(int startSlot, int count, const HandleType *handles, const unsigned int *strides, const unsigned int *offsets)
+{
+	for (int i = 0; i < count; i++)
+		if (startSlot + i >= 0 && startSlot + i < RENDER_MAX_BINDINGS) {
+			m_vertexBuffers[startSlot + i] = handles[i];
+			m_strides[startSlot + i]	   = strides[i];
+			m_offsets[startSlot + i]	   = offsets[i];
+		}
+
+	return;
+}
+
+void SoftwareBackendClass::SetIndexBuffer(HandleType handle)
+{
+	m_indexBuffer = handle;
+
+	return;
+}
+
+void SoftwareBackendClass::SetConstantBuffers(int stages, int startSlot, int count, const HandleType *handles)
+{
+	for (int i = 0; i < count; i++)
+		if (startSlot + i >= 0 && startSlot + i < RENDER_MAX_BINDINGS) {
+			if (stages & RENDER_STAGE_VERTEX)
+				m_constantBuffers[0][startSlot + i] = handles[i];
+
+			if (stages & RENDER_STAGE_PIXEL)
+				m_constantBuffers[1][startSlot + i] = handles[i];
+		}
+
+	return;
+}
+
+void SoftwareBackendClass::SetTextures(int stages, int startSlot, int count, const HandleType *handles)
+{
+	for (int i = 0; i < count; i++)
+		if (startSlot + i >= 0 && startSlot + i < RENDER_MAX_BINDINGS) {
+			if (stages & RENDER_STAGE_VERTEX)
+				m_textures[0][startSlot + i] = handles[i];
+
+			if (stages & RENDER_STAGE_PIXEL)
+				m_textures[1][startSlot + i] = handles[i];
+		}
+
+	return;
+}
+
+void SoftwareBackendClass::Draw(int vertexCount, int startVertex)
+{
+	Submit(false, vertexCount, 1, startVertex, 0, 0);
+
+	return;
+}
+
+void SoftwareBackendClass::DrawIndexed(int indexCount, int startIndex, int baseVertex)
+{
+	Submit(true, indexCount, 1, startIndex, baseVertex, 0);
+
+	return;
+}
+
+void SoftwareBackendClass::DrawInstanced(int vertexCount, int instanceCount, int startVertex, int startInstance)
+{
+	Submit(false, vertexCount, instanceCount, startVertex, 0, startInstance);
+
+	return;
+}
+
+void SoftwareBackendClass::DrawIndexedInstanced(int indexCount, int instanceCount, int startIndex, int baseVertex, int startInstance)
+{
+	Submit(true, indexCount, instanceCount, startIndex, baseVertex, startInstance);
+
+	return;
+}
+
+// The recorder has no owner: it does not check the handles, they are the ones of this backend and are played back as they are.
+RenderContextClass* SoftwareBackendClass::CreateDeferredContext()
+{
+	HeadlessBackendClass *recorder = new HeadlessBackendClass;
+
+	if (!recorder)
+		return 0;
+
+	recorder->SetOwner(0);
+
+	return recorder;
+}
+
+void SoftwareBackendClass::ExecuteDeferredContext(RenderContextClass *context)
+{
+	HeadlessBackendClass *recorder = (HeadlessBackendClass*)context;
+
+	HeadlessBackendClass::ReplayContext(recorder->GetStream(), this);
+
+	recorder->GetStream()->Clear();
+	recorder->ResetCounters();
+
+	SetRenderTarget(0);
+
+	return;
+}
+
+void SoftwareBackendClass::ReleaseDeferredContext(RenderContextClass *context)
+{
+	HeadlessBackendClass *recorder = (HeadlessBackendClass*)context;
+
+	if (recorder) {
+		recorder->Shutdown();
+		delete recorder;
+	}
+
+	return;
+}
+
+RenderBackendClass::HandleType SoftwareBackendClass::NewObject(ObjectType *object)
+{
+	HandleType handle;
+
+	object->batch = 0;
+
+	if (!m_freeHandles.empty()) {
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+		m_objects[handle - 1] = object;
+	}
+	else {
+		m_objects.push_back(object);
+		handle = (HandleType)m_objects.size();
+	}
+
+	return handle;
+}
+
+// FindObject returns the object of a handle if it is of the kind, any kind for 0.
+SoftwareBackendClass::ObjectType* SoftwareBackendClass::FindObject(HandleType handle, int kind)
+{
+	ObjectType *object;
+
+	if (handle == 0 || handle > m_objects.size())
+		return 0;
+
+	object = m_objects[handle - 1];
+
+	return object && (!kind || object->kind == kind) ? object : 0;
+}
+
+// GetConstants returns the data of the constant buffer in a slot of a stage (0 vertex, 1 pixel) if it has the size of the struct.
+const void* SoftwareBackendClass::GetConstants(int stage, int slot, int size)
+{
+	ObjectType *object = FindObject(m_constantBuffers[stage][slot], SOFTWARE_OBJECT_BUFFER);
+
+	return object && (int)object->data.size() >= size ? &object->data[0] : 0;
+}
+
+// GetResource returns the texture or structured buffer in a slot of a stage. The pixel shaders read theirs
+// when the tiles are drawn, so the batch marks them, to draw the tiles before they change.
+SoftwareBackendClass::ObjectType* SoftwareBackendClass::GetResource(int stage, int slot, int kind)
+{
+	ObjectType *object = FindObject(m_textures[stage][slot], kind);
+
+	if (object && kind == SOFTWARE_OBJECT_BUFFER && object->type != RENDER_BUFFER_STRUCTURED)
+		return 0;
+
+	if (object && stage == 1)
+		object->batch = m_batch;
+
+	return object;
+}
+
+// SetupDraw takes what the pixel shader of the draw reads, and fails if it has to read what isn't bound.
+bool SoftwareBackendClass::SetupDraw(ObjectType *vertexShader, ObjectType *pixelShader, DrawType *draw)
+{
+	ObjectType *state = FindObject(m_state, SOFTWARE_OBJECT_STATE);
+	ObjectType *texture;
+	const void *light;
+
+	memset(draw, 0, sizeof(DrawType));
+
+	// Without a state the draw gets the one d3dClass starts with.
+	if (state)
+		draw->state = state->state;
+	else {
+		draw->state.alphaBlending = false;
+		draw->state.depthTest	  = true;
+		draw->state.depthWrite	  = true;
+		draw->state.cullBack	  = true;
+	}
+
+	// The light shaders only go with each other, the others all hand the same values to the pixel shader.
+	if ((vertexShader->program == SOFTWARE_VS_LIGHT) != (pixelShader->program == SOFTWARE_PS_LIGHT))
+		return false;
+
+	draw->pixelShader = pixelShader->program;
+	draw->features	  = pixelShader->features;
+
+	if (draw->pixelShader == SOFTWARE_PS_TEXTURE && vertexShader->program == SOFTWARE_VS_TEXTURE_INSTANCING)
+		draw->pixelShader = SOFTWARE_PS_TEXTURE_INSTANCING;
+
+	if (draw->pixelShader != SOFTWARE_PS_LIGHT || (draw->features & SHADER_FEATURE_TEXTURE)) {
+		texture = GetResource(1, 0, SOFTWARE_OBJECT_TEXTURE);
+
+		if (!texture)
+			return false;
+
+		draw->texture.width	 = texture->width;
+		draw->texture.height = texture->height;
+		draw->texture.texels = &texture->texels[0];
+	}
+
+	if (draw->pixelShader == SOFTWARE_PS_LIGHT) {
+		light = GetConstants(1, 0, sizeof(ConstantsType::LightBufferType));
+
+		if (!light)
+			return false;
+
+		memcpy(&draw->light, light, sizeof(draw->light));
+
+		if (draw->features & SHADER_FEATURE_CLUSTERED_LIGHTS) {
+			const void *constants = GetConstants(1, 1, sizeof(ConstantsType::ClusterBufferType));
+			ObjectType *lights	  = GetResource(1, 1, SOFTWARE_OBJECT_BUFFER);
+			ObjectType *grid	  = GetResource(1, 2, SOFTWARE_OBJECT_BUFFER);
+			ObjectType *indices	  = GetResource(1, 3, SOFTWARE_OBJECT_BUFFER);
+
+			if (!constants || !lights || !grid || !indices)
+				return false;
+
+			memcpy(&draw->clusters.constants, constants, sizeof(draw->clusters.constants));
+			draw->clusters.lights  = (const ClusterLightType*)&lights->data[0];
+			draw->clusters.grid	   = (const unsigned int*)&grid->data[0];
+			draw->clusters.indices = (const unsigned int*)&indices->data[0];
+		}
+	}
+
+	return true;
+}
+
+// Submit shades the vertices of a draw four at a time, instance after instance, and bins its triangles.
+void SoftwareBackendClass::Submit(bool indexed, int count, int instanceCount, int start, int baseVertex, int startInstance)
+{
+	ObjectType		   *vertexShader = FindObject(m_vertexShader, SOFTWARE_OBJECT_SHADER);
+	ObjectType		   *pixelShader	 = FindObject(m_pixelShader, SOFTWARE_OBJECT_SHADER);
+	ObjectType		   *indexBuffer	 = FindObject(m_indexBuffer, SOFTWARE_OBJECT_BUFFER);
+	ObjectType		   *objects		 = 0;
+	ObjectType		   *buffers[RENDER_MAX_BINDINGS];
+	const unsigned int *indices		 = 0;
+	const void		   *frame = 0, *object = 0;
+	DrawType			draw;
+	int					total, vertexCount;
+	float				attributes[ATTRIBUTE_COUNT][4][4];
+
+	PerfStatsClass::CountDraw();
+
+	if (!vertexShader || vertexShader->type != RENDER_STAGE_VERTEX || !pixelShader || pixelShader->type != RENDER_STAGE_PIXEL ||
+		count < 3 || instanceCount <= 0 || start < 0)
+		return;
+
+	if (indexed) {
+		if (!indexBuffer || indexBuffer->type != RENDER_BUFFER_INDEX || (long long)(start + count) * 4 > (long long)indexBuffer->data.size())
+			return;
+
+		indices = (const unsigned int*)&indexBuffer->data[0];
+	}
+
+	// The constant buffers of the vertex shaders, and the world matrices of TextureObjectsVertexShader
+	switch (vertexShader->program) {
+		case SOFTWARE_VS_LIGHT:
+			frame  = GetConstants(0, 0, sizeof(ConstantsType::LightFrameBufferType));
+			object = GetConstants(0, 1, sizeof(ConstantsType::LightObjectBufferType));
+			break;
+
+		case SOFTWARE_VS_TEXTURE:
+			frame  = GetConstants(0, 0, sizeof(ConstantsType::TextureFrameBufferType));
+			object = GetConstants(0, 1, sizeof(ConstantsType::TextureObjectBufferType));
+			break;
+
+		case SOFTWARE_VS_TEXTURE_OBJECTS:
+			frame	= GetConstants(0, 0, sizeof(ConstantsType::TextureFrameBufferType));
+			objects = GetResource(0, 0, SOFTWARE_OBJECT_BUFFER);
+			object	= frame;
+
+			if (!objects || (int)(objects->data.size() / sizeof(ShaderReferenceClass::MatrixType)) < instanceCount)
+				return;
+
+			break;
+
+		default:
+			frame  = GetConstants(0, 0, sizeof(ConstantsType::MatrixBufferType));
+			object = frame;
+			break;
+	}
+
+	if (!frame || !object || !SetupDraw(vertexShader, pixelShader, &draw))
+		return;
+
+	for (int i = 0; i < RENDER_MAX_BINDINGS; i++)
+		buffers[i] = FindObject(m_vertexBuffers[i], SOFTWARE_OBJECT_BUFFER);
+
+	// The tiles cover the target of the batch, a change of the target has drawn the batch before.
+	if (m_triangles.empty()) {
+		m_drawTarget = GetTarget();
+		m_tilesX	 = (m_drawTarget.width	+ SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+		m_tilesY	 = (m_drawTarget.height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+		m_tiles.resize(m_tilesX * m_tilesY);
+	}
+
+	m_draws.push_back(draw);
+
+	vertexCount = count - count % 3;
+	total		= vertexCount * instanceCount;
+
+	if ((int)m_vertices.size() < total + 3)
+		m_vertices.resize(total + 3);
+
+	for (int i = 0; i < total; i += 4) {
+		int vertices[4], instances[4];
+
+		// The last lanes of the last four repeat the last vertex.
+		for (int lane = 0; lane < 4; lane++) {
+			int n = i + lane < total ? i + lane : total - 1;
+			int k = n % vertexCount;
+
+			instances[lane] = n / vertexCount;
+			vertices[lane]	= indexed ? baseVertex + (int)indices[start + k] : start + k;
+		}
+
+		FetchVertices(vertexShader, buffers, vertices, instances, startInstance, attributes);
+		ShadeVertices(vertexShader, frame, object, objects, instances, attributes, &m_vertices[i]);
+	}
+
+	for (int i = 0; i < total; i += 3)
+		AddTriangle(&m_vertices[i], &m_vertices[i + 1], &m_vertices[i + 2], vertexShader->program == SOFTWARE_VS_LIGHT ? 16 : 10, draw.state.cullBack);
+
+	if (m_triangles.size() >= SOFTWARE_MAX_TRIANGLES)
+		Flush();
+
+	return;
+}
+
+// FetchVertices reads the elements of the input layout for four vertices. What the layout doesn't fill is (0, 0, 0, 1),
+// and so is what lies out of its buffer, like the GPU reads it.
+void SoftwareBackendClass::FetchVertices(ObjectType *shader, ObjectType **buffers, const int *vertices, const int *instances, int startInstance,
+										 float attributes[][4][4])
+{
+	for (int a = 0; a < ATTRIBUTE_COUNT; a++)
+		for (int c = 0; c < 4; c++)
+			for (int lane = 0; lane < 4; lane++)
+				attributes[a][c][lane] = c == 3 ? 1.0f : 0.0f;
+
+	for (size_t i = 0; i < shader->elements.size(); i++) {
+		const ElementType &element = shader->elements[i];
+		ObjectType		  *buffer  = buffers[element.slot];
+
+		if (!buffer)
+			continue;
+
+		for (int lane = 0; lane < 4; lane++) {
+			long long index	 = element.perInstance ? startInstance + instances[lane] : vertices[lane];
+			long long offset = m_offsets[element.slot] + index * m_strides[element.slot] + element.offset;
+			float	  values[4];
+
+			if (offset < 0 || offset + element.components * 4 > (long long)buffer->data.size())
+				continue;
+
+			memcpy(values, &buffer->data[(size_t)offset], element.components * 4);
+
+			for (int c = 0; c < element.components; c++)
+				attributes[element.attribute][c][lane] = values[c];
+		}
+	}
+
+	return;
+}
+
+// ShadeVertices runs the vertex shader on four vertices and lays its output out as VertexType:
+// the position, then tex, normal, viewDirection, worldPosition and viewDepth for the light shader, tex and color for the others.
+void SoftwareBackendClass::ShadeVertices(ObjectType *shader, const void *frame, const void *object, const ObjectType *objects, const int *instances,
+										 float attributes[][4][4], VertexType *out)
+{
+	ShaderReferenceClass::TexturePixelType pixel;
+	float								  *values = out->values;
+
+	switch (shader->program) {
+		case SOFTWARE_VS_LIGHT: {
+			ShaderReferenceClass::LightVertexType in;
+			ShaderReferenceClass::LightPixelType  lightPixel;
+
+			in.position = Load3(attributes[ATTRIBUTE_POSITION]);
+			in.tex		= Load2(attributes[ATTRIBUTE_TEXCOORD]);
+			in.normal	= Load3(attributes[ATTRIBUTE_NORMAL]);
+
+			for (int i = 0; i < 4; i++)
+				in.world[i] = Load4(attributes[ATTRIBUTE_WORLD + i]);
+
+			ShaderReferenceClass::LightVertexShader(shader->features, *(const ConstantsType::LightFrameBufferType*)frame,
+													*(const ConstantsType::LightObjectBufferType*)object, in, &lightPixel);
+
+			Store(lightPixel.position, values, 0);
+			Store(lightPixel.tex, values, 4);
+			Store(lightPixel.normal, values, 6);
+			Store(lightPixel.viewDirection, values, 9);
+			Store(lightPixel.worldPosition, values, 12);
+			Store(lightPixel.viewDepth, values, 15);
+
+			return;
+		}
+
+		case SOFTWARE_VS_TEXTURE:
+		case SOFTWARE_VS_TEXTURE_OBJECTS: {
+			ShaderReferenceClass::TextureVertexType in;
+
+			in.position = Load3(attributes[ATTRIBUTE_POSITION]);
+			in.tex		= Load2(attributes[ATTRIBUTE_TEXCOORD]);
+
+			if (shader->program == SOFTWARE_VS_TEXTURE)
+				ShaderReferenceClass::TextureVertexShader(*(const ConstantsType::TextureFrameBufferType*)frame,
+														  *(const ConstantsType::TextureObjectBufferType*)object, in, &pixel);
+			else
+				ShaderReferenceClass::TextureObjectsVertexShader(*(const ConstantsType::TextureFrameBufferType*)frame,
+																 (const ShaderReferenceClass::MatrixType*)&objects->data[0], instances, in, &pixel);
+			break;
+		}
+
+		case SOFTWARE_VS_TEXTURE_INSTANCING: {
+			ShaderReferenceClass::TextureInstanceVertexType in;
+
+			in.position			= Load3(attributes[ATTRIBUTE_POSITION]);
+			in.tex				= Load2(attributes[ATTRIBUTE_TEXCOORD]);
+			in.instancePosition = Load3(attributes[ATTRIBUTE_TEXCOORD + 1]);
+			in.instanceSize		= _mm_loadu_ps(attributes[ATTRIBUTE_TEXCOORD + 2][0]);
+			in.instanceColor	= Load4(attributes[ATTRIBUTE_COLOR]);
+			in.instanceUV		= Load4(attributes[ATTRIBUTE_TEXCOORD + 3]);
+
+			ShaderReferenceClass::TextureInstancingVertexShader(*(const ConstantsType::MatrixBufferType*)frame, in, &pixel);
+			break;
+		}
+
+		default: {
+			ShaderReferenceClass::FontVertexType in;
+
+			in.position = Load3(attributes[ATTRIBUTE_POSITION]);
+			in.tex		= Load2(attributes[ATTRIBUTE_TEXCOORD]);
+			in.color	= Load4(attributes[ATTRIBUTE_COLOR]);
+
+			ShaderReferenceClass::FontVertexShader(*(const ConstantsType::MatrixBufferType*)frame, in, &pixel);
+			break;
+		}
+	}
+
+	Store(pixel.position, values, 0);
+	Store(pixel.tex, values, 4);
+	Store(pixel.color, values, 6);
+
+	return;
+}
+
+// AddTriangle clips a triangle to the near plane (z >= 0 in clip space), which keeps it, cuts it into one or two, or drops it.
+// The other planes need no clipping: the edges are tested in floats far past the screen, and the depth is clipped per pixel.
+void SoftwareBackendClass::AddTriangle(const VertexType *a, const VertexType *b, const VertexType *c, int floats, bool cullBack)
+{
+	const VertexType *in[3] = { a, b, c };
+	const VertexType *triangle[3];
+	VertexType		  polygon[4];
+	int				  count = 0;
+
+	if (a->values[2] >= 0.0f && b->values[2] >= 0.0f && c->values[2] >= 0.0f) {
+		SetupTriangle(in, floats, cullBack);
+		return;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		const VertexType *from = in[i];
+		const VertexType *to   = in[(i + 1) % 3];
+		float			  d0   = from->values[2];
+		float			  d1   = to->values[2];
+
+		if (d0 >= 0.0f)
+			polygon[count++] = *from;
+
+		if ((d0 >= 0.0f) != (d1 >= 0.0f)) {
+			float t = d0 / (d0 - d1);
+
+			for (int k = 0; k < floats; k++)
+				polygon[count].values[k] = from->values[k] + (to->values[k] - from->values[k]) * t;
+
+			count++;
+		}
+	}
+
+	for (int i = 1; i + 1 < count; i++) {
+		triangle[0] = &polygon[0];
+		triangle[1] = &polygon[i];
+		triangle[2] = &polygon[i + 1];
+
+		SetupTriangle(triangle, floats, cullBack);
+	}
+
+	return;
+}
+
+// SetupTriangle puts a triangle on the target with the viewport of d3dClass, snapped to 1/256 of a pixel like the GPU does,
+// culls it, makes its edges and planes and bins it into the tiles it touches.
+void SoftwareBackendClass::SetupTriangle(const VertexType **vertices, int floats, bool cullBack)
+{
+	TriangleType triangle;
+	double		 x[3], y[3], rw[3], A[3], B[3];
+	double		 area, orientation, inverse, minX, minY, maxX, maxY;
+	int			 index;
+
+	for (int i = 0; i < 3; i++) {
+		const float *values = vertices[i]->values;
+
+		rw[i] = 1.0 / values[3];
+		x[i]  = floor((values[0] * rw[i] * 0.5 + 0.5) * m_drawTarget.width * 256.0 + 0.5) / 256.0;
+		y[i]  = floor((0.5 - values[1] * rw[i] * 0.5) * m_drawTarget.height * 256.0 + 0.5) / 256.0;
+	}
+
+	// Clockwise on the screen is the front.
+	area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+
+	if (!(area > 0.0 || (area < 0.0 && !cullBack)))
+		return;
+
+	// The pixels whose centers can be inside
+	minX = min(min(x[0], x[1]), x[2]) - 0.5;
+	minY = min(min(y[0], y[1]), y[2]) - 0.5;
+	maxX = max(max(x[0], x[1]), x[2]) - 0.5;
+	maxY = max(max(y[0], y[1]), y[2]) - 0.5;
+
+	triangle.minX = (int)ceil(max(minX, 0.0));
+	triangle.minY = (int)ceil(max(minY, 0.0));
+	triangle.maxX = (int)floor(min(maxX, m_drawTarget.width  - 1.0));
+	triangle.maxY = (int)floor(min(maxY, m_drawTarget.height - 1.0));
+
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+		return;
+
+	// Edge i is the one across vertex i, positive inside; a back face turns them all around.
+	orientation = area < 0.0 ? -1.0 : 1.0;
+
+	for (int i = 0; i < 3; i++) {
+		int	   a	= (i + 1) % 3;
+		int	   b	= (i + 2) % 3;
+		double sign = orientation;
+
+		if (y[a] > y[b] || (y[a] == y[b] && x[a] > x[b])) {
+			a	 = (i + 2) % 3;
+			b	 = (i + 1) % 3;
+			sign = -sign;
+		}
+
+		triangle.edgeX[i]	 = (float)x[a];
+		triangle.edgeY[i]	 = (float)y[a];
+		triangle.edgeDX[i]	 = (float)(x[b] - x[a]);
+		triangle.edgeDY[i]	 = (float)(y[b] - y[a]);
+		triangle.edgeSign[i] = (float)sign;
+
+		// The steps of the edge along x and y. A left edge grows to the right, a top edge (flat) grows downwards.
+		A[i] = -sign * (y[b] - y[a]);
+		B[i] =	sign * (x[b] - x[a]);
+
+		triangle.topLeft[i] = A[i] > 0.0 || (A[i] == 0.0 && B[i] > 0.0);
+	}
+
+	// The weight of a vertex is its edge over the area, 1 at the vertex and 0 on the edge across it.
+	inverse			 = 1.0 / fabs(area);
+	triangle.originX = (float)x[0];
+	triangle.originY = (float)y[0];
+	triangle.planeCount = floats - 2;
+
+	for (int p = 0; p < triangle.planeCount; p++) {
+		double values[3];
+
+		for (int i = 0; i < 3; i++) {
+			const float *vertex = vertices[i]->values;
+
+			values[i] = p == 0 ? vertex[2] * rw[i] : (p == 1 ? rw[i] : vertex[p + 2] * rw[i]);
+		}
+
+		triangle.planes[p][0] = (float)values[0];
+		triangle.planes[p][1] = (float)((values[0] * A[0] + values[1] * A[1] + values[2] * A[2]) * inverse);
+		triangle.planes[p][2] = (float)((values[0] * B[0] + values[1] * B[1] + values[2] * B[2]) * inverse);
+	}
+
+	triangle.draw = (int)m_draws.size() - 1;
+
+	index = (int)m_triangles.size();
+	m_triangles.push_back(triangle);
+	m_triangleCount++;
+
+	for (int tileY = triangle.minY / SOFTWARE_TILE_SIZE; tileY <= triangle.maxY / SOFTWARE_TILE_SIZE; tileY++)
+		for (int tileX = triangle.minX / SOFTWARE_TILE_SIZE; tileX <= triangle.maxX / SOFTWARE_TILE_SIZE; tileX++)
+			m_tiles[tileY * m_tilesX + tileX].push_back(index);
+
+	return;
+}
+
+SoftwareBackendClass::TargetType SoftwareBackendClass::GetTarget()
+{
+	ObjectType *texture = FindObject(m_target, SOFTWARE_OBJECT_TEXTURE);
+	TargetType	target;
+
+	if (texture) {
+		target.color	= &texture->texels[0];
+		target.depth	= 0;
+		target.width	= texture->width;
+		target.height	= texture->height;
+		target.quantize = texture->format != RENDER_FORMAT_RGBA32F;
+	}
+	else {
+		target.color	= m_color.empty() ? 0 : &m_color[0];
+		target.depth	= m_depth.empty() ? 0 : &m_depth[0];
+		target.width	= m_width;
+		target.height	= m_height;
+		target.quantize = true;
+	}
+
+	return target;
+}
+
+void SoftwareBackendClass::ClearTarget(const float *color, bool clearDepth)
+{
+	TargetType target = GetTarget();
+	float	   value[4];
+
+	_mm_storeu_ps(value, target.quantize ? Quantize(_mm_loadu_ps(color)) : _mm_loadu_ps(color));
+
+	for (int i = 0; i < target.width * target.height; i++)
+		memcpy(target.color + i * 4, value, sizeof(value));
+
+	if (clearDepth && target.depth)
+		for (int i = 0; i < target.width * target.height; i++)
+			target.depth[i] = DEPTH_MAX;
+
+	return;
+}
+
+// Flush draws the binned triangles: the workers and the calling thread take the tiles one by one until all are drawn.
+void SoftwareBackendClass::Flush()
+{
+	if (!m_triangles.empty()) {
+		m_nextTile = 0;
+
+		if (m_threadCount > 1) {
+			{
+				lock_guard<mutex> lock(m_mutex);
+				m_pending = m_threadCount - 1;
+				m_generation++;
+			}
+
+			m_wakeUp.notify_all();
+		}
+
+		DrawTiles(0);
+
+		if (m_threadCount > 1) {
+			unique_lock<mutex> lock(m_mutex);
+
+			while (m_pending > 0)
+				m_finished.wait(lock);
+		}
+
+		for (size_t i = 0; i < m_tiles.size(); i++)
+			m_tiles[i].clear();
+	}
+
+	m_draws.clear();
+	m_triangles.clear();
+	m_batch++;
+
+	return;
+}
+
+void SoftwareBackendClass::DrawTiles(int threadIndex)
+{
+	TraceScopeClass scope("SoftwareBackendClass::DrawTiles");
+
+	while (true) {
+		int tile;
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			tile = m_nextTile++;
+		}
+
+		if (tile >= m_tilesX * m_tilesY)
+			return;
+
+		if (!m_tiles[tile].empty())
+			DrawTile(tile, threadIndex);
+	}
+}
+
+// A plane of the triangle at the pixels of a quad, from the first vertex
+static __m128 Plane(const __m128 *plane, __m128 x, __m128 y)
+{
+	return _mm_add_ps(plane[0], _mm_add_ps(_mm_mul_ps(plane[1], x), _mm_mul_ps(plane[2], y)));
+}
+
+// DrawTile draws the triangles of a tile in the order of their draws, a 2x2 quad of pixels at a time:
+// the edges give the pixels inside, the depth test takes some away before the pixel shader runs on the whole quad,
+// and the pixels it keeps are blended into the target, the quad turned from pixels to channels to blend the four at once.
+void SoftwareBackendClass::DrawTile(int tile, int threadIndex)
+{
+	const vector<int> &triangles = m_tiles[tile];
+	const TargetType  &target	 = m_drawTarget;
+	int				   tileX	 = (tile % m_tilesX) * SOFTWARE_TILE_SIZE;
+	int				   tileY	 = (tile / m_tilesX) * SOFTWARE_TILE_SIZE;
+	int				   quads	 = 0;
+	__m128			   offsetX	 = _mm_setr_ps(0.5f, 1.5f, 0.5f, 1.5f);
+	__m128			   offsetY	 = _mm_setr_ps(0.5f, 0.5f, 1.5f, 1.5f);
+	__m128			   zero		 = _mm_setzero_ps();
+	__m128			   one		 = _mm_set1_ps(1.0f);
+	__m128			   width	 = _mm_set1_ps((float)target.width);
+	__m128			   height	 = _mm_set1_ps((float)target.height);
+
+	for (size_t t = 0; t < triangles.size(); t++) {
+		const TriangleType &triangle = m_triangles[triangles[t]];
+		const DrawType	   &draw	 = m_draws[triangle.draw];
+		__m128				edgeX[3], edgeY[3], edgeDX[3], edgeDY[3], edgeSign[3];
+		__m128				planes[SOFTWARE_VERTEX_FLOATS - 2][3];
+		__m128				originX	   = _mm_set1_ps(triangle.originX);
+		__m128				originY	   = _mm_set1_ps(triangle.originY);
+		bool				depthTest  = target.depth && draw.state.depthTest;
+		bool				depthWrite = depthTest && draw.state.depthWrite;
+		int					x0		   = max(tileX, triangle.minX) & ~1;
+		int					y0		   = max(tileY, triangle.minY) & ~1;
+		int					x1		   = min(tileX + SOFTWARE_TILE_SIZE - 1, triangle.maxX);
+		int					y1		   = min(tileY + SOFTWARE_TILE_SIZE - 1, triangle.maxY);
+
+		for (int e = 0; e < 3; e++) {
+			edgeX[e]	= _mm_set1_ps(triangle.edgeX[e]);
+			edgeY[e]	= _mm_set1_ps(triangle.edgeY[e]);
+			edgeDX[e]	= _mm_set1_ps(triangle.edgeDX[e]);
+			edgeDY[e]	= _mm_set1_ps(triangle.edgeDY[e]);
+			edgeSign[e] = _mm_set1_ps(triangle.edgeSign[e]);
+		}
+
+		for (int p = 0; p < triangle.planeCount; p++)
+			for (int i = 0; i < 3; i++)
+				planes[p][i] = _mm_set1_ps(triangle.planes[p][i]);
+
+		for (int qy = y0; qy <= y1; qy += 2)
+			for (int qx = x0; qx <= x1; qx += 2) {
+				ShaderReferenceClass::Float4Type position, color;
+				__m128							 varyings[SOFTWARE_VERTEX_FLOATS - 4];
+				__m128							 px		= _mm_add_ps(_mm_set1_ps((float)qx), offsetX);
+				__m128							 py		= _mm_add_ps(_mm_set1_ps((float)qy), offsetY);
+				__m128							 inside = _mm_and_ps(_mm_cmplt_ps(px, width), _mm_cmplt_ps(py, height));
+				__m128							 rx, ry, z, w, dest[4];
+				float							 depths[4];
+				unsigned int					 quantized[4] = { 0, 0, 0, 0 };
+				int								 pixels[4]	  = { 0, 0, 0, 0 };
+				int								 mask;
+
+				// The edges take the same steps in the same order for both of their triangles.
+				for (int e = 0; e < 3; e++) {
+					__m128 edge = _mm_mul_ps(edgeSign[e], _mm_sub_ps(_mm_mul_ps(edgeDX[e], _mm_sub_ps(py, edgeY[e])),
+																	 _mm_mul_ps(edgeDY[e], _mm_sub_ps(px, edgeX[e]))));
+
+					inside = _mm_and_ps(inside, triangle.topLeft[e] ? _mm_cmpge_ps(edge, zero) : _mm_cmpgt_ps(edge, zero));
+				}
+
+				if (!_mm_movemask_ps(inside))
+					continue;
+
+				rx = _mm_sub_ps(px, originX);
+				ry = _mm_sub_ps(py, originY);
+				z  = Plane(planes[0], rx, ry);
+
+				inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(z, zero), _mm_cmple_ps(z, one)));
+				mask   = _mm_movemask_ps(inside);
+
+				_mm_storeu_ps(depths, z);
+
+				// Only the lanes inside get their pixel and depth, the others are never read.
+				for (int lane = 0; lane < 4; lane++)
+					if (mask & (1 << lane)) {
+						pixels[lane]	= (qy + (lane >> 1)) * target.width + qx + (lane & 1);
+						quantized[lane] = (unsigned int)(depths[lane] * DEPTH_MAX + 0.5f);
+
+						if (depthTest && !(quantized[lane] < target.depth[pixels[lane]]))
+							mask &= ~(1 << lane);
+					}
+
+				if (!mask)
+					continue;
+
+				w = _mm_div_ps(one, Plane(planes[1], rx, ry));
+
+				for (int k = 0; k < triangle.planeCount - 2; k++)
+					varyings[k] = _mm_mul_ps(Plane(planes[k + 2], rx, ry), w);
+
+				position.x = px;
+				position.y = py;
+				position.z = z;
+				position.w = w;
+
+				mask &= ShadePixels(draw, position, varyings, &color);
+				quads++;
+
+				if (!mask)
+					continue;
+
+				// SRC_ALPHA, INV_SRC_ALPHA for the color, ONE, ZERO for the alpha
+				if (draw.state.alphaBlending) {
+					__m128 inverse = _mm_sub_ps(one, color.w);
+
+					for (int lane = 0; lane < 4; lane++)
+						dest[lane] = mask & (1 << lane) ? _mm_loadu_ps(target.color + pixels[lane] * 4) : zero;
+
+					_MM_TRANSPOSE4_PS(dest[0], dest[1], dest[2], dest[3]);
+
+					color.x = _mm_add_ps(_mm_mul_ps(color.x, color.w), _mm_mul_ps(dest[0], inverse));
+					color.y = _mm_add_ps(_mm_mul_ps(color.y, color.w), _mm_mul_ps(dest[1], inverse));
+					color.z = _mm_add_ps(_mm_mul_ps(color.z, color.w), _mm_mul_ps(dest[2], inverse));
+				}
+
+				if (target.quantize) {
+					color.x = Quantize(color.x);
+					color.y = Quantize(color.y);
+					color.z = Quantize(color.z);
+					color.w = Quantize(color.w);
+				}
+
+				_MM_TRANSPOSE4_PS(color.x, color.y, color.z, color.w);
+
+				dest[0] = color.x;
+				dest[1] = color.y;
+				dest[2] = color.z;
+				dest[3] = color.w;
+
+				for (int lane = 0; lane < 4; lane++)
+					if (mask & (1 << lane)) {
+						_mm_storeu_ps(target.color + pixels[lane] * 4, dest[lane]);
+
+						if (depthWrite)
+							target.depth[pixels[lane]] = quantized[lane];
+					}
+			}
+	}
+
+	m_quadCounts[threadIndex] += quads;
+
+	return;
+}
+
+void SoftwareBackendClass::WorkerThread(int threadIndex)
+{
+	int generation = 0;
+
+	TraceClass::SetThreadName("software tiles");
+
+	while (true) {
+		{
+			unique_lock<mutex> lock(m_mutex);
+
+			while (!m_quit && m_generation == generation)
+				m_wakeUp.wait(lock);
+
+			if (m_quit)
+				return;
+
+			generation = m_generation;
+		}
+
+		DrawTiles(threadIndex);
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_pending--;
+		}
+
+		m_finished.notify_one();
+	}
+}
+
+// ShadePixels runs the pixel shader of a draw on a quad, the outputs of the vertex shader in the order of ShadeVertices.
+// It returns the lanes the shader keeps.
+int SoftwareBackendClass::ShadePixels(const DrawType &draw, const ShaderReferenceClass::Float4Type &position, const __m128 *varyings,
+									  ShaderReferenceClass::Float4Type *color)
+{
+	ShaderReferenceClass::TexturePixelType in;
+
+	if (draw.pixelShader == SOFTWARE_PS_LIGHT) {
+		ShaderReferenceClass::LightPixelType lightIn;
+
+		lightIn.position		= position;
+		lightIn.tex.x			= varyings[0];
+		lightIn.tex.y			= varyings[1];
+		lightIn.normal.x		= varyings[2];
+		lightIn.normal.y		= varyings[3];
+		lightIn.normal.z		= varyings[4];
+		lightIn.viewDirection.x = varyings[5];
+		lightIn.viewDirection.y = varyings[6];
+		lightIn.viewDirection.z = varyings[7];
+		lightIn.worldPosition.x = varyings[8];
+		lightIn.worldPosition.y = varyings[9];
+		lightIn.worldPosition.z = varyings[10];
+		lightIn.viewDepth		= varyings[11];
+
+		return ShaderReferenceClass::LightPixelShader(draw.features, draw.light, draw.texture.texels ? &draw.texture : 0,
+													  draw.clusters.lights ? &draw.clusters : 0, lightIn, color);
+	}
+
+	in.position = position;
+	in.tex.x	= varyings[0];
+	in.tex.y	= varyings[1];
+	in.color.x	= varyings[2];
+	in.color.y	= varyings[3];
+	in.color.z	= varyings[4];
+	in.color.w	= varyings[5];
+
+	switch (draw.pixelShader) {
+		case SOFTWARE_PS_TEXTURE:
+			ShaderReferenceClass::TexturePixelShader(draw.texture, in, color);
+			break;
+
+		case SOFTWARE_PS_TEXTURE_INSTANCING:
+			ShaderReferenceClass::TextureInstancingPixelShader(draw.texture, in, color);
+			break;
+
+		case SOFTWARE_PS_FONT:
+			ShaderReferenceClass::FontPixelShader(draw.texture, in, color);
+			break;
+
+		default:
+			ShaderReferenceClass::FontSdfPixelShader(draw.texture, in, color);
+			break;
+	}
+
+	return 0xF;
+}
@@ -0,0 +1,245 @@
+// --------------------------------------------------------------------------------------------------------
+// SoftwareBackendClass is a RenderBackendClass that draws on the CPU, as a reference for what d3dClass draws
+// and as a benchmark of how the work scales with the cores. It does what d3dClass sets up: a 24 bit depth buffer tested with LESS,
+// the back faces culled (clockwise is the front), SRC_ALPHA/INV_SRC_ALPHA blending into an 8 bit RGBA back buffer,
+// and the bilinear wrap sampler. The shaders are the ShaderReferenceClass twins of the project's shaders,
+// found by their entry points and, for the light shader, the feature bits of the variant; a shader without a twin can't be made.
+//
+// A draw shades its vertices on the calling thread, clips the triangles to the near plane, sets them up
+// and bins them into tiles of SOFTWARE_TILE_SIZE pixels. The tiles are drawn when the target is needed:
+// at EndFrame, at a change of the target, a Clear, or a write to a buffer a binned triangle still has to read.
+// Then every thread takes tiles until there are none left, and draws the triangles of a tile in their order:
+// the 2x2 quads of pixels are tested against the edges with SSE and shaded four pixels at once.
+// The constant buffers of the pixel shaders are copied with the draws, updating them between the draws keeps the tiles binned.
+// A deferred context records into a HeadlessBackendClass stream, which is drawn when the context is executed.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SOFTWAREBACKENDCLASS_H_
+#define _SOFTWAREBACKENDCLASS_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+#include "__renderBackendClass.h"
+#include "__shaderReferenceClass.h"
+
+#define SOFTWARE_TILE_SIZE	   64		// even, so the quads never cross the tiles
+#define SOFTWARE_MAX_TRIANGLES 1048576	// the tiles are drawn when the binned triangles get this many
+
+// The kinds of objects
+#define SOFTWARE_OBJECT_BUFFER	1
+#define SOFTWARE_OBJECT_TEXTURE 2
+#define SOFTWARE_OBJECT_SHADER	3
+#define SOFTWARE_OBJECT_STATE	4
+
+// The vertex shaders with a twin
+#define SOFTWARE_VS_LIGHT			   1
+#define SOFTWARE_VS_TEXTURE			   2
+#define SOFTWARE_VS_TEXTURE_OBJECTS	   3
+#define SOFTWARE_VS_TEXTURE_INSTANCING 4
+#define SOFTWARE_VS_FONT			   5
+
+// The pixel shaders with a twin. TexturePixelShader is the one of _shaderTextureInstancing.ps after its vertex shader.
+#define SOFTWARE_PS_LIGHT			   1
+#define SOFTWARE_PS_TEXTURE			   2
+#define SOFTWARE_PS_TEXTURE_INSTANCING 3
+#define SOFTWARE_PS_FONT			   4
+#define SOFTWARE_PS_FONT_SDF		   5
+
+// A shaded vertex: the clip space position and what the pixel shader gets, 12 floats for the light shader, 6 for the others.
+#define SOFTWARE_VERTEX_FLOATS 16
+
+
+
+class SoftwareBackendClass : public RenderBackendClass {
+ private:
+	typedef ShaderReferenceClass::ConstantsType ConstantsType;
+
+	// An element of an input layout: the vertex attribute it fills and how many floats it has
+	struct ElementType {
+		int	 attribute;
+		int	 components;
+		int	 slot;
+		int	 offset;
+		bool perInstance;
+	};
+
+	struct ObjectType {
+		int					kind;
+		int					type;			// the buffer type or the shader stage
+		int					batch;			// the batch of triangles that last read it
+		bool				dynamic;
+
+		// A buffer
+		vector<unsigned char> data;
+
+		// A texture, RGBA floats like ShaderReferenceClass samples them
+		int					width, height;
+		int					format;
+		bool				renderTarget;
+		vector<float>		texels;
+
+		// A shader
+		int					program;		// SOFTWARE_VS_ or SOFTWARE_PS_
+		unsigned long long	features;
+		vector<ElementType> elements;
+
+		// A state
+		StateDescType		state;
+	};
+
+	// What the tiles need of a draw: its pixel shader and what it reads
+	struct DrawType {
+		int										   pixelShader;
+		unsigned long long						   features;
+		StateDescType							   state;
+		ConstantsType::LightBufferType			   light;
+		ShaderReferenceClass::TextureType		   texture;		// no texels without a texture
+		ShaderReferenceClass::ClusterResourcesType clusters;	// no lights without the clustered lights
+	};
+
+	struct VertexType {
+		float values[SOFTWARE_VERTEX_FLOATS];
+	};
+
+	// A triangle set up for the tiles. An edge is kept from its upper end, the same way for both triangles that share it,
+	// so the two get exactly opposite values along it and the top left rule gives every pixel to one of them.
+	// A plane holds a value at the first vertex and its steps along x and y: the depth, 1/w and every output of the vertex shader over w.
+	struct TriangleType {
+		int	  draw;
+		int	  minX, minY, maxX, maxY;
+		int	  planeCount;
+		float edgeX[3], edgeY[3], edgeDX[3], edgeDY[3], edgeSign[3];
+		bool  topLeft[3];
+		float originX, originY;
+		float planes[SOFTWARE_VERTEX_FLOATS - 2][3];
+	};
+
+	// The target of the batch being drawn; render targets have no depth buffer.
+	struct TargetType {
+		float		 *color;
+		unsigned int *depth;
+		int			  width, height;
+		bool		  quantize;		// an 8 bit format, the colors are rounded as they are written
+	};
+
+ public:
+	SoftwareBackendClass();
+	SoftwareBackendClass(const SoftwareBackendClass &);
+   ~SoftwareBackendClass();
+
+	// Initialize makes the back buffer and starts the threads, 1 draws all the tiles on the calling thread.
+	bool Initialize(int, int, int);
+	void Shutdown();
+
+	int GetWidth();
+	int GetHeight();
+
+	// The back buffer as 8 bit RGBA rows from the top, width * height * 4 bytes; SaveImage writes it as a 32 bit TGA file.
+	void GetPixels(unsigned char *);
+	bool SaveImage(const char *);
+
+	// The counters since the last ResetCounters: the triangles binned and the quads of pixels shaded.
+	int	 GetTriangleCount();
+	int	 GetQuadCount();
+	void ResetCounters();
+
+	// RenderBackendClass
+	HandleType CreateBuffer(const BufferDescType &, const void *);
+	HandleType CreateTexture(const TextureDescType &, const void *, int);
+	HandleType CreateShader(const ShaderDescType &);
+	HandleType CreateState(const StateDescType &);
+	void	   Release(HandleType);
+
+	bool UpdateBuffer(HandleType, const void *, int);
+
+	void BeginFrame(const float *);
+	void EndFrame();
+
+	void SetRenderTarget(HandleType);
+	void Clear(const float *);
+
+	void SetState(HandleType);
+	void SetShaders(HandleType, HandleType);
+	void SetVertexBuffers(int, int, const HandleType *, const unsigned int *, const unsigned int *);
+	void SetIndexBuffer(HandleType);
+	void SetConstantBuffers(int, int, int, const HandleType *);
+	void SetTextures(int, int, int, const HandleType *);
+
+	void Draw(int, int);
+	void DrawIndexed(int, int, int);
+	void DrawInstanced(int, int, int, int);
+	void DrawIndexedInstanced(int, int, int, int, int);
+
+	RenderContextClass* CreateDeferredContext();
+	void				ExecuteDeferredContext(RenderContextClass *);
+	void				ReleaseDeferredContext(RenderContextClass *);
+
+ private:
+	HandleType	NewObject(ObjectType *);
+	ObjectType* FindObject(HandleType, int);
+	const void* GetConstants(int, int, int);
+	ObjectType* GetResource(int, int, int);
+	bool		SetupDraw(ObjectType *, ObjectType *, DrawType *);
+
+	void Submit(bool, int, int, int, int, int);
+	void FetchVertices(ObjectType *, ObjectType **, const int *, const int *, int, float [][4][4]);
+	void ShadeVertices(ObjectType *, const void *, const void *, const ObjectType *, const int *, float [][4][4], VertexType *);
+	void AddTriangle(const VertexType *, const VertexType *, const VertexType *, int, bool);
+	void SetupTriangle(const VertexType **, int, bool);
+
+	TargetType GetTarget();
+	void	   ClearTarget(const float *, bool);
+	void	   Flush();
+	void	   DrawTiles(int);
+	void	   DrawTile(int, int);
+	void	   WorkerThread(int);
+
+	static int ShadePixels(const DrawType &, const ShaderReferenceClass::Float4Type &, const __m128 *, ShaderReferenceClass::Float4Type *);
+
+ private:
+	int						m_width, m_height;
+	vector<float>			m_color;
+	vector<unsigned int>	m_depth;
+
+	vector<ObjectType*>		m_objects;
+	vector<HandleType>		m_freeHandles;
+
+	// The bindings, the constant buffers and textures per stage (vertex, pixel)
+	HandleType				m_target;
+	HandleType				m_state;
+	HandleType				m_vertexShader, m_pixelShader;
+	HandleType				m_vertexBuffers[RENDER_MAX_BINDINGS];
+	unsigned int			m_strides[RENDER_MAX_BINDINGS], m_offsets[RENDER_MAX_BINDINGS];
+	HandleType				m_indexBuffer;
+	HandleType				m_constantBuffers[2][RENDER_MAX_BINDINGS];
+	HandleType				m_textures[2][RENDER_MAX_BINDINGS];
+
+	// The batch being binned: the draws, their triangles and the triangles of every tile
+	int						m_batch;
+	vector<DrawType>		m_draws;
+	vector<VertexType>		m_vertices;
+	vector<TriangleType>	m_triangles;
+	vector<vector<int> >	m_tiles;
+	int						m_tilesX, m_tilesY;
+	TargetType				m_drawTarget;
+	int						m_nextTile;
+
+	int						m_triangleCount;
+	vector<int>				m_quadCounts;		// per thread
+
+	// The workers draw tiles when m_generation changes, and count m_pending down when they are done (like LightClusterClass).
+	int						m_threadCount;
+	vector<thread>			m_workers;
+	mutex					m_mutex;
+	condition_variable		m_wakeUp, m_finished;
+	int						m_generation;
+	int						m_pending;
+	bool					m_quit;
+};
+
+#endif
@@ -0,0 +1,247 @@
+#include "__spriteAnimatorClass.h"
+
+#include <string.h>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+SpriteAnimatorClass::SpriteAnimatorClass()
+{
+	m_maxSprites  = 0;
+	m_capacity	  = 0;
+	m_spriteCount = 0;
+
+	m_phase		 = 0;
+	m_rate		 = 0;
+	m_firstFrame = 0;
+	m_frameCount = 0;
+	m_loop		 = 0;
+	m_frame		 = 0;
+	m_speed		 = 0;
+	m_animation	 = 0;
+}
+
+SpriteAnimatorClass::SpriteAnimatorClass(const SpriteAnimatorClass& other)
+{
+}
+
+SpriteAnimatorClass::~SpriteAnimatorClass()
+{
+}
+
+// Initialize takes the maximum number of sprites and the layout of the sprite sheet, in frames.
+bool SpriteAnimatorClass::Initialize(int maxSprites, int sheetColumns, int sheetRows)
+{
+	float **arrays[] = { &m_phase, &m_rate, &m_firstFrame, &m_frameCount, &m_loop, &m_frame };
+
+	if (maxSprites <= 0 || sheetColumns <= 0 || sheetRows <= 0)
+		return false;
+
+	m_maxSprites   = maxSprites;
+	m_capacity	   = (maxSprites + 3) & ~3;
+	m_spriteCount  = 0;
+	m_sheetColumns = sheetColumns;
+	m_sheetRows	   = sheetRows;
+
+	// The unused lanes at the end are left zeroed: no frames and no rate, so they stay on frame 0.
+	for (size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++) {
+
+		*arrays[i] = (float*)_mm_malloc(sizeof(float) * m_capacity, 16);
+		if (!*arrays[i])
+			return false;
+
+		memset(*arrays[i], 0, sizeof(float) * m_capacity);
+	}
+
+	// These two are only used when a sprite is set up, so they are plain arrays.
+	m_speed = new float[m_capacity];
+	if (!m_speed)
+		return false;
+
+	m_animation = new int[m_capacity];
+	if (!m_animation)
+		return false;
+
+	return true;
+}
+
+void SpriteAnimatorClass::Shutdown()
+{
+	float **arrays[] = { &m_phase, &m_rate, &m_firstFrame, &m_frameCount, &m_loop, &m_frame };
+
+	for (size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++) {
+		if (*arrays[i]) {
+			_mm_free(*arrays[i]);
+			*arrays[i] = 0;
+		}
+	}
+
+	if (m_speed) {
+		delete [] m_speed;
+		m_speed = 0;
+	}
+
+	if (m_animation) {
+		delete [] m_animation;
+		m_animation = 0;
+	}
+
+	m_animations.clear();
+
+	m_maxSprites  = 0;
+	m_capacity	  = 0;
+	m_spriteCount = 0;
+
+	return;
+}
+
+// AddAnimation registers frameCount frames of the sheet starting at firstFrame, counted row by row, and returns the index of the animation.
+int SpriteAnimatorClass::AddAnimation(int firstFrame, int frameCount, float framesPerSecond, bool loop)
+{
+	AnimationType animation;
+
+	animation.firstFrame	  = firstFrame;
+	animation.frameCount	  = frameCount > 0 ? frameCount : 1;
+	animation.framesPerSecond = framesPerSecond;
+	animation.loop			  = loop;
+
+	m_animations.push_back(animation);
+
+	return (int)m_animations.size() - 1;
+}
+
+// AddSprite starts the animation for a new sprite, startTime seconds into it, and returns the index of the sprite.
+// The sprite index is also the index of its texture rectangle in BuildUVArray.
+// The lanes past maxSprites are only padding for the SSE pass, so a sprite is refused once maxSprites are in use.
+int SpriteAnimatorClass::AddSprite(int animation, float startTime)
+{
+	if (m_spriteCount >= m_maxSprites)
+		return -1;
+
+	int sprite = m_spriteCount++;
+
+	m_speed[sprite] = 1.0f;
+	SetSpriteAnimation(sprite, animation);
+
+	// The phase is wrapped (or clamped) into the animation by the next Frame() call
+	m_phase[sprite] = startTime * m_rate[sprite];
+
+	return sprite;
+}
+
+// SetSpriteAnimation switches the sprite to another animation and rewinds it. The speed of the sprite is kept.
+void SpriteAnimatorClass::SetSpriteAnimation(int sprite, int animation)
+{
+	AnimationType &anim = m_animations[animation];
+
+	m_animation[sprite]	 = animation;
+	m_phase[sprite]		 = 0.0f;
+	m_rate[sprite]		 = anim.framesPerSecond * m_speed[sprite];
+	m_firstFrame[sprite] = (float)anim.firstFrame;
+	m_frameCount[sprite] = (float)anim.frameCount;
+	m_loop[sprite]		 = anim.loop ? 1.0f : 0.0f;
+	m_frame[sprite]		 = (float)anim.firstFrame;
+
+	return;
+}
+
+// SetSpriteSpeed scales the playback rate of the sprite, 1.0f being the normal rate of its animation.
+// A negative speed plays the animation backwards: a looping one wraps from its first frame to its last,
+// the others stop on their first frame.
+void SpriteAnimatorClass::SetSpriteSpeed(int sprite, float speed)
+{
+	m_speed[sprite] = speed;
+	m_rate[sprite]	= m_animations[m_animation[sprite]].framesPerSecond * speed;
+
+	return;
+}
+
+int SpriteAnimatorClass::GetSpriteCount()
+{
+	return m_spriteCount;
+}
+
+// Frame advances the phase of every sprite and works out the frame it is on, four sprites at a time.
+// Looping animations wrap around, the others stop on their last frame (or on the first one when played backwards).
+void SpriteAnimatorClass::Frame(float frameTime)
+{
+	__m128 dt	= _mm_set1_ps(frameTime);
+	__m128 one	= _mm_set1_ps(1.0f);
+	__m128 zero = _mm_setzero_ps();
+
+	for (int i = 0; i < m_spriteCount; i += 4) {
+
+		__m128 phase = _mm_load_ps(m_phase + i);
+		__m128 count = _mm_load_ps(m_frameCount + i);
+		__m128 loop	 = _mm_load_ps(m_loop + i);
+
+		phase = _mm_add_ps(phase, _mm_mul_ps(_mm_load_ps(m_rate + i), dt));
+
+		// Looping: phase - count * floor(phase / count). SSE2 only truncates, so one is taken off where the truncation rounded up,
+		// which is the case for the negative phases of the sprites played backwards.
+		// The max() keeps the zeroed padding lanes away from a division by zero.
+		__m128 safeCount = _mm_max_ps(count, one);
+		__m128 quotient	 = _mm_div_ps(phase, safeCount);
+		__m128 laps		 = _mm_cvtepi32_ps(_mm_cvttps_epi32(quotient));
+		laps			 = _mm_sub_ps(laps, _mm_and_ps(_mm_cmpgt_ps(laps, quotient), one));
+		__m128 wrapped	 = _mm_sub_ps(phase, _mm_mul_ps(laps, safeCount));
+
+		// Select by the loop mask
+		__m128 isLoop = _mm_cmpgt_ps(loop, zero);
+		phase = _mm_or_ps(_mm_and_ps(isLoop, wrapped), _mm_andnot_ps(isLoop, phase));
+
+		// Not looping: stay on the first or the last frame. This also keeps a wrapped phase that rounded up to the count inside the animation.
+		phase = _mm_min_ps(_mm_max_ps(phase, zero), _mm_sub_ps(safeCount, _mm_set1_ps(0.001f)));
+
+		_mm_store_ps(m_phase + i, phase);
+
+		// The frame of the sheet is the first frame of the animation plus the whole part of the phase
+		__m128 frame = _mm_add_ps(_mm_load_ps(m_firstFrame + i), _mm_cvtepi32_ps(_mm_cvttps_epi32(phase)));
+		_mm_store_ps(m_frame + i, frame);
+	}
+
+	return;
+}
+
+// BuildUVArray turns the frame of every sprite into its rectangle in the sprite sheet.
+// The row and column are found with float math (the frame numbers are small whole numbers, so this is exact),
+// and the four rectangles of a group are then written out to the destination one by one.
+void SpriteAnimatorClass::BuildUVArray(void *uvRects, int stride)
+{
+	unsigned char *dest = (unsigned char*)uvRects;
+
+	__m128 columns	  = _mm_set1_ps((float)m_sheetColumns);
+	__m128 invColumns = _mm_set1_ps(1.0f / m_sheetColumns);
+	__m128 frameU	  = _mm_set1_ps(1.0f / m_sheetColumns);
+	__m128 frameV	  = _mm_set1_ps(1.0f / m_sheetRows);
+	__m128 half		  = _mm_set1_ps(0.5f);
+
+	float width  = 1.0f / m_sheetColumns;
+	float height = 1.0f / m_sheetRows;
+
+	for (int i = 0; i < m_spriteCount; i += 4) {
+
+		__m128 frame = _mm_load_ps(m_frame + i);
+
+		// row = floor((frame + 0.5) / columns), column = frame - row * columns
+		__m128 row	  = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(_mm_add_ps(frame, half), invColumns)));
+		__m128 column = _mm_sub_ps(frame, _mm_mul_ps(row, columns));
+
+		float u[4], v[4];
+		_mm_storeu_ps(u, _mm_mul_ps(column, frameU));
+		_mm_storeu_ps(v, _mm_mul_ps(row, frameV));
+
+		int lanes = m_spriteCount - i < 4 ? m_spriteCount - i : 4;
+
+		for (int lane = 0; lane < lanes; lane++) {
+
+			float *rect = (float*)(dest + (i + lane) * stride);
+
+			rect[0] = u[lane];
+			rect[1] = v[lane];
+			rect[2] = width;
+			rect[3] = height;
+		}
+	}
+
+	return;
+}
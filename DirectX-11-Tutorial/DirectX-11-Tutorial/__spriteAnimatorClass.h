@@ -0,0 +1,71 @@
+// --------------------------------------------------------------------------------------------------------
+// SpriteAnimatorClass is the animation clock for flipbook sprites drawn with BitmapClass_Instancing.
+// The sprite sheet is a grid of frames, an animation is a run of consecutive frames played at some rate.
+// Every sprite keeps its own playback position, and all of them are advanced together in one SSE pass per frame.
+// The result is a texture rectangle per sprite, which goes into the uvRect of the instance,
+// so thousands of independently animated sprites still share one texture and one draw call.
+//
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SPRITEANIMATORCLASS_H_
+#define _SPRITEANIMATORCLASS_H_
+
+#include <vector>
+using namespace std;
+
+
+
+class SpriteAnimatorClass {
+ private:
+	struct AnimationType {
+		int   firstFrame;
+		int   frameCount;
+		float framesPerSecond;
+		bool  loop;
+	};
+
+ public:
+	SpriteAnimatorClass();
+	SpriteAnimatorClass(const SpriteAnimatorClass &);
+   ~SpriteAnimatorClass();
+
+	bool Initialize(int, int, int);
+	void Shutdown();
+
+	int  AddAnimation(int, int, float, bool);
+	int  AddSprite(int, float);
+	void SetSpriteAnimation(int, int);
+	void SetSpriteSpeed(int, float);
+
+	// Frame advances all the sprites by the given number of seconds.
+	void Frame(float);
+
+	// BuildUVArray writes the texture rectangle (u, v, width, height) of every sprite.
+	// The rectangles are written stride bytes apart, so they can go straight into the uvRect of an instance array.
+	void BuildUVArray(void *, int);
+
+	int  GetSpriteCount();
+
+ private:
+	int  m_maxSprites;
+	int  m_capacity;			// rounded up to a multiple of 4 for the SSE pass
+	int  m_spriteCount;
+
+	int  m_sheetColumns, m_sheetRows;
+
+	// Per sprite data as a structure of arrays. The phase is the playback position in frames.
+	float *m_phase;
+	float *m_rate;				// frames per second times the speed of the sprite
+	float *m_firstFrame;
+	float *m_frameCount;
+	float *m_loop;				// 1.0f for looping animations, 0.0f for the ones that stop on the last frame
+	float *m_frame;				// current frame of the sheet, the result of Frame()
+
+	float *m_speed;
+	int	  *m_animation;
+
+	vector<AnimationType> m_animations;
+};
+
+#endif
@@ -0,0 +1,255 @@
+#include "__spritePassClass.h"
+#include "__traceClass.h"
+
+#include <string.h>
+
+#define QUAD_VERTEX_SIZE (5 * sizeof(float))	// the position and the texture coordinates of VertexType
+
+SpritePassClass::SpritePassClass()
+{
+	m_backend		 = 0;
+	m_quadBuffer	 = 0;
+	m_instanceBuffer = 0;
+	m_matrixBuffer	 = 0;
+	m_vertexShader	 = 0;
+	m_pixelShader	 = 0;
+	m_texture		 = 0;
+	m_state			 = 0;
+	m_maxInstances	 = 0;
+
+	m_instances		= 0;
+	m_instanceCount = 0;
+
+	memset(&m_matrices, 0, sizeof(m_matrices));
+}
+
+SpritePassClass::SpritePassClass(const SpritePassClass& other)
+{
+}
+
+SpritePassClass::~SpritePassClass()
+{
+}
+
+bool SpritePassClass::Initialize(RenderBackendClass *backend, int size, int maxInstances, HandleType vertexShader, HandleType pixelShader,
+								 HandleType texture, HandleType state)
+{
+	RenderBackendClass::BufferDescType bufferDesc;
+
+	if (!backend || maxInstances < 1)
+		return false;
+
+	m_backend	   = backend;
+	m_maxInstances = maxInstances;
+	m_vertexShader = vertexShader;
+	m_pixelShader  = pixelShader;
+	m_texture	   = texture;
+	m_state		   = state;
+
+	m_quadBuffer = CreateQuad(m_backend, size);
+
+	bufferDesc.type	   = RENDER_BUFFER_VERTEX;
+	bufferDesc.size	   = maxInstances * sizeof(InstanceType);
+	bufferDesc.stride  = 0;
+	bufferDesc.dynamic = true;
+	m_instanceBuffer = m_backend->CreateBuffer(bufferDesc, 0);
+
+	bufferDesc.type = RENDER_BUFFER_CONSTANT;
+	bufferDesc.size = sizeof(MatrixBufferType);
+	m_matrixBuffer = m_backend->CreateBuffer(bufferDesc, 0);
+
+	return m_quadBuffer && m_instanceBuffer && m_matrixBuffer;
+}
+
+// The shaders, the texture and the state belong to the caller.
+void SpritePassClass::Shutdown()
+{
+	if (m_backend) {
+		m_backend->Release(m_matrixBuffer);
+		m_backend->Release(m_instanceBuffer);
+		m_backend->Release(m_quadBuffer);
+	}
+
+	m_matrixBuffer	 = 0;
+	m_instanceBuffer = 0;
+	m_quadBuffer	 = 0;
+	m_instances		 = 0;
+	m_instanceCount	 = 0;
+	m_backend		 = 0;
+
+	return;
+}
+
+// The quad is the one of BitmapClass_Instancing::UpdateBuffers around the origin: two triangles, clockwise.
+SpritePassClass::HandleType SpritePassClass::CreateQuad(RenderBackendClass *backend, int size)
+{
+	RenderBackendClass::BufferDescType bufferDesc;
+
+	float half = size * 0.5f;
+	float quad[6][5] = {
+		{ -half,  half, 0.0f, 0.0f, 0.0f },		// Top left
+		{  half, -half, 0.0f, 1.0f, 1.0f },		// Bottom right
+		{ -half, -half, 0.0f, 0.0f, 1.0f },		// Bottom left
+		{ -half,  half, 0.0f, 0.0f, 0.0f },		// Top left
+		{  half,  half, 0.0f, 1.0f, 0.0f },		// Top right
+		{  half, -half, 0.0f, 1.0f, 1.0f },		// Bottom right
+	};
+
+	bufferDesc.type	   = RENDER_BUFFER_VERTEX;
+	bufferDesc.size	   = sizeof(quad);
+	bufferDesc.stride  = 0;
+	bufferDesc.dynamic = false;
+
+	return backend->CreateBuffer(bufferDesc, quad);
+}
+
+int SpritePassClass::GetQuadVertexSize()
+{
+	return QUAD_VERTEX_SIZE;
+}
+
+// The input layout of TextureShaderClass_Instancing: the quad in slot 0, the instances in slot 1.
+bool SpritePassClass::CreateShaders(RenderBackendClass *backend, const void *vertexCode, int vertexSize, const void *pixelCode, int pixelSize,
+									HandleType *vertexShader, HandleType *pixelShader)
+{
+	RenderBackendClass::VertexElementType elements[6] = {
+		{ "POSITION", 0,  6, 0,  0, false },
+		{ "TEXCOORD", 0, 16, 0, 12, false },
+		{ "TEXCOORD", 1,  6, 1,  0, true  },
+		{ "TEXCOORD", 2, 41, 1, 12, true  },
+		{ "COLOR",	  0,  2, 1, 16, true  },
+		{ "TEXCOORD", 3,  2, 1, 32, true  },
+	};
+
+	RenderBackendClass::ShaderDescType shaderDesc;
+
+	memset(&shaderDesc, 0, sizeof(shaderDesc));
+	shaderDesc.stage		= RENDER_STAGE_VERTEX;
+	shaderDesc.entry		= "TextureVertexShader";
+	shaderDesc.code			= vertexCode;
+	shaderDesc.size			= vertexSize;
+	shaderDesc.elements		= elements;
+	shaderDesc.elementCount = 6;
+	*vertexShader = backend->CreateShader(shaderDesc);
+
+	memset(&shaderDesc, 0, sizeof(shaderDesc));
+	shaderDesc.stage = RENDER_STAGE_PIXEL;
+	shaderDesc.entry = "TexturePixelShader";
+	shaderDesc.code	 = pixelCode;
+	shaderDesc.size	 = pixelSize;
+	*pixelShader = backend->CreateShader(shaderDesc);
+
+	return *vertexShader && *pixelShader;
+}
+
+void SpritePassClass::SetInstances(const InstanceType *instances, int count)
+{
+	m_instances		= instances;
+	m_instanceCount = count < m_maxInstances ? count : m_maxInstances;
+
+	return;
+}
+
+void SpritePassClass::SetMatrices(const MatrixBufferType &matrices)
+{
+	m_matrices = matrices;
+
+	return;
+}
+
+int SpritePassClass::GetInstanceCount()
+{
+	return m_instanceCount;
+}
+
+SpritePassClass::HandleType SpritePassClass::GetTexture()
+{
+	return m_texture;
+}
+
+bool SpritePassClass::Render(RenderContextClass *context)
+{
+	TraceScopeClass scope("SpritePassClass::Render");
+
+	HandleType	 vertexBuffers[2] = { m_quadBuffer, m_instanceBuffer };
+	unsigned int strides[2]		  = { QUAD_VERTEX_SIZE, sizeof(InstanceType) };
+	unsigned int offsets[2]		  = { 0, 0 };
+
+	if (m_instanceCount < 1)
+		return true;
+
+	if (!Upload(context))
+		return false;
+
+	if (!context->UpdateBuffer(m_matrixBuffer, &m_matrices, sizeof(m_matrices)))
+		return false;
+
+	context->SetRenderTarget(0);
+	context->SetState(m_state);
+	context->SetShaders(m_vertexShader, m_pixelShader);
+	context->SetVertexBuffers(0, 2, vertexBuffers, strides, offsets);
+	context->SetConstantBuffers(RENDER_STAGE_VERTEX, 0, 1, &m_matrixBuffer);
+	context->SetTextures(RENDER_STAGE_PIXEL, 0, 1, &m_texture);
+	context->DrawInstanced(6, m_instanceCount, 0, 0);
+
+	return true;
+}
+
+// The passes record nothing else, a failed upload leaves the draw out as Render does.
+void SpritePassClass::RecordPass(RenderContextClass *context, void *data)
+{
+	((SpritePassClass*)data)->Render(context);
+
+	return;
+}
+
+bool SpritePassClass::Upload(RenderContextClass *context)
+{
+	if (m_instanceCount < 1)
+		return true;
+
+	return context->UpdateBuffer(m_instanceBuffer, m_instances, m_instanceCount * sizeof(InstanceType));
+}
+
+// The draw binds what Render binds; the queue writes the matrices into the constant buffer before it.
+void SpritePassClass::AddDraw(DrawQueueClass *queue, unsigned long long key)
+{
+	DrawQueueClass::DrawType draw;
+
+	if (m_instanceCount < 1)
+		return;
+
+	memset(&draw, 0, sizeof(draw));
+	draw.state				   = m_state;
+	draw.vertexShader		   = m_vertexShader;
+	draw.pixelShader		   = m_pixelShader;
+	draw.vertexBufferCount	   = 2;
+	draw.vertexBuffers[0]	   = m_quadBuffer;
+	draw.vertexBuffers[1]	   = m_instanceBuffer;
+	draw.strides[0]			   = QUAD_VERTEX_SIZE;
+	draw.strides[1]			   = sizeof(InstanceType);
+	draw.constantBuffers[0][0] = m_matrixBuffer;
+	draw.textures[0]		   = m_texture;
+	draw.constantBuffer		   = m_matrixBuffer;
+	draw.count				   = 6;
+	draw.instanceCount		   = m_instanceCount;
+
+	queue->AddDraw(key, draw, &m_matrices, sizeof(m_matrices));
+
+	return;
+}
+
+void SpritePassClass::RecordLayer(RenderContextClass *context, void *data)
+{
+	TraceScopeClass scope("SpritePassClass::RecordLayer");
+
+	LayerType *layer = (LayerType*)data;
+
+	for (size_t i = 0; i < layer->passes.size(); i++)
+		if (!layer->passes[i]->Upload(context))
+			return;
+
+	layer->queue.Submit(context);
+
+	return;
+}
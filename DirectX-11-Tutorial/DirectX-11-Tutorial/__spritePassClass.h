@@ -0,0 +1,93 @@
+// --------------------------------------------------------------------------------------------------------
+// SpritePassClass draws a batch of instanced sprites through a RenderContextClass: the quad of BitmapClass_Instancing,
+// the instances of TextureShaderClass_Instancing (the ones ParticleSystemClass and SpriteAnimatorClass write)
+// and the shaders of _shaderTextureInstancing.vs/ps, in one instanced draw.
+// GraphicsClass draws its particles, its instanced bitmap and its animated sprites with it in layers recorded through PassRecorderClass,
+// HeadlessRunnerClass draws its particles with it on its backends.
+//
+// SetInstances and SetMatrices give the pass what to draw, Render records it: the upload of the instances and of the matrices,
+// the bindings, the target included, and the draw. The instances are only read then, so they have to stay until it records.
+// A layer records the passes through a DrawQueueClass instead: AddDraw queues the draw of a pass with its matrices as the constants,
+// the layer uploads the instances of its passes into the context, then submits its queue, sorted.
+// The shaders, the texture and the state are made by the caller, the passes that draw the same way share them.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _SPRITEPASSCLASS_H_
+#define _SPRITEPASSCLASS_H_
+
+#include "__renderBackendClass.h"
+#include "__drawQueueClass.h"
+#include "__particleSystemClass.h"
+#include "__shaderReferenceClass.h"
+
+
+
+class SpritePassClass {
+ public:
+	typedef RenderBackendClass::HandleType						  HandleType;
+	typedef ParticleSystemClass::InstanceType					  InstanceType;
+	typedef ShaderReferenceClass::ConstantsType::MatrixBufferType MatrixBufferType;
+
+	// The passes of a layer and the queue their draws were added to. The instances of a dynamic buffer are lost
+	// from a deferred context to the next, so a layer uploads them in the context it submits its draws in.
+	struct LayerType {
+		DrawQueueClass			 queue;
+		vector<SpritePassClass*> passes;
+	};
+
+ public:
+	SpritePassClass();
+	SpritePassClass(const SpritePassClass &);
+   ~SpritePassClass();
+
+	// Initialize takes the backend, the size of the quad in pixels, the most instances, the shaders, the texture and the state.
+	// The quad is centered on the origin, the instances place it.
+	bool Initialize(RenderBackendClass *, int, int, HandleType, HandleType, HandleType, HandleType);
+	void Shutdown();
+
+	// CreateShaders makes the two shaders from their bytecode, with the input layout of the quad and the instances.
+	// A backend that knows the shaders by their entry points gets no code.
+	static bool CreateShaders(RenderBackendClass *, const void *, int, const void *, int, HandleType *, HandleType *);
+
+	// CreateQuad makes the vertex buffer of the quad of a size, the one the passes draw their instances with.
+	// TilemapClass draws its tiles with the same shaders as instances of a quad of the tile size.
+	static HandleType CreateQuad(RenderBackendClass *, int);
+	static int		  GetQuadVertexSize();
+
+	// The instances past the most the pass was made for are not drawn.
+	// The matrices are written into the constant buffer as they are, transposed like the shader classes write them.
+	void SetInstances(const InstanceType *, int);
+	void SetMatrices(const MatrixBufferType &);
+	int	 GetInstanceCount();
+
+	// The texture the pass was made with, for the keys of its draws.
+	HandleType GetTexture();
+
+	// Render records nothing without instances. It returns false when an upload fails, the draw is left out then.
+	bool Render(RenderContextClass *);
+
+	// RecordPass is the pass function of PassRecorderClass, the data is the SpritePassClass. It renders the pass into the context.
+	static void RecordPass(RenderContextClass *, void *);
+
+	// Upload writes the instances into the instance buffer. AddDraw adds the draw of the instances to the queue under the key,
+	// nothing without instances.
+	bool Upload(RenderContextClass *);
+	void AddDraw(DrawQueueClass *, unsigned long long);
+
+	// RecordLayer is the pass function of a LayerType: the uploads of its passes, then the sorted draws of its queue.
+	// A failed upload leaves the draws of the layer out.
+	static void RecordLayer(RenderContextClass *, void *);
+
+ private:
+	RenderBackendClass	 *m_backend;
+	HandleType			  m_quadBuffer, m_instanceBuffer, m_matrixBuffer;
+	HandleType			  m_vertexShader, m_pixelShader, m_texture, m_state;
+	int					  m_maxInstances;
+
+	const InstanceType	 *m_instances;
+	int					  m_instanceCount;
+	MatrixBufferType	  m_matrices;
+};
+
+#endif
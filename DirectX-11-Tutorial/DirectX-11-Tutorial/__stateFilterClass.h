@@ -0,0 +1,463 @@
+// --------------------------------------------------------------------------------------------------------
+// StateFilterClass sits in front of a device context and drops the state changes that set what is already bound:
+// the shaders, the input layout, the topology, the vertex and index buffers, the constant buffers, the shader resource views
+// and the samplers of the vertex and pixel shaders, and the blend, depth stencil and rasterizer states.
+// A call that changes only some of its slots is forwarded for these slots only.
+// It counts the calls it forwarded and the calls it dropped.
+//
+// The filter only knows what went through it, so every state change of the context has to go through it too;
+// Invalidate forgets everything, after ClearState or after the context was used behind its back.
+// Binding a render target unbinds its texture from the shader inputs, so the views are forgotten by InvalidateResources then.
+//
+// The context is a template parameter and the methods take the argument types of the context they forward to,
+// so the filter is used with ID3D11DeviceContext by FilteredContextClass and can be checked with a recording mock on any platform.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _STATEFILTERCLASS_H_
+#define _STATEFILTERCLASS_H_
+
+// The slots that are tracked, calls outside of them are always forwarded
+#define STATE_FILTER_VERTEX_BUFFERS	  4
+#define STATE_FILTER_CONSTANT_BUFFERS 4
+#define STATE_FILTER_RESOURCES		  8
+#define STATE_FILTER_SAMPLERS		  4
+
+
+
+template <class Context>
+class StateFilterClass {
+ public:
+	StateFilterClass()
+	{
+		m_context = 0;
+
+		Invalidate();
+		ResetCounters();
+	}
+
+	StateFilterClass(const StateFilterClass &other)
+	{
+	}
+
+   ~StateFilterClass()
+	{
+	}
+
+	void SetContext(Context *context)
+	{
+		m_context = context;
+
+		Invalidate();
+
+		return;
+	}
+
+	// After Invalidate every slot is unknown, the next call for it is forwarded whatever it sets.
+	void Invalidate()
+	{
+		m_inputLayout  = Unknown();
+		m_topology	   = -1;
+		m_indexBuffer  = Unknown();
+		m_indexFormat  = -1;
+		m_indexOffset  = 0;
+		m_vertexShader = Unknown();
+		m_pixelShader  = Unknown();
+		m_blendState   = Unknown();
+		m_depthState   = Unknown();
+		m_rasterState  = Unknown();
+		m_blendMask	   = 0;
+		m_stencilRef   = 0;
+
+		for (int i = 0; i < 4; i++)
+			m_blendFactor[i] = 0.0f;
+
+		for (int i = 0; i < STATE_FILTER_VERTEX_BUFFERS; i++) {
+			m_vertexBuffers[i] = Unknown();
+			m_vertexStrides[i] = 0;
+			m_vertexOffsets[i] = 0;
+		}
+
+		for (int i = 0; i < STATE_FILTER_CONSTANT_BUFFERS; i++) {
+			m_vsConstantBuffers[i] = Unknown();
+			m_psConstantBuffers[i] = Unknown();
+		}
+
+		for (int i = 0; i < STATE_FILTER_SAMPLERS; i++) {
+			m_vsSamplers[i] = Unknown();
+			m_psSamplers[i] = Unknown();
+		}
+
+		InvalidateResources();
+
+		return;
+	}
+
+	void InvalidateResources()
+	{
+		for (int i = 0; i < STATE_FILTER_RESOURCES; i++) {
+			m_vsResources[i] = Unknown();
+			m_psResources[i] = Unknown();
+		}
+
+		return;
+	}
+
+	int GetForwardedCount()
+	{
+		return m_forwarded;
+	}
+
+	int GetFilteredCount()
+	{
+		return m_filtered;
+	}
+
+	void ResetCounters()
+	{
+		m_forwarded = 0;
+		m_filtered	= 0;
+
+		return;
+	}
+
+	template <class Layout>
+	void IASetInputLayout(Layout *layout)
+	{
+		if (Same(&m_inputLayout, layout))
+			return;
+
+		m_context->IASetInputLayout(layout);
+
+		return;
+	}
+
+	template <class Topology>
+	void IASetPrimitiveTopology(Topology topology)
+	{
+		if (Same(&m_topology, (int)topology))
+			return;
+
+		m_context->IASetPrimitiveTopology(topology);
+
+		return;
+	}
+
+	template <class Buffer>
+	void IASetVertexBuffers(unsigned int start, unsigned int count, Buffer *const *buffers, const unsigned int *strides, const unsigned int *offsets)
+	{
+		unsigned int first, last;
+
+		if (start + count > STATE_FILTER_VERTEX_BUFFERS) {
+			for (unsigned int i = start; i < start + count && i < STATE_FILTER_VERTEX_BUFFERS; i++)
+				m_vertexBuffers[i] = Unknown();
+
+			Forward();
+			m_context->IASetVertexBuffers(start, count, buffers, strides, offsets);
+			return;
+		}
+
+		// The smallest range of slots that changes
+		for (first = 0; first < count && m_vertexBuffers[start + first] == buffers[first] &&
+			 m_vertexStrides[start + first] == strides[first] && m_vertexOffsets[start + first] == offsets[first]; first++);
+
+		if (first == count) {
+			m_filtered++;
+			return;
+		}
+
+		for (last = count; m_vertexBuffers[start + last - 1] == buffers[last - 1] &&
+			 m_vertexStrides[start + last - 1] == strides[last - 1] && m_vertexOffsets[start + last - 1] == offsets[last - 1]; last--);
+
+		for (unsigned int i = first; i < last; i++) {
+			m_vertexBuffers[start + i] = buffers[i];
+			m_vertexStrides[start + i] = strides[i];
+			m_vertexOffsets[start + i] = offsets[i];
+		}
+
+		Forward();
+		m_context->IASetVertexBuffers(start + first, last - first, buffers + first, strides + first, offsets + first);
+
+		return;
+	}
+
+	template <class Buffer, class Format>
+	void IASetIndexBuffer(Buffer *buffer, Format format, unsigned int offset)
+	{
+		if (m_indexBuffer == buffer && m_indexFormat == (int)format && m_indexOffset == offset) {
+			m_filtered++;
+			return;
+		}
+
+		m_indexBuffer = buffer;
+		m_indexFormat = (int)format;
+		m_indexOffset = offset;
+
+		Forward();
+		m_context->IASetIndexBuffer(buffer, format, offset);
+
+		return;
+	}
+
+	// The shaders with class instances are always forwarded, and make the slot unknown.
+	template <class Shader, class Instance>
+	void VSSetShader(Shader *shader, Instance *const *instances, unsigned int instanceCount)
+	{
+		if (instanceCount) {
+			m_vertexShader = Unknown();
+			Forward();
+		}
+		else if (Same(&m_vertexShader, shader))
+			return;
+
+		m_context->VSSetShader(shader, instances, instanceCount);
+
+		return;
+	}
+
+	template <class Shader, class Instance>
+	void PSSetShader(Shader *shader, Instance *const *instances, unsigned int instanceCount)
+	{
+		if (instanceCount) {
+			m_pixelShader = Unknown();
+			Forward();
+		}
+		else if (Same(&m_pixelShader, shader))
+			return;
+
+		m_context->PSSetShader(shader, instances, instanceCount);
+
+		return;
+	}
+
+	template <class Buffer>
+	void VSSetConstantBuffers(unsigned int start, unsigned int count, Buffer *const *buffers)
+	{
+		unsigned int first, last;
+
+		if (Slots(m_vsConstantBuffers, STATE_FILTER_CONSTANT_BUFFERS, start, count, buffers, &first, &last))
+			m_context->VSSetConstantBuffers(first, last - first, buffers + (first - start));
+
+		return;
+	}
+
+	template <class Buffer>
+	void PSSetConstantBuffers(unsigned int start, unsigned int count, Buffer *const *buffers)
+	{
+		unsigned int first, last;
+
+		if (Slots(m_psConstantBuffers, STATE_FILTER_CONSTANT_BUFFERS, start, count, buffers, &first, &last))
+			m_context->PSSetConstantBuffers(first, last - first, buffers + (first - start));
+
+		return;
+	}
+
+	template <class View>
+	void VSSetShaderResources(unsigned int start, unsigned int count, View *const *views)
+	{
+		unsigned int first, last;
+
+		if (Slots(m_vsResources, STATE_FILTER_RESOURCES, start, count, views, &first, &last))
+			m_context->VSSetShaderResources(first, last - first, views + (first - start));
+
+		return;
+	}
+
+	template <class View>
+	void PSSetShaderResources(unsigned int start, unsigned int count, View *const *views)
+	{
+		unsigned int first, last;
+
+		if (Slots(m_psResources, STATE_FILTER_RESOURCES, start, count, views, &first, &last))
+			m_context->PSSetShaderResources(first, last - first, views + (first - start));
+
+		return;
+	}
+
+	template <class Sampler>
+	void VSSetSamplers(unsigned int start, unsigned int count, Sampler *const *samplers)
+	{
+		unsigned int first, last;
+
+		if (Slots(m_vsSamplers, STATE_FILTER_SAMPLERS, start, count, samplers, &first, &last))
+			m_context->VSSetSamplers(first, last - first, samplers + (first - start));
+
+		return;
+	}
+
+	template <class Sampler>
+	void PSSetSamplers(unsigned int start, unsigned int count, Sampler *const *samplers)
+	{
+		unsigned int first, last;
+
+		if (Slots(m_psSamplers, STATE_FILTER_SAMPLERS, start, count, samplers, &first, &last))
+			m_context->PSSetSamplers(first, last - first, samplers + (first - start));
+
+		return;
+	}
+
+	// A null blend factor is the same as a factor of 1.
+	template <class State, class Float>
+	void OMSetBlendState(State *state, const Float *factor, unsigned int mask)
+	{
+		float values[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+		if (factor)
+			for (int i = 0; i < 4; i++)
+				values[i] = (float)factor[i];
+
+		if (m_blendState == state && m_blendMask == mask &&
+			m_blendFactor[0] == values[0] && m_blendFactor[1] == values[1] && m_blendFactor[2] == values[2] && m_blendFactor[3] == values[3]) {
+			m_filtered++;
+			return;
+		}
+
+		m_blendState = state;
+		m_blendMask	 = mask;
+
+		for (int i = 0; i < 4; i++)
+			m_blendFactor[i] = values[i];
+
+		Forward();
+		m_context->OMSetBlendState(state, factor, mask);
+
+		return;
+	}
+
+	template <class State>
+	void OMSetDepthStencilState(State *state, unsigned int stencilRef)
+	{
+		if (m_depthState == state && m_stencilRef == stencilRef) {
+			m_filtered++;
+			return;
+		}
+
+		m_depthState = state;
+		m_stencilRef = stencilRef;
+
+		Forward();
+		m_context->OMSetDepthStencilState(state, stencilRef);
+
+		return;
+	}
+
+	template <class State>
+	void RSSetState(State *state)
+	{
+		if (Same(&m_rasterState, state))
+			return;
+
+		m_context->RSSetState(state);
+
+		return;
+	}
+
+ private:
+	// A slot that may hold anything: no object has this address.
+	static const void* Unknown()
+	{
+		static const char marker = 0;
+
+		return &marker;
+	}
+
+	void Forward()
+	{
+		m_forwarded++;
+
+		return;
+	}
+
+	// Same compares a single slot with the new value, counts the call and takes the value when it differs.
+	bool Same(const void **slot, const void *value)
+	{
+		if (*slot == value) {
+			m_filtered++;
+			return true;
+		}
+
+		*slot = value;
+		Forward();
+
+		return false;
+	}
+
+	bool Same(int *slot, int value)
+	{
+		if (*slot == value) {
+			m_filtered++;
+			return true;
+		}
+
+		*slot = value;
+		Forward();
+
+		return false;
+	}
+
+	// Slots compares the slots of an array call with the cache. It returns false when nothing changes,
+	// otherwise it gives the range [first, last) of the slots to forward, in slot numbers.
+	template <class Object>
+	bool Slots(const void **cache, unsigned int size, unsigned int start, unsigned int count, Object *const *objects, unsigned int *first, unsigned int *last)
+	{
+		unsigned int begin, end;
+
+		if (start + count > size) {
+			for (unsigned int i = start; i < size; i++)
+				cache[i] = Unknown();
+
+			*first = start;
+			*last  = start + count;
+
+			Forward();
+			return true;
+		}
+
+		for (begin = 0; begin < count && cache[start + begin] == objects[begin]; begin++);
+
+		if (begin == count) {
+			m_filtered++;
+			return false;
+		}
+
+		for (end = count; cache[start + end - 1] == objects[end - 1]; end--);
+
+		for (unsigned int i = begin; i < end; i++)
+			cache[start + i] = objects[i];
+
+		*first = start + begin;
+		*last  = start + end;
+
+		Forward();
+
+		return true;
+	}
+
+ private:
+	Context		*m_context;
+
+	const void	*m_inputLayout;
+	int			 m_topology;
+	const void	*m_vertexBuffers[STATE_FILTER_VERTEX_BUFFERS];
+	unsigned int m_vertexStrides[STATE_FILTER_VERTEX_BUFFERS];
+	unsigned int m_vertexOffsets[STATE_FILTER_VERTEX_BUFFERS];
+	const void	*m_indexBuffer;
+	int			 m_indexFormat;
+	unsigned int m_indexOffset;
+
+	const void	*m_vertexShader, *m_pixelShader;
+	const void	*m_vsConstantBuffers[STATE_FILTER_CONSTANT_BUFFERS], *m_psConstantBuffers[STATE_FILTER_CONSTANT_BUFFERS];
+	const void	*m_vsResources[STATE_FILTER_RESOURCES], *m_psResources[STATE_FILTER_RESOURCES];
+	const void	*m_vsSamplers[STATE_FILTER_SAMPLERS], *m_psSamplers[STATE_FILTER_SAMPLERS];
+
+	const void	*m_blendState;
+	float		 m_blendFactor[4];
+	unsigned int m_blendMask;
+	const void	*m_depthState;
+	unsigned int m_stencilRef;
+	const void	*m_rasterState;
+
+	int			 m_forwarded, m_filtered;
+};
+
+#endif
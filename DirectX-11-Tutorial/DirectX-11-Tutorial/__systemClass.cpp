@@ -9,6 +9,15 @@ SystemClass::SystemClass()
 	m_Fps   = 0;
 	m_Cpu   = 0;
 	m_Timer = 0;
+
+	m_hudKeyDown = false;
+
+	m_traceKeyDown	  = false;
+	m_traceFramesLeft = 0;
+
+	m_fixedStep	 = 0.0f;
+	m_frameLimit = 0;
+	m_frameCount = 0;
 }
 
 SystemClass::SystemClass(const SystemClass& other)
@@ -19,6 +28,17 @@ SystemClass::~SystemClass()
 {
 }
 
+void SystemClass::SetFixedStep(float step, int frames)
+{
+	m_fixedStep	 = step;
+	m_frameLimit = frames;
+}
+
+void SystemClass::SetTrace(int frames)
+{
+	m_traceFramesLeft = frames;
+}
+
 bool SystemClass::Initialize()
 {
 	bool result;
@@ -28,6 +48,8 @@ bool SystemClass::Initialize()
 	screenWidth  = 0;
 	screenHeight = 0;
 
+	TraceClass::SetThreadName("main");
+
 	// Initialize the windows api.
 	InitializeWindows(screenWidth, screenHeight);
 
@@ -82,6 +104,8 @@ bool SystemClass::Initialize()
 		return false;
 	}
 
+	m_Timer->SetFixedStep(m_fixedStep);
+
 	return true;
 }
 
@@ -156,11 +180,22 @@ void SystemClass::Run()
 		}
 		else {
 
+			// A trace starts between the frames
+			if (m_traceFramesLeft > 0 && !TraceClass::IsEnabled())
+				TraceClass::Start();
+
 			// Otherwise do the frame processing
 			result = Frame();
 			if (!result)
 				done = true;
 
+			if (m_traceFramesLeft > 0 && --m_traceFramesLeft == 0)
+				EndTrace();
+
+			// A fixed run stops after its frames
+			if (m_frameLimit > 0 && ++m_frameCount >= m_frameLimit)
+				done = true;
+
 		}
 
 		// The check for the escape key in the Run function is now done slightly different by checking the return value of the helper function in the InputClass.
@@ -169,11 +204,29 @@ void SystemClass::Run()
 			done = true;
 	}
 
+	// A trace cut short by the end of the program is written all the same
+	if (TraceClass::IsEnabled())
+		EndTrace();
+
+	return;
+}
+
+// The GPU times of the frames in flight are read before the trace stops
+void SystemClass::EndTrace()
+{
+	m_traceFramesLeft = 0;
+
+	m_Graphics->GetGpuTimer()->Flush();
+	TraceClass::Stop();
+	TraceClass::Export("trace.json");
+
 	return;
 }
 
 bool SystemClass::Frame()
 {
+	TraceScopeClass scope("SystemClass::Frame");
+
 	bool result;
 	int  mouseX, mouseY, mouseZ;
 
@@ -182,14 +235,37 @@ bool SystemClass::Frame()
 	m_Fps->Frame();
 	m_Cpu->Frame();
 
+	// The performance HUD takes the time of the frame that just ended, the counters start over for this one
+	m_Graphics->GetPerfHud()->EndFrame(m_Timer->GetTime());
+
 	// During the Frame function we call the DirectInput object's own Frame function to update the states of the keyboard and mouse.
 	// This call can fail so we need to check the return value.
 
 	// Do the input frame processing
+	m_Graphics->GetPerfHud()->Begin(PERF_INPUT);
+
 	result = m_Input->Frame();
 	if (!result)
 		return false;
 
+	m_Graphics->GetPerfHud()->End(PERF_INPUT);
+
+	// Toggle the performance HUD when F1 goes down
+	if (m_Input->IsKeyPressed(DIK_F1) != m_hudKeyDown) {
+		m_hudKeyDown = !m_hudKeyDown;
+
+		if (m_hudKeyDown)
+			m_Graphics->GetPerfHud()->Toggle();
+	}
+
+	// Trace the next frames when F2 goes down, unless a trace is running
+	if (m_Input->IsKeyPressed(DIK_F2) != m_traceKeyDown) {
+		m_traceKeyDown = !m_traceKeyDown;
+
+		if (m_traceKeyDown && !m_traceFramesLeft)
+			m_traceFramesLeft = TRACE_CAPTURE_FRAMES;
+	}
+
 	// After the input device updates have been read we update the GraphicsClass with the location of the mouse so it can render that in text on the screen.
 	// Get the location of the mouse from the input object,
 	m_Input->GetMouseLocation(mouseX, mouseY, mouseZ);
@@ -10,6 +10,9 @@
 #include "__fpsClass.h"
 #include "__cpuClass.h"
 #include "__highPrecTimer.h"
+#include "__traceClass.h"
+
+#define TRACE_CAPTURE_FRAMES 120		// the frames F2 traces
 
 
 
@@ -19,6 +22,13 @@ class SystemClass {
 	SystemClass(const SystemClass&);
 	~SystemClass();
 
+	// SetFixedStep, before Initialize, animates every frame by the same step in milliseconds and quits after the count of frames (0 runs on),
+	// for runs that can be compared with each other.
+	void SetFixedStep(float, int);
+
+	// SetTrace traces the first frames, the count of them, and writes the trace to trace.json.
+	void SetTrace(int);
+
 	bool Initialize();
 	void Shutdown();
 	void Run();
@@ -29,6 +39,7 @@ class SystemClass {
 	bool Frame();
 	void InitializeWindows(int&, int&);
 	void ShutdownWindows();
+	void EndTrace();
 
  private:
 	LPCWSTR	  m_applicationName;
@@ -42,6 +53,16 @@ class SystemClass {
 	FpsClass			*m_Fps;
 	CpuClass			*m_Cpu;
 	HighPrecisionTimer	*m_Timer;
+
+	// F1 shows and hides the performance HUD, the key has to be released before it toggles again
+	bool				 m_hudKeyDown;
+
+	// F2 traces the next TRACE_CAPTURE_FRAMES frames into trace.json
+	bool				 m_traceKeyDown;
+	int					 m_traceFramesLeft;
+
+	float				 m_fixedStep;
+	int					 m_frameLimit, m_frameCount;
 };
 
 static LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
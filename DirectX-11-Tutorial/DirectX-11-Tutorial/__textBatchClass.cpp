@@ -0,0 +1,334 @@
+#include "__textBatchClass.h"
+
+#include <string.h>
+
+TextBatchClass::TextBatchClass()
+{
+	m_metrics		   = 0;
+	m_screenWidth	   = 0;
+	m_screenHeight	   = 0;
+	m_maxInstanceCount = 0;
+	m_instanceCount	   = 0;
+	m_dirty			   = false;
+
+	m_version		 = 0;
+	m_uploadCount	 = 0;
+	m_uploadsAvoided = 0;
+}
+
+TextBatchClass::TextBatchClass(const TextBatchClass& other)
+{
+}
+
+TextBatchClass::~TextBatchClass()
+{
+}
+
+bool TextBatchClass::Initialize(const FontMetricsClass *metrics, int screenWidth, int screenHeight, int maxInstances)
+{
+	if (!metrics || maxInstances <= 0)
+		return false;
+
+	m_metrics		   = metrics;
+	m_screenWidth	   = screenWidth;
+	m_screenHeight	   = screenHeight;
+	m_maxInstanceCount = maxInstances;
+	m_instanceCount	   = 0;
+	m_dirty			   = false;
+
+	// The paragraphs are laid out with the metrics of the font, the last layouts are cached.
+	return m_Layout.Initialize(64);
+}
+
+void TextBatchClass::Shutdown()
+{
+	for (size_t i = 0; i < m_sentences.size(); i++)
+		ReleaseSentence(&m_sentences[i]);
+
+	m_sentences.clear();
+
+	m_Layout.Shutdown();
+
+	m_metrics		= 0;
+	m_instanceCount = 0;
+
+	return;
+}
+
+// AddSentence creates an empty sentence which can hold up to maxLength letters. Nothing is built before its first update.
+int TextBatchClass::AddSentence(int maxLength)
+{
+	SentenceType *sentence;
+
+	sentence = new SentenceType;
+	if (!sentence)
+		return -1;
+
+	sentence->maxLength			  = maxLength;
+	sentence->activeInstanceCount = 0;
+
+	sentence->instances = new GlyphTableClass::InstanceType[maxLength > 0 ? maxLength : 1];
+	if (!sentence->instances || !sentence->state.Initialize(maxLength)) {
+		ReleaseSentence(&sentence);
+		return -1;
+	}
+
+	memset(sentence->instances, 0, sizeof(GlyphTableClass::InstanceType) * (maxLength > 0 ? maxLength : 1));
+
+	m_sentences.push_back(sentence);
+
+	return (int)m_sentences.size() - 1;
+}
+
+// RemoveSentence releases the sentence, its text disappears with the next batch.
+void TextBatchClass::RemoveSentence(int id)
+{
+	if (id < 0 || id >= (int)m_sentences.size() || !m_sentences[id])
+		return;
+
+	if (m_sentences[id]->activeInstanceCount > 0) {
+		m_dirty = true;
+		m_version++;
+	}
+
+	ReleaseSentence(&m_sentences[id]);
+
+	return;
+}
+
+// UpdateSentence changes the instances of the sentence, they get to the batch with the next WriteInstances.
+// The sentence remembers its last text, position and color: if none of them changed nothing is rebuilt or uploaded,
+// a new color only recolors the letters, and if only the end of the text changed (e.g. "Fps: 59" -> "Fps: 60")
+// only the letters from the first different one on are rebuilt.
+bool TextBatchClass::UpdateSentence(int id, const char *text, int positionX, int positionY, unsigned int color)
+{
+	SentenceType *sentence;
+	int changes, firstLetter;
+	float drawX, drawY;
+
+	if (id < 0 || id >= (int)m_sentences.size() || !m_sentences[id])
+		return false;
+
+	sentence = m_sentences[id];
+
+	// A text longer than the sentence would overflow its instances.
+	changes = sentence->state.UpdateSentence(text, positionX, positionY, color, &firstLetter);
+	if (changes < 0)
+		return false;
+
+	// Same text at the same place in the same color: nothing to do.
+	if (changes == SentenceStateClass::CHANGE_NONE) {
+		m_uploadsAvoided++;
+		return true;
+	}
+
+	// The color is stored in every instance, so a new color recolors the letters already built.
+	if (changes & SentenceStateClass::CHANGE_COLOR)
+		for (int i = 0; i < sentence->activeInstanceCount; i++)
+			sentence->instances[i].color = color;
+
+	if (changes & SentenceStateClass::CHANGE_TEXT) {
+
+		// Calculate the X and Y pixel position on the screen to start drawing to.
+		drawX = (float)( (m_screenWidth  /-2) + positionX );
+		drawY = (float)( (m_screenHeight / 2) - positionY );
+
+		// Patch the instances from the first changed letter on.
+		sentence->activeInstanceCount = BuildSentence(sentence, text, drawX, drawY, firstLetter, color);
+	}
+
+	m_dirty = true;
+	m_version++;
+
+	return true;
+}
+
+// SetParagraph lays the text out with the TextLayoutClass and builds the instances of the glyph runs it gives.
+// Like UpdateSentence it does nothing when the text, position, wrapping width, alignment and color didn't change;
+// otherwise the whole paragraph is rebuilt, as a changed word can move all the words after it to another line.
+bool TextBatchClass::SetParagraph(int id, const char *text, int positionX, int positionY, float wrapWidth, int align, unsigned int color)
+{
+	SentenceType *sentence;
+	int changes;
+	TextLayoutClass::LayoutParamsType params;
+	const TextLayoutClass::LayoutType *layout;
+	float drawX, drawY;
+
+	if (id < 0 || id >= (int)m_sentences.size() || !m_sentences[id])
+		return false;
+
+	sentence = m_sentences[id];
+
+	// Check for possible buffer overflow, a letter is at least one byte of UTF-8.
+	changes = sentence->state.UpdateParagraph(text, positionX, positionY, wrapWidth, align, color);
+	if (changes < 0)
+		return false;
+
+	if (changes == SentenceStateClass::CHANGE_NONE) {
+		m_uploadsAvoided++;
+		return true;
+	}
+
+	if (changes & SentenceStateClass::CHANGE_TEXT) {
+		params = TextLayoutClass::DefaultParams();
+		params.maxWidth = wrapWidth;
+		params.align	= align;
+
+		layout = m_Layout.Layout(m_metrics, text, params);
+
+		drawX = (float)( (m_screenWidth  /-2) + positionX );
+		drawY = (float)( (m_screenHeight / 2) - positionY );
+
+		// The layout positions are from the top left corner of the text, y going down, while drawY goes up the screen.
+		// The instance array of the sentence is the limit, the glyphs past it are left out.
+		sentence->activeInstanceCount = 0;
+
+		for (size_t i = 0; i < layout->glyphs.size() && sentence->activeInstanceCount < sentence->maxLength; i++) {
+
+			GlyphTableClass::InstanceType &instance = sentence->instances[sentence->activeInstanceCount++];
+
+			instance.x	   = drawX + layout->glyphs[i].x;
+			instance.y	   = drawY - layout->glyphs[i].y;
+			instance.glyph = layout->glyphs[i].glyph;
+			instance.color = color;
+		}
+	}
+	else {
+		for (int i = 0; i < sentence->activeInstanceCount; i++)
+			sentence->instances[i].color = color;
+	}
+
+	m_dirty = true;
+	m_version++;
+
+	return true;
+}
+
+bool TextBatchClass::IsDirty()
+{
+	return m_dirty;
+}
+
+// WriteInstances is the upload: every sentence is copied, not only the changed ones, as the destination is a fresh
+// WRITE_DISCARD buffer; a letter is only 16 bytes.
+int TextBatchClass::WriteInstances(GlyphTableClass::InstanceType *dest)
+{
+	int count;
+
+	m_instanceCount = 0;
+
+	for (size_t i = 0; i < m_sentences.size(); i++) {
+
+		SentenceType *sentence = m_sentences[i];
+
+		if (!sentence || sentence->activeInstanceCount == 0)
+			continue;
+
+		count = sentence->activeInstanceCount;
+
+		if (m_instanceCount + count > m_maxInstanceCount)
+			count = m_maxInstanceCount - m_instanceCount;
+
+		memcpy(dest + m_instanceCount, sentence->instances, sizeof(GlyphTableClass::InstanceType) * count);
+		m_instanceCount += count;
+
+		if (m_instanceCount == m_maxInstanceCount)
+			break;
+	}
+
+	m_dirty = false;
+	m_uploadCount++;
+
+	return m_instanceCount;
+}
+
+void TextBatchClass::SkipUpload()
+{
+	m_uploadsAvoided++;
+
+	return;
+}
+
+int TextBatchClass::GetInstanceCount()
+{
+	return m_instanceCount;
+}
+
+const unsigned int* TextBatchClass::GetVersionCounter()
+{
+	return &m_version;
+}
+
+// ResetCounters is called once per frame, before the sentences are set, so the counters tell what that frame cost.
+// A skipped sentence update or a Render with nothing changed counts as avoided.
+void TextBatchClass::ResetCounters()
+{
+	m_uploadCount	 = 0;
+	m_uploadsAvoided = 0;
+
+	return;
+}
+
+int TextBatchClass::GetUploadCount()
+{
+	return m_uploadCount;
+}
+
+int TextBatchClass::GetUploadsAvoided()
+{
+	return m_uploadsAvoided;
+}
+
+// BuildSentence writes one instance per letter at the pen position, the letters before firstLetter are left untouched
+// and only move the pen. Spaces and the other glyphs without ink only move the pen, the characters the font doesn't have are left out.
+// It returns the number of instances in the whole sentence.
+int TextBatchClass::BuildSentence(SentenceType *sentence, const char *text, float drawX, float drawY, int firstLetter, unsigned int color)
+{
+	int index = 0;
+
+	for (int i = 0; text[i]; i++) {
+
+		int glyph = GlyphTableClass::GetAsciiGlyph(text[i]);
+
+		if (glyph < 0 || glyph >= m_metrics->GetGlyphCount())
+			continue;
+
+		const FontMetricsClass::GlyphMetricsType &metrics = m_metrics->GetGlyph(glyph);
+
+		if (metrics.visible) {
+
+			if (i >= firstLetter) {
+				GlyphTableClass::InstanceType &instance = sentence->instances[index];
+
+				instance.x	   = drawX;
+				instance.y	   = drawY;
+				instance.glyph = glyph;
+				instance.color = color;
+			}
+
+			index++;
+		}
+
+		drawX += metrics.advance;
+	}
+
+	return index;
+}
+
+void TextBatchClass::ReleaseSentence(SentenceType **sentence)
+{
+	if (*sentence) {
+
+		if ((*sentence)->instances) {
+			delete [] (*sentence)->instances;
+			(*sentence)->instances = 0;
+		}
+
+		(*sentence)->state.Shutdown();
+
+		delete *sentence;
+		*sentence = 0;
+	}
+
+	return;
+}
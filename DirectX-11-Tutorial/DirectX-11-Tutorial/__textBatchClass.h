@@ -0,0 +1,86 @@
+// --------------------------------------------------------------------------------------------------------
+// TextBatchClass is the CPU side of the TextOutClass: the sentences and paragraphs on the screen, the glyph instances
+// each of them is made of, and the one batch all of them are appended into, so all the text goes out in a single draw.
+// A letter is one GlyphTableClass instance with its own color, the sentences don't need a draw or a constant of their own.
+//
+// A sentence only rebuilds what an update changed (see SentenceStateClass), and the batch is only written again
+// when a sentence changed since the last WriteInstances. The TextOutClass keeps the Direct3D buffers and copies the batch into them.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _TEXTBATCHCLASS_H_
+#define _TEXTBATCHCLASS_H_
+
+#include <vector>
+using namespace std;
+
+#include "__fontMetricsClass.h"
+#include "__glyphTableClass.h"
+#include "__sentenceStateClass.h"
+#include "__textLayoutClass.h"
+
+
+
+class TextBatchClass {
+ private:
+	struct SentenceType {
+		int					 maxLength;
+		SentenceStateClass	 state;					// what the instances were last built from
+		int					 activeInstanceCount;	// instances actually used by the text, spaces have none
+		GlyphTableClass::InstanceType *instances;	// one per letter
+	};
+
+ public:
+	TextBatchClass();
+	TextBatchClass(const TextBatchClass &);
+   ~TextBatchClass();
+
+	// Initialize takes the metrics of the font, the size of the screen and the number of letters the batch holds.
+	// The metrics are the ones of an ASCII font, as FontClass::BuildMetrics fills them: the glyph id of a character is GlyphTableClass::GetAsciiGlyph.
+	bool Initialize(const FontMetricsClass *, int, int, int);
+	void Shutdown();
+
+	// Sentences are referred to by the id AddSentence returns, -1 if it can't be created. The id of a removed sentence is not reused.
+	int	 AddSentence(int);
+	void RemoveSentence(int);
+
+	// The position is the top left corner of the text on the screen in pixels, the color a GlyphTableClass::PackColor one.
+	// Both return false for an unknown sentence or a text longer than the sentence.
+	bool UpdateSentence(int, const char *, int, int, unsigned int);
+	bool SetParagraph(int, const char *, int, int, float, int, unsigned int);
+
+	// WriteInstances copies the instances of all the sentences, in the order they were added, and returns their number.
+	// The letters past the size of the batch are left out. SkipUpload is for a Render that draws the batch written before.
+	bool IsDirty();
+	int	 WriteInstances(GlyphTableClass::InstanceType *);
+	void SkipUpload();
+	int	 GetInstanceCount();
+
+	// The version counter goes up every time a sentence is updated, a LayerCacheClass watches it to know when to redraw the layer.
+	const unsigned int* GetVersionCounter();
+
+	// Counters of the batch uploads done and avoided since the last ResetCounters.
+	void ResetCounters();
+	int	 GetUploadCount();
+	int	 GetUploadsAvoided();
+
+ private:
+	int	 BuildSentence(SentenceType *, const char *, float, float, int, unsigned int);
+	void ReleaseSentence(SentenceType **);
+
+ private:
+	const FontMetricsClass	*m_metrics;
+	TextLayoutClass			 m_Layout;
+	int						 m_screenWidth, m_screenHeight;
+
+	vector<SentenceType*>	 m_sentences;
+	int						 m_maxInstanceCount;
+	int						 m_instanceCount;
+	bool					 m_dirty;
+
+	unsigned int			 m_version;
+	int						 m_uploadCount;
+	int						 m_uploadsAvoided;
+};
+
+#endif
@@ -0,0 +1,366 @@
+#include "__textLayoutClass.h"
+#include "__glyphAtlasClass.h"
+
+#include <string.h>
+
+TextLayoutClass::TextLayoutClass()
+{
+	m_cacheCapacity = 0;
+	m_cacheHits		= 0;
+	m_cacheMisses	= 0;
+}
+
+TextLayoutClass::TextLayoutClass(const TextLayoutClass& other)
+{
+}
+
+TextLayoutClass::~TextLayoutClass()
+{
+}
+
+bool TextLayoutClass::Initialize(int cacheCapacity)
+{
+	m_cacheCapacity = cacheCapacity;
+
+	return true;
+}
+
+void TextLayoutClass::Shutdown()
+{
+	m_cache.clear();
+	m_codepoints.clear();
+
+	return;
+}
+
+const TextLayoutClass::LayoutType* TextLayoutClass::Layout(const FontMetricsClass *font, const char *text, const LayoutParamsType &params)
+{
+	unsigned long long key = Hash(font, text, params);
+
+	unordered_map<unsigned long long, CacheEntryType>::iterator it = m_cache.find(key);
+
+	// The hash only finds the entry, the text and the parameters are compared too.
+	if (it != m_cache.end() && it->second.font == font && it->second.fontVersion == font->GetVersion() &&
+		SameParams(it->second.params, params) && it->second.text == text) {
+		m_cacheHits++;
+		return &it->second.layout;
+	}
+
+	m_cacheMisses++;
+
+	if ((int)m_cache.size() >= m_cacheCapacity)
+		m_cache.clear();
+
+	CacheEntryType &entry = m_cache[key];
+
+	entry.text		  = text;
+	entry.params	  = params;
+	entry.font		  = font;
+	entry.fontVersion = font->GetVersion();
+
+	LayoutUncached(font, text, params, &entry.layout);
+
+	return &entry.layout;
+}
+
+void TextLayoutClass::LayoutUncached(const FontMetricsClass *font, const char *text, const LayoutParamsType &params, LayoutType *layout)
+{
+	layout->glyphs.clear();
+	layout->lines.clear();
+	layout->clippedCount = 0;
+
+	Run(font, text, params, layout, &layout->width, &layout->height);
+
+	return;
+}
+
+void TextLayoutClass::Measure(const FontMetricsClass *font, const char *text, const LayoutParamsType &params, float *width, float *height)
+{
+	Run(font, text, params, 0, width, height);
+
+	return;
+}
+
+TextLayoutClass::LayoutParamsType TextLayoutClass::DefaultParams()
+{
+	LayoutParamsType params;
+
+	params.maxWidth	  = 0.0f;
+	params.align	  = TEXT_ALIGN_LEFT;
+	params.clip		  = false;
+	params.clipLeft	  = 0.0f;
+	params.clipTop	  = 0.0f;
+	params.clipRight  = 0.0f;
+	params.clipBottom = 0.0f;
+
+	return params;
+}
+
+int TextLayoutClass::GetCacheHits()
+{
+	return m_cacheHits;
+}
+
+int TextLayoutClass::GetCacheMisses()
+{
+	return m_cacheMisses;
+}
+
+void TextLayoutClass::ResetCounters()
+{
+	m_cacheHits	  = 0;
+	m_cacheMisses = 0;
+
+	return;
+}
+
+// Run lays the text out line by line. Without a layout to fill it only measures:
+// the line breaks are found the same way, but no glyph is written and nothing is aligned or clipped.
+void TextLayoutClass::Run(const FontMetricsClass *font, const char *text, const LayoutParamsType &params, LayoutType *layout, float *width, float *height)
+{
+	unsigned int codepoint;
+	int	  length, start, end, next, count;
+	float lineWidth, lineHeight, y, x, boxWidth, offset;
+	bool  more;
+
+	m_codepoints.clear();
+
+	while ((length = GlyphAtlasClass::DecodeUtf8(text, &codepoint)) > 0) {
+		m_codepoints.push_back(codepoint);
+		text += length;
+	}
+
+	count = (int)m_codepoints.size();
+
+	*width	= 0.0f;
+	*height = 0.0f;
+
+	if (count == 0)
+		return;
+
+	lineHeight = font->GetLineHeight();
+	start	   = 0;
+	y		   = 0.0f;
+	more	   = true;
+
+	while (more) {
+		end = BreakLine(font, start, params.maxWidth, &next, &lineWidth);
+
+		if (layout) {
+			LineType line;
+			unsigned int prev = 0;
+
+			line.firstGlyph = (int)layout->glyphs.size();
+			line.x			= 0.0f;
+			line.y			= y;
+			line.width		= lineWidth;
+
+			x = 0.0f;
+
+			for (int i = start; i < end; i++) {
+				int id = font->FindGlyph(m_codepoints[i]);
+
+				if (id < 0)
+					continue;
+
+				const FontMetricsClass::GlyphMetricsType &metrics = font->GetGlyph(id);
+
+				if (prev)
+					x += font->GetKerning(prev, m_codepoints[i]);
+
+				if (metrics.visible) {
+					LayoutGlyphType glyph;
+
+					glyph.glyph = id;
+					glyph.x		= x;
+					glyph.y		= y;
+
+					layout->glyphs.push_back(glyph);
+				}
+
+				x	+= metrics.advance;
+				prev = m_codepoints[i];
+			}
+
+			line.glyphCount = (int)layout->glyphs.size() - line.firstGlyph;
+			layout->lines.push_back(line);
+		}
+
+		if (lineWidth > *width)
+			*width = lineWidth;
+
+		y += lineHeight;
+
+		// A text ending with '\n' has one more, empty, line.
+		more  = next < count || (end < count && m_codepoints[end] == '\n');
+		start = next;
+	}
+
+	*height = y;
+
+	if (!layout)
+		return;
+
+	// Align the lines inside the wrapping width, or inside the widest line when there is no wrapping.
+	boxWidth = params.maxWidth > 0.0f ? params.maxWidth : *width;
+
+	if (params.align != TEXT_ALIGN_LEFT)
+		for (size_t i = 0; i < layout->lines.size(); i++) {
+			LineType &line = layout->lines[i];
+
+			offset = boxWidth - line.width;
+
+			if (params.align == TEXT_ALIGN_CENTER)
+				offset *= 0.5f;
+
+			line.x = offset;
+
+			for (int g = line.firstGlyph; g < line.firstGlyph + line.glyphCount; g++)
+				layout->glyphs[g].x += offset;
+		}
+
+	// Drop the glyphs the box of which is completely outside the clipping rectangle.
+	if (params.clip) {
+		int kept = 0;
+
+		for (size_t i = 0; i < layout->lines.size(); i++) {
+			LineType &line = layout->lines[i];
+			int first = kept;
+
+			for (int g = line.firstGlyph; g < line.firstGlyph + line.glyphCount; g++) {
+				const LayoutGlyphType &glyph = layout->glyphs[g];
+				const FontMetricsClass::GlyphMetricsType &metrics = font->GetGlyph(glyph.glyph);
+
+				float left	 = glyph.x + metrics.left;
+				float top	 = glyph.y + metrics.top;
+				float right	 = left + metrics.width;
+				float bottom = top + metrics.height;
+
+				if (right <= params.clipLeft || left >= params.clipRight || bottom <= params.clipTop || top >= params.clipBottom) {
+					layout->clippedCount++;
+					continue;
+				}
+
+				layout->glyphs[kept++] = glyph;
+			}
+
+			line.firstGlyph = first;
+			line.glyphCount = kept - first;
+		}
+
+		layout->glyphs.resize(kept);
+	}
+
+	return;
+}
+
+// BreakLine finds where the line starting at the given codepoint ends: at a '\n', at the end of the text,
+// or, with a width to wrap at, before the first word that doesn't fit. A word wider than the whole line is cut where it overflows.
+// It returns the end of the line, gives the start of the next line and the width of the line without its trailing spaces.
+int TextLayoutClass::BreakLine(const FontMetricsClass *font, int start, float maxWidth, int *next, float *width)
+{
+	int			 count = (int)m_codepoints.size();
+	int			 lastSpace = -1;
+	float		 x = 0.0f, inkWidth = 0.0f, breakWidth = 0.0f, advance;
+	unsigned int prev = 0;
+
+	for (int i = start; i < count; i++) {
+		unsigned int codepoint = m_codepoints[i];
+
+		if (codepoint == '\n') {
+			*next  = i + 1;
+			*width = inkWidth;
+			return i;
+		}
+
+		int id = font->FindGlyph(codepoint);
+
+		if (id < 0)
+			continue;
+
+		advance = font->GetGlyph(id).advance;
+
+		if (prev)
+			advance += font->GetKerning(prev, codepoint);
+
+		// A space is where the line can be broken, the line then ends before the spaces.
+		if (codepoint == ' ') {
+			if (prev != ' ')
+				breakWidth = inkWidth;
+
+			lastSpace = i;
+			x	 += advance;
+			prev  = codepoint;
+			continue;
+		}
+
+		if (maxWidth > 0.0f && x + advance > maxWidth && i > start) {
+
+			if (lastSpace >= start) {
+				*next  = lastSpace + 1;
+				*width = breakWidth;
+				return lastSpace;
+			}
+
+			*next  = i;
+			*width = x;
+			return i;
+		}
+
+		x		+= advance;
+		inkWidth = x;
+		prev	 = codepoint;
+	}
+
+	*next  = count;
+	*width = inkWidth;
+
+	return count;
+}
+
+// FNV-1a over the text, the parameters and the font.
+unsigned long long TextLayoutClass::Hash(const FontMetricsClass *font, const char *text, const LayoutParamsType &params)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	unsigned char	   data[sizeof(float) * 5 + sizeof(int) + sizeof(bool) + sizeof(font)];
+	int				   size = 0;
+
+	for (const unsigned char *s = (const unsigned char*)text; *s; s++) {
+		hash ^= *s;
+		hash *= 1099511628211ULL;
+	}
+
+	// The fields one by one, the padding of the structure is not initialized.
+	// Like in SameParams the clipping rectangle only counts when clipping.
+	memcpy(data + size, &params.maxWidth,	sizeof(float));	size += sizeof(float);
+	memcpy(data + size, &params.align,		sizeof(int));	size += sizeof(int);
+	memcpy(data + size, &params.clip,		sizeof(bool));	size += sizeof(bool);
+
+	if (params.clip) {
+		memcpy(data + size, &params.clipLeft,	sizeof(float));	size += sizeof(float);
+		memcpy(data + size, &params.clipTop,	sizeof(float));	size += sizeof(float);
+		memcpy(data + size, &params.clipRight,	sizeof(float));	size += sizeof(float);
+		memcpy(data + size, &params.clipBottom,	sizeof(float));	size += sizeof(float);
+	}
+
+	memcpy(data + size, &font,				sizeof(font));	size += sizeof(font);
+
+	for (int i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+bool TextLayoutClass::SameParams(const LayoutParamsType &a, const LayoutParamsType &b)
+{
+	if (a.maxWidth != b.maxWidth || a.align != b.align || a.clip != b.clip)
+		return false;
+
+	// The clipping rectangle only matters when clipping.
+	if (a.clip && (a.clipLeft != b.clipLeft || a.clipTop != b.clipTop || a.clipRight != b.clipRight || a.clipBottom != b.clipBottom))
+		return false;
+
+	return true;
+}
@@ -0,0 +1,106 @@
+// --------------------------------------------------------------------------------------------------------
+// TextLayoutClass turns UTF-8 text into glyph runs: the glyph id and pen position of every visible letter,
+// line by line, using the metrics and kerning pairs of a FontMetricsClass.
+// It breaks the lines at '\n' and, when a width is given, wraps the words that don't fit (a word longer than the line is cut);
+// the lines are then aligned left, centered or right, and the glyphs outside the clipping rectangle are dropped.
+// Measure gives the size of the text the same way, without writing any glyph.
+//
+// The positions are in pixels from the top left corner of the text, y going down (the pen is at the top of the line).
+// The results of Layout are cached by a hash of the text and the parameters, so text that doesn't change costs one lookup.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _TEXTLAYOUTCLASS_H_
+#define _TEXTLAYOUTCLASS_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+#include "__fontMetricsClass.h"
+
+#define TEXT_ALIGN_LEFT	  0
+#define TEXT_ALIGN_CENTER 1
+#define TEXT_ALIGN_RIGHT  2
+
+
+
+class TextLayoutClass {
+ public:
+	// maxWidth 0 means no wrapping. Without wrapping, the lines are aligned inside the widest one.
+	// The clipping rectangle is in the same coordinates as the glyphs and is only used when clip is set.
+	struct LayoutParamsType {
+		float maxWidth;
+		int	  align;
+		bool  clip;
+		float clipLeft, clipTop, clipRight, clipBottom;
+	};
+
+	struct LayoutGlyphType {
+		int	  glyph;
+		float x, y;
+	};
+
+	struct LineType {
+		int	  firstGlyph, glyphCount;
+		float x, y, width;
+	};
+
+	struct LayoutType {
+		vector<LayoutGlyphType> glyphs;
+		vector<LineType>		lines;
+		float					width, height;
+		int						clippedCount;
+	};
+
+ private:
+	struct CacheEntryType {
+		string				text;
+		LayoutParamsType	params;
+		const FontMetricsClass *font;
+		unsigned int		fontVersion;
+		LayoutType			layout;
+	};
+
+ public:
+	TextLayoutClass();
+	TextLayoutClass(const TextLayoutClass &);
+   ~TextLayoutClass();
+
+	// Initialize sets how many layouts the cache keeps. When it is full, it is emptied.
+	bool Initialize(int);
+	void Shutdown();
+
+	// Layout returns the layout of the text, from the cache if the same text was laid out with the same font and parameters.
+	// The pointer stays valid until the next call.
+	const LayoutType* Layout(const FontMetricsClass *, const char *, const LayoutParamsType &);
+
+	// LayoutUncached does the work of Layout into the given result.
+	void LayoutUncached(const FontMetricsClass *, const char *, const LayoutParamsType &, LayoutType *);
+
+	// Measure is the fast path for the size of the text: same wrapping, no glyphs, no cache.
+	void Measure(const FontMetricsClass *, const char *, const LayoutParamsType &, float *, float *);
+
+	static LayoutParamsType DefaultParams();
+
+	int  GetCacheHits();
+	int  GetCacheMisses();
+	void ResetCounters();
+
+ private:
+	void Run(const FontMetricsClass *, const char *, const LayoutParamsType &, LayoutType *, float *, float *);
+	int  BreakLine(const FontMetricsClass *, int, float, int *, float *);
+
+	static unsigned long long Hash(const FontMetricsClass *, const char *, const LayoutParamsType &);
+	static bool SameParams(const LayoutParamsType &, const LayoutParamsType &);
+
+ private:
+	vector<unsigned int>	m_codepoints;		// the decoded text of the current call
+
+	unordered_map<unsigned long long, CacheEntryType> m_cache;
+	int						m_cacheCapacity;
+	int						m_cacheHits, m_cacheMisses;
+};
+
+#endif
@@ -1,12 +1,19 @@
 #include "__textOutClass.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
 
 TextOutClass::TextOutClass()
 {
 	m_Font = 0;
 	m_FontShader = 0;
 
-	m_sentence1 = 0;
-	m_sentence2 = 0;
+	m_vertexBuffer		 = 0;
+	m_instanceBuffer	 = 0;
+
+	m_fpsSentence = -1;
+	m_cpuSentence = -1;
+
+	m_drawCount = 0;
 }
 
 TextOutClass::TextOutClass(const TextOutClass& other)
@@ -20,6 +27,7 @@ TextOutClass::~TextOutClass()
 bool TextOutClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceContext, HWND hwnd, int screenWidth, int screenHeight, D3DXMATRIX baseViewMatrix)
 {
 	bool result;
+	int	 paragraph;
 
 	// Store the screen size and the base view matrix, these will be used for rendering 2D text.
 
@@ -44,10 +52,21 @@ bool TextOutClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceC
 		return false;
 	}
 
+	// Fill the metrics table of the font, the paragraphs are laid out with it.
+	m_Font->BuildMetrics(&m_Metrics);
+
+	// And the glyph table the vertex shader makes the letters with.
+	m_Font->BuildGlyphTable(&m_GlyphTable);
+
+	// The sentences are kept and batched on the CPU side, the batch is as big as the shared instance buffer.
+	result = m_Batch.Initialize(&m_Metrics, screenWidth, screenHeight, TEXT_MAX_GLYPHS);
+	if(!result)
+		return false;
+
 	// Create and initialize the font shader object.
 
 	// Create the font shader object.
-	m_FontShader = new FontShaderClass;
+	m_FontShader = new FontShaderClass_Instancing;
 	if(!m_FontShader)
 		return false;
 
@@ -58,39 +77,57 @@ bool TextOutClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceC
 		return false;
 	}
 
+	// Create the quad and instance buffers shared by all the sentences.
+	result = InitializeBuffers(device);
+	if(!result) {
+		MessageBox(hwnd, L"Could not initialize the text buffers.", L"Error", MB_OK);
+		return false;
+	}
+
 	// Create and initialize the two strings that will be used for this tutorial.
-	// One string says Hello in white at 100, 100 and the other says Goodbye in yellow at 100, 200.
+	// One string says Hello in white at 10, 10 and the other says Goodbye in yellow at 10, 25.
 	// The UpdateSentence function can be called to change the contents, location, and color of the strings at any time.
 
 	// Initialize the first sentence.
-	result = InitializeSentence(&m_sentence1, 16, device);
-	if(!result)
+	m_fpsSentence = AddSentence(16);
+	if(m_fpsSentence < 0)
 		return false;
 
-	// Now update the sentence vertex buffer with the new string information.
-	result = UpdateSentence(m_sentence1, "Hello", 10, 10, 1.0f, 1.0f, 1.0f, deviceContext);
+	// Now update the sentence vertices with the new string information.
+	result = UpdateSentence(m_fpsSentence, "Hello", 10, 10, 1.0f, 1.0f, 1.0f);
 	if(!result)
 		return false;
 
-	// Initialize the first sentence.
-	result = InitializeSentence(&m_sentence2, 16, device);
+	// Initialize the second sentence.
+	m_cpuSentence = AddSentence(16);
+	if(m_cpuSentence < 0)
+		return false;
+
+	// Now update the sentence vertices with the new string information.
+	result = UpdateSentence(m_cpuSentence, "Goodbye", 10, 25, 1.0f, 1.0f, 0.0f);
 	if(!result)
 		return false;
 
-	// Now update the sentence vertex buffer with the new string information.
-	result = UpdateSentence(m_sentence2, "Goodbye", 10, 25, 1.0f, 1.0f, 0.0f, deviceContext);
+	// And a paragraph, wrapped at 200 pixels and centered, in the top right corner of the screen.
+	paragraph = AddSentence(128);
+	if(paragraph < 0)
+		return false;
+
+	result = SetParagraph(paragraph, "The text layout engine measures the words, wraps the lines that are too long and centers them.\nA new line starts here.",
+						  m_screenWidth - 220, 10, 200.0f, TEXT_ALIGN_CENTER, 0.6f, 0.8f, 1.0f);
 	if(!result)
 		return false;
 
 	return true;
 }
 
-// The Shutdown function will release the two sentences, the font object, and the font shader object.
+// The Shutdown function will release the sentences, the shared buffers, the font object, and the font shader object.
 void TextOutClass::Shutdown()
 {
 	// Release the sentences
-	ReleaseSentence(&m_sentence1);
-	ReleaseSentence(&m_sentence2);
+	m_Batch.Shutdown();
+
+	ShutdownBuffers();
 
 	// Release the font shader object.
 	if(m_FontShader) {
@@ -107,252 +144,168 @@ void TextOutClass::Shutdown()
 	}
 }
 
-// Render will draw the two sentences to the screen.
+// Render draws all the sentences to the screen with a single instanced draw call, one instance per letter.
+// The shared instance buffer is only rewritten when a sentence changed since the last Render.
+// Notice that we use the m_baseViewMatrix instead of the current view matrix.
+// This allows us to draw text to the same location on the screen each frame regardless of where the current view may be.
+// Likewise we use the orthoMatrix instead of the regular projection matrix since this should be drawn using 2D coordinates.
 bool TextOutClass::Render(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX orthoMatrix)
 {
-	bool result;
+	unsigned int  strides[2], offsets[2];
+	ID3D11Buffer *bufferPointers[2];
+	bool		  result;
 
-	// Draw the first sentence.
-	result = RenderSentence(deviceContext, m_sentence1, worldMatrix, orthoMatrix);
-	if(!result)
-		return false;
+	m_drawCount = 0;
 
-	// Draw the second sentence.
-	result = RenderSentence(deviceContext, m_sentence2, worldMatrix, orthoMatrix);
-	if(!result)
-		return false;
+	if (m_Batch.IsDirty()) {
 
-	return true;
-}
+		result = UpdateBuffers(deviceContext);
+		if(!result)
+			return false;
+	}
+	else {
+		m_Batch.SkipUpload();
+	}
 
-// The InitializeSentence function creates a SentenceType with an empty vertex buffer which will be used to store and render sentences.
-// The maxLength input parameter determines how large the vertex buffer will be.
-// All sentences have a vertex and index buffer associated with them which is initialized first in this function.
-bool TextOutClass::InitializeSentence(SentenceType** sentence, int maxLength, ID3D11Device* device)
-{
-	VertexType* vertices;
-	unsigned long* indices;
-	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
-	D3D11_SUBRESOURCE_DATA vertexData, indexData;
-	HRESULT result;
+	// Nothing to draw when there is no sentence (or only sentences made of spaces).
+	if (m_Batch.GetInstanceCount() == 0)
+		return true;
 
-	// Create a new sentence object.
-	*sentence = new SentenceType;
-	if( !*sentence )
-		return false;
+	// The unit quad is in the first slot, the letters in the second.
+	strides[0] = sizeof(VertexType);
+	strides[1] = sizeof(GlyphTableClass::InstanceType);
 
-	// Initialize the sentence buffers to null.
-	(*sentence)->vertexBuffer = 0;
-	(*sentence)->indexBuffer  = 0;
+	offsets[0] = 0;
+	offsets[1] = 0;
 
-	// Set the maximum length of the sentence.
-	(*sentence)->maxLength = maxLength;
+	bufferPointers[0] = m_vertexBuffer;
+	bufferPointers[1] = m_instanceBuffer;
 
-	// Set the number of vertices in the vertex array.
-	(*sentence)->vertexCount = 6 * maxLength;
+	// Set the vertex and instance buffers to active in the input assembler so they can be rendered.
+	deviceContext->IASetVertexBuffers(0, 2, bufferPointers, strides, offsets);
 
-	// Set the number of indexes in the index array.
-	(*sentence)->indexCount = (*sentence)->vertexCount;
-
-	// Create the vertex array.
-	vertices = new VertexType[(*sentence)->vertexCount];
-	if(!vertices)
-		return false;
+	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
+	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-	// Create the index array.
-	indices = new unsigned long[(*sentence)->indexCount];
-	if(!indices)
+	// Render the text of all the sentences using the instanced font shader, the color of each letter comes with its instance.
+	result = m_FontShader->Render(deviceContext, 6, m_Batch.GetInstanceCount(), worldMatrix, m_baseViewMatrix, orthoMatrix, m_Font->GetTexture(), &m_GlyphTable);
+	if(!result)
 		return false;
 
-	// Initialize vertex array to zeros at first.
-	memset(vertices, 0, (sizeof(VertexType) * (*sentence)->vertexCount));
+	m_drawCount++;
 
-	// Initialize the index array.
-	for(int i = 0; i < (*sentence)->indexCount; i++)
-		indices[i] = i;
+	return true;
+}
 
+// InitializeBuffers creates the unit quad and the instance buffer shared by all the sentences.
+// The quad never changes, so its vertex buffer is immutable; the instance buffer is dynamic, as it is rewritten every time a sentence changes.
+bool TextOutClass::InitializeBuffers(ID3D11Device* device)
+{
+	VertexType vertices[6];
+	D3D11_BUFFER_DESC vertexBufferDesc, instanceBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData;
+	HRESULT result;
 
-	// During the creation of the vertex buffer description for the sentence we set the Usage type to dynamic
-	// as we may want to change the contents of the sentence at any time.
+	// The six corners of the unit quad, in the order GlyphTableClass::ExpandVertex uses.
+	for (int i = 0; i < 6; i++)
+		GlyphTableClass::GetQuadCorner(i, &vertices[i].corner.x, &vertices[i].corner.y);
 
-	// Set up the description of the dynamic vertex buffer.
-	vertexBufferDesc.Usage			= D3D11_USAGE_DYNAMIC;
-	vertexBufferDesc.ByteWidth		= sizeof(VertexType) * (*sentence)->vertexCount;
+	// Set up the description of the static vertex buffer.
+	vertexBufferDesc.Usage			= D3D11_USAGE_IMMUTABLE;
+	vertexBufferDesc.ByteWidth		= sizeof(VertexType) * 6;
 	vertexBufferDesc.BindFlags		= D3D11_BIND_VERTEX_BUFFER;
-	vertexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	vertexBufferDesc.CPUAccessFlags = 0;
 	vertexBufferDesc.MiscFlags		= 0;
 	vertexBufferDesc.StructureByteStride = 0;
 
 	// Give the subresource structure a pointer to the vertex data.
-	vertexData.pSysMem		= vertices;
-	vertexData.SysMemPitch  = 0;
+	vertexData.pSysMem			= vertices;
+	vertexData.SysMemPitch		= 0;
 	vertexData.SysMemSlicePitch = 0;
 
-	// Create the vertex buffer.
-	result = device->CreateBuffer(&vertexBufferDesc, &vertexData, &(*sentence)->vertexBuffer);
+	result = device->CreateBuffer(&vertexBufferDesc, &vertexData, &m_vertexBuffer);
 	if(FAILED(result))
 		return false;
 
+	// Set up the description of the dynamic instance buffer.
+	instanceBufferDesc.Usage		  = D3D11_USAGE_DYNAMIC;
+	instanceBufferDesc.ByteWidth	  = sizeof(GlyphTableClass::InstanceType) * TEXT_MAX_GLYPHS;
+	instanceBufferDesc.BindFlags	  = D3D11_BIND_VERTEX_BUFFER;
+	instanceBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	instanceBufferDesc.MiscFlags	  = 0;
+	instanceBufferDesc.StructureByteStride = 0;
 
-	// The index buffer is setup as a normal static buffer since the contents will never need to change.
-
-	// Set up the description of the static index buffer.
-	indexBufferDesc.Usage			= D3D11_USAGE_DEFAULT;
-	indexBufferDesc.ByteWidth		= sizeof(unsigned long) * (*sentence)->indexCount;
-	indexBufferDesc.BindFlags		= D3D11_BIND_INDEX_BUFFER;
-	indexBufferDesc.CPUAccessFlags	= 0;
-	indexBufferDesc.MiscFlags		= 0;
-	indexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the index data.
-	indexData.pSysMem	  = indices;
-	indexData.SysMemPitch = 0;
-	indexData.SysMemSlicePitch = 0;
-
-	// Create the index buffer.
-	result = device->CreateBuffer(&indexBufferDesc, &indexData, &(*sentence)->indexBuffer);
+	// Create the instance buffer, it gets its content with the first Render.
+	result = device->CreateBuffer(&instanceBufferDesc, NULL, &m_instanceBuffer);
 	if(FAILED(result))
 		return false;
 
-	// Release the vertex array as it is no longer needed.
-	delete [] vertices;
-	vertices = 0;
-
-	// Release the index array as it is no longer needed.
-	delete [] indices;
-	indices = 0;
-
 	return true;
 }
 
-// UpdateSentence changes the contents of the vertex buffer for the input sentence.
-// It uses the Map and Unmap functions along with memcpy to update the contents of the vertex buffer.
-bool TextOutClass::UpdateSentence(SentenceType* sentence, char* text, int positionX, int positionY, float red, float green, float blue, ID3D11DeviceContext* deviceContext)
+void TextOutClass::ShutdownBuffers()
 {
-	int numLetters;
-	VertexType* vertices;
-	float drawX, drawY;
-	HRESULT result;
-	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	VertexType* verticesPtr;
-
-	// Set the color and size of the sentence.
-
-	// Store the color of the sentence.
-	sentence->red   = red;
-	sentence->green = green;
-	sentence->blue  = blue;
-
-	// Get the number of letters in the sentence.
-	numLetters = (int)strlen(text);
-
-	// Check for possible buffer overflow.
-	if(numLetters > sentence->maxLength)
-		return false;
-
-	// Create the vertex array.
-	vertices = new VertexType[sentence->vertexCount];
-	if(!vertices)
-		return false;
-
-	// Initialize vertex array to zeros at first.
-	memset(vertices, 0, (sizeof(VertexType) * sentence->vertexCount));
-
-	// Calculate the X and Y pixel position on the screen to start drawing to.
-	drawX = (float)( (m_screenWidth  /-2) + positionX );
-	drawY = (float)( (m_screenHeight / 2) - positionY );
+	if(m_instanceBuffer) {
+		m_instanceBuffer->Release();
+		m_instanceBuffer = 0;
+	}
 
-	// Build the vertex array using the FontClass and the sentence information.
+	if(m_vertexBuffer) {
+		m_vertexBuffer->Release();
+		m_vertexBuffer = 0;
+	}
+}
 
-	// Use the font class to build the vertex array from the sentence text and sentence draw location.
-	m_Font->BuildVertexArray((void*)vertices, text, drawX, drawY);
+// UpdateBuffers writes the batch of all the sentences into the shared instance buffer.
+// WRITE_DISCARD gives us a fresh buffer, so every sentence is copied, not only the changed ones; a letter is only 16 bytes.
+bool TextOutClass::UpdateBuffers(ID3D11DeviceContext* deviceContext)
+{
+	TraceScopeClass scope("TextOutClass::UpdateBuffers");
 
-	// Copy the vertex array information into the sentence vertex buffer.
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT result;
+	int count;
 
-	// Lock the vertex buffer so it can be written to.
-	result = deviceContext->Map(sentence->vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	// Lock the instance buffer so it can be written to.
+	result = deviceContext->Map(m_instanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
 	if(FAILED(result))
 		return false;
 
-	// Get a pointer to the data in the vertex buffer.
-	verticesPtr = (VertexType*)mappedResource.pData;
-
-	// Copy the data into the vertex buffer.
-	memcpy(verticesPtr, (void*)vertices, (sizeof(VertexType) * sentence->vertexCount));
-
-	// Unlock the vertex buffer.
-	deviceContext->Unmap(sentence->vertexBuffer, 0);
+	count = m_Batch.WriteInstances((GlyphTableClass::InstanceType*)mappedResource.pData);
 
-	// Release the vertex array as it is no longer needed.
-	delete [] vertices;
-	vertices = 0;
+	// Unlock the instance buffer.
+	deviceContext->Unmap(m_instanceBuffer, 0);
+	PerfStatsClass::CountMap(sizeof(GlyphTableClass::InstanceType) * count);
 
 	return true;
 }
 
-// ReleaseSentence is used to release the sentence vertex and index buffer as well as the sentence itself.
-void TextOutClass::ReleaseSentence(SentenceType** sentence)
+// The sentences live in the TextBatchClass, see there for what an update rebuilds.
+int TextOutClass::AddSentence(int maxLength)
 {
-	if( *sentence )
-	{
-		// Release the sentence vertex buffer.
-		if((*sentence)->vertexBuffer) {
-			(*sentence)->vertexBuffer->Release();
-			(*sentence)->vertexBuffer = 0;
-		}
-
-		// Release the sentence index buffer.
-		if((*sentence)->indexBuffer) {
-			(*sentence)->indexBuffer->Release();
-			(*sentence)->indexBuffer = 0;
-		}
-
-		// Release the sentence.
-		delete *sentence;
-		*sentence = 0;
-	}
+	return m_Batch.AddSentence(maxLength);
 }
 
-// The RenderSentence function puts the sentence vertex and index buffer on the input assembler and then calls the FontShaderClass object
-// to draw the sentence that was given as input to this function.
-// Notice that we use the m_baseViewMatrix instead of the current view matrix.
-// This allows us to draw text to the same location on the screen each frame regardless of where the current view may be.
-// Likewise we use the orthoMatrix instead of the regular projection matrix since this should be drawn using 2D coordinates.
-bool TextOutClass::RenderSentence(ID3D11DeviceContext* deviceContext, SentenceType* sentence, D3DXMATRIX worldMatrix, D3DXMATRIX orthoMatrix)
+void TextOutClass::RemoveSentence(int id)
 {
-	unsigned int stride, offset;
-	D3DXVECTOR4  pixelColor;
-	bool		 result;
-
-	// Set vertex buffer stride and offset.
-	stride = sizeof(VertexType); 
-	offset = 0;
-
-	// Set the vertex buffer to active in the input assembler so it can be rendered.
-	deviceContext->IASetVertexBuffers(0, 1, &sentence->vertexBuffer, &stride, &offset);
-
-	// Set the index buffer to active in the input assembler so it can be rendered.
-	deviceContext->IASetIndexBuffer(sentence->indexBuffer, DXGI_FORMAT_R32_UINT, 0);
-
-	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
-	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-	// Create a pixel color vector with the input sentence color.
-	pixelColor = D3DXVECTOR4(sentence->red, sentence->green, sentence->blue, 1.0f);
+	m_Batch.RemoveSentence(id);
+}
 
-	// Render the text using the font shader.
-	result = m_FontShader->Render(deviceContext, sentence->indexCount, worldMatrix, m_baseViewMatrix, orthoMatrix, m_Font->GetTexture(), pixelColor);
-	if(!result)
-		false;
+bool TextOutClass::UpdateSentence(int id, char* text, int positionX, int positionY, float red, float green, float blue)
+{
+	return m_Batch.UpdateSentence(id, text, positionX, positionY, GlyphTableClass::PackColor(red, green, blue, 1.0f));
+}
 
-	return true;
+bool TextOutClass::SetParagraph(int id, char* text, int positionX, int positionY, float wrapWidth, int align, float red, float green, float blue)
+{
+	return m_Batch.SetParagraph(id, text, positionX, positionY, wrapWidth, align, GlyphTableClass::PackColor(red, green, blue, 1.0f));
 }
 
 // The SetFps function takes the fps integer value given to it and then converts it to a string.
 // Once the fps count is in a string format it gets concatenated to another string so it has a prefix indicating that it is the fps speed.
 // After that it is stored in the sentence structure for rendering.
 // The SetFps function also sets the color of the fps string to green if above 60 fps, yellow if below 60 fps, and red if below 30 fps.
-bool TextOutClass::SetFps(int fps, ID3D11DeviceContext *deviceContext)
+bool TextOutClass::SetFps(int fps)
 {
 	char  tempString[16];
 	char  fpsString [16];
@@ -391,8 +344,8 @@ bool TextOutClass::SetFps(int fps, ID3D11DeviceContext *deviceContext)
 		}
 	}
 
-	// Update the sentence vertex buffer with the new string information.
-	result = UpdateSentence(m_sentence1, fpsString, 20, 20, red, green, blue, deviceContext);
+	// Update the sentence vertices with the new string information.
+	result = UpdateSentence(m_fpsSentence, fpsString, 20, 20, red, green, blue);
 	if (!result)
 		return false;
 
@@ -401,7 +354,7 @@ bool TextOutClass::SetFps(int fps, ID3D11DeviceContext *deviceContext)
 
 // The SetCpu function is similar to the SetFps function.
 // It takes the cpu value and converts it to a string which is then stored in the sentence structure and rendered.
-bool TextOutClass::SetCpu(int cpu, ID3D11DeviceContext* deviceContext)
+bool TextOutClass::SetCpu(int cpu)
 {
 	char tempString[16];
 	char cpuString [16];
@@ -415,10 +368,42 @@ bool TextOutClass::SetCpu(int cpu, ID3D11DeviceContext* deviceContext)
 	strcat_s(cpuString, tempString);
 	strcat_s(cpuString, "%");
 
-	// Update the sentence vertex buffer with the new string information.
-	result = UpdateSentence(m_sentence2, cpuString, 20, 40, 0.0f, 1.0f, 0.0f, deviceContext);
+	// Update the sentence vertices with the new string information.
+	result = UpdateSentence(m_cpuSentence, cpuString, 20, 40, 0.0f, 1.0f, 0.0f);
 	if (!result)
 		return false;
 
 	return true;
 }
+
+const unsigned int* TextOutClass::GetVersionCounter()
+{
+	return m_Batch.GetVersionCounter();
+}
+
+// ResetCounters is called once per frame, before the sentences are set, so the counters tell what that frame cost.
+// An upload is a rewrite of the shared instance buffer; a skipped sentence update or a Render with nothing changed counts as avoided.
+void TextOutClass::ResetCounters()
+{
+	m_Batch.ResetCounters();
+}
+
+int TextOutClass::GetUploadCount()
+{
+	return m_Batch.GetUploadCount();
+}
+
+int TextOutClass::GetUploadsAvoided()
+{
+	return m_Batch.GetUploadsAvoided();
+}
+
+int TextOutClass::GetDrawCount()
+{
+	return m_drawCount;
+}
+
+int TextOutClass::GetBatchInstanceCount()
+{
+	return m_Batch.GetInstanceCount();
+}
@@ -3,22 +3,23 @@
 #define _TEXTOUTCLASS_H_
 
 #include "__fontClass.h"
-#include "__fontShaderClass.h"
+#include "__fontShaderClassInstancing.h"
+#include "__textBatchClass.h"
+
+#include <vector>
+
+// The shared instance buffer holds that many letters, the letters of the sentences past it are not drawn.
+#define TEXT_MAX_GLYPHS 4096
 
 class TextOutClass {
   private:
 
-	// SentenceType is the structure that holds the rendering information for each text sentence.
-	struct SentenceType {
-		ID3D11Buffer *vertexBuffer, *indexBuffer;
-		int vertexCount, indexCount, maxLength;
-		float red, green, blue;
-	};
+	// The sentences and the batch they are appended into are kept by the TextBatchClass,
+	// this class has the Direct3D side: the font texture, the shader and the two buffers the batch is drawn from.
 
-	// The VertexType must match the one in the FontClass.
+	// The vertex of the unit quad all the letters are made from.
 	struct VertexType {
-		D3DXVECTOR3 position;
-		D3DXVECTOR2 texture;
+		D3DXVECTOR2 corner;
 	};
 
  public:
@@ -30,25 +31,55 @@ class TextOutClass {
 	void Shutdown();
 	bool Render(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX);
 
+	// Sentences are referred to by the id AddSentence returns. The id of a removed sentence is not reused.
+	int  AddSentence(int);
+	bool UpdateSentence(int, char*, int, int, float, float, float);
+
+	// SetParagraph puts a wrapped and aligned text in the sentence: the width to wrap at (0 for no wrapping) and a TEXT_ALIGN_ value.
+	bool SetParagraph(int, char*, int, int, float, int, float, float, float);
+	void RemoveSentence(int);
+
 	// We now have two new functions for setting the fps count and the cpu usage.
-	bool SetFps(int, ID3D11DeviceContext *);
-	bool SetCpu(int, ID3D11DeviceContext *);
+	bool SetFps(int);
+	bool SetCpu(int);
+
+	// The version counter goes up every time a sentence is updated, a LayerCacheClass watches it to know when to redraw the layer.
+	const unsigned int* GetVersionCounter();
+
+	// Counters of the instance buffer uploads done and avoided since the last ResetCounters.
+	void ResetCounters();
+	int  GetUploadCount();
+	int  GetUploadsAvoided();
+
+	// Number of draw calls and glyph instances of the last Render.
+	int  GetDrawCount();
+	int  GetBatchInstanceCount();
 
  private:
- 	bool InitializeSentence(SentenceType**, int, ID3D11Device*);
-	bool UpdateSentence(SentenceType*, char*, int, int, float, float, float, ID3D11DeviceContext*);
-	void ReleaseSentence(SentenceType**);
-	bool RenderSentence(ID3D11DeviceContext*, SentenceType*, D3DXMATRIX, D3DXMATRIX);
+	bool InitializeBuffers(ID3D11Device*);
+	void ShutdownBuffers();
+	bool UpdateBuffers(ID3D11DeviceContext*);
 
  private:
 	FontClass		*m_Font;
-	FontShaderClass	*m_FontShader;
+	FontShaderClass_Instancing *m_FontShader;
 	int				 m_screenWidth, m_screenHeight;
 	D3DXMATRIX		 m_baseViewMatrix;
 
-	// We will use two sentences in this tutorial.
-	SentenceType	*m_sentence1;
-	SentenceType	*m_sentence2;
+	// The metrics of the font, the sentences are built and laid out with them.
+	FontMetricsClass m_Metrics;
+
+	// The boxes and texture rectangles of the letters, read by the vertex shader.
+	GlyphTableClass	 m_GlyphTable;
+
+	// All the sentences share one dynamic instance buffer and the static unit quad, so all the text is drawn with a single call.
+	TextBatchClass	 m_Batch;
+	ID3D11Buffer	*m_vertexBuffer, *m_instanceBuffer;
+
+	int				 m_fpsSentence;
+	int				 m_cpuSentence;
+
+	int				 m_drawCount;
 };
 
 #endif
\ No newline at end of file
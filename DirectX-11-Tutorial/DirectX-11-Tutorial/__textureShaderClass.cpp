@@ -1,15 +1,27 @@
 #include "__textureShaderClass.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
+#include "__shaderLoaderClass.h"
 
 //   D3DCompileFromFile
 #pragma comment(lib, "d3dcompiler.lib")
 #include "D3Dcompiler.h"
 
+#include <string.h>
+
 TextureShaderClass::TextureShaderClass()
 {
 	m_vertexShader = 0;
 	m_pixelShader  = 0;
 	m_layout	   = 0;
-	m_matrixBuffer = 0;
+	m_frameBuffer  = 0;
+	m_objectBuffer = 0;
+	m_frameValid   = false;
+	m_objectValid  = false;
+
+	m_objectsVertexShader = 0;
+	m_objectsBuffer		  = 0;
+	m_objectsView		  = 0;
 
 	// The new sampler variable is set to null in the class constructor.
 	m_sampleState = 0;
@@ -50,6 +62,8 @@ void TextureShaderClass::Shutdown()
 bool TextureShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCount,
 									D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
 {
+	TraceScopeClass scope("TextureShaderClass::Render");
+
 	bool result;
 
 	// Set the shader parameters that it will use for rendering.
@@ -66,6 +80,8 @@ bool TextureShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCou
 bool TextureShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCount,
 									D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, bool sendTexture)
 {
+	TraceScopeClass scope("TextureShaderClass::Render");
+
 	bool result;
 
 	// Set the shader parameters that it will use for rendering.
@@ -79,6 +95,56 @@ bool TextureShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCou
 	return true;
 }
 
+bool TextureShaderClass::RenderObjects(ID3D11DeviceContext* deviceContext, int indexCount, const D3DXMATRIX* worldMatrices, int objectCount,
+										D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
+{
+	TraceScopeClass scope("TextureShaderClass::RenderObjects");
+
+	HRESULT					 result;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	D3DXMATRIX				*dataPtr;
+	int						 count;
+
+	if (!SetFrameParameters(deviceContext, viewMatrix, projectionMatrix))
+		return false;
+
+	deviceContext->IASetInputLayout(m_layout);
+	deviceContext->VSSetShader(m_objectsVertexShader, NULL, 0);
+	deviceContext->PSSetShader(m_pixelShader, NULL, 0);
+	deviceContext->PSSetShaderResources(0, 1, &texture);
+	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
+
+	// The world matrices go into the structured buffer with one Map for up to TEXTURE_SHADER_MAX_OBJECTS objects,
+	// the instance id of the draw picks the matrix of every copy.
+	for (int first = 0; first < objectCount; first += count) {
+
+		count = objectCount - first < TEXTURE_SHADER_MAX_OBJECTS ? objectCount - first : TEXTURE_SHADER_MAX_OBJECTS;
+
+		result = deviceContext->Map(m_objectsBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+		if (FAILED(result))
+			return false;
+
+		dataPtr = (D3DXMATRIX*)mappedResource.pData;
+
+		for (int i = 0; i < count; i++)
+			D3DXMatrixTranspose(&dataPtr[i], &worldMatrices[first + i]);
+
+		deviceContext->Unmap(m_objectsBuffer, 0);
+		PerfStatsClass::CountMap(count * sizeof(D3DXMATRIX));
+
+		deviceContext->VSSetShaderResources(0, 1, &m_objectsView);
+
+		deviceContext->DrawIndexedInstanced(indexCount, count, 0, 0, 0);
+		PerfStatsClass::CountDraw();
+	}
+
+	// The other shaders don't expect anything in the vertex shader slot.
+	ID3D11ShaderResourceView *nullView = 0;
+	deviceContext->VSSetShaderResources(0, 1, &nullView);
+
+	return true;
+}
+
 // InitializeShader sets up the texture shader.
 bool TextureShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
 {
@@ -86,9 +152,12 @@ bool TextureShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR
 	ID3D10Blob* errorMessage;
 	ID3D10Blob* vertexShaderBuffer;
 	ID3D10Blob* pixelShaderBuffer;
+	ID3D10Blob* objectsShaderBuffer;
 	D3D11_INPUT_ELEMENT_DESC polygonLayout[2];
 	unsigned int numElements;
-	D3D11_BUFFER_DESC matrixBufferDesc;
+	D3D11_BUFFER_DESC constantBufferDesc;
+	D3D11_BUFFER_DESC objectsBufferDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC objectsViewDesc;
 
 	//We have a new variable to hold the description of the texture sampler that will be setup in this function.
 	D3D11_SAMPLER_DESC samplerDesc;
@@ -102,7 +171,7 @@ bool TextureShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR
 	// Load in the new texture vertex and pixel shaders.
 	// Compile the vertex shader code.
 	//result = D3DX11CompileFromFile(vsFilename, NULL, NULL, "TextureVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &vertexShaderBuffer, &errorMessage, NULL);
-	result = D3DCompileFromFile(vsFilename, NULL, NULL, "TextureVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &vertexShaderBuffer, &errorMessage);
+	result = ShaderLoaderClass::CompileFromFile(vsFilename, "TextureVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, &vertexShaderBuffer, &errorMessage);
 
 	if( FAILED(result) ) {
 
@@ -118,7 +187,7 @@ bool TextureShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR
 
 	// Compile the pixel shader code.
 	//result = D3DX11CompileFromFile(psFilename, NULL, NULL, "TexturePixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &pixelShaderBuffer, &errorMessage, NULL);
-	result = D3DCompileFromFile(psFilename, NULL, NULL, "TexturePixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &pixelShaderBuffer, &errorMessage);
+	result = ShaderLoaderClass::CompileFromFile(psFilename, "TexturePixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, &pixelShaderBuffer, &errorMessage);
 
 	if( FAILED(result) ) {
 
@@ -142,6 +211,27 @@ bool TextureShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR
 	if (FAILED(result))
 		return false;
 
+	// The vertex shader of RenderObjects is in the same file. Its inputs are the same, so it uses the same layout.
+	result = ShaderLoaderClass::CompileFromFile(vsFilename, "TextureObjectsVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, &objectsShaderBuffer, &errorMessage);
+
+	if( FAILED(result) ) {
+
+		if (errorMessage)
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
+		else
+			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
+
+		return false;
+	}
+
+	result = device->CreateVertexShader(objectsShaderBuffer->GetBufferPointer(), objectsShaderBuffer->GetBufferSize(), NULL, &m_objectsVertexShader);
+
+	objectsShaderBuffer->Release();
+	objectsShaderBuffer = 0;
+
+	if( FAILED(result) )
+		return false;
+
 
 
 	// The input layout has changed as we now have a texture element instead of color.
@@ -181,16 +271,42 @@ bool TextureShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR
 	pixelShaderBuffer->Release();
 	pixelShaderBuffer = 0;
 
-	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
-	matrixBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	matrixBufferDesc.ByteWidth = sizeof(MatrixBufferType);
-	matrixBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	matrixBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	matrixBufferDesc.MiscFlags = 0;
-	matrixBufferDesc.StructureByteStride = 0;
+	// Setup the description of the dynamic constant buffers that are in the vertex shader, one per frame and one per object.
+	constantBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	constantBufferDesc.ByteWidth = sizeof(FrameBufferType);
+	constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	constantBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	constantBufferDesc.MiscFlags = 0;
+	constantBufferDesc.StructureByteStride = 0;
+
+	result = device->CreateBuffer(&constantBufferDesc, NULL, &m_frameBuffer);
+	if( FAILED(result) )
+		return false;
+
+	constantBufferDesc.ByteWidth = sizeof(ObjectBufferType);
+
+	result = device->CreateBuffer(&constantBufferDesc, NULL, &m_objectBuffer);
+	if( FAILED(result) )
+		return false;
 
-	// Create the constant buffer pointer so we can access the vertex shader constant buffer from within this class.
-	result = device->CreateBuffer(&matrixBufferDesc, NULL, &m_matrixBuffer);
+	// The structured buffer of RenderObjects holds one world matrix per object and is read by the vertex shader through a shader resource view.
+	objectsBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	objectsBufferDesc.ByteWidth = sizeof(D3DXMATRIX) * TEXTURE_SHADER_MAX_OBJECTS;
+	objectsBufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	objectsBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	objectsBufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	objectsBufferDesc.StructureByteStride = sizeof(D3DXMATRIX);
+
+	result = device->CreateBuffer(&objectsBufferDesc, NULL, &m_objectsBuffer);
+	if( FAILED(result) )
+		return false;
+
+	objectsViewDesc.Format = DXGI_FORMAT_UNKNOWN;
+	objectsViewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	objectsViewDesc.Buffer.FirstElement = 0;
+	objectsViewDesc.Buffer.NumElements = TEXTURE_SHADER_MAX_OBJECTS;
+
+	result = device->CreateShaderResourceView(m_objectsBuffer, &objectsViewDesc, &m_objectsView);
 	if( FAILED(result) )
 		return false;
 
@@ -240,10 +356,31 @@ void TextureShaderClass::ShutdownShader()
 		m_sampleState = 0;
 	}
 
-	// Release the matrix constant buffer.
-	if (m_matrixBuffer) {
-		m_matrixBuffer->Release();
-		m_matrixBuffer = 0;
+	// Release the structured buffer of RenderObjects and its vertex shader.
+	if (m_objectsView) {
+		m_objectsView->Release();
+		m_objectsView = 0;
+	}
+
+	if (m_objectsBuffer) {
+		m_objectsBuffer->Release();
+		m_objectsBuffer = 0;
+	}
+
+	if (m_objectsVertexShader) {
+		m_objectsVertexShader->Release();
+		m_objectsVertexShader = 0;
+	}
+
+	// Release the constant buffers.
+	if (m_objectBuffer) {
+		m_objectBuffer->Release();
+		m_objectBuffer = 0;
+	}
+
+	if (m_frameBuffer) {
+		m_frameBuffer->Release();
+		m_frameBuffer = 0;
 	}
 
 	// Release the layout.
@@ -306,86 +443,87 @@ void TextureShaderClass::OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND
 bool TextureShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext,
 	D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
 {
+	return SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, true);
+}
+
+bool TextureShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext,
+												D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, bool sendTexture)
+{
+	TraceScopeClass scope("TextureShaderClass::SetShaderParameters");
+
 	HRESULT result;
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	MatrixBufferType* dataPtr;
-	unsigned int bufferNumber;
-
+	ObjectBufferType object;
+	ID3D11Buffer *buffers[2];
 
-	// Transpose the matrices to prepare them for the shader.
-	D3DXMatrixTranspose(&worldMatrix, &worldMatrix);
-	D3DXMatrixTranspose(&viewMatrix, &viewMatrix);
-	D3DXMatrixTranspose(&projectionMatrix, &projectionMatrix);
 
-	// Lock the constant buffer so it can be written to.
-	result = deviceContext->Map(m_matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if (FAILED(result))
+	// The view and the projection go into the frame buffer, which is only uploaded when they change.
+	if (!SetFrameParameters(deviceContext, viewMatrix, projectionMatrix))
 		return false;
 
-	// Get a pointer to the data in the constant buffer.
-	dataPtr = (MatrixBufferType*)mappedResource.pData;
+	// Transpose the matrix to prepare it for the shader.
+	D3DXMatrixTranspose(&object.world, &worldMatrix);
+
+	// Many draws in a row use the same world matrix (all the chunks of the tilemap), the buffer still has it then.
+	if (!m_objectValid || memcmp(&object, &m_objectData, sizeof(object)) != 0) {
 
-	// Copy the matrices into the constant buffer.
-	dataPtr->world = worldMatrix;
-	dataPtr->view = viewMatrix;
-	dataPtr->projection = projectionMatrix;
+		// Lock the constant buffer so it can be written to.
+		result = deviceContext->Map(m_objectBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+		if (FAILED(result))
+			return false;
 
-	// Unlock the constant buffer.
-	deviceContext->Unmap(m_matrixBuffer, 0);
+		// Copy the matrix into the constant buffer.
+		*(ObjectBufferType*)mappedResource.pData = object;
 
-	// Set the position of the constant buffer in the vertex shader.
-	bufferNumber = 0;
+		// Unlock the constant buffer.
+		deviceContext->Unmap(m_objectBuffer, 0);
+		PerfStatsClass::CountMap(sizeof(ObjectBufferType));
 
-	// Now set the constant buffer in the vertex shader with the updated values.
-	deviceContext->VSSetConstantBuffers(bufferNumber, 1, &m_matrixBuffer);
+		m_objectData  = object;
+		m_objectValid = true;
+	}
+
+	// Other shaders use the same slots, so the buffers are set again even when they were not uploaded.
+	buffers[0] = m_frameBuffer;
+	buffers[1] = m_objectBuffer;
+	deviceContext->VSSetConstantBuffers(0, 2, buffers);
 
 	// The SetShaderParameters function has been modified from the previous tutorial to include setting the texture in the pixel shader now.
 	// Set shader texture resource in the pixel shader.
-	deviceContext->PSSetShaderResources(0, 1, &texture);
+	if(sendTexture)
+		deviceContext->PSSetShaderResources(0, 1, &texture);
 
 	return true;
 }
 
-bool TextureShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext,
-												D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, bool sendTexture)
+// SetFrameParameters uploads the view and the projection when they are not the ones the frame buffer already has.
+bool TextureShaderClass::SetFrameParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix)
 {
+	TraceScopeClass scope("TextureShaderClass::SetFrameParameters");
+
 	HRESULT result;
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	MatrixBufferType* dataPtr;
-	unsigned int bufferNumber;
-
+	FrameBufferType frame;
 
-	// Transpose the matrices to prepare them for the shader.
-	D3DXMatrixTranspose(&worldMatrix, &worldMatrix);
-	D3DXMatrixTranspose(&viewMatrix,  &viewMatrix);
-	D3DXMatrixTranspose(&projectionMatrix, &projectionMatrix);
-
-	// Lock the constant buffer so it can be written to.
-	result = deviceContext->Map(m_matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if (FAILED(result))
-		return false;
+	D3DXMatrixTranspose(&frame.view, &viewMatrix);
+	D3DXMatrixTranspose(&frame.projection, &projectionMatrix);
 
-	// Get a pointer to the data in the constant buffer.
-	dataPtr = (MatrixBufferType*)mappedResource.pData;
+	if (!m_frameValid || memcmp(&frame, &m_frameData, sizeof(frame)) != 0) {
 
-	// Copy the matrices into the constant buffer.
-	dataPtr->world	    = worldMatrix;
-	dataPtr->view       = viewMatrix;
-	dataPtr->projection = projectionMatrix;
+		result = deviceContext->Map(m_frameBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+		if (FAILED(result))
+			return false;
 
-	// Unlock the constant buffer.
-	deviceContext->Unmap(m_matrixBuffer, 0);
+		*(FrameBufferType*)mappedResource.pData = frame;
 
-	// Set the position of the constant buffer in the vertex shader.
-	bufferNumber = 0;
+		deviceContext->Unmap(m_frameBuffer, 0);
+		PerfStatsClass::CountMap(sizeof(FrameBufferType));
 
-	// Now set the constant buffer in the vertex shader with the updated values.
-	deviceContext->VSSetConstantBuffers(bufferNumber, 1, &m_matrixBuffer);
+		m_frameData  = frame;
+		m_frameValid = true;
+	}
 
-	// The SetShaderParameters function has been modified from the previous tutorial to include setting the texture in the pixel shader now.
-	// Set shader texture resource in the pixel shader.
-	if(sendTexture)
-		deviceContext->PSSetShaderResources(0, 1, &texture);
+	deviceContext->VSSetConstantBuffers(0, 1, &m_frameBuffer);
 
 	return true;
 }
@@ -406,6 +544,7 @@ void TextureShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int in
 
 	// Render the triangle.
 	deviceContext->DrawIndexed(indexCount, 0, 0);
+	PerfStatsClass::CountDraw();
 
 	return;
 }
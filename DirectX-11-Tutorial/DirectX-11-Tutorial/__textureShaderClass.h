@@ -10,13 +10,17 @@
 #include <fstream>
 using namespace std;
 
+#include "__shaderConstantsClass.h"
+
+// Size of the structured buffer of RenderObjects, larger sets are drawn in several calls
+#define TEXTURE_SHADER_MAX_OBJECTS 4096
+
 class TextureShaderClass {
  private:
-	struct MatrixBufferType {
-		D3DXMATRIX world;
-		D3DXMATRIX view;
-		D3DXMATRIX projection;
-	};
+	// The constant buffers are split by how often they change: the frame buffer is uploaded only when the view or the projection changes,
+	// the object buffer only when the world matrix differs from the one of the previous draw.
+	typedef ShaderConstantsClass<D3DXMATRIX, D3DXVECTOR3, D3DXVECTOR4>::TextureFrameBufferType  FrameBufferType;
+	typedef ShaderConstantsClass<D3DXMATRIX, D3DXVECTOR3, D3DXVECTOR4>::TextureObjectBufferType ObjectBufferType;
 
  public:
 	TextureShaderClass();
@@ -29,6 +33,9 @@ class TextureShaderClass {
 	// new
 	bool Render(ID3D11DeviceContext*, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, bool);
 
+	// RenderObjects draws the same buffers count times with one call, the world matrices of all the objects are uploaded into a structured buffer.
+	bool RenderObjects(ID3D11DeviceContext*, int, const D3DXMATRIX*, int, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*);
+
  private:
 	bool InitializeShader(ID3D11Device*, HWND, WCHAR*, WCHAR*);
 	void ShutdownShader();
@@ -37,13 +44,25 @@ class TextureShaderClass {
 	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*);
 	// new
 	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, bool);
+	bool SetFrameParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX);
 	void RenderShader(ID3D11DeviceContext*, int);
 
  private:
 	ID3D11VertexShader	*m_vertexShader;
 	ID3D11PixelShader	*m_pixelShader;
 	ID3D11InputLayout	*m_layout;
-	ID3D11Buffer		*m_matrixBuffer;
+	ID3D11Buffer		*m_frameBuffer;
+	ID3D11Buffer		*m_objectBuffer;
+
+	// The last uploaded contents of the constant buffers, already transposed, and whether there is any yet.
+	FrameBufferType		 m_frameData;
+	ObjectBufferType	 m_objectData;
+	bool				 m_frameValid, m_objectValid;
+
+	// The vertex shader of RenderObjects and its structured buffer of world matrices
+	ID3D11VertexShader		 *m_objectsVertexShader;
+	ID3D11Buffer			 *m_objectsBuffer;
+	ID3D11ShaderResourceView *m_objectsView;
 
 	// There is a new private variable for the sampler state pointer. This pointer will be used to interface with the texture shader.
 	ID3D11SamplerState	*m_sampleState;
@@ -1,18 +1,9 @@
 #include "__textureShaderClassInstancing.h"
-
-//   D3DCompileFromFile
-#pragma comment(lib, "d3dcompiler.lib")
-#include "D3Dcompiler.h"
+#include "__perfStatsClass.h"
+#include "__traceClass.h"
 
 TextureShaderClass_Instancing::TextureShaderClass_Instancing()
 {
-	m_vertexShader = 0;
-	m_pixelShader = 0;
-	m_layout = 0;
-	m_matrixBuffer = 0;
-
-	// The new sampler variable is set to null in the class constructor.
-	m_sampleState = 0;
 }
 
 TextureShaderClass_Instancing::TextureShaderClass_Instancing(const TextureShaderClass_Instancing& other)
@@ -23,25 +14,36 @@ TextureShaderClass_Instancing::~TextureShaderClass_Instancing()
 {
 }
 
+// Initialize loads the instancing vertex and pixel shaders. The input layout is made from the VertexLayout for slot 0
+// and the InstanceLayout for slot 1, the instance elements step once per instance.
 bool TextureShaderClass_Instancing::Initialize(ID3D11Device* device, HWND hwnd)
 {
-	bool result;
-
-	// The new texture.vs and texture.ps HLSL files are loaded for this shader.
-	// Initialize the vertex and pixel shaders.
-	result = InitializeShader(device, hwnd, L"../DirectX-11-Tutorial/_shaderTextureInstancing.vs", L"../DirectX-11-Tutorial/_shaderTextureInstancing.ps");
+	D3D11_SAMPLER_DESC samplerDesc;
 
-	if (!result)
-		return false;
+	// Create a texture sampler state description.
+	samplerDesc.Filter		   = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.AddressU	   = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressV	   = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressW	   = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.MipLODBias     = 0.0f;
+	samplerDesc.MaxAnisotropy  = 1;
+	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+	samplerDesc.BorderColor[0] = 0;
+	samplerDesc.BorderColor[1] = 0;
+	samplerDesc.BorderColor[2] = 0;
+	samplerDesc.BorderColor[3] = 0;
+	samplerDesc.MinLOD		   = 0;
+	samplerDesc.MaxLOD		   = D3D11_FLOAT32_MAX;
 
-	return true;
+	return m_program.Initialize(device, hwnd, L"../DirectX-11-Tutorial/_shaderTextureInstancing.vs", "TextureVertexShader",
+											  L"../DirectX-11-Tutorial/_shaderTextureInstancing.ps", "TexturePixelShader", &samplerDesc);
 }
 
 // The Shutdown function calls the release of the shader variables.
 void TextureShaderClass_Instancing::Shutdown()
 {
-	// Shutdown the vertex and pixel shaders as well as the related objects.
-	ShutdownShader();
+	m_program.Shutdown();
+
 	return;
 }
 
@@ -50,424 +52,67 @@ void TextureShaderClass_Instancing::Shutdown()
 bool TextureShaderClass_Instancing::Render(ID3D11DeviceContext* deviceContext, int indexCount,
 	D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
 {
-	bool result;
-
-	// Set the shader parameters that it will use for rendering.
-	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture);
-	if (!result)
-		return false;
-
-	// Now render the prepared buffers with the shader.
-	RenderShader(deviceContext, indexCount);
-
-	return true;
-}
-
-// The Render function now takes as input a vertex count and an instance count instead of the old index count.
-bool TextureShaderClass_Instancing::Render(ID3D11DeviceContext* deviceContext, int vertexCount, int instanceCount,
-											D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
-{
-	bool result;
-
-	// Set the shader parameters that it will use for rendering.
-	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture);
-	if (!result)
-		return false;
-
-	// Now render the prepared buffers with the shader.
-	RenderShader(deviceContext, vertexCount, instanceCount);
-
-	return true;
+	return Render(deviceContext, indexCount, worldMatrix, viewMatrix, projectionMatrix, texture, true);
 }
 
 bool TextureShaderClass_Instancing::Render(ID3D11DeviceContext* deviceContext, int indexCount,
 	D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, bool sendTexture)
 {
-	bool result;
+	TraceScopeClass scope("TextureShaderClass_Instancing::Render");
 
 	// Set the shader parameters that it will use for rendering.
-	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, sendTexture);
-	if (!result)
+	if (!SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, sendTexture))
 		return false;
 
-	// Now render the prepared buffers with the shader.
-	RenderShader(deviceContext, indexCount);
-
-	return true;
-}
-
-// InitializeShader sets up the texture shader.
-bool TextureShaderClass_Instancing::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename)
-{
-	HRESULT result;
-	ID3D10Blob* errorMessage;
-	ID3D10Blob* vertexShaderBuffer;
-	ID3D10Blob* pixelShaderBuffer;
-	D3D11_INPUT_ELEMENT_DESC polygonLayout[3];
-	unsigned int numElements;
-	D3D11_BUFFER_DESC matrixBufferDesc;
-
-	//We have a new variable to hold the description of the texture sampler that will be setup in this function.
-	D3D11_SAMPLER_DESC samplerDesc;
-
-
-	// Initialize the pointers this function will use to null.
-	errorMessage       = 0;
-	vertexShaderBuffer = 0;
-	pixelShaderBuffer  = 0;
-
-	// Load in the new texture vertex and pixel shaders.
-	// Compile the vertex shader code.
-	//result = D3DX11CompileFromFile(vsFilename, NULL, NULL, "TextureVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &vertexShaderBuffer, &errorMessage, NULL);
-	result = D3DCompileFromFile(vsFilename, NULL, NULL, "TextureVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &vertexShaderBuffer, &errorMessage);
-
-	if (FAILED(result)) {
-
-		// If the shader failed to compile it should have writen something to the error message.
-		if (errorMessage)
-			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
-		else
-			// If there was nothing in the error message then it simply could not find the shader file itself.
-			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
-
-		return false;
-	}
-
-	// Compile the pixel shader code.
-	//result = D3DX11CompileFromFile(psFilename, NULL, NULL, "TexturePixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &pixelShaderBuffer, &errorMessage, NULL);
-	result = D3DCompileFromFile(psFilename, NULL, NULL, "TexturePixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, &pixelShaderBuffer, &errorMessage);
-
-	if (FAILED(result)) {
-
-		// If the shader failed to compile it should have writen something to the error message.
-		if (errorMessage)
-			OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
-		else
-			// If there was  nothing in the error message then it simply could not find the file itself.
-			MessageBox(hwnd, psFilename, L"Missing Shader File", MB_OK);
-
-		return false;
-	}
-
-	// Create the vertex shader from the buffer.
-	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &m_vertexShader);
-	if (FAILED(result))
-		return false;
-
-	// Create the pixel shader from the buffer.
-	result = device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), NULL, &m_pixelShader);
-	if (FAILED(result))
-		return false;
-
-
-
-	// The input layout has changed as we now have a texture element instead of color.
-	// The first position element stays unchanged but the SemanticName and Format of the second element have been changed to TEXCOORD and DXGI_FORMAT_R32G32_FLOAT.
-	// These two changes will now align this layout with our new VertexType in both the ModelClass definition and the typedefs in the shader files
-
-	// Create the vertex input layout description.
-	// This setup needs to match the VertexType stucture in the ModelClass and in the shader.
-	polygonLayout[0].SemanticName = "POSITION";
-	polygonLayout[0].SemanticIndex = 0;
-	polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	polygonLayout[0].InputSlot = 0;
-	polygonLayout[0].AlignedByteOffset = 0;
-	polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[0].InstanceDataStepRate = 0;
-
-	polygonLayout[1].SemanticName = "TEXCOORD";
-	polygonLayout[1].SemanticIndex = 0;
-	polygonLayout[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-	polygonLayout[1].InputSlot = 0;
-	polygonLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	polygonLayout[1].InstanceDataStepRate = 0;
-
-	// new instancing
-	{
-		// For instancing we are going to add a third element to the layout.
-		// As we plan to position the four instanced triangles in different positions in 3D space we need to send the shader an extra position vector
-		// composed of three floats representing x, y, and z.
-		// Therefore the format is set to DXGI_FORMAT_R32G32B32_FLOAT.
-		// The semantic name is set to TEXCOORD as we are just using a generic semantic.
-		// Note that we have to set the semantic index to 1 in the layout since there is already a TEXCOORD for the texture coordinates using slot 0.
-
-		// Now for the instancing specific stuff we set the InputSlotClass to D3D11_INPUT_PER_INSTANCE_DATA which indicates that this is instanced data.
-		// Secondly the InstanceDataStepRate is now used and we set the step rate to 1 so that it will draw one instance before stepping forward a unit
-		// in the instance data.
-		// Note also that this is the first unit in the instance buffer so we set the AlignedByteOffset to 0 again since we are not aligning to the vertex buffer
-		// with the instance data.
-
-		polygonLayout[2].SemanticName		= "TEXCOORD";
-		polygonLayout[2].SemanticIndex		= 1;
-		polygonLayout[2].Format				= DXGI_FORMAT_R32G32B32_FLOAT;
-		polygonLayout[2].InputSlot			= 1;
-		polygonLayout[2].AlignedByteOffset  = 0;
-		polygonLayout[2].InputSlotClass		= D3D11_INPUT_PER_INSTANCE_DATA;
-		polygonLayout[2].InstanceDataStepRate = 1;
-	}
-
-	// Get a count of the elements in the layout.
-	numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
-
-	// Create the vertex input layout.
-	result = device->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &m_layout);
-	if (FAILED(result))
-		return false;
-
-	// Release the vertex shader buffer and pixel shader buffer since they are no longer needed.
-	vertexShaderBuffer->Release();
-	vertexShaderBuffer = 0;
-
-	pixelShaderBuffer->Release();
-	pixelShaderBuffer = 0;
-
-	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
-	matrixBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	matrixBufferDesc.ByteWidth = sizeof(MatrixBufferType);
-	matrixBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	matrixBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	matrixBufferDesc.MiscFlags = 0;
-	matrixBufferDesc.StructureByteStride = 0;
-
-	// Create the constant buffer pointer so we can access the vertex shader constant buffer from within this class.
-	result = device->CreateBuffer(&matrixBufferDesc, NULL, &m_matrixBuffer);
-	if (FAILED(result))
-		return false;
-
-
+	// Set the input layout, the shaders and the sampler, and render the triangles.
+	m_program.Bind(deviceContext);
 
-	// The sampler state description is setup here and then can be passed to the pixel shader after.
-	// The most important element of the texture sampler description is Filter. Filter will determine how it decides which pixels will be used or combined
-	// to create the final look of the texture on the polygon face.
-	// In the example here I use D3D11_FILTER_MIN_MAG_MIP_LINEAR which is more expensive in terms of processing but gives the best visual result.
-	// It tells the sampler to use linear interpolation for minification, magnification, and mip - level sampling.
-
-	// AddressU and AddressV are set to Wrap which ensures that the coordinates stay between 0.0f and 1.0f.
-	// Anything outside of that wraps around and is placed between 0.0f and 1.0f.
-	// All other settings for the sampler state description are defaults.
-
-	// Create a texture sampler state description.
-	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.MipLODBias = 0.0f;
-	samplerDesc.MaxAnisotropy = 1;
-	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
-	samplerDesc.BorderColor[0] = 0;
-	samplerDesc.BorderColor[1] = 0;
-	samplerDesc.BorderColor[2] = 0;
-	samplerDesc.BorderColor[3] = 0;
-	samplerDesc.MinLOD = 0;
-	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-
-	// Create the texture sampler state.
-	result = device->CreateSamplerState(&samplerDesc, &m_sampleState);
-	if (FAILED(result))
-		return false;
+	deviceContext->DrawIndexed(indexCount, 0, 0);
+	PerfStatsClass::CountDraw();
 
 	return true;
 }
 
-// The ShutdownShader function releases all the variables used in the TextureShaderClass_Instancing.
-void TextureShaderClass_Instancing::ShutdownShader()
-{
-	// The ShutdownShader function now releases the new sampler state that was created during initialization.
-
-	// Release the sampler state.
-	if (m_sampleState) {
-		m_sampleState->Release();
-		m_sampleState = 0;
-	}
-
-	// Release the matrix constant buffer.
-	if (m_matrixBuffer) {
-		m_matrixBuffer->Release();
-		m_matrixBuffer = 0;
-	}
-
-	// Release the layout.
-	if (m_layout) {
-		m_layout->Release();
-		m_layout = 0;
-	}
-
-	// Release the pixel shader.
-	if (m_pixelShader) {
-		m_pixelShader->Release();
-		m_pixelShader = 0;
-	}
-
-	// Release the vertex shader.
-	if (m_vertexShader) {
-		m_vertexShader->Release();
-		m_vertexShader = 0;
-	}
-
-	return;
-}
-
-// OutputShaderErrorMessage writes out errors to a text file if the HLSL shader could not be loaded.
-void TextureShaderClass_Instancing::OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFilename)
-{
-	char* compileErrors;
-	unsigned long bufferSize, i;
-	ofstream fout;
-
-
-	// Get a pointer to the error message text buffer.
-	compileErrors = (char*)(errorMessage->GetBufferPointer());
-
-	// Get the length of the message.
-	bufferSize = errorMessage->GetBufferSize();
-
-	// Open a file to write the error message to.
-	fout.open("____shader-error.txt");
-
-	// Write out the error message.
-	for (i = 0; i<bufferSize; i++)
-		fout << compileErrors[i];
-
-	// Close the file.
-	fout.close();
-
-	// Release the error message.
-	errorMessage->Release();
-	errorMessage = 0;
-
-	// Pop a message up on the screen to notify the user to check the text file for compile errors.
-	MessageBox(hwnd, L"Error compiling shader. Check '__shader-error.txt' for message.", shaderFilename, MB_OK);
-
-	return;
-}
-
-// SetShaderParameters function now takes in a pointer to a texture resource and then assigns it to the shader using the new texture resource pointer.
-// Note that the texture has to be set before rendering of the buffer occurs.
-bool TextureShaderClass_Instancing::SetShaderParameters(ID3D11DeviceContext* deviceContext,
-	D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
+// The Render function now takes as input a vertex count and an instance count instead of the old index count,
+// and uses the DrawInstanced function to draw the triangles instead of using the DrawIndexed function.
+bool TextureShaderClass_Instancing::Render(ID3D11DeviceContext* deviceContext, int vertexCount, int instanceCount,
+											D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
 {
-	HRESULT result;
-	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	MatrixBufferType* dataPtr;
-	unsigned int bufferNumber;
-
-
-	// Transpose the matrices to prepare them for the shader.
-	D3DXMatrixTranspose(&worldMatrix, &worldMatrix);
-	D3DXMatrixTranspose(&viewMatrix, &viewMatrix);
-	D3DXMatrixTranspose(&projectionMatrix, &projectionMatrix);
+	TraceScopeClass scope("TextureShaderClass_Instancing::Render");
 
-	// Lock the constant buffer so it can be written to.
-	result = deviceContext->Map(m_matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if (FAILED(result))
+	// Set the shader parameters that it will use for rendering.
+	if (!SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, true))
 		return false;
 
-	// Get a pointer to the data in the constant buffer.
-	dataPtr = (MatrixBufferType*)mappedResource.pData;
-
-	// Copy the matrices into the constant buffer.
-	dataPtr->world = worldMatrix;
-	dataPtr->view  = viewMatrix;
-	dataPtr->projection = projectionMatrix;
-
-	// Unlock the constant buffer.
-	deviceContext->Unmap(m_matrixBuffer, 0);
-
-	// Set the position of the constant buffer in the vertex shader.
-	bufferNumber = 0;
+	m_program.Bind(deviceContext);
 
-	// Now set the constant buffer in the vertex shader with the updated values.
-	deviceContext->VSSetConstantBuffers(bufferNumber, 1, &m_matrixBuffer);
-
-	// The SetShaderParameters function has been modified from the previous tutorial to include setting the texture in the pixel shader now.
-	// Set shader texture resource in the pixel shader.
-	deviceContext->PSSetShaderResources(0, 1, &texture);
+	deviceContext->DrawInstanced(vertexCount, instanceCount, 0, 0);
+	PerfStatsClass::CountDraw();
 
 	return true;
 }
 
+// SetShaderParameters uploads the transposed matrices to the vertex shader and sets the texture in the pixel shader.
+// Without sendTexture the texture bound before is kept.
 bool TextureShaderClass_Instancing::SetShaderParameters(ID3D11DeviceContext* deviceContext,
 	D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, bool sendTexture)
 {
-	HRESULT result;
-	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	MatrixBufferType* dataPtr;
-	unsigned int bufferNumber;
+	TraceScopeClass scope("TextureShaderClass_Instancing::SetShaderParameters");
 
+	MatrixBufferType matrices;
 
 	// Transpose the matrices to prepare them for the shader.
-	D3DXMatrixTranspose(&worldMatrix, &worldMatrix);
-	D3DXMatrixTranspose(&viewMatrix, &viewMatrix);
-	D3DXMatrixTranspose(&projectionMatrix, &projectionMatrix);
+	D3DXMatrixTranspose(&matrices.world, &worldMatrix);
+	D3DXMatrixTranspose(&matrices.view,  &viewMatrix);
+	D3DXMatrixTranspose(&matrices.projection, &projectionMatrix);
 
-	// Lock the constant buffer so it can be written to.
-	result = deviceContext->Map(m_matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	if (FAILED(result))
+	// Set the matrices in the constant buffer of the vertex shader.
+	if (!m_program.SetConstants<0>(deviceContext, matrices))
 		return false;
 
-	// Get a pointer to the data in the constant buffer.
-	dataPtr = (MatrixBufferType*)mappedResource.pData;
-
-	// Copy the matrices into the constant buffer.
-	dataPtr->world = worldMatrix;
-	dataPtr->view = viewMatrix;
-	dataPtr->projection = projectionMatrix;
-
-	// Unlock the constant buffer.
-	deviceContext->Unmap(m_matrixBuffer, 0);
-
-	// Set the position of the constant buffer in the vertex shader.
-	bufferNumber = 0;
-
-	// Now set the constant buffer in the vertex shader with the updated values.
-	deviceContext->VSSetConstantBuffers(bufferNumber, 1, &m_matrixBuffer);
-
-	// The SetShaderParameters function has been modified from the previous tutorial to include setting the texture in the pixel shader now.
 	// Set shader texture resource in the pixel shader.
 	if (sendTexture)
 		deviceContext->PSSetShaderResources(0, 1, &texture);
 
 	return true;
 }
-
-// RenderShader calls the shader technique to render the polygons.
-void TextureShaderClass_Instancing::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount)
-{
-	// Set the vertex input layout.
-	deviceContext->IASetInputLayout(m_layout);
-
-	// Set the vertex and pixel shaders that will be used to render this triangle.
-	deviceContext->VSSetShader(m_vertexShader, NULL, 0);
-	deviceContext->PSSetShader(m_pixelShader, NULL, 0);
-
-	// The RenderShader function has been changed to include setting the sample state in the pixel shader before rendering.
-	// Set the sampler state in the pixel shader.
-	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
-
-	// Render the triangle.
-	deviceContext->DrawIndexed(indexCount, 0, 0);
-
-	return;
-}
-
-// The RenderShader function is different in two ways.
-// First is that it takes as input the vertex and instance count instead of how it used to take in just an index count.
-// Secondly it uses the DrawInstanced function to draw the triangles instead of using the DrawIndexed function.
-void TextureShaderClass_Instancing::RenderShader(ID3D11DeviceContext* deviceContext, int vertexCount, int instanceCount)
-{
-	// Set the vertex input layout.
-	deviceContext->IASetInputLayout(m_layout);
-
-	// Set the vertex and pixel shaders that will be used to render this triangle.
-	deviceContext->VSSetShader(m_vertexShader, NULL, 0);
-	deviceContext->PSSetShader(m_pixelShader,  NULL, 0);
-
-	// Set the sampler state in the pixel shader.
-	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
-
-	// Render the triangle.
-	deviceContext->DrawInstanced(vertexCount, instanceCount, 0, 0);
-
-	return;
-}
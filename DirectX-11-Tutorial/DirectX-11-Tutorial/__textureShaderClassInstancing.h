@@ -6,19 +6,42 @@
 
 #include <d3d11.h>
 #include <d3dx10math.h>
-#include <d3dx11async.h>
-#include <fstream>
-using namespace std;
+
+#include "__shaderProgramClass.h"
+#include "__shaderConstantsClass.h"
 
 class TextureShaderClass_Instancing {
-private:
-	struct MatrixBufferType {
-		D3DXMATRIX world;
-		D3DXMATRIX view;
-		D3DXMATRIX projection;
+ public:
+	// The vertex of the quad, a position and texture coordinates, in the vertex buffer of slot 0.
+	struct VertexType {
+		D3DXVECTOR3 position;
+		D3DXVECTOR2 texture;
+	};
+
+	// The instance, in the instance buffer of slot 1: the position (z is the rotation angle), the size, the tint
+	// and the part of the texture it shows. The BitmapClass_Instancing and the ParticleSystemClass write this one.
+	struct InstanceType {
+		D3DXVECTOR3 position;
+		float		size;
+		D3DXVECTOR4 color;
+		D3DXVECTOR4 uvRect;
 	};
 
-public:
+	typedef VertexLayoutClass<VertexType,
+							  VERTEX_ELEMENT(VertexType, position, PositionSemantic),
+							  VERTEX_ELEMENT(VertexType, texture,  TexcoordSemantic)> VertexLayout;
+
+	// Texcoord 0 is taken by the texture coordinates of the vertex, so the instance starts at texcoord 1.
+	typedef VertexLayoutClass<InstanceType,
+							  VERTEX_ELEMENT(InstanceType, position, Texcoord1Semantic),
+							  VERTEX_ELEMENT(InstanceType, size,	 Texcoord2Semantic),
+							  VERTEX_ELEMENT(InstanceType, color,	 ColorSemantic),
+							  VERTEX_ELEMENT(InstanceType, uvRect,	 Texcoord3Semantic)> InstanceLayout;
+
+ private:
+	typedef ShaderConstantsClass<D3DXMATRIX, D3DXVECTOR3, D3DXVECTOR4>::MatrixBufferType MatrixBufferType;
+
+ public:
 	TextureShaderClass_Instancing();
 	TextureShaderClass_Instancing(const TextureShaderClass_Instancing &);
    ~TextureShaderClass_Instancing();
@@ -31,26 +54,11 @@ public:
 	// new instancing
 	bool Render(ID3D11DeviceContext*, int, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*);
 
-private:
-	bool InitializeShader(ID3D11Device*, HWND, WCHAR*, WCHAR*);
-	void ShutdownShader();
-	void OutputShaderErrorMessage(ID3D10Blob*, HWND, WCHAR*);
-
-	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*);
-	// new
+ private:
 	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, bool);
-	void RenderShader(ID3D11DeviceContext*, int);
-	// new instancing
-	void RenderShader(ID3D11DeviceContext*, int, int);
-
-private:
-	ID3D11VertexShader	*m_vertexShader;
-	ID3D11PixelShader	*m_pixelShader;
-	ID3D11InputLayout	*m_layout;
-	ID3D11Buffer		*m_matrixBuffer;
 
-	// There is a new private variable for the sampler state pointer. This pointer will be used to interface with the texture shader.
-	ID3D11SamplerState	*m_sampleState;
+ private:
+	ShaderProgramClass<InstancedLayoutClass<VertexLayout, InstanceLayout>, ConstantBufferClass<MatrixBufferType, SHADER_VERTEX, 0> > m_program;
 };
 
 #endif
@@ -0,0 +1,372 @@
+#include "__tilemapChunksClass.h"
+
+#include <string.h>
+
+TilemapChunksClass::TilemapChunksClass()
+{
+	m_mapWidth	   = 0;
+	m_mapHeight	   = 0;
+	m_chunksX	   = 0;
+	m_chunksY	   = 0;
+	m_tileSize	   = 0;
+	m_atlasColumns = 1;
+	m_atlasRows	   = 1;
+
+	m_tiles	 = 0;
+	m_chunks = 0;
+
+	m_frame		   = 0;
+	m_evictFrames  = 120;
+	m_rebuildCount = 0;
+}
+
+TilemapChunksClass::TilemapChunksClass(const TilemapChunksClass &other)
+{
+}
+
+TilemapChunksClass::~TilemapChunksClass()
+{
+}
+
+// A tile id is the index of the tile in the atlas, counted row by row. All the tiles are empty at first.
+bool TilemapChunksClass::Initialize(int mapWidth, int mapHeight, int tileSize, int atlasColumns, int atlasRows)
+{
+	if (mapWidth <= 0 || mapHeight <= 0 || tileSize <= 0 || atlasColumns <= 0 || atlasRows <= 0)
+		return false;
+
+	m_mapWidth	   = mapWidth;
+	m_mapHeight	   = mapHeight;
+	m_tileSize	   = tileSize;
+	m_atlasColumns = atlasColumns;
+	m_atlasRows	   = atlasRows;
+
+	// Round the map up to whole chunks, the tiles outside of the map simply stay empty.
+	m_chunksX = (mapWidth  + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	m_chunksY = (mapHeight + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+	int chunkCount = m_chunksX * m_chunksY;
+
+	// The tiles of all the chunks are kept in one array, each chunk points to its own part of it.
+	m_tiles = new unsigned short[chunkCount * CHUNK_SIZE * CHUNK_SIZE];
+	if (!m_tiles)
+		return false;
+
+	memset(m_tiles, 0xFF, sizeof(unsigned short) * chunkCount * CHUNK_SIZE * CHUNK_SIZE);
+
+	m_chunks = new ChunkType[chunkCount];
+	if (!m_chunks)
+		return false;
+
+	for (int i = 0; i < chunkCount; i++) {
+		m_chunks[i].tiles			 = m_tiles + i * CHUNK_SIZE * CHUNK_SIZE;
+		m_chunks[i].quadCount		 = 0;
+		m_chunks[i].lastVisibleFrame = 0;
+		m_chunks[i].dirty			 = true;
+		m_chunks[i].resident		 = false;
+	}
+
+	m_frame		   = 0;
+	m_rebuildCount = 0;
+
+	return true;
+}
+
+void TilemapChunksClass::Shutdown()
+{
+	if (m_chunks) {
+		delete[] m_chunks;
+		m_chunks = 0;
+	}
+
+	if (m_tiles) {
+		delete[] m_tiles;
+		m_tiles = 0;
+	}
+
+	m_visibleChunks.clear();
+	m_bakedChunks.clear();
+	m_evictedChunks.clear();
+
+	return;
+}
+
+// SetTile only changes the tile id and marks the chunk as dirty, the chunk will be rebuilt the next time it is visible.
+void TilemapChunksClass::SetTile(int x, int y, unsigned short id)
+{
+	if (x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight)
+		return;
+
+	ChunkType &chunk = m_chunks[(y / CHUNK_SIZE) * m_chunksX + (x / CHUNK_SIZE)];
+	unsigned short &tile = chunk.tiles[(y % CHUNK_SIZE) * CHUNK_SIZE + (x % CHUNK_SIZE)];
+
+	if (tile != id) {
+		tile = id;
+		chunk.dirty = true;
+	}
+
+	return;
+}
+
+unsigned short TilemapChunksClass::GetTile(int x, int y)
+{
+	if (x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight)
+		return EMPTY_TILE;
+
+	return m_chunks[(y / CHUNK_SIZE) * m_chunksX + (x / CHUNK_SIZE)].tiles[(y % CHUNK_SIZE) * CHUNK_SIZE + (x % CHUNK_SIZE)];
+}
+
+void TilemapChunksClass::SetEvictFrames(int frames)
+{
+	m_evictFrames = frames;
+}
+
+int TilemapChunksClass::BeginFrame(int viewLeft, int viewTop, int viewWidth, int viewHeight)
+{
+	m_frame++;
+	m_rebuildCount = 0;
+
+	SelectVisibleChunks(viewLeft, viewTop, viewWidth, viewHeight);
+
+	for (size_t i = 0; i < m_visibleChunks.size(); i++)
+		m_chunks[m_visibleChunks[i]].lastVisibleFrame = m_frame;
+
+	return (int)m_visibleChunks.size();
+}
+
+int TilemapChunksClass::GetVisibleChunk(int index)
+{
+	return m_visibleChunks[index];
+}
+
+int TilemapChunksClass::BakeChunk(int index, VertexType *vertices)
+{
+	return SetBaked(index, BuildChunkVertices(index, vertices));
+}
+
+int TilemapChunksClass::BakeChunk(int index, InstanceType *instances)
+{
+	return SetBaked(index, BuildChunkInstances(index, instances));
+}
+
+// SetBaked is the book-keeping of both ways to bake a chunk: it is clean and resident, with that many quads.
+int TilemapChunksClass::SetBaked(int index, int quadCount)
+{
+	ChunkType &chunk = m_chunks[index];
+
+	chunk.quadCount = quadCount;
+	chunk.dirty		= false;
+	m_rebuildCount++;
+
+	// Keep track of the baked chunks so that the eviction doesn't have to look through the whole map.
+	// Empty chunks are tracked too, otherwise they would never be marked for rebaking after eviction.
+	if (!chunk.resident) {
+		chunk.resident = true;
+		m_bakedChunks.push_back(index);
+	}
+
+	return chunk.quadCount;
+}
+
+bool TilemapChunksClass::IsDirty(int index)
+{
+	return m_chunks[index].dirty;
+}
+
+// SetDirty is for a chunk whose buffer could not be made, it is baked again the next frame.
+void TilemapChunksClass::SetDirty(int index)
+{
+	m_chunks[index].dirty	  = true;
+	m_chunks[index].quadCount = 0;
+}
+
+int TilemapChunksClass::GetQuadCount(int index)
+{
+	return m_chunks[index].quadCount;
+}
+
+// EvictChunks finds the baked chunks that have not been visible for m_evictFrames frames.
+// They are marked dirty, so they will be baked again if they come back into the view.
+const vector<int>& TilemapChunksClass::EvictChunks()
+{
+	m_evictedChunks.clear();
+
+	for (size_t i = 0; i < m_bakedChunks.size(); ) {
+
+		ChunkType &chunk = m_chunks[m_bakedChunks[i]];
+
+		if (m_frame - chunk.lastVisibleFrame > m_evictFrames) {
+
+			chunk.dirty		= true;
+			chunk.resident	= false;
+			chunk.quadCount = 0;
+
+			m_evictedChunks.push_back(m_bakedChunks[i]);
+
+			m_bakedChunks[i] = m_bakedChunks.back();
+			m_bakedChunks.pop_back();
+		}
+		else {
+			i++;
+		}
+	}
+
+	return m_evictedChunks;
+}
+
+// SelectVisibleChunks fills the list of the chunks that overlap the view rectangle and returns their number.
+// The map is a regular grid, so the visible chunks are found directly from the rectangle, nothing is tested one by one.
+int TilemapChunksClass::SelectVisibleChunks(int viewLeft, int viewTop, int viewWidth, int viewHeight)
+{
+	int chunkPixels = CHUNK_SIZE * m_tileSize;
+
+	m_visibleChunks.clear();
+
+	if (viewWidth <= 0 || viewHeight <= 0 || viewLeft + viewWidth <= 0 || viewTop + viewHeight <= 0)
+		return 0;
+
+	int x0 = viewLeft < 0 ? 0 : viewLeft / chunkPixels;
+	int y0 = viewTop  < 0 ? 0 : viewTop  / chunkPixels;
+	int x1 = (viewLeft + viewWidth  - 1) / chunkPixels;
+	int y1 = (viewTop  + viewHeight - 1) / chunkPixels;
+
+	if (x1 >= m_chunksX)
+		x1 = m_chunksX - 1;
+
+	if (y1 >= m_chunksY)
+		y1 = m_chunksY - 1;
+
+	for (int y = y0; y <= y1; y++)
+		for (int x = x0; x <= x1; x++)
+			m_visibleChunks.push_back(y * m_chunksX + x);
+
+	return (int)m_visibleChunks.size();
+}
+
+// BuildChunkVertices writes four vertices for every non-empty tile of the chunk and returns the number of quads.
+// The vertices are in map pixels with Y pointing up, so the map goes down from 0.
+int TilemapChunksClass::BuildChunkVertices(int index, VertexType *vertices)
+{
+	VertexType *vertexPtr = vertices;
+	ChunkType  &chunk	  = m_chunks[index];
+	int			quadCount = 0;
+
+	float tileU = 1.0f / m_atlasColumns;
+	float tileV = 1.0f / m_atlasRows;
+	float size	= (float)m_tileSize;
+
+	// Position of the top left corner of the chunk in map pixels
+	float chunkX = float((index % m_chunksX) * CHUNK_SIZE * m_tileSize);
+	float chunkY = float((index / m_chunksX) * CHUNK_SIZE * m_tileSize);
+
+	for (int y = 0; y < CHUNK_SIZE; y++) {
+
+		const unsigned short *row = chunk.tiles + y * CHUNK_SIZE;
+
+		float top	 = -(chunkY + y * size);
+		float bottom = top - size;
+
+		for (int x = 0; x < CHUNK_SIZE; x++) {
+
+			if (row[x] == EMPTY_TILE)
+				continue;
+
+			float left	= chunkX + x * size;
+			float right = left + size;
+
+			// Texture coordinates of the tile inside the atlas
+			float u0 = (row[x] % m_atlasColumns) * tileU;
+			float v0 = ((row[x] / m_atlasColumns) % m_atlasRows) * tileV;
+			float u1 = u0 + tileU;
+			float v1 = v0 + tileV;
+
+			VertexType quad[4] = {
+				{ left,  top,	 0.0f, u0, v0 },	// Top left
+				{ right, top,	 0.0f, u1, v0 },	// Top right
+				{ left,  bottom, 0.0f, u0, v1 },	// Bottom left
+				{ right, bottom, 0.0f, u1, v1 },	// Bottom right
+			};
+
+			memcpy(vertexPtr, quad, sizeof(quad));
+
+			vertexPtr += 4;
+			quadCount++;
+		}
+	}
+
+	return quadCount;
+}
+
+// BuildChunkInstances writes an instance for every non-empty tile of the chunk and returns their number: the center of the tile
+// in the map pixels of BuildChunkVertices, size 1 for a quad of the tile size, no rotation, white and the tile of the atlas.
+int TilemapChunksClass::BuildChunkInstances(int index, InstanceType *instances)
+{
+	InstanceType *instancePtr = instances;
+	ChunkType	 &chunk		  = m_chunks[index];
+
+	float tileU = 1.0f / m_atlasColumns;
+	float tileV = 1.0f / m_atlasRows;
+	float size	= (float)m_tileSize;
+
+	float chunkX = float((index % m_chunksX) * CHUNK_SIZE * m_tileSize);
+	float chunkY = float((index / m_chunksX) * CHUNK_SIZE * m_tileSize);
+
+	for (int y = 0; y < CHUNK_SIZE; y++) {
+
+		const unsigned short *row = chunk.tiles + y * CHUNK_SIZE;
+
+		for (int x = 0; x < CHUNK_SIZE; x++) {
+
+			if (row[x] == EMPTY_TILE)
+				continue;
+
+			instancePtr->x		  = chunkX + (x + 0.5f) * size;
+			instancePtr->y		  = -(chunkY + (y + 0.5f) * size);
+			instancePtr->rotation = 0.0f;
+			instancePtr->size	  = 1.0f;
+			instancePtr->r		  = instancePtr->g = instancePtr->b = instancePtr->a = 1.0f;
+			instancePtr->u		  = (row[x] % m_atlasColumns) * tileU;
+			instancePtr->v		  = ((row[x] / m_atlasColumns) % m_atlasRows) * tileV;
+			instancePtr->uWidth	  = tileU;
+			instancePtr->vHeight  = tileV;
+
+			instancePtr++;
+		}
+	}
+
+	return int(instancePtr - instances);
+}
+
+int TilemapChunksClass::GetVisibleChunkCount()
+{
+	return (int)m_visibleChunks.size();
+}
+
+int TilemapChunksClass::GetRebuildCount()
+{
+	return m_rebuildCount;
+}
+
+int TilemapChunksClass::GetBakedChunkCount()
+{
+	return (int)m_bakedChunks.size();
+}
+
+int TilemapChunksClass::GetChunkCount()
+{
+	return m_chunksX * m_chunksY;
+}
+
+int TilemapChunksClass::GetMapWidth()
+{
+	return m_mapWidth;
+}
+
+int TilemapChunksClass::GetMapHeight()
+{
+	return m_mapHeight;
+}
+
+int TilemapChunksClass::GetTileSize()
+{
+	return m_tileSize;
+}
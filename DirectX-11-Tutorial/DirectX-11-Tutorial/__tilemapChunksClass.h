@@ -0,0 +1,113 @@
+// --------------------------------------------------------------------------------------------------------
+// TilemapChunksClass is the CPU side of TilemapClass: the tile ids of the map stored chunk by chunk, which chunks are dirty,
+// which ones overlap the view, the vertices or the instances a chunk is baked into, and which baked chunks have not been seen for long enough
+// to be evicted. TilemapClass keeps the instance buffers of the chunks and does what this class tells it, so the baking and the culling
+// can be tested and timed on their own.
+//
+// A frame starts with BeginFrame and the view rectangle, which selects the visible chunks. A visible chunk that is dirty is baked with BakeChunk,
+// and EvictChunks ends the frame with the list of the chunks whose buffers are to be released; they are dirty again, to be baked when they come back.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _TILEMAPCHUNKSCLASS_H_
+#define _TILEMAPCHUNKSCLASS_H_
+
+#include <vector>
+using namespace std;
+
+
+
+class TilemapChunksClass {
+ public:
+	enum { CHUNK_SIZE = 32, EMPTY_TILE = 0xFFFF };
+
+	// The VertexType must match the one in the TextureShaderClass layout.
+	struct VertexType {
+		float x, y, z;
+		float u, v;
+	};
+
+	// The InstanceType must match the one of SpritePassClass: a tile is an instance of a quad of the tile size.
+	struct InstanceType {
+		float x, y, rotation;
+		float size;
+		float r, g, b, a;
+		float u, v, uWidth, vHeight;
+	};
+
+ private:
+	struct ChunkType {
+		unsigned short	*tiles;				// CHUNK_SIZE * CHUNK_SIZE tile ids, row by row
+		int				 quadCount;			// number of non-empty tiles when the chunk was baked
+		int				 lastVisibleFrame;
+		bool			 dirty;
+		bool			 resident;			// the chunk is in the list of baked chunks
+	};
+
+ public:
+	TilemapChunksClass();
+	TilemapChunksClass(const TilemapChunksClass &);
+   ~TilemapChunksClass();
+
+	// Initialize takes the map size in tiles, the size of a tile in pixels and the grid of the texture atlas, atlasColumns x atlasRows tiles.
+	bool Initialize(int, int, int, int, int);
+	void Shutdown();
+
+	void SetTile(int, int, unsigned short);
+	unsigned short GetTile(int, int);
+
+	// Chunks which have not been visible for this number of frames are evicted.
+	void SetEvictFrames(int);
+
+	// BeginFrame selects the chunks that overlap the view rectangle (in map pixels, Y pointing down) and returns their number.
+	int	 BeginFrame(int, int, int, int);
+	int	 GetVisibleChunk(int);
+
+	// BakeChunk writes the vertices of the chunk, four for every non-empty tile, and returns the number of quads; the chunk is clean and resident.
+	// The vertices take CHUNK_SIZE * CHUNK_SIZE * 4 at most. Baked into instances the chunk takes one for every non-empty tile.
+	int	 BakeChunk(int, VertexType *);
+	int	 BakeChunk(int, InstanceType *);
+	bool IsDirty(int);
+	void SetDirty(int);
+	int	 GetQuadCount(int);
+
+	// EvictChunks returns the chunks that were evicted at the end of the frame.
+	const vector<int>& EvictChunks();
+
+	// SelectVisibleChunks, BuildChunkVertices and BuildChunkInstances are the culling and the baking alone, without the book-keeping of a frame.
+	int	 SelectVisibleChunks(int, int, int, int);
+	int	 BuildChunkVertices(int, VertexType *);
+	int	 BuildChunkInstances(int, InstanceType *);
+
+	// Per-frame counters
+	int GetVisibleChunkCount();
+	int GetRebuildCount();
+	int GetBakedChunkCount();
+
+	int GetChunkCount();
+	int GetMapWidth();
+	int GetMapHeight();
+	int GetTileSize();
+
+ private:
+	int	 SetBaked(int, int);
+
+ private:
+	int				 m_mapWidth, m_mapHeight;			// in tiles
+	int				 m_chunksX,  m_chunksY;
+	int				 m_tileSize;						// in pixels
+	int				 m_atlasColumns, m_atlasRows;
+
+	unsigned short	*m_tiles;							// storage for the tiles of all the chunks
+	ChunkType		*m_chunks;
+
+	vector<int>		 m_visibleChunks;
+	vector<int>		 m_bakedChunks;
+	vector<int>		 m_evictedChunks;
+
+	int				 m_frame;
+	int				 m_evictFrames;
+	int				 m_rebuildCount;
+};
+
+#endif
@@ -0,0 +1,295 @@
+#include "__tilemapClass.h"
+
+#include <string.h>
+
+// The instance buffers of the chunks are drawn with the input layout of the sprites
+static_assert(sizeof(TilemapChunksClass::InstanceType) == sizeof(SpritePassClass::InstanceType), "Tile instance must match the sprite instance");
+
+TilemapClass::TilemapClass()
+{
+	m_backend	   = 0;
+	m_Texture	   = 0;
+	m_texture	   = 0;
+	m_quadBuffer   = 0;
+	m_matrixBuffer = 0;
+	m_vertexShader = 0;
+	m_pixelShader  = 0;
+	m_state		   = 0;
+	m_Chunks	   = 0;
+	m_instances	   = 0;
+}
+
+TilemapClass::TilemapClass(const TilemapClass &other)
+{
+}
+
+TilemapClass::~TilemapClass()
+{
+}
+
+// Initialize takes the map size in tiles, the size of a tile in pixels and the texture atlas, which is a grid of atlasColumns x atlasRows tiles.
+// A tile id is the index of the tile in the atlas, counted row by row. All the tiles are empty at first.
+// The atlas is loaded with TextureClass and imported into the backend; the shaders and the state belong to the caller.
+bool TilemapClass::Initialize(d3dClass *d3d, int mapWidth, int mapHeight, int tileSize, WCHAR *atlasFilename, int atlasColumns, int atlasRows,
+							  HandleType vertexShader, HandleType pixelShader, HandleType state)
+{
+	RenderBackendClass::BufferDescType bufferDesc;
+	bool							   result;
+
+	m_backend	   = d3d;
+	m_vertexShader = vertexShader;
+	m_pixelShader  = pixelShader;
+	m_state		   = state;
+
+	m_Chunks = new TilemapChunksClass;
+	if (!m_Chunks)
+		return false;
+
+	result = m_Chunks->Initialize(mapWidth, mapHeight, tileSize, atlasColumns, atlasRows);
+	if (!result)
+		return false;
+
+	m_instanceBuffers.assign(m_Chunks->GetChunkCount(), (HandleType)0);
+
+	// The scratch array is big enough for a chunk where every tile is used.
+	m_instances = new InstanceType[CHUNK_SIZE * CHUNK_SIZE];
+	if (!m_instances)
+		return false;
+
+	// A tile is the sprite quad at the tile size, so all the tiles are instances of size 1.
+	m_quadBuffer = SpritePassClass::CreateQuad(m_backend, tileSize);
+	if (!m_quadBuffer)
+		return false;
+
+	bufferDesc.type	   = RENDER_BUFFER_CONSTANT;
+	bufferDesc.size	   = sizeof(SpritePassClass::MatrixBufferType);
+	bufferDesc.stride  = 0;
+	bufferDesc.dynamic = true;
+	m_matrixBuffer = m_backend->CreateBuffer(bufferDesc, 0);
+	if (!m_matrixBuffer)
+		return false;
+
+	result = LoadTexture(d3d->GetDevice(), atlasFilename);
+	if (!result)
+		return false;
+
+	m_texture = d3d->ImportTexture(m_Texture->GetTexture(), 0);
+	if (!m_texture)
+		return false;
+
+	return true;
+}
+
+void TilemapClass::Shutdown()
+{
+	// Release the instance buffers of all the baked chunks.
+	for (size_t i = 0; i < m_instanceBuffers.size(); i++)
+		ReleaseChunk((int)i);
+	m_instanceBuffers.clear();
+
+	if (m_Chunks) {
+		m_Chunks->Shutdown();
+		delete m_Chunks;
+		m_Chunks = 0;
+	}
+
+	if (m_instances) {
+		delete[] m_instances;
+		m_instances = 0;
+	}
+
+	if (m_backend) {
+		m_backend->Release(m_texture);
+		m_backend->Release(m_matrixBuffer);
+		m_backend->Release(m_quadBuffer);
+	}
+
+	m_texture	   = 0;
+	m_matrixBuffer = 0;
+	m_quadBuffer   = 0;
+	m_backend	   = 0;
+
+	ReleaseTexture();
+
+	return;
+}
+
+void TilemapClass::SetTile(int x, int y, unsigned short id)
+{
+	m_Chunks->SetTile(x, y, id);
+}
+
+unsigned short TilemapClass::GetTile(int x, int y)
+{
+	return m_Chunks->GetTile(x, y);
+}
+
+void TilemapClass::SetEvictFrames(int frames)
+{
+	m_Chunks->SetEvictFrames(frames);
+}
+
+int TilemapClass::GetVisibleChunkCount()
+{
+	return m_Chunks->GetVisibleChunkCount();
+}
+
+int TilemapClass::GetRebuildCount()
+{
+	return m_Chunks->GetRebuildCount();
+}
+
+int TilemapClass::GetBakedChunkCount()
+{
+	return m_Chunks->GetBakedChunkCount();
+}
+
+int TilemapClass::GetMapWidth()
+{
+	return m_Chunks->GetMapWidth();
+}
+
+int TilemapClass::GetMapHeight()
+{
+	return m_Chunks->GetMapHeight();
+}
+
+int TilemapClass::GetTileSize()
+{
+	return m_Chunks->GetTileSize();
+}
+
+TilemapClass::HandleType TilemapClass::GetTexture()
+{
+	return m_texture;
+}
+
+// AddDraws selects the chunks that overlap the view, bakes the ones that are new or dirty and adds a draw of the tiles of each non-empty chunk.
+// The view rectangle is given in map pixels, (0, 0) being the top left corner of the map.
+// The chunks share the quad, the matrices, the shaders and the texture, so one after the other they only change the instances.
+bool TilemapClass::AddDraws(DrawQueueClass *queue, unsigned long long key, D3DXMATRIX viewMatrix, D3DXMATRIX orthoMatrix,
+							int viewLeft, int viewTop, int viewWidth, int viewHeight)
+{
+	DrawQueueClass::DrawType		 draw;
+	SpritePassClass::MatrixBufferType matrices;
+	D3DXMATRIX						 worldMatrix;
+	bool							 result;
+	int								 visibleCount;
+
+	visibleCount = m_Chunks->BeginFrame(viewLeft, viewTop, viewWidth, viewHeight);
+
+	// The tiles are in map pixels with Y pointing up, so one translation puts the top left corner of the view into the top left corner of the screen.
+	D3DXMatrixTranslation(&worldMatrix, float(-viewLeft - viewWidth/2), float(viewTop + viewHeight/2), 0.0f);
+
+	D3DXMatrixTranspose((D3DXMATRIX*)&matrices.world,	   &worldMatrix);
+	D3DXMatrixTranspose((D3DXMATRIX*)&matrices.view,	   &viewMatrix);
+	D3DXMatrixTranspose((D3DXMATRIX*)&matrices.projection, &orthoMatrix);
+
+	memset(&draw, 0, sizeof(draw));
+	draw.state				   = m_state;
+	draw.vertexShader		   = m_vertexShader;
+	draw.pixelShader		   = m_pixelShader;
+	draw.vertexBufferCount	   = 2;
+	draw.vertexBuffers[0]	   = m_quadBuffer;
+	draw.strides[0]			   = SpritePassClass::GetQuadVertexSize();
+	draw.strides[1]			   = sizeof(InstanceType);
+	draw.constantBuffers[0][0] = m_matrixBuffer;
+	draw.textures[0]		   = m_texture;
+	draw.constantBuffer		   = m_matrixBuffer;
+	draw.count				   = 6;
+
+	for (int i = 0; i < visibleCount; i++) {
+
+		int index = m_Chunks->GetVisibleChunk(i);
+
+		if (m_Chunks->IsDirty(index)) {
+			result = BakeChunk(index);
+			if (!result)
+				return false;
+		}
+
+		// Completely empty chunks have no instance buffer at all
+		if (!m_Chunks->GetQuadCount(index))
+			continue;
+
+		draw.vertexBuffers[1] = m_instanceBuffers[index];
+		draw.instanceCount	  = m_Chunks->GetQuadCount(index);
+
+		queue->AddDraw(key, draw, &matrices, sizeof(matrices));
+	}
+
+	// The chunks that have not been visible for a while give their buffers back.
+	// None of them is in the queue: the draws are only added for the visible chunks.
+	const vector<int> &evicted = m_Chunks->EvictChunks();
+
+	for (size_t i = 0; i < evicted.size(); i++)
+		ReleaseChunk(evicted[i]);
+
+	return true;
+}
+
+// BakeChunk makes the immutable instance buffer of the chunk. It is made before the layers record, they only bind it.
+bool TilemapClass::BakeChunk(int index)
+{
+	RenderBackendClass::BufferDescType bufferDesc;
+	int								   quadCount;
+
+	ReleaseChunk(index);
+
+	quadCount = m_Chunks->BakeChunk(index, m_instances);
+
+	if (quadCount) {
+
+		bufferDesc.type	   = RENDER_BUFFER_VERTEX;
+		bufferDesc.size	   = sizeof(InstanceType) * quadCount;
+		bufferDesc.stride  = 0;
+		bufferDesc.dynamic = false;
+
+		m_instanceBuffers[index] = m_backend->CreateBuffer(bufferDesc, m_instances);
+		if (!m_instanceBuffers[index]) {
+			m_Chunks->SetDirty(index);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void TilemapClass::ReleaseChunk(int index)
+{
+	if (m_instanceBuffers[index]) {
+		m_backend->Release(m_instanceBuffers[index]);
+		m_instanceBuffers[index] = 0;
+	}
+
+	return;
+}
+
+bool TilemapClass::LoadTexture(ID3D11Device *device, WCHAR *filename)
+{
+	bool result;
+
+	// Create the texture object.
+	m_Texture = new TextureClass;
+	if (!m_Texture)
+		return false;
+
+	// Initialize the texture object.
+	result = m_Texture->Initialize(device, filename);
+	if (!result)
+		return false;
+
+	return true;
+}
+
+void TilemapClass::ReleaseTexture()
+{
+	// Release the texture object.
+	if (m_Texture) {
+		m_Texture->Shutdown();
+		delete m_Texture;
+		m_Texture = 0;
+	}
+
+	return;
+}
@@ -0,0 +1,84 @@
+// --------------------------------------------------------------------------------------------------------
+// TilemapClass draws large 2D tile backgrounds.
+// The map is split into chunks of CHUNK_SIZE x CHUNK_SIZE tiles. The tiles of each chunk are baked once into an immutable instance buffer,
+// an instance of the quad of the tile size for every tile, with the texture coordinates of the tile taken from a texture atlas,
+// and the buffer is rebuilt only when a tile inside the chunk changes.
+// Only the chunks that overlap the view are baked and drawn, and the buffers of chunks that have not been seen for a while are released again,
+// so even a 4096x4096 map keeps only a screenful of chunks on the video card.
+// The chunks are drawn through the backend with the shaders of SpritePassClass, a draw per chunk added to a DrawQueueClass,
+// so they are sorted with the sprites of the same layer.
+// The tiles, the culling, the baking of the instances and the choice of the chunks to evict are TilemapChunksClass, this class keeps the buffers.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _TILEMAPCLASS_H_
+#define _TILEMAPCLASS_H_
+
+#include <d3d11.h>
+#include <d3dx10math.h>
+#include <vector>
+using namespace std;
+
+#include "__d3dClass.h"
+#include "__textureClass.h"
+#include "__tilemapChunksClass.h"
+#include "__spritePassClass.h"
+
+
+
+class TilemapClass {
+ public:
+	enum { CHUNK_SIZE = TilemapChunksClass::CHUNK_SIZE, EMPTY_TILE = TilemapChunksClass::EMPTY_TILE };
+
+	typedef RenderBackendClass::HandleType HandleType;
+
+ private:
+	typedef TilemapChunksClass::InstanceType InstanceType;
+
+ public:
+	TilemapClass();
+	TilemapClass(const TilemapClass &);
+   ~TilemapClass();
+
+	// Initialize takes the map and the atlas, then the shaders and the state of SpritePassClass to draw the tiles with.
+	bool Initialize(d3dClass *, int, int, int, WCHAR *, int, int, HandleType, HandleType, HandleType);
+	void Shutdown();
+
+	void SetTile(int, int, unsigned short);
+	unsigned short GetTile(int, int);
+
+	// Chunks which have not been visible for this number of frames lose their instance buffers.
+	void SetEvictFrames(int);
+
+	// AddDraws adds the draws of the part of the map that overlaps the view rectangle (in map pixels, Y pointing down) to the queue,
+	// a draw per chunk under the key. The texture is the one for the key.
+	bool	   AddDraws(DrawQueueClass *, unsigned long long, D3DXMATRIX, D3DXMATRIX, int, int, int, int);
+	HandleType GetTexture();
+
+	// Per-frame counters
+	int GetVisibleChunkCount();
+	int GetRebuildCount();
+	int GetBakedChunkCount();
+
+	int GetMapWidth();
+	int GetMapHeight();
+	int GetTileSize();
+
+ private:
+	bool BakeChunk(int);
+	void ReleaseChunk(int);
+
+	bool LoadTexture(ID3D11Device *, WCHAR *);
+	void ReleaseTexture();
+
+ private:
+	RenderBackendClass	 *m_backend;
+	TextureClass		 *m_Texture;
+	HandleType			  m_texture, m_quadBuffer, m_matrixBuffer;
+	HandleType			  m_vertexShader, m_pixelShader, m_state;
+
+	TilemapChunksClass	 *m_Chunks;
+	vector<HandleType>	  m_instanceBuffers;		// of the chunks, 0 until a chunk is baked, and again after it is evicted
+	InstanceType		 *m_instances;				// scratch array for baking one chunk
+};
+
+#endif
@@ -0,0 +1,272 @@
+#include "__traceClass.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+atomic<bool>				 TraceClass::s_enabled(false);
+long long					 TraceClass::s_start = 0;
+mutex						 TraceClass::s_mutex;
+vector<TraceClass::BufferType*> TraceClass::s_buffers;
+atomic<int>					 TraceClass::s_generation(0);
+TRACE_THREAD_LOCAL TraceClass::BufferType *TraceClass::s_threadBuffer	  = 0;
+TRACE_THREAD_LOCAL int					  TraceClass::s_threadGeneration = 0;
+TRACE_THREAD_LOCAL const char			  *TraceClass::s_threadName	  = 0;
+
+// A name as a JSON string, the names are ours so only the quotes and the backslashes are escaped
+static void WriteName(ofstream &fout, const char *name)
+{
+	fout << '"';
+
+	for (const char *c = name; *c; c++) {
+		if (*c == '"' || *c == '\\')
+			fout << '\\';
+
+		fout << *c;
+	}
+
+	fout << '"';
+}
+
+void TraceClass::Start()
+{
+	lock_guard<mutex> lock(s_mutex);
+
+	for (size_t i = 0; i < s_buffers.size(); i++) {
+		s_buffers[i]->count.store(0);
+		s_buffers[i]->dropped.store(0);
+	}
+
+	s_start = GetTicks();
+	s_enabled.store(true);
+
+	return;
+}
+
+void TraceClass::Stop()
+{
+	s_enabled.store(false);
+
+	return;
+}
+
+// The buffers of all the threads are released. The other threads still point at theirs, the new generation tells them
+// not to use them.
+void TraceClass::Shutdown()
+{
+	lock_guard<mutex> lock(s_mutex);
+
+	s_enabled.store(false);
+
+	for (size_t i = 0; i < s_buffers.size(); i++)
+		delete s_buffers[i];
+
+	s_buffers.clear();
+	s_generation.fetch_add(1);
+	s_threadBuffer = 0;
+
+	return;
+}
+
+int TraceClass::GetGeneration()
+{
+	return s_generation.load();
+}
+
+// The performance counter on Windows, where the standard clocks of VS2013 are as coarse as the system time
+long long TraceClass::GetTicks()
+{
+#ifdef _WIN32
+	LARGE_INTEGER counter;
+
+	QueryPerformanceCounter(&counter);
+
+	return counter.QuadPart;
+#else
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+long long TraceClass::GetFrequency()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency;
+
+	QueryPerformanceFrequency(&frequency);
+
+	return frequency.QuadPart;
+#else
+	return 1000000000LL;
+#endif
+}
+
+void TraceClass::SetThreadName(const char *name)
+{
+	s_threadName = name;
+
+	if (s_threadBuffer) {
+		lock_guard<mutex> lock(s_mutex);
+
+		if (s_threadGeneration == s_generation.load())
+			s_threadBuffer->name = name;
+	}
+
+	return;
+}
+
+int TraceClass::CreateTrack(const char *name)
+{
+	BufferType *buffer = CreateBuffer(name);
+
+	return buffer ? buffer->id - 1 : -1;
+}
+
+void TraceClass::AddEvent(int track, const char *name, long long begin, long long end)
+{
+	BufferType *buffer;
+
+	if (!IsEnabled() || track < 0)
+		return;
+
+	{
+		lock_guard<mutex> lock(s_mutex);
+
+		if (track >= (int)s_buffers.size())
+			return;
+
+		buffer = s_buffers[track];
+	}
+
+	Write(buffer, name, begin, end);
+
+	return;
+}
+
+// The events are complete events ("ph":"X") in microseconds from Start, every buffer is a thread of one process.
+bool TraceClass::Export(const char *filename)
+{
+	lock_guard<mutex> lock(s_mutex);
+	ofstream		  fout;
+	double			  scale = 1000000.0 / GetFrequency();
+	bool			  first = true;
+
+	fout.open(filename);
+	if (fout.fail())
+		return false;
+
+	fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" << fixed << setprecision(3);
+
+	for (size_t i = 0; i < s_buffers.size(); i++) {
+		BufferType *buffer = s_buffers[i];
+		int			count  = buffer->count.load(memory_order_acquire);
+
+		fout << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":";
+		WriteName(fout, buffer->name.c_str());
+		fout << "}}";
+		first = false;
+
+		for (int e = 0; e < count; e++) {
+			const EventType &event = buffer->events[e];
+
+			fout << ",\n{\"name\":";
+			WriteName(fout, event.name);
+			fout << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":" << (event.begin - s_start) * scale
+				 << ",\"dur\":" << (event.end - event.begin) * scale << "}";
+		}
+	}
+
+	fout << "\n]}\n";
+	fout.close();
+
+	return !fout.fail();
+}
+
+int TraceClass::GetEventCount()
+{
+	lock_guard<mutex> lock(s_mutex);
+	int				  count = 0;
+
+	for (size_t i = 0; i < s_buffers.size(); i++)
+		count += s_buffers[i]->count.load(memory_order_acquire);
+
+	return count;
+}
+
+int TraceClass::GetDroppedCount()
+{
+	lock_guard<mutex> lock(s_mutex);
+	int				  count = 0;
+
+	for (size_t i = 0; i < s_buffers.size(); i++)
+		count += s_buffers[i]->dropped.load();
+
+	return count;
+}
+
+// A thread takes the lock once, for its buffer, the events it records after that go into it straight.
+// A buffer of an older generation was released by Shutdown, the thread makes a new one.
+void TraceClass::Record(const char *name, long long begin, long long end)
+{
+	int generation = s_generation.load(memory_order_relaxed);
+
+	if (!s_threadBuffer || s_threadGeneration != generation) {
+		s_threadBuffer	   = CreateBuffer(s_threadName);
+		s_threadGeneration = generation;
+	}
+
+	if (s_threadBuffer)
+		Write(s_threadBuffer, name, begin, end);
+
+	return;
+}
+
+TraceClass::BufferType* TraceClass::CreateBuffer(const char *name)
+{
+	lock_guard<mutex> lock(s_mutex);
+	BufferType		 *buffer;
+
+	buffer = new BufferType;
+	if (!buffer)
+		return 0;
+
+	buffer->count.store(0);
+	buffer->dropped.store(0);
+	buffer->id		= (int)s_buffers.size() + 1;
+
+	if (name)
+		buffer->name = name;
+	else {
+		ostringstream thread;
+
+		thread << "thread " << buffer->id;
+		buffer->name = thread.str();
+	}
+
+	s_buffers.push_back(buffer);
+
+	return buffer;
+}
+
+// Only the owner of the buffer writes it: the event is complete before the count tells about it.
+void TraceClass::Write(BufferType *buffer, const char *name, long long begin, long long end)
+{
+	int count = buffer->count.load(memory_order_relaxed);
+
+	if (count >= TRACE_BUFFER_EVENTS) {
+		buffer->dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	buffer->events[count].name	= name;
+	buffer->events[count].begin = begin;
+	buffer->events[count].end	= end;
+	buffer->count.store(count + 1, memory_order_release);
+
+	return;
+}
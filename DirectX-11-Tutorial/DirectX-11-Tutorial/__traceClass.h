@@ -0,0 +1,134 @@
+// --------------------------------------------------------------------------------------------------------
+// TraceClass records where the time of the frames goes, as a timeline of named pieces of work on every thread,
+// and writes it as the JSON of the Chrome trace viewer (chrome://tracing, or ui.perfetto.dev).
+//
+// A piece of work is timed by a TraceScopeClass object on the stack: TraceScopeClass scope("GraphicsClass::Render");
+// the names are string literals, only their pointers are kept. While tracing is off a scope tests one flag when it opens
+// and its own pointer when it closes, it neither reads the clock nor calls anything.
+// While it is on, the scope reads the clock at both ends and writes one event into the buffer of its thread when it closes.
+// Every thread has its own buffer, made the first time it records, so the threads never wait for each other:
+// the owner writes the events and only then moves the count on, which the export reads.
+// A full buffer drops the events that follow and counts them.
+//
+// A track is a buffer that belongs to no thread, for the events measured elsewhere, like the GPU times of GpuTimerClass;
+// they are written by one thread too, in the ticks of GetTicks.
+// Start and Stop go between the frames, when the other threads are not recording; Start empties the buffers.
+// Shutdown releases the buffers and moves the generation on: a thread whose buffer is of an older generation
+// makes a new one the next time it records, and the tracks are made again by their owners.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _TRACECLASS_H_
+#define _TRACECLASS_H_
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+using namespace std;
+
+#define TRACE_BUFFER_EVENTS 65536		// per thread, from Start to Stop
+
+// The storage of a pointer per thread, VS2013 has no thread_local
+#ifdef _MSC_VER
+#define TRACE_THREAD_LOCAL __declspec(thread)
+#else
+#define TRACE_THREAD_LOCAL __thread
+#endif
+
+
+
+class TraceClass {
+ private:
+	struct EventType {
+		const char *name;
+		long long	begin, end;
+	};
+
+	struct BufferType {
+		EventType	events[TRACE_BUFFER_EVENTS];
+		atomic<int> count;
+		atomic<int> dropped;
+		int			id;						// the tid of the trace
+		string		name;
+	};
+
+ public:
+	static void Start();
+	static void Stop();
+	static void Shutdown();
+
+	// The generation of the buffers, changed by every Shutdown; the track numbers of an older one are gone.
+	static int GetGeneration();
+
+	static bool IsEnabled()
+	{
+		return s_enabled.load(memory_order_relaxed);
+	}
+
+	// The clock of the events, and its ticks per second.
+	static long long GetTicks();
+	static long long GetFrequency();
+
+	// SetThreadName names the calling thread in the trace, with a string literal; a thread without a name is "thread" and its number.
+	// The buffer of a thread is made when it first records, a thread that never records costs nothing.
+	static void SetThreadName(const char *);
+
+	// CreateTrack returns the number of a new track with its name, AddEvent writes an event into it.
+	static int	CreateTrack(const char *);
+	static void AddEvent(int, const char *, long long, long long);
+
+	// Export writes the events recorded since Start; it returns false when the file can't be written.
+	static bool Export(const char *);
+
+	static int GetEventCount();
+	static int GetDroppedCount();
+
+	// The scopes, see TraceScopeClass
+	static void Record(const char *, long long, long long);
+
+ private:
+	static BufferType* CreateBuffer(const char *);
+	static void		   Write(BufferType *, const char *, long long, long long);
+
+ private:
+	static atomic<bool>			s_enabled;
+	static long long			s_start;
+	static mutex				s_mutex;				// for making the buffers
+	static vector<BufferType*>	s_buffers;
+	static atomic<int>			s_generation;
+	static TRACE_THREAD_LOCAL BufferType *s_threadBuffer;
+	static TRACE_THREAD_LOCAL int		  s_threadGeneration;		// of s_threadBuffer
+	static TRACE_THREAD_LOCAL const char *s_threadName;
+};
+
+
+
+// TraceScopeClass times the block of code it is declared in, with the name it is given.
+class TraceScopeClass {
+ public:
+	TraceScopeClass(const char *name)
+	{
+		m_name = 0;
+
+		if (TraceClass::IsEnabled()) {
+			m_name	= name;
+			m_begin = TraceClass::GetTicks();
+		}
+	}
+
+   ~TraceScopeClass()
+	{
+		if (m_name)
+			TraceClass::Record(m_name, m_begin, TraceClass::GetTicks());
+	}
+
+ private:
+	TraceScopeClass(const TraceScopeClass &);
+
+ private:
+	const char *m_name;
+	long long	m_begin;
+};
+
+#endif
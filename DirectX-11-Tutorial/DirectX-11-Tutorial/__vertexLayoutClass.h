@@ -0,0 +1,170 @@
+// --------------------------------------------------------------------------------------------------------
+// VertexLayoutClass describes the input layout of a vertex struct at compile time, from the struct itself:
+// the format and the offset of every element come from the type and the position of its member,
+// only the semantic is written by hand. The members are listed in the order of the struct; a layout that misses one,
+// or has a member that is no vertex format, doesn't compile.
+//
+// The layout is declared next to the vertex struct:
+//
+//	struct VertexType {
+//		D3DXVECTOR3 position;
+//		D3DXVECTOR4 color;
+//	};
+//
+//	typedef VertexLayoutClass<VertexType,
+//							  VERTEX_ELEMENT(VertexType, position, PositionSemantic),
+//							  VERTEX_ELEMENT(VertexType, color,	   ColorSemantic)> VertexLayout;
+//
+// and Describe fills the element descriptions (D3D11_INPUT_ELEMENT_DESC for ShaderProgramClass).
+// A member of 1 to 4 floats (D3DXVECTOR2 and such) is a float format, int and unsigned int members are 32 bit integers.
+// The formats are the DXGI_FORMAT values, ShaderProgramClass checks that they are.
+// An instanced draw reads two buffers, InstancedLayoutClass puts the vertex layout in slot 0 and the instance one in slot 1.
+// The class has no Direct3D dependency.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _VERTEXLAYOUTCLASS_H_
+#define _VERTEXLAYOUTCLASS_H_
+
+#include <stddef.h>
+
+// The DXGI_FORMAT values of the vertex formats
+#define VERTEX_FORMAT_FLOAT4 2
+#define VERTEX_FORMAT_FLOAT3 6
+#define VERTEX_FORMAT_FLOAT2 16
+#define VERTEX_FORMAT_FLOAT1 41
+#define VERTEX_FORMAT_UINT1	 42
+#define VERTEX_FORMAT_SINT1	 43
+
+// The semantics, a semantic with an index is a type of its own
+#define VERTEX_SEMANTIC(Name, semantic, semanticIndex) \
+	struct Name { static const char* GetName() { return semantic; } enum { index = semanticIndex }; };
+
+VERTEX_SEMANTIC(PositionSemantic,  "POSITION", 0)
+VERTEX_SEMANTIC(NormalSemantic,	   "NORMAL",   0)
+VERTEX_SEMANTIC(ColorSemantic,	   "COLOR",	   0)
+VERTEX_SEMANTIC(TexcoordSemantic,  "TEXCOORD", 0)
+VERTEX_SEMANTIC(Texcoord1Semantic, "TEXCOORD", 1)
+VERTEX_SEMANTIC(Texcoord2Semantic, "TEXCOORD", 2)
+VERTEX_SEMANTIC(Texcoord3Semantic, "TEXCOORD", 3)
+
+// The element of a member of the vertex struct
+#define VERTEX_ELEMENT(Vertex, member, Semantic) \
+	VertexElementClass<Semantic, decltype(((Vertex*)0)->member), offsetof(Vertex, member)>
+
+
+
+// The format of a member: floats unless it is an integer
+template <int floats>
+struct VertexFloatFormat;
+
+template <> struct VertexFloatFormat<1> { enum { format = VERTEX_FORMAT_FLOAT1 }; };
+template <> struct VertexFloatFormat<2> { enum { format = VERTEX_FORMAT_FLOAT2 }; };
+template <> struct VertexFloatFormat<3> { enum { format = VERTEX_FORMAT_FLOAT3 }; };
+template <> struct VertexFloatFormat<4> { enum { format = VERTEX_FORMAT_FLOAT4 }; };
+
+template <class Member>
+struct VertexFormat {
+	static_assert(sizeof(Member) % sizeof(float) == 0 && sizeof(Member) <= 4 * sizeof(float), "a vertex member must be 1 to 4 floats");
+
+	enum { format = VertexFloatFormat<sizeof(Member) / sizeof(float)>::format };
+};
+
+template <> struct VertexFormat<unsigned int> { enum { format = VERTEX_FORMAT_UINT1 }; };
+template <> struct VertexFormat<int>		  { enum { format = VERTEX_FORMAT_SINT1 }; };
+
+
+
+template <class Semantic, class Member, unsigned int Offset>
+class VertexElementClass {
+ public:
+	enum {
+		format = VertexFormat<Member>::format,
+		offset = Offset,
+		size   = sizeof(Member)
+	};
+
+	template <class Desc>
+	static void Describe(Desc *desc, unsigned int slot, bool perInstance)
+	{
+		desc->SemanticName		   = Semantic::GetName();
+		desc->SemanticIndex		   = Semantic::index;
+		desc->Format			   = (decltype(desc->Format))format;
+		desc->InputSlot			   = slot;
+		desc->AlignedByteOffset	   = Offset;
+		desc->InputSlotClass	   = (decltype(desc->InputSlotClass))(perInstance ? 1 : 0);
+		desc->InstanceDataStepRate = perInstance ? 1 : 0;
+
+		return;
+	}
+};
+
+
+
+// The recursion over the elements: every element must start where the one before it ends,
+// end is where the last one ends.
+template <unsigned int Start, class... Elements>
+struct VertexElementList;
+
+template <unsigned int Start>
+struct VertexElementList<Start> {
+	enum { end = Start };
+
+	template <class Desc>
+	static void Describe(Desc *, unsigned int, bool)
+	{
+	}
+};
+
+template <unsigned int Start, class Element, class... Elements>
+struct VertexElementList<Start, Element, Elements...> {
+	static_assert(Element::offset == Start, "the vertex layout must list the members of the vertex in order, without a gap");
+
+	enum { end = VertexElementList<Start + Element::size, Elements...>::end };
+
+	template <class Desc>
+	static void Describe(Desc *desc, unsigned int slot, bool perInstance)
+	{
+		Element::Describe(desc, slot, perInstance);
+		VertexElementList<Start + Element::size, Elements...>::Describe(desc + 1, slot, perInstance);
+	}
+};
+
+
+
+template <class Vertex, class... Elements>
+class VertexLayoutClass {
+ public:
+	typedef Vertex VertexType;
+
+	enum { count = sizeof...(Elements) };
+
+	// The vertex formats need no padding, so every byte of the struct must belong to an element.
+	static_assert(VertexElementList<0, Elements...>::end == sizeof(Vertex), "the vertex layout doesn't describe every member of the vertex");
+
+	// Describe fills count element descriptions, for the input slot of the vertex buffer.
+	// A per instance layout steps once per instance.
+	template <class Desc>
+	static void Describe(Desc *desc, unsigned int slot = 0, bool perInstance = false)
+	{
+		VertexElementList<0, Elements...>::Describe(desc, slot, perInstance);
+	}
+};
+
+
+
+
+// The layout of an instanced draw: the vertices in slot 0, followed by the instances in slot 1, stepping once per instance.
+template <class VertexLayout, class InstanceLayout>
+class InstancedLayoutClass {
+ public:
+	enum { count = VertexLayout::count + InstanceLayout::count };
+
+	template <class Desc>
+	static void Describe(Desc *desc)
+	{
+		VertexLayout::Describe(desc, 0, false);
+		InstanceLayout::Describe(desc + VertexLayout::count, 1, true);
+	}
+};
+
+#endif
@@ -12,12 +12,14 @@ struct VertexInputType
 {
     float4 position : POSITION;
     float2 tex		: TEXCOORD0;
+    float4 color	: COLOR0;
 };
 
 struct PixelInputType
 {
     float4 position : SV_POSITION;
     float2 tex		: TEXCOORD0;
+    float4 color	: COLOR0;
 };
 
 // Vertex Shader
@@ -35,6 +37,9 @@ PixelInputType FontVertexShader(VertexInputType input)
     
     // Store the texture coordinates for the pixel shader.
     output.tex = input.tex;
+
+    // The color of the letter is passed on to the pixel shader.
+    output.color = input.color;
     
     return output;
 }
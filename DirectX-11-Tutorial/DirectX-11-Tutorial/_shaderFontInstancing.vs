@@ -0,0 +1,65 @@
+// The instanced font vertex shader draws a letter from a single 16 byte instance.
+// The vertex buffer only holds the six corners of a unit quad, the instance gives the pen position, the glyph id and the color,
+// and the box and texture rectangle of the glyph are read from the glyph table in the GlyphBuffer.
+// GlyphTableClass::ExpandVertex does the same on the CPU.
+
+cbuffer PerFrameBuffer
+{
+    matrix worldMatrix;
+    matrix viewMatrix;
+    matrix projectionMatrix;
+};
+
+// Two float4 per glyph: the box (left, top, width, height) in pixels from the pen and the texture rectangle (u0, v0, u1, v1).
+// The size must match GLYPH_TABLE_MAX_GLYPHS.
+cbuffer GlyphBuffer
+{
+    float4 glyphs[256 * 2];
+};
+
+struct VertexInputType
+{
+    float2 corner			: POSITION;
+    float2 instancePosition : TEXCOORD1;
+    uint   instanceGlyph	: TEXCOORD2;
+    float4 instanceColor	: COLOR0;
+};
+
+struct PixelInputType
+{
+    float4 position : SV_POSITION;
+    float2 tex		: TEXCOORD0;
+    float4 color	: COLOR0;
+};
+
+// Vertex Shader
+PixelInputType FontInstancingVertexShader(VertexInputType input)
+{
+    PixelInputType output;
+    float4 box, uv;
+    uint   id;
+
+    // Keep the glyph id inside the table.
+    id  = min(input.instanceGlyph, 255);
+    box = glyphs[id * 2];
+    uv  = glyphs[id * 2 + 1];
+
+    // Place the corner in the box of the glyph, the box goes down from the pen while the screen y goes up.
+    output.position.x = input.instancePosition.x + box.x + input.corner.x * box.z;
+    output.position.y = input.instancePosition.y - box.y - input.corner.y * box.w;
+    output.position.z = 0.0f;
+    output.position.w = 1.0f;
+
+    // Calculate the position of the vertex against the world, view, and projection matrices.
+    output.position = mul(output.position, worldMatrix);
+    output.position = mul(output.position, viewMatrix);
+    output.position = mul(output.position, projectionMatrix);
+
+    // The same corner in the texture rectangle of the glyph.
+    output.tex = lerp(uv.xy, uv.zw, input.corner);
+
+    // The color is unpacked from 8 bits per channel by the input assembler.
+    output.color = input.instanceColor;
+
+    return output;
+}
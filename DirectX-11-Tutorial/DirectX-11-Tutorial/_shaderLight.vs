@@ -1,16 +1,32 @@
-cbuffer MatrixBuffer
+// The shader is compiled in variants (ShaderPermutationClass), the features are defined to 1 or 0 in front of the source:
+// SPECULAR	  - the view direction is computed for the specular highlight of the pixel shader
+// INSTANCING - the world matrix comes with every instance, from the second vertex buffer, instead of the object buffer
+// CLUSTERED_LIGHTS - the world position and the view depth are passed on, for the point and spot lights of the pixel shader
+#ifndef SPECULAR
+#define SPECULAR 1
+#endif
+
+#ifndef INSTANCING
+#define INSTANCING 0
+#endif
+
+#ifndef CLUSTERED_LIGHTS
+#define CLUSTERED_LIGHTS 0
+#endif
+
+// The view, the projection and the camera change once per frame, the world matrix with every object.
+// In this shader we require the position of the camera to determine where this vertex is being viewed from for specular light calculations.
+cbuffer FrameBuffer : register(b0)
 {
-    matrix worldMatrix;
     matrix viewMatrix;
     matrix projectionMatrix;
+	float3 cameraPosition;
+	float  padding;
 };
 
-// We add a new constant buffer to hold camera information.
-// In this shader we require the position of the camera to determine where this vertex is being viewed from for specular light calculations.
-cbuffer CameraBuffer
+cbuffer ObjectBuffer : register(b1)
 {
-	float3 cameraPosition;
-	float  padding;
+    matrix worldMatrix;
 };
 
 // Both structures now have a 3 float normal vector.
@@ -21,6 +37,13 @@ struct VertexInputType
     float4 position : POSITION;
     float2 tex		: TEXCOORD0;
     float3 normal	: NORMAL;
+#if INSTANCING
+	// The rows of the world matrix of the instance (not transposed)
+	float4 world0	: WORLD0;
+	float4 world1	: WORLD1;
+	float4 world2	: WORLD2;
+	float4 world3	: WORLD3;
+#endif
 };
 
 // The PixelInputType structure is modified as the viewing direction needs to be calculated in the vertex shader and then sent into the pixel shader
@@ -30,7 +53,13 @@ struct PixelInputType
     float4 position		 : SV_POSITION;
     float2 tex			 : TEXCOORD0;
     float3 normal		 : NORMAL;
+#if SPECULAR
 	float3 viewDirection : TEXCOORD1;		// new
+#endif
+#if CLUSTERED_LIGHTS
+	float3 worldPosition : TEXCOORD2;
+	float  viewDepth	 : TEXCOORD3;
+#endif
 };
 
 
@@ -40,13 +69,26 @@ PixelInputType LightVertexShader(VertexInputType input)
 {
     PixelInputType output;
 	float4		   worldPosition;
+	float4x4	   world;
+
+#if INSTANCING
+	world = float4x4(input.world0, input.world1, input.world2, input.world3);
+#else
+	world = worldMatrix;
+#endif
 
     // Change the position vector to be 4 units for proper matrix calculations.
     input.position.w = 1.0f;
 
     // Calculate the position of the vertex against the world, view, and projection matrices.
-    output.position = mul(input.position,  worldMatrix);
+    output.position = mul(input.position,  world);
+#if CLUSTERED_LIGHTS
+	output.worldPosition = output.position.xyz;
+#endif
     output.position = mul(output.position, viewMatrix);
+#if CLUSTERED_LIGHTS
+	output.viewDepth = output.position.z;
+#endif
     output.position = mul(output.position, projectionMatrix);
     
     // Store the texture coordinates for the pixel shader.
@@ -55,12 +97,13 @@ PixelInputType LightVertexShader(VertexInputType input)
 	// The normal vector for this vertex is calculated in world space and then is normalized before being sent as input into the pixel shader.
 
     // Calculate the normal vector against the world matrix only.
-    output.normal = mul(input.normal, (float3x3)worldMatrix);
+    output.normal = mul(input.normal, (float3x3)world);
 	
     // Normalize the normal vector.
     output.normal = normalize(output.normal);
 
 
+#if SPECULAR
 	// for Specular Lighting calculation:
 
 	// The viewing direction is calculated here in the vertex shader.
@@ -68,13 +111,14 @@ PixelInputType LightVertexShader(VertexInputType input)
 	// The final value is normalized and sent into the pixel shader.
 
 	// Calculate the position of the vertex in the world.
-	worldPosition = mul(input.position, worldMatrix);
+	worldPosition = mul(input.position, world);
 
 	// Determine the viewing direction based on the position of the camera and the position of the vertex in the world.
 	output.viewDirection = cameraPosition.xyz - worldPosition.xyz;
 
 	// Normalize the viewing direction vector.
 	output.viewDirection = normalize(output.viewDirection);
+#endif
 
     return output;
 }
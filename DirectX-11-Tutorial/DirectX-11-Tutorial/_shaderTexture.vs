@@ -1,10 +1,19 @@
-cbuffer MatrixBuffer
+// The constant buffers are split by how often they change:
+// the view and projection are the same for all the objects of a frame, only the world matrix changes from one draw to the next.
+cbuffer FrameBuffer : register(b0)
 {
-    matrix worldMatrix;
     matrix viewMatrix;
     matrix projectionMatrix;
 };
 
+cbuffer ObjectBuffer : register(b1)
+{
+    matrix worldMatrix;
+};
+
+// The world matrices of a large set of objects drawn with one call, indexed by the instance id.
+StructuredBuffer<matrix> objectMatrices : register(t0);
+
 struct VertexInputType
 {
     float4 position : POSITION;
@@ -36,3 +45,19 @@ PixelInputType TextureVertexShader(VertexInputType input)
     
     return output;
 }
+
+// Vertex Shader for the object sets: the same as above, with the world matrix of the instance taken from the structured buffer
+PixelInputType TextureObjectsVertexShader(VertexInputType input, uint instance : SV_InstanceID)
+{
+    PixelInputType output;
+
+    input.position.w = 1.0f;
+
+    output.position = mul(input.position,  objectMatrices[instance]);
+    output.position = mul(output.position, viewMatrix);
+    output.position = mul(output.position, projectionMatrix);
+
+    output.tex = input.tex;
+
+    return output;
+}
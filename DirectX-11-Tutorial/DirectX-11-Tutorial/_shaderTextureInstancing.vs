@@ -14,12 +14,16 @@ struct VertexInputType
 	float4 position			: POSITION;
 	float2 tex				: TEXCOORD0;
 	float3 instancePosition : TEXCOORD1;
+	float  instanceSize		: TEXCOORD2;
+	float4 instanceColor	: COLOR0;
+	float4 instanceUV		: TEXCOORD3;
 };
 
 struct PixelInputType
 {
 	float4 position : SV_POSITION;
 	float2 tex		: TEXCOORD0;
+	float4 color	: COLOR0;
 };
 
 // Vertex Shader
@@ -70,8 +74,11 @@ PixelInputType TextureVertexShader(VertexInputType input)
 	//sincos(input.instancePosition.z, Sin, Cos);
 	//float4 rotation = float4(Cos, -Sin, Sin, Cos);
 
-	output.position.x = input.position.x * Cos - input.position.y * Sin;
-	output.position.y = input.position.x * Sin + input.position.y * Cos;
+	// Scale the quad by the size of the instance before rotating it.
+	float2 pos = input.position.xy * input.instanceSize;
+
+	output.position.x = pos.x * Cos - pos.y * Sin;
+	output.position.y = pos.x * Sin + pos.y * Cos;
 
 	output.position.z = 1.0f;
 	output.position.w = 1.0f;
@@ -87,7 +94,11 @@ PixelInputType TextureVertexShader(VertexInputType input)
 
 
 	// Store the texture coordinates for the pixel shader.
-	output.tex = input.tex;
+	// The quad is mapped 0..1 across the texture, the instance rectangle moves it to the right frame of the sprite sheet.
+	output.tex = input.instanceUV.xy + input.tex * input.instanceUV.zw;
+
+	// The instance color is passed on to the pixel shader, where it tints the texture.
+	output.color = input.instanceColor;
 
 //	output.position.x += input.instancePosition.x;
 //	output.position.y += input.instancePosition.y;
@@ -0,0 +1,36 @@
+// --------------------------------------------------------------------------------------------------------
+// The clock of the benchmarks, in milliseconds, and the best of a few runs of a piece of work.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _BENCHMARKCLOCK_H_
+#define _BENCHMARKCLOCK_H_
+
+#include <stdio.h>
+#include <chrono>
+
+static double GetBenchmarkClock()
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The fastest of the runs, the others were slowed down by something else
+template <class WorkType>
+static double TimeBest(int runs, WorkType work)
+{
+	double best = 1e30;
+
+	for (int i = 0; i < runs; i++) {
+		double start = GetBenchmarkClock();
+
+		work();
+
+		double time = GetBenchmarkClock() - start;
+
+		if (time < best)
+			best = time;
+	}
+
+	return best;
+}
+
+#endif
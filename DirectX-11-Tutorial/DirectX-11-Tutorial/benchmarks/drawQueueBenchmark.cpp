@@ -0,0 +1,104 @@
+// DrawQueueClass with 100000 draws of 16 shaders, 256 textures and 2 states over 4 passes, added in a random order:
+// the state changes in the order they were added against the ones of the sorted order, and the time of the sort
+// and of the submission into a context that does nothing.
+
+#include "__benchmarkClock.h"
+#include "__drawQueueClass.h"
+
+#include <string.h>
+
+#define DRAWS	 100000
+#define SHADERS	 16
+#define TEXTURES 256
+#define PASSES	 4
+#define RUNS	 20
+
+// The calls go nowhere, only the queue is timed
+class NullContextClass : public RenderContextClass {
+ public:
+	bool UpdateBuffer(HandleType, const void *, int) { return true; }
+	void SetRenderTarget(HandleType) {}
+	void Clear(const float *) {}
+	void SetState(HandleType) {}
+	void SetShaders(HandleType, HandleType) {}
+	void SetVertexBuffers(int, int, const HandleType *, const unsigned int *, const unsigned int *) {}
+	void SetIndexBuffer(HandleType) {}
+	void SetConstantBuffers(int, int, int, const HandleType *) {}
+	void SetTextures(int, int, int, const HandleType *) {}
+	void Draw(int, int) {}
+	void DrawIndexed(int, int, int) {}
+	void DrawInstanced(int, int, int, int) {}
+	void DrawIndexedInstanced(int, int, int, int, int) {}
+};
+
+static unsigned int s_random = 12345;
+
+static unsigned int Random()
+{
+	s_random = s_random * 1664525 + 1013904223;
+
+	return s_random >> 8;
+}
+
+static void PrintChanges(const char *name, const DrawQueueClass::StatisticsType &statistics)
+{
+	printf("%-8s targets %6d, states %6d, shaders %6d, textures %6d, calls %7d\n", name,
+		   statistics.targets, statistics.states, statistics.shaders, statistics.textures, statistics.calls);
+}
+
+int main()
+{
+	DrawQueueClass				   queue;
+	NullContextClass			   context;
+	DrawQueueClass::StatisticsType submitted, added;
+	float						   constants[16];
+
+	memset(constants, 0, sizeof(constants));
+
+	for (int pass = 0; pass < PASSES; pass++)
+		queue.SetPassTarget(pass, pass);
+
+	// The draws of the frame, the opaque ones with the first state, the blended ones with the second
+	double fill = TimeBest(RUNS, [&]() {
+		s_random = 12345;
+		queue.Reset();
+
+		for (int i = 0; i < DRAWS; i++) {
+			DrawQueueClass::DrawType draw;
+			int						 pass	 = Random() % PASSES;
+			bool					 blended = Random() % 4 == 0;
+			int						 shader	 = 1 + Random() % SHADERS;
+			int						 texture = 1 + Random() % TEXTURES;
+
+			memset(&draw, 0, sizeof(draw));
+			draw.state				   = blended ? 2 : 1;
+			draw.vertexShader		   = shader;
+			draw.pixelShader		   = shader;
+			draw.vertexBufferCount	   = 1;
+			draw.vertexBuffers[0]	   = 1;
+			draw.strides[0]			   = 20;
+			draw.constantBuffers[0][0] = 1;
+			draw.textures[0]		   = texture;
+			draw.constantBuffer		   = 1;
+			draw.count				   = 6;
+
+			queue.AddDraw(DrawQueueClass::MakeKey(pass, blended, shader, texture, (Random() % 10000) / 10000.0f), draw, constants, sizeof(constants));
+		}
+	});
+
+	// A radix sort takes the same time whatever order the keys are in, sorting them again times it as well
+	double sort	  = TimeBest(RUNS, [&]() { queue.Sort(); });
+	double submit = TimeBest(RUNS, [&]() { queue.Submit(&context); });
+
+	queue.GetStatistics(&submitted, &added);
+
+	printf("%d draws\n", queue.GetDrawCount());
+	PrintChanges("added:", added);
+	PrintChanges("sorted:", submitted);
+	printf("calls saved: %.1f%%\n", 100.0 * (added.calls - submitted.calls) / added.calls);
+	printf("fill:   %7.3f ms\n", fill);
+	printf("sort:   %7.3f ms, %6.1f M draws/s\n", sort, DRAWS / sort / 1000.0);
+	printf("submit: %7.3f ms, %6.1f M draws/s\n", submit, DRAWS / submit / 1000.0);
+
+	return 0;
+}
@@ -0,0 +1,113 @@
+// LightClusterClass with the clusters of ClusteredLightsClass (16 x 9 x 24, 256 lights a cluster): the binning of
+// 1000 to 16000 point and spot lights on 1 to 4 threads, against the brute force that tests every light against every cluster box.
+
+#include "__benchmarkClock.h"
+#include "__lightClusterClass.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+using namespace std;
+
+#define RUNS 10
+
+static float Random(float low, float high)
+{
+	return low + (high - low) * (float)rand() / RAND_MAX;
+}
+
+static void MakeLights(vector<ClusterLightType> *lights, int count)
+{
+	lights->resize(count);
+
+	for (int i = 0; i < count; i++) {
+		ClusterLightType &light = (*lights)[i];
+
+		light.position[0]  = Random(-100.0f, 100.0f);
+		light.position[1]  = Random(-20.0f, 20.0f);
+		light.position[2]  = Random(0.0f, 200.0f);
+		light.range		   = Random(2.0f, 10.0f);
+		light.color[0]	   = light.color[1] = light.color[2] = 1.0f;
+		light.spotCos	   = i % 2 ? 0.9f : -1.0f;
+		light.direction[0] = 0.0f;
+		light.direction[1] = -1.0f;
+		light.direction[2] = 0.0f;
+		light.padding	   = 0.0f;
+	}
+}
+
+// The brute force: every light against every cluster box, the count of the pairs
+static int BruteForce(LightClusterClass *clusters, const vector<ClusterLightType> &lights, const float *view)
+{
+	vector<float> spheres(lights.size() * 4);
+	float		  min[3], max[3], d, distance2;
+	int			  pairs = 0;
+
+	for (size_t l = 0; l < lights.size(); l++)
+		LightClusterClass::GetBoundingSphere(lights[l], view, &spheres[l * 4]);
+
+	for (int c = 0; c < clusters->GetClusterCount(); c++) {
+		clusters->GetClusterBounds(c, min, max);
+
+		for (size_t l = 0; l < lights.size(); l++) {
+			const float *sphere = &spheres[l * 4];
+
+			distance2 = 0.0f;
+
+			for (int k = 0; k < 3; k++) {
+				d = sphere[k] < min[k] ? min[k] - sphere[k] : (sphere[k] > max[k] ? sphere[k] - max[k] : 0.0f);
+				distance2 += d * d;
+			}
+
+			pairs += distance2 <= sphere[3] * sphere[3];
+		}
+	}
+
+	return pairs;
+}
+
+int main()
+{
+	int						 lightCounts[4] = { 1000, 4000, 8000, 16000 };
+	int						 threads[3]		= { 1, 2, 4 };
+	vector<ClusterLightType> lights;
+	float					 view[16] = { 1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1 };
+
+	srand(1);
+
+	for (int n = 0; n < 4; n++) {
+		MakeLights(&lights, lightCounts[n]);
+
+		printf("%5d lights:", lightCounts[n]);
+
+		for (int t = 0; t < 3; t++) {
+			LightClusterClass clusters;
+
+			clusters.Initialize(16, 9, 24, 256, threads[t]);
+			clusters.SetFrustum(0.7363797f, 0.41421356f, 0.1f, 1000.0f);
+
+			double time = TimeBest(RUNS, [&]() { clusters.Bin(&lights[0], lightCounts[n], view); });
+
+			printf("  %d thread(s) %7.3f ms", threads[t], time);
+
+			if (t == 2)
+				printf(" (%d pairs, %d dropped)", clusters.GetIndexCount(), clusters.GetDroppedCount());
+
+			clusters.Shutdown();
+		}
+
+		LightClusterClass clusters;
+		int				  pairs = 0;
+
+		clusters.Initialize(16, 9, 24, 256, 1);
+		clusters.SetFrustum(0.7363797f, 0.41421356f, 0.1f, 1000.0f);
+
+		double time = TimeBest(2, [&]() { pairs = BruteForce(&clusters, lights, view); });
+
+		printf("  brute force %8.3f ms (%d pairs)\n", time, pairs);
+
+		clusters.Shutdown();
+	}
+
+	return 0;
+}
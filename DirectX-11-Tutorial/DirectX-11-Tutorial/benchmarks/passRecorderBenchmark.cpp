@@ -0,0 +1,149 @@
+// PassRecorderClass on a HeadlessBackendClass: 16 passes of 5000 indexed draws, each draw writing its own matrix into
+// the constant buffer, recorded into the command stream by 1, 2, 4 and 8 threads against the same passes recorded
+// one after the other straight into the backend. The streams are compared too, they have to be the same.
+
+#include "__benchmarkClock.h"
+#include "__passRecorderClass.h"
+#include "__spritePassClass.h"
+#include "__headlessBackendClass.h"
+
+#include <string.h>
+#include <thread>
+
+#define PASSES 16
+#define DRAWS  5000
+#define RUNS   10
+
+struct SceneType {
+	RenderBackendClass::HandleType vertexShader, pixelShader, state, texture;
+	RenderBackendClass::HandleType vertexBuffer, indexBuffer, constantBuffer;
+};
+
+struct PassDataType {
+	const SceneType *scene;
+	int				 index;
+};
+
+static bool CreateScene(RenderBackendClass *backend, SceneType *scene)
+{
+	RenderBackendClass::TextureDescType textureDesc = { 2, 2, RENDER_FORMAT_RGBA8, false };
+	RenderBackendClass::StateDescType	stateDesc	= { false, true, true, true };
+	RenderBackendClass::BufferDescType	bufferDesc	= { RENDER_BUFFER_VERTEX, 36 * 5 * sizeof(float), 0, false };
+	unsigned char						texels[16];
+	float								vertices[36 * 5];
+	unsigned int						indices[36];
+
+	memset(texels, 255, sizeof(texels));
+	memset(vertices, 0, sizeof(vertices));
+
+	for (int i = 0; i < 36; i++)
+		indices[i] = i;
+
+	scene->texture		= backend->CreateTexture(textureDesc, texels, 8);
+	scene->state		= backend->CreateState(stateDesc);
+	scene->vertexBuffer = backend->CreateBuffer(bufferDesc, vertices);
+
+	bufferDesc.type = RENDER_BUFFER_INDEX;
+	bufferDesc.size = sizeof(indices);
+	scene->indexBuffer = backend->CreateBuffer(bufferDesc, indices);
+
+	bufferDesc.type	   = RENDER_BUFFER_CONSTANT;
+	bufferDesc.size	   = 16 * sizeof(float);
+	bufferDesc.dynamic = true;
+	scene->constantBuffer = backend->CreateBuffer(bufferDesc, 0);
+
+	return SpritePassClass::CreateShaders(backend, 0, 0, 0, 0, &scene->vertexShader, &scene->pixelShader) &&
+		   scene->texture && scene->state && scene->vertexBuffer && scene->indexBuffer && scene->constantBuffer;
+}
+
+// A pass of the benchmark: its bindings once, then a matrix and an indexed draw for every object
+static void RecordPass(RenderContextClass *context, void *data)
+{
+	const PassDataType *pass  = (const PassDataType*)data;
+	const SceneType	   *scene = pass->scene;
+	unsigned int		stride = 5 * sizeof(float), offset = 0;
+	float				matrix[16];
+
+	memset(matrix, 0, sizeof(matrix));
+
+	context->SetRenderTarget(0);
+	context->SetState(scene->state);
+	context->SetShaders(scene->vertexShader, scene->pixelShader);
+	context->SetVertexBuffers(0, 1, &scene->vertexBuffer, &stride, &offset);
+	context->SetIndexBuffer(scene->indexBuffer);
+	context->SetConstantBuffers(RENDER_STAGE_VERTEX, 0, 1, &scene->constantBuffer);
+	context->SetTextures(RENDER_STAGE_PIXEL, 0, 1, &scene->texture);
+
+	for (int i = 0; i < DRAWS; i++) {
+		matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1.0f;
+		matrix[12] = (float)pass->index;
+		matrix[13] = (float)i;
+
+		context->UpdateBuffer(scene->constantBuffer, matrix, sizeof(matrix));
+		context->DrawIndexed(36, 0, 0);
+	}
+}
+
+int main()
+{
+	HeadlessBackendClass direct;
+	SceneType			 directScene;
+	PassDataType		 directPasses[PASSES];
+
+	if (!CreateScene(&direct, &directScene))
+		return 1;
+
+	for (int i = 0; i < PASSES; i++) {
+		directPasses[i].scene = &directScene;
+		directPasses[i].index = i;
+	}
+
+	// The serial recording: the passes one after the other, the back buffer bound again after each like after a deferred context
+	double serial = TimeBest(RUNS, [&]() {
+		direct.GetStream()->Clear();
+
+		for (int i = 0; i < PASSES; i++) {
+			RecordPass(&direct, &directPasses[i]);
+			direct.SetRenderTarget(0);
+		}
+	});
+
+	printf("%d passes of %d draws, %u hardware threads\n", PASSES, DRAWS, thread::hardware_concurrency());
+	printf("serial:    %8.3f ms, %6.1f ns/draw\n", serial, serial * 1e6 / (PASSES * DRAWS));
+
+	int threadCounts[4] = { 1, 2, 4, 8 };
+
+	for (int t = 0; t < 4; t++) {
+		HeadlessBackendClass recorded;
+		SceneType			 recordedScene;
+		PassDataType		 recordedPasses[PASSES];
+		PassRecorderClass	 recorder;
+
+		if (!CreateScene(&recorded, &recordedScene) || !recorder.Initialize(&recorded, threadCounts[t]))
+			return 1;
+
+		for (int i = 0; i < PASSES; i++) {
+			recordedPasses[i].scene = &recordedScene;
+			recordedPasses[i].index = i;
+			recorder.AddPass(RecordPass, &recordedPasses[i]);
+		}
+
+		double time = TimeBest(RUNS, [&]() {
+			recorded.GetStream()->Clear();
+			recorder.Record();
+		});
+
+		bool same = recorded.GetStream()->GetSize() == direct.GetStream()->GetSize() &&
+					memcmp(recorded.GetStream()->GetData(), direct.GetStream()->GetData(), direct.GetStream()->GetSize()) == 0;
+
+		printf("%d thread%s: %8.3f ms, %6.1f ns/draw, %.2fx serial, stream %s\n", threadCounts[t], threadCounts[t] > 1 ? "s" : " ",
+			   time, time * 1e6 / (PASSES * DRAWS), serial / time, same ? "same" : "DIFFERENT");
+
+		recorder.Shutdown();
+		recorded.Shutdown();
+	}
+
+	direct.Shutdown();
+
+	return 0;
+}
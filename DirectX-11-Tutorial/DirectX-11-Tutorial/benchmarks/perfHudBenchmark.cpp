@@ -0,0 +1,78 @@
+// The cost of the performance HUD, against its budget of 0.1 ms of CPU a frame: the HeadlessRunnerClass frames of particles
+// with and without the HUD, recorded by the headless backend (the CPU side of a frame, what PerfHudClass adds to it)
+// and drawn by the software backend. The HUD time is measured around the HUD alone, from its statistics to its draw.
+
+#include "__headlessRunnerClass.h"
+
+#include <stdio.h>
+#include <algorithm>
+using namespace std;
+
+#define FRAMES	   600
+#define STEP	   (1000.0f / 60.0f)
+#define BUDGET_MS  0.1
+
+static bool Measure(int mode, int frames, bool hud, double *render, double *hudMean, double *hudMax, int *draws)
+{
+	HeadlessRunnerClass runner;
+	bool				result;
+
+	result = runner.Initialize(mode, 800, 600, 4, 100000);
+	if (result) {
+		runner.SetHudEnabled(hud);
+		result = runner.Run(frames, STEP, 0);
+	}
+
+	*render	 = 0.0;
+	*hudMean = 0.0;
+	*hudMax	 = 0.0;
+	*draws	 = 0;
+
+	// The first frames fill the caches and the pools, they are left out
+	for (int i = 10; result && i < runner.GetFrameCount(); i++) {
+		const HeadlessRunnerClass::FrameType &frame = runner.GetFrame(i);
+
+		*render	 += frame.renderTime;
+		*hudMean += frame.hudTime;
+		*hudMax	  = max(*hudMax, frame.hudTime);
+		*draws	  = max(*draws, frame.draws);
+	}
+
+	*render	 /= frames - 10;
+	*hudMean /= frames - 10;
+
+	runner.Shutdown();
+
+	return result;
+}
+
+int main()
+{
+	const char *names[2]  = { "recorded", "software" };
+	int			modes[2]  = { HEADLESS_RUNNER_RECORD, HEADLESS_RUNNER_SOFTWARE };
+	int			frames[2] = { FRAMES, FRAMES / 10 };
+	bool		within	  = true;
+
+	printf("%-10s %6s %16s %16s %12s %12s %6s\n", "backend", "frames", "render ms, off", "render ms, on", "hud ms mean", "hud ms max", "draws");
+
+	for (int m = 0; m < 2; m++) {
+		double render[2], hudMean[2], hudMax[2];
+		int	   draws[2];
+
+		if (!Measure(modes[m], frames[m], false, &render[0], &hudMean[0], &hudMax[0], &draws[0]) ||
+			!Measure(modes[m], frames[m], true, &render[1], &hudMean[1], &hudMax[1], &draws[1])) {
+			printf("the %s run failed\n", names[m]);
+			return 1;
+		}
+
+		printf("%-10s %6d %16.4f %16.4f %12.4f %12.4f %3d/%-2d\n", names[m], frames[m], render[0], render[1], hudMean[1], hudMax[1], draws[0], draws[1]);
+
+		// The budget is for the CPU side, which the recorded frames are; the software backend also rasterizes the HUD
+		if (modes[m] == HEADLESS_RUNNER_RECORD)
+			within = hudMean[1] <= BUDGET_MS;
+	}
+
+	printf("the HUD is %s the budget of %.1f ms on the recorded frames\n", within ? "within" : "over", BUDGET_MS);
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+// SdfGeneratorClass on glyphs of the sizes GlyphAtlasClass uses as the SDF base size: the time to generate the field of one glyph,
+// and how far its distances are from the true ones. The glyph is a ring (an 'o'), antialiased with 8 x 8 samples a pixel,
+// whose distance to the outline is known exactly; the error is measured over the texels within the spread of the outline.
+
+#include "__benchmarkClock.h"
+#include "__sdfGeneratorClass.h"
+
+#include <math.h>
+#include <vector>
+using namespace std;
+
+#define RUNS 20
+
+static float RingDistance(float x, float y, float center, float outer, float inner)
+{
+	float radius = sqrtf((x - center) * (x - center) + (y - center) * (y - center));
+	float out	 = radius - outer;
+	float in	 = inner - radius;
+
+	return out > in ? out : in;
+}
+
+static void MakeRing(int size, float outer, float inner, vector<unsigned char> *coverage)
+{
+	float center = size * 0.5f;
+
+	coverage->resize(size * size);
+
+	for (int y = 0; y < size; y++)
+		for (int x = 0; x < size; x++) {
+			int inside = 0;
+
+			for (int sy = 0; sy < 8; sy++)
+				for (int sx = 0; sx < 8; sx++)
+					if (RingDistance(x + (sx + 0.5f) / 8.0f, y + (sy + 0.5f) / 8.0f, center, outer, inner) <= 0.0f)
+						inside++;
+
+			(*coverage)[y * size + x] = (unsigned char)((inside * 255 + 32) / 64);
+		}
+}
+
+int main()
+{
+	int sizes[] = { 16, 32, 48, 64, 128 };
+
+	printf("%6s %6s %12s %12s %14s %14s\n", "size", "spread", "ms/glyph", "glyphs/s", "max error px", "mean error px");
+
+	for (int s = 0; s < 5; s++) {
+		SdfGeneratorClass	  sdf;
+		vector<unsigned char> coverage, field;
+		int					  size	 = sizes[s];
+		int					  spread = size / 8 > 2 ? size / 8 : 2;
+		int					  width	 = size + 2 * spread;
+		float				  outer	 = size * 0.4f;
+		float				  inner	 = size * 0.2f;
+
+		MakeRing(size, outer, inner, &coverage);
+
+		double time = TimeBest(RUNS, [&]() { sdf.Generate(&coverage[0], size, size, spread, &field); });
+
+		const float *distances = sdf.GetDistances();
+		double		 worst = 0.0, total = 0.0;
+		int			 count = 0;
+
+		for (int y = 0; y < width; y++)
+			for (int x = 0; x < width; x++) {
+				float expected = RingDistance(x - spread + 0.5f, y - spread + 0.5f, size * 0.5f, outer, inner);
+
+				if (fabsf(expected) > spread)
+					continue;
+
+				double error = fabs(distances[y * width + x] - expected);
+
+				if (error > worst)
+					worst = error;
+
+				total += error;
+				count++;
+			}
+
+		printf("%6d %6d %12.4f %12.0f %14.3f %14.3f\n", size, spread, time, 1000.0 / time, worst, total / count);
+	}
+
+	return 0;
+}
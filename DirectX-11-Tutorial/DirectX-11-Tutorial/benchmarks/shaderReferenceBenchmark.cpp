@@ -0,0 +1,173 @@
+// ShaderReferenceClass: the cost of the pixel shaders a pixel, over a million pixels in 2x2 quads, for the light variants
+// of ShaderPermutationClass (the clustered one with 8 lights a cluster) and the texture and font shaders.
+
+#include "__benchmarkClock.h"
+#include "__shaderReferenceClass.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+using namespace std;
+
+#define QUADS 262144
+#define RUNS  5
+
+typedef ShaderReferenceClass				SR;
+typedef ShaderReferenceClass::ConstantsType ConstantsType;
+
+static float Random(float low, float high)
+{
+	return low + (high - low) * (float)rand() / RAND_MAX;
+}
+
+static __m128 RandomLanes(float low, float high)
+{
+	return _mm_setr_ps(Random(low, high), Random(low, high), Random(low, high), Random(low, high));
+}
+
+int main()
+{
+	vector<SR::LightPixelType>	 lightPixels(QUADS);
+	vector<SR::TexturePixelType> texturePixels(QUADS);
+	vector<float>				 texels(256 * 256 * 4);
+	SR::TextureType				 texture = { 256, 256, 0 };
+	SR::Float4Type				 out;
+	float						 sink = 0.0f;
+
+	srand(1);
+
+	for (size_t i = 0; i < texels.size(); i++)
+		texels[i] = Random(0.0f, 1.0f);
+
+	texture.texels = &texels[0];
+
+	// A screen of 1024 x 1024 pixels, normals and view directions of all sorts
+	for (int q = 0; q < QUADS; q++) {
+		SR::LightPixelType &pixel = lightPixels[q];
+		float				x = (float)(q % 512 * 2), y = (float)(q / 512 * 2);
+
+		pixel.position.x = _mm_setr_ps(x, x + 1, x, x + 1);
+		pixel.position.y = _mm_setr_ps(y, y, y + 1, y + 1);
+		pixel.position.z = _mm_set1_ps(0.5f);
+		pixel.position.w = _mm_set1_ps(1.0f);
+		pixel.tex.x		 = _mm_set1_ps(x / 1024.0f);
+		pixel.tex.y		 = _mm_set1_ps(y / 1024.0f);
+		pixel.normal.x	 = RandomLanes(-0.6f, 0.6f);
+		pixel.normal.y	 = RandomLanes(-0.6f, 0.6f);
+		pixel.normal.z	 = RandomLanes(-0.6f, 0.6f);
+		pixel.viewDirection = pixel.normal;
+		pixel.worldPosition.x = RandomLanes(-50.0f, 50.0f);
+		pixel.worldPosition.y = RandomLanes(-5.0f, 5.0f);
+		pixel.worldPosition.z = RandomLanes(-50.0f, 50.0f);
+		pixel.viewDepth		  = RandomLanes(1.0f, 100.0f);
+
+		texturePixels[q].position = pixel.position;
+		texturePixels[q].tex	  = pixel.tex;
+		texturePixels[q].color.x  = texturePixels[q].color.y = texturePixels[q].color.z = texturePixels[q].color.w = _mm_set1_ps(1.0f);
+	}
+
+	ConstantsType::LightBufferType light;
+
+	light.ambientColor.x   = light.ambientColor.y = light.ambientColor.z = 0.15f;
+	light.ambientColor.w   = 1.0f;
+	light.diffuseColor.x   = light.diffuseColor.y = light.diffuseColor.z = light.diffuseColor.w = 1.0f;
+	light.specularColor	   = light.diffuseColor;
+	light.lightDirection.x = 0.0f;
+	light.lightDirection.y = -0.6f;
+	light.lightDirection.z = 0.8f;
+	light.specularPower	   = 32.0f;
+
+	// 16 x 16 x 4 clusters of 8 lights each, from 64 lights
+	vector<ClusterLightType> lights(64);
+	vector<unsigned int>	 grid(16 * 16 * 4 * 2), indices(16 * 16 * 4 * 8);
+	SR::ClusterResourcesType clusters;
+
+	for (size_t i = 0; i < lights.size(); i++) {
+		ClusterLightType &l = lights[i];
+
+		l.position[0]  = Random(-50.0f, 50.0f);
+		l.position[1]  = Random(0.0f, 10.0f);
+		l.position[2]  = Random(-50.0f, 50.0f);
+		l.range		   = 20.0f;
+		l.color[0]	   = l.color[1] = l.color[2] = 0.2f;
+		l.spotCos	   = i % 2 ? 0.8f : -1.0f;
+		l.direction[0] = 0.0f;
+		l.direction[1] = -1.0f;
+		l.direction[2] = 0.0f;
+		l.padding	   = 0.0f;
+	}
+
+	for (int c = 0; c < 16 * 16 * 4; c++) {
+		grid[c * 2]		= c * 8;
+		grid[c * 2 + 1] = 8;
+
+		for (int i = 0; i < 8; i++)
+			indices[c * 8 + i] = (c + i * 7) % 64;
+	}
+
+	clusters.constants.tileScale[0]		= 16.0f / 1024.0f;
+	clusters.constants.tileScale[1]		= 16.0f / 1024.0f;
+	clusters.constants.depthScale		= 4.0f / logf(100.0f);
+	clusters.constants.depthBias		= 0.0f;
+	clusters.constants.clusterCounts[0] = 16;
+	clusters.constants.clusterCounts[1] = 16;
+	clusters.constants.clusterCounts[2] = 4;
+	clusters.constants.lightCount		= 64;
+	clusters.lights						= &lights[0];
+	clusters.grid						= &grid[0];
+	clusters.indices					= &indices[0];
+
+	struct {
+		const char		  *name;
+		unsigned long long features;
+	} variants[5] = {
+		{ "light",							0 },
+		{ "light + texture",				SHADER_FEATURE_TEXTURE },
+		{ "light + texture + specular",		SHADER_FEATURE_TEXTURE | SHADER_FEATURE_SPECULAR },
+		{ "light + ... + alpha test",		SHADER_FEATURE_TEXTURE | SHADER_FEATURE_SPECULAR | SHADER_FEATURE_ALPHA_TEST },
+		{ "light + ... + clustered lights", SHADER_FEATURE_TEXTURE | SHADER_FEATURE_SPECULAR | SHADER_FEATURE_CLUSTERED_LIGHTS },
+	};
+
+	printf("%d pixels\n", QUADS * 4);
+
+	for (int v = 0; v < 5; v++) {
+		double time = TimeBest(RUNS, [&]() {
+			for (int q = 0; q < QUADS; q++) {
+				SR::LightPixelShader(variants[v].features, light, &texture, &clusters, lightPixels[q], &out);
+				sink += _mm_cvtss_f32(out.x);
+			}
+		});
+
+		printf("%-32s %6.2f ns a pixel\n", variants[v].name, time * 1.0e6 / (QUADS * 4));
+	}
+
+	double time = TimeBest(RUNS, [&]() {
+		for (int q = 0; q < QUADS; q++) {
+			SR::TexturePixelShader(texture, texturePixels[q], &out);
+			sink += _mm_cvtss_f32(out.x);
+		}
+	});
+
+	printf("%-32s %6.2f ns a pixel\n", "texture", time * 1.0e6 / (QUADS * 4));
+
+	time = TimeBest(RUNS, [&]() {
+		for (int q = 0; q < QUADS; q++) {
+			SR::FontPixelShader(texture, texturePixels[q], &out);
+			sink += _mm_cvtss_f32(out.w);
+		}
+	});
+
+	printf("%-32s %6.2f ns a pixel\n", "font", time * 1.0e6 / (QUADS * 4));
+
+	time = TimeBest(RUNS, [&]() {
+		for (int q = 0; q < QUADS; q++) {
+			SR::FontSdfPixelShader(texture, texturePixels[q], &out);
+			sink += _mm_cvtss_f32(out.w);
+		}
+	});
+
+	printf("%-32s %6.2f ns a pixel\n", "font, distance field", time * 1.0e6 / (QUADS * 4));
+
+	// Keeps the shading from being optimized away
+	return sink == 12345.0f ? 1 : 0;
+}
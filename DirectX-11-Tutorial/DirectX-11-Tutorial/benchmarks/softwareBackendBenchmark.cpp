@@ -0,0 +1,278 @@
+// SoftwareBackendClass drawing a 1280 x 720 frame: 40 lit cubes through the light shader twin, depth tested, then 20000 sprites
+// of SpritePassClass blended over them, on 1, 2, 4 and as many threads as the machine has. The time of the frame, the quads of pixels
+// shaded a second and the speedup over one thread; the pictures are compared with the one of one thread, they have to be the same.
+
+#include "__benchmarkClock.h"
+#include "__softwareBackendClass.h"
+#include "__spritePassClass.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+using namespace std;
+
+typedef RenderBackendClass					RB;
+typedef ShaderReferenceClass::ConstantsType ConstantsType;
+
+#define WIDTH	1280
+#define HEIGHT	720
+#define CUBES_X 8
+#define CUBES_Y 5
+#define SPRITES 20000
+#define RUNS	5
+
+struct LightVertexType {
+	float x, y, z;
+	float u, v;
+	float nx, ny, nz;
+};
+
+struct SceneType {
+	RB::HandleType lightVertexShader, lightPixelShader, spriteVertexShader, spritePixelShader;
+	RB::HandleType cubeBuffer, constants[3], texture, cubeState, spriteState;
+	SpritePassClass sprites;
+};
+
+static float Random(float low, float high)
+{
+	return low + (high - low) * (float)rand() / RAND_MAX;
+}
+
+// The unit cube, two clockwise triangles a face
+static void MakeCube(LightVertexType *vertices)
+{
+	static const float faces[6][3][3] = {
+		{ {  0.0f,  0.0f, -1.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ {  0.0f,  0.0f,  1.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { -1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ {  1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ {  0.0f, -1.0f,  0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+		{ {  0.0f,  1.0f,  0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+	};
+	static const float corners[6][2] = { { -1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f }, { -1.0f, -1.0f }, { 1.0f, 1.0f }, { 1.0f, -1.0f } };
+
+	for (int f = 0; f < 6; f++) {
+		const float *normal = faces[f][0];
+		const float *u		= faces[f][1];
+		const float *v		= faces[f][2];
+		float		 inward = (u[1] * v[2] - u[2] * v[1]) * normal[0] + (u[2] * v[0] - u[0] * v[2]) * normal[1] + (u[0] * v[1] - u[1] * v[0]) * normal[2];
+
+		for (int i = 0; i < 6; i++) {
+			LightVertexType &vertex = vertices[f * 6 + i];
+			float			 a		= corners[i][0] * 0.5f * (inward < 0.0f ? 1.0f : -1.0f);
+			float			 b		= corners[i][1] * 0.5f;
+
+			vertex.x  = normal[0] * 0.5f + u[0] * a + v[0] * b;
+			vertex.y  = normal[1] * 0.5f + u[1] * a + v[1] * b;
+			vertex.z  = normal[2] * 0.5f + u[2] * a + v[2] * b;
+			vertex.u  = vertex.v = 0.0f;
+			vertex.nx = normal[0];
+			vertex.ny = normal[1];
+			vertex.nz = normal[2];
+		}
+	}
+}
+
+// The world of a cube in pixels, turned around y and x and moved to its place; transposed, as the shader classes upload it
+static void CubeWorld(int index, ShaderReferenceClass::MatrixType *world)
+{
+	float size = 110.0f;
+	float a	   = 0.3f + index * 0.37f, b = 0.2f + index * 0.23f;
+	float ca   = cosf(a), sa = sinf(a), cb = cosf(b), sb = sinf(b);
+
+	// RotationY(a) * RotationX(b) * Scaling(size) * Translation, in the D3DX order
+	float rows[4][4] = {
+		{ ca * size,  sa * sb * size, -sa * cb * size, 0.0f },
+		{ 0.0f,		  cb * size,	   sb * size,	   0.0f },
+		{ sa * size, -ca * sb * size,  ca * cb * size, 0.0f },
+		{ ((index % CUBES_X) + 0.5f) * WIDTH / CUBES_X - WIDTH / 2, HEIGHT / 2 - ((index / CUBES_X) + 0.5f) * HEIGHT / CUBES_Y, 0.0f, 1.0f },
+	};
+
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			world->m[i][j] = rows[j][i];
+}
+
+static bool CreateScene(SoftwareBackendClass *backend, SceneType *scene, const vector<SpritePassClass::InstanceType> &instances)
+{
+	RB::VertexElementType elements[3] = {
+		{ "POSITION", 0,  6, 0,  0, false },
+		{ "TEXCOORD", 0, 16, 0, 12, false },
+		{ "NORMAL",	  0,  6, 0, 20, false },
+	};
+
+	RB::ShaderDescType	shaderDesc;
+	RB::BufferDescType	bufferDesc	= { RENDER_BUFFER_VERTEX, 36 * sizeof(LightVertexType), 0, false };
+	RB::TextureDescType textureDesc = { 32, 32, RENDER_FORMAT_RGBA8, false };
+	RB::StateDescType	cubeState	= { false, true, true, true };
+	RB::StateDescType	spriteState = { true, false, false, true };
+	LightVertexType		vertices[36];
+	unsigned char		texels[32 * 32 * 4];
+	int					sizes[3] = { sizeof(ConstantsType::LightFrameBufferType), sizeof(ConstantsType::LightObjectBufferType), sizeof(ConstantsType::LightBufferType) };
+
+	MakeCube(vertices);
+	scene->cubeBuffer = backend->CreateBuffer(bufferDesc, vertices);
+
+	bufferDesc.type	   = RENDER_BUFFER_CONSTANT;
+	bufferDesc.dynamic = true;
+
+	for (int i = 0; i < 3; i++) {
+		bufferDesc.size		 = sizes[i];
+		scene->constants[i] = backend->CreateBuffer(bufferDesc, 0);
+	}
+
+	memset(&shaderDesc, 0, sizeof(shaderDesc));
+	shaderDesc.stage		= RENDER_STAGE_VERTEX;
+	shaderDesc.entry		= "LightVertexShader";
+	shaderDesc.elements		= elements;
+	shaderDesc.elementCount = 3;
+	scene->lightVertexShader = backend->CreateShader(shaderDesc);
+
+	memset(&shaderDesc, 0, sizeof(shaderDesc));
+	shaderDesc.stage = RENDER_STAGE_PIXEL;
+	shaderDesc.entry = "LightPixelShader";
+	scene->lightPixelShader = backend->CreateShader(shaderDesc);
+
+	// The soft round dot of the particles
+	for (int y = 0; y < 32; y++)
+		for (int x = 0; x < 32; x++) {
+			float dx	= (x + 0.5f) / 16.0f - 1.0f;
+			float dy	= (y + 0.5f) / 16.0f - 1.0f;
+			float alpha = 1.0f - sqrtf(dx * dx + dy * dy);
+
+			texels[(y * 32 + x) * 4] = texels[(y * 32 + x) * 4 + 1] = texels[(y * 32 + x) * 4 + 2] = 255;
+			texels[(y * 32 + x) * 4 + 3] = (unsigned char)(alpha > 0.0f ? alpha * 255.0f : 0.0f);
+		}
+
+	scene->texture	   = backend->CreateTexture(textureDesc, texels, 32 * 4);
+	scene->cubeState   = backend->CreateState(cubeState);
+	scene->spriteState = backend->CreateState(spriteState);
+
+	if (!SpritePassClass::CreateShaders(backend, 0, 0, 0, 0, &scene->spriteVertexShader, &scene->spritePixelShader) ||
+		!scene->sprites.Initialize(backend, 16, SPRITES, scene->spriteVertexShader, scene->spritePixelShader, scene->texture, scene->spriteState))
+		return false;
+
+	scene->sprites.SetInstances(&instances[0], SPRITES);
+
+	return scene->cubeBuffer && scene->constants[0] && scene->constants[1] && scene->constants[2] &&
+		   scene->lightVertexShader && scene->lightPixelShader && scene->texture && scene->cubeState && scene->spriteState;
+}
+
+// A frame: the cubes one draw each with their own world matrix, then the sprites in one instanced draw
+static void DrawFrame(SoftwareBackendClass *backend, SceneType *scene)
+{
+	ConstantsType::LightFrameBufferType	 frame;
+	ConstantsType::LightObjectBufferType object;
+	ConstantsType::LightBufferType		 light;
+	SpritePassClass::MatrixBufferType	 matrices;
+	unsigned int						 stride = sizeof(LightVertexType), offset = 0;
+	float								 background[4] = { 0.1f, 0.1f, 0.2f, 1.0f };
+
+	memset(&frame, 0, sizeof(frame));
+	memset(&light, 0, sizeof(light));
+	memset(&matrices, 0, sizeof(matrices));
+
+	// Pixels from the middle of the screen, z from -200..200 into 0..1 (transposed: the translation is in the last column)
+	for (int i = 0; i < 4; i++) {
+		frame.view.m[i][i]		 = 1.0f;
+		frame.projection.m[i][i] = 1.0f;
+	}
+
+	frame.projection.m[0][0] = 2.0f / WIDTH;
+	frame.projection.m[1][1] = 2.0f / HEIGHT;
+	frame.projection.m[2][2] = 1.0f / 400.0f;
+	frame.projection.m[2][3] = 0.5f;
+
+	matrices.world		= frame.view;
+	matrices.view		= frame.view;
+	matrices.projection = frame.projection;
+
+	light.ambientColor.x   = light.ambientColor.y = light.ambientColor.z = 0.15f;
+	light.ambientColor.w   = 1.0f;
+	light.diffuseColor.x   = light.diffuseColor.y = light.diffuseColor.z = light.diffuseColor.w = 1.0f;
+	light.lightDirection.x = 0.3f;
+	light.lightDirection.y = -0.5f;
+	light.lightDirection.z = 0.81f;
+
+	backend->BeginFrame(background);
+
+	backend->UpdateBuffer(scene->constants[0], &frame, sizeof(frame));
+	backend->UpdateBuffer(scene->constants[2], &light, sizeof(light));
+
+	backend->SetRenderTarget(0);
+	backend->SetState(scene->cubeState);
+	backend->SetShaders(scene->lightVertexShader, scene->lightPixelShader);
+	backend->SetVertexBuffers(0, 1, &scene->cubeBuffer, &stride, &offset);
+	backend->SetConstantBuffers(RENDER_STAGE_VERTEX, 0, 2, scene->constants);
+	backend->SetConstantBuffers(RENDER_STAGE_PIXEL, 0, 1, &scene->constants[2]);
+
+	for (int i = 0; i < CUBES_X * CUBES_Y; i++) {
+		CubeWorld(i, &object.world);
+		backend->UpdateBuffer(scene->constants[1], &object, sizeof(object));
+		backend->Draw(36, 0);
+	}
+
+	scene->sprites.SetMatrices(matrices);
+	scene->sprites.Render(backend);
+
+	backend->EndFrame();
+}
+
+int main()
+{
+	vector<SpritePassClass::InstanceType> instances(SPRITES);
+	vector<unsigned char>				  reference(WIDTH * HEIGHT * 4), pixels(WIDTH * HEIGHT * 4);
+	int									  threadCounts[4] = { 1, 2, 4, (int)thread::hardware_concurrency() };
+	double								  single = 0.0;
+
+	for (int i = 0; i < SPRITES; i++) {
+		SpritePassClass::InstanceType &instance = instances[i];
+
+		instance.x		  = Random(-WIDTH * 0.5f, WIDTH * 0.5f);
+		instance.y		  = Random(-HEIGHT * 0.5f, HEIGHT * 0.5f);
+		instance.rotation = Random(0.0f, 6.2831853f);
+		instance.size	  = Random(0.5f, 2.0f);
+		instance.r		  = 1.0f;
+		instance.g		  = Random(0.3f, 1.0f);
+		instance.b		  = Random(0.0f, 0.5f);
+		instance.a		  = Random(0.3f, 1.0f);
+		instance.u		  = instance.v = 0.0f;
+		instance.uWidth	  = instance.vHeight = 1.0f;
+	}
+
+	printf("%d x %d, %d cubes and %d sprites, %u hardware threads\n", WIDTH, HEIGHT, CUBES_X * CUBES_Y, SPRITES, thread::hardware_concurrency());
+
+	for (int t = 0; t < 4; t++) {
+		SoftwareBackendClass backend;
+		SceneType			 scene;
+		int					 threads = threadCounts[t] > 0 ? threadCounts[t] : 1;
+
+		if (!backend.Initialize(WIDTH, HEIGHT, threads) || !CreateScene(&backend, &scene, instances))
+			return 1;
+
+		DrawFrame(&backend, &scene);
+		backend.ResetCounters();
+
+		double time = TimeBest(RUNS, [&]() { DrawFrame(&backend, &scene); });
+
+		DrawFrame(&backend, &scene);
+		backend.GetPixels(t == 0 ? &reference[0] : &pixels[0]);
+
+		int triangles = backend.GetTriangleCount() / (RUNS + 1);
+		int quads	  = backend.GetQuadCount() / (RUNS + 1);
+
+		if (t == 0)
+			single = time;
+
+		printf("%2d thread%s%s: %8.2f ms a frame, %d triangles, %d quads, %6.1f M quads/s, %.2fx one thread, picture %s\n",
+			   threads, threads > 1 ? "s" : " ", t == 3 ? " (all)" : "      ", time, triangles, quads, quads / time / 1000.0, single / time,
+			   t == 0 || pixels == reference ? "same" : "DIFFERENT");
+
+		scene.sprites.Shutdown();
+		backend.Shutdown();
+	}
+
+	return 0;
+}
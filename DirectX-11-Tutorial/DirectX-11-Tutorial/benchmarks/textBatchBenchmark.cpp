@@ -0,0 +1,237 @@
+// 1000 sentences on the screen, drawn through the HeadlessBackendClass, so the CPU side of a frame of text is timed without a GPU.
+// The batched text of TextOutClass: the sentences are updated, the TextBatchClass is written into the one instance buffer
+// and all the text goes out in a single instanced draw. Against it the text as it was before the batching:
+// every sentence with a buffer of its own, rewritten when it changed, and a draw with its color constant per sentence.
+// The frames are run with no sentence changed, with one in ten changed (a counter going up) and with all of them changed.
+
+#include "__benchmarkClock.h"
+#include "__headlessBackendClass.h"
+#include "__textBatchClass.h"
+
+#include <stdio.h>
+#include <vector>
+using namespace std;
+
+#define SENTENCES	  1000
+#define MAX_LENGTH	  24
+#define SCREEN_WIDTH  1920
+#define SCREEN_HEIGHT 1080
+#define FRAMES		  200
+
+typedef RenderBackendClass::HandleType HandleType;
+
+static void FillMetrics(FontMetricsClass *metrics)
+{
+	FontMetricsClass::GlyphMetricsType glyph;
+
+	for (int letter = 0; letter < 95; letter++) {
+		glyph.left	  = 0.0f;
+		glyph.top	  = 0.0f;
+		glyph.width	  = 5.0f + letter % 4;
+		glyph.height  = 16.0f;
+		glyph.visible = letter != 0;
+		glyph.advance = letter == 0 ? 3.0f : glyph.width + 1.0f;
+
+		metrics->AddGlyph(letter + 32, glyph);
+	}
+
+	metrics->SetLineMetrics(16.0f, 18.0f);
+}
+
+static void MakeText(char *text, int sentence, int value)
+{
+	sprintf(text, "Sentence %d: %d", sentence, value);
+}
+
+// The objects both ways of drawing use: the unit quad, the shaders, the state and the constant buffer
+struct SceneType {
+	HandleType quad, vertexShader, pixelShader, state, constants;
+};
+
+static void CreateScene(HeadlessBackendClass *backend, SceneType *scene)
+{
+	RenderBackendClass::BufferDescType buffer = { RENDER_BUFFER_VERTEX, 6 * 8, 0, false };
+	RenderBackendClass::ShaderDescType shader = { RENDER_STAGE_VERTEX, "FontInstancingVertexShader", 0, "", 1, 0, 0 };
+	RenderBackendClass::StateDescType  state  = { true, false, false, false };
+	float							   quad[12] = { 0, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1 };
+
+	scene->quad			= backend->CreateBuffer(buffer, quad);
+	scene->vertexShader = backend->CreateShader(shader);
+
+	shader.stage = RENDER_STAGE_PIXEL;
+	shader.entry = "FontPixelShader";
+	scene->pixelShader = backend->CreateShader(shader);
+	scene->state	   = backend->CreateState(state);
+
+	buffer.type	   = RENDER_BUFFER_CONSTANT;
+	buffer.size	   = 16;
+	buffer.dynamic = true;
+	scene->constants = backend->CreateBuffer(buffer, 0);
+}
+
+static void BindScene(HeadlessBackendClass *backend, const SceneType &scene)
+{
+	backend->SetState(scene.state);
+	backend->SetShaders(scene.vertexShader, scene.pixelShader);
+}
+
+// One frame of TextOutClass::Render
+static void DrawBatched(HeadlessBackendClass *backend, const SceneType &scene, TextBatchClass *batch, HandleType instanceBuffer,
+						vector<GlyphTableClass::InstanceType> *staging)
+{
+	if (batch->IsDirty()) {
+		int count = batch->WriteInstances(&(*staging)[0]);
+
+		backend->UpdateBuffer(instanceBuffer, &(*staging)[0], count * (int)sizeof(GlyphTableClass::InstanceType));
+	}
+	else
+		batch->SkipUpload();
+
+	if (batch->GetInstanceCount() == 0)
+		return;
+
+	HandleType	 buffers[2] = { scene.quad, instanceBuffer };
+	unsigned int strides[2] = { 8, sizeof(GlyphTableClass::InstanceType) };
+	unsigned int offsets[2] = { 0, 0 };
+
+	BindScene(backend, scene);
+	backend->SetVertexBuffers(0, 2, buffers, strides, offsets);
+	backend->DrawInstanced(6, batch->GetInstanceCount(), 0, 0);
+}
+
+// One frame of the text before the batching, a buffer, a color and a draw per sentence
+static void DrawPerSentence(HeadlessBackendClass *backend, const SceneType &scene, TextBatchClass *sentences, const vector<HandleType> &buffers,
+							vector<bool> *changed, vector<GlyphTableClass::InstanceType> *staging)
+{
+	float		 color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	unsigned int stride	  = sizeof(GlyphTableClass::InstanceType);
+	unsigned int offset	  = 0;
+
+	for (int i = 0; i < SENTENCES; i++) {
+
+		// Each sentence has its own little batch here, only written when the sentence changed
+		if ((*changed)[i]) {
+			int count = sentences[i].WriteInstances(&(*staging)[0]);
+
+			backend->UpdateBuffer(buffers[i], &(*staging)[0], count * (int)sizeof(GlyphTableClass::InstanceType));
+			(*changed)[i] = false;
+		}
+
+		BindScene(backend, scene);
+		backend->UpdateBuffer(scene.constants, color, sizeof(color));
+		backend->SetConstantBuffers(RENDER_STAGE_PIXEL, 0, 1, &scene.constants);
+		backend->SetVertexBuffers(0, 1, &buffers[i], &stride, &offset);
+		backend->DrawInstanced(6, sentences[i].GetInstanceCount(), 0, 0);
+	}
+}
+
+int main()
+{
+	FontMetricsClass	 metrics;
+	HeadlessBackendClass backend;
+	SceneType			 scene;
+	char				 text[64];
+
+	FillMetrics(&metrics);
+	CreateScene(&backend, &scene);
+
+	vector<GlyphTableClass::InstanceType> staging(SENTENCES * MAX_LENGTH);
+
+	// The batch of TextOutClass, with a shared instance buffer big enough for all the sentences
+	TextBatchClass batch;
+	batch.Initialize(&metrics, SCREEN_WIDTH, SCREEN_HEIGHT, SENTENCES * MAX_LENGTH);
+
+	RenderBackendClass::BufferDescType desc = { RENDER_BUFFER_VERTEX, SENTENCES * MAX_LENGTH * (int)sizeof(GlyphTableClass::InstanceType), 0, true };
+	HandleType instanceBuffer = backend.CreateBuffer(desc, 0);
+
+	// The same sentences one by one, each in a batch and a buffer of its own
+	vector<TextBatchClass> sentences(SENTENCES);
+	vector<HandleType>	   buffers(SENTENCES);
+	vector<bool>		   changed(SENTENCES, true);
+
+	desc.size = MAX_LENGTH * (int)sizeof(GlyphTableClass::InstanceType);
+
+	for (int i = 0; i < SENTENCES; i++) {
+		sentences[i].Initialize(&metrics, SCREEN_WIDTH, SCREEN_HEIGHT, MAX_LENGTH);
+		sentences[i].AddSentence(MAX_LENGTH);
+		buffers[i] = backend.CreateBuffer(desc, 0);
+
+		batch.AddSentence(MAX_LENGTH);
+	}
+
+	int errors = 0;
+
+	const char *cases[]	  = { "no sentence changed", "1 in 10 changed", "all changed" };
+	int			periods[] = { 0, 10, 1 };
+
+	printf("%d sentences, %d frames\n", SENTENCES, FRAMES);
+
+	for (int c = 0; c < 3; c++) {
+
+		int	   batchedDraws = 0, perSentenceDraws = 0, uploads = 0, instances = 0;
+		double batched = 0.0, perSentence = 0.0;
+
+		for (int frame = 0; frame < FRAMES; frame++) {
+
+			// The text of the frame; the first frame of every case sets all of them
+			double start = GetBenchmarkClock();
+
+			batch.ResetCounters();
+
+			for (int i = 0; i < SENTENCES; i++) {
+				int value = periods[c] && (frame == 0 || i % periods[c] == 0) ? frame + c * FRAMES : 0;
+
+				MakeText(text, i, value);
+				batch.UpdateSentence(i, text, (i % 8) * 240, (i / 8) * 8 % SCREEN_HEIGHT, 0xFFFFFFFF);
+			}
+
+			backend.GetStream()->Clear();
+			backend.ResetCounters();
+
+			DrawBatched(&backend, scene, &batch, instanceBuffer, &staging);
+
+			errors		 += backend.GetErrorCount();
+			batched		 += GetBenchmarkClock() - start;
+			batchedDraws += backend.GetDrawCount();
+			uploads		 += batch.GetUploadCount();
+			instances	 += batch.GetInstanceCount();
+
+			start = GetBenchmarkClock();
+
+			for (int i = 0; i < SENTENCES; i++) {
+				int value = periods[c] && (frame == 0 || i % periods[c] == 0) ? frame + c * FRAMES : 0;
+
+				MakeText(text, i, value);
+
+				sentences[i].ResetCounters();
+				sentences[i].UpdateSentence(0, text, (i % 8) * 240, (i / 8) * 8 % SCREEN_HEIGHT, 0xFFFFFFFF);
+
+				if (sentences[i].IsDirty())
+					changed[i] = true;
+			}
+
+			backend.GetStream()->Clear();
+			backend.ResetCounters();
+
+			DrawPerSentence(&backend, scene, &sentences[0], buffers, &changed, &staging);
+
+			errors			 += backend.GetErrorCount();
+			perSentence		 += GetBenchmarkClock() - start;
+			perSentenceDraws += backend.GetDrawCount();
+		}
+
+		printf("%-20s batched: %7.3f ms/frame, %d draw(s), %d uploads in %d frames, %d letters | per sentence: %7.3f ms/frame, %d draws\n",
+			   cases[c], batched / FRAMES, batchedDraws / FRAMES, uploads, FRAMES, instances / FRAMES,
+			   perSentence / FRAMES, perSentenceDraws / FRAMES);
+	}
+
+	printf("headless errors: %d\n", errors);
+
+	for (int i = 0; i < SENTENCES; i++)
+		sentences[i].Shutdown();
+
+	batch.Shutdown();
+	backend.Shutdown();
+
+	return 0;
+}
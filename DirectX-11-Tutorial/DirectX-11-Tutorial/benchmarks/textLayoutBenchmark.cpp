@@ -0,0 +1,111 @@
+// TextLayoutClass throughput in glyphs per second, on a text of a few thousand letters with the metrics of the ASCII font
+// of FontClass and a few kerning pairs: the layout on one line per paragraph, wrapped, wrapped and centered with a clipping
+// rectangle, Measure, and Layout when the cache already has the text.
+
+#include "__benchmarkClock.h"
+#include "__textLayoutClass.h"
+
+#include <string>
+using namespace std;
+
+#define RUNS 50
+
+static void FillMetrics(FontMetricsClass *metrics)
+{
+	FontMetricsClass::GlyphMetricsType glyph;
+
+	for (int letter = 0; letter < 95; letter++) {
+		glyph.left	  = 0.0f;
+		glyph.top	  = 0.0f;
+		glyph.width	  = 5.0f + letter % 4;
+		glyph.height  = 16.0f;
+		glyph.visible = letter != 0;
+		glyph.advance = letter == 0 ? 3.0f : glyph.width + 1.0f;
+
+		metrics->AddGlyph(letter + 32, glyph);
+	}
+
+	metrics->AddKerningPair('A', 'V', -1.0f);
+	metrics->AddKerningPair('T', 'o', -1.0f);
+	metrics->AddKerningPair('f', 'f', -1.0f);
+	metrics->SetLineMetrics(16.0f, 18.0f);
+	metrics->SetFallback('?');
+}
+
+// Words of 1 to 9 letters, a paragraph every 60 words
+static string MakeText(int words)
+{
+	string		text;
+	const char *letters = "etaoinshrdlucmfwypvbgkqjxzTAVE";
+	unsigned	seed	= 12345;
+
+	for (int w = 0; w < words; w++) {
+		seed = seed * 1103515245 + 12345;
+
+		int length = 1 + (seed >> 16) % 9;
+
+		for (int i = 0; i < length; i++) {
+			seed = seed * 1103515245 + 12345;
+			text += letters[(seed >> 16) % 30];
+		}
+
+		text += (w % 60 == 59) ? '\n' : ' ';
+	}
+
+	return text;
+}
+
+static void Report(const char *name, double time, int glyphs)
+{
+	printf("%-34s %9.4f ms %10.2f Mglyphs/s\n", name, time, glyphs / time / 1000.0);
+}
+
+int main()
+{
+	FontMetricsClass				metrics;
+	TextLayoutClass					layout;
+	TextLayoutClass::LayoutType		result;
+	TextLayoutClass::LayoutParamsType params = TextLayoutClass::DefaultParams();
+	float							width, height;
+
+	FillMetrics(&metrics);
+	layout.Initialize(64);
+
+	string text	  = MakeText(1200);
+	int	   glyphs = 0;
+
+	for (size_t i = 0; i < text.size(); i++)
+		if (text[i] != ' ' && text[i] != '\n')
+			glyphs++;
+
+	printf("%d bytes, %d glyphs\n", (int)text.size(), glyphs);
+
+	Report("layout, one line per paragraph", TimeBest(RUNS, [&]() { layout.LayoutUncached(&metrics, text.c_str(), params, &result); }), glyphs);
+
+	params.maxWidth = 400.0f;
+	Report("layout, wrapped at 400 px", TimeBest(RUNS, [&]() { layout.LayoutUncached(&metrics, text.c_str(), params, &result); }), glyphs);
+
+	int lines = (int)result.lines.size();
+
+	params.align	  = TEXT_ALIGN_CENTER;
+	params.clip		  = true;
+	params.clipRight  = 400.0f;
+	params.clipBottom = 600.0f;
+	Report("layout, wrapped, centered, clipped", TimeBest(RUNS, [&]() { layout.LayoutUncached(&metrics, text.c_str(), params, &result); }), glyphs);
+
+	int kept = (int)result.glyphs.size();
+
+	params = TextLayoutClass::DefaultParams();
+	params.maxWidth = 400.0f;
+	Report("measure, wrapped at 400 px", TimeBest(RUNS, [&]() { layout.Measure(&metrics, text.c_str(), params, &width, &height); }), glyphs);
+
+	layout.Layout(&metrics, text.c_str(), params);
+	Report("layout from the cache", TimeBest(RUNS, [&]() { layout.Layout(&metrics, text.c_str(), params); }), glyphs);
+
+	printf("%d lines of at most 400 px, %d glyphs left by the clip, cache: %d hits, %d misses\n",
+		   lines, kept, layout.GetCacheHits(), layout.GetCacheMisses());
+
+	layout.Shutdown();
+
+	return 0;
+}
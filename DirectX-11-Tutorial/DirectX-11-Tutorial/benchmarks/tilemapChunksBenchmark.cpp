@@ -0,0 +1,63 @@
+// TilemapChunksClass on the map of GraphicsClass, 4096 x 4096 tiles of 32 pixels with the same pattern:
+// the rebuild of a chunk, the rebuild of every chunk of the map, and the selection of the visible chunks for an 800x600 view scrolling over it.
+
+#include "__benchmarkClock.h"
+#include "__tilemapChunksClass.h"
+
+#include <vector>
+using namespace std;
+
+#define MAP_SIZE  4096
+#define TILE_SIZE 32
+#define RUNS	  5
+
+int main()
+{
+	TilemapChunksClass chunks;
+	vector<TilemapChunksClass::VertexType> vertices(TilemapChunksClass::CHUNK_SIZE * TilemapChunksClass::CHUNK_SIZE * 4);
+	int quads = 0;
+
+	if (!chunks.Initialize(MAP_SIZE, MAP_SIZE, TILE_SIZE, 2, 2))
+		return 1;
+
+	double fill = TimeBest(1, [&]() {
+		for (int y = 0; y < MAP_SIZE; y++)
+			for (int x = 0; x < MAP_SIZE; x++)
+				if ((x ^ y) % 13)
+					chunks.SetTile(x, y, (unsigned short)(((x / 7) ^ (y / 5)) & 3));
+	});
+
+	int chunkCount = chunks.GetChunkCount();
+
+	double all = TimeBest(RUNS, [&]() {
+		quads = 0;
+
+		for (int i = 0; i < chunkCount; i++)
+			quads += chunks.BuildChunkVertices(i, &vertices[0]);
+	});
+
+	double one = TimeBest(RUNS * 100, [&]() { chunks.BuildChunkVertices(chunkCount / 2, &vertices[0]); });
+
+	// The view of GraphicsClass, moving over the whole map a frame at a time
+	int mapPixels = MAP_SIZE * TILE_SIZE;
+	int visible	  = 0;
+	int frames	  = 100000;
+
+	double select = TimeBest(RUNS, [&]() {
+		for (int frame = 0; frame < frames; frame++) {
+			int left = (frame * 97) % (mapPixels - 800);
+			int top	 = (frame * 61) % (mapPixels - 600);
+
+			visible += chunks.SelectVisibleChunks(left, top, 800, 600);
+		}
+	});
+
+	printf("map %dx%d tiles, %d chunks, filled in %.1f ms\n", MAP_SIZE, MAP_SIZE, chunkCount, fill);
+	printf("rebuild of every chunk: %.1f ms, %d quads, %.2f us per chunk\n", all, quads, all * 1000.0 / chunkCount);
+	printf("rebuild of one full chunk: %.2f us\n", one * 1000.0);
+	printf("visible chunk selection, 800x600 view: %.1f ns per frame, %d chunks per frame\n", select * 1e6 / frames, visible / (frames * RUNS));
+
+	chunks.Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,27 @@
+// --------------------------------------------------------------------------------------------------------
+// The checks of the tests: CHECK prints the failed condition with its file and line and counts it,
+// and TEST_RESULT is what main returns, 0 when nothing failed.
+// --------------------------------------------------------------------------------------------------------
+
+#ifndef _TESTCHECK_H_
+#define _TESTCHECK_H_
+
+#include <stdio.h>
+#include <math.h>
+
+static int s_testFailures = 0;
+
+#define CHECK(condition)															\
+	do {																			\
+		if (!(condition)) {															\
+			printf("%s(%d): CHECK failed: %s\n", __FILE__, __LINE__, #condition);	\
+			s_testFailures++;														\
+		}																			\
+	} while (0)
+
+// Two floats within the tolerance
+#define CHECK_NEAR(a, b, tolerance) CHECK(fabs((double)(a) - (double)(b)) <= (tolerance))
+
+#define TEST_RESULT() (s_testFailures ? (printf("%d check(s) failed\n", s_testFailures), 1) : (printf("all checks passed\n"), 0))
+
+#endif
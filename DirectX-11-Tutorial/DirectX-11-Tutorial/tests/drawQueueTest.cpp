@@ -0,0 +1,568 @@
+// DrawQueueClass in front of a recording fake context, which keeps what is bound and what every draw was made with.
+// The keys of MakeKey order the passes, then the opaque draws before the blended ones, the opaque ones by shader, texture
+// and depth front to back, the blended ones back to front. Sort has to give the order of a stable sort of the keys,
+// for random keys, keys with many duplicates and keys that share their high bytes. Submit has to draw every draw
+// with what it binds and its own constants, binding only what changed, and count the changes it made.
+// Then the sprite passes of a layer of GraphicsClass are recorded on a HeadlessBackendClass: the uploads, then the draws,
+// and a layer like the scene of GraphicsClass, whose passes come with their textures in turn, is submitted back to front, a texture at a time.
+
+#include "__testCheck.h"
+#include "__drawQueueClass.h"
+#include "__spritePassClass.h"
+#include "__headlessBackendClass.h"
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+typedef DrawQueueClass::HandleType HandleType;
+
+class RecordingContextClass : public RenderContextClass {
+ public:
+	// What a draw was made with; the start is the index the test gave the draw
+	struct DrawRecordType {
+		HandleType target, state, vertexShader, pixelShader, vertexBuffer, indexBuffer, constantBuffer, texture;
+		int		   start;
+		float	   constant;
+	};
+
+ public:
+	RecordingContextClass()
+	{
+		target = state = vertexShader = pixelShader = vertexBuffer = indexBuffer = constantBuffer = texture = 0;
+		constant = 0.0f;
+		calls	 = 0;
+	}
+
+	bool UpdateBuffer(HandleType buffer, const void *data, int size)
+	{
+		if (buffer == constantBuffer && size == sizeof(float))
+			constant = *(const float*)data;
+		else
+			constant = -1.0f;
+
+		return true;
+	}
+
+	void SetRenderTarget(HandleType handle)
+	{
+		calls++;
+		target = handle;
+	}
+
+	void Clear(const float *)
+	{
+	}
+
+	void SetState(HandleType handle)
+	{
+		calls++;
+		state = handle;
+	}
+
+	void SetShaders(HandleType vertex, HandleType pixel)
+	{
+		calls++;
+		vertexShader = vertex;
+		pixelShader	 = pixel;
+	}
+
+	void SetVertexBuffers(int, int count, const HandleType *buffers, const unsigned int *, const unsigned int *)
+	{
+		calls++;
+		vertexBuffer = count > 0 ? buffers[0] : 0;
+	}
+
+	void SetIndexBuffer(HandleType handle)
+	{
+		calls++;
+		indexBuffer = handle;
+	}
+
+	// The vertex and the pixel constant buffers are one change of the queue
+	void SetConstantBuffers(int stage, int, int, const HandleType *buffers)
+	{
+		if (stage == RENDER_STAGE_VERTEX) {
+			calls++;
+			constantBuffer = buffers[0];
+		}
+	}
+
+	void SetTextures(int, int, int, const HandleType *textures)
+	{
+		calls++;
+		texture = textures[0];
+	}
+
+	void Draw(int, int start)
+	{
+		Record(start);
+	}
+
+	void DrawIndexed(int, int start, int)
+	{
+		Record(start);
+	}
+
+	void DrawInstanced(int, int, int start, int)
+	{
+		Record(start);
+	}
+
+	void DrawIndexedInstanced(int, int, int start, int, int)
+	{
+		Record(start);
+	}
+
+ private:
+	void Record(int start)
+	{
+		DrawRecordType record = { target, state, vertexShader, pixelShader, vertexBuffer, indexBuffer, constantBuffer, texture, start, constant };
+
+		draws.push_back(record);
+	}
+
+ public:
+	HandleType			   target, state, vertexShader, pixelShader, vertexBuffer, indexBuffer, constantBuffer, texture;
+	float				   constant;
+	int					   calls;
+	vector<DrawRecordType> draws;
+};
+
+static unsigned int s_random = 12345;
+
+static unsigned int Random()
+{
+	s_random = s_random * 1664525 + 1013904223;
+
+	return s_random >> 8;
+}
+
+// A draw that binds its state, shader and texture, its start being the index it was added with
+static DrawQueueClass::DrawType MakeDraw(int index, HandleType state, HandleType shader, HandleType texture)
+{
+	DrawQueueClass::DrawType draw;
+
+	memset(&draw, 0, sizeof(draw));
+	draw.state				   = state;
+	draw.vertexShader		   = shader;
+	draw.pixelShader		   = shader + 100;
+	draw.vertexBufferCount	   = 1;
+	draw.vertexBuffers[0]	   = 7;
+	draw.strides[0]			   = 20;
+	draw.constantBuffers[0][0] = 9;
+	draw.textures[0]		   = texture;
+	draw.constantBuffer		   = 9;
+	draw.count				   = 6;
+	draw.start				   = index;
+
+	return draw;
+}
+
+static void TestKeys()
+{
+	typedef DrawQueueClass Q;
+
+	// The pass first, then the blending
+	CHECK(Q::MakeKey(0, true, 0xffff, 0xffff, 1.0f) < Q::MakeKey(1, false, 0, 0, 0.0f));
+	CHECK(Q::MakeKey(0, false, 0xffff, 0xffff, 1.0f) < Q::MakeKey(0, true, 0, 0, 0.0f));
+	CHECK(Q::MakeKey(3, false, 1, 2, 0.5f) >> 56 == 3);
+
+	// Opaque: the shader, the texture, then the depth front to back
+	CHECK(Q::MakeKey(0, false, 1, 0xffff, 1.0f) < Q::MakeKey(0, false, 2, 0, 0.0f));
+	CHECK(Q::MakeKey(0, false, 1, 1, 1.0f) < Q::MakeKey(0, false, 1, 2, 0.0f));
+	CHECK(Q::MakeKey(0, false, 1, 1, 0.25f) < Q::MakeKey(0, false, 1, 1, 0.5f));
+
+	// Blended: the depth back to front before the shader and the texture
+	CHECK(Q::MakeKey(0, true, 0xffff, 0xffff, 0.75f) < Q::MakeKey(0, true, 0, 0, 0.5f));
+	CHECK(Q::MakeKey(0, true, 1, 0xffff, 0.5f) < Q::MakeKey(0, true, 2, 0, 0.5f));
+	CHECK(Q::MakeKey(0, true, 1, 1, 0.5f) < Q::MakeKey(0, true, 1, 2, 0.5f));
+
+	// The depth is clamped, the ids keep their 16 bits
+	CHECK(Q::MakeKey(0, false, 1, 1, -1.0f) == Q::MakeKey(0, false, 1, 1, 0.0f));
+	CHECK(Q::MakeKey(0, true, 1, 1, 2.0f) == Q::MakeKey(0, true, 1, 1, 1.0f));
+	CHECK(Q::MakeKey(0, false, 0x10001, 0x20002, 0.0f) == Q::MakeKey(0, false, 1, 2, 0.0f));
+}
+
+// The keys are made by the kind: 0 for any 64 bits, 1 for a few values, 2 for keys that differ in their low bytes only
+static unsigned long long MakeTestKey(int kind)
+{
+	if (kind == 0)
+		return (unsigned long long)Random() << 40 ^ (unsigned long long)Random() << 16 ^ Random();
+
+	if (kind == 1)
+		return (unsigned long long)(Random() % 7) << 50 | (Random() % 3);
+
+	return 0x1234560000000000ULL | (Random() & 0xffff);
+}
+
+static bool CompareKeys(const pair<unsigned long long, int> &a, const pair<unsigned long long, int> &b)
+{
+	return a.first < b.first;
+}
+
+static void TestSort(int count, int kind)
+{
+	DrawQueueClass						   queue;
+	RecordingContextClass				   context;
+	vector<pair<unsigned long long, int> > expected;
+
+	for (int i = 0; i < count; i++) {
+		unsigned long long key = MakeTestKey(kind);
+
+		queue.AddDraw(key, MakeDraw(i, 1, 1, 1), 0, 0);
+		expected.push_back(make_pair(key, i));
+	}
+
+	CHECK(queue.GetDrawCount() == count);
+
+	queue.Sort();
+	queue.Submit(&context);
+
+	stable_sort(expected.begin(), expected.end(), CompareKeys);
+
+	CHECK((int)context.draws.size() == count);
+
+	int mismatches = 0;
+
+	for (int i = 0; i < (int)context.draws.size() && i < count; i++)
+		if (context.draws[i].start != expected[i].second)
+			mismatches++;
+
+	CHECK(mismatches == 0);
+
+	// Sorting again changes nothing, the order of the equal keys included
+	context.draws.clear();
+	queue.Sort();
+	queue.Submit(&context);
+
+	mismatches = 0;
+
+	for (int i = 0; i < (int)context.draws.size() && i < count; i++)
+		if (context.draws[i].start != expected[i].second)
+			mismatches++;
+
+	CHECK((int)context.draws.size() == count && mismatches == 0);
+}
+
+static void TestSubmit()
+{
+	DrawQueueClass						 queue;
+	RecordingContextClass				 context;
+	DrawQueueClass::StatisticsType		 submitted, added;
+	vector<DrawQueueClass::DrawType>	 draws;
+	vector<int>							 passes;
+
+	queue.SetPassTarget(1, 50);
+
+	// Two passes, two states, three shaders and four textures, in a random order, each draw with its own constant
+	for (int i = 0; i < 400; i++) {
+		int		 pass	 = Random() % 2;
+		bool	 blended = Random() % 2 != 0;
+		int		 shader	 = 1 + Random() % 3;
+		int		 texture = 20 + Random() % 4;
+		float	 value	 = (float)i;
+
+		DrawQueueClass::DrawType draw = MakeDraw(i, blended ? 2 : 3, shader, texture);
+
+		if (i % 5 == 0) {
+			draw.indexBuffer   = 8;
+			draw.instanceCount = 4;
+		}
+
+		queue.AddDraw(DrawQueueClass::MakeKey(pass, blended, shader, texture, (Random() % 1000) / 1000.0f), draw, &value, sizeof(value));
+
+		draws.push_back(draw);
+		passes.push_back(pass);
+	}
+
+	queue.Sort();
+	queue.Submit(&context);
+	queue.GetStatistics(&submitted, &added);
+
+	CHECK(context.draws.size() == draws.size());
+
+	// Every draw is made with what it binds and its own constants, the passes in their order
+	int wrong = 0, previousPass = 0;
+
+	for (size_t i = 0; i < context.draws.size(); i++) {
+		const RecordingContextClass::DrawRecordType &record = context.draws[i];
+		const DrawQueueClass::DrawType				&draw	= draws[record.start];
+		int											 pass	= passes[record.start];
+
+		if (record.target != (pass ? 50u : 0u) || record.state != draw.state || record.vertexShader != draw.vertexShader ||
+			record.pixelShader != draw.pixelShader || record.vertexBuffer != 7 || record.indexBuffer != draw.indexBuffer ||
+			record.constantBuffer != 9 || record.texture != draw.textures[0] || record.constant != (float)record.start || pass < previousPass)
+			wrong++;
+
+		previousPass = pass;
+	}
+
+	CHECK(wrong == 0);
+
+	// The changes counted are the calls made, fewer than in the order the draws were added
+	CHECK(submitted.draws == 400 && added.draws == 400);
+	CHECK(submitted.calls == context.calls);
+	CHECK(submitted.targets == 2);
+	CHECK(submitted.states <= 4);
+	CHECK(submitted.shaders < added.shaders && submitted.textures < added.textures && submitted.calls < added.calls);
+
+	// Reset empties the queue, the targets stay
+	queue.Reset();
+	CHECK(queue.GetDrawCount() == 0);
+
+	context.draws.clear();
+	queue.Submit(&context);
+	CHECK(context.draws.empty());
+
+	queue.AddDraw(DrawQueueClass::MakeKey(1, false, 1, 1, 0.0f), MakeDraw(0, 1, 1, 1), 0, 0);
+	queue.Submit(&context);
+	CHECK(context.draws.size() == 1 && context.draws[0].target == 50);
+}
+
+// The two passes of a layer draw the way Render draws them: the uploads of the instances first,
+// then for each draw the bindings, the matrices and the instanced draw. A pass without instances adds no draw.
+static void TestLayer()
+{
+	RenderBackendClass::TextureDescType	  textureDesc = { 2, 2, RENDER_FORMAT_RGBA8, false };
+	RenderBackendClass::StateDescType	  stateDesc	  = { true, false, false, true };
+	HeadlessBackendClass				  backend;
+	SpritePassClass::HandleType			  vertexShader, pixelShader, texture, state;
+	SpritePassClass						  passes[3];
+	SpritePassClass::LayerType			  layer;
+	SpritePassClass::MatrixBufferType	  matrices;
+	vector<SpritePassClass::InstanceType> instances(8);
+	unsigned char						  texels[16];
+
+	memset(texels, 255, sizeof(texels));
+	memset(&matrices, 0, sizeof(matrices));
+	memset(&instances[0], 0, instances.size() * sizeof(SpritePassClass::InstanceType));
+
+	texture = backend.CreateTexture(textureDesc, texels, 8);
+	state	= backend.CreateState(stateDesc);
+
+	CHECK(SpritePassClass::CreateShaders(&backend, 0, 0, 0, 0, &vertexShader, &pixelShader));
+
+	for (int i = 0; i < 3; i++) {
+		CHECK(passes[i].Initialize(&backend, 24, 8, vertexShader, pixelShader, texture, state));
+
+		matrices.world.m[0][0] = (float)i;
+		passes[i].SetMatrices(matrices);
+		passes[i].SetInstances(&instances[0], i == 1 ? 0 : 3 + i);
+
+		layer.passes.push_back(&passes[i]);
+		passes[i].AddDraw(&layer.queue, DrawQueueClass::MakeKey(0, true, vertexShader, texture, 0.0f));
+	}
+
+	CHECK(layer.queue.GetDrawCount() == 2);
+	layer.queue.Sort();
+
+	backend.GetStream()->Clear();
+	backend.ResetCounters();
+
+	SpritePassClass::RecordLayer(&backend, &layer);
+
+	CHECK(backend.GetErrorCount() == 0 && backend.GetDrawCount() == 2);
+
+	CommandStreamClass *stream = backend.GetStream();
+
+	stream->Rewind();
+
+	CHECK(stream->ReadByte() == HEADLESS_UPDATE_BUFFER);
+	stream->ReadUint();
+	CHECK(stream->ReadUint() == 3 * sizeof(SpritePassClass::InstanceType));
+	stream->ReadBytes(3 * sizeof(SpritePassClass::InstanceType));
+
+	CHECK(stream->ReadByte() == HEADLESS_UPDATE_BUFFER);
+	stream->ReadUint();
+	CHECK(stream->ReadUint() == 5 * sizeof(SpritePassClass::InstanceType));
+	stream->ReadBytes(5 * sizeof(SpritePassClass::InstanceType));
+
+	// The draws keep the order of the passes, the second one only binds the buffers of its own pass
+	int draws = 0, updates = 0, sets = 0;
+
+	while (!stream->AtEnd() && stream->IsValid()) {
+		int opcode = stream->ReadByte();
+
+		if (opcode == HEADLESS_DRAW_INSTANCED) {
+			CHECK(stream->ReadUint() == 6 && stream->ReadUint() == (draws ? 5u : 3u));
+			stream->ReadUint();
+			stream->ReadUint();
+			draws++;
+		}
+		else if (opcode == HEADLESS_UPDATE_BUFFER) {
+			stream->ReadUint();
+			CHECK(stream->ReadUint() == sizeof(matrices));
+
+			const SpritePassClass::MatrixBufferType *written = (const SpritePassClass::MatrixBufferType*)stream->ReadBytes(sizeof(matrices));
+			CHECK(written->world.m[0][0] == (draws ? 2.0f : 0.0f));
+			updates++;
+		}
+		else if (opcode == HEADLESS_SET_STATE || opcode == HEADLESS_SET_SHADERS) {
+			stream->ReadUint();
+			if (opcode == HEADLESS_SET_SHADERS)
+				stream->ReadUint();
+			sets++;
+		}
+		else if (opcode == HEADLESS_SET_RENDER_TARGET || opcode == HEADLESS_SET_INDEX_BUFFER)
+			stream->ReadUint();
+		else if (opcode == HEADLESS_SET_VERTEX_BUFFERS) {
+			stream->ReadUint();
+			int count = stream->ReadUint();
+			for (int i = 0; i < count * 3; i++)
+				stream->ReadUint();
+		}
+		else if (opcode == HEADLESS_SET_CONSTANT_BUFFERS || opcode == HEADLESS_SET_TEXTURES) {
+			stream->ReadUint();
+			stream->ReadUint();
+			int count = stream->ReadUint();
+			for (int i = 0; i < count; i++)
+				stream->ReadUint();
+		}
+		else
+			CHECK(false);
+	}
+
+	CHECK(stream->IsValid());
+	CHECK(draws == 2 && updates == 2 && sets == 2);
+
+	for (int i = 0; i < 3; i++)
+		passes[i].Shutdown();
+
+	backend.Shutdown();
+}
+
+// The scene of GraphicsClass: the background at the back, the bitmap in the middle and the batches of the sprites in front,
+// their textures in turn. Sorted, the batches of a texture come together, each in the order it was added.
+static void TestSceneLayer()
+{
+	RenderBackendClass::TextureDescType	  textureDesc = { 2, 2, RENDER_FORMAT_RGBA8, false };
+	RenderBackendClass::StateDescType	  stateDesc	  = { true, false, false, true };
+	HeadlessBackendClass				  backend;
+	SpritePassClass::HandleType			  vertexShader, pixelShader, background, sheet, bitmap, state;
+	SpritePassClass						  passes[10];
+	SpritePassClass::LayerType			  layer;
+	SpritePassClass::MatrixBufferType	  matrices;
+	DrawQueueClass::StatisticsType		  submitted, added;
+	vector<SpritePassClass::InstanceType> instances(16);
+	unsigned char						  texels[16];
+
+	memset(texels, 255, sizeof(texels));
+	memset(&matrices, 0, sizeof(matrices));
+	memset(&instances[0], 0, instances.size() * sizeof(SpritePassClass::InstanceType));
+
+	background = backend.CreateTexture(textureDesc, texels, 8);
+	sheet	   = backend.CreateTexture(textureDesc, texels, 8);
+	bitmap	   = backend.CreateTexture(textureDesc, texels, 8);
+	state	   = backend.CreateState(stateDesc);
+
+	CHECK(background < sheet && sheet < bitmap);
+	CHECK(SpritePassClass::CreateShaders(&backend, 0, 0, 0, 0, &vertexShader, &pixelShader));
+
+	// The background draws 12 instances, the bitmap 11 and the pass i of the sprites i, more than one each: they are all instanced draws
+	for (int i = 0; i < 10; i++) {
+		HandleType texture = i == 0 ? background : (i == 1 || i % 2 ? bitmap : sheet);
+		float	   depth   = i == 0 ? 1.0f : (i == 1 ? 0.5f : 0.0f);
+		int		   count   = i < 2 ? 12 - i : i;
+
+		CHECK(passes[i].Initialize(&backend, 24, 16, vertexShader, pixelShader, texture, state));
+
+		passes[i].SetMatrices(matrices);
+		passes[i].SetInstances(&instances[0], count);
+
+		layer.passes.push_back(&passes[i]);
+		passes[i].AddDraw(&layer.queue, DrawQueueClass::MakeKey(0, true, vertexShader, texture, depth));
+	}
+
+	layer.queue.Sort();
+
+	backend.GetStream()->Clear();
+	backend.ResetCounters();
+
+	SpritePassClass::RecordLayer(&backend, &layer);
+	layer.queue.GetStatistics(&submitted, &added);
+
+	CHECK(backend.GetErrorCount() == 0 && backend.GetDrawCount() == 10);
+
+	// In the order added every draw changed the texture, sorted only the background, the bitmap, the sheet and the bitmap again
+	CHECK(submitted.draws == 10 && added.draws == 10);
+	CHECK(added.textures == 10 && submitted.textures == 4);
+	CHECK(submitted.calls < added.calls);
+
+	CommandStreamClass *stream = backend.GetStream();
+	vector<int>			counts;
+	vector<HandleType>	textures;
+
+	stream->Rewind();
+
+	while (!stream->AtEnd() && stream->IsValid()) {
+		int opcode = stream->ReadByte();
+
+		if (opcode == HEADLESS_DRAW_INSTANCED) {
+			stream->ReadUint();
+			counts.push_back(stream->ReadUint());
+			stream->ReadUint();
+			stream->ReadUint();
+		}
+		else if (opcode == HEADLESS_UPDATE_BUFFER) {
+			stream->ReadUint();
+			stream->ReadBytes(stream->ReadUint());
+		}
+		else if (opcode == HEADLESS_SET_SHADERS) {
+			stream->ReadUint();
+			stream->ReadUint();
+		}
+		else if (opcode == HEADLESS_SET_STATE || opcode == HEADLESS_SET_RENDER_TARGET || opcode == HEADLESS_SET_INDEX_BUFFER)
+			stream->ReadUint();
+		else if (opcode == HEADLESS_SET_VERTEX_BUFFERS) {
+			stream->ReadUint();
+			int count = stream->ReadUint();
+			for (int i = 0; i < count * 3; i++)
+				stream->ReadUint();
+		}
+		else if (opcode == HEADLESS_SET_CONSTANT_BUFFERS || opcode == HEADLESS_SET_TEXTURES) {
+			stream->ReadUint();
+			stream->ReadUint();
+			int count = stream->ReadUint();
+			for (int i = 0; i < count; i++) {
+				HandleType handle = stream->ReadUint();
+				if (opcode == HEADLESS_SET_TEXTURES && i == 0)
+					textures.push_back(handle);
+			}
+		}
+		else
+			CHECK(false);
+	}
+
+	int		   expectedCounts[10]  = { 12, 11, 2, 4, 6, 8, 3, 5, 7, 9 };
+	HandleType expectedTextures[4] = { background, bitmap, sheet, bitmap };
+
+	CHECK(stream->IsValid());
+	CHECK(counts == vector<int>(expectedCounts, expectedCounts + 10));
+	CHECK(textures == vector<HandleType>(expectedTextures, expectedTextures + 4));
+
+	for (int i = 0; i < 10; i++)
+		passes[i].Shutdown();
+
+	backend.Shutdown();
+}
+
+int main()
+{
+	TestKeys();
+
+	for (int kind = 0; kind < 3; kind++) {
+		TestSort(0, kind);
+		TestSort(1, kind);
+		TestSort(2, kind);
+		TestSort(1000, kind);
+		TestSort(50000, kind);
+	}
+
+	TestSubmit();
+	TestLayer();
+	TestSceneLayer();
+
+	return TEST_RESULT();
+}
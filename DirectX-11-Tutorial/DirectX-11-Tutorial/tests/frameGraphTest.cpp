@@ -0,0 +1,403 @@
+// FrameGraphClass on a HeadlessBackendClass: the passes log when they run, the stream tells the targets and states that were set.
+// The order keeps every pass after the ones it reads from and after the ones before it on its target, and groups the passes of a target;
+// the frame of GraphicsClass runs in the order it is declared in. The passes nothing reads from are culled and don't run.
+// Two transient textures of the same size whose passes don't overlap share a texture of the pool, the others don't,
+// and the next frame makes no texture.
+
+#include "__testCheck.h"
+#include "__frameGraphClass.h"
+#include "__headlessBackendClass.h"
+
+#include <string.h>
+#include <vector>
+using namespace std;
+
+static const RenderBackendClass::StateDescType STATE_2D = { true,  false, false, true };
+static const RenderBackendClass::StateDescType STATE_3D = { false, true,  true,  true };
+
+struct PassLogType {
+	vector<int> *log;
+	int			 id;
+};
+
+static void LogPass(RenderContextClass *context, void *data)
+{
+	PassLogType *pass = (PassLogType*)data;
+
+	pass->log->push_back(pass->id);
+	context->Draw(3, 0);
+}
+
+static int PositionOf(const vector<int> &log, int id)
+{
+	for (size_t i = 0; i < log.size(); i++)
+		if (log[i] == id)
+			return (int)i;
+
+	return -1;
+}
+
+static RenderBackendClass::TextureDescType MakeDesc(int width, int height)
+{
+	RenderBackendClass::TextureDescType desc = { width, height, RENDER_FORMAT_RGBA8, true };
+
+	return desc;
+}
+
+// The passes wait for what they read and for their target, the free ones are grouped by target.
+static void TestOrder()
+{
+	HeadlessBackendClass backend;
+	FrameGraphClass		 graph;
+	vector<int>			 log;
+	PassLogType			 passes[8];
+	int					 a, b, shadow, blur, scene;
+
+	for (int i = 0; i < 8; i++) {
+		passes[i].log = &log;
+		passes[i].id  = i;
+	}
+
+	CHECK(!graph.Initialize(0));
+	CHECK(graph.Initialize(&backend));
+
+	// Two textures drawn in turns, then read together into the back buffer, then drawn over
+	a	   = graph.CreateTexture(MakeDesc(64, 64));
+	b	   = graph.CreateTexture(MakeDesc(32, 32));
+	shadow = graph.AddPass("a1", LogPass, &passes[0], STATE_3D);
+	graph.Write(shadow, a);
+	blur = graph.AddPass("b1", LogPass, &passes[1], STATE_2D);
+	graph.Write(blur, b);
+	graph.Write(graph.AddPass("a2", LogPass, &passes[2], STATE_3D), a);
+	graph.Write(graph.AddPass("b2", LogPass, &passes[3], STATE_2D), b);
+
+	scene = graph.AddPass("scene", LogPass, &passes[4], STATE_3D);
+	graph.Read(scene, a);
+	graph.Read(scene, b);
+	graph.AddPass("overlay", LogPass, &passes[5], STATE_2D);
+
+	CHECK(graph.Compile());
+	CHECK(graph.GetPassCount() == 6 && graph.GetCulledCount() == 0);
+
+	graph.Execute();
+	CHECK(log.size() == 6);
+
+	for (int i = 0; i < graph.GetPassCount(); i++)
+		CHECK(log[i] == graph.GetOrderedPass(i));
+
+	// The writes of a target keep their order, the reader comes after both, the overlay after the scene
+	CHECK(PositionOf(log, 0) < PositionOf(log, 2));
+	CHECK(PositionOf(log, 1) < PositionOf(log, 3));
+	CHECK(PositionOf(log, 2) < PositionOf(log, 4) && PositionOf(log, 3) < PositionOf(log, 4));
+	CHECK(PositionOf(log, 4) < PositionOf(log, 5));
+
+	// a1 and a2 go together, then b1 and b2: three target changes instead of five
+	CHECK(log[0] == 0 && log[1] == 2 && log[2] == 1 && log[3] == 3);
+	CHECK(graph.GetTargetChanges() == 3);
+	CHECK(graph.GetStateChanges() == 4);
+	CHECK(strcmp(graph.GetPassName(graph.GetOrderedPass(0)), "a1") == 0);
+
+	// Execute sets the target and the state only when they change
+	CommandStreamClass *stream = backend.GetStream();
+	int					targets = 0, states = 0, draws = 0;
+
+	stream->Clear();
+	log.clear();
+	graph.Execute();
+
+	stream->Rewind();
+
+	while (!stream->AtEnd() && stream->IsValid()) {
+		switch (stream->ReadByte()) {
+			case HEADLESS_SET_RENDER_TARGET: stream->ReadUint(); targets++; break;
+			case HEADLESS_SET_STATE:		 stream->ReadUint(); states++;	break;
+			case HEADLESS_DRAW:				 stream->ReadUint(); stream->ReadUint(); draws++; break;
+			default:						 CHECK(false); break;
+		}
+	}
+
+	CHECK(targets == graph.GetTargetChanges() && states == graph.GetStateChanges() && draws == 6);
+	CHECK(backend.GetErrorCount() == 0);
+
+	graph.Shutdown();
+	backend.Shutdown();
+}
+
+// The frame of GraphicsClass: the 2D scene, the text into the imported layer, the layer over the scene, the 3D scene, the performance HUD.
+static void TestGraphicsFrame()
+{
+	HeadlessBackendClass backend;
+	FrameGraphClass		 graph;
+	vector<int>			 log;
+	PassLogType			 passes[5];
+	RenderBackendClass::TextureDescType layerDesc = { 800, 600, RENDER_FORMAT_RGBA8, true };
+	RenderBackendClass::HandleType		layerTexture;
+
+	for (int i = 0; i < 5; i++) {
+		passes[i].log = &log;
+		passes[i].id  = i;
+	}
+
+	layerTexture = backend.CreateTexture(layerDesc, 0, 0);
+	CHECK(graph.Initialize(&backend));
+
+	for (int dirty = 1; dirty >= 0; dirty--) {
+		int layer, pass;
+
+		graph.Reset();
+		log.clear();
+
+		layer = graph.ImportTexture(layerTexture, false);
+		graph.AddPass("2D", LogPass, &passes[0], STATE_2D);
+
+		if (dirty) {
+			pass = graph.AddPass("Text", LogPass, &passes[1], STATE_2D);
+			graph.Write(pass, layer);
+		}
+
+		pass = graph.AddPass("HUD Layer", LogPass, &passes[2], STATE_2D);
+		graph.Read(pass, layer);
+
+		graph.AddPass("3D", LogPass, &passes[3], STATE_3D);
+		graph.AddPass("Performance HUD", LogPass, &passes[4], STATE_2D);
+
+		CHECK(graph.Compile());
+		graph.Execute();
+
+		CHECK(graph.GetCulledCount() == 0 && graph.GetTransientCount() == 0);
+
+		if (dirty) {
+			CHECK(log.size() == 5);
+			CHECK(log[0] == 0 && log[1] == 1 && log[2] == 2 && log[3] == 3 && log[4] == 4);
+			CHECK(graph.GetTargetChanges() == 3 && graph.GetStateChanges() == 3);
+			CHECK(graph.GetTexture(layer) == layerTexture);
+		}
+		else {
+			CHECK(log.size() == 4);
+			CHECK(log[0] == 0 && log[1] == 2 && log[2] == 3 && log[3] == 4);
+			CHECK(graph.GetTargetChanges() == 1);
+		}
+	}
+
+	CHECK(backend.GetErrorCount() == 0);
+
+	graph.Shutdown();
+	backend.Release(layerTexture);
+	backend.Shutdown();
+}
+
+// A pass is kept when what it draws is needed: the back buffer, an imported output, or what a kept pass reads.
+static void TestCulling()
+{
+	HeadlessBackendClass backend;
+	FrameGraphClass		 graph;
+	vector<int>			 log;
+	PassLogType			 passes[8];
+	int					 used, unused, chained, imported, output, pass;
+
+	for (int i = 0; i < 8; i++) {
+		passes[i].log = &log;
+		passes[i].id  = i;
+	}
+
+	CHECK(graph.Initialize(&backend));
+
+	used	 = graph.CreateTexture(MakeDesc(16, 16));
+	unused	 = graph.CreateTexture(MakeDesc(16, 16));
+	chained	 = graph.CreateTexture(MakeDesc(16, 16));
+	imported = graph.ImportTexture(0, false);
+	output	 = graph.ImportTexture(0, true);
+
+	graph.Write(graph.AddPass("used", LogPass, &passes[0], STATE_2D), used);
+
+	// Nobody reads unused, so the pass that reads chained into it goes too, and the one that draws chained
+	graph.Write(graph.AddPass("chained", LogPass, &passes[1], STATE_2D), chained);
+	pass = graph.AddPass("unused", LogPass, &passes[2], STATE_2D);
+	graph.Read(pass, chained);
+	graph.Write(pass, unused);
+
+	graph.Write(graph.AddPass("imported", LogPass, &passes[3], STATE_2D), imported);
+	graph.Write(graph.AddPass("output", LogPass, &passes[4], STATE_2D), output);
+
+	pass = graph.AddPass("scene", LogPass, &passes[5], STATE_2D);
+	graph.Read(pass, used);
+
+	CHECK(graph.Compile());
+	CHECK(graph.GetCulledCount() == 3 && graph.GetPassCount() == 3);
+
+	graph.Execute();
+
+	CHECK(log.size() == 3);
+	CHECK(PositionOf(log, 0) >= 0 && PositionOf(log, 4) >= 0 && PositionOf(log, 5) >= 0);
+	CHECK(PositionOf(log, 1) < 0 && PositionOf(log, 2) < 0 && PositionOf(log, 3) < 0);
+
+	// The culled textures take nothing from the pool
+	CHECK(graph.GetTransientCount() == 1 && graph.GetPoolTexture(unused) < 0 && graph.GetPoolTexture(chained) < 0);
+
+	// A frame of culled passes draws nothing
+	graph.Reset();
+	log.clear();
+	graph.Write(graph.AddPass("unused", LogPass, &passes[2], STATE_2D), graph.CreateTexture(MakeDesc(16, 16)));
+
+	CHECK(graph.Compile());
+	CHECK(graph.GetCulledCount() == 1 && graph.GetPassCount() == 0);
+
+	graph.Execute();
+	CHECK(log.empty());
+
+	// The wrong declarations fail the compile
+	graph.Reset();
+	pass = graph.AddPass("self", LogPass, &passes[0], STATE_2D);
+	used = graph.CreateTexture(MakeDesc(16, 16));
+	graph.Write(pass, used);
+	graph.Read(pass, used);
+	CHECK(!graph.Compile());
+
+	graph.Reset();
+	graph.Read(graph.AddPass("back buffer", LogPass, &passes[0], STATE_2D), FRAME_GRAPH_BACK_BUFFER);
+	CHECK(!graph.Compile());
+
+	graph.Reset();
+	graph.AddPass("no function", 0, 0, STATE_2D);
+	CHECK(!graph.Compile());
+
+	graph.Shutdown();
+	backend.Shutdown();
+}
+
+static int CountCreates(HeadlessBackendClass *backend)
+{
+	CommandStreamClass *stream = backend->GetStream();
+	int					count  = 0;
+
+	stream->Rewind();
+
+	while (!stream->AtEnd() && stream->IsValid()) {
+		switch (stream->ReadByte()) {
+			case HEADLESS_CREATE_TEXTURE:
+				stream->ReadUint(); stream->ReadUint(); stream->ReadUint(); stream->ReadUint(); stream->ReadByte();
+				count++;
+
+				if (stream->ReadByte())
+					return -1;		// the graph makes its textures empty
+				break;
+
+			case HEADLESS_CREATE_STATE:		 stream->ReadUint(); stream->ReadByte(); break;
+			case HEADLESS_SET_RENDER_TARGET: stream->ReadUint(); break;
+			case HEADLESS_SET_STATE:		 stream->ReadUint(); break;
+			case HEADLESS_DRAW:				 stream->ReadUint(); stream->ReadUint(); break;
+			default:						 return -1;
+		}
+	}
+
+	return count;
+}
+
+// Declares a frame with four transient textures: first and second have the same size and don't overlap,
+// overlap lives across both of them and small has another size.
+static void DeclareAliasedFrame(FrameGraphClass *graph, PassLogType *passes, int *first, int *second, int *overlap, int *small)
+{
+	int pass;
+
+	graph->Reset();
+
+	*first	 = graph->CreateTexture(MakeDesc(256, 256));
+	*second	 = graph->CreateTexture(MakeDesc(256, 256));
+	*overlap = graph->CreateTexture(MakeDesc(256, 256));
+	*small	 = graph->CreateTexture(MakeDesc(128, 128));
+
+	graph->Write(graph->AddPass("first", LogPass, &passes[0], STATE_2D), *first);
+
+	pass = graph->AddPass("use first", LogPass, &passes[1], STATE_2D);
+	graph->Read(pass, *first);
+
+	// The second texture is drawn after the first is read for the last time; the overlapping one is drawn before and read after it
+	pass = graph->AddPass("overlap", LogPass, &passes[2], STATE_2D);
+	graph->Read(pass, *first);
+	graph->Write(pass, *overlap);
+
+	graph->Write(graph->AddPass("second", LogPass, &passes[3], STATE_2D), *second);
+	graph->Write(graph->AddPass("small", LogPass, &passes[4], STATE_2D), *small);
+
+	pass = graph->AddPass("use second", LogPass, &passes[5], STATE_2D);
+	graph->Read(pass, *second);
+	graph->Read(pass, *overlap);
+	graph->Read(pass, *small);
+}
+
+static void TestAliasing()
+{
+	HeadlessBackendClass backend;
+	FrameGraphClass		 graph;
+	vector<int>			 log;
+	PassLogType			 passes[6];
+	int					 first, second, overlap, small;
+
+	for (int i = 0; i < 6; i++) {
+		passes[i].log = &log;
+		passes[i].id  = i;
+	}
+
+	CHECK(graph.Initialize(&backend));
+
+	DeclareAliasedFrame(&graph, passes, &first, &second, &overlap, &small);
+	CHECK(graph.Compile());
+
+	// The lifetimes in the order: first until "overlap", overlap from "overlap" on, second and small after it
+	CHECK(graph.GetTransientCount() == 4);
+	CHECK(graph.GetPoolTexture(first) >= 0 && graph.GetPoolTexture(first) == graph.GetPoolTexture(second));
+	CHECK(graph.GetPoolTexture(overlap) != graph.GetPoolTexture(first));
+	CHECK(graph.GetPoolTexture(small) != graph.GetPoolTexture(first) && graph.GetPoolTexture(small) != graph.GetPoolTexture(overlap));
+	CHECK(graph.GetPooledCount() == 3);
+
+	// Before Execute the pool has no textures, after it the shared one is the same handle
+	CHECK(graph.GetTexture(first) == 0);
+
+	graph.Execute();
+
+	CHECK(graph.GetTexture(first) != 0 && graph.GetTexture(first) == graph.GetTexture(second));
+	CHECK(graph.GetTexture(overlap) != 0 && graph.GetTexture(overlap) != graph.GetTexture(first));
+	CHECK(CountCreates(&backend) == 3);
+	CHECK(backend.GetErrorCount() == 0);
+
+	// The next frame reuses the pool and the states, it makes nothing
+	RenderBackendClass::HandleType shared = graph.GetTexture(first);
+
+	backend.GetStream()->Clear();
+
+	DeclareAliasedFrame(&graph, passes, &first, &second, &overlap, &small);
+	CHECK(graph.Compile());
+	graph.Execute();
+
+	CHECK(CountCreates(&backend) == 0);
+	CHECK(graph.GetTexture(first) == shared && graph.GetTexture(second) == shared);
+
+	// Shutdown releases the pool and the states, the backend has nothing left
+	backend.GetStream()->Clear();
+	graph.Shutdown();
+
+	CommandStreamClass *stream	 = backend.GetStream();
+	int					releases = 0;
+
+	stream->Rewind();
+
+	while (!stream->AtEnd() && stream->IsValid()) {
+		CHECK(stream->ReadByte() == HEADLESS_RELEASE);
+		stream->ReadUint();
+		releases++;
+	}
+
+	CHECK(releases == 3 + 1);
+
+	backend.Shutdown();
+}
+
+int main()
+{
+	TestOrder();
+	TestGraphicsFrame();
+	TestCulling();
+	TestAliasing();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,277 @@
+// GlyphAtlasClass with a rasterizer that makes boxes: the UTF-8 decoding, the cache of the (codepoint, size) pairs,
+// the shelf packing (no two glyphs overlap, the pixels land where the glyph says), the dirty rectangles,
+// the LRU eviction of the pages, and the worker thread delivering the glyphs a few Updates later.
+
+#include "__testCheck.h"
+#include "__glyphAtlasClass.h"
+
+#include <atomic>
+#include <chrono>
+using namespace std;
+
+// Every glyph is a box filled with the low byte of its codepoint (never 0), the space is empty
+class BoxRasterizerClass : public GlyphRasterizerClass {
+ public:
+	BoxRasterizerClass() : calls(0), width(0) {}
+
+	bool RasterizeGlyph(unsigned int codepoint, int size, GlyphBitmapType *bitmap)
+	{
+		calls++;
+
+		bitmap->width	 = codepoint == ' ' ? 0 : (width ? width : 3 + codepoint % 6);
+		bitmap->height	 = codepoint == ' ' ? 0 : size;
+		bitmap->bearingX = 1;
+		bitmap->bearingY = size;
+		bitmap->advance	 = (float)bitmap->width + 1.0f;
+		bitmap->pixels.assign(bitmap->width * bitmap->height, (unsigned char)(codepoint % 255 + 1));
+
+		return true;
+	}
+
+	void GetLineMetrics(int size, int *ascent, int *lineHeight)
+	{
+		*ascent		= size;
+		*lineHeight = size + size / 4;
+	}
+
+	atomic<int> calls;
+	int			width;		// 0 for widths going with the codepoint
+};
+
+static void TestUtf8()
+{
+	unsigned int codepoint;
+
+	CHECK(GlyphAtlasClass::DecodeUtf8("A", &codepoint) == 1 && codepoint == 'A');
+	CHECK(GlyphAtlasClass::DecodeUtf8("\xC3\xA9", &codepoint) == 2 && codepoint == 0xE9);
+	CHECK(GlyphAtlasClass::DecodeUtf8("\xE2\x82\xAC", &codepoint) == 3 && codepoint == 0x20AC);
+	CHECK(GlyphAtlasClass::DecodeUtf8("\xF0\x9F\x98\x80", &codepoint) == 4 && codepoint == 0x1F600);
+	CHECK(GlyphAtlasClass::DecodeUtf8("", &codepoint) == 0 && codepoint == 0);
+
+	// A lonely continuation byte, a cut sequence, an overlong form and a surrogate
+	CHECK(GlyphAtlasClass::DecodeUtf8("\x80", &codepoint) == 1 && codepoint == 0xFFFD);
+	CHECK(GlyphAtlasClass::DecodeUtf8("\xE2\x82", &codepoint) == 1 && codepoint == 0xFFFD);
+	CHECK(GlyphAtlasClass::DecodeUtf8("\xC0\xAF", &codepoint) == 1 && codepoint == 0xFFFD);
+	CHECK(GlyphAtlasClass::DecodeUtf8("\xED\xA0\x80", &codepoint) == 1 && codepoint == 0xFFFD);
+}
+
+// Without the worker a glyph is there at the first lookup, and it is rasterized once per (codepoint, size)
+static void TestCache()
+{
+	BoxRasterizerClass rasterizer;
+	GlyphAtlasClass	   atlas;
+
+	CHECK(atlas.Initialize(&rasterizer, 64, 2, false));
+	atlas.Update();
+
+	const GlyphAtlasClass::GlyphType *glyph = atlas.FindGlyph(0x20AC, 12);
+
+	CHECK(glyph != 0);
+	CHECK(!atlas.IsPending());
+	CHECK(glyph && glyph->width == 3 + 0x20AC % 6 && glyph->height == 12);
+	CHECK(glyph && glyph->bearingX == 1 && glyph->bearingY == 12 && glyph->advance == glyph->width + 1.0f);
+
+	atlas.FindGlyph(0x20AC, 12);
+	CHECK(rasterizer.calls == 1);
+
+	// Another size is another glyph
+	CHECK(atlas.FindGlyph(0x20AC, 20) != 0);
+	CHECK(rasterizer.calls == 2);
+	CHECK(atlas.GetGlyphCount() == 2);
+
+	// The space is cached without pixels
+	glyph = atlas.FindGlyph(' ', 12);
+	CHECK(glyph && glyph->page == -1 && glyph->advance == 1.0f);
+	atlas.FindGlyph(' ', 12);
+	CHECK(rasterizer.calls == 3);
+
+	atlas.Shutdown();
+}
+
+// Many glyphs of different sizes: all inside their page, none overlapping another one or its padding, the pixels copied in place
+static void TestPacking()
+{
+	BoxRasterizerClass rasterizer;
+	GlyphAtlasClass	   atlas;
+	int				   size = 128;
+
+	CHECK(atlas.Initialize(&rasterizer, size, 4, false));
+	atlas.Update();
+
+	vector<GlyphAtlasClass::GlyphType> glyphs;
+
+	for (unsigned int codepoint = 0x400; codepoint < 0x400 + 200; codepoint++) {
+		const GlyphAtlasClass::GlyphType *glyph = atlas.FindGlyph(codepoint, 8 + codepoint % 9);
+
+		CHECK(glyph != 0);
+		if (glyph)
+			glyphs.push_back(*glyph);
+	}
+
+	CHECK(atlas.GetEvictionCount() == 0);
+	CHECK(atlas.GetPageCount() > 1 && atlas.GetPageCount() <= 4);
+
+	for (size_t i = 0; i < glyphs.size(); i++) {
+		const GlyphAtlasClass::GlyphType &a = glyphs[i];
+		unsigned char value = (unsigned char)((0x400 + i) % 255 + 1);
+
+		CHECK(a.x >= 0 && a.y >= 0 && a.x + a.width < size && a.y + a.height < size);
+
+		// One pixel of padding on the right and at the bottom of every glyph
+		for (size_t j = i + 1; j < glyphs.size(); j++) {
+			const GlyphAtlasClass::GlyphType &b = glyphs[j];
+
+			if (a.page == b.page)
+				CHECK(a.x + a.width + 1 <= b.x || b.x + b.width + 1 <= a.x || a.y + a.height + 1 <= b.y || b.y + b.height + 1 <= a.y);
+		}
+
+		const unsigned char *pixels = atlas.GetPagePixels(a.page);
+		bool inPlace = true;
+
+		for (int y = 0; y < a.height; y++)
+			for (int x = 0; x < a.width; x++)
+				inPlace = inPlace && pixels[(a.y + y) * size + a.x + x] == value;
+
+		CHECK(inPlace);
+		CHECK(pixels[(a.y + a.height) * size + a.x] == 0 && pixels[a.y * size + a.x + a.width] == 0);
+	}
+
+	atlas.Shutdown();
+}
+
+static void TestDirtyRect()
+{
+	BoxRasterizerClass rasterizer;
+	GlyphAtlasClass	   atlas;
+	int				   left, top, right, bottom;
+
+	CHECK(atlas.Initialize(&rasterizer, 64, 1, false));
+	atlas.Update();
+
+	const GlyphAtlasClass::GlyphType *a = atlas.FindGlyph('a', 10);
+
+	CHECK(atlas.GetDirtyRect(0, &left, &top, &right, &bottom));
+	CHECK(a && left == a->x && top == a->y && right == a->x + a->width && bottom == a->y + a->height);
+
+	atlas.ClearDirtyRect(0);
+	CHECK(!atlas.GetDirtyRect(0, &left, &top, &right, &bottom));
+
+	const GlyphAtlasClass::GlyphType *b = atlas.FindGlyph('b', 12);
+
+	CHECK(atlas.GetDirtyRect(0, &left, &top, &right, &bottom));
+	CHECK(b && left == b->x && right == b->x + b->width && bottom == b->y + b->height);
+
+	atlas.Shutdown();
+}
+
+// Pages of 16 pixels hold four 7 x 7 glyphs (8 x 8 with the padding); two pages make eight glyphs
+static void FillPages(GlyphAtlasClass *atlas, unsigned int first)
+{
+	for (unsigned int codepoint = first; codepoint < first + 8; codepoint++)
+		atlas->FindGlyph(codepoint, 7);
+}
+
+static void TestEviction()
+{
+	BoxRasterizerClass rasterizer;
+	GlyphAtlasClass	   atlas;
+	const unsigned int *version;
+	unsigned int		seen;
+
+	rasterizer.width = 7;
+
+	CHECK(atlas.Initialize(&rasterizer, 16, 2, false));
+	atlas.Update();
+
+	FillPages(&atlas, 'a');
+
+	CHECK(atlas.GetPageCount() == 2 && atlas.GetGlyphCount() == 8);
+	CHECK(atlas.FindGlyph('a', 7)->page == 0 && atlas.FindGlyph('e', 7)->page == 1);
+
+	// The pages were both used this frame: the new glyph waits for the next Update rather than clear text being drawn
+	CHECK(atlas.FindGlyph('i', 7) == 0);
+	CHECK(atlas.IsPending());
+	CHECK(atlas.GetEvictionCount() == 0);
+
+	// Next frame the pages are free again, the first one of the two goes for it
+	atlas.Update();
+	CHECK(atlas.GetEvictionCount() == 1);
+	CHECK(!atlas.IsPending());
+	CHECK(atlas.GetGlyphCount() == 5);
+	CHECK(atlas.FindGlyph('i', 7)->page == 0);
+
+	atlas.Update();
+	atlas.FindGlyph('i', 7);
+	atlas.FindGlyph('a', 7);
+	atlas.Update();
+
+	version = atlas.GetVersionCounter();
+	seen	= *version;
+
+	FillPages(&atlas, 'A');
+
+	// 'i' and 'a' were drawn last frame and share their page with the first new glyphs, the page of the older glyphs goes
+	CHECK(atlas.GetEvictionCount() == 2);
+	CHECK(atlas.FindGlyph('A', 7)->page == 0 && atlas.FindGlyph('C', 7)->page == 1);
+	CHECK(*version != seen);
+
+	int calls = rasterizer.calls;
+
+	CHECK(atlas.FindGlyph('i', 7) != 0);
+	CHECK(rasterizer.calls == calls);
+
+	// An evicted glyph is rasterized again when some text needs it
+	atlas.Update();
+	CHECK(atlas.FindGlyph('b', 7) != 0);
+	CHECK(rasterizer.calls == calls + 1);
+
+	atlas.Shutdown();
+}
+
+// The worker rasterizes, Update packs: the glyph shows up after some frames and the rasterizer is called once
+static void TestThreaded()
+{
+	BoxRasterizerClass rasterizer;
+	GlyphAtlasClass	   atlas;
+
+	CHECK(atlas.Initialize(&rasterizer, 64, 2, true));
+	atlas.Update();
+
+	const char *text = "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82";
+	int			missing = 1;
+
+	for (int frame = 0; frame < 1000 && missing; frame++) {
+		unsigned int codepoint;
+
+		missing = 0;
+
+		for (const char *c = text; *c; ) {
+			c += GlyphAtlasClass::DecodeUtf8(c, &codepoint);
+
+			if (!atlas.FindGlyph(codepoint, 16))
+				missing++;
+		}
+
+		this_thread::sleep_for(chrono::milliseconds(1));
+		atlas.Update();
+	}
+
+	CHECK(missing == 0);
+	CHECK(!atlas.IsPending());
+	CHECK(rasterizer.calls == 6);
+	CHECK(atlas.GetGlyphCount() == 6);
+
+	atlas.Shutdown();
+}
+
+int main()
+{
+	TestUtf8();
+	TestCache();
+	TestPacking();
+	TestDirtyRect();
+	TestEviction();
+	TestThreaded();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,183 @@
+// GlyphTableClass: the glyph ids of the characters of the ASCII fonts, with the characters the fonts don't have,
+// and ExpandVertex, the CPU twin of the instanced font vertex shader, against the six vertices a letter was made of
+// before the instancing (FontClass::BuildVertexArray): the instances of a sentence expand to the same quads.
+
+#include "__testCheck.h"
+#include "__glyphTableClass.h"
+#include "__textBatchClass.h"
+
+#include <string.h>
+#include <vector>
+using namespace std;
+
+#define SCREEN_WIDTH  800
+#define SCREEN_HEIGHT 600
+
+static void TestAsciiGlyphs()
+{
+	CHECK(GlyphTableClass::GetAsciiGlyph(' ') == 0);
+	CHECK(GlyphTableClass::GetAsciiGlyph('!') == 1);
+	CHECK(GlyphTableClass::GetAsciiGlyph('A') == 'A' - 32);
+	CHECK(GlyphTableClass::GetAsciiGlyph('~') == 94);
+
+	// Control characters, DEL and the bytes of UTF-8 sequences have no glyph
+	CHECK(GlyphTableClass::GetAsciiGlyph('\n') == -1);
+	CHECK(GlyphTableClass::GetAsciiGlyph('\t') == -1);
+	CHECK(GlyphTableClass::GetAsciiGlyph(31) == -1);
+	CHECK(GlyphTableClass::GetAsciiGlyph(127) == -1);
+
+	const char *utf8 = "\xC3\xA9\xE2\x82\xAC";
+
+	for (int i = 0; utf8[i]; i++)
+		CHECK(GlyphTableClass::GetAsciiGlyph(utf8[i]) == -1);
+
+	// Every id is inside the glyph table of the font
+	for (int c = -128; c < 128; c++) {
+		int glyph = GlyphTableClass::GetAsciiGlyph((char)c);
+
+		CHECK(glyph >= -1 && glyph < 95);
+		CHECK((glyph >= 0) == (c >= 32 && c <= 126));
+	}
+}
+
+// The font data of FontClass: the texture coordinates of the left and right of a letter, and its width in pixels
+struct FontType {
+	float left, right;
+	int	  size;
+};
+
+static void MakeFont(FontType *font)
+{
+	for (int letter = 0; letter < 95; letter++) {
+		font[letter].size  = letter == 0 ? 0 : 4 + letter % 5;
+		font[letter].left  = letter / 95.0f;
+		font[letter].right = font[letter].left + font[letter].size / 1024.0f;
+	}
+}
+
+// FontClass::BuildGlyphTable and FontClass::BuildMetrics
+static void FillTables(const FontType *font, GlyphTableClass *table, FontMetricsClass *metrics)
+{
+	for (int letter = 0; letter < 95; letter++) {
+		GlyphTableClass::GlyphType			glyph = { 0.0f, 0.0f, (float)font[letter].size, 16.0f, font[letter].left, 0.0f, font[letter].right, 1.0f };
+		FontMetricsClass::GlyphMetricsType	box	  = { letter == 0 ? 3.0f : font[letter].size + 1.0f, 0.0f, 0.0f, (float)font[letter].size, 16.0f, letter != 0 };
+
+		table->SetGlyph(letter, glyph);
+		metrics->AddGlyph(letter + 32, box);
+	}
+
+	metrics->SetLineMetrics(16.0f, 18.0f);
+}
+
+// The six vertices of a letter of FontClass::BuildVertexArray, the way the text was drawn before the instancing
+struct VertexType {
+	float x, y;
+	float u, v;
+};
+
+static void BuildVertexArray(const FontType *font, const char *sentence, float drawX, float drawY, vector<VertexType> *vertices)
+{
+	for (int i = 0; sentence[i]; i++) {
+		int letter = GlyphTableClass::GetAsciiGlyph(sentence[i]);
+
+		if (letter < 0)
+			continue;
+
+		if (letter == 0) {
+			drawX = drawX + 3.0f;
+			continue;
+		}
+
+		float	   right = drawX + font[letter].size;
+		VertexType quad[6] = {
+			{ drawX, drawY,		   font[letter].left,  0.0f },	// Top left.
+			{ right, drawY - 16,   font[letter].right, 1.0f },	// Bottom right.
+			{ drawX, drawY - 16,   font[letter].left,  1.0f },	// Bottom left.
+			{ drawX, drawY,		   font[letter].left,  0.0f },	// Top left.
+			{ right, drawY,		   font[letter].right, 0.0f },	// Top right.
+			{ right, drawY - 16,   font[letter].right, 1.0f },	// Bottom right.
+		};
+
+		vertices->insert(vertices->end(), quad, quad + 6);
+
+		drawX = drawX + font[letter].size + 1.0f;
+	}
+}
+
+static void TestExpansion()
+{
+	FontType		 font[95];
+	GlyphTableClass	 table;
+	FontMetricsClass metrics;
+	TextBatchClass	 batch;
+	const char		*sentence = "Fps: 60, Cpu: 12% {x|y}~";
+	unsigned int	 color	  = GlyphTableClass::PackColor(0.2f, 0.4f, 0.6f, 1.0f);
+
+	MakeFont(font);
+	FillTables(font, &table, &metrics);
+
+	// The instances the text of TextOutClass makes for the sentence at (100, 50)
+	vector<GlyphTableClass::InstanceType> instances(64);
+
+	CHECK(batch.Initialize(&metrics, SCREEN_WIDTH, SCREEN_HEIGHT, 64));
+	batch.UpdateSentence(batch.AddSentence(32), sentence, 100, 50, color);
+	instances.resize(batch.WriteInstances(&instances[0]));
+
+	vector<VertexType> reference;
+	BuildVertexArray(font, sentence, -400.0f + 100.0f, 300.0f - 50.0f, &reference);
+
+	CHECK(reference.size() == instances.size() * 6);
+
+	int mismatches = 0;
+
+	for (size_t i = 0; i < instances.size() && i * 6 < reference.size(); i++)
+		for (int corner = 0; corner < 6; corner++) {
+			GlyphTableClass::ExpandedVertexType vertex;
+			const VertexType &expected = reference[i * 6 + corner];
+
+			GlyphTableClass::ExpandVertex(table.GetGlyphs(), instances[i], corner, &vertex);
+
+			if (vertex.x != expected.x || vertex.y != expected.y || fabsf(vertex.u - expected.u) > 1e-6f || vertex.v != expected.v)
+				mismatches++;
+
+			if (fabsf(vertex.r - 0.2f) > 0.5f / 255.0f || fabsf(vertex.g - 0.4f) > 0.5f / 255.0f || fabsf(vertex.b - 0.6f) > 0.5f / 255.0f || vertex.a != 1.0f)
+				mismatches++;
+		}
+
+	CHECK(mismatches == 0);
+
+	// An instance is 16 bytes against the six vertices of 36 bytes of FontClass, and the table is two float4 per glyph
+	CHECK(sizeof(GlyphTableClass::InstanceType) == 16);
+	CHECK(sizeof(GlyphTableClass::GlyphType) == 32);
+
+	// A glyph id past the table reads the last glyph, as the shader clamps it
+	GlyphTableClass::GlyphType		last = { 1.0f, 2.0f, 3.0f, 4.0f, 0.5f, 0.5f, 0.75f, 1.0f };
+	GlyphTableClass::InstanceType	bad	 = { 10.0f, 20.0f, 100000, 0xFFFFFFFF };
+	GlyphTableClass::ExpandedVertexType vertex;
+
+	table.SetGlyph(GLYPH_TABLE_MAX_GLYPHS - 1, last);
+	GlyphTableClass::ExpandVertex(table.GetGlyphs(), bad, 1, &vertex);
+
+	CHECK(vertex.x == 10.0f + 1.0f + 3.0f && vertex.y == 20.0f - 2.0f - 4.0f);
+	CHECK(vertex.u == 0.75f && vertex.v == 1.0f);
+	CHECK(!table.SetGlyph(GLYPH_TABLE_MAX_GLYPHS, last));
+
+	batch.Shutdown();
+}
+
+// PackColor puts red in the lowest byte and rounds, out of range values are clamped
+static void TestPackColor()
+{
+	CHECK(GlyphTableClass::PackColor(1.0f, 0.0f, 0.0f, 0.0f) == 0x000000FF);
+	CHECK(GlyphTableClass::PackColor(0.0f, 0.0f, 0.0f, 1.0f) == 0xFF000000);
+	CHECK(GlyphTableClass::PackColor(0.5f, -1.0f, 2.0f, 1.0f) == 0xFFFF0080);
+}
+
+int main()
+{
+	TestAsciiGlyphs();
+	TestExpansion();
+	TestPackColor();
+
+	return TEST_RESULT();
+}
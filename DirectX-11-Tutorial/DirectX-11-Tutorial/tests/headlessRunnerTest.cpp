@@ -0,0 +1,111 @@
+// HeadlessRunnerClass: two runs of the same frames give the same hashes frame by frame, on one runner and on two,
+// recorded by the headless backend and drawn by the software one. The particles start over with every run.
+// Then RunCommandLine with the options of the headless program: the frames of -frames, the CSV and the images of -images.
+
+#include "__testCheck.h"
+#include "__headlessRunnerClass.h"
+
+#include <stdio.h>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+static void GetHashes(HeadlessRunnerClass *runner, vector<unsigned long long> *hashes, vector<int> *particles)
+{
+	hashes->clear();
+	particles->clear();
+
+	for (int i = 0; i < runner->GetFrameCount(); i++) {
+		hashes->push_back(runner->GetFrame(i).hash);
+		particles->push_back(runner->GetFrame(i).particles);
+	}
+}
+
+static void TestRuns(int mode, int frameCount)
+{
+	HeadlessRunnerClass		   runner, other;
+	vector<unsigned long long> first, second, third;
+	vector<int>				   firstParticles, secondParticles, thirdParticles;
+
+	CHECK(runner.Initialize(mode, 160, 120, 2, 20000));
+	CHECK(other.Initialize(mode, 160, 120, 2, 20000));
+
+	CHECK(runner.Run(frameCount, 1000.0f / 60.0f, 0));
+	CHECK(runner.GetFrameCount() == frameCount);
+	GetHashes(&runner, &first, &firstParticles);
+
+	// The same runner again, from the start
+	CHECK(runner.Run(frameCount, 1000.0f / 60.0f, 0));
+	GetHashes(&runner, &second, &secondParticles);
+
+	CHECK(first == second);
+	CHECK(firstParticles == secondParticles);
+
+	// Another runner draws the same frames
+	CHECK(other.Run(frameCount, 1000.0f / 60.0f, 0));
+	GetHashes(&other, &third, &thirdParticles);
+
+	CHECK(first == third);
+	CHECK(firstParticles == thirdParticles);
+
+	// The frames are not all the same: the particles come out and move
+	CHECK(firstParticles.back() > 0);
+	CHECK(first.front() != first.back());
+
+	other.Shutdown();
+	runner.Shutdown();
+}
+
+static int CountLines(const char *filename)
+{
+	ifstream fin(filename);
+	string	 line;
+	int		 count = 0;
+
+	if (fin.fail())
+		return -1;
+
+	while (getline(fin, line))
+		count++;
+
+	return count;
+}
+
+static bool FileExists(const char *filename)
+{
+	ifstream fin(filename);
+
+	return !fin.fail();
+}
+
+static void TestCommandLine()
+{
+	CHECK(HeadlessRunnerClass::GetOption("-frames 12 -fixedstep 8.5", "-fixedstep", 0.0f) == 8.5f);
+	CHECK(HeadlessRunnerClass::GetOption("-frames 12", "-fixedstep", 3.0f) == 3.0f);
+
+	// The header line and a line for every frame
+	CHECK(HeadlessRunnerClass::RunCommandLine("-frames 5 -fixedstep 10 "));
+	CHECK(CountLines("headless.csv") == 6);
+	CHECK(!FileExists("headless_0000.tga"));
+
+	// The software frames saved as images, one for every frame, and the trace
+	CHECK(HeadlessRunnerClass::RunCommandLine("-frames 2 -fixedstep 10 -software -threads 2 -images -hud -trace "));
+	CHECK(CountLines("headless.csv") == 3);
+	CHECK(FileExists("headless_0000.tga") && FileExists("headless_0001.tga") && !FileExists("headless_0002.tga"));
+	CHECK(FileExists("headless_trace.json"));
+
+	remove("headless.csv");
+	remove("headless_0000.tga");
+	remove("headless_0001.tga");
+	remove("headless_trace.json");
+}
+
+int main()
+{
+	TestRuns(HEADLESS_RUNNER_RECORD, 90);
+	TestRuns(HEADLESS_RUNNER_SOFTWARE, 20);
+	TestCommandLine();
+
+	return TEST_RESULT();
+}
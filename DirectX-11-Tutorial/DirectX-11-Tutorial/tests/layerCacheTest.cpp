@@ -0,0 +1,172 @@
+// LayerCacheClass with mock targets that count their Begin / End calls: a layer is drawn once and then reused
+// until one of its version counters moves or it is invalidated, and a counter bumped while the layer is drawn does not make it dirty again.
+
+#include "__testCheck.h"
+#include "__layerCacheClass.h"
+
+class MockTargetClass : public LayerTargetClass {
+ public:
+	MockTargetClass() : begins(0), ends(0), fail(false) {}
+
+	bool BeginLayer() { begins++; return !fail; }
+	void EndLayer()	  { ends++; }
+
+	int	 begins, ends;
+	bool fail;
+};
+
+// The frame of GraphicsClass: draw the layer if it is dirty, then composite it either way
+static bool DrawFrame(LayerCacheClass &cache, int layer, unsigned int *bumpWhileDrawing = 0)
+{
+	if (cache.IsDirty(layer)) {
+		if (!cache.BeginLayer(layer))
+			return false;
+
+		if (bumpWhileDrawing)
+			(*bumpWhileDrawing)++;
+
+		cache.EndLayer(layer);
+	}
+
+	return true;
+}
+
+static void TestVersions()
+{
+	LayerCacheClass cache;
+	MockTargetClass hud, map;
+	unsigned int	text = 0, font = 0, tiles = 0;
+
+	int hudLayer = cache.AddLayer(&hud);
+	int mapLayer = cache.AddLayer(&map);
+
+	cache.WatchVersion(hudLayer, &text);
+	cache.WatchVersion(hudLayer, &font);
+	cache.WatchVersion(mapLayer, &tiles);
+
+	// A new layer is drawn on the first frame, then reused
+	for (int frame = 0; frame < 10; frame++) {
+		cache.ResetCounters();
+		DrawFrame(cache, hudLayer);
+		DrawFrame(cache, mapLayer);
+	}
+
+	CHECK(hud.begins == 1 && hud.ends == 1);
+	CHECK(map.begins == 1 && map.ends == 1);
+	CHECK(cache.GetRedrawCount() == 0 && cache.GetReuseCount() == 2);
+
+	// Any of the watched counters redraws its layer, and only that one
+	font++;
+
+	cache.ResetCounters();
+	DrawFrame(cache, hudLayer);
+	DrawFrame(cache, mapLayer);
+
+	CHECK(hud.begins == 2 && map.begins == 1);
+	CHECK(cache.GetRedrawCount() == 1 && cache.GetReuseCount() == 1);
+
+	// Several changes between two frames are one redraw
+	text++;
+	text++;
+	tiles++;
+
+	DrawFrame(cache, hudLayer);
+	DrawFrame(cache, hudLayer);
+	DrawFrame(cache, mapLayer);
+
+	CHECK(hud.begins == 3 && map.begins == 2);
+
+	// The counter only has to differ, a wrapped or lowered value is a change too
+	text = 0;
+	DrawFrame(cache, hudLayer);
+	CHECK(hud.begins == 4);
+
+	cache.Shutdown();
+}
+
+static void TestInvalidate()
+{
+	LayerCacheClass cache;
+	MockTargetClass first, second;
+	unsigned int	version = 7;
+
+	int a = cache.AddLayer(&first);
+	int b = cache.AddLayer(&second);
+
+	cache.WatchVersion(a, &version);
+
+	DrawFrame(cache, a);
+	DrawFrame(cache, b);
+
+	cache.Invalidate(a);
+	DrawFrame(cache, a);
+	DrawFrame(cache, b);
+
+	CHECK(first.begins == 2 && second.begins == 1);
+
+	// After a resize every layer is drawn again
+	cache.InvalidateAll();
+	DrawFrame(cache, a);
+	DrawFrame(cache, b);
+
+	CHECK(first.begins == 3 && second.begins == 2);
+
+	cache.Shutdown();
+}
+
+// Drawing a layer can bump its own counters (a bitmap updating its buffer on its first Render):
+// the values are taken at EndLayer, so this does not make the layer dirty for the next frame
+static void TestBumpWhileDrawing()
+{
+	LayerCacheClass cache;
+	MockTargetClass target;
+	unsigned int	version = 0;
+
+	int layer = cache.AddLayer(&target);
+
+	cache.WatchVersion(layer, &version);
+
+	DrawFrame(cache, layer, &version);
+	DrawFrame(cache, layer, &version);
+	DrawFrame(cache, layer, &version);
+
+	CHECK(target.begins == 1);
+	CHECK(version == 1);
+
+	cache.Shutdown();
+}
+
+// A target that cannot be bound leaves the layer dirty, and the EndLayer of a layer that was not begun does nothing
+static void TestFailedTarget()
+{
+	LayerCacheClass cache;
+	MockTargetClass target;
+
+	int layer = cache.AddLayer(&target);
+
+	target.fail = true;
+
+	CHECK(!DrawFrame(cache, layer));
+	cache.EndLayer(layer);
+
+	CHECK(target.begins == 1 && target.ends == 0);
+	CHECK(cache.IsDirty(layer));
+
+	target.fail = false;
+
+	CHECK(DrawFrame(cache, layer));
+	CHECK(!cache.IsDirty(layer));
+	CHECK(target.begins == 2 && target.ends == 1);
+
+	cache.Shutdown();
+}
+
+int main()
+{
+	TestVersions();
+	TestInvalidate();
+	TestBumpWhileDrawing();
+	TestFailedTarget();
+
+	return TEST_RESULT();
+}
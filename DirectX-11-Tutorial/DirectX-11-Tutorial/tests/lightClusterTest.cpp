@@ -0,0 +1,327 @@
+// LightClusterClass against brute force, with the cluster counts of ClusteredLightsClass and a few thousand point and spot lights
+// seen from a turned camera. The brute force tests every light against the bounding box of every cluster:
+// the binning must keep a subset of that (it only skips the tiles the sphere can't project onto), and miss no cluster
+// the light really reaches, which is checked with points inside the lights. The grid must not depend on the threads,
+// and a cluster that is full drops the lights past its limit, in order.
+
+#include "__testCheck.h"
+#include "__lightClusterClass.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+using namespace std;
+
+#define CLUSTERS_X 16
+#define CLUSTERS_Y 9
+#define CLUSTERS_Z 24
+#define NEAR_Z	   0.5f
+#define FAR_Z	   200.0f
+
+static float Random(float low, float high)
+{
+	return low + (high - low) * (float)rand() / RAND_MAX;
+}
+
+// Half the lights are spot lights of 10 to 80 degrees, pointing anywhere
+static void MakeLights(vector<ClusterLightType> *lights, int count)
+{
+	lights->resize(count);
+
+	for (int i = 0; i < count; i++) {
+		ClusterLightType &light = (*lights)[i];
+		float			  length;
+
+		light.position[0] = Random(-80.0f, 80.0f);
+		light.position[1] = Random(-30.0f, 30.0f);
+		light.position[2] = Random(-40.0f, 220.0f);
+		light.range		  = Random(1.0f, 15.0f);
+		light.color[0]	  = light.color[1] = light.color[2] = 1.0f;
+		light.spotCos	  = i % 2 ? cosf(Random(5.0f, 40.0f) * 3.14159265f / 180.0f) : -1.0f;
+		light.padding	  = 0.0f;
+
+		do {
+			for (int k = 0; k < 3; k++)
+				light.direction[k] = Random(-1.0f, 1.0f);
+
+			length = sqrtf(light.direction[0] * light.direction[0] + light.direction[1] * light.direction[1] + light.direction[2] * light.direction[2]);
+		} while (length < 0.1f);
+
+		for (int k = 0; k < 3; k++)
+			light.direction[k] /= length;
+	}
+}
+
+// A camera at (5, 2, -10) turned 0.3 radians about the y axis, in the D3DX order: row vectors, translation in the last row
+static void MakeView(float *view)
+{
+	float angle = 0.3f, c = cosf(angle), s = sinf(angle);
+	float eye[3] = { 5.0f, 2.0f, -10.0f };
+	float rows[3][3] = { { c, 0.0f, s }, { 0.0f, 1.0f, 0.0f }, { -s, 0.0f, c } };
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++)
+			view[i * 4 + j] = rows[i][j];
+
+		view[i * 4 + 3] = 0.0f;
+	}
+
+	for (int j = 0; j < 3; j++)
+		view[12 + j] = -(eye[0] * rows[0][j] + eye[1] * rows[1][j] + eye[2] * rows[2][j]);
+
+	view[15] = 1.0f;
+}
+
+static void Transform(const float *point, const float *view, float *result)
+{
+	for (int i = 0; i < 3; i++)
+		result[i] = point[0] * view[i] + point[1] * view[4 + i] + point[2] * view[8 + i] + view[12 + i];
+}
+
+// The lights of every cluster, by testing every light against every box
+static vector<vector<unsigned int> > BruteForce(LightClusterClass *clusters, const vector<ClusterLightType> &lights, const float *view)
+{
+	vector<vector<unsigned int> > result(clusters->GetClusterCount());
+	float						  sphere[4], min[3], max[3], d, distance2;
+
+	for (int c = 0; c < clusters->GetClusterCount(); c++) {
+		clusters->GetClusterBounds(c, min, max);
+
+		for (int l = 0; l < (int)lights.size(); l++) {
+			LightClusterClass::GetBoundingSphere(lights[l], view, sphere);
+
+			distance2 = 0.0f;
+
+			for (int k = 0; k < 3; k++) {
+				d = sphere[k] < min[k] ? min[k] - sphere[k] : (sphere[k] > max[k] ? sphere[k] - max[k] : 0.0f);
+				distance2 += d * d;
+			}
+
+			if (distance2 <= sphere[3] * sphere[3])
+				result[c].push_back(l);
+		}
+	}
+
+	return result;
+}
+
+static bool Contains(const unsigned int *grid, const unsigned int *indices, int cluster, unsigned int light)
+{
+	for (unsigned int i = 0; i < grid[cluster * 2 + 1]; i++)
+		if (indices[grid[cluster * 2] + i] == light)
+			return true;
+
+	return false;
+}
+
+static void TestAgainstBruteForce()
+{
+	LightClusterClass		 clusters;
+	vector<ClusterLightType> lights;
+	float					 view[16];
+
+	srand(42);
+	MakeLights(&lights, 2000);
+	MakeView(view);
+
+	CHECK(!clusters.Initialize(0, CLUSTERS_Y, CLUSTERS_Z, 256, 1));
+	CHECK(clusters.Initialize(CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z, 2000, 1));
+
+	// A 16:9 screen with a 45 degree vertical field of view
+	clusters.SetFrustum(0.41421356f * 16.0f / 9.0f, 0.41421356f, NEAR_Z, FAR_Z);
+	clusters.Bin(&lights[0], (int)lights.size(), view);
+
+	vector<vector<unsigned int> > expected = BruteForce(&clusters, lights, view);
+	const unsigned int			 *grid	   = clusters.GetGrid();
+	const unsigned int			 *indices  = clusters.GetIndices();
+	int							  binned = 0, bruteForce = 0, offset = 0;
+	bool						  subset = true, ordered = true, packed = true;
+
+	CHECK(clusters.GetDroppedCount() == 0);
+
+	for (int c = 0; c < clusters.GetClusterCount(); c++) {
+		packed = packed && grid[c * 2] == (unsigned int)offset;
+		offset += grid[c * 2 + 1];
+
+		for (unsigned int i = 0; i < grid[c * 2 + 1]; i++) {
+			unsigned int light = indices[grid[c * 2] + i];
+			bool		 found = false;
+
+			for (size_t j = 0; j < expected[c].size() && !found; j++)
+				found = expected[c][j] == light;
+
+			subset	= subset && found;
+			ordered = ordered && (i == 0 || light > indices[grid[c * 2] + i - 1]);
+		}
+
+		binned	   += grid[c * 2 + 1];
+		bruteForce += (int)expected[c].size();
+	}
+
+	CHECK(packed && offset == clusters.GetIndexCount());
+	CHECK(subset);
+	CHECK(ordered);
+	CHECK(binned > 0 && binned <= bruteForce);
+
+	printf("%d light/cluster pairs binned, %d by brute force against the boxes\n", binned, bruteForce);
+
+	// Points inside the lights, 90% of the way out at most: the cluster of each one must have the light
+	int	 points = 0;
+	bool covered = true;
+
+	for (int l = 0; l < (int)lights.size(); l++) {
+		const ClusterLightType &light = lights[l];
+
+		for (int n = 0; n < 50; n++) {
+			float point[3], offsetDir[3], viewPoint[3], length, distance;
+
+			do {
+				for (int k = 0; k < 3; k++)
+					offsetDir[k] = Random(-1.0f, 1.0f);
+
+				length = sqrtf(offsetDir[0] * offsetDir[0] + offsetDir[1] * offsetDir[1] + offsetDir[2] * offsetDir[2]);
+			} while (length < 0.1f || length > 1.0f);
+
+			// A spot light only lights its cone
+			if (light.spotCos > 0.0f &&
+				(offsetDir[0] * light.direction[0] + offsetDir[1] * light.direction[1] + offsetDir[2] * light.direction[2]) / length < light.spotCos)
+				continue;
+
+			distance = Random(0.0f, 0.9f) * light.range;
+
+			for (int k = 0; k < 3; k++)
+				point[k] = light.position[k] + offsetDir[k] / length * distance;
+
+			Transform(point, view, viewPoint);
+
+			int cluster = clusters.GetCluster(viewPoint[0], viewPoint[1], viewPoint[2]);
+
+			if (cluster < 0)
+				continue;
+
+			covered = covered && Contains(grid, indices, cluster, l);
+			points++;
+		}
+	}
+
+	CHECK(points > 1000);
+	CHECK(covered);
+
+	clusters.Shutdown();
+}
+
+// The grid is the same with 1, 3 and 4 threads, frame after frame
+static void TestThreads()
+{
+	LightClusterClass		 clusters[3];
+	int						 threads[3] = { 1, 3, 4 };
+	vector<ClusterLightType> lights;
+	float					 view[16];
+
+	srand(7);
+	MakeView(view);
+
+	for (int t = 0; t < 3; t++) {
+		CHECK(clusters[t].Initialize(CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z, 64, threads[t]));
+		clusters[t].SetFrustum(0.7363797f, 0.41421356f, NEAR_Z, FAR_Z);
+	}
+
+	for (int frame = 0; frame < 5; frame++) {
+		MakeLights(&lights, 500 + frame * 500);
+
+		for (int t = 0; t < 3; t++)
+			clusters[t].Bin(&lights[0], (int)lights.size(), view);
+
+		for (int t = 1; t < 3; t++) {
+			bool same = clusters[t].GetIndexCount() == clusters[0].GetIndexCount() && clusters[t].GetDroppedCount() == clusters[0].GetDroppedCount();
+
+			for (int c = 0; c < clusters[0].GetClusterCount() * 2 && same; c++)
+				same = clusters[t].GetGrid()[c] == clusters[0].GetGrid()[c];
+
+			for (int i = 0; i < clusters[0].GetIndexCount() && same; i++)
+				same = clusters[t].GetIndices()[i] == clusters[0].GetIndices()[i];
+
+			CHECK(same);
+		}
+	}
+
+	for (int t = 0; t < 3; t++)
+		clusters[t].Shutdown();
+}
+
+// With room for 4 lights a cluster keeps the first 4 and counts the others as dropped
+static void TestLimit()
+{
+	LightClusterClass		 full, limited;
+	vector<ClusterLightType> lights;
+	float					 view[16];
+
+	srand(3);
+	MakeLights(&lights, 1000);
+	MakeView(view);
+
+	full.Initialize(CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z, 1000, 2);
+	limited.Initialize(CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z, 4, 2);
+	full.SetFrustum(0.7363797f, 0.41421356f, NEAR_Z, FAR_Z);
+	limited.SetFrustum(0.7363797f, 0.41421356f, NEAR_Z, FAR_Z);
+
+	full.Bin(&lights[0], (int)lights.size(), view);
+	limited.Bin(&lights[0], (int)lights.size(), view);
+
+	int	 dropped = 0;
+	bool first	 = true;
+
+	for (int c = 0; c < full.GetClusterCount(); c++) {
+		unsigned int count = full.GetGrid()[c * 2 + 1];
+		unsigned int kept  = count < 4 ? count : 4;
+
+		first = first && limited.GetGrid()[c * 2 + 1] == kept;
+
+		for (unsigned int i = 0; i < kept && first; i++)
+			first = limited.GetIndices()[limited.GetGrid()[c * 2] + i] == full.GetIndices()[full.GetGrid()[c * 2] + i];
+
+		dropped += count - kept;
+	}
+
+	CHECK(first);
+	CHECK(dropped > 0 && limited.GetDroppedCount() == dropped && full.GetDroppedCount() == 0);
+
+	full.Shutdown();
+	limited.Shutdown();
+}
+
+// A point on the axis of the camera is in the middle tiles, at the slice of its depth; out of the frustum is -1
+static void TestGetCluster()
+{
+	LightClusterClass clusters;
+
+	clusters.Initialize(4, 4, 8, 16, 1);
+	clusters.SetFrustum(1.0f, 1.0f, 1.0f, 256.0f);
+
+	// The slices of 1 to 256 in 8 are powers of 2
+	CHECK(clusters.GetCluster(0.1f, 0.1f, 1.5f) == (0 * 4 + 1) * 4 + 2);
+	CHECK(clusters.GetCluster(0.1f, 0.1f, 100.0f) == (6 * 4 + 1) * 4 + 2);
+	CHECK(clusters.GetCluster(-5.0f, -5.0f, 6.0f) == (2 * 4 + 3) * 4 + 0);
+	CHECK(clusters.GetCluster(0.0f, 0.0f, 0.5f) == -1);
+	CHECK(clusters.GetCluster(0.0f, 0.0f, 300.0f) == -1);
+	CHECK(clusters.GetCluster(10.0f, 0.0f, 5.0f) == -1);
+
+	float min[3], max[3];
+
+	clusters.GetClusterBounds((6 * 4 + 1) * 4 + 2, min, max);
+	CHECK_NEAR(min[2], 64.0f, 1e-3);
+	CHECK_NEAR(max[2], 128.0f, 1e-3);
+	CHECK(min[0] <= 0.1f && max[0] >= 0.1f && min[1] <= 0.1f && max[1] >= 0.1f);
+
+	clusters.Shutdown();
+}
+
+int main()
+{
+	TestAgainstBruteForce();
+	TestThreads();
+	TestLimit();
+	TestGetCluster();
+
+	return TEST_RESULT();
+}
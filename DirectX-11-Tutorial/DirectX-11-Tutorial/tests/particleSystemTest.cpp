@@ -0,0 +1,131 @@
+// ParticleSystemClass: the integration against the same formulas in scalar code, the lifetime and the curves,
+// and the free list: a full pool drops the spawns, the dead slots are used again, the compaction stops at the size of the array.
+
+#include "__testCheck.h"
+#include "__particleSystemClass.h"
+
+#include <vector>
+using namespace std;
+
+typedef ParticleSystemClass::InstanceType InstanceType;
+
+// One particle going right at 100 units a second, under gravity and drag, checked frame by frame
+static void TestIntegration()
+{
+	ParticleSystemClass particles;
+	vector<InstanceType> instances(4);
+	float				 dt = 0.1f;
+	float				 posX = 10.0f, posY = 20.0f, velX = 100.0f, velY = 0.0f;
+	float				 rotation = 0.0f;
+
+	CHECK(particles.Initialize(4));
+
+	// 10 particles a second for 0.1 s is exactly one
+	int emitter = particles.AddEmitter(10.0f, 20.0f, 10.0f);
+	particles.SetEmitterVelocity(emitter, 0.0f, 0.0f, 100.0f, 100.0f);
+	particles.SetEmitterLifetime(emitter, 1.0f, 1.0f);
+	particles.SetEmitterSpin(emitter, 2.0f, 2.0f);
+	particles.SetGravity(0.0f, -10.0f);
+	particles.SetDrag(0.5f);
+	particles.SetColorCurve(1.0f, 0.0f, 0.0f, 1.0f,   0.0f, 1.0f, 0.0f, 0.0f);
+	particles.SetSizeCurve(1.0f, 0.0f);
+
+	for (int frame = 1; frame <= 9; frame++) {
+		particles.Frame(dt);
+
+		if (frame == 1)
+			particles.SetEmitterActive(emitter, false);
+
+		// The same steps as the SSE kernel: velocity first, then the position with the new velocity
+		velX = (velX + 0.0f * dt) * (1.0f - 0.5f * dt);
+		velY = (velY - 10.0f * dt) * (1.0f - 0.5f * dt);
+		posX += velX * dt;
+		posY += velY * dt;
+
+		CHECK(particles.GetLiveCount() == 1);
+		CHECK(particles.BuildInstanceArray(&instances[0], 4) == 1);
+
+		CHECK_NEAR(instances[0].x, posX, 1e-3);
+		CHECK_NEAR(instances[0].y, posY, 1e-3);
+
+		// The first rotation is random, the spin adds 2 radians a second from there
+		if (frame == 1)
+			rotation = instances[0].rotation;
+		else
+			CHECK_NEAR(instances[0].rotation - rotation, 2.0f * dt * (frame - 1), 1e-4);
+
+		// The curves at the normalized age
+		float t = frame * dt;
+
+		CHECK_NEAR(instances[0].size, 1.0f - t, 1e-5);
+		CHECK_NEAR(instances[0].r, 1.0f - t, 1e-5);
+		CHECK_NEAR(instances[0].g, t, 1e-5);
+		CHECK_NEAR(instances[0].a, 1.0f - t, 1e-5);
+
+		// The whole texture
+		CHECK(instances[0].u == 0.0f && instances[0].v == 0.0f && instances[0].uWidth == 1.0f && instances[0].vHeight == 1.0f);
+	}
+
+	// The lifetime is 1 s, it is over after a few more frames
+	particles.Frame(dt);
+	particles.Frame(dt);
+
+	CHECK(particles.GetLiveCount() == 0);
+	CHECK(particles.BuildInstanceArray(&instances[0], 4) == 0);
+
+	particles.Shutdown();
+}
+
+// The pool of 5 particles has 8 slots; the emitter wants more than that
+static void TestFreeList()
+{
+	ParticleSystemClass particles;
+	vector<InstanceType> instances(16);
+
+	CHECK(!particles.Initialize(0));
+	CHECK(particles.Initialize(5));
+	CHECK(particles.GetCapacity() == 8);
+
+	int emitter = particles.AddEmitter(0.0f, 0.0f, 1000.0f);
+	particles.SetEmitterLifetime(emitter, 0.05f, 0.05f);
+	particles.SetGravity(0.0f, 0.0f);
+
+	// 10 spawns in the first frame, the pool takes 8 and the rest are dropped
+	particles.Frame(0.01f);
+	CHECK(particles.GetLiveCount() == 8);
+	CHECK(particles.BuildInstanceArray(&instances[0], 16) == 8);
+
+	// The compaction stops when the array is full
+	CHECK(particles.BuildInstanceArray(&instances[0], 3) == 3);
+
+	// Nothing happens without time
+	particles.Frame(0.0f);
+	CHECK(particles.GetLiveCount() == 8);
+
+	// All of them die together, then their slots are used again by the next spawns, over and over
+	particles.SetEmitterActive(emitter, false);
+	particles.Frame(0.05f);
+	CHECK(particles.GetLiveCount() == 0);
+
+	particles.SetEmitterActive(emitter, true);
+
+	for (int i = 0; i < 50; i++) {
+		particles.Frame(0.01f);
+
+		CHECK(particles.GetLiveCount() >= 0 && particles.GetLiveCount() <= particles.GetCapacity());
+		CHECK(particles.BuildInstanceArray(&instances[0], 16) == particles.GetLiveCount());
+	}
+
+	CHECK(particles.GetLiveCount() == 8);
+
+	particles.Shutdown();
+	CHECK(particles.GetCapacity() == 0);
+}
+
+int main()
+{
+	TestIntegration();
+	TestFreeList();
+
+	return TEST_RESULT();
+}
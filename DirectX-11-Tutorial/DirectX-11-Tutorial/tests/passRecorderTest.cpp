@@ -0,0 +1,180 @@
+// PassRecorderClass on a HeadlessBackendClass: the sprite passes of a frame, like the particles and the animated sprites of GraphicsClass,
+// are recorded on deferred contexts by 1, 2, 4 and 8 threads and executed. The stream the backend gets has to be the one
+// of the same passes rendered one after the other on the calling thread, byte for byte, frame after frame.
+// After every context the backend binds the back buffer again, the single-threaded stream does the same after every pass.
+
+#include "__testCheck.h"
+#include "__passRecorderClass.h"
+#include "__spritePassClass.h"
+#include "__headlessBackendClass.h"
+
+#include <string.h>
+#include <vector>
+using namespace std;
+
+#define PASS_COUNT	  6
+#define MAX_INSTANCES 256
+#define FRAME_COUNT	  5
+
+struct SceneType {
+	SpritePassClass						  passes[PASS_COUNT];
+	vector<SpritePassClass::InstanceType> instances[PASS_COUNT];
+};
+
+static bool CreateScene(RenderBackendClass *backend, SceneType *scene)
+{
+	RenderBackendClass::TextureDescType textureDesc = { 2, 2, RENDER_FORMAT_RGBA8, false };
+	RenderBackendClass::StateDescType	stateDesc	= { true, false, false, true };
+	SpritePassClass::HandleType			vertexShader, pixelShader, texture, state;
+	unsigned char						texels[16];
+
+	memset(texels, 255, sizeof(texels));
+
+	texture = backend->CreateTexture(textureDesc, texels, 8);
+	state	= backend->CreateState(stateDesc);
+
+	if (!SpritePassClass::CreateShaders(backend, 0, 0, 0, 0, &vertexShader, &pixelShader) || !texture || !state)
+		return false;
+
+	for (int i = 0; i < PASS_COUNT; i++)
+		if (!scene->passes[i].Initialize(backend, 24, MAX_INSTANCES, vertexShader, pixelShader, texture, state))
+			return false;
+
+	return true;
+}
+
+static void ShutdownScene(SceneType *scene)
+{
+	for (int i = 0; i < PASS_COUNT; i++)
+		scene->passes[i].Shutdown();
+}
+
+// Every pass draws another number of instances every frame, the third one none in the even frames.
+static void SetFrame(SceneType *scene, int frame)
+{
+	SpritePassClass::MatrixBufferType matrices;
+
+	for (int i = 0; i < PASS_COUNT; i++) {
+		int count = (i == 2 && frame % 2 == 0) ? 0 : 1 + (frame * 37 + i * 53) % MAX_INSTANCES;
+
+		scene->instances[i].resize(count + 1);
+
+		for (int j = 0; j < count; j++) {
+			float *values = &scene->instances[i][j].x;
+
+			for (int k = 0; k < 12; k++)
+				values[k] = frame * 10000.0f + i * 1000.0f + j + k * 0.5f;
+		}
+
+		float *values = &matrices.world.m[0][0];
+
+		for (int k = 0; k < 48; k++)
+			values[k] = frame + i * 0.25f + k;
+
+		scene->passes[i].SetInstances(&scene->instances[i][0], count);
+		scene->passes[i].SetMatrices(matrices);
+	}
+}
+
+static bool SameStreams(HeadlessBackendClass *a, HeadlessBackendClass *b)
+{
+	return a->GetStream()->GetSize() == b->GetStream()->GetSize() &&
+		   memcmp(a->GetStream()->GetData(), b->GetStream()->GetData(), a->GetStream()->GetSize()) == 0;
+}
+
+static void TestThreads(int threadCount)
+{
+	HeadlessBackendClass direct, recorded;
+	SceneType			 directScene, recordedScene;
+	PassRecorderClass	 recorder;
+
+	CHECK(CreateScene(&direct, &directScene));
+	CHECK(CreateScene(&recorded, &recordedScene));
+	CHECK(SameStreams(&direct, &recorded));
+
+	CHECK(recorder.Initialize(&recorded, threadCount));
+	CHECK(recorder.IsDeferred());
+
+	for (int i = 0; i < PASS_COUNT; i++)
+		recorder.AddPass(SpritePassClass::RecordPass, &recordedScene.passes[i]);
+
+	CHECK(recorder.GetPassCount() == PASS_COUNT);
+
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		direct.GetStream()->Clear();
+		direct.ResetCounters();
+		recorded.GetStream()->Clear();
+		recorded.ResetCounters();
+
+		SetFrame(&directScene, frame);
+		SetFrame(&recordedScene, frame);
+
+		for (int i = 0; i < PASS_COUNT; i++) {
+			CHECK(directScene.passes[i].Render(&direct));
+			direct.SetRenderTarget(0);
+		}
+
+		recorder.Record();
+
+		CHECK(recorded.GetErrorCount() == 0);
+		CHECK(recorded.GetDrawCount() == direct.GetDrawCount());
+		CHECK(recorded.GetCommandCount() == direct.GetCommandCount());
+		CHECK(SameStreams(&direct, &recorded));
+	}
+
+	recorder.Shutdown();
+	ShutdownScene(&recordedScene);
+	ShutdownScene(&directScene);
+
+	recorded.Shutdown();
+	direct.Shutdown();
+}
+
+// The passes are recorded again every Record, without them nothing is executed.
+static void TestPasses()
+{
+	HeadlessBackendClass backend;
+	SceneType			 scene;
+	PassRecorderClass	 recorder;
+
+	CHECK(!recorder.Initialize(0, 2));
+
+	CHECK(CreateScene(&backend, &scene));
+	CHECK(recorder.Initialize(&backend, 2));
+
+	SetFrame(&scene, 1);
+	backend.GetStream()->Clear();
+
+	recorder.Record();
+	CHECK(backend.GetStream()->GetSize() == 0);
+
+	recorder.AddPass(SpritePassClass::RecordPass, &scene.passes[0]);
+	recorder.AddPass(SpritePassClass::RecordPass, &scene.passes[1]);
+
+	backend.ResetCounters();
+	recorder.Record();
+	recorder.Record();
+	CHECK(backend.GetDrawCount() == 4 && backend.GetErrorCount() == 0);
+
+	recorder.ClearPasses();
+	CHECK(recorder.GetPassCount() == 0);
+
+	backend.GetStream()->Clear();
+	recorder.Record();
+	CHECK(backend.GetStream()->GetSize() == 0);
+
+	recorder.Shutdown();
+	ShutdownScene(&scene);
+	backend.Shutdown();
+}
+
+int main()
+{
+	TestThreads(1);
+	TestThreads(2);
+	TestThreads(4);
+	TestThreads(8);
+	TestPasses();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,223 @@
+// PerfHudBuilderClass with a glyph table of boxes of known sizes and texture rectangles: the letters of the text
+// placed like FontClass::BuildVertexArray, the bars of the graph with their heights and colors, the two reference lines,
+// and the vertices staying within GetMaxVertexCount whatever the history and the text.
+
+#include "__testCheck.h"
+#include "__perfHudBuilderClass.h"
+
+#include <string.h>
+#include <vector>
+using namespace std;
+
+#define SCREEN_WIDTH  800
+#define SCREEN_HEIGHT 600
+
+typedef PerfHudBuilderClass::VertexType VertexType;
+
+// Letter n of the ASCII range is 5 + n % 3 pixels wide and 16 high, its texture rectangle is column n of a 95 x 1 grid
+static void FillGlyphs(GlyphTableClass *glyphs)
+{
+	GlyphTableClass::GlyphType glyph;
+
+	memset(&glyph, 0, sizeof(glyph));
+	glyphs->Clear();
+	glyphs->SetGlyph(0, glyph);
+
+	for (int letter = 1; letter < 95; letter++) {
+		glyph.left	 = 0.0f;
+		glyph.top	 = 0.0f;
+		glyph.width	 = 5.0f + letter % 3;
+		glyph.height = 16.0f;
+		glyph.u0	 = letter / 95.0f;
+		glyph.u1	 = (letter + 1) / 95.0f;
+		glyph.v0	 = 0.0f;
+		glyph.v1	 = 1.0f;
+
+		glyphs->SetGlyph(letter, glyph);
+	}
+}
+
+static void Bounds(const VertexType *vertices, float *left, float *top, float *right, float *bottom)
+{
+	*left = *right	= vertices[0].x;
+	*top  = *bottom = vertices[0].y;
+
+	for (int i = 1; i < 6; i++) {
+		*left	= vertices[i].x < *left	  ? vertices[i].x : *left;
+		*right	= vertices[i].x > *right  ? vertices[i].x : *right;
+		*top	= vertices[i].y > *top	  ? vertices[i].y : *top;
+		*bottom = vertices[i].y < *bottom ? vertices[i].y : *bottom;
+	}
+}
+
+static void TestText()
+{
+	GlyphTableClass		glyphs;
+	PerfHudBuilderClass hud;
+	PerfStatsClass		stats;
+	vector<VertexType>	vertices(PerfHudBuilderClass::GetMaxVertexCount());
+
+	FillGlyphs(&glyphs);
+	CHECK(hud.Initialize(&glyphs, SCREEN_WIDTH, SCREEN_HEIGHT));
+	CHECK(!hud.Initialize(0, SCREEN_WIDTH, SCREEN_HEIGHT));
+	CHECK(hud.Initialize(&glyphs, SCREEN_WIDTH, SCREEN_HEIGHT));
+
+	CHECK(hud.GetTextVertexCount() == 0);
+
+	// The shader line adds a quad per letter, the space is only a gap
+	hud.BuildText(&stats, 0, 0.0f);
+	int withoutLine = hud.GetTextVertexCount();
+
+	hud.BuildText(&stats, "ab c", 0.0f);
+	int withLine = hud.GetTextVertexCount();
+
+	CHECK(withoutLine > 0 && withoutLine % 6 == 0);
+	CHECK(withLine == withoutLine + 3 * 6);
+
+	// WriteVertices starts with the text as it was built
+	int count = hud.WriteVertices(&stats, &vertices[0]);
+
+	CHECK(count == withLine + 2 * 6);
+
+	// The first line starts 10 pixels from the left of the screen, above the graph and the four other lines
+	float firstX = (float)(SCREEN_WIDTH / -2 + 10);
+	float firstY = (float)(SCREEN_HEIGHT / -2 + 10 + (int)(PERF_HUD_GRAPH_MAX * PERF_HUD_GRAPH_SCALE) + 5 * 18);
+	float left, top, right, bottom;
+
+	Bounds(&vertices[0], &left, &top, &right, &bottom);
+
+	// "frame": the box of the glyph from the pen, y going up, with its texture rectangle
+	int f = GlyphTableClass::GetAsciiGlyph('f');
+	const GlyphTableClass::GlyphType &glyph = glyphs.GetGlyphs()[f];
+
+	CHECK(left == firstX && right == firstX + glyph.width);
+	CHECK(top == firstY && bottom == firstY - 16.0f);
+
+	for (int i = 0; i < 6; i++) {
+		CHECK(vertices[i].u == glyph.u0 || vertices[i].u == glyph.u1);
+		CHECK(vertices[i].v == glyph.v0 || vertices[i].v == glyph.v1);
+		CHECK(vertices[i].z == 0.0f && vertices[i].a == 1.0f);
+	}
+
+	// The next letter is one pixel after the box
+	Bounds(&vertices[6], &left, &top, &right, &bottom);
+	CHECK(left == firstX + glyph.width + 1.0f);
+
+	// The shader line is the fourth line, 18 pixels a line: "ab c" ends the text before the last line
+	bool linesInside = true;
+
+	for (int i = 0; i < withLine; i++)
+		linesInside = linesInside && vertices[i].y <= firstY && vertices[i].y >= firstY - 4 * 18.0f - 16.0f;
+
+	CHECK(linesInside);
+
+	hud.Shutdown();
+}
+
+static void TestGraph()
+{
+	GlyphTableClass		glyphs;
+	PerfHudBuilderClass hud;
+	PerfStatsClass		stats;
+	vector<VertexType>	vertices(PerfHudBuilderClass::GetMaxVertexCount());
+	float				times[4] = { 10.0f, 20.0f, 40.0f, 100.0f };
+
+	FillGlyphs(&glyphs);
+	hud.Initialize(&glyphs, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+	for (int i = 0; i < 4; i++)
+		stats.EndFrame(times[i]);
+
+	// Without text the vertices are the four bars and the two lines
+	int count = hud.WriteVertices(&stats, &vertices[0]);
+
+	CHECK(count == 6 * 6);
+
+	float graphLeft	  = (float)(SCREEN_WIDTH / -2 + 10);
+	float graphBottom = (float)(SCREEN_HEIGHT / -2 + 10);
+
+	// The oldest frame on the left: green up to 60 fps, yellow up to 30 fps, red below, the height clamped at the top of the graph
+	float heights[4]   = { 20.0f, 40.0f, 80.0f, PERF_HUD_GRAPH_MAX * PERF_HUD_GRAPH_SCALE };
+	float colors[4][3] = { { 0.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } };
+
+	for (int bar = 0; bar < 4; bar++) {
+		const VertexType *quad = &vertices[bar * 6];
+		float			  left, top, right, bottom;
+
+		Bounds(quad, &left, &top, &right, &bottom);
+
+		CHECK(left == graphLeft + 3.0f * bar && right == left + 2.0f);
+		CHECK(bottom == graphBottom);
+		CHECK_NEAR(top - bottom, heights[bar], 1e-4);
+		CHECK(quad[0].r == colors[bar][0] && quad[0].g == colors[bar][1] && quad[0].b == colors[bar][2]);
+	}
+
+	// The reference lines at 16.7 and 33.3 ms, one pixel high, across the whole history
+	for (int line = 0; line < 2; line++) {
+		float left, top, right, bottom;
+
+		Bounds(&vertices[(4 + line) * 6], &left, &top, &right, &bottom);
+
+		CHECK_NEAR(bottom, graphBottom + 1000.0f / 60.0f * (line + 1) * PERF_HUD_GRAPH_SCALE, 1e-4);
+		CHECK_NEAR(top - bottom, 1.0f, 1e-4);
+		CHECK(right - left == 3.0f * PERF_HISTORY);
+	}
+
+	// Every bar samples the middle of the vertical bar glyph
+	const GlyphTableClass::GlyphType &bar = glyphs.GetGlyphs()[GlyphTableClass::GetAsciiGlyph('|')];
+	bool solid = true;
+
+	for (int i = 0; i < count; i++)
+		solid = solid && vertices[i].u == (bar.u0 + bar.u1) * 0.5f && vertices[i].v == 0.5f;
+
+	CHECK(solid);
+
+	hud.Shutdown();
+}
+
+// A full history and the longest lines stay within the vertex buffer
+static void TestLimits()
+{
+	GlyphTableClass		glyphs;
+	PerfHudBuilderClass hud;
+	PerfStatsClass		stats;
+	vector<VertexType>	vertices(PerfHudBuilderClass::GetMaxVertexCount() + 6);
+	char				line[1024];
+
+	FillGlyphs(&glyphs);
+	hud.Initialize(&glyphs, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+	for (int i = 0; i < 3 * PERF_HISTORY; i++)
+		stats.EndFrame(1000.0f + i);
+
+	for (int s = 0; s < PERF_SUBSYSTEM_COUNT; s++)
+		stats.AddTime(s, 12345.678f);
+
+	stats.EndFrame(99999.0f);
+
+	memset(line, 'W', sizeof(line) - 1);
+	line[sizeof(line) - 1] = 0;
+
+	// A marker past the end shows any write beyond the buffer
+	vertices[PerfHudBuilderClass::GetMaxVertexCount()].x = 12345.0f;
+
+	hud.BuildText(&stats, line, 99.999f);
+
+	int count = hud.WriteVertices(&stats, &vertices[0]);
+
+	CHECK(hud.GetTextVertexCount() <= 6 * PERF_HUD_MAX_LETTERS);
+	CHECK(count == hud.GetTextVertexCount() + 6 * (PERF_HISTORY + 2));
+	CHECK(count <= PerfHudBuilderClass::GetMaxVertexCount());
+	CHECK(vertices[PerfHudBuilderClass::GetMaxVertexCount()].x == 12345.0f);
+
+	hud.Shutdown();
+}
+
+int main()
+{
+	TestText();
+	TestGraph();
+	TestLimits();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,179 @@
+// SdfGeneratorClass against shapes whose distance is known: the texels of a square with hard edges, which the transform
+// must get exactly, and an antialiased disc, whose distances must be within half a pixel of the circle.
+// Then the field cut at 0.5 gives back the glyph, and ReferenceCoverage is the smoothstep of FontSdfPixelShader.
+
+#include "__testCheck.h"
+#include "__sdfGeneratorClass.h"
+
+#include <math.h>
+#include <vector>
+using namespace std;
+
+// The coverage of a disc, 8 x 8 samples a pixel
+static void MakeDisc(int size, float radius, vector<unsigned char> *coverage)
+{
+	float center = size * 0.5f;
+
+	coverage->resize(size * size);
+
+	for (int y = 0; y < size; y++)
+		for (int x = 0; x < size; x++) {
+			int inside = 0;
+
+			for (int sy = 0; sy < 8; sy++)
+				for (int sx = 0; sx < 8; sx++) {
+					float dx = x + (sx + 0.5f) / 8.0f - center;
+					float dy = y + (sy + 0.5f) / 8.0f - center;
+
+					if (dx * dx + dy * dy <= radius * radius)
+						inside++;
+				}
+
+			(*coverage)[y * size + x] = (unsigned char)((inside * 255 + 32) / 64);
+		}
+}
+
+// A 4 x 4 square in the middle of a 10 x 10 bitmap, texels fully in or out
+static void TestSquare()
+{
+	SdfGeneratorClass	  sdf;
+	vector<unsigned char> coverage(100, 0), field;
+	int					  spread = 3;
+	int					  width	 = 10 + 2 * spread;
+
+	for (int y = 3; y < 7; y++)
+		for (int x = 3; x < 7; x++)
+			coverage[y * 10 + x] = 255;
+
+	sdf.Generate(&coverage[0], 10, 10, spread, &field);
+
+	CHECK((int)field.size() == width * width);
+
+	const float *distances = sdf.GetDistances();
+
+	// Along the middle row the outline is half way between the last texel in and the first one out
+	int row = (5 + spread) * width;
+
+	for (int x = 0; x < width; x++) {
+		int	  bx	   = x - spread;
+		int	  depth	   = bx - 3 < 6 - bx ? bx - 3 : 6 - bx;
+		float expected = bx < 3 ? 3 - bx - 0.5f : bx > 6 ? bx - 6 - 0.5f : -depth - 0.5f;
+
+		CHECK_NEAR(distances[row + x], expected, 1e-4);
+	}
+
+	// Past a corner the nearest texel in is the corner one
+	CHECK_NEAR(distances[(9 + spread) * width + 9 + spread], sqrtf(18.0f) - 0.5f, 1e-4);
+
+	// 0 spread pixels outside, 1 inside, and about 0.5 on the texels next to the outline
+	CHECK(field[0] == 0);
+	CHECK(field[row + 5 + spread] > 128);
+	CHECK(field[row + 2 + spread] < 128);
+	CHECK(field[row + 2 + spread] == (unsigned char)((0.5f - 0.5f / (2.0f * spread)) * 255.0f + 0.5f));
+}
+
+static void TestDisc()
+{
+	SdfGeneratorClass	  sdf;
+	vector<unsigned char> coverage, field;
+	int					  size	 = 32;
+	int					  spread = 4;
+	float				  radius = 11.3f;
+	int					  width	 = size + 2 * spread;
+	float				  worst	 = 0.0f;
+	int					  wrongSide = 0, lost = 0;
+
+	MakeDisc(size, radius, &coverage);
+	sdf.Generate(&coverage[0], size, size, spread, &field);
+
+	const float *distances = sdf.GetDistances();
+
+	for (int y = 0; y < width; y++)
+		for (int x = 0; x < width; x++) {
+			float dx	   = x - spread + 0.5f - size * 0.5f;
+			float dy	   = y - spread + 0.5f - size * 0.5f;
+			float expected = sqrtf(dx * dx + dy * dy) - radius;
+			float distance = distances[y * width + x];
+
+			if (fabsf(expected) <= spread && fabsf(distance - expected) > worst)
+				worst = fabsf(distance - expected);
+
+			if (fabsf(expected) > 1.0f && (distance > 0.0f) != (expected > 0.0f))
+				wrongSide++;
+
+			// The field cut at 0.5 is the glyph again
+			int bx = x - spread, by = y - spread;
+			bool in = bx >= 0 && bx < size && by >= 0 && by < size && coverage[by * size + bx] >= 128;
+
+			if (in != (field[y * width + x] >= 128))
+				lost++;
+		}
+
+	CHECK(worst <= 0.5f);
+	CHECK(wrongSide == 0);
+	CHECK(lost == 0);
+
+	// The field goes up towards the center, and is flat spread pixels away from the outline
+	int row = (size / 2 + spread) * width;
+
+	for (int x = 1; x <= width / 2; x++)
+		CHECK(field[row + x] >= field[row + x - 1]);
+
+	CHECK(field[row] == 0 && field[row + width / 2] == 255);
+}
+
+// Nothing inside: every texel is as far out as it gets
+static void TestEmpty()
+{
+	SdfGeneratorClass	  sdf;
+	vector<unsigned char> coverage(6 * 4, 0), field;
+
+	sdf.Generate(&coverage[0], 6, 4, 2, &field);
+
+	CHECK(field.size() == 10 * 8);
+
+	bool zero = true;
+
+	for (size_t i = 0; i < field.size(); i++)
+		zero = zero && field[i] == 0;
+
+	CHECK(zero);
+}
+
+static void TestReferenceCoverage()
+{
+	float width = 0.1f;
+
+	CHECK_NEAR(SdfGeneratorClass::ReferenceCoverage(0.5f, width), 0.5f, 1e-6);
+	CHECK(SdfGeneratorClass::ReferenceCoverage(0.5f - width, width) == 0.0f);
+	CHECK(SdfGeneratorClass::ReferenceCoverage(0.5f + width, width) == 1.0f);
+	CHECK(SdfGeneratorClass::ReferenceCoverage(0.0f, width) == 0.0f);
+	CHECK(SdfGeneratorClass::ReferenceCoverage(1.0f, width) == 1.0f);
+
+	// Symmetric around the outline and never going down
+	float last = 0.0f;
+
+	for (int i = 0; i <= 100; i++) {
+		float distance = 0.4f + i * 0.002f;
+		float coverage = SdfGeneratorClass::ReferenceCoverage(distance, width);
+
+		CHECK(coverage >= last);
+		CHECK_NEAR(coverage + SdfGeneratorClass::ReferenceCoverage(1.0f - distance, width), 1.0f, 1e-5);
+
+		last = coverage;
+	}
+
+	// A flat field (fwidth 0) is a hard cut
+	CHECK(SdfGeneratorClass::ReferenceCoverage(0.49f, 0.0f) == 0.0f);
+	CHECK(SdfGeneratorClass::ReferenceCoverage(0.51f, 0.0f) == 1.0f);
+}
+
+int main()
+{
+	TestSquare();
+	TestDisc();
+	TestEmpty();
+	TestReferenceCoverage();
+
+	return TEST_RESULT();
+}
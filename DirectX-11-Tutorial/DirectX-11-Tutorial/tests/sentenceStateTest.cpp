@@ -0,0 +1,102 @@
+// SentenceStateClass: what the updates of a sentence of the TextOutClass change. Only an update that changes nothing
+// may skip the upload; a new color alone recolors, and a new end of the text only rebuilds the letters from the first different one.
+
+#include "__testCheck.h"
+#include "__sentenceStateClass.h"
+
+#define WHITE 0xFFFFFFFF
+#define GREEN 0xFF00FF00
+
+static void TestSentence()
+{
+	SentenceStateClass state;
+	int				   firstLetter = -1;
+
+	CHECK(state.Initialize(16));
+
+	// The first update builds everything
+	CHECK(state.UpdateSentence("Fps: 59", 20, 20, WHITE, &firstLetter) == (SentenceStateClass::CHANGE_COLOR | SentenceStateClass::CHANGE_TEXT));
+	CHECK(firstLetter == 0);
+
+	CHECK(state.UpdateSentence("Fps: 59", 20, 20, WHITE, &firstLetter) == SentenceStateClass::CHANGE_NONE);
+
+	// Only the end of the text
+	CHECK(state.UpdateSentence("Fps: 60", 20, 20, WHITE, &firstLetter) == SentenceStateClass::CHANGE_TEXT);
+	CHECK(firstLetter == 5);
+
+	CHECK(state.UpdateSentence("Fps: 600", 20, 20, WHITE, &firstLetter) == SentenceStateClass::CHANGE_TEXT);
+	CHECK(firstLetter == 7);
+
+	// A shorter text changes nothing in its letters, but the last ones have to go
+	CHECK(state.UpdateSentence("Fps: 60", 20, 20, WHITE, &firstLetter) == SentenceStateClass::CHANGE_TEXT);
+	CHECK(firstLetter == 7);
+
+	// A new position moves every letter
+	CHECK(state.UpdateSentence("Fps: 60", 20, 21, WHITE, &firstLetter) == SentenceStateClass::CHANGE_TEXT);
+	CHECK(firstLetter == 0);
+
+	CHECK(state.UpdateSentence("", 20, 21, WHITE, &firstLetter) == SentenceStateClass::CHANGE_TEXT);
+	CHECK(state.UpdateSentence("", 20, 21, WHITE, &firstLetter) == SentenceStateClass::CHANGE_NONE);
+
+	// Too long for the sentence: refused and not stored
+	CHECK(state.UpdateSentence("0123456789abcdefg", 20, 21, WHITE, &firstLetter) == -1);
+	CHECK(state.GetText()[0] == 0);
+
+	state.Shutdown();
+}
+
+// The Cpu sentence turning green: the letters are only recolored, and that is still a change to upload
+static void TestColorOnly()
+{
+	SentenceStateClass state;
+	int				   firstLetter = -1;
+
+	CHECK(state.Initialize(16));
+
+	state.UpdateSentence("Cpu: 5%", 20, 40, WHITE, &firstLetter);
+
+	CHECK(state.UpdateSentence("Cpu: 5%", 20, 40, GREEN, &firstLetter) == SentenceStateClass::CHANGE_COLOR);
+	CHECK(state.UpdateSentence("Cpu: 5%", 20, 40, GREEN, &firstLetter) == SentenceStateClass::CHANGE_NONE);
+
+	// Both at once
+	CHECK(state.UpdateSentence("Cpu: 6%", 20, 40, WHITE, &firstLetter) == (SentenceStateClass::CHANGE_COLOR | SentenceStateClass::CHANGE_TEXT));
+	CHECK(firstLetter == 5);
+
+	state.Shutdown();
+}
+
+static void TestParagraph()
+{
+	SentenceStateClass state;
+	int				   firstLetter = -1;
+
+	CHECK(state.Initialize(64));
+
+	CHECK(state.UpdateParagraph("Some words to wrap", 10, 10, 200.0f, 1, WHITE) & SentenceStateClass::CHANGE_TEXT);
+	CHECK(state.UpdateParagraph("Some words to wrap", 10, 10, 200.0f, 1, WHITE) == SentenceStateClass::CHANGE_NONE);
+	CHECK(state.UpdateParagraph("Some words to wrap", 10, 10, 200.0f, 1, GREEN) == SentenceStateClass::CHANGE_COLOR);
+
+	// Any of the layout parameters lays the paragraph out again
+	CHECK(state.UpdateParagraph("Some words to wrap", 10, 10, 150.0f, 1, GREEN) == SentenceStateClass::CHANGE_TEXT);
+	CHECK(state.UpdateParagraph("Some words to wrap", 10, 10, 150.0f, 2, GREEN) == SentenceStateClass::CHANGE_TEXT);
+	CHECK(state.UpdateParagraph("Some words to wrap", 11, 10, 150.0f, 2, GREEN) == SentenceStateClass::CHANGE_TEXT);
+	CHECK(state.UpdateParagraph("Some words to wrap!", 11, 10, 150.0f, 2, GREEN) == SentenceStateClass::CHANGE_TEXT);
+
+	// A sentence after a paragraph with the same text is rebuilt from its first letter, the instances were made by the layout
+	CHECK(state.UpdateSentence("Some words to wrap!", 11, 10, GREEN, &firstLetter) == SentenceStateClass::CHANGE_TEXT);
+	CHECK(firstLetter == 0);
+
+	// And the other way round
+	CHECK(state.UpdateParagraph("Some words to wrap!", 11, 10, 150.0f, 2, GREEN) == SentenceStateClass::CHANGE_TEXT);
+
+	state.Shutdown();
+}
+
+int main()
+{
+	TestSentence();
+	TestColorOnly();
+	TestParagraph();
+
+	return TEST_RESULT();
+}
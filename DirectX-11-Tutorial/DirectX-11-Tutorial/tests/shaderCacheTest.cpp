@@ -0,0 +1,281 @@
+// ShaderCacheClass with a stub compiler that counts its calls: a blob is compiled once and read afterwards,
+// and it is compiled again when anything the bytecode depends on changes (the source, the entry point, the profile,
+// the flags, the defines, the compiler), when the blob is damaged, or when reading is off. Failures are not stored.
+// The sources and the blobs are written in the working directory.
+
+#include "__testCheck.h"
+#include "__shaderCacheClass.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+using namespace std;
+
+#define SOURCE "shaderCacheTest.vs"
+
+struct StubType {
+	int	   calls;
+	string source;		// the text the last compilation got
+};
+
+// The bytecode is the entry point, the profile, the flags and the text; a source with "error" in it doesn't compile.
+static bool StubCompile(void *user, const char *filename, const char *source, int size, const char *entry, const char *profile,
+						unsigned int flags, vector<unsigned char> *bytecode, string *errors, float *milliseconds)
+{
+	StubType *stub	 = (StubType*)user;
+	string	  header = string(entry) + " " + profile + " " + to_string(flags) + ":";
+
+	stub->calls++;
+	stub->source.assign(source, size);
+
+	if (stub->source.find("error") != string::npos) {
+		*errors = string(filename) + "(1,1): error X0000: stub";
+		return false;
+	}
+
+	bytecode->assign(header.begin(), header.end());
+	bytecode->insert(bytecode->end(), source, source + size);
+	*milliseconds = 5.0f;
+
+	return true;
+}
+
+static void WriteSource(const char *text)
+{
+	ofstream fout(SOURCE, ios::binary | ios::trunc);
+
+	fout << text;
+}
+
+static string Text(const vector<unsigned char> &bytecode)
+{
+	return string(bytecode.begin(), bytecode.end());
+}
+
+static void RemoveBlobs(ShaderCacheClass *cache)
+{
+	const char *entries[2] = { "MainVS", "OtherVS" };
+	const char *defines[3] = { "", "#define A 1", "#define A 2\n" };
+
+	for (int e = 0; e < 2; e++)
+		for (int d = 0; d < 3; d++) {
+			remove(cache->GetBlobPath(SOURCE, entries[e], "vs_5_0", defines[d]).c_str());
+			remove(cache->GetBlobPath(SOURCE, entries[e], "vs_4_0", defines[d]).c_str());
+		}
+}
+
+static void TestHitsAndMisses()
+{
+	ShaderCacheClass	  cache;
+	StubType			  stub;
+	vector<unsigned char> bytecode;
+	string				  errors;
+
+	stub.calls = 0;
+
+	CHECK(!cache.Initialize(".", "stub_1", 0, 0));
+	CHECK(cache.Initialize(".", "stub_1", StubCompile, &stub));
+	RemoveBlobs(&cache);
+
+	WriteSource("float4 MainVS() : SV_POSITION { return 0; }");
+
+	// Compiled once and stored, then read
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 1 && Text(bytecode) == "MainVS vs_5_0 0:float4 MainVS() : SV_POSITION { return 0; }");
+	CHECK(cache.GetStats().misses == 1 && cache.GetStats().hits == 0 && cache.GetStats().writeFailures == 0);
+	CHECK(cache.GetStats().compileTime == 5.0f);
+
+	vector<unsigned char> first = bytecode;
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 1 && bytecode == first && errors.empty());
+	CHECK(cache.GetStats().hits == 1 && cache.GetStats().savedTime == 5.0f);
+
+	// The source changed: compiled again, and the new blob is read next time
+	WriteSource("float4 MainVS() : SV_POSITION { return 1; }");
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 2 && bytecode != first);
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 2);
+
+	// Other flags share the blob of the entry point: each change compiles and replaces it
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 1, &bytecode, &errors));
+	CHECK(stub.calls == 3 && Text(bytecode).compare(0, 15, "MainVS vs_5_0 1") == 0);
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 4);
+
+	// Another entry point or profile has its own blob
+	CHECK(cache.Load(SOURCE, "OtherVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_4_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 6);
+	CHECK(cache.Load(SOURCE, "OtherVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_4_0", 0, &bytecode, &errors));
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 6);
+
+	// A new compiler makes every blob stale
+	ShaderCacheClass newer;
+
+	CHECK(newer.Initialize(".", "stub_2", StubCompile, &stub));
+	CHECK(newer.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 7 && newer.GetStats().misses == 1);
+
+	newer.Shutdown();
+	RemoveBlobs(&cache);
+	cache.Shutdown();
+}
+
+static void TestVariants()
+{
+	ShaderCacheClass	  cache;
+	StubType			  stub;
+	vector<unsigned char> bytecode;
+	string				  errors;
+
+	stub.calls = 0;
+
+	cache.Initialize(".", "stub_1", StubCompile, &stub);
+	RemoveBlobs(&cache);
+
+	WriteSource("float4 MainVS() : SV_POSITION { return A; }");
+
+	// The defines go in front of the text with a #line 1, and each variant has its own blob
+	CHECK(cache.GetBlobPath(SOURCE, "MainVS", "vs_5_0", "#define A 1") != cache.GetBlobPath(SOURCE, "MainVS", "vs_5_0", "#define A 2"));
+	CHECK(cache.GetBlobPath(SOURCE, "MainVS", "vs_5_0", "") == "./shaderCacheTest.vs.MainVS.vs_5_0.cso");
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, "#define A 1", &bytecode, &errors));
+	CHECK(stub.source == "#define A 1\n#line 1\nfloat4 MainVS() : SV_POSITION { return A; }");
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, "#define A 2\n", &bytecode, &errors));
+	CHECK(stub.source == "#define A 2\n#line 1\nfloat4 MainVS() : SV_POSITION { return A; }");
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 3);
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, "#define A 1", &bytecode, &errors));
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 3 && cache.GetStats().hits == 2);
+
+	RemoveBlobs(&cache);
+	cache.Shutdown();
+}
+
+// A damaged blob is compiled again and replaced
+static void TestDamagedBlobs()
+{
+	ShaderCacheClass	  cache;
+	StubType			  stub;
+	vector<unsigned char> bytecode;
+	string				  errors;
+
+	stub.calls = 0;
+
+	cache.Initialize(".", "stub_1", StubCompile, &stub);
+	RemoveBlobs(&cache);
+
+	WriteSource("float4 MainVS() : SV_POSITION { return 0; }");
+
+	string path = cache.GetBlobPath(SOURCE, "MainVS", "vs_5_0", "");
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+
+	vector<unsigned char> good = bytecode;
+
+	// Cut short while being written
+	{
+		ifstream fin(path.c_str(), ios::binary);
+		string	 blob((istreambuf_iterator<char>(fin)), istreambuf_iterator<char>());
+
+		fin.close();
+
+		ofstream fout(path.c_str(), ios::binary | ios::trunc);
+		fout.write(blob.c_str(), blob.size() - 4);
+	}
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 2 && bytecode == good);
+
+	// Not a blob at all
+	{
+		ofstream fout(path.c_str(), ios::binary | ios::trunc);
+		fout << "garbage, not a blob of the shader cache";
+	}
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 3 && bytecode == good);
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 3);
+
+	// Without reading every load compiles, and still stores
+	cache.SetReadEnabled(false);
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 4);
+
+	cache.SetReadEnabled(true);
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 4);
+
+	RemoveBlobs(&cache);
+	cache.Shutdown();
+}
+
+static void TestFailures()
+{
+	ShaderCacheClass	  cache;
+	StubType			  stub;
+	vector<unsigned char> bytecode;
+	string				  errors;
+
+	stub.calls = 0;
+
+	cache.Initialize(".", "stub_1", StubCompile, &stub);
+	RemoveBlobs(&cache);
+
+	// A missing source fails without errors and without compiling
+	remove(SOURCE);
+	CHECK(!cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(errors.empty() && bytecode.empty() && stub.calls == 0);
+
+	// A failure gives the errors and is not stored, the next load compiles again
+	WriteSource("error");
+
+	CHECK(!cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(!errors.empty() && bytecode.empty());
+	CHECK(!cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(stub.calls == 2 && cache.GetStats().compileFailures == 2 && cache.GetStats().hits == 0);
+
+	// Fixing it compiles it
+	WriteSource("float4 MainVS() : SV_POSITION { return 0; }");
+
+	CHECK(cache.Load(SOURCE, "MainVS", "vs_5_0", 0, &bytecode, &errors));
+	CHECK(errors.empty() && !bytecode.empty() && stub.calls == 3);
+
+	cache.ResetStats();
+	CHECK(cache.GetStats().misses == 0 && cache.GetStats().compileFailures == 0);
+
+	RemoveBlobs(&cache);
+	remove(SOURCE);
+	cache.Shutdown();
+}
+
+// The strings are hashed with their ends, so moving text from one to the next changes the hash
+static void TestHash()
+{
+	CHECK(ShaderCacheClass::Hash("ab", 2, "c", "vs_5_0", 0, "x") != ShaderCacheClass::Hash("a", 1, "bc", "vs_5_0", 0, "x"));
+	CHECK(ShaderCacheClass::Hash("a", 1, "main", "vs_5_0", 0, "x") != ShaderCacheClass::Hash("a", 1, "main", "vs_5_0", 1 << 24, "x"));
+	CHECK(ShaderCacheClass::Hash("a", 1, "main", "vs_5_0", 0, "x") == ShaderCacheClass::Hash("a", 1, "main", "vs_5_0", 0, "x"));
+}
+
+int main()
+{
+	TestHitsAndMisses();
+	TestVariants();
+	TestDamagedBlobs();
+	TestFailures();
+	TestHash();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,780 @@
+// ShaderReferenceClass against the HLSL of the shaders, written out again a pixel at a time in plain C++ straight from the
+// .vs and .ps files: mul(v, M) with the matrices in the D3DX order, the bilinear wrapped sampler, the branches of the light
+// variants, the loop of the clustered lights and fwidth across the quad. Every lane of the twins gets its own random input
+// and must give what the scalar code gives. The twins take the matrices transposed, as the shader classes upload them.
+
+#include "__testCheck.h"
+#include "__shaderReferenceClass.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+using namespace std;
+
+typedef ShaderReferenceClass				SR;
+typedef ShaderReferenceClass::ConstantsType ConstantsType;
+
+// A matrix in the D3DX order, the row vectors are multiplied on the left
+struct MatrixType {
+	float m[4][4];
+};
+
+static float Random(float low, float high)
+{
+	return low + (high - low) * (float)rand() / RAND_MAX;
+}
+
+static MatrixType RandomMatrix()
+{
+	MatrixType matrix;
+
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			matrix.m[i][j] = Random(-2.0f, 2.0f);
+
+	return matrix;
+}
+
+// What the shader classes upload: the transposed matrix
+static SR::MatrixType Upload(const MatrixType &matrix)
+{
+	SR::MatrixType transposed;
+
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			transposed.m[i][j] = matrix.m[j][i];
+
+	return transposed;
+}
+
+// mul(v, M)
+static void Mul(const float *v, const MatrixType &matrix, float *out)
+{
+	float result[4];
+
+	for (int j = 0; j < 4; j++)
+		result[j] = v[0] * matrix.m[0][j] + v[1] * matrix.m[1][j] + v[2] * matrix.m[2][j] + v[3] * matrix.m[3][j];
+
+	memcpy(out, result, sizeof(result));
+}
+
+static void Normalize3(float *v)
+{
+	float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+
+	v[0] /= length;
+	v[1] /= length;
+	v[2] /= length;
+}
+
+static float Dot3(const float *a, const float *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static float Saturate(float x)
+{
+	return x < 0.0f ? 0.0f : (x > 1.0f ? 1.0f : x);
+}
+
+static float Smoothstep(float edge0, float edge1, float x)
+{
+	float t = Saturate((x - edge0) / (edge1 - edge0));
+
+	return t * t * (3.0f - 2.0f * t);
+}
+
+
+
+// The lanes of the twins
+static __m128 Lanes(const float *values)
+{
+	return _mm_loadu_ps(values);
+}
+
+static float Lane(__m128 lanes, int lane)
+{
+	float values[4];
+
+	_mm_storeu_ps(values, lanes);
+
+	return values[lane];
+}
+
+static void RandomLanes(__m128 *lanes, float low, float high)
+{
+	float values[4];
+
+	for (int i = 0; i < 4; i++)
+		values[i] = Random(low, high);
+
+	*lanes = Lanes(values);
+}
+
+// Within 1e-4 of the value, relative to it when it is bigger than 1
+static bool Near(float value, float expected)
+{
+	float scale = fabsf(expected) > 1.0f ? fabsf(expected) : 1.0f;
+
+	return fabsf(value - expected) <= 1e-4f * scale;
+}
+
+static bool Near4(const SR::Float4Type &value, int lane, const float *expected)
+{
+	return Near(Lane(value.x, lane), expected[0]) && Near(Lane(value.y, lane), expected[1]) &&
+		   Near(Lane(value.z, lane), expected[2]) && Near(Lane(value.w, lane), expected[3]);
+}
+
+static bool Near3(const SR::Float3Type &value, int lane, const float *expected)
+{
+	return Near(Lane(value.x, lane), expected[0]) && Near(Lane(value.y, lane), expected[1]) && Near(Lane(value.z, lane), expected[2]);
+}
+
+
+
+// Texture2D.Sample with the samplers of the shader classes: bilinear, wrapped, the top mip level
+static void Sample(const SR::TextureType &texture, float u, float v, float *out)
+{
+	float x = u * texture.width - 0.5f, y = v * texture.height - 0.5f;
+	float fx = floorf(x), fy = floorf(y), ax = x - fx, ay = y - fy;
+	int	  x0 = (((int)fx % texture.width) + texture.width) % texture.width;
+	int	  y0 = (((int)fy % texture.height) + texture.height) % texture.height;
+	int	  x1 = (x0 + 1) % texture.width;
+	int	  y1 = (y0 + 1) % texture.height;
+
+	for (int c = 0; c < 4; c++) {
+		float t00 = texture.texels[(y0 * texture.width + x0) * 4 + c];
+		float t10 = texture.texels[(y0 * texture.width + x1) * 4 + c];
+		float t01 = texture.texels[(y1 * texture.width + x0) * 4 + c];
+		float t11 = texture.texels[(y1 * texture.width + x1) * 4 + c];
+		float top = t00 + (t10 - t00) * ax, bottom = t01 + (t11 - t01) * ax;
+
+		out[c] = top + (bottom - top) * ay;
+	}
+}
+
+static vector<float> RandomTexels(int width, int height)
+{
+	vector<float> texels(width * height * 4);
+
+	for (size_t i = 0; i < texels.size(); i++)
+		texels[i] = Random(0.0f, 1.0f);
+
+	return texels;
+}
+
+static void TestSample()
+{
+	vector<float>	texels = RandomTexels(8, 4);
+	SR::TextureType texture = { 8, 4, &texels[0] };
+	SR::Float2Type	tex;
+	SR::Float4Type	out;
+	bool			same = true;
+
+	// Texel centers give the texels, the coordinates wrap both ways
+	float u[4] = { 0.5f / 8, 3.5f / 8, 1.0f + 3.5f / 8, -1.0f + 7.5f / 8 };
+	float v[4] = { 0.5f / 4, 2.5f / 4, 2.5f / 4, -3.0f + 1.5f / 4 };
+	int	  texel[4] = { 0, 2 * 8 + 3, 2 * 8 + 3, 1 * 8 + 7 };
+
+	tex.x = Lanes(u);
+	tex.y = Lanes(v);
+	SR::Sample(texture, tex, &out);
+
+	for (int lane = 0; lane < 4; lane++)
+		CHECK(Near4(out, lane, &texels[texel[lane] * 4]));
+
+	// Anywhere else, the same as the scalar sampler, also across the edges and far out
+	for (int n = 0; n < 200; n++) {
+		float expected[4];
+
+		RandomLanes(&tex.x, -3.0f, 3.0f);
+		RandomLanes(&tex.y, -3.0f, 3.0f);
+		SR::Sample(texture, tex, &out);
+
+		for (int lane = 0; lane < 4; lane++) {
+			Sample(texture, Lane(tex.x, lane), Lane(tex.y, lane), expected);
+			same = same && Near4(out, lane, expected);
+		}
+	}
+
+	CHECK(same);
+}
+
+
+
+// _shaderLight.vs
+static void LightVertexShader(unsigned long long features, const MatrixType &view, const MatrixType &projection, const float *cameraPosition,
+							  const MatrixType &world, const float *position, const float *normal,
+							  float *outPosition, float *outNormal, float *outViewDirection, float *outWorldPosition, float *outViewDepth)
+{
+	float input[4] = { position[0], position[1], position[2], 1.0f };
+	float worldPosition[4];
+
+	Mul(input, world, outPosition);
+	memcpy(outWorldPosition, outPosition, 3 * sizeof(float));
+
+	Mul(outPosition, view, outPosition);
+	*outViewDepth = outPosition[2];
+
+	Mul(outPosition, projection, outPosition);
+
+	// mul(normal, (float3x3)world)
+	for (int j = 0; j < 3; j++)
+		outNormal[j] = normal[0] * world.m[0][j] + normal[1] * world.m[1][j] + normal[2] * world.m[2][j];
+
+	Normalize3(outNormal);
+
+	if (features & SHADER_FEATURE_SPECULAR) {
+		Mul(input, world, worldPosition);
+
+		for (int k = 0; k < 3; k++)
+			outViewDirection[k] = cameraPosition[k] - worldPosition[k];
+
+		Normalize3(outViewDirection);
+	}
+}
+
+static void TestLightVertexShader()
+{
+	unsigned long long variants[4] = { 0, SHADER_FEATURE_SPECULAR, SHADER_FEATURE_SPECULAR | SHADER_FEATURE_INSTANCING,
+									   SHADER_FEATURE_INSTANCING | SHADER_FEATURE_CLUSTERED_LIGHTS };
+
+	for (int variant = 0; variant < 4; variant++) {
+		unsigned long long					 features = variants[variant];
+		bool								 same = true;
+		ConstantsType::LightFrameBufferType	 frame;
+		ConstantsType::LightObjectBufferType object;
+
+		for (int n = 0; n < 50; n++) {
+			MatrixType			view = RandomMatrix(), projection = RandomMatrix(), world = RandomMatrix(), instances[4];
+			SR::LightVertexType in;
+			SR::LightPixelType	out;
+			float				camera[3] = { Random(-10.0f, 10.0f), Random(-10.0f, 10.0f), Random(-10.0f, 10.0f) };
+
+			frame.view			   = Upload(view);
+			frame.projection	   = Upload(projection);
+			frame.cameraPosition.x = camera[0];
+			frame.cameraPosition.y = camera[1];
+			frame.cameraPosition.z = camera[2];
+			frame.padding		   = 0.0f;
+			object.world		   = Upload(world);
+
+			RandomLanes(&in.position.x, -5.0f, 5.0f);
+			RandomLanes(&in.position.y, -5.0f, 5.0f);
+			RandomLanes(&in.position.z, -5.0f, 5.0f);
+			RandomLanes(&in.tex.x, 0.0f, 1.0f);
+			RandomLanes(&in.tex.y, 0.0f, 1.0f);
+			RandomLanes(&in.normal.x, -1.0f, 1.0f);
+			RandomLanes(&in.normal.y, -1.0f, 1.0f);
+			RandomLanes(&in.normal.z, -1.0f, 1.0f);
+
+			// The rows of the instance matrices come with the vertex, not transposed
+			for (int lane = 0; lane < 4; lane++)
+				instances[lane] = RandomMatrix();
+
+			for (int row = 0; row < 4; row++) {
+				float x[4], y[4], z[4], w[4];
+
+				for (int lane = 0; lane < 4; lane++) {
+					x[lane] = instances[lane].m[row][0];
+					y[lane] = instances[lane].m[row][1];
+					z[lane] = instances[lane].m[row][2];
+					w[lane] = instances[lane].m[row][3];
+				}
+
+				in.world[row].x = Lanes(x);
+				in.world[row].y = Lanes(y);
+				in.world[row].z = Lanes(z);
+				in.world[row].w = Lanes(w);
+			}
+
+			SR::LightVertexShader(features, frame, object, in, &out);
+
+			for (int lane = 0; lane < 4; lane++) {
+				float position[3] = { Lane(in.position.x, lane), Lane(in.position.y, lane), Lane(in.position.z, lane) };
+				float normal[3]	  = { Lane(in.normal.x, lane), Lane(in.normal.y, lane), Lane(in.normal.z, lane) };
+				float outPosition[4], outNormal[3], outViewDirection[3], outWorldPosition[3], outViewDepth;
+
+				LightVertexShader(features, view, projection, camera, features & SHADER_FEATURE_INSTANCING ? instances[lane] : world,
+								  position, normal, outPosition, outNormal, outViewDirection, outWorldPosition, &outViewDepth);
+
+				same = same && Near4(out.position, lane, outPosition) && Near3(out.normal, lane, outNormal);
+				same = same && Near3(out.worldPosition, lane, outWorldPosition) && Near(Lane(out.viewDepth, lane), outViewDepth);
+				same = same && Lane(out.tex.x, lane) == Lane(in.tex.x, lane) && Lane(out.tex.y, lane) == Lane(in.tex.y, lane);
+
+				if (features & SHADER_FEATURE_SPECULAR)
+					same = same && Near3(out.viewDirection, lane, outViewDirection);
+			}
+		}
+
+		CHECK(same);
+	}
+}
+
+
+
+// The clusters of the test: 2 x 2 tiles of 100 pixels, the depths 1 to 10 in slice 0 and 10 to 100 in slice 1,
+// and a few lights in every cluster, point and spot lights
+struct ClustersType {
+	vector<ClusterLightType> lights;
+	vector<unsigned int>	 grid, indices;
+	SR::ClusterResourcesType resources;
+};
+
+static void MakeClusters(ClustersType *clusters)
+{
+	clusters->lights.resize(12);
+
+	for (int i = 0; i < 12; i++) {
+		ClusterLightType &light = clusters->lights[i];
+		float			  direction[3] = { Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) };
+
+		Normalize3(direction);
+
+		for (int k = 0; k < 3; k++) {
+			light.position[k]  = Random(-5.0f, 5.0f);
+			light.color[k]	   = Random(0.0f, 0.5f);
+			light.direction[k] = direction[k];
+		}
+
+		light.range	  = Random(3.0f, 12.0f);
+		light.spotCos = i % 3 == 0 ? -1.0f : Random(0.3f, 0.9f);
+		light.padding = 0.0f;
+	}
+
+	clusters->grid.clear();
+	clusters->indices.clear();
+
+	for (int c = 0; c < 8; c++) {
+		clusters->grid.push_back((unsigned int)clusters->indices.size());
+		clusters->grid.push_back(c % 4 + 1);
+
+		for (int i = 0; i < c % 4 + 1; i++)
+			clusters->indices.push_back((c * 5 + i * 7) % 12);
+	}
+
+	ConstantsType::ClusterBufferType &constants = clusters->resources.constants;
+
+	constants.tileScale[0]	  = 0.01f;
+	constants.tileScale[1]	  = 0.01f;
+	constants.depthScale	  = 1.0f / logf(10.0f);
+	constants.depthBias		  = 0.0f;
+	constants.clusterCounts[0] = 2;
+	constants.clusterCounts[1] = 2;
+	constants.clusterCounts[2] = 2;
+	constants.lightCount	  = 12;
+
+	clusters->resources.lights	= &clusters->lights[0];
+	clusters->resources.grid	= &clusters->grid[0];
+	clusters->resources.indices = &clusters->indices[0];
+}
+
+// ClusterLighting of _shaderLight.ps
+static void ClusterLighting(const ClustersType &clusters, const float *position, const float *normal, const float *worldPosition, float viewDepth, float *color)
+{
+	const ConstantsType::ClusterBufferType &constants = clusters.resources.constants;
+	unsigned int							cluster[3], counts[3];
+
+	for (int k = 0; k < 3; k++)
+		counts[k] = constants.clusterCounts[k];
+
+	cluster[0] = (unsigned int)(position[0] * constants.tileScale[0]);
+	cluster[1] = (unsigned int)(position[1] * constants.tileScale[1]);
+	cluster[2] = (unsigned int)fmaxf(logf(viewDepth) * constants.depthScale + constants.depthBias, 0.0f);
+
+	for (int k = 0; k < 3; k++)
+		cluster[k] = cluster[k] < counts[k] - 1 ? cluster[k] : counts[k] - 1;
+
+	const unsigned int *lights = &clusters.grid[((cluster[2] * counts[1] + cluster[1]) * counts[0] + cluster[0]) * 2];
+
+	color[0] = color[1] = color[2] = color[3] = 0.0f;
+
+	for (unsigned int i = 0; i < lights[1]; i++) {
+		const ClusterLightType &light = clusters.lights[clusters.indices[lights[0] + i]];
+		float					toLight[3], lightDir[3], distance, attenuation, intensity;
+
+		for (int k = 0; k < 3; k++)
+			toLight[k] = light.position[k] - worldPosition[k];
+
+		distance = sqrtf(Dot3(toLight, toLight));
+
+		for (int k = 0; k < 3; k++)
+			lightDir[k] = toLight[k] / fmaxf(distance, 0.0001f);
+
+		attenuation = Saturate(1.0f - distance / light.range);
+		intensity	= Saturate(Dot3(normal, lightDir)) * attenuation * attenuation;
+
+		if (light.spotCos > -1.0f)
+			intensity *= Smoothstep(light.spotCos, light.spotCos + (1.0f - light.spotCos) * 0.2f, -Dot3(lightDir, light.direction));
+
+		for (int k = 0; k < 3; k++)
+			color[k] += light.color[k] * intensity;
+	}
+}
+
+// LightPixelShader of _shaderLight.ps, false when clip() discards the pixel
+static bool LightPixelShader(unsigned long long features, const ConstantsType::LightBufferType &buffer, const SR::TextureType *texture, const ClustersType *clusters,
+							 const float *position, const float *tex, const float *normal, const float *viewDirection, const float *worldPosition, float viewDepth,
+							 float *color)
+{
+	float textureColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	float ambient[4]	  = { buffer.ambientColor.x, buffer.ambientColor.y, buffer.ambientColor.z, buffer.ambientColor.w };
+	float diffuse[4]	  = { buffer.diffuseColor.x, buffer.diffuseColor.y, buffer.diffuseColor.z, buffer.diffuseColor.w };
+	float lightDir[3]	  = { -buffer.lightDirection.x, -buffer.lightDirection.y, -buffer.lightDirection.z };
+	float specular		  = 0.0f, lightIntensity, reflection[3], cluster[4];
+	bool  drawn			  = true;
+
+	if (features & SHADER_FEATURE_TEXTURE)
+		Sample(*texture, tex[0], tex[1], textureColor);
+
+	if (features & SHADER_FEATURE_ALPHA_TEST)
+		drawn = textureColor[3] - 0.5f >= 0.0f;
+
+	memcpy(color, ambient, sizeof(ambient));
+
+	lightIntensity = Saturate(Dot3(normal, lightDir));
+
+	if (lightIntensity > 0.0f) {
+		for (int c = 0; c < 4; c++)
+			color[c] = Saturate(color[c] + diffuse[c] * lightIntensity);
+
+		if (features & SHADER_FEATURE_SPECULAR) {
+			for (int k = 0; k < 3; k++)
+				reflection[k] = 2 * lightIntensity * normal[k] - lightDir[k];
+
+			Normalize3(reflection);
+			specular = powf(Saturate(Dot3(reflection, viewDirection)), buffer.specularPower);
+		}
+	}
+
+	if (features & SHADER_FEATURE_CLUSTERED_LIGHTS) {
+		ClusterLighting(*clusters, position, normal, worldPosition, viewDepth, cluster);
+
+		for (int c = 0; c < 4; c++)
+			color[c] = Saturate(color[c] + cluster[c]);
+	}
+
+	for (int c = 0; c < 4; c++)
+		color[c] = Saturate(color[c] * textureColor[c] + specular);
+
+	return drawn;
+}
+
+static void TestLightPixelShader()
+{
+	vector<float>	texels = RandomTexels(16, 16);
+	SR::TextureType texture = { 16, 16, &texels[0] };
+	ClustersType	clusters;
+
+	MakeClusters(&clusters);
+
+	for (unsigned long long features = 0; features < (1ULL << SHADER_FEATURE_COUNT); features++) {
+		bool same = true;
+		int	 discarded = 0;
+
+		if (features & SHADER_FEATURE_INSTANCING)
+			continue;
+
+		for (int n = 0; n < 200; n++) {
+			ConstantsType::LightBufferType buffer;
+			SR::LightPixelType			   in;
+			SR::Float4Type				   out;
+			float						   direction[3] = { Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) };
+
+			Normalize3(direction);
+
+			buffer.ambientColor.x = Random(0.0f, 0.3f); buffer.ambientColor.y = Random(0.0f, 0.3f);
+			buffer.ambientColor.z = Random(0.0f, 0.3f); buffer.ambientColor.w = 1.0f;
+			buffer.diffuseColor.x = Random(0.5f, 1.0f); buffer.diffuseColor.y = Random(0.5f, 1.0f);
+			buffer.diffuseColor.z = Random(0.5f, 1.0f); buffer.diffuseColor.w = 1.0f;
+			buffer.specularColor.x = buffer.specularColor.y = buffer.specularColor.z = buffer.specularColor.w = 1.0f;
+			buffer.lightDirection.x = direction[0];
+			buffer.lightDirection.y = direction[1];
+			buffer.lightDirection.z = direction[2];
+			buffer.specularPower	= Random(4.0f, 64.0f);
+
+			// A quad of pixels, every second one across the tiles, and depths on both sides of 10
+			float x = n % 2 ? 99.5f : Random(0.0f, 198.0f), y = n % 4 < 2 ? 99.5f : Random(0.0f, 198.0f);
+			float px[4] = { x, x + 1.0f, x, x + 1.0f }, py[4] = { y, y, y + 1.0f, y + 1.0f };
+			float normals[3][4], views[3][4];
+
+			for (int lane = 0; lane < 4; lane++) {
+				float normal[3] = { Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) };
+				float view[3]	= { Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) };
+
+				Normalize3(normal);
+				Normalize3(view);
+
+				for (int k = 0; k < 3; k++) {
+					normals[k][lane] = normal[k];
+					views[k][lane]	 = view[k];
+				}
+			}
+
+			in.position.x = Lanes(px);
+			in.position.y = Lanes(py);
+			in.position.z = _mm_set1_ps(0.5f);
+			in.position.w = _mm_set1_ps(1.0f);
+			in.normal.x	  = Lanes(normals[0]);
+			in.normal.y	  = Lanes(normals[1]);
+			in.normal.z	  = Lanes(normals[2]);
+			in.viewDirection.x = Lanes(views[0]);
+			in.viewDirection.y = Lanes(views[1]);
+			in.viewDirection.z = Lanes(views[2]);
+			RandomLanes(&in.tex.x, -1.0f, 2.0f);
+			RandomLanes(&in.tex.y, -1.0f, 2.0f);
+			RandomLanes(&in.worldPosition.x, -6.0f, 6.0f);
+			RandomLanes(&in.worldPosition.y, -6.0f, 6.0f);
+			RandomLanes(&in.worldPosition.z, -6.0f, 6.0f);
+			RandomLanes(&in.viewDepth, 1.0f, 50.0f);
+
+			int mask = SR::LightPixelShader(features, buffer, &texture, &clusters.resources, in, &out);
+
+			for (int lane = 0; lane < 4; lane++) {
+				float position[2]	   = { px[lane], py[lane] };
+				float tex[2]		   = { Lane(in.tex.x, lane), Lane(in.tex.y, lane) };
+				float normal[3]		   = { normals[0][lane], normals[1][lane], normals[2][lane] };
+				float viewDirection[3] = { views[0][lane], views[1][lane], views[2][lane] };
+				float worldPosition[3] = { Lane(in.worldPosition.x, lane), Lane(in.worldPosition.y, lane), Lane(in.worldPosition.z, lane) };
+				float color[4];
+				bool  drawn;
+
+				drawn = LightPixelShader(features, buffer, &texture, &clusters, position, tex, normal, viewDirection, worldPosition,
+										 Lane(in.viewDepth, lane), color);
+
+				same = same && Near4(out, lane, color) && drawn == ((mask & (1 << lane)) != 0);
+				discarded += !drawn;
+			}
+		}
+
+		CHECK(same);
+
+		// The alpha test has something to discard, once there is a texture to give an alpha
+		if ((features & SHADER_FEATURE_ALPHA_TEST) && (features & SHADER_FEATURE_TEXTURE))
+			CHECK(discarded > 0);
+	}
+}
+
+
+
+// _shaderTexture.vs, with the object matrix of the constant buffer or of the structured buffer
+static void TestTextureShaders()
+{
+	vector<float>	texels = RandomTexels(8, 8);
+	SR::TextureType texture = { 8, 8, &texels[0] };
+	bool			same = true;
+
+	for (int n = 0; n < 50; n++) {
+		MatrixType							   view = RandomMatrix(), projection = RandomMatrix(), world = RandomMatrix();
+		SR::MatrixType						   objects[3];
+		MatrixType							   objectMatrices[3];
+		int									   instances[4] = { 2, 0, 1, 2 };
+		ConstantsType::TextureFrameBufferType  frame;
+		ConstantsType::TextureObjectBufferType object;
+		SR::TextureVertexType				   in;
+		SR::TexturePixelType				   out, outObjects;
+		SR::Float4Type						   color;
+
+		for (int i = 0; i < 3; i++) {
+			objectMatrices[i] = RandomMatrix();
+			objects[i]		  = Upload(objectMatrices[i]);
+		}
+
+		frame.view		 = Upload(view);
+		frame.projection = Upload(projection);
+		object.world	 = Upload(world);
+
+		RandomLanes(&in.position.x, -5.0f, 5.0f);
+		RandomLanes(&in.position.y, -5.0f, 5.0f);
+		RandomLanes(&in.position.z, -5.0f, 5.0f);
+		RandomLanes(&in.tex.x, 0.0f, 1.0f);
+		RandomLanes(&in.tex.y, 0.0f, 1.0f);
+
+		SR::TextureVertexShader(frame, object, in, &out);
+		SR::TextureObjectsVertexShader(frame, objects, instances, in, &outObjects);
+		SR::TexturePixelShader(texture, out, &color);
+
+		for (int lane = 0; lane < 4; lane++) {
+			float position[4] = { Lane(in.position.x, lane), Lane(in.position.y, lane), Lane(in.position.z, lane), 1.0f };
+			float expected[4], expectedObjects[4], sampled[4];
+
+			Mul(position, world, expected);
+			Mul(expected, view, expected);
+			Mul(expected, projection, expected);
+
+			Mul(position, objectMatrices[instances[lane]], expectedObjects);
+			Mul(expectedObjects, view, expectedObjects);
+			Mul(expectedObjects, projection, expectedObjects);
+
+			Sample(texture, Lane(out.tex.x, lane), Lane(out.tex.y, lane), sampled);
+
+			same = same && Near4(out.position, lane, expected) && Near4(outObjects.position, lane, expectedObjects);
+			same = same && Lane(out.tex.x, lane) == Lane(in.tex.x, lane) && Lane(outObjects.tex.y, lane) == Lane(in.tex.y, lane);
+			same = same && Near4(color, lane, sampled);
+		}
+	}
+
+	CHECK(same);
+}
+
+// _shaderTextureInstancing.vs/ps: the quad scaled, turned and moved by the instance, its texture rectangle and its tint
+static void TestTextureInstancingShaders()
+{
+	vector<float>	texels = RandomTexels(8, 8);
+	SR::TextureType texture = { 8, 8, &texels[0] };
+	bool			same = true;
+
+	for (int n = 0; n < 50; n++) {
+		MatrixType						matrices[3] = { RandomMatrix(), RandomMatrix(), RandomMatrix() };
+		ConstantsType::MatrixBufferType buffer;
+		SR::TextureInstanceVertexType	in;
+		SR::TexturePixelType			out;
+		SR::Float4Type					color;
+
+		buffer.world	  = Upload(matrices[0]);
+		buffer.view		  = Upload(matrices[1]);
+		buffer.projection = Upload(matrices[2]);
+
+		RandomLanes(&in.position.x, -1.0f, 1.0f);
+		RandomLanes(&in.position.y, -1.0f, 1.0f);
+		RandomLanes(&in.position.z, -1.0f, 1.0f);
+		RandomLanes(&in.tex.x, 0.0f, 1.0f);
+		RandomLanes(&in.tex.y, 0.0f, 1.0f);
+		RandomLanes(&in.instancePosition.x, -100.0f, 100.0f);
+		RandomLanes(&in.instancePosition.y, -100.0f, 100.0f);
+		RandomLanes(&in.instancePosition.z, -6.3f, 6.3f);
+		RandomLanes(&in.instanceSize, 1.0f, 20.0f);
+		RandomLanes(&in.instanceColor.x, 0.0f, 1.0f);
+		RandomLanes(&in.instanceColor.y, 0.0f, 1.0f);
+		RandomLanes(&in.instanceColor.z, 0.0f, 1.0f);
+		RandomLanes(&in.instanceColor.w, 0.0f, 1.0f);
+		RandomLanes(&in.instanceUV.x, 0.0f, 0.75f);
+		RandomLanes(&in.instanceUV.y, 0.0f, 0.75f);
+		RandomLanes(&in.instanceUV.z, 0.1f, 0.25f);
+		RandomLanes(&in.instanceUV.w, 0.1f, 0.25f);
+
+		SR::TextureInstancingVertexShader(buffer, in, &out);
+		SR::TextureInstancingPixelShader(texture, out, &color);
+
+		for (int lane = 0; lane < 4; lane++) {
+			float angle = Lane(in.instancePosition.z, lane), size = Lane(in.instanceSize, lane);
+			float Cos = cosf(angle), Sin = sinf(angle);
+			float pos[2] = { Lane(in.position.x, lane) * size, Lane(in.position.y, lane) * size };
+			float position[4], tex[2], sampled[4], tinted[4], tint[4];
+
+			position[0] = pos[0] * Cos - pos[1] * Sin + Lane(in.instancePosition.x, lane);
+			position[1] = pos[0] * Sin + pos[1] * Cos + Lane(in.instancePosition.y, lane);
+			position[2] = 1.0f;
+			position[3] = 1.0f;
+
+			for (int i = 0; i < 3; i++)
+				Mul(position, matrices[i], position);
+
+			tex[0] = Lane(in.instanceUV.x, lane) + Lane(in.tex.x, lane) * Lane(in.instanceUV.z, lane);
+			tex[1] = Lane(in.instanceUV.y, lane) + Lane(in.tex.y, lane) * Lane(in.instanceUV.w, lane);
+
+			tint[0] = Lane(in.instanceColor.x, lane);
+			tint[1] = Lane(in.instanceColor.y, lane);
+			tint[2] = Lane(in.instanceColor.z, lane);
+			tint[3] = Lane(in.instanceColor.w, lane);
+
+			Sample(texture, tex[0], tex[1], sampled);
+
+			for (int c = 0; c < 4; c++)
+				tinted[c] = sampled[c] * tint[c];
+
+			same = same && Near4(out.position, lane, position) && Near(Lane(out.tex.x, lane), tex[0]) && Near(Lane(out.tex.y, lane), tex[1]);
+			same = same && Near4(out.color, lane, tint) && Near4(color, lane, tinted);
+		}
+	}
+
+	CHECK(same);
+}
+
+// _shaderFont.vs/ps: the coverage of the red channel, and the distance field smoothed over the fwidth of the quad
+static void TestFontShaders()
+{
+	vector<float>	texels = RandomTexels(16, 16);
+	SR::TextureType texture = { 16, 16, &texels[0] };
+	bool			same = true;
+
+	for (int n = 0; n < 100; n++) {
+		MatrixType						matrices[3] = { RandomMatrix(), RandomMatrix(), RandomMatrix() };
+		ConstantsType::MatrixBufferType buffer;
+		SR::FontVertexType				in;
+		SR::TexturePixelType			out;
+		SR::Float4Type					color, sdf;
+
+		buffer.world	  = Upload(matrices[0]);
+		buffer.view		  = Upload(matrices[1]);
+		buffer.projection = Upload(matrices[2]);
+
+		RandomLanes(&in.position.x, -400.0f, 400.0f);
+		RandomLanes(&in.position.y, -300.0f, 300.0f);
+		RandomLanes(&in.position.z, 0.0f, 1.0f);
+		RandomLanes(&in.color.x, 0.0f, 1.0f);
+		RandomLanes(&in.color.y, 0.0f, 1.0f);
+		RandomLanes(&in.color.z, 0.0f, 1.0f);
+		RandomLanes(&in.color.w, 0.0f, 1.0f);
+
+		// The texture coordinates of a quad of pixels a texel or so apart, as a letter drawn at about its size
+		float u = Random(0.0f, 1.0f), v = Random(0.0f, 1.0f), step = Random(0.2f, 2.0f) / 16;
+		float us[4] = { u, u + step, u, u + step }, vs[4] = { v, v, v + step, v + step };
+
+		in.tex.x = Lanes(us);
+		in.tex.y = Lanes(vs);
+
+		SR::FontVertexShader(buffer, in, &out);
+		SR::FontPixelShader(texture, out, &color);
+		SR::FontSdfPixelShader(texture, out, &sdf);
+
+		float distances[4];
+
+		for (int lane = 0; lane < 4; lane++) {
+			float sampled[4];
+
+			Sample(texture, us[lane], vs[lane], sampled);
+			distances[lane] = sampled[0];
+		}
+
+		for (int lane = 0; lane < 4; lane++) {
+			float position[4] = { Lane(in.position.x, lane), Lane(in.position.y, lane), Lane(in.position.z, lane), 1.0f };
+			float inColor[4]  = { Lane(in.color.x, lane), Lane(in.color.y, lane), Lane(in.color.z, lane), Lane(in.color.w, lane) };
+			float coverage[4], smoothed[4];
+
+			for (int i = 0; i < 3; i++)
+				Mul(position, matrices[i], position);
+
+			// ddx across the row of the lane, ddy down its column
+			int	  row = lane & 2, column = lane & 1;
+			float ddx = distances[row + 1] - distances[row];
+			float ddy = distances[column + 2] - distances[column];
+			float width = fmaxf(fabsf(ddx) + fabsf(ddy), 0.0001f);
+
+			memcpy(coverage, inColor, sizeof(inColor));
+			memcpy(smoothed, inColor, sizeof(inColor));
+			coverage[3] *= distances[lane];
+			smoothed[3] *= Smoothstep(0.5f - width, 0.5f + width, distances[lane]);
+
+			same = same && Near4(out.position, lane, position) && Near4(out.color, lane, inColor);
+			same = same && Near4(color, lane, coverage) && Near4(sdf, lane, smoothed);
+		}
+	}
+
+	CHECK(same);
+}
+
+int main()
+{
+	srand(1);
+
+	TestSample();
+	TestLightVertexShader();
+	TestLightPixelShader();
+	TestTextureShaders();
+	TestTextureInstancingShaders();
+	TestFontShaders();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,794 @@
+// SoftwareBackendClass against the pixels its draws must give: a lit cube through the light shader twin against a ray cast
+// of its faces, the sprites of SpritePassClass through the instancing twin blended over each other in their order, and text
+// through the font twin. A mesh of jittered triangles, some edges through the pixel centers, has to cover every pixel once:
+// no gaps and no pixel drawn twice along the edges the triangles share. The back faces are culled, and drawn when the state keeps them.
+// Every picture is drawn on 1 and on 3 threads and has to be the same byte for byte, the tiles of 64 pixels cut across all of them.
+
+#include "__testCheck.h"
+#include "__softwareBackendClass.h"
+#include "__spritePassClass.h"
+#include "__perfHudBuilderClass.h"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+using namespace std;
+
+typedef RenderBackendClass					RB;
+typedef ShaderReferenceClass				SR;
+typedef ShaderReferenceClass::ConstantsType ConstantsType;
+typedef PerfHudBuilderClass::VertexType		FontVertexType;
+
+#define WIDTH  160
+#define HEIGHT 128
+
+// The clear color of the pictures, as the 8 bit target holds it
+static const float s_background[4] = { 0.0f, 0.0f, 64.0f / 255.0f, 1.0f };
+
+// A matrix in the D3DX order, the row vectors are multiplied on the left
+struct MatrixType {
+	float m[4][4];
+};
+
+static MatrixType Identity()
+{
+	MatrixType matrix;
+
+	memset(&matrix, 0, sizeof(matrix));
+
+	for (int i = 0; i < 4; i++)
+		matrix.m[i][i] = 1.0f;
+
+	return matrix;
+}
+
+static MatrixType Multiply(const MatrixType &a, const MatrixType &b)
+{
+	MatrixType result;
+
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			result.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
+
+	return result;
+}
+
+// D3DXMatrixRotationX and D3DXMatrixRotationY
+static MatrixType RotationX(float angle)
+{
+	MatrixType matrix = Identity();
+
+	matrix.m[1][1] = matrix.m[2][2] = cosf(angle);
+	matrix.m[1][2] = sinf(angle);
+	matrix.m[2][1] = -sinf(angle);
+
+	return matrix;
+}
+
+static MatrixType RotationY(float angle)
+{
+	MatrixType matrix = Identity();
+
+	matrix.m[0][0] = matrix.m[2][2] = cosf(angle);
+	matrix.m[0][2] = -sinf(angle);
+	matrix.m[2][0] = sinf(angle);
+
+	return matrix;
+}
+
+// What the shader classes upload: the transposed matrix
+static SR::MatrixType Upload(const MatrixType &matrix)
+{
+	SR::MatrixType transposed;
+
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			transposed.m[i][j] = matrix.m[j][i];
+
+	return transposed;
+}
+
+// v * M for a direction, the fourth row left out
+static void Rotate(const float *v, const MatrixType &matrix, float *out)
+{
+	for (int j = 0; j < 3; j++)
+		out[j] = v[0] * matrix.m[0][j] + v[1] * matrix.m[1][j] + v[2] * matrix.m[2][j];
+}
+
+static float Dot3(const float *a, const float *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static float Saturate(float x)
+{
+	return x < 0.0f ? 0.0f : (x > 1.0f ? 1.0f : x);
+}
+
+// The pixel holds the color as the 8 bit target rounds it, a level off for the float math of the twins
+static bool SamePixel(const vector<unsigned char> &pixels, int x, int y, const float *color)
+{
+	const unsigned char *pixel = &pixels[(y * WIDTH + x) * 4];
+
+	for (int c = 0; c < 4; c++) {
+		int expected = (int)floorf(Saturate(color[c]) * 255.0f + 0.5f);
+
+		if (pixel[c] < expected - 1 || pixel[c] > expected + 1)
+			return false;
+	}
+
+	return true;
+}
+
+static RB::HandleType CreateShader(SoftwareBackendClass *backend, int stage, const char *entry, const RB::VertexElementType *elements, int elementCount)
+{
+	RB::ShaderDescType shaderDesc;
+
+	memset(&shaderDesc, 0, sizeof(shaderDesc));
+	shaderDesc.stage		= stage;
+	shaderDesc.entry		= entry;
+	shaderDesc.elements		= elements;
+	shaderDesc.elementCount = elementCount;
+
+	return backend->CreateShader(shaderDesc);
+}
+
+static RB::HandleType CreateBuffer(SoftwareBackendClass *backend, int type, int size, const void *data)
+{
+	RB::BufferDescType bufferDesc = { type, size, 0, data == 0 };
+
+	return backend->CreateBuffer(bufferDesc, data);
+}
+
+static RB::HandleType CreateState(SoftwareBackendClass *backend, bool alphaBlending, bool depthTest, bool cullBack)
+{
+	RB::StateDescType stateDesc = { alphaBlending, depthTest, depthTest, cullBack };
+
+	return backend->CreateState(stateDesc);
+}
+
+// The font shaders of the HUD of HeadlessRunnerClass, with the layout of FontShaderClass::VertexType
+static bool CreateFontShaders(SoftwareBackendClass *backend, RB::HandleType *vertexShader, RB::HandleType *pixelShader)
+{
+	RB::VertexElementType elements[3] = {
+		{ "POSITION", 0,  6, 0,  0, false },
+		{ "TEXCOORD", 0, 16, 0, 12, false },
+		{ "COLOR",	  0,  2, 0, 20, false },
+	};
+
+	*vertexShader = CreateShader(backend, RENDER_STAGE_VERTEX, "FontVertexShader", elements, 3);
+	*pixelShader  = CreateShader(backend, RENDER_STAGE_PIXEL, "FontPixelShader", 0, 0);
+
+	return *vertexShader && *pixelShader;
+}
+
+// The matrices of the 2D drawing: the positions in pixels from the middle of the screen, y going up
+static SpritePassClass::MatrixBufferType ScreenMatrices()
+{
+	SpritePassClass::MatrixBufferType matrices;
+	MatrixType						  projection = Identity();
+
+	projection.m[0][0] = 2.0f / WIDTH;
+	projection.m[1][1] = 2.0f / HEIGHT;
+	projection.m[2][2] = 0.5f;
+
+	matrices.world		= Upload(Identity());
+	matrices.view		= Upload(Identity());
+	matrices.projection = Upload(projection);
+
+	return matrices;
+}
+
+// --- The cube ---
+
+struct LightVertexType {
+	float x, y, z;
+	float u, v;
+	float nx, ny, nz;
+};
+
+// The faces of the unit cube: the normal and the two directions along the face
+static const float s_faces[6][3][3] = {
+	{ {  0.0f,  0.0f, -1.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {  0.0f,  0.0f,  1.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ { -1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {  1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {  0.0f, -1.0f,  0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+	{ {  0.0f,  1.0f,  0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+};
+
+// The cube turned around y, then around x, seen along z; the projection keeps the pixels square and puts z from -1..1 into 0..1.
+#define CUBE_SCALE_Y 0.8f
+#define CUBE_SCALE_X (CUBE_SCALE_Y * HEIGHT / WIDTH)
+
+static MatrixType CubeWorld()
+{
+	return Multiply(RotationY(0.6f), RotationX(0.5f));
+}
+
+static MatrixType CubeProjection()
+{
+	MatrixType projection = Identity();
+
+	projection.m[0][0] = CUBE_SCALE_X;
+	projection.m[1][1] = CUBE_SCALE_Y;
+	projection.m[2][2] = 0.5f;
+	projection.m[3][2] = 0.5f;
+
+	return projection;
+}
+
+// Two triangles a face, clockwise from outside like the models of the project
+static void MakeCube(LightVertexType *vertices)
+{
+	static const float corners[6][2] = { { -1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f }, { -1.0f, -1.0f }, { 1.0f, 1.0f }, { 1.0f, -1.0f } };
+
+	for (int f = 0; f < 6; f++) {
+		const float *normal = s_faces[f][0];
+		const float *u		= s_faces[f][1];
+		const float *v		= s_faces[f][2];
+		float		 cross[3];
+
+		// The corners go clockwise seen from outside when u x v points into the cube, the other way round along u otherwise.
+		cross[0]  = u[1] * v[2] - u[2] * v[1];
+		cross[1]  = u[2] * v[0] - u[0] * v[2];
+		cross[2]  = u[0] * v[1] - u[1] * v[0];
+		float way = Dot3(cross, normal) < 0.0f ? 1.0f : -1.0f;
+
+		for (int i = 0; i < 6; i++) {
+			LightVertexType &vertex = vertices[f * 6 + i];
+			float			 a		= corners[i][0] * 0.5f * way;
+			float			 b		= corners[i][1] * 0.5f;
+
+			vertex.x  = normal[0] * 0.5f + u[0] * a + v[0] * b;
+			vertex.y  = normal[1] * 0.5f + u[1] * a + v[1] * b;
+			vertex.z  = normal[2] * 0.5f + u[2] * a + v[2] * b;
+			vertex.u  = 0.0f;
+			vertex.v  = 0.0f;
+			vertex.nx = normal[0];
+			vertex.ny = normal[1];
+			vertex.nz = normal[2];
+		}
+	}
+}
+
+// The light of the cube: dimmer than the diffuse on every face that looks away from it
+static ConstantsType::LightBufferType CubeLight()
+{
+	ConstantsType::LightBufferType light;
+	float						   length = sqrtf(0.4f * 0.4f + 0.6f * 0.6f + 1.0f);
+
+	memset(&light, 0, sizeof(light));
+	light.ambientColor.x   = light.ambientColor.y = light.ambientColor.z = 0.15f;
+	light.ambientColor.w   = 1.0f;
+	light.diffuseColor.x   = 0.9f;
+	light.diffuseColor.y   = 0.6f;
+	light.diffuseColor.z   = 0.3f;
+	light.diffuseColor.w   = 1.0f;
+	light.lightDirection.x = 0.4f / length;
+	light.lightDirection.y = -0.6f / length;
+	light.lightDirection.z = 1.0f / length;
+	light.specularPower	   = 32.0f;
+
+	return light;
+}
+
+// The color of a face lit like _shaderLight.ps does without its features
+static void FaceColor(const float *normal, const ConstantsType::LightBufferType &light, float *color)
+{
+	float direction[3] = { -light.lightDirection.x, -light.lightDirection.y, -light.lightDirection.z };
+	float ambient[4]   = { light.ambientColor.x, light.ambientColor.y, light.ambientColor.z, light.ambientColor.w };
+	float diffuse[4]   = { light.diffuseColor.x, light.diffuseColor.y, light.diffuseColor.z, light.diffuseColor.w };
+	float intensity	   = Saturate(Dot3(normal, direction));
+
+	for (int c = 0; c < 4; c++)
+		color[c] = intensity > 0.0f ? Saturate(ambient[c] + diffuse[c] * intensity) : ambient[c];
+}
+
+// The ray of every pixel center against the front faces of the cube: the pixels well inside a face get its color,
+// the ones well away from all of them the background. Those near an edge are left to the rasterizer; returns the pixels checked.
+static int CheckCube(const vector<unsigned char> &pixels, int *wrong)
+{
+	ConstantsType::LightBufferType light  = CubeLight();
+	MatrixType					   world  = CubeWorld();
+	float						   margin = 0.08f;
+	int							   checked = 0;
+
+	*wrong = 0;
+
+	for (int py = 0; py < HEIGHT; py++)
+		for (int px = 0; px < WIDTH; px++) {
+			float		 x		= ((px + 0.5f) / WIDTH * 2.0f - 1.0f) / CUBE_SCALE_X;
+			float		 y		= (1.0f - (py + 0.5f) / HEIGHT * 2.0f) / CUBE_SCALE_Y;
+			const float *color	= s_background;
+			bool		 inside = false, near = false;
+			float		 faceColor[4];
+
+			for (int f = 0; f < 6; f++) {
+				float normal[3], u[3], v[3], center[3], point[3], a, b;
+
+				Rotate(s_faces[f][0], world, normal);
+				Rotate(s_faces[f][1], world, u);
+				Rotate(s_faces[f][2], world, v);
+
+				if (normal[2] >= 0.0f)
+					continue;
+
+				for (int k = 0; k < 3; k++)
+					center[k] = normal[k] * 0.5f;
+
+				point[0] = x - center[0];
+				point[1] = y - center[1];
+				point[2] = (Dot3(normal, center) - normal[0] * x - normal[1] * y) / normal[2] - center[2];
+
+				a = fabsf(Dot3(point, u));
+				b = fabsf(Dot3(point, v));
+
+				if (a < 0.5f - margin && b < 0.5f - margin) {
+					FaceColor(normal, light, faceColor);
+					color  = faceColor;
+					inside = true;
+				}
+				else if (a < 0.5f + margin && b < 0.5f + margin)
+					near = true;
+			}
+
+			if (near && !inside)
+				continue;
+
+			checked++;
+
+			if (!SamePixel(pixels, px, py, color))
+				(*wrong)++;
+		}
+
+	return checked;
+}
+
+static void DrawCube(int threads, bool depthTest, bool cullBack, vector<unsigned char> *pixels, int *triangles)
+{
+	SoftwareBackendClass				 backend;
+	LightVertexType						 vertices[36];
+	ConstantsType::LightFrameBufferType	 frame;
+	ConstantsType::LightObjectBufferType object;
+	ConstantsType::LightBufferType		 light = CubeLight();
+	unsigned int						 stride = sizeof(LightVertexType), offset = 0;
+
+	RB::VertexElementType elements[3] = {
+		{ "POSITION", 0,  6, 0,  0, false },
+		{ "TEXCOORD", 0, 16, 0, 12, false },
+		{ "NORMAL",	  0,  6, 0, 20, false },
+	};
+
+	CHECK(backend.Initialize(WIDTH, HEIGHT, threads));
+
+	MakeCube(vertices);
+
+	memset(&frame, 0, sizeof(frame));
+	frame.view		 = Upload(Identity());
+	frame.projection = Upload(CubeProjection());
+	object.world	 = Upload(CubeWorld());
+
+	RB::HandleType vertexShader	  = CreateShader(&backend, RENDER_STAGE_VERTEX, "LightVertexShader", elements, 3);
+	RB::HandleType pixelShader	  = CreateShader(&backend, RENDER_STAGE_PIXEL, "LightPixelShader", 0, 0);
+	RB::HandleType vertexBuffer	  = CreateBuffer(&backend, RENDER_BUFFER_VERTEX, sizeof(vertices), vertices);
+	RB::HandleType constants[3]	  = { CreateBuffer(&backend, RENDER_BUFFER_CONSTANT, sizeof(frame), 0),
+									  CreateBuffer(&backend, RENDER_BUFFER_CONSTANT, sizeof(object), 0),
+									  CreateBuffer(&backend, RENDER_BUFFER_CONSTANT, sizeof(light), 0) };
+	RB::HandleType state		  = CreateState(&backend, false, depthTest, cullBack);
+
+	CHECK(vertexShader && pixelShader && vertexBuffer && constants[0] && constants[1] && constants[2] && state);
+
+	backend.BeginFrame(s_background);
+	backend.ResetCounters();
+
+	CHECK(backend.UpdateBuffer(constants[0], &frame, sizeof(frame)));
+	CHECK(backend.UpdateBuffer(constants[1], &object, sizeof(object)));
+	CHECK(backend.UpdateBuffer(constants[2], &light, sizeof(light)));
+
+	backend.SetState(state);
+	backend.SetShaders(vertexShader, pixelShader);
+	backend.SetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	backend.SetConstantBuffers(RENDER_STAGE_VERTEX, 0, 2, constants);
+	backend.SetConstantBuffers(RENDER_STAGE_PIXEL, 0, 1, &constants[2]);
+	backend.Draw(36, 0);
+	backend.EndFrame();
+
+	pixels->resize(WIDTH * HEIGHT * 4);
+	backend.GetPixels(&(*pixels)[0]);
+	*triangles = backend.GetTriangleCount();
+
+	backend.Shutdown();
+}
+
+// The three faces that look at the camera are drawn, the three others are culled. Kept, the back faces are hidden
+// by the depth test; culled, the front faces are all that is left even without it.
+static void TestCube(int threads, vector<unsigned char> *pixels)
+{
+	vector<unsigned char> other;
+	int					  triangles, checked, wrong;
+
+	DrawCube(threads, true, true, pixels, &triangles);
+	checked = CheckCube(*pixels, &wrong);
+
+	CHECK(triangles == 6);
+	CHECK(checked > WIDTH * HEIGHT / 2 && wrong == 0);
+
+	DrawCube(threads, true, false, &other, &triangles);
+	checked = CheckCube(other, &wrong);
+
+	CHECK(triangles == 12);
+	CHECK(checked > WIDTH * HEIGHT / 2 && wrong == 0);
+
+	DrawCube(threads, false, true, &other, &triangles);
+	checked = CheckCube(other, &wrong);
+
+	CHECK(triangles == 6);
+	CHECK(checked > WIDTH * HEIGHT / 2 && wrong == 0);
+	CHECK(other == *pixels);
+}
+
+// --- The sprites ---
+
+// Three sprites on a one color texture: the second half over the first, the third turned by 45 degrees and twice as big.
+static void TestSprites(int threads, vector<unsigned char> *pixels)
+{
+	SoftwareBackendClass		  backend;
+	SpritePassClass				  pass;
+	SpritePassClass::InstanceType instances[3];
+	RB::HandleType				  vertexShader, pixelShader;
+	RB::TextureDescType			  textureDesc = { 2, 2, RENDER_FORMAT_RGBA8, false };
+	unsigned char				  texels[2 * 2 * 4];
+	float						  texel[4] = { 1.0f, 200.0f / 255.0f, 100.0f / 255.0f, 1.0f };
+
+	for (int i = 0; i < 4; i++) {
+		texels[i * 4]	  = 255;
+		texels[i * 4 + 1] = 200;
+		texels[i * 4 + 2] = 100;
+		texels[i * 4 + 3] = 255;
+	}
+
+	CHECK(backend.Initialize(WIDTH, HEIGHT, threads));
+	CHECK(SpritePassClass::CreateShaders(&backend, 0, 0, 0, 0, &vertexShader, &pixelShader));
+
+	RB::HandleType texture = backend.CreateTexture(textureDesc, texels, 2 * 4);
+	RB::HandleType state   = CreateState(&backend, true, false, true);
+
+	CHECK(pass.Initialize(&backend, 16, 3, vertexShader, pixelShader, texture, state));
+
+	float placed[3][8] = {
+		// x, y, rotation, size, color
+		{ -48.0f,  24.0f, 0.0f,		  1.0f, 1.0f, 1.0f, 1.0f, 1.0f  },
+		{ -40.0f,  16.0f, 0.0f,		  1.0f, 0.0f, 1.0f, 0.0f, 0.5f  },
+		{  40.0f, -20.0f, 0.7853982f, 2.0f, 1.0f, 0.0f, 0.0f, 0.75f },
+	};
+
+	for (int i = 0; i < 3; i++) {
+		memcpy(&instances[i], placed[i], sizeof(placed[i]));
+		instances[i].u		 = 0.0f;
+		instances[i].v		 = 0.0f;
+		instances[i].uWidth	 = 1.0f;
+		instances[i].vHeight = 1.0f;
+	}
+
+	backend.BeginFrame(s_background);
+	backend.ResetCounters();
+
+	pass.SetInstances(instances, 3);
+	pass.SetMatrices(ScreenMatrices());
+	CHECK(pass.Render(&backend));
+
+	backend.EndFrame();
+
+	pixels->resize(WIDTH * HEIGHT * 4);
+	backend.GetPixels(&(*pixels)[0]);
+
+	CHECK(backend.GetTriangleCount() == 6);
+
+	// The screen center is (80, 64): the first sprite covers 24..39 x 32..47, the second 32..47 x 40..55.
+	float first[4]	 = { texel[0], texel[1], texel[2], 1.0f };
+	float over[4]	 = { first[0] * 0.5f, texel[1] * 0.5f + first[1] * 0.5f, first[2] * 0.5f, 0.5f };
+	float alone[4]	 = { 0.0f, texel[1] * 0.5f, s_background[2] * 0.5f, 0.5f };
+	float turned[4]	 = { 0.75f, 0.0f, s_background[2] * 0.25f, 0.75f };
+
+	CHECK(SamePixel(*pixels, 26, 34, first));
+	CHECK(SamePixel(*pixels, 39, 39, first));
+	CHECK(SamePixel(*pixels, 36, 44, over));
+	CHECK(SamePixel(*pixels, 44, 52, alone));
+	CHECK(SamePixel(*pixels, 23, 40, s_background));
+	CHECK(SamePixel(*pixels, 48, 48, s_background));
+
+	// The third is centered on (120, 84), its corners on the axes 22.6 pixels out: it has the corner
+	// of the unturned sprite outside, and the points of its corners inside.
+	CHECK(SamePixel(*pixels, 120, 84, turned));
+	CHECK(SamePixel(*pixels, 120 + 20, 84, turned));
+	CHECK(SamePixel(*pixels, 120, 84 - 20, turned));
+	CHECK(SamePixel(*pixels, 120 + 14, 84 + 14, s_background));
+	CHECK(SamePixel(*pixels, 120 - 14, 84 - 14, s_background));
+
+	pass.Shutdown();
+	backend.Shutdown();
+}
+
+// --- The text ---
+
+// Two glyphs of 8 x 8 texels in an R8 texture: I is solid, O is a box with a line of texels around an empty inside.
+#define GLYPH_TEXELS 8
+#define GLYPH_SCALE	 4
+#define GLYPH_SIZE	 (GLYPH_TEXELS * GLYPH_SCALE)
+#define GLYPH_ADVANCE (GLYPH_SIZE + 4)
+
+// The quads of the letters like FontClass::BuildVertexArray makes them, the pen at the top left of the first one
+static int WriteText(const char *text, float left, float top, const float *color, FontVertexType *vertices)
+{
+	static const float corners[6][2] = { { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } };
+	int				   count		 = 0;
+
+	for (int i = 0; text[i]; i++, left += GLYPH_ADVANCE) {
+		if (text[i] == ' ')
+			continue;
+
+		float u0 = text[i] == 'I' ? 0.0f : 0.5f;
+
+		for (int k = 0; k < 6; k++) {
+			FontVertexType &vertex = vertices[count++];
+
+			vertex.x = left + corners[k][0] * GLYPH_SIZE;
+			vertex.y = top - corners[k][1] * GLYPH_SIZE;
+			vertex.z = 0.0f;
+			vertex.u = u0 + corners[k][0] * 0.5f;
+			vertex.v = corners[k][1];
+			vertex.r = color[0];
+			vertex.g = color[1];
+			vertex.b = color[2];
+			vertex.a = color[3];
+		}
+	}
+
+	return count;
+}
+
+static void TestText(int threads, vector<unsigned char> *pixels)
+{
+	SoftwareBackendClass			  backend;
+	SpritePassClass::MatrixBufferType matrices = ScreenMatrices();
+	RB::TextureDescType				  textureDesc = { GLYPH_TEXELS * 2, GLYPH_TEXELS, RENDER_FORMAT_R8, false };
+	RB::HandleType					  vertexShader, pixelShader;
+	FontVertexType					  vertices[4 * 6];
+	unsigned char					  texels[GLYPH_TEXELS * 2 * GLYPH_TEXELS];
+	unsigned int					  stride = sizeof(FontVertexType), offset = 0;
+	float							  color[4] = { 1.0f, 0.5f, 0.25f, 1.0f };
+	int								  vertexCount;
+
+	for (int y = 0; y < GLYPH_TEXELS; y++)
+		for (int x = 0; x < GLYPH_TEXELS * 2; x++) {
+			bool border = x == GLYPH_TEXELS || x == GLYPH_TEXELS * 2 - 1 || y == 0 || y == GLYPH_TEXELS - 1;
+
+			texels[y * GLYPH_TEXELS * 2 + x] = x < GLYPH_TEXELS || border ? 255 : 0;
+		}
+
+	CHECK(backend.Initialize(WIDTH, HEIGHT, threads));
+	CHECK(CreateFontShaders(&backend, &vertexShader, &pixelShader));
+
+	// The text starts 8 pixels in from the left and 24 down from the top
+	vertexCount = WriteText("IO I", 8.0f - WIDTH / 2, HEIGHT / 2 - 24.0f, color, vertices);
+
+	RB::HandleType texture		= backend.CreateTexture(textureDesc, texels, GLYPH_TEXELS * 2);
+	RB::HandleType vertexBuffer = CreateBuffer(&backend, RENDER_BUFFER_VERTEX, sizeof(vertices), vertices);
+	RB::HandleType matrixBuffer = CreateBuffer(&backend, RENDER_BUFFER_CONSTANT, sizeof(matrices), 0);
+	RB::HandleType state		= CreateState(&backend, true, false, true);
+
+	CHECK(texture && vertexBuffer && matrixBuffer && state);
+	CHECK(vertexCount == 3 * 6);
+
+	backend.BeginFrame(s_background);
+	backend.ResetCounters();
+
+	CHECK(backend.UpdateBuffer(matrixBuffer, &matrices, sizeof(matrices)));
+
+	backend.SetState(state);
+	backend.SetShaders(vertexShader, pixelShader);
+	backend.SetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	backend.SetConstantBuffers(RENDER_STAGE_VERTEX, 0, 1, &matrixBuffer);
+	backend.SetTextures(RENDER_STAGE_PIXEL, 0, 1, &texture);
+	backend.Draw(vertexCount, 0);
+	backend.EndFrame();
+
+	pixels->resize(WIDTH * HEIGHT * 4);
+	backend.GetPixels(&(*pixels)[0]);
+
+	CHECK(backend.GetTriangleCount() == 6);
+
+	// The glyphs start at x = 8, 44, (80) and 116, y = 24; the coverage is the alpha, the color is the one of the vertices.
+	// Blended ONE, ZERO the alpha of the target is the one of the text, none inside the O.
+	int	  middle   = 24 + GLYPH_SIZE / 2;
+	float empty[4] = { s_background[0], s_background[1], s_background[2], 0.0f };
+
+	CHECK(SamePixel(*pixels, 8 + GLYPH_SIZE / 2, middle, color));
+	CHECK(SamePixel(*pixels, 44 + GLYPH_SIZE / 2, middle, empty));
+	CHECK(SamePixel(*pixels, 44 + GLYPH_SIZE / 2, 24 + 1, color));
+	CHECK(SamePixel(*pixels, 44 + 1, middle, color));
+	CHECK(SamePixel(*pixels, 80 + GLYPH_SIZE / 2, middle, s_background));
+	CHECK(SamePixel(*pixels, 116 + GLYPH_SIZE / 2, middle, color));
+
+	// Between the letters, above and below the line
+	CHECK(SamePixel(*pixels, 8 + GLYPH_SIZE + 2, middle, s_background));
+	CHECK(SamePixel(*pixels, 8 + GLYPH_SIZE / 2, 24 - 2, s_background));
+	CHECK(SamePixel(*pixels, 8 + GLYPH_SIZE / 2, 24 + GLYPH_SIZE + 1, s_background));
+
+	backend.Shutdown();
+}
+
+// --- The shared edges ---
+
+// A grid of cells past the edges of the screen, two triangles a cell with the diagonal changing from cell to cell.
+// The even rows and columns of vertices sit on pixel centers, so the edges between them run through the centers and the top left
+// rule decides; the others are moved by up to a third of a cell, which makes edges of every slope.
+#define MESH_CELLS_X 11
+#define MESH_CELLS_Y 9
+
+static unsigned int s_random = 12345;
+
+static float Random()
+{
+	s_random = s_random * 1664525 + 1013904223;
+
+	return (s_random >> 8) / 16777216.0f;
+}
+
+static int MakeMesh(bool reversed, FontVertexType *vertices)
+{
+	float x[MESH_CELLS_Y + 1][MESH_CELLS_X + 1], y[MESH_CELLS_Y + 1][MESH_CELLS_X + 1];
+	float cellX = (WIDTH  + 32.0f) / MESH_CELLS_X;
+	float cellY = (HEIGHT + 32.0f) / MESH_CELLS_Y;
+	int	  count = 0;
+
+	s_random = 12345;
+
+	// The screen positions of the vertices, 16 pixels past the edges
+	for (int j = 0; j <= MESH_CELLS_Y; j++)
+		for (int i = 0; i <= MESH_CELLS_X; i++) {
+			x[j][i] = -16.0f + i * cellX;
+			y[j][i] = -16.0f + j * cellY;
+			x[j][i] = i % 2 ? x[j][i] + (Random() - 0.5f) * cellX * 0.6f : floorf(x[j][i]) + 0.5f;
+			y[j][i] = j % 2 ? y[j][i] + (Random() - 0.5f) * cellY * 0.6f : floorf(y[j][i]) + 0.5f;
+		}
+
+	for (int j = 0; j < MESH_CELLS_Y; j++)
+		for (int i = 0; i < MESH_CELLS_X; i++) {
+			int corners[2][3][2];
+
+			// Clockwise on the screen
+			if ((i + j) % 2) {
+				int first[2][3][2] = { { { 0, 0 }, { 1, 0 }, { 0, 1 } }, { { 1, 0 }, { 1, 1 }, { 0, 1 } } };
+				memcpy(corners, first, sizeof(corners));
+			}
+			else {
+				int second[2][3][2] = { { { 0, 0 }, { 1, 0 }, { 1, 1 } }, { { 0, 0 }, { 1, 1 }, { 0, 1 } } };
+				memcpy(corners, second, sizeof(corners));
+			}
+
+			for (int t = 0; t < 2; t++)
+				for (int k = 0; k < 3; k++) {
+					int				corner = reversed ? (3 - k) % 3 : k;
+					int				ci	   = i + corners[t][corner][0];
+					int				cj	   = j + corners[t][corner][1];
+					FontVertexType &vertex = vertices[count++];
+
+					vertex.x = x[cj][ci] - WIDTH / 2;
+					vertex.y = HEIGHT / 2 - y[cj][ci];
+					vertex.z = 0.0f;
+					vertex.u = vertex.v = 0.5f;
+					vertex.r = vertex.g = vertex.b = 1.0f;
+					vertex.a = 0.5f;
+				}
+		}
+
+	return count;
+}
+
+// The mesh drawn with half its color over black: a pixel drawn once is 128, twice 191, never 0.
+static void DrawMesh(int threads, bool reversed, bool cullBack, vector<unsigned char> *pixels, int *triangles)
+{
+	SoftwareBackendClass			  backend;
+	SpritePassClass::MatrixBufferType matrices = ScreenMatrices();
+	RB::TextureDescType				  textureDesc = { 2, 2, RENDER_FORMAT_R8, false };
+	RB::HandleType					  vertexShader, pixelShader;
+	vector<FontVertexType>			  vertices(MESH_CELLS_X * MESH_CELLS_Y * 6);
+	unsigned char					  texels[4] = { 255, 255, 255, 255 };
+	unsigned int					  stride = sizeof(FontVertexType), offset = 0;
+	float							  black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	int								  vertexCount;
+
+	CHECK(backend.Initialize(WIDTH, HEIGHT, threads));
+	CHECK(CreateFontShaders(&backend, &vertexShader, &pixelShader));
+
+	vertexCount = MakeMesh(reversed, &vertices[0]);
+
+	RB::HandleType texture		= backend.CreateTexture(textureDesc, texels, 2);
+	RB::HandleType vertexBuffer = CreateBuffer(&backend, RENDER_BUFFER_VERTEX, vertexCount * sizeof(FontVertexType), &vertices[0]);
+	RB::HandleType matrixBuffer = CreateBuffer(&backend, RENDER_BUFFER_CONSTANT, sizeof(matrices), 0);
+	RB::HandleType state		= CreateState(&backend, true, false, cullBack);
+
+	CHECK(texture && vertexBuffer && matrixBuffer && state);
+
+	backend.BeginFrame(black);
+	backend.ResetCounters();
+
+	CHECK(backend.UpdateBuffer(matrixBuffer, &matrices, sizeof(matrices)));
+
+	backend.SetState(state);
+	backend.SetShaders(vertexShader, pixelShader);
+	backend.SetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	backend.SetConstantBuffers(RENDER_STAGE_VERTEX, 0, 1, &matrixBuffer);
+	backend.SetTextures(RENDER_STAGE_PIXEL, 0, 1, &texture);
+	backend.Draw(vertexCount, 0);
+	backend.EndFrame();
+
+	pixels->resize(WIDTH * HEIGHT * 4);
+	backend.GetPixels(&(*pixels)[0]);
+	*triangles = backend.GetTriangleCount();
+
+	backend.Shutdown();
+}
+
+// The pixels drawn once, and the ones not drawn or drawn more than once
+static void CountCoverage(const vector<unsigned char> &pixels, int *once, int *gaps, int *twice)
+{
+	*once = *gaps = *twice = 0;
+
+	for (size_t i = 0; i < pixels.size(); i += 4)
+		if (pixels[i] == 0)
+			(*gaps)++;
+		else if (pixels[i] == 128 && pixels[i + 1] == 128 && pixels[i + 2] == 128)
+			(*once)++;
+		else
+			(*twice)++;
+}
+
+static void TestEdges(int threads, vector<unsigned char> *pixels)
+{
+	vector<unsigned char> other;
+	int					  triangles, otherTriangles, once, gaps, twice;
+
+	DrawMesh(threads, false, true, pixels, &triangles);
+	CountCoverage(*pixels, &once, &gaps, &twice);
+
+	CHECK(triangles > MESH_CELLS_X * MESH_CELLS_Y);
+	CHECK(once == WIDTH * HEIGHT && gaps == 0 && twice == 0);
+
+	// Turned around, the triangles are all back faces: culled, nothing is drawn
+	DrawMesh(threads, true, true, &other, &otherTriangles);
+	CountCoverage(other, &once, &gaps, &twice);
+
+	CHECK(otherTriangles == 0);
+	CHECK(gaps == WIDTH * HEIGHT);
+
+	// Kept, the back faces share their edges the same way
+	DrawMesh(threads, true, false, &other, &otherTriangles);
+	CountCoverage(other, &once, &gaps, &twice);
+
+	CHECK(otherTriangles == triangles);
+	CHECK(once == WIDTH * HEIGHT && gaps == 0 && twice == 0);
+}
+
+// A test on 1 and on 3 threads, the pictures have to be the same
+static void TestThreads(void (*test)(int, vector<unsigned char> *))
+{
+	vector<unsigned char> one, several;
+
+	test(1, &one);
+	test(3, &several);
+
+	CHECK(!one.empty() && one == several);
+}
+
+int main()
+{
+	TestThreads(TestCube);
+	TestThreads(TestSprites);
+	TestThreads(TestText);
+	TestThreads(TestEdges);
+
+	return TEST_RESULT();
+}
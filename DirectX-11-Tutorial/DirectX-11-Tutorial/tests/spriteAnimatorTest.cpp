@@ -0,0 +1,178 @@
+// SpriteAnimatorClass: the texture rectangles of the frames of a sprite sheet, looping and stopping animations,
+// the sprites played backwards with a negative speed, and the number of sprites the animator takes.
+
+#include "__testCheck.h"
+#include "__spriteAnimatorClass.h"
+
+#include <vector>
+using namespace std;
+
+// The instance layout of BitmapClass_Instancing: the position, then the uvRect
+struct InstanceType {
+	float position[3];
+	float uvRect[4];
+};
+
+// A 4 x 2 sheet, so the frames are 0.25 wide and 0.5 high
+#define COLUMNS 4
+#define ROWS	2
+
+static vector<InstanceType> BuildRects(SpriteAnimatorClass &animator)
+{
+	vector<InstanceType> instances(animator.GetSpriteCount());
+
+	animator.BuildUVArray(&instances[0].uvRect, sizeof(InstanceType));
+
+	return instances;
+}
+
+// The sheet frame of a rectangle, counted row by row
+static int FrameOf(const InstanceType &instance)
+{
+	return (int)(instance.uvRect[1] * ROWS + 0.5f) * COLUMNS + (int)(instance.uvRect[0] * COLUMNS + 0.5f);
+}
+
+static void TestRects()
+{
+	SpriteAnimatorClass animator;
+
+	CHECK(animator.Initialize(8, COLUMNS, ROWS));
+
+	// One still animation per frame of the sheet
+	for (int frame = 0; frame < COLUMNS * ROWS; frame++)
+		animator.AddSprite(animator.AddAnimation(frame, 1, 0.0f, false), 0.0f);
+
+	animator.Frame(0.0f);
+
+	vector<InstanceType> instances = BuildRects(animator);
+
+	for (int frame = 0; frame < COLUMNS * ROWS; frame++) {
+		CHECK(instances[frame].uvRect[0] == (frame % COLUMNS) * 0.25f);
+		CHECK(instances[frame].uvRect[1] == (frame / COLUMNS) * 0.5f);
+		CHECK(instances[frame].uvRect[2] == 0.25f);
+		CHECK(instances[frame].uvRect[3] == 0.5f);
+	}
+
+	animator.Shutdown();
+}
+
+static void TestPlayback()
+{
+	SpriteAnimatorClass animator;
+
+	CHECK(animator.Initialize(4, COLUMNS, ROWS));
+
+	// Frames 2..5 at 10 frames per second, across the end of the first row
+	int looping	 = animator.AddAnimation(2, 4, 10.0f, true);
+	int stopping = animator.AddAnimation(2, 4, 10.0f, false);
+
+	int a = animator.AddSprite(looping, 0.0f);
+	int b = animator.AddSprite(stopping, 0.0f);
+	int c = animator.AddSprite(looping, 0.1f);		// started a frame in
+	int d = animator.AddSprite(looping, 0.0f);
+
+	animator.SetSpriteSpeed(d, 2.0f);
+
+	// 0.125 s: a and b are on their frame 1, c and d on their frame 2
+	animator.Frame(0.125f);
+
+	vector<InstanceType> instances = BuildRects(animator);
+
+	CHECK(FrameOf(instances[a]) == 3);
+	CHECK(FrameOf(instances[b]) == 3);
+	CHECK(FrameOf(instances[c]) == 4);
+	CHECK(FrameOf(instances[d]) == 4);
+
+	// 0.5 s: a has looped to its frame 1, b stays on the last one
+	animator.Frame(0.375f);
+
+	instances = BuildRects(animator);
+
+	CHECK(FrameOf(instances[a]) == 3);
+	CHECK(FrameOf(instances[b]) == 5);
+
+	// Switching the animation rewinds the sprite but keeps its speed
+	animator.SetSpriteAnimation(d, stopping);
+	animator.Frame(0.0625f);
+
+	instances = BuildRects(animator);
+
+	CHECK(FrameOf(instances[d]) == 3);
+
+	animator.Shutdown();
+}
+
+// A negative speed plays backwards: the looping sprite wraps from its first frame to the last, the other stops on its first frame
+static void TestBackwards()
+{
+	SpriteAnimatorClass animator;
+
+	CHECK(animator.Initialize(2, COLUMNS, ROWS));
+
+	int looping	 = animator.AddAnimation(2, 4, 10.0f, true);
+	int stopping = animator.AddAnimation(2, 4, 10.0f, false);
+
+	int a = animator.AddSprite(looping, 0.0f);
+	int b = animator.AddSprite(stopping, 0.35f);	// on its last frame
+
+	animator.SetSpriteSpeed(a, -1.0f);
+	animator.SetSpriteSpeed(b, -1.0f);
+
+	int expectedA[] = { 5, 4, 3, 2, 5, 4, 3, 2, 5 };
+	int expectedB[] = { 4, 3, 2, 2, 2, 2, 2, 2, 2 };
+
+	// The first step only brings b to its last frame, 3.5 frames in
+	animator.Frame(0.0f);
+
+	CHECK(FrameOf(BuildRects(animator)[b]) == 5);
+
+	for (int step = 0; step < 9; step++) {
+		animator.Frame(0.1f);
+
+		vector<InstanceType> instances = BuildRects(animator);
+
+		CHECK(FrameOf(instances[a]) == expectedA[step]);
+		CHECK(FrameOf(instances[b]) == expectedB[step]);
+	}
+
+	// A step back from the first frame too small to leave 4.0 after the wrap is still on the last frame, not past it
+	animator.SetSpriteAnimation(a, looping);
+	animator.Frame(0.000000001f);
+	CHECK(FrameOf(BuildRects(animator)[a]) == 5);
+
+	// Forwards again from the first frame
+	animator.SetSpriteSpeed(b, 1.0f);
+	animator.Frame(0.1f);
+	CHECK(FrameOf(BuildRects(animator)[b]) == 3);
+
+	animator.Shutdown();
+}
+
+// The arrays are padded to 4 sprites for the SSE pass, but only the asked number of sprites is taken
+static void TestCapacity()
+{
+	SpriteAnimatorClass animator;
+
+	CHECK(!animator.Initialize(0, COLUMNS, ROWS));
+	CHECK(animator.Initialize(5, COLUMNS, ROWS));
+
+	int animation = animator.AddAnimation(0, 8, 10.0f, true);
+
+	for (int i = 0; i < 5; i++)
+		CHECK(animator.AddSprite(animation, 0.0f) == i);
+
+	CHECK(animator.AddSprite(animation, 0.0f) == -1);
+	CHECK(animator.GetSpriteCount() == 5);
+
+	animator.Shutdown();
+}
+
+int main()
+{
+	TestRects();
+	TestPlayback();
+	TestBackwards();
+	TestCapacity();
+
+	return TEST_RESULT();
+}
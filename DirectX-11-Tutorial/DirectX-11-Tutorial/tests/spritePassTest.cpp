@@ -0,0 +1,279 @@
+// SpritePassClass recorded by a HeadlessBackendClass: the stream is read back command by command.
+// The pass makes its quad, its instance buffer and its constant buffer; a frame is the upload of the instances and of the matrices,
+// the bindings with the target and one instanced draw, and nothing without instances. The instances past the most are left out.
+// Then the 2D part of the frame of GraphicsClass, two passes between the states, is replayed on another backend,
+// which records the same stream byte for byte.
+
+#include "__testCheck.h"
+#include "__spritePassClass.h"
+#include "__headlessBackendClass.h"
+
+#include <string.h>
+#include <vector>
+using namespace std;
+
+#define MAX_INSTANCES 64
+
+struct SceneType {
+	SpritePassClass::HandleType vertexShader, pixelShader, texture, state2D, state3D;
+};
+
+static bool CreateScene(RenderBackendClass *backend, SceneType *scene)
+{
+	RenderBackendClass::TextureDescType textureDesc = { 2, 2, RENDER_FORMAT_RGBA8, false };
+	RenderBackendClass::StateDescType	stateDesc	= { true, false, false, true };
+	unsigned char						texels[16];
+
+	memset(texels, 255, sizeof(texels));
+
+	scene->texture = backend->CreateTexture(textureDesc, texels, 8);
+	scene->state2D = backend->CreateState(stateDesc);
+
+	stateDesc.alphaBlending = false;
+	stateDesc.depthTest		= true;
+	stateDesc.depthWrite	= true;
+	scene->state3D = backend->CreateState(stateDesc);
+
+	return SpritePassClass::CreateShaders(backend, 0, 0, 0, 0, &scene->vertexShader, &scene->pixelShader) && scene->texture && scene->state2D && scene->state3D;
+}
+
+static void MakeInstances(vector<SpritePassClass::InstanceType> *instances, int count, float seed)
+{
+	instances->resize(count);
+
+	for (int i = 0; i < count; i++) {
+		float *values = &(*instances)[i].x;
+
+		for (int j = 0; j < 12; j++)
+			values[j] = seed + i * 12 + j;
+	}
+}
+
+static void MakeMatrices(SpritePassClass::MatrixBufferType *matrices, float seed)
+{
+	float *values = &matrices->world.m[0][0];
+
+	for (int i = 0; i < 48; i++)
+		values[i] = seed + i;
+}
+
+static void TestCreation()
+{
+	HeadlessBackendClass backend;
+	SceneType			 scene;
+	SpritePassClass		 pass;
+
+	CHECK(CreateScene(&backend, &scene));
+	backend.GetStream()->Clear();
+
+	CHECK(!pass.Initialize(0, 24, MAX_INSTANCES, scene.vertexShader, scene.pixelShader, scene.texture, scene.state2D));
+	CHECK(pass.Initialize(&backend, 24, MAX_INSTANCES, scene.vertexShader, scene.pixelShader, scene.texture, scene.state2D));
+	CHECK(backend.GetErrorCount() == 0);
+
+	// The quad of BitmapClass_Instancing around the origin, then the dynamic buffers
+	CommandStreamClass *stream = backend.GetStream();
+	const float		   *quad;
+
+	stream->Rewind();
+
+	CHECK(stream->ReadByte() == HEADLESS_CREATE_BUFFER);
+	stream->ReadUint();
+	CHECK(stream->ReadUint() == RENDER_BUFFER_VERTEX && stream->ReadUint() == 6 * 5 * sizeof(float));
+	stream->ReadUint();
+	CHECK(stream->ReadByte() == 0 && stream->ReadByte() == 1);
+
+	quad = (const float*)stream->ReadBytes(6 * 5 * sizeof(float));
+	CHECK(quad[0] == -12.0f && quad[1] == 12.0f && quad[3] == 0.0f && quad[4] == 0.0f);		// top left
+	CHECK(quad[5] == 12.0f && quad[6] == -12.0f && quad[8] == 1.0f && quad[9] == 1.0f);		// bottom right
+	CHECK(quad[20] == 12.0f && quad[21] == 12.0f && quad[23] == 1.0f && quad[24] == 0.0f);	// top right
+
+	CHECK(stream->ReadByte() == HEADLESS_CREATE_BUFFER);
+	stream->ReadUint();
+	CHECK(stream->ReadUint() == RENDER_BUFFER_VERTEX && stream->ReadUint() == MAX_INSTANCES * sizeof(SpritePassClass::InstanceType));
+	stream->ReadUint();
+	CHECK(stream->ReadByte() == 1 && stream->ReadByte() == 0);
+
+	CHECK(stream->ReadByte() == HEADLESS_CREATE_BUFFER);
+	stream->ReadUint();
+	CHECK(stream->ReadUint() == RENDER_BUFFER_CONSTANT && stream->ReadUint() == sizeof(SpritePassClass::MatrixBufferType));
+	stream->ReadUint();
+	CHECK(stream->ReadByte() == 1 && stream->ReadByte() == 0);
+	CHECK(stream->AtEnd() && stream->IsValid());
+
+	// Shutdown releases what the pass made and leaves the shaders, the texture and the state
+	backend.GetStream()->Clear();
+	pass.Shutdown();
+
+	stream->Rewind();
+
+	for (int i = 0; i < 3; i++) {
+		CHECK(stream->ReadByte() == HEADLESS_RELEASE);
+		stream->ReadUint();
+	}
+
+	CHECK(stream->AtEnd());
+	CHECK(backend.GetErrorCount() == 0);
+
+	backend.Shutdown();
+}
+
+static void TestFrame()
+{
+	HeadlessBackendClass			  backend;
+	SceneType						  scene;
+	SpritePassClass					  pass;
+	vector<SpritePassClass::InstanceType> instances;
+	SpritePassClass::MatrixBufferType matrices;
+	CommandStreamClass				 *stream = backend.GetStream();
+
+	CHECK(CreateScene(&backend, &scene));
+	CHECK(pass.Initialize(&backend, 24, MAX_INSTANCES, scene.vertexShader, scene.pixelShader, scene.texture, scene.state2D));
+
+	MakeInstances(&instances, 3, 1.0f);
+	MakeMatrices(&matrices, 100.0f);
+
+	pass.SetInstances(&instances[0], 3);
+	pass.SetMatrices(matrices);
+	CHECK(pass.GetInstanceCount() == 3);
+
+	stream->Clear();
+	backend.ResetCounters();
+
+	CHECK(pass.Render(&backend));
+	CHECK(backend.GetErrorCount() == 0 && backend.GetDrawCount() == 1 && backend.GetCommandCount() == 9);
+
+	// The uploads come first, then the bindings and the draw
+	unsigned int instanceBuffer, matrixBuffer;
+
+	stream->Rewind();
+
+	CHECK(stream->ReadByte() == HEADLESS_UPDATE_BUFFER);
+	instanceBuffer = stream->ReadUint();
+	CHECK(stream->ReadUint() == 3 * sizeof(SpritePassClass::InstanceType));
+	CHECK(memcmp(stream->ReadBytes(3 * sizeof(SpritePassClass::InstanceType)), &instances[0], 3 * sizeof(SpritePassClass::InstanceType)) == 0);
+
+	CHECK(stream->ReadByte() == HEADLESS_UPDATE_BUFFER);
+	matrixBuffer = stream->ReadUint();
+	CHECK(stream->ReadUint() == sizeof(matrices));
+	CHECK(memcmp(stream->ReadBytes(sizeof(matrices)), &matrices, sizeof(matrices)) == 0);
+
+	CHECK(stream->ReadByte() == HEADLESS_SET_RENDER_TARGET && stream->ReadUint() == 0);
+	CHECK(stream->ReadByte() == HEADLESS_SET_STATE && stream->ReadUint() == scene.state2D);
+	CHECK(stream->ReadByte() == HEADLESS_SET_SHADERS && stream->ReadUint() == scene.vertexShader && stream->ReadUint() == scene.pixelShader);
+
+	CHECK(stream->ReadByte() == HEADLESS_SET_VERTEX_BUFFERS && stream->ReadUint() == 0 && stream->ReadUint() == 2);
+	stream->ReadUint();
+	CHECK(stream->ReadUint() == 5 * sizeof(float) && stream->ReadUint() == 0);
+	CHECK(stream->ReadUint() == instanceBuffer && stream->ReadUint() == sizeof(SpritePassClass::InstanceType) && stream->ReadUint() == 0);
+
+	CHECK(stream->ReadByte() == HEADLESS_SET_CONSTANT_BUFFERS);
+	CHECK(stream->ReadUint() == RENDER_STAGE_VERTEX && stream->ReadUint() == 0 && stream->ReadUint() == 1 && stream->ReadUint() == matrixBuffer);
+
+	CHECK(stream->ReadByte() == HEADLESS_SET_TEXTURES);
+	CHECK(stream->ReadUint() == RENDER_STAGE_PIXEL && stream->ReadUint() == 0 && stream->ReadUint() == 1 && stream->ReadUint() == scene.texture);
+
+	CHECK(stream->ReadByte() == HEADLESS_DRAW_INSTANCED);
+	CHECK(stream->ReadUint() == 6 && stream->ReadUint() == 3 && stream->ReadUint() == 0 && stream->ReadUint() == 0);
+	CHECK(stream->AtEnd() && stream->IsValid());
+
+	// Without instances nothing is recorded
+	stream->Clear();
+	pass.SetInstances(&instances[0], 0);
+
+	CHECK(pass.Render(&backend));
+	CHECK(stream->GetSize() == 0);
+
+	// Past the most instances the rest is left out
+	MakeInstances(&instances, MAX_INSTANCES + 10, 2.0f);
+	pass.SetInstances(&instances[0], MAX_INSTANCES + 10);
+	CHECK(pass.GetInstanceCount() == MAX_INSTANCES);
+
+	stream->Clear();
+	backend.ResetCounters();
+
+	CHECK(pass.Render(&backend));
+	CHECK(backend.GetErrorCount() == 0 && backend.GetDrawCount() == 1);
+
+	stream->Rewind();
+	CHECK(stream->ReadByte() == HEADLESS_UPDATE_BUFFER && stream->ReadUint() == instanceBuffer);
+	CHECK(stream->ReadUint() == MAX_INSTANCES * sizeof(SpritePassClass::InstanceType));
+
+	pass.Shutdown();
+	backend.Shutdown();
+}
+
+// The frame of GraphicsClass through the backend around its sprites: the clear, the 2D state, the particles and the animated sprites,
+// the 3D state and the end of the frame. Two frames, the second with other instances.
+static bool RecordFrames(RenderBackendClass *backend)
+{
+	SceneType							  scene;
+	SpritePassClass						  particles, sprites;
+	vector<SpritePassClass::InstanceType> particleInstances, spriteInstances;
+	SpritePassClass::MatrixBufferType	  matrices;
+	float								  color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	bool								  result   = true;
+
+	if (!CreateScene(backend, &scene))
+		return false;
+
+	result = particles.Initialize(backend, 24, MAX_INSTANCES, scene.vertexShader, scene.pixelShader, scene.texture, scene.state2D) &&
+			 sprites.Initialize(backend, 24, MAX_INSTANCES, scene.vertexShader, scene.pixelShader, scene.texture, scene.state2D);
+
+	for (int frame = 0; frame < 2 && result; frame++) {
+		MakeInstances(&particleInstances, 10 + frame * 7, frame * 1000.0f);
+		MakeInstances(&spriteInstances, 20, frame * 1000.0f + 500.0f);
+		MakeMatrices(&matrices, frame * 10.0f);
+
+		backend->BeginFrame(color);
+		backend->SetState(scene.state2D);
+
+		particles.SetInstances(&particleInstances[0], (int)particleInstances.size());
+		particles.SetMatrices(matrices);
+		sprites.SetInstances(&spriteInstances[0], (int)spriteInstances.size());
+		sprites.SetMatrices(matrices);
+
+		result = particles.Render(backend) && sprites.Render(backend);
+
+		backend->SetState(scene.state3D);
+		backend->EndFrame();
+	}
+
+	sprites.Shutdown();
+	particles.Shutdown();
+
+	return result;
+}
+
+static void TestReplay()
+{
+	HeadlessBackendClass recorded, replayed;
+
+	CHECK(RecordFrames(&recorded));
+	CHECK(recorded.GetErrorCount() == 0 && recorded.GetDrawCount() == 4);
+
+	CHECK(HeadlessBackendClass::Replay(recorded.GetStream(), &replayed));
+	CHECK(replayed.GetErrorCount() == 0 && replayed.GetDrawCount() == 4);
+
+	CHECK(replayed.GetStream()->GetSize() == recorded.GetStream()->GetSize());
+	CHECK(memcmp(replayed.GetStream()->GetData(), recorded.GetStream()->GetData(), recorded.GetStream()->GetSize()) == 0);
+
+	// And recording it again gives the same stream
+	HeadlessBackendClass again;
+
+	CHECK(RecordFrames(&again));
+	CHECK(again.GetStream()->GetSize() == recorded.GetStream()->GetSize());
+	CHECK(memcmp(again.GetStream()->GetData(), recorded.GetStream()->GetData(), recorded.GetStream()->GetSize()) == 0);
+
+	recorded.Shutdown();
+	replayed.Shutdown();
+	again.Shutdown();
+}
+
+int main()
+{
+	TestCreation();
+	TestFrame();
+	TestReplay();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,402 @@
+// StateFilterClass in front of a counting fake context, which keeps what is bound and counts the calls that reach it:
+// the redundant calls are dropped, the array calls are cut to the slots that change, the calls outside the tracked slots
+// and the shaders with class instances always go through, and Invalidate makes the next calls go through.
+// Then a long random sequence of calls is made through the filter and straight to a second context:
+// after every call both contexts have the same state bound, and every call is either forwarded or counted as filtered.
+
+#include "__testCheck.h"
+#include "__stateFilterClass.h"
+
+#include <string.h>
+
+#define SLOTS 16		// the slots of the fake context, more than the filter tracks
+
+struct ObjectType {
+	int id;
+};
+
+// What a context has bound
+struct BoundType {
+	const void	*inputLayout;
+	int			 topology;
+	const void	*vertexBuffers[SLOTS];
+	unsigned int strides[SLOTS], offsets[SLOTS];
+	const void	*indexBuffer;
+	int			 indexFormat;
+	unsigned int indexOffset;
+	const void	*vertexShader, *pixelShader;
+	const void	*vsConstantBuffers[SLOTS], *psConstantBuffers[SLOTS];
+	const void	*vsResources[SLOTS], *psResources[SLOTS];
+	const void	*vsSamplers[SLOTS], *psSamplers[SLOTS];
+	const void	*blendState;
+	float		 blendFactor[4];
+	unsigned int blendMask;
+	const void	*depthState;
+	unsigned int stencilRef;
+	const void	*rasterState;
+};
+
+class CountingContextClass {
+ public:
+	CountingContextClass()
+	{
+		memset(&bound, 0, sizeof(bound));
+
+		calls	  = 0;
+		lastStart = 0;
+		lastCount = 0;
+	}
+
+	void IASetInputLayout(ObjectType *layout)
+	{
+		calls++;
+		bound.inputLayout = layout;
+	}
+
+	void IASetPrimitiveTopology(int topology)
+	{
+		calls++;
+		bound.topology = topology;
+	}
+
+	void IASetVertexBuffers(unsigned int start, unsigned int count, ObjectType *const *buffers, const unsigned int *strides, const unsigned int *offsets)
+	{
+		Range(start, count);
+
+		for (unsigned int i = 0; i < count; i++) {
+			bound.vertexBuffers[start + i] = buffers[i];
+			bound.strides[start + i]	   = strides[i];
+			bound.offsets[start + i]	   = offsets[i];
+		}
+	}
+
+	void IASetIndexBuffer(ObjectType *buffer, int format, unsigned int offset)
+	{
+		calls++;
+		bound.indexBuffer = buffer;
+		bound.indexFormat = format;
+		bound.indexOffset = offset;
+	}
+
+	void VSSetShader(ObjectType *shader, ObjectType *const *, unsigned int)
+	{
+		calls++;
+		bound.vertexShader = shader;
+	}
+
+	void PSSetShader(ObjectType *shader, ObjectType *const *, unsigned int)
+	{
+		calls++;
+		bound.pixelShader = shader;
+	}
+
+	void VSSetConstantBuffers(unsigned int start, unsigned int count, ObjectType *const *objects)	{ Set(bound.vsConstantBuffers, start, count, objects); }
+	void PSSetConstantBuffers(unsigned int start, unsigned int count, ObjectType *const *objects)	{ Set(bound.psConstantBuffers, start, count, objects); }
+	void VSSetShaderResources(unsigned int start, unsigned int count, ObjectType *const *objects)	{ Set(bound.vsResources, start, count, objects); }
+	void PSSetShaderResources(unsigned int start, unsigned int count, ObjectType *const *objects)	{ Set(bound.psResources, start, count, objects); }
+	void VSSetSamplers(unsigned int start, unsigned int count, ObjectType *const *objects)			{ Set(bound.vsSamplers, start, count, objects); }
+	void PSSetSamplers(unsigned int start, unsigned int count, ObjectType *const *objects)			{ Set(bound.psSamplers, start, count, objects); }
+
+	// Like D3D11, a null blend factor is 1, 1, 1, 1
+	void OMSetBlendState(ObjectType *state, const float *factor, unsigned int mask)
+	{
+		calls++;
+		bound.blendState = state;
+		bound.blendMask	 = mask;
+
+		for (int i = 0; i < 4; i++)
+			bound.blendFactor[i] = factor ? factor[i] : 1.0f;
+	}
+
+	void OMSetDepthStencilState(ObjectType *state, unsigned int stencilRef)
+	{
+		calls++;
+		bound.depthState = state;
+		bound.stencilRef = stencilRef;
+	}
+
+	void RSSetState(ObjectType *state)
+	{
+		calls++;
+		bound.rasterState = state;
+	}
+
+ private:
+	void Range(unsigned int start, unsigned int count)
+	{
+		calls++;
+		lastStart = start;
+		lastCount = count;
+	}
+
+	void Set(const void **slots, unsigned int start, unsigned int count, ObjectType *const *objects)
+	{
+		Range(start, count);
+
+		for (unsigned int i = 0; i < count; i++)
+			slots[start + i] = objects[i];
+	}
+
+ public:
+	BoundType	 bound;
+	int			 calls;
+	unsigned int lastStart, lastCount;		// the slots of the last array call
+};
+
+typedef StateFilterClass<CountingContextClass> FilterType;
+
+static void TestSingleSlots()
+{
+	CountingContextClass context;
+	FilterType			 filter;
+	ObjectType			 a, b;
+
+	filter.SetContext(&context);
+
+	// The first call goes through whatever it sets, even null, the next identical ones are dropped
+	filter.VSSetShader((ObjectType*)0, (ObjectType**)0, 0);
+	filter.VSSetShader((ObjectType*)0, (ObjectType**)0, 0);
+	filter.VSSetShader(&a, (ObjectType**)0, 0);
+	filter.VSSetShader(&a, (ObjectType**)0, 0);
+	filter.VSSetShader(&b, (ObjectType**)0, 0);
+
+	CHECK(context.calls == 3 && context.bound.vertexShader == &b);
+	CHECK(filter.GetForwardedCount() == 3 && filter.GetFilteredCount() == 2);
+
+	// A shader with class instances always goes through, and so does the next one
+	ObjectType *instances[1] = { &a };
+
+	filter.PSSetShader(&a, instances, 1);
+	filter.PSSetShader(&a, instances, 1);
+	filter.PSSetShader(&a, (ObjectType**)0, 0);
+	filter.PSSetShader(&a, (ObjectType**)0, 0);
+
+	CHECK(context.calls == 6);
+
+	filter.IASetPrimitiveTopology(4);
+	filter.IASetPrimitiveTopology(4);
+	filter.IASetInputLayout(&a);
+	filter.IASetInputLayout(&a);
+	filter.RSSetState(&b);
+	filter.RSSetState(&b);
+
+	CHECK(context.calls == 9);
+
+	// The index buffer is the buffer, its format and its offset
+	filter.IASetIndexBuffer(&a, 42, 0);
+	filter.IASetIndexBuffer(&a, 42, 0);
+	filter.IASetIndexBuffer(&a, 57, 0);
+	filter.IASetIndexBuffer(&a, 57, 16);
+
+	CHECK(context.calls == 12);
+
+	// The blend state with its factor and mask, a null factor being 1
+	float ones[4] = { 1.0f, 1.0f, 1.0f, 1.0f }, half[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+
+	filter.OMSetBlendState(&a, (const float*)0, 0xFFFFFFFF);
+	filter.OMSetBlendState(&a, ones, 0xFFFFFFFF);
+	filter.OMSetBlendState(&a, half, 0xFFFFFFFF);
+	filter.OMSetBlendState(&a, half, 0x0000FFFF);
+
+	filter.OMSetDepthStencilState(&b, 1);
+	filter.OMSetDepthStencilState(&b, 1);
+	filter.OMSetDepthStencilState(&b, 2);
+
+	CHECK(context.calls == 17);
+	CHECK(filter.GetForwardedCount() == context.calls);
+
+	// Invalidate lets the next calls through
+	filter.Invalidate();
+	filter.VSSetShader(&b, (ObjectType**)0, 0);
+	filter.RSSetState(&b);
+
+	CHECK(context.calls == 19);
+
+	filter.ResetCounters();
+	CHECK(filter.GetForwardedCount() == 0 && filter.GetFilteredCount() == 0);
+}
+
+static void TestArrays()
+{
+	CountingContextClass context;
+	FilterType			 filter;
+	ObjectType			 a, b, c;
+
+	filter.SetContext(&context);
+
+	ObjectType *three[3] = { &a, &b, &c };
+	ObjectType *middle[3] = { &a, &c, &c };
+
+	filter.PSSetShaderResources(0, 3, three);
+	CHECK(context.calls == 1 && context.lastStart == 0 && context.lastCount == 3);
+
+	filter.PSSetShaderResources(0, 3, three);
+	CHECK(context.calls == 1);
+
+	// Only the slot that changes goes through
+	filter.PSSetShaderResources(0, 3, middle);
+	CHECK(context.calls == 2 && context.lastStart == 1 && context.lastCount == 1);
+	CHECK(context.bound.psResources[0] == &a && context.bound.psResources[1] == &c && context.bound.psResources[2] == &c);
+
+	// The other stage has its own slots
+	filter.VSSetShaderResources(0, 3, middle);
+	CHECK(context.calls == 3 && context.lastCount == 3);
+
+	// The slots past the tracked ones always go through, and make the tracked ones they touched unknown
+	ObjectType *one[1] = { &a };
+
+	filter.PSSetConstantBuffers(STATE_FILTER_CONSTANT_BUFFERS, 1, one);
+	filter.PSSetConstantBuffers(STATE_FILTER_CONSTANT_BUFFERS, 1, one);
+	CHECK(context.calls == 5);
+
+	filter.PSSetConstantBuffers(STATE_FILTER_CONSTANT_BUFFERS - 1, 2, three);
+	filter.PSSetConstantBuffers(STATE_FILTER_CONSTANT_BUFFERS - 1, 1, three);
+	CHECK(context.calls == 7);
+
+	// Vertex buffers are the buffer, its stride and its offset
+	unsigned int strides[2] = { 20, 32 }, offsets[2] = { 0, 0 }, otherStrides[2] = { 20, 48 };
+
+	filter.IASetVertexBuffers(0, 2, three, strides, offsets);
+	filter.IASetVertexBuffers(0, 2, three, strides, offsets);
+	CHECK(context.calls == 8);
+
+	filter.IASetVertexBuffers(0, 2, three, otherStrides, offsets);
+	CHECK(context.calls == 9 && context.lastStart == 1 && context.lastCount == 1 && context.bound.strides[1] == 48);
+
+	// After a render target unbinds the views behind the filter's back, InvalidateResources lets them through again
+	filter.InvalidateResources();
+	filter.PSSetShaderResources(0, 3, middle);
+	CHECK(context.calls == 10 && context.lastCount == 3);
+
+	filter.PSSetSamplers(0, 1, one);
+	filter.PSSetSamplers(0, 1, one);
+	filter.VSSetSamplers(0, 1, one);
+	CHECK(context.calls == 12);
+
+	CHECK(filter.GetForwardedCount() == context.calls);
+}
+
+// The draws of the shader classes: every draw sets all its state, the filter lets through what changes between materials
+static void TestDrawSequence()
+{
+	CountingContextClass context;
+	FilterType			 filter;
+	ObjectType			 shaders[2], layouts[2], textures[3], buffers[2], sampler;
+	unsigned int		 stride = 32, offset = 0;
+	int					 calls	= 0;
+
+	filter.SetContext(&context);
+
+	// 3 materials, 100 draws each, sorted by material
+	for (int material = 0; material < 3; material++)
+		for (int draw = 0; draw < 100; draw++) {
+			ObjectType *vertexBuffer[1] = { &buffers[draw % 2] };
+			ObjectType *constants[1]	= { &buffers[0] };
+			ObjectType *texture[1]		= { &textures[material] };
+			ObjectType *samplers[1]		= { &sampler };
+
+			filter.IASetVertexBuffers(0, 1, vertexBuffer, &stride, &offset);
+			filter.IASetPrimitiveTopology(4);
+			filter.IASetInputLayout(&layouts[material % 2]);
+			filter.VSSetShader(&shaders[material % 2], (ObjectType**)0, 0);
+			filter.PSSetShader(&shaders[material % 2], (ObjectType**)0, 0);
+			filter.VSSetConstantBuffers(0, 1, constants);
+			filter.PSSetShaderResources(0, 1, texture);
+			filter.PSSetSamplers(0, 1, samplers);
+			calls += 8;
+		}
+
+	// The vertex buffer changes every draw, the material three times, the rest once
+	CHECK(filter.GetForwardedCount() + filter.GetFilteredCount() == calls);
+	CHECK(context.calls == filter.GetForwardedCount());
+	CHECK(context.calls == 300 + 3 * 4 + 3);
+}
+
+static void TestRandomSequence()
+{
+	CountingContextClass filtered, direct;
+	FilterType			 filter;
+	ObjectType			 pool[3];
+	unsigned int		 seed = 2024, calls = 0;
+	bool				 same = true;
+
+	filter.SetContext(&filtered);
+
+	for (int step = 0; step < 50000 && same; step++) {
+		ObjectType	*objects[4];
+		unsigned int strides[4], offsets[4];
+		float		 factor[4];
+		unsigned int start, count, kind, value;
+
+		seed = seed * 1103515245 + 12345;
+		kind = (seed >> 16) % 17;
+
+		seed  = seed * 1103515245 + 12345;
+		start = (seed >> 16) % 6;
+		count = 1 + (seed >> 20) % 4;
+		value = (seed >> 24) % 3;
+
+		for (int i = 0; i < 4; i++) {
+			seed = seed * 1103515245 + 12345;
+
+			objects[i] = (seed >> 16) % 4 == 3 ? 0 : &pool[(seed >> 18) % 3];
+			strides[i] = 16 + 16 * ((seed >> 20) % 2);
+			offsets[i] = 0;
+			factor[i]  = (seed >> 21) % 2 ? 1.0f : 0.5f;
+		}
+
+		calls++;
+
+		switch (kind) {
+			case 0:	 filter.IASetInputLayout(objects[0]);				direct.IASetInputLayout(objects[0]);			   break;
+			case 1:	 filter.IASetPrimitiveTopology((int)value);			direct.IASetPrimitiveTopology((int)value);		   break;
+			case 2:	 filter.IASetVertexBuffers(start, count, objects, strides, offsets);
+					 direct.IASetVertexBuffers(start, count, objects, strides, offsets);								   break;
+			case 3:	 filter.IASetIndexBuffer(objects[0], (int)value, 0);  direct.IASetIndexBuffer(objects[0], (int)value, 0);  break;
+			case 4:	 filter.VSSetShader(objects[0], (ObjectType**)0, 0); direct.VSSetShader(objects[0], (ObjectType**)0, 0); break;
+			case 5:	 filter.PSSetShader(objects[0], (ObjectType**)0, 0); direct.PSSetShader(objects[0], (ObjectType**)0, 0); break;
+			case 6:	 filter.VSSetConstantBuffers(start, count, objects);  direct.VSSetConstantBuffers(start, count, objects);  break;
+			case 7:	 filter.PSSetConstantBuffers(start, count, objects);  direct.PSSetConstantBuffers(start, count, objects);  break;
+			case 8:	 filter.VSSetShaderResources(start, count, objects);  direct.VSSetShaderResources(start, count, objects);  break;
+			case 9:	 filter.PSSetShaderResources(start, count, objects);  direct.PSSetShaderResources(start, count, objects);  break;
+			case 10: filter.VSSetSamplers(start, count, objects);		  direct.VSSetSamplers(start, count, objects);		   break;
+			case 11: filter.PSSetSamplers(start, count, objects);		  direct.PSSetSamplers(start, count, objects);		   break;
+			case 12: filter.OMSetBlendState(objects[0], value ? factor : (const float*)0, value);
+					 direct.OMSetBlendState(objects[0], value ? factor : (const float*)0, value);						   break;
+			case 13: filter.OMSetDepthStencilState(objects[0], value);	  direct.OMSetDepthStencilState(objects[0], value);	   break;
+			case 14: filter.RSSetState(objects[0]);						  direct.RSSetState(objects[0]);					   break;
+
+			// A render target binding unbinds the views in both contexts, behind the filter
+			case 15:
+				memset(filtered.bound.psResources, 0, sizeof(filtered.bound.psResources));
+				memset(direct.bound.psResources, 0, sizeof(direct.bound.psResources));
+				filter.InvalidateResources();
+				calls--;
+				break;
+
+			default:
+				filter.Invalidate();
+				calls--;
+				break;
+		}
+
+		same = memcmp(&filtered.bound, &direct.bound, sizeof(BoundType)) == 0;
+	}
+
+	CHECK(same);
+	CHECK(filter.GetForwardedCount() == filtered.calls);
+	CHECK(filter.GetForwardedCount() + filter.GetFilteredCount() == (int)calls);
+	CHECK(filtered.calls < direct.calls);
+
+	printf("random sequence: %d calls, %d forwarded, %d filtered\n", direct.calls, filter.GetForwardedCount(), filter.GetFilteredCount());
+}
+
+int main()
+{
+	TestSingleSlots();
+	TestArrays();
+	TestDrawSequence();
+	TestRandomSequence();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,242 @@
+// TextBatchClass with the metrics of an ASCII font like the one of FontClass: the instances of a sentence and of a patched sentence,
+// the batch of all the sentences in one array, and the uploads it counts for unchanged, recolored and changed sentences.
+
+#include "__testCheck.h"
+#include "__textBatchClass.h"
+
+#include <string.h>
+#include <vector>
+using namespace std;
+
+#define SCREEN_WIDTH  800
+#define SCREEN_HEIGHT 600
+#define WHITE		  0xFFFFFFFF
+#define GREEN		  0xFF00FF00
+
+// The letters are 5 + (letter % 4) pixels wide and followed by one pixel, the space is 3 pixels, as FontClass::BuildMetrics makes them
+static void FillMetrics(FontMetricsClass *metrics)
+{
+	FontMetricsClass::GlyphMetricsType glyph;
+
+	for (int letter = 0; letter < 95; letter++) {
+		glyph.left	  = 0.0f;
+		glyph.top	  = 0.0f;
+		glyph.width	  = 5.0f + letter % 4;
+		glyph.height  = 16.0f;
+		glyph.visible = letter != 0;
+		glyph.advance = letter == 0 ? 3.0f : glyph.width + 1.0f;
+
+		metrics->AddGlyph(letter + 32, glyph);
+	}
+
+	metrics->SetLineMetrics(16.0f, 18.0f);
+	metrics->SetFallback('?');
+}
+
+static float Advance(char c)
+{
+	return c == ' ' ? 3.0f : 6.0f + (c - 32) % 4;
+}
+
+static vector<GlyphTableClass::InstanceType> Write(TextBatchClass &batch)
+{
+	vector<GlyphTableClass::InstanceType> instances(64);
+
+	instances.resize(batch.WriteInstances(&instances[0]));
+
+	return instances;
+}
+
+static void TestSentence()
+{
+	FontMetricsClass metrics;
+	TextBatchClass	 batch;
+
+	FillMetrics(&metrics);
+	CHECK(batch.Initialize(&metrics, SCREEN_WIDTH, SCREEN_HEIGHT, 64));
+
+	int sentence = batch.AddSentence(16);
+
+	// The pen starts at the top left of the text in the coordinates of the FontClass vertices: the origin in the middle, y going up.
+	// The space and the characters the font doesn't have make no instance; the newline and the UTF-8 bytes don't move the pen either
+	CHECK(batch.UpdateSentence(sentence, "Ab c\n\xC3\xA9!", 20, 30, WHITE));
+
+	vector<GlyphTableClass::InstanceType> instances = Write(batch);
+
+	const char *letters = "Abc!";
+	float		x		= -400.0f + 20.0f;
+
+	CHECK(instances.size() == 4);
+
+	for (int i = 0; i < 4 && i < (int)instances.size(); i++) {
+		CHECK(instances[i].glyph == (unsigned int)(letters[i] - 32));
+		CHECK(instances[i].x == x);
+		CHECK(instances[i].y == 300.0f - 30.0f);
+		CHECK(instances[i].color == WHITE);
+
+		x += Advance(letters[i]);
+
+		if (i == 1)
+			x += Advance(' ');
+	}
+
+	// A sentence patched from its first changed letter is the same as one built from scratch
+	int fresh = batch.AddSentence(16);
+
+	batch.UpdateSentence(sentence, "Fps: 59", 20, 20, WHITE);
+	batch.UpdateSentence(sentence, "Fps: 6000", 20, 20, WHITE);
+	batch.UpdateSentence(fresh, "Fps: 6000", 20, 20, WHITE);
+
+	instances = Write(batch);
+
+	CHECK(instances.size() == 16);
+	CHECK(memcmp(&instances[0], &instances[8], sizeof(GlyphTableClass::InstanceType) * 8) == 0);
+
+	// And shorter again
+	batch.UpdateSentence(sentence, "Fps: 6", 20, 20, WHITE);
+	CHECK(Write(batch).size() == 5 + 8);
+
+	// Too long, or not a sentence
+	CHECK(!batch.UpdateSentence(sentence, "0123456789abcdefg", 20, 20, WHITE));
+	CHECK(!batch.UpdateSentence(7, "x", 20, 20, WHITE));
+
+	batch.Shutdown();
+}
+
+// All the sentences in the order they were added, without the removed ones, and no more than the batch holds
+static void TestBatch()
+{
+	FontMetricsClass metrics;
+	TextBatchClass	 batch;
+
+	FillMetrics(&metrics);
+	CHECK(batch.Initialize(&metrics, SCREEN_WIDTH, SCREEN_HEIGHT, 10));
+
+	int a = batch.AddSentence(8);
+	int b = batch.AddSentence(8);
+	int c = batch.AddSentence(8);
+
+	batch.UpdateSentence(a, "aaa", 0, 0, WHITE);
+	batch.UpdateSentence(b, "bbbb", 0, 20, GREEN);
+	batch.UpdateSentence(c, "   ", 0, 40, WHITE);
+
+	CHECK(batch.IsDirty());
+
+	vector<GlyphTableClass::InstanceType> instances(10);
+
+	CHECK(batch.WriteInstances(&instances[0]) == 7);
+	CHECK(!batch.IsDirty());
+	CHECK(instances[2].glyph == 'a' - 32 && instances[3].glyph == 'b' - 32);
+	CHECK(instances[3].color == GREEN);
+
+	// The letters past the end of the batch are left out
+	batch.UpdateSentence(c, "cccccc", 0, 40, WHITE);
+	CHECK(batch.WriteInstances(&instances[0]) == 10);
+	CHECK(instances[9].glyph == 'c' - 32);
+
+	batch.RemoveSentence(b);
+	CHECK(batch.IsDirty());
+	CHECK(batch.WriteInstances(&instances[0]) == 9);
+	CHECK(!batch.UpdateSentence(b, "b", 0, 0, WHITE));
+
+	// Removing a sentence without letters changes nothing
+	int d = batch.AddSentence(4);
+	batch.UpdateSentence(d, " ", 0, 0, WHITE);
+	batch.WriteInstances(&instances[0]);
+	batch.RemoveSentence(d);
+	CHECK(!batch.IsDirty());
+
+	batch.Shutdown();
+}
+
+// The frames of TextOutClass: set the sentences, then Render writes the batch when it is dirty and skips the upload otherwise.
+// Only an update that changes nothing is an avoided upload, a new color has to be uploaded.
+static void TestUploads()
+{
+	FontMetricsClass metrics;
+	TextBatchClass	 batch;
+	vector<GlyphTableClass::InstanceType> instances(64);
+
+	FillMetrics(&metrics);
+	CHECK(batch.Initialize(&metrics, SCREEN_WIDTH, SCREEN_HEIGHT, 64));
+
+	int fps = batch.AddSentence(16);
+	const unsigned int *version = batch.GetVersionCounter();
+	unsigned int		seen	= *version;
+
+	batch.UpdateSentence(fps, "Fps: 60", 20, 20, GREEN);
+	batch.WriteInstances(&instances[0]);
+
+	// The same text in a new color
+	batch.ResetCounters();
+	CHECK(batch.UpdateSentence(fps, "Fps: 60", 20, 20, WHITE));
+	CHECK(batch.GetUploadsAvoided() == 0);
+	CHECK(batch.IsDirty());
+	CHECK(*version != seen);
+
+	CHECK(batch.WriteInstances(&instances[0]) == 6);
+	CHECK(instances[0].color == WHITE && instances[5].color == WHITE);
+	CHECK(batch.GetUploadCount() == 1);
+
+	// Nothing changed: the update and the Render are both avoided
+	seen = *version;
+
+	batch.ResetCounters();
+	CHECK(batch.UpdateSentence(fps, "Fps: 60", 20, 20, WHITE));
+	CHECK(!batch.IsDirty());
+	batch.SkipUpload();
+
+	CHECK(batch.GetUploadsAvoided() == 2);
+	CHECK(batch.GetUploadCount() == 0);
+	CHECK(*version == seen);
+
+	batch.Shutdown();
+}
+
+static void TestParagraph()
+{
+	FontMetricsClass metrics;
+	TextBatchClass	 batch;
+	vector<GlyphTableClass::InstanceType> instances(64);
+
+	FillMetrics(&metrics);
+	CHECK(batch.Initialize(&metrics, SCREEN_WIDTH, SCREEN_HEIGHT, 64));
+
+	int paragraph = batch.AddSentence(64);
+
+	// Wrapped into two lines, the second one 18 pixels lower
+	CHECK(batch.SetParagraph(paragraph, "one two", 100, 50, 30.0f, TEXT_ALIGN_LEFT, WHITE));
+
+	int count = batch.WriteInstances(&instances[0]);
+
+	CHECK(count == 6);
+	CHECK(instances[0].x == -300.0f && instances[0].y == 250.0f);
+	CHECK(instances[3].x == -300.0f && instances[3].y == 250.0f - 18.0f);
+
+	// A new color only recolors
+	batch.ResetCounters();
+	CHECK(batch.SetParagraph(paragraph, "one two", 100, 50, 30.0f, TEXT_ALIGN_LEFT, GREEN));
+	CHECK(batch.GetUploadsAvoided() == 0);
+	CHECK(batch.WriteInstances(&instances[0]) == 6 && instances[5].color == GREEN);
+
+	CHECK(batch.SetParagraph(paragraph, "one two", 100, 50, 30.0f, TEXT_ALIGN_LEFT, GREEN));
+	CHECK(batch.GetUploadsAvoided() == 1);
+
+	// The glyphs past the length of the sentence are left out
+	int small = batch.AddSentence(4);
+	CHECK(batch.SetParagraph(small, "ab cd", 0, 0, 0.0f, TEXT_ALIGN_LEFT, WHITE) == false);
+	CHECK(batch.SetParagraph(small, "ab c", 0, 0, 0.0f, TEXT_ALIGN_LEFT, WHITE));
+	CHECK(batch.WriteInstances(&instances[0]) == 6 + 3);
+
+	batch.Shutdown();
+}
+
+int main()
+{
+	TestSentence();
+	TestBatch();
+	TestUploads();
+	TestParagraph();
+
+	return TEST_RESULT();
+}
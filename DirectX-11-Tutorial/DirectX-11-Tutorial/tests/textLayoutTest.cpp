@@ -0,0 +1,264 @@
+// TextLayoutClass with a font of 10 pixel letters and 5 pixel spaces and one kerning pair: the pen positions and kerning,
+// the line breaks, the word wrapping and the cut of the words longer than a line, the alignment, the clipping,
+// Measure giving the same size as Layout, and the cache.
+
+#include "__testCheck.h"
+#include "__textLayoutClass.h"
+
+#define LINE_HEIGHT 14.0f
+
+typedef TextLayoutClass::LayoutType LayoutType;
+
+// The letters of "abcdefgh", 'A', 'V' and the euro sign, '?' for the rest; A followed by V is 2 pixels closer
+static void FillMetrics(FontMetricsClass *metrics)
+{
+	FontMetricsClass::GlyphMetricsType glyph;
+	const char *letters = "abcdefghAV?";
+
+	metrics->Clear();
+
+	glyph.advance = 5.0f;
+	glyph.left	  = 0.0f;
+	glyph.top	  = 0.0f;
+	glyph.width	  = 0.0f;
+	glyph.height  = 0.0f;
+	glyph.visible = false;
+
+	metrics->AddGlyph(' ', glyph);
+
+	glyph.advance = 10.0f;
+	glyph.left	  = 1.0f;
+	glyph.width	  = 8.0f;
+	glyph.height  = 12.0f;
+	glyph.visible = true;
+
+	for (const char *c = letters; *c; c++)
+		metrics->AddGlyph(*c, glyph);
+
+	metrics->AddGlyph(0x20AC, glyph);
+	metrics->AddKerningPair('A', 'V', -2.0f);
+	metrics->SetLineMetrics(12.0f, LINE_HEIGHT);
+	metrics->SetFallback('?');
+}
+
+static LayoutType Lay(const FontMetricsClass &metrics, const char *text, float maxWidth, int align)
+{
+	TextLayoutClass						layout;
+	TextLayoutClass::LayoutParamsType	params = TextLayoutClass::DefaultParams();
+	LayoutType							result;
+
+	params.maxWidth = maxWidth;
+	params.align	= align;
+
+	layout.LayoutUncached(&metrics, text, params, &result);
+
+	return result;
+}
+
+static void TestLine()
+{
+	FontMetricsClass metrics;
+	FillMetrics(&metrics);
+
+	// The kerning moves the V, and everything after it
+	LayoutType layout = Lay(metrics, "AVA b", 0.0f, TEXT_ALIGN_LEFT);
+
+	CHECK(layout.glyphs.size() == 4);
+	CHECK(layout.glyphs[0].x == 0.0f && layout.glyphs[1].x == 8.0f && layout.glyphs[2].x == 18.0f && layout.glyphs[3].x == 33.0f);
+	CHECK(layout.glyphs[1].glyph == metrics.FindGlyph('V'));
+	CHECK(layout.width == 43.0f && layout.height == LINE_HEIGHT);
+	CHECK(layout.lines.size() == 1 && layout.lines[0].glyphCount == 4);
+
+	// The characters the font doesn't have are drawn with the fallback, UTF-8 is decoded
+	layout = Lay(metrics, "a\xE2\x82\xACz", 0.0f, TEXT_ALIGN_LEFT);
+
+	CHECK(layout.glyphs.size() == 3);
+	CHECK(layout.glyphs[1].glyph == metrics.FindGlyph(0x20AC) && layout.glyphs[1].x == 10.0f);
+	CHECK(layout.glyphs[2].glyph == metrics.FindGlyph('?'));
+
+	layout = Lay(metrics, "", 0.0f, TEXT_ALIGN_LEFT);
+	CHECK(layout.glyphs.empty() && layout.lines.empty() && layout.width == 0.0f && layout.height == 0.0f);
+}
+
+static void TestLineBreaks()
+{
+	FontMetricsClass metrics;
+	FillMetrics(&metrics);
+
+	LayoutType layout = Lay(metrics, "ab\ncde", 0.0f, TEXT_ALIGN_LEFT);
+
+	CHECK(layout.lines.size() == 2);
+	CHECK(layout.glyphs.size() == 5);
+	CHECK(layout.glyphs[2].x == 0.0f && layout.glyphs[2].y == LINE_HEIGHT);
+	CHECK(layout.width == 30.0f && layout.height == 2 * LINE_HEIGHT);
+
+	// A text ending with a line break has an empty last line
+	layout = Lay(metrics, "ab\n", 0.0f, TEXT_ALIGN_LEFT);
+
+	CHECK(layout.lines.size() == 2 && layout.lines[1].glyphCount == 0);
+	CHECK(layout.height == 2 * LINE_HEIGHT);
+}
+
+static void TestWrap()
+{
+	FontMetricsClass metrics;
+	FillMetrics(&metrics);
+
+	// "aaa bbb" is 65 pixels and fits in 70, the line width leaves the space out
+	LayoutType layout = Lay(metrics, "aaa bbb ccc", 70.0f, TEXT_ALIGN_LEFT);
+
+	CHECK(layout.lines.size() == 2);
+	CHECK(layout.lines.size() == 2 && layout.lines[0].width == 65.0f && layout.lines[1].width == 30.0f);
+	CHECK(layout.lines.size() == 2 && layout.lines[1].glyphCount == 3);
+	CHECK(layout.glyphs[6].x == 0.0f && layout.glyphs[6].y == LINE_HEIGHT);
+
+	// One word a line, and the width of the text is the widest line
+	layout = Lay(metrics, "aaa bbb ccc", 60.0f, TEXT_ALIGN_LEFT);
+
+	CHECK(layout.lines.size() == 3);
+	CHECK(layout.width == 30.0f && layout.height == 3 * LINE_HEIGHT);
+
+	// A word longer than the line is cut where it overflows
+	layout = Lay(metrics, "abcdefgh", 35.0f, TEXT_ALIGN_LEFT);
+
+	CHECK(layout.lines.size() == 3);
+	CHECK(layout.lines.size() == 3 && layout.lines[0].glyphCount == 3 && layout.lines[1].glyphCount == 3 && layout.lines[2].glyphCount == 2);
+	CHECK(layout.glyphs[3].x == 0.0f && layout.glyphs[3].glyph == metrics.FindGlyph('d'));
+
+	// Every glyph stays inside the wrapping width
+	layout = Lay(metrics, "ab cdef gh a bcd efgh abc de fgh", 47.0f, TEXT_ALIGN_LEFT);
+
+	bool inside = true;
+
+	for (size_t i = 0; i < layout.glyphs.size(); i++)
+		inside = inside && layout.glyphs[i].x + 10.0f <= 47.0f;
+
+	CHECK(inside);
+	CHECK(layout.glyphs.size() == 24);
+}
+
+static void TestAlign()
+{
+	FontMetricsClass metrics;
+	FillMetrics(&metrics);
+
+	LayoutType layout = Lay(metrics, "ab\nabcd", 100.0f, TEXT_ALIGN_RIGHT);
+
+	CHECK(layout.lines[0].x == 80.0f && layout.glyphs[0].x == 80.0f);
+	CHECK(layout.lines[1].x == 60.0f && layout.glyphs[2].x == 60.0f);
+
+	layout = Lay(metrics, "ab\nabcd", 100.0f, TEXT_ALIGN_CENTER);
+
+	CHECK(layout.lines[0].x == 40.0f && layout.lines[1].x == 30.0f);
+
+	// Without wrapping the lines are centered on the widest one
+	layout = Lay(metrics, "ab\nabcd", 0.0f, TEXT_ALIGN_CENTER);
+
+	CHECK(layout.lines[0].x == 10.0f && layout.lines[1].x == 0.0f);
+}
+
+static void TestClip()
+{
+	FontMetricsClass metrics;
+	TextLayoutClass	 layout;
+	LayoutType		 result;
+
+	FillMetrics(&metrics);
+
+	// The box of a glyph is 1 to 9 pixels right of its pen and 12 pixels high: the clip keeps what it touches
+	TextLayoutClass::LayoutParamsType params = TextLayoutClass::DefaultParams();
+
+	params.clip		  = true;
+	params.clipLeft	  = 15.0f;
+	params.clipTop	  = 0.0f;
+	params.clipRight  = 35.0f;
+	params.clipBottom = 14.0f;
+
+	layout.LayoutUncached(&metrics, "abcde\nabcde", params, &result);
+
+	CHECK(result.glyphs.size() == 3);
+	CHECK(result.clippedCount == 7);
+	CHECK(result.glyphs[0].x == 10.0f && result.glyphs[2].x == 30.0f);
+	CHECK(result.lines[0].glyphCount == 3 && result.lines[1].glyphCount == 0);
+
+	// The size is the size of the text, not of what is left of it
+	CHECK(result.width == 50.0f && result.height == 2 * LINE_HEIGHT);
+}
+
+// Measure wraps the same way as Layout
+static void TestMeasure()
+{
+	FontMetricsClass metrics;
+	TextLayoutClass	 layout;
+	const char		*texts[]  = { "", "a", "AVA b", "aaa bbb ccc", "abcdefgh", "ab\ncd  ef\n\ngh", "a b c d e f g h" };
+	float			 widths[] = { 0.0f, 25.0f, 47.0f, 70.0f };
+
+	FillMetrics(&metrics);
+
+	for (int t = 0; t < 7; t++)
+		for (int w = 0; w < 4; w++) {
+			TextLayoutClass::LayoutParamsType params = TextLayoutClass::DefaultParams();
+			LayoutType result;
+			float	   width, height;
+
+			params.maxWidth = widths[w];
+
+			layout.LayoutUncached(&metrics, texts[t], params, &result);
+			layout.Measure(&metrics, texts[t], params, &width, &height);
+
+			CHECK(width == result.width && height == result.height);
+			CHECK(height == result.lines.size() * LINE_HEIGHT);
+		}
+}
+
+static void TestCache()
+{
+	FontMetricsClass metrics;
+	TextLayoutClass	 layout;
+
+	FillMetrics(&metrics);
+	CHECK(layout.Initialize(2));
+
+	TextLayoutClass::LayoutParamsType params = TextLayoutClass::DefaultParams();
+
+	const LayoutType *first = layout.Layout(&metrics, "abc", params);
+
+	CHECK(first->glyphs.size() == 3);
+	CHECK(layout.Layout(&metrics, "abc", params) == first);
+	CHECK(layout.GetCacheHits() == 1 && layout.GetCacheMisses() == 1);
+
+	// Other parameters, another text, or a changed font are laid out again
+	params.maxWidth = 15.0f;
+	CHECK(layout.Layout(&metrics, "abc", params)->lines.size() == 3);
+
+	params.maxWidth = 0.0f;
+	layout.Layout(&metrics, "abd", params);
+
+	FillMetrics(&metrics);
+	layout.Layout(&metrics, "abc", params);
+
+	CHECK(layout.GetCacheHits() == 1 && layout.GetCacheMisses() == 4);
+
+	// The clipping rectangle doesn't matter when not clipping
+	params.clipRight = 5.0f;
+	layout.Layout(&metrics, "abc", params);
+	CHECK(layout.GetCacheHits() == 2);
+
+	layout.ResetCounters();
+	CHECK(layout.GetCacheHits() == 0 && layout.GetCacheMisses() == 0);
+
+	layout.Shutdown();
+}
+
+int main()
+{
+	TestLine();
+	TestLineBreaks();
+	TestWrap();
+	TestAlign();
+	TestClip();
+	TestMeasure();
+	TestCache();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,232 @@
+// TilemapChunksClass: the tiles and the dirty chunks, the vertices, the instances and atlas coordinates a chunk is baked into,
+// the chunks selected for views inside, across and outside the map, and the eviction and rebaking of the chunks that leave the view.
+
+#include "__testCheck.h"
+#include "__tilemapChunksClass.h"
+
+#include <vector>
+using namespace std;
+
+typedef TilemapChunksClass::VertexType	VertexType;
+typedef TilemapChunksClass::InstanceType InstanceType;
+
+#define CHUNK TilemapChunksClass::CHUNK_SIZE
+
+static void TestTiles()
+{
+	TilemapChunksClass chunks;
+
+	CHECK(!chunks.Initialize(0, 10, 32, 2, 2));
+
+	// 100 x 70 tiles round up to 4 x 3 chunks
+	CHECK(chunks.Initialize(100, 70, 16, 2, 2));
+	CHECK(chunks.GetChunkCount() == 12);
+	CHECK(chunks.GetTile(5, 5) == TilemapChunksClass::EMPTY_TILE);
+
+	// Every chunk starts dirty; baking cleans it, and only a change of a tile makes it dirty again
+	vector<VertexType> vertices(CHUNK * CHUNK * 4);
+
+	CHECK(chunks.IsDirty(0));
+	chunks.BakeChunk(0, &vertices[0]);
+	chunks.BakeChunk(1, &vertices[0]);
+	CHECK(!chunks.IsDirty(0));
+
+	chunks.SetTile(5, 5, 3);
+	CHECK(chunks.GetTile(5, 5) == 3);
+	CHECK(chunks.IsDirty(0));
+	CHECK(!chunks.IsDirty(1));
+
+	chunks.BakeChunk(0, &vertices[0]);
+	chunks.SetTile(5, 5, 3);
+	CHECK(!chunks.IsDirty(0));
+
+	// The tiles outside of the map are ignored
+	chunks.SetTile(-1, 0, 1);
+	chunks.SetTile(100, 0, 1);
+	chunks.SetTile(0, 70, 1);
+	CHECK(chunks.GetTile(100, 0) == TilemapChunksClass::EMPTY_TILE);
+
+	// The last tile of the map is in the last chunk
+	chunks.BakeChunk(11, &vertices[0]);
+	chunks.SetTile(99, 69, 0);
+	CHECK(chunks.IsDirty(11));
+
+	chunks.Shutdown();
+}
+
+// A 2x2 atlas of 16 pixel tiles: the quads are in map pixels with Y going down from 0, the coordinates pick the cell of the atlas
+static void TestVertices()
+{
+	TilemapChunksClass chunks;
+	vector<VertexType> vertices(CHUNK * CHUNK * 4);
+
+	CHECK(chunks.Initialize(64, 64, 16, 2, 2));
+
+	chunks.SetTile(1, 2, 3);					// chunk 0, the bottom right cell
+	chunks.SetTile(CHUNK + 4, CHUNK, 1);		// chunk 3, the top right cell
+
+	CHECK(chunks.BakeChunk(0, &vertices[0]) == 1);
+
+	const VertexType *quad = &vertices[0];
+
+	CHECK(quad[0].x == 16.0f && quad[0].y == -32.0f);		// Top left
+	CHECK(quad[1].x == 32.0f && quad[1].y == -32.0f);		// Top right
+	CHECK(quad[2].x == 16.0f && quad[2].y == -48.0f);		// Bottom left
+	CHECK(quad[3].x == 32.0f && quad[3].y == -48.0f);		// Bottom right
+	CHECK(quad[0].u == 0.5f && quad[0].v == 0.5f);
+	CHECK(quad[3].u == 1.0f && quad[3].v == 1.0f);
+	CHECK(quad[0].z == 0.0f);
+
+	CHECK(chunks.BakeChunk(3, &vertices[0]) == 1);
+	CHECK(quad[0].x == (CHUNK + 4) * 16.0f && quad[0].y == -(CHUNK * 16.0f));
+	CHECK(quad[0].u == 0.5f && quad[0].v == 0.0f);
+
+	// An empty chunk has no quads, a full one has all of them
+	CHECK(chunks.BakeChunk(1, &vertices[0]) == 0);
+
+	for (int y = 0; y < CHUNK; y++)
+		for (int x = 0; x < CHUNK; x++)
+			chunks.SetTile(CHUNK + x, y, (unsigned short)((x + y) & 3));
+
+	CHECK(chunks.BakeChunk(1, &vertices[0]) == CHUNK * CHUNK);
+	CHECK(chunks.GetQuadCount(1) == CHUNK * CHUNK);
+
+	chunks.Shutdown();
+}
+
+// The same tiles as instances: the centers of the quads of TestVertices, the cell of the atlas as the texture rectangle
+static void TestInstances()
+{
+	TilemapChunksClass	 chunks;
+	vector<InstanceType> instances(CHUNK * CHUNK);
+	vector<VertexType>	 vertices(CHUNK * CHUNK * 4);
+
+	CHECK(chunks.Initialize(64, 64, 16, 2, 2));
+
+	chunks.SetTile(1, 2, 3);
+	chunks.SetTile(CHUNK + 4, CHUNK, 1);
+
+	CHECK(chunks.BakeChunk(0, &instances[0]) == 1);
+	CHECK(!chunks.IsDirty(0) && chunks.GetQuadCount(0) == 1 && chunks.GetBakedChunkCount() == 1);
+
+	const InstanceType *tile = &instances[0];
+
+	CHECK(tile->x == 24.0f && tile->y == -40.0f);
+	CHECK(tile->rotation == 0.0f && tile->size == 1.0f);
+	CHECK(tile->r == 1.0f && tile->g == 1.0f && tile->b == 1.0f && tile->a == 1.0f);
+	CHECK(tile->u == 0.5f && tile->v == 0.5f && tile->uWidth == 0.5f && tile->vHeight == 0.5f);
+
+	CHECK(chunks.BakeChunk(3, &instances[0]) == 1);
+	CHECK(tile->x == (CHUNK + 4.5f) * 16.0f && tile->y == -(CHUNK + 0.5f) * 16.0f);
+	CHECK(tile->u == 0.5f && tile->v == 0.0f);
+
+	// A full chunk: an instance in the middle of every quad of the vertices, row by row
+	for (int y = 0; y < CHUNK; y++)
+		for (int x = 0; x < CHUNK; x++)
+			chunks.SetTile(CHUNK + x, y, (unsigned short)((x + y) & 3));
+
+	CHECK(chunks.BuildChunkVertices(1, &vertices[0]) == CHUNK * CHUNK);
+	CHECK(chunks.BakeChunk(1, &instances[0]) == CHUNK * CHUNK);
+
+	bool same = true;
+
+	for (int i = 0; i < CHUNK * CHUNK; i++) {
+		const VertexType *quad = &vertices[i * 4];
+
+		same = same && instances[i].x == (quad[0].x + quad[3].x) * 0.5f && instances[i].y == (quad[0].y + quad[3].y) * 0.5f;
+		same = same && instances[i].u == quad[0].u && instances[i].v == quad[0].v;
+		same = same && instances[i].uWidth == quad[3].u - quad[0].u && instances[i].vHeight == quad[3].v - quad[0].v;
+	}
+
+	CHECK(same);
+
+	chunks.Shutdown();
+}
+
+static void TestVisibility()
+{
+	TilemapChunksClass chunks;
+
+	// 8 x 8 chunks of 32 x 32 pixels
+	CHECK(chunks.Initialize(8 * CHUNK, 8 * CHUNK, 1, 1, 1));
+
+	// Exactly one chunk, then a view one pixel past it
+	CHECK(chunks.SelectVisibleChunks(0, 0, CHUNK, CHUNK) == 1);
+	CHECK(chunks.SelectVisibleChunks(0, 0, CHUNK + 1, CHUNK) == 2);
+
+	// A view across a corner of four chunks
+	CHECK(chunks.BeginFrame(CHUNK * 3 - 1, CHUNK * 5 - 1, 2, 2) == 4);
+	CHECK(chunks.GetVisibleChunk(0) == 4 * 8 + 2);
+	CHECK(chunks.GetVisibleChunk(3) == 5 * 8 + 3);
+
+	// Views partly and fully outside of the map
+	CHECK(chunks.SelectVisibleChunks(-10, -10, 20, 20) == 1);
+	CHECK(chunks.SelectVisibleChunks(8 * CHUNK - 5, 0, 100, 1) == 1);
+	CHECK(chunks.SelectVisibleChunks(-100, 0, 50, 50) == 0);
+	CHECK(chunks.SelectVisibleChunks(8 * CHUNK, 0, 50, 50) == 0);
+	CHECK(chunks.SelectVisibleChunks(0, 0, 0, 50) == 0);
+
+	// The whole map and more
+	CHECK(chunks.SelectVisibleChunks(-1000, -1000, 10000, 10000) == 64);
+
+	chunks.Shutdown();
+}
+
+// The frames of TilemapClass::Render: bake what is visible and dirty, then evict what was not seen for 3 frames
+static void TestEviction()
+{
+	TilemapChunksClass chunks;
+	vector<VertexType> vertices(CHUNK * CHUNK * 4);
+
+	CHECK(chunks.Initialize(8 * CHUNK, 8 * CHUNK, 1, 1, 1));
+	chunks.SetEvictFrames(3);
+
+	int baked = 0;
+
+	for (int frame = 0; frame < 10; frame++) {
+		// The view sits on chunk 0 for 5 frames, then on chunk 63
+		int left = frame < 5 ? 0 : 7 * CHUNK;
+
+		int visible = chunks.BeginFrame(left, left, CHUNK, CHUNK);
+
+		CHECK(visible == 1);
+
+		for (int i = 0; i < visible; i++)
+			if (chunks.IsDirty(chunks.GetVisibleChunk(i))) {
+				chunks.BakeChunk(chunks.GetVisibleChunk(i), &vertices[0]);
+				baked++;
+			}
+
+		const vector<int> &evicted = chunks.EvictChunks();
+
+		// Chunk 0 was last seen in frame 4 and goes after 3 more
+		if (frame == 8) {
+			CHECK(evicted.size() == 1 && evicted[0] == 0);
+			CHECK(chunks.IsDirty(0));
+		}
+		else
+			CHECK(evicted.empty());
+
+		CHECK(chunks.GetRebuildCount() == (frame == 0 || frame == 5 ? 1 : 0));
+	}
+
+	CHECK(baked == 2);
+	CHECK(chunks.GetBakedChunkCount() == 1);
+
+	// It is baked again when it comes back
+	chunks.BeginFrame(0, 0, CHUNK, CHUNK);
+	CHECK(chunks.IsDirty(0));
+
+	chunks.Shutdown();
+}
+
+int main()
+{
+	TestTiles();
+	TestVertices();
+	TestInstances();
+	TestVisibility();
+	TestEviction();
+
+	return TEST_RESULT();
+}
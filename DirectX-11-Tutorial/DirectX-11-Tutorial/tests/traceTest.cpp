@@ -0,0 +1,383 @@
+// TraceClass: the file Export writes is the JSON of the Chrome trace viewer, read back line by line: a thread_name record
+// for every thread and track, and a complete event for every scope, the nested scopes inside the ones around them.
+// A full buffer drops the events that follow and counts them, and Start empties the buffers again.
+// Several threads record at once, each into its own buffer. A thread that recorded before a Shutdown records into
+// a new buffer after it, not into the released one.
+
+#include "__testCheck.h"
+#include "__traceClass.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+using namespace std;
+
+#define TRACE_FILE "traceTest.json"
+
+// A complete event of the file
+struct EventType {
+	string name;
+	int	   tid;
+	double ts, dur;
+};
+
+// The string after "key": on the line, without its quotes
+static bool ReadString(const string &line, const char *key, string *value)
+{
+	string pattern = string("\"") + key + "\":\"";
+	size_t start   = line.find(pattern);
+
+	if (start == string::npos)
+		return false;
+
+	start += pattern.size();
+	value->clear();
+
+	for (size_t i = start; i < line.size(); i++) {
+		if (line[i] == '\\' && i + 1 < line.size())
+			*value += line[++i];
+		else if (line[i] == '"')
+			return true;
+		else
+			*value += line[i];
+	}
+
+	return false;
+}
+
+static bool ReadNumber(const string &line, const char *key, double *value)
+{
+	string pattern = string("\"") + key + "\":";
+	size_t start   = line.find(pattern);
+
+	if (start == string::npos)
+		return false;
+
+	*value = atof(line.c_str() + start + pattern.size());
+
+	return true;
+}
+
+// The file has to be one object with the events in one array, a record per line; the names of the threads go into the map by tid.
+static bool ReadTrace(vector<EventType> *events, vector<string> *threads)
+{
+	ifstream fin(TRACE_FILE);
+	string	 line;
+	int		 braces = 0;
+
+	if (fin.fail() || !getline(fin, line) || line != "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[")
+		return false;
+
+	events->clear();
+	threads->clear();
+
+	while (getline(fin, line)) {
+		if (line == "]}")
+			return braces == 0 && !getline(fin, line);
+
+		for (size_t i = 0; i < line.size(); i++)
+			braces += line[i] == '{' ? 1 : (line[i] == '}' ? -1 : 0);
+
+		string phase, name;
+		double tid;
+
+		if (!ReadString(line, "ph", &phase) || !ReadString(line, "name", &name) || !ReadNumber(line, "tid", &tid))
+			return false;
+
+		if (phase == "M") {
+			string threadName;
+
+			if (name != "thread_name" || line.find("\"args\":{\"name\":") == string::npos)
+				return false;
+
+			ReadString(line.substr(line.find("\"args\"")), "name", &threadName);
+
+			if ((int)threads->size() < (int)tid + 1)
+				threads->resize((int)tid + 1);
+
+			(*threads)[(int)tid] = threadName;
+		}
+		else if (phase == "X") {
+			EventType event;
+
+			event.name = name;
+			event.tid  = (int)tid;
+
+			if (!ReadNumber(line, "ts", &event.ts) || !ReadNumber(line, "dur", &event.dur))
+				return false;
+
+			events->push_back(event);
+		}
+		else
+			return false;
+	}
+
+	return false;
+}
+
+static const EventType* FindEvent(const vector<EventType> &events, const char *name)
+{
+	for (size_t i = 0; i < events.size(); i++)
+		if (events[i].name == name)
+			return &events[i];
+
+	return 0;
+}
+
+static void Spin()
+{
+	long long start = TraceClass::GetTicks();
+
+	while (TraceClass::GetTicks() - start < TraceClass::GetFrequency() / 10000)
+		;
+}
+
+static void TestExport()
+{
+	vector<EventType> events;
+	vector<string>	  threads;
+
+	TraceClass::SetThreadName("main");
+
+	// Nothing is recorded while the trace is off
+	{
+		TraceScopeClass scope("Off");
+	}
+
+	CHECK(TraceClass::GetEventCount() == 0);
+
+	TraceClass::Start();
+
+	int track = TraceClass::CreateTrack("GPU");
+	CHECK(track >= 0);
+
+	{
+		TraceScopeClass outer("Frame");
+
+		Spin();
+
+		{
+			TraceScopeClass inner("Render \"2D\"");
+
+			Spin();
+		}
+
+		Spin();
+	}
+
+	long long now = TraceClass::GetTicks();
+	TraceClass::AddEvent(track, "2D", now - TraceClass::GetFrequency() / 1000, now);
+
+	TraceClass::Stop();
+
+	// Stopped, the scopes record nothing
+	{
+		TraceScopeClass scope("Stopped");
+	}
+
+	CHECK(TraceClass::GetEventCount() == 3 && TraceClass::GetDroppedCount() == 0);
+	CHECK(TraceClass::Export(TRACE_FILE));
+	CHECK(ReadTrace(&events, &threads));
+	CHECK(events.size() == 3);
+
+	// The thread and the track are named, the events are on their tids
+	const EventType *frame = FindEvent(events, "Frame");
+	const EventType *inner = FindEvent(events, "Render \"2D\"");
+	const EventType *gpu   = FindEvent(events, "2D");
+
+	CHECK(frame && inner && gpu);
+	CHECK(!FindEvent(events, "Off") && !FindEvent(events, "Stopped"));
+
+	if (frame && inner && gpu) {
+		CHECK(frame->tid == inner->tid && gpu->tid != frame->tid);
+		CHECK(frame->tid < (int)threads.size() && threads[frame->tid] == "main");
+		CHECK(gpu->tid < (int)threads.size() && threads[gpu->tid] == "GPU");
+
+		// The inner scope begins and ends inside the outer one
+		CHECK(frame->ts >= 0.0 && frame->dur > 0.0 && inner->dur > 0.0);
+		CHECK(inner->ts >= frame->ts && inner->ts + inner->dur <= frame->ts + frame->dur + 0.001);
+		CHECK_NEAR(gpu->dur, 1000.0, 1.0);
+	}
+
+	CHECK(!TraceClass::Export("no_such_directory/trace.json"));
+
+	remove(TRACE_FILE);
+	TraceClass::Shutdown();
+}
+
+static void TestDropped()
+{
+	TraceClass::Start();
+
+	for (int i = 0; i < TRACE_BUFFER_EVENTS + 10; i++)
+		TraceClass::Record("Event", i, i + 1);
+
+	TraceClass::Stop();
+
+	CHECK(TraceClass::GetEventCount() == TRACE_BUFFER_EVENTS);
+	CHECK(TraceClass::GetDroppedCount() == 10);
+
+	// Start empties the buffers and the counts
+	TraceClass::Start();
+	TraceClass::Record("Event", 0, 1);
+	TraceClass::Stop();
+
+	CHECK(TraceClass::GetEventCount() == 1 && TraceClass::GetDroppedCount() == 0);
+
+	TraceClass::Shutdown();
+}
+
+#define THREADS			  4
+#define EVENTS_PER_THREAD 10000
+
+static void RecordEvents(int index)
+{
+	static const char *names[THREADS] = { "worker 0", "worker 1", "worker 2", "worker 3" };
+
+	TraceClass::SetThreadName(names[index]);
+
+	for (int i = 0; i < EVENTS_PER_THREAD; i++) {
+		TraceScopeClass scope("Work");
+	}
+}
+
+static void TestThreads()
+{
+	vector<thread>	  workers;
+	vector<EventType> events;
+	vector<string>	  threads;
+
+	TraceClass::Start();
+
+	for (int i = 0; i < THREADS; i++)
+		workers.push_back(thread(RecordEvents, i));
+
+	for (int i = 0; i < THREADS; i++)
+		workers[i].join();
+
+	TraceClass::Stop();
+
+	CHECK(TraceClass::GetEventCount() == THREADS * EVENTS_PER_THREAD);
+	CHECK(TraceClass::GetDroppedCount() == 0);
+
+	// Every thread has its buffer with its name and all its events
+	CHECK(TraceClass::Export(TRACE_FILE));
+	CHECK(ReadTrace(&events, &threads));
+	CHECK(events.size() == THREADS * EVENTS_PER_THREAD);
+
+	vector<int> counts(threads.size(), 0);
+
+	for (size_t i = 0; i < events.size(); i++)
+		if (events[i].tid > 0 && events[i].tid < (int)counts.size())
+			counts[events[i].tid]++;
+
+	for (int i = 0; i < THREADS; i++) {
+		char name[16];
+		int	 found = 0;
+
+		sprintf(name, "worker %d", i);
+
+		for (size_t t = 0; t < threads.size(); t++)
+			if (threads[t] == name && counts[t] == EVENTS_PER_THREAD)
+				found++;
+
+		CHECK(found == 1);
+	}
+
+	remove(TRACE_FILE);
+	TraceClass::Shutdown();
+}
+
+// A worker records in steps the test gives it, across a Shutdown of the trace
+static mutex			  s_stepMutex;
+static condition_variable s_stepChanged;
+static int				  s_step = 0, s_done = 0;
+
+static void RecordSteps()
+{
+	TraceClass::SetThreadName("worker");
+
+	for (int step = 1; step <= 2; step++) {
+		unique_lock<mutex> lock(s_stepMutex);
+
+		s_stepChanged.wait(lock, [step]() { return s_step >= step; });
+
+		for (int i = 0; i < 100; i++) {
+			TraceScopeClass scope("Step");
+		}
+
+		s_done = step;
+		s_stepChanged.notify_all();
+	}
+}
+
+static void Step(int step)
+{
+	unique_lock<mutex> lock(s_stepMutex);
+
+	s_step = step;
+	s_stepChanged.notify_all();
+	s_stepChanged.wait(lock, [step]() { return s_done >= step; });
+}
+
+static void TestShutdown()
+{
+	vector<EventType> events;
+	vector<string>	  threads;
+	thread			  worker(RecordSteps);
+	int				  generation = TraceClass::GetGeneration();
+
+	TraceClass::Start();
+	Step(1);
+	TraceClass::Stop();
+
+	CHECK(TraceClass::GetEventCount() == 100);
+
+	// The buffers are gone, the worker makes a new one with its name
+	TraceClass::Shutdown();
+	CHECK(TraceClass::GetGeneration() != generation);
+	CHECK(TraceClass::GetEventCount() == 0);
+
+	TraceClass::Start();
+	Step(2);
+
+	{
+		TraceScopeClass scope("Main");
+	}
+
+	TraceClass::Stop();
+	worker.join();
+
+	CHECK(TraceClass::GetEventCount() == 101);
+	CHECK(TraceClass::Export(TRACE_FILE));
+	CHECK(ReadTrace(&events, &threads));
+
+	const EventType *step = FindEvent(events, "Step");
+	const EventType *main = FindEvent(events, "Main");
+
+	CHECK(step && main && step->tid != main->tid);
+
+	if (step && main) {
+		CHECK(step->tid < (int)threads.size() && threads[step->tid] == "worker");
+		CHECK(main->tid < (int)threads.size() && threads[main->tid] == "main");
+	}
+
+	remove(TRACE_FILE);
+	TraceClass::Shutdown();
+}
+
+int main()
+{
+	TestExport();
+	TestDropped();
+	TestThreads();
+	TestShutdown();
+
+	return TEST_RESULT();
+}
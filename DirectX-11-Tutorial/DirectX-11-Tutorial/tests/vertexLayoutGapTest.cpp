@@ -0,0 +1,23 @@
+// This file must not compile: the layout skips the texture coordinates of the vertex, so the color is not where
+// the position ends. The test passes when the build of this target fails.
+
+#include "__vertexLayoutClass.h"
+
+struct VertexType {
+	float position[3];
+	float texture[2];
+	float color[4];
+};
+
+typedef VertexLayoutClass<VertexType,
+						  VERTEX_ELEMENT(VertexType, position, PositionSemantic),
+						  VERTEX_ELEMENT(VertexType, color,	   ColorSemantic)> GapLayout;
+
+int main()
+{
+	struct { const char *SemanticName; unsigned int SemanticIndex; int Format; unsigned int InputSlot, AlignedByteOffset; int InputSlotClass; unsigned int InstanceDataStepRate; } desc[GapLayout::count];
+
+	GapLayout::Describe(desc);
+
+	return 0;
+}
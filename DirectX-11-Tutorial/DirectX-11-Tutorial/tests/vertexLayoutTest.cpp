@@ -0,0 +1,200 @@
+// VertexLayoutClass and InstancedLayoutClass against the input layouts the shader classes used to write by hand:
+// the formats, the offsets, the semantics, the slots and the stepping of every element. And the constant buffer layouts
+// of ShaderConstantsClass against the HLSL packing: multiples of 16 bytes, no member across a 16 byte boundary,
+// the padding where the shaders have it. A layout with a gap doesn't compile, vertexLayoutGapTest checks that.
+
+#include "__testCheck.h"
+#include "__vertexLayoutClass.h"
+#include "__shaderConstantsClass.h"
+#include "__particleSystemClass.h"
+
+#include <string.h>
+
+// The fields of D3D11_INPUT_ELEMENT_DESC the layouts fill, with the enums as ints
+struct DescType {
+	const char	 *SemanticName;
+	unsigned int  SemanticIndex;
+	int			  Format;
+	unsigned int  InputSlot;
+	unsigned int  AlignedByteOffset;
+	int			  InputSlotClass;
+	unsigned int  InstanceDataStepRate;
+};
+
+struct Vector2 { float x, y; };
+struct Vector3 { float x, y, z; };
+struct Vector4 { float x, y, z, w; };
+struct Matrix  { float m[16]; };
+
+static bool Element(const DescType &desc, const char *name, unsigned int index, int format, unsigned int slot, unsigned int offset)
+{
+	bool perInstance = slot == 1;
+
+	return strcmp(desc.SemanticName, name) == 0 && desc.SemanticIndex == index && desc.Format == format &&
+		   desc.InputSlot == slot && desc.AlignedByteOffset == offset &&
+		   desc.InputSlotClass == (perInstance ? 1 : 0) && desc.InstanceDataStepRate == (perInstance ? 1u : 0u);
+}
+
+// The vertex of the FontShaderClass: position, texture coordinates and color
+struct FontVertexType {
+	Vector3 position;
+	Vector2 texture;
+	Vector4 color;
+};
+
+typedef VertexLayoutClass<FontVertexType,
+						  VERTEX_ELEMENT(FontVertexType, position, PositionSemantic),
+						  VERTEX_ELEMENT(FontVertexType, texture,  TexcoordSemantic),
+						  VERTEX_ELEMENT(FontVertexType, color,	   ColorSemantic)> FontLayout;
+
+static void TestVertexLayout()
+{
+	DescType desc[FontLayout::count];
+
+	static_assert(FontLayout::count == 3, "three elements");
+
+	memset(desc, 0xff, sizeof(desc));
+	FontLayout::Describe(desc);
+
+	CHECK(Element(desc[0], "POSITION", 0, 6,  0, 0));	// DXGI_FORMAT_R32G32B32_FLOAT
+	CHECK(Element(desc[1], "TEXCOORD", 0, 16, 0, 12));	// DXGI_FORMAT_R32G32_FLOAT
+	CHECK(Element(desc[2], "COLOR",	   0, 2,  0, 20));	// DXGI_FORMAT_R32G32B32A32_FLOAT
+
+	// Another slot, stepping per instance
+	FontLayout::Describe(desc, 1, true);
+
+	CHECK(Element(desc[2], "COLOR", 0, 2, 1, 20));
+}
+
+// The integers and the single floats
+struct IndexVertexType {
+	float		 weight;
+	unsigned int bone;
+	int			 offset;
+};
+
+typedef VertexLayoutClass<IndexVertexType,
+						  VERTEX_ELEMENT(IndexVertexType, weight, TexcoordSemantic),
+						  VERTEX_ELEMENT(IndexVertexType, bone,	  Texcoord1Semantic),
+						  VERTEX_ELEMENT(IndexVertexType, offset, Texcoord2Semantic)> IndexLayout;
+
+static void TestFormats()
+{
+	DescType desc[IndexLayout::count];
+
+	IndexLayout::Describe(desc);
+
+	CHECK(Element(desc[0], "TEXCOORD", 0, 41, 0, 0));	// DXGI_FORMAT_R32_FLOAT
+	CHECK(Element(desc[1], "TEXCOORD", 1, 42, 0, 4));	// DXGI_FORMAT_R32_UINT
+	CHECK(Element(desc[2], "TEXCOORD", 2, 43, 0, 8));	// DXGI_FORMAT_R32_SINT
+}
+
+// The layout of TextureShaderClass_Instancing: the quad in slot 0 and the particle instances in slot 1,
+// element for element the six descriptions it had before
+struct QuadVertexType {
+	Vector3 position;
+	Vector2 texture;
+};
+
+typedef ParticleSystemClass::InstanceType InstanceType;
+
+typedef VertexLayoutClass<QuadVertexType,
+						  VERTEX_ELEMENT(QuadVertexType, position, PositionSemantic),
+						  VERTEX_ELEMENT(QuadVertexType, texture,  TexcoordSemantic)> QuadLayout;
+
+// The particle instance is all floats: x, y, rotation make the position, then the size, the color and the rectangle
+struct ParticleInstanceType {
+	Vector3 position;
+	float	size;
+	Vector4 color;
+	Vector4 uvRect;
+};
+
+static_assert(sizeof(ParticleInstanceType) == sizeof(InstanceType), "the particle instance is the instance of the layout");
+
+typedef VertexLayoutClass<ParticleInstanceType,
+						  VERTEX_ELEMENT(ParticleInstanceType, position, Texcoord1Semantic),
+						  VERTEX_ELEMENT(ParticleInstanceType, size,	 Texcoord2Semantic),
+						  VERTEX_ELEMENT(ParticleInstanceType, color,	 ColorSemantic),
+						  VERTEX_ELEMENT(ParticleInstanceType, uvRect,	 Texcoord3Semantic)> ParticleLayout;
+
+static void TestInstancedLayout()
+{
+	typedef InstancedLayoutClass<QuadLayout, ParticleLayout> Layout;
+
+	DescType desc[Layout::count];
+
+	static_assert(Layout::count == 6, "two vertex and four instance elements");
+
+	Layout::Describe(desc);
+
+	CHECK(Element(desc[0], "POSITION", 0, 6,  0, 0));
+	CHECK(Element(desc[1], "TEXCOORD", 0, 16, 0, 12));
+	CHECK(Element(desc[2], "TEXCOORD", 1, 6,  1, 0));
+	CHECK(Element(desc[3], "TEXCOORD", 2, 41, 1, 12));
+	CHECK(Element(desc[4], "COLOR",	   0, 2,  1, 16));
+	CHECK(Element(desc[5], "TEXCOORD", 3, 2,  1, 32));
+
+	// The instance offsets are the ones the particle system writes
+	CHECK(offsetof(InstanceType, size) == desc[3].AlignedByteOffset);
+	CHECK(offsetof(InstanceType, r) == desc[4].AlignedByteOffset);
+	CHECK(offsetof(InstanceType, u) == desc[5].AlignedByteOffset);
+}
+
+
+
+// HLSL packs a cbuffer in 16 byte registers: a member never crosses one, and the buffer is a whole number of them.
+static bool Packed(size_t offset, size_t size)
+{
+	return size >= 16 ? offset % 16 == 0 : offset / 16 == (offset + size - 1) / 16;
+}
+
+#define CHECK_PACKED(Type, member) CHECK(Packed(offsetof(Type, member), sizeof(((Type*)0)->member)))
+
+typedef ShaderConstantsClass<Matrix, Vector3, Vector4> ConstantsType;
+
+static void TestConstantBuffers()
+{
+	typedef ConstantsType::LightFrameBufferType	   LightFrame;
+	typedef ConstantsType::LightObjectBufferType   LightObject;
+	typedef ConstantsType::LightBufferType		   Light;
+	typedef ConstantsType::ClusterBufferType	   Cluster;
+	typedef ConstantsType::TextureFrameBufferType  TextureFrame;
+	typedef ConstantsType::TextureObjectBufferType TextureObject;
+	typedef ConstantsType::MatrixBufferType		   Matrices;
+
+	CHECK(sizeof(LightFrame) == 144 && sizeof(LightObject) == 64 && sizeof(Light) == 64 && sizeof(Cluster) == 32);
+	CHECK(sizeof(TextureFrame) == 128 && sizeof(TextureObject) == 64 && sizeof(Matrices) == 192);
+
+	// The camera position is followed by its padding to fill the register
+	CHECK(offsetof(LightFrame, cameraPosition) == 128 && offsetof(LightFrame, padding) == 140);
+	CHECK_PACKED(LightFrame, view);
+	CHECK_PACKED(LightFrame, projection);
+	CHECK_PACKED(LightFrame, cameraPosition);
+
+	// The specular power fills the register of the light direction
+	CHECK(offsetof(Light, lightDirection) == 32 && offsetof(Light, specularPower) == 44 && offsetof(Light, specularColor) == 48);
+	CHECK_PACKED(Light, ambientColor);
+	CHECK_PACKED(Light, diffuseColor);
+	CHECK_PACKED(Light, lightDirection);
+	CHECK_PACKED(Light, specularColor);
+
+	// float2 tileScale, float depthScale, float depthBias, uint3 clusterCounts, uint lightCount
+	CHECK(offsetof(Cluster, depthScale) == 8 && offsetof(Cluster, depthBias) == 12);
+	CHECK(offsetof(Cluster, clusterCounts) == 16 && offsetof(Cluster, lightCount) == 28);
+	CHECK_PACKED(Cluster, tileScale);
+	CHECK_PACKED(Cluster, clusterCounts);
+
+	CHECK(offsetof(Matrices, view) == 64 && offsetof(Matrices, projection) == 128);
+	CHECK(offsetof(TextureFrame, projection) == 64);
+}
+
+int main()
+{
+	TestVertexLayout();
+	TestFormats();
+	TestInstancedLayout();
+	TestConstantBuffers();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,31 @@
+// --------------------------------------------------------------------------------------------------------
+// ShaderBuild compiles every shader DirectX-11-Tutorial loads into its bytecode cache (ShaderLoaderClass::BuildAll),
+// without a window or a device. The project runs it after it is built and whenever a shader source changes,
+// so the program starts without compiling anything. It is run from this directory: the paths of the shaders
+// and of the cache are the ones of the program, relative to the directory next to this one.
+// The errors go to '____shader-error.txt'; the exit code is 1 when a shader doesn't compile.
+// --------------------------------------------------------------------------------------------------------
+
+#include "../DirectX-11-Tutorial/__shaderLoaderClass.h"
+
+#include <stdio.h>
+
+#pragma comment(lib, "d3d11.lib")
+
+int main()
+{
+	bool result;
+
+	result = ShaderLoaderClass::BuildAll();
+
+	const ShaderCacheClass::StatsType &stats = ShaderLoaderClass::GetStats();
+
+	printf("shaders: %d up to date, %d compiled in %.1f ms, %d failed\n", stats.hits, stats.misses, stats.compileTime, stats.compileFailures);
+
+	if (!result)
+		printf("see ____shader-error.txt\n");
+
+	ShaderLoaderClass::Shutdown();
+
+	return result ? 0 : 1;
+}